@@ -116,6 +116,40 @@ struct WField
   uint_t        type;    /* Field type. */
 };
 
+/* Describes how much a procedure's synchronized statement is contended. */
+struct WSyncStats
+{
+  ullong_t      aquires;      /* Times the statement was entered. */
+  ullong_t      contentions;  /* Times a caller had to wait to enter it. */
+  ullong_t      timeouts;     /* Waits given up as they took too long. */
+  ullong_t      waitTime;     /* Milliseconds spent waiting to enter it. */
+  ullong_t      maxWaitTime;  /* The longest wait, in milliseconds. */
+  uint_t        waiting;      /* Callers waiting right now to enter it. */
+  uint_t        held;         /* Not 0 if some one is in the statement. */
+};
+
+/* How a procedure has run since the procedures' profiling was enabled. */
+struct WProfileStats
+{
+  ullong_t      calls;
+  ullong_t      instructions;   /* Executed from the procedure's own code. */
+  ullong_t      inclusiveTime;  /* Microseconds, with the called procedures. */
+  ullong_t      exclusiveTime;  /* Microseconds spent in its own code. */
+  uint_t        enabled;        /* Not 0 if the profiling is enabled. */
+};
+
+/* How many times the instruction found at a code position was executed. */
+struct WCodeCount
+{
+  uint_t        pos;
+  ullong_t      count;
+};
+
+#define WPROF_QUERY         0
+#define WPROF_ENABLE        1
+#define WPROF_DISABLE       2
+#define WPROF_RESET         3
+
 
 /* Connects to a remote sever.
  *
@@ -398,6 +432,67 @@ WProcParamField(const WH_CONNECTION   hnd,
                 const char**          outpFieldName,
                 uint_t* const         outFieldType);
 
+/* Get the statistics of a procedure's synchronized statement.
+ *
+ * This function will fail if it's not called with a connection handler that
+ * was successfully authenticated with the the administrator account.
+ *
+ * @hnd                 The connection handle.
+ * @procedure           Name of the procedure.
+ * @sync                The index of the synchronized statement, in the order
+ *                      they appear in the procedure's code.
+ * @outSyncsCount       In case of success it will hold the number of the
+ *                      procedure's synchronized statements.
+ * @outStats            In case of success it will hold the statistics of the
+ *                      requested statement. These are all 0 if the procedure
+ *                      has no synchronized statements.
+ *
+ * @return              WCS_OK in case of success, other way it will return
+ *                      the error's case corresponding code.
+ */
+CONNECTOR_SHL uint_t
+WProcSyncStats(const WH_CONNECTION       hnd,
+               const char* const         procedure,
+               const uint_t              sync,
+               uint_t* const             outSyncsCount,
+               struct WSyncStats* const  outStats);
+
+/* Control the procedures' profiling and get a procedure's profile.
+ *
+ * This function will fail if it's not called with a connection handler that
+ * was successfully authenticated with the the administrator account.
+ *
+ * @hnd                 The connection handle.
+ * @action              One of WPROF_QUERY, WPROF_ENABLE, WPROF_DISABLE or
+ *                      WPROF_RESET. The last three apply to the whole server.
+ * @procedure           Name of the procedure. If it's NULL or empty only the
+ *                      action is applied and the profile's counts are 0.
+ * @fromPos             The code position to start retrieving the counts of
+ *                      the executed instructions from.
+ * @outStats            In case of success it will hold the procedure's profile.
+ * @outCounts           Where to put the counts of the executed instructions.
+ *                      It may be NULL if these are not needed.
+ * @countsCapacity      How many counts fit into outCounts.
+ * @outCountsCount      In case of success it will hold the number of counts
+ *                      put into outCounts.
+ * @outNextPos          In case of success it will hold the code position to
+ *                      use as 'fromPos' to retrieve the next counts. It is 0
+ *                      when there are no counts left.
+ *
+ * @return              WCS_OK in case of success, other way it will return
+ *                      the error's case corresponding code.
+ */
+CONNECTOR_SHL uint_t
+WProcProfile(const WH_CONNECTION          hnd,
+             const uint_t                 action,
+             const char* const            procedure,
+             const uint_t                 fromPos,
+             struct WProfileStats* const  outStats,
+             struct WCodeCount* const     outCounts,
+             const uint_t                 countsCapacity,
+             uint_t* const                outCountsCount,
+             uint_t* const                outNextPos);
+
 /* Get the type of a global value.
  *
  * Retrieve the type of a global value. In case the global types is a table
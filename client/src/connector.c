@@ -3344,6 +3344,237 @@ proc_parameter_field_err:
   return cs;
 }
 
+
+uint_t
+WProcSyncStats(const WH_CONNECTION       hnd,
+               const char* const         procedure,
+               const uint_t              sync,
+               uint_t* const             outSyncsCount,
+               struct WSyncStats* const  outStats)
+{
+  struct INTERNAL_HANDLER* const hnd_ = (struct INTERNAL_HANDLER*)hnd;
+
+  const uint_t nameLen = (procedure == NULL) ? 0 : strlen(procedure) + 1;
+
+  uint8_t  *data_  = NULL;
+  uint_t    cs     = WCS_OK;
+  uint_t    offset = 0;
+  uint16_t  type   = 0;
+
+  if (hnd == NULL
+      || nameLen <= 1
+      || outSyncsCount == NULL
+      || outStats == NULL)
+  {
+    return WCS_INVALID_ARGS;
+  }
+  else if (hnd_->userId != 0)
+    return WCS_OP_NOTPERMITED;
+
+  else if (hnd_->buildingCmd != CMD_INVALID)
+    return WCS_INCOMPLETE_CMD;
+
+  else if (nameLen + 2 * sizeof(uint16_t) > max_data_size(hnd_)
+           || sync > 0xFFFF)
+  {
+    return WCS_LARGE_ARGS;
+  }
+
+  set_data_size(hnd_, nameLen + 2 * sizeof(uint16_t));
+  data_ = data(hnd_);
+  store_le_int16(sync, data_);
+  store_le_int16(0, data_ + sizeof(uint16_t)); /* reserved */
+  strcpy((char*)data_ + 2 * sizeof(uint16_t), procedure);
+
+  if ((cs = send_command(hnd_, CMD_PROC_SYNC_STATS)) != WCS_OK)
+    goto proc_sync_stats_err;
+
+  if ((cs = recieve_answer(hnd_, &type)) != WCS_OK)
+    goto proc_sync_stats_err;
+
+  else if (type != CMD_PROC_SYNC_STATS_RSP)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto proc_sync_stats_err;
+  }
+
+  data_ = data(hnd_);
+  if ((cs = load_le_int32(data_)) != WCS_OK)
+    goto proc_sync_stats_err;
+
+  else if (data_size(hnd_) < 2 * sizeof(uint32_t) + 2 * sizeof(uint16_t)
+                             + 5 * sizeof(uint64_t))
+  {
+    cs = WCS_INVALID_FRAME;
+    goto proc_sync_stats_err;
+  }
+
+  offset = sizeof(uint32_t);
+
+  *outSyncsCount = load_le_int16(data_ + offset);
+  offset += sizeof(uint16_t);
+
+  outStats->held = data_[offset];
+  offset += 2 * sizeof(uint8_t);
+
+  outStats->waiting = load_le_int32(data_ + offset);
+  offset += sizeof(uint32_t);
+
+  outStats->aquires = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->contentions = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->timeouts = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->waitTime = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->maxWaitTime = load_le_int64(data_ + offset);
+
+  return WCS_OK;
+
+proc_sync_stats_err:
+
+  assert(cs != WCS_OK);
+
+  hnd_->lastCmdRespReceived = CMD_INVALID_RSP;
+
+  return cs;
+}
+
+uint_t
+WProcProfile(const WH_CONNECTION          hnd,
+             const uint_t                 action,
+             const char* const            procedure,
+             const uint_t                 fromPos,
+             struct WProfileStats* const  outStats,
+             struct WCodeCount* const     outCounts,
+             const uint_t                 countsCapacity,
+             uint_t* const                outCountsCount,
+             uint_t* const                outNextPos)
+{
+  struct INTERNAL_HANDLER* const hnd_ = (struct INTERNAL_HANDLER*)hnd;
+
+  const uint_t nameLen = (procedure == NULL) ? 1 : strlen(procedure) + 1;
+  const uint_t reqSize = 2 * sizeof(uint16_t) + sizeof(uint32_t) + nameLen;
+  const uint_t rspSize = 3 * sizeof(uint32_t) + 4 * sizeof(uint64_t);
+
+  uint8_t  *data_       = NULL;
+  uint_t    cs          = WCS_OK;
+  uint_t    offset      = 0;
+  uint_t    countsCount = 0;
+  uint_t    count       = 0;
+  uint16_t  type        = 0;
+
+  if (hnd == NULL
+      || action > WPROF_RESET
+      || outStats == NULL
+      || outCountsCount == NULL
+      || outNextPos == NULL
+      || (outCounts == NULL && countsCapacity > 0))
+  {
+    return WCS_INVALID_ARGS;
+  }
+  else if (hnd_->userId != 0)
+    return WCS_OP_NOTPERMITED;
+
+  else if (hnd_->buildingCmd != CMD_INVALID)
+    return WCS_INCOMPLETE_CMD;
+
+  else if (reqSize > max_data_size(hnd_))
+    return WCS_LARGE_ARGS;
+
+  set_data_size(hnd_, reqSize);
+  data_ = data(hnd_);
+  store_le_int16(action, data_);
+  store_le_int16(0, data_ + sizeof(uint16_t)); /* reserved */
+  store_le_int32(fromPos, data_ + 2 * sizeof(uint16_t));
+  strcpy((char*)data_ + 2 * sizeof(uint16_t) + sizeof(uint32_t),
+         (procedure == NULL) ? "" : procedure);
+
+  if ((cs = send_command(hnd_, CMD_PROC_PROFILE)) != WCS_OK)
+    goto proc_profile_err;
+
+  if ((cs = recieve_answer(hnd_, &type)) != WCS_OK)
+    goto proc_profile_err;
+
+  else if (type != CMD_PROC_PROFILE_RSP)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto proc_profile_err;
+  }
+
+  data_ = data(hnd_);
+  if ((cs = load_le_int32(data_)) != WCS_OK)
+    goto proc_profile_err;
+
+  else if (data_size(hnd_) < rspSize)
+  {
+    cs = WCS_INVALID_FRAME;
+    goto proc_profile_err;
+  }
+
+  offset = sizeof(uint32_t);
+
+  outStats->enabled = data_[offset];
+  offset += 2 * sizeof(uint8_t);
+
+  countsCount = load_le_int16(data_ + offset);
+  offset += sizeof(uint16_t);
+
+  *outNextPos = load_le_int32(data_ + offset);
+  offset += sizeof(uint32_t);
+
+  outStats->calls = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->instructions = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->inclusiveTime = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  outStats->exclusiveTime = load_le_int64(data_ + offset);
+  offset += sizeof(uint64_t);
+
+  if (data_size(hnd_) != rspSize + countsCount * (sizeof(uint32_t) + sizeof(uint64_t)))
+  {
+    cs = WCS_INVALID_FRAME;
+    goto proc_profile_err;
+  }
+
+  for (count = 0; count < countsCount; ++count)
+  {
+    /* Let the caller continue with the ones that did not fit. */
+    if (count == countsCapacity)
+    {
+      *outNextPos = load_le_int32(data_ + offset);
+      break;
+    }
+
+    outCounts[count].pos = load_le_int32(data_ + offset);
+    offset += sizeof(uint32_t);
+
+    outCounts[count].count = load_le_int64(data_ + offset);
+    offset += sizeof(uint64_t);
+  }
+
+  *outCountsCount = count;
+
+  return WCS_OK;
+
+proc_profile_err:
+
+  assert(cs != WCS_OK);
+
+  hnd_->lastCmdRespReceived = CMD_INVALID_RSP;
+
+  return cs;
+}
+
 uint_t
 WExecuteProcedure(const WH_CONNECTION   hnd,
                   const char* const     procedure)
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
 #include <assert.h>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <vector>
@@ -626,6 +627,257 @@ cmd_greet_exit:
 
 
 
+static const char syncShowDesc[]    = "Show procedures' synchronized statements use.";
+static const char syncShowDescExt[] =
+  "Show how much the synchronized statements of the specified procedures\n"
+  "are contended for. The times are shown in milliseconds.\n"
+  "Usage:\n"
+  "  syncstat procedure_name ... ";
+
+
+static bool
+cmdSyncStats(const string& cmdLine, ENTRY_CMD_CONTEXT context)
+{
+  size_t              linePos     = 0;
+  string              token       = CmdLineNextToken(cmdLine, linePos);
+  WH_CONNECTION       conHdl      = nullptr;
+  const VERBOSE_LEVEL level       = GetVerbosityLevel();
+
+  assert(token == "syncstat");
+
+  uint32_t cs = WConnect(GetRemoteHostName().c_str(),
+                          GetConnectionPort().c_str(),
+                          GetWorkingDB().c_str(),
+                          GetUserPassword().c_str(),
+                          GetUserId(),
+                          DEFAULT_FRAME_SIZE,
+                          &conHdl);
+  if (cs != WCS_OK)
+    {
+      if (level >= VL_DEBUG)
+        cout << "Failed to connect: ";
+
+      cout << wcmd_translate_status(cs) << endl;
+
+      return false;
+    }
+
+  while (cs == WCS_OK)
+    {
+      token = CmdLineNextToken(cmdLine, linePos);
+      if (token.length() == 0)
+        break;
+
+      uint_t syncsCount = 0, sync = 0;
+      do
+        {
+          struct WSyncStats stats;
+
+          cs = WProcSyncStats(conHdl, token.c_str(), sync, &syncsCount, &stats);
+          if (cs != WCS_OK)
+            {
+              if (level >= VL_DEBUG)
+                {
+                  cout << "Failed to get the synchronized statements of procedure '"
+                       << token << "'.\n";
+                }
+              break;
+            }
+          else if (syncsCount == 0)
+            {
+              cout << token << ": no synchronized statements.\n";
+              break;
+            }
+
+          cout << token << '#' << sync << ": "
+               << (stats.held ? "held" : "free")
+               << ", entered " << stats.aquires
+               << ", contended " << stats.contentions
+               << ", timeouts " << stats.timeouts
+               << ", waiting " << stats.waiting
+               << ", wait time " << stats.waitTime
+               << ", max wait time " << stats.maxWaitTime << endl;
+        }
+      while (++sync < syncsCount);
+    }
+
+  WClose(conHdl);
+
+  if (cs != WCS_OK)
+    cout << wcmd_translate_status(cs) << endl;
+
+  return(cs == WCS_OK) ? true : false;
+}
+
+
+
+static const char profShowDesc[]    = "Profile the procedures.";
+static const char profShowDescExt[] =
+  "Enable, disable or reset the procedures' profiling on the server, or show\n"
+  "how many times the specified procedures were called, how many instructions\n"
+  "they have executed, the time spent in them and their most executed\n"
+  "instructions. The times are shown in microseconds. The profiles may be\n"
+  "also written into a file to be used for annotating the disassembled code.\n"
+  "Usage:\n"
+  "  profile on | off | reset\n"
+  "  profile [-o file] procedure_name ... ";
+
+
+static const uint_t PROFILE_HOTSPOTS = 5;
+
+
+static bool
+cmdProfile(const string& cmdLine, ENTRY_CMD_CONTEXT context)
+{
+  size_t              linePos     = 0;
+  string              token       = CmdLineNextToken(cmdLine, linePos);
+  WH_CONNECTION       conHdl      = nullptr;
+  FILE*               outFile     = nullptr;
+  const VERBOSE_LEVEL level       = GetVerbosityLevel();
+
+  assert(token == "profile");
+
+  token = CmdLineNextToken(cmdLine, linePos);
+
+  uint_t action = WPROF_QUERY;
+  if (token == "on")
+    action = WPROF_ENABLE;
+
+  else if (token == "off")
+    action = WPROF_DISABLE;
+
+  else if (token == "reset")
+    action = WPROF_RESET;
+
+  else if (token == "-o")
+    {
+      const string fileName = CmdLineNextToken(cmdLine, linePos);
+
+      if (fileName.empty())
+        {
+          cout << "The name of the profile's file is missing.\n";
+          return false;
+        }
+      else if ((outFile = fopen(fileName.c_str(), "w")) == nullptr)
+        {
+          cout << "Failed to open the file '" << fileName << "'.\n";
+          return false;
+        }
+
+      token = CmdLineNextToken(cmdLine, linePos);
+    }
+
+  uint32_t cs = WConnect(GetRemoteHostName().c_str(),
+                          GetConnectionPort().c_str(),
+                          GetWorkingDB().c_str(),
+                          GetUserPassword().c_str(),
+                          GetUserId(),
+                          DEFAULT_FRAME_SIZE,
+                          &conHdl);
+  if (cs != WCS_OK)
+    {
+      if (level >= VL_DEBUG)
+        cout << "Failed to connect: ";
+
+      cout << wcmd_translate_status(cs) << endl;
+
+      if (outFile != nullptr)
+        fclose(outFile);
+
+      return false;
+    }
+
+  if (action != WPROF_QUERY)
+    {
+      struct WProfileStats stats;
+      uint_t countsCount, nextPos;
+
+      cs = WProcProfile(conHdl, action, nullptr, 0, &stats, nullptr, 0, &countsCount, &nextPos);
+      if (cs == WCS_OK)
+        cout << "Profiling is " << (stats.enabled ? "enabled" : "disabled") << ".\n";
+
+      token.clear();
+    }
+
+  while ((cs == WCS_OK) && (token.length() > 0))
+    {
+      struct WProfileStats  stats;
+      struct WCodeCount     buffer[256];
+      vector<WCodeCount>    counts;
+      uint_t                fromPos = 0;
+
+      do
+        {
+          uint_t countsCount = 0;
+
+          cs = WProcProfile(conHdl,
+                            WPROF_QUERY,
+                            token.c_str(),
+                            fromPos,
+                            &stats,
+                            buffer,
+                            sizeof buffer / sizeof buffer[0],
+                            &countsCount,
+                            &fromPos);
+
+          counts.insert(counts.end(), buffer, buffer + countsCount);
+        }
+      while ((cs == WCS_OK) && (fromPos > 0));
+
+      if (cs != WCS_OK)
+        {
+          if (level >= VL_DEBUG)
+            cout << "Failed to get the profile of procedure '" << token << "'.\n";
+
+          break;
+        }
+
+      cout << token << ": called " << stats.calls
+           << ", instructions " << stats.instructions
+           << ", inclusive time " << stats.inclusiveTime
+           << ", exclusive time " << stats.exclusiveTime << endl;
+
+      if (outFile != nullptr)
+        {
+          fprintf(outFile,
+                  "PROC %s %llu %llu %llu %llu\n",
+                  token.c_str(),
+                  stats.calls,
+                  stats.instructions,
+                  stats.inclusiveTime,
+                  stats.exclusiveTime);
+
+          for (const auto& c : counts)
+            fprintf(outFile, "AT %s %u %llu\n", token.c_str(), c.pos, c.count);
+        }
+
+      const size_t hotspots = min<size_t>(PROFILE_HOTSPOTS, counts.size());
+      partial_sort(counts.begin(),
+                   counts.begin() + hotspots,
+                   counts.end(),
+                   [](const WCodeCount& a, const WCodeCount& b) {
+                      return a.count > b.count;
+                   });
+
+      for (size_t i = 0; i < hotspots; ++i)
+        cout << "  @" << counts[i].pos << ": " << counts[i].count << endl;
+
+      token = CmdLineNextToken(cmdLine, linePos);
+    }
+
+  WClose(conHdl);
+
+  if (outFile != nullptr)
+    fclose(outFile);
+
+  if (cs != WCS_OK)
+    cout << wcmd_translate_status(cs) << endl;
+
+  return(cs == WCS_OK) ? true : false;
+}
+
+
+
 static const char execShowDesc[]    = "Execute a procedure. ";
 static const char execShowDescExt[] =
   "Execute a procedure on the remote server using the "
@@ -716,6 +968,22 @@ AddOnlineTableCommands()
 
   RegisterCommand(entry);
 
+  entry.mShowStatus   = true;
+  entry.mName         = "syncstat";
+  entry.mDesc         = syncShowDesc;
+  entry.mExtendedDesc = syncShowDescExt;
+  entry.mCmd          = cmdSyncStats;
+
+  RegisterCommand(entry);
+
+  entry.mShowStatus   = true;
+  entry.mName         = "profile";
+  entry.mDesc         = profShowDesc;
+  entry.mExtendedDesc = profShowDescExt;
+  entry.mCmd          = cmdProfile;
+
+  RegisterCommand(entry);
+
   entry.mShowStatus   = true;
   entry.mName         = "exec";
   entry.mDesc         = execShowDesc;
@@ -118,10 +118,19 @@ static const char tableAddIndDesc[]    = "Index the specified field tables.";
 static const char tableAddIndDescExt[] =
   "Index the values of the specified table fields for faster searching.\n"
   "Currently it does not support to index array nor text field types.\n"
+  "Fields joined by '+' are indexed together using a composite index, which\n"
+  "orders the rows by the first field, then by the second one and so on.\n"
+  "A field followed by ':bitmap' gets a bitmap index. These are suited for\n"
+  "BOOL, CHAR or UINT8 fields which hold only a few distinct values. Only\n"
+  "the choice is saved; the bitmaps are rebuilt in memory after a restart.\n"
   "Usage:\n"
   "  index table_name field_name [second_field_name ...]\n"
+  "  index table_name field_name+second_field_name[+...]\n"
+  "  index table_name field_name:bitmap\n"
   "Example:\n"
-  "  index mytab password_hash";
+  "  index mytab password_hash\n"
+  "  index orders customer+date\n"
+  "  index orders delivered:bitmap";
 
 static const char tableRmIndDesc[]    = "Remove the index associated with some"
                                         " table fields.";
@@ -129,8 +138,12 @@ static const char tableRmIndDescExt[] =
   "Remove the associated index of the specified table fields.\n"
   "Usage:\n"
   "  rmindex table_name field_name [second_field_name ...]\n"
+  "  rmindex table_name field_name+second_field_name[+...]\n"
+  "  rmindex table_name field_name:bitmap\n"
   "Example:\n"
-  "  rmindex mytab password_hash";
+  "  rmindex mytab password_hash\n"
+  "  rmindex orders customer+date\n"
+  "  rmindex orders delivered:bitmap";
 
 static const char rowsDesc[]    = "Manipulate table rows.";
 static const char rowsDescExt[] =
@@ -763,6 +776,40 @@ create_index_call_back(CreateIndexCallbackContext* cbContext)
 }
 
 
+static const char BITMAP_INDEX_SUFFIX[] = ":bitmap";
+
+
+static bool
+is_bitmap_index_spec(const string& spec)
+{
+  const size_t suffixLen = sizeof BITMAP_INDEX_SUFFIX - 1;
+
+  return (spec.length() > suffixLen)
+         && (spec.compare(spec.length() - suffixLen, suffixLen, BITMAP_INDEX_SUFFIX) == 0);
+}
+
+
+static vector<FIELD_INDEX>
+retrieve_composite_fields(ITable& table, const string& spec)
+{
+  vector<FIELD_INDEX> result;
+  size_t              from = 0;
+
+  while (true)
+    {
+      const size_t to = spec.find('+', from);
+
+      result.push_back(table.RetrieveField(spec.substr(from, to - from).c_str()));
+      if (to == string::npos)
+        break;
+
+      from = to + 1;
+    }
+
+  return result;
+}
+
+
 static bool
 cmdTableAddIndex(const string& cmdLine, ENTRY_CMD_CONTEXT context)
 {
@@ -803,6 +850,38 @@ cmdTableAddIndex(const string& cmdLine, ENTRY_CMD_CONTEXT context)
       {
         token = CmdLineNextToken(cmdLine, linePos);
 
+        if (token.find('+') != string::npos)
+          {
+            const vector<FIELD_INDEX> fields = retrieve_composite_fields(*table, token);
+
+            if ( ! table->IsCompositeIndexed(&fields[0], fields.size()))
+              {
+                if (level >= VL_INFO)
+                  {
+                    CreateIndexCallbackContext context;
+
+                    table->CreateCompositeIndex(&fields[0],
+                                                fields.size(),
+                                                create_index_call_back,
+                                                &context);
+                    cout << endl;
+                  }
+                else
+                  table->CreateCompositeIndex(&fields[0], fields.size(), nullptr, nullptr);
+              }
+            continue;
+          }
+        else if (is_bitmap_index_spec(token))
+          {
+            const string name = token.substr(0, token.length() - sizeof BITMAP_INDEX_SUFFIX + 1);
+            const FIELD_INDEX field = table->RetrieveField(name.c_str());
+
+            if ( ! table->IsBitmapIndexed(field))
+              table->CreateBitmapIndex(field);
+
+            continue;
+          }
+
         const FIELD_INDEX field = table->RetrieveField(token.c_str());
 
         if ( ! table->IsIndexed(field))
@@ -887,6 +966,40 @@ cmdTableRmIndex(const string& cmdLine, ENTRY_CMD_CONTEXT context)
       {
         token = CmdLineNextToken(cmdLine, linePos);
 
+        if (token.find('+') != string::npos)
+          {
+            const vector<FIELD_INDEX> fields = retrieve_composite_fields(*table, token);
+
+            if (table->IsCompositeIndexed(&fields[0], fields.size()))
+              {
+                if (level >= VL_INFO)
+                  cout << "Removing composite index for '" << token << "'.\n";
+
+                table->RemoveCompositeIndex(&fields[0], fields.size());
+              }
+            else if (level > VL_INFO)
+              cout << "Ignoring fields '" << token << "'.\n";
+
+            continue;
+          }
+        else if (is_bitmap_index_spec(token))
+          {
+            const string name = token.substr(0, token.length() - sizeof BITMAP_INDEX_SUFFIX + 1);
+            const FIELD_INDEX field = table->RetrieveField(name.c_str());
+
+            if (table->IsBitmapIndexed(field))
+              {
+                if (level >= VL_INFO)
+                  cout << "Removing bitmap index for '" << name << "'.\n";
+
+                table->RemoveBitmapIndex(field);
+              }
+            else if (level > VL_INFO)
+              cout << "Ignoring field '" << name << "'.\n";
+
+            continue;
+          }
+
         const FIELD_INDEX field = table->RetrieveField(token.c_str());
 
         if (table->IsIndexed(field))
@@ -0,0 +1,76 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef COMPACTCODE_H_
+#define COMPACTCODE_H_
+
+#include <vector>
+
+#include "whais.h"
+
+#include "whaisc.h"
+
+
+namespace whais
+{
+
+
+//Append a value using as few bytes as needed, 7 bits each, the lowest first.
+COMPILER_SHL void
+store_varint(const uint64_t value, std::vector<uint8_t>& out);
+
+//Read a value stored by 'store_varint()' from the first 'size' bytes of
+//'data'. Returns the count of bytes used and throws if the value is
+//truncated.
+COMPILER_SHL uint_t
+load_varint(const uint8_t* const data, const uint64_t size, uint64_t& outValue);
+
+//The count of bytes of the arguments following an opcode in a procedure's
+//code. Throws for the invalid opcodes.
+COMPILER_SHL uint_t
+code_args_size(const uint_t opcode);
+
+//Append the form a procedure's code is kept in the objects of version 2.
+//The opcodes are left as they are, the procedures, locals, globals and
+//constants indexes are stored with 'store_varint()' while the jumps keep the
+//signed count of instructions to their targets. Throws if the code cannot be
+//decoded.
+COMPILER_SHL void
+compact_proc_code(const uint8_t* const   code,
+                  const uint_t           codeSize,
+                  std::vector<uint8_t>&  out);
+
+//Restore in 'out' the code of 'codeSize' bytes a procedure had before
+//'compact_proc_code()'. Throws if the compact code is malformed or does not
+//expand to exactly 'codeSize' bytes.
+COMPILER_SHL void
+expand_proc_code(const uint8_t* const   compact,
+                 const uint_t           compactSize,
+                 uint8_t* const         out,
+                 const uint_t           codeSize);
+
+
+} //namespace whais
+
+#endif /* COMPACTCODE_H_ */
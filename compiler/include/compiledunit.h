@@ -65,6 +65,10 @@ public:
   virtual uint_t         GetProcLocalTypeOff(uint_t procId,
                                               uint_t localId) = 0;
   virtual bool_t         IsProcExternal(uint_t procId) = 0;
+
+  //Tell if the procedures' code was already checked by the interpreter,
+  //when the unit was linked by a previous run.
+  virtual bool_t         IsCodeVerified();
 };
 
 class COMPILER_SHL
@@ -89,7 +93,8 @@ public:
   CompiledBufferUnit(const uint8_t     *buffer,
                      uint_t             bufferSize,
                      WH_MESSENGER       messenger,
-                     WH_MESSENGER_CTXT  messengerContext);
+                     WH_MESSENGER_CTXT  messengerContext,
+                     const uint_t       options = 0);
   virtual ~CompiledBufferUnit() override;
 
   CompiledBufferUnit(CompiledBufferUnit&) = delete;
@@ -122,6 +127,9 @@ private:
   WH_COMPILED_UNIT mHandler;
 };
 
+//A compiled object file whose procedures' bodies are read on request. The
+//compact bodies of the second format version are expanded on load to the
+//fixed width code of the first one, the only code the interpreter executes.
 class COMPILER_SHL
 CompiledFileUnit : public WIFunctionalUnit
 {
@@ -163,6 +171,7 @@ private:
 #pragma warning(disable: 4251)
   File     mFile;
 #pragma warning(default: 4251)
+  uint8_t  mFormat;
   uint32_t mGlobalsCount;
   uint32_t mProcsCount;
   uint32_t mTypeAreaSize;
@@ -177,10 +186,103 @@ private:
   std::unique_ptr<uint8_t[]>  mConstArea;
   std::unique_ptr<uint8_t[]>  mGlobals;
   std::unique_ptr<uint8_t[]>  mProcs;
+  std::unique_ptr<uint32_t[]> mBodiesSizes;
   std::unique_ptr<uint8_t*[]> mProcData;
 #pragma warning(default: 4251)
 };
 
+//A compiled object file with the tables of its globals and procedures
+//resolved ahead and with its compact bodies expanded, so it may be loaded
+//by any number of sessions without going back to the file. The result, the
+//linked image, may be saved and then mapped by a later run instead of
+//linking the object again, as long as the object's hash still matches.
+class COMPILER_SHL
+CompiledImageUnit : public WIFunctionalUnit
+{
+
+public:
+  explicit CompiledImageUnit(const char *file);
+
+  //Map the image saved in 'imageFile', if it was linked from the same
+  //content of 'file' and it is not damaged. Otherwise link 'file' again.
+  CompiledImageUnit(const char *file, const char *imageFile);
+
+  virtual ~CompiledImageUnit() override;
+
+  CompiledImageUnit(CompiledImageUnit&) = delete;
+  CompiledImageUnit& operator= (CompiledImageUnit&) = delete;
+
+  uint64_t ObjectSize() const { return mObjectSize; }
+  uint64_t ObjectHash() const { return mObjectHash; }
+  uint64_t ImageSize() const { return mImageSize; }
+  bool     IsMapped() const { return mMapping != nullptr; }
+
+  //Keep the linked image for the next runs. A mapped image's code is not
+  //verified again, so save it only after the interpreter has loaded it.
+  void SaveImage(const char* const imageFile) const;
+
+  virtual bool_t         IsCodeVerified() override;
+
+  virtual uint_t         TypeAreaSize() override;
+  virtual const uint8_t* RetriveTypeArea() override;
+
+  virtual uint_t         GlobalsCount() override;
+  virtual uint_t         GlobalNameLength(const uint_t id) override;
+  virtual const char*    RetriveGlobalName(const uint_t id) override;
+  virtual uint_t         GlobalTypeOff(const uint_t id) override;
+  virtual bool_t         IsGlobalExternal(const uint_t id) override;
+  virtual uint_t         ConstsAreaSize() override;
+  virtual const uint8_t* RetrieveConstArea() override;
+
+  virtual uint_t         ProceduresCount() override;
+  virtual uint_t         ProcSyncStatementsCount(const uint_t id) override;
+  virtual uint_t         ProcCodeAreaSize(const uint_t id) override;
+  virtual const uint8_t* RetriveProcCodeArea(const uint_t id) override;
+  virtual uint_t         ProcLocalsCount(const uint_t id) override;
+  virtual uint_t         ProcParametersCount(const uint_t id) override;
+  virtual uint_t         GetProcReturnTypeOff(const uint_t id) override;
+  virtual uint_t         GetProcNameSize(const uint_t id) override;
+  virtual const char*    RetriveProcName(const uint_t id) override;
+  virtual uint_t         GetProcLocalTypeOff(uint_t procId, uint_t localId) override;
+  virtual bool_t         IsProcExternal(uint_t procId) override;
+
+private:
+  bool MapImage(const char* const imageFile,
+                const uint64_t    objectSize,
+                const uint64_t    objectHash);
+
+  void LinkObject(const uint8_t* const object,
+                  const uint64_t       objectSize,
+                  const uint64_t       objectHash);
+
+  void AttachImage(const uint8_t* const image, const uint64_t imageSize);
+
+  const uint8_t* Global(const uint_t id) const;
+  const uint8_t* Procedure(const uint_t id) const;
+
+  const uint8_t*  mBase;
+  uint64_t        mImageSize;
+  uint64_t        mObjectSize;
+  uint64_t        mObjectHash;
+  uint32_t        mGlobalsCount;
+  uint32_t        mProcsCount;
+  uint32_t        mTypeAreaSize;
+  uint32_t        mConstAreaSize;
+
+  const uint8_t*  mGlobals;
+  const uint8_t*  mProcs;
+  const uint8_t*  mLocalsTypes;
+  const uint8_t*  mTypeInfo;
+  const uint8_t*  mSymbols;
+  const uint8_t*  mConstArea;
+  const uint8_t*  mCode;
+
+#pragma warning(disable: 4251)
+  std::unique_ptr<uint8_t[]>    mImage;
+  std::unique_ptr<FileMapping>  mMapping;
+#pragma warning(default: 4251)
+};
+
 
 } //namespace whais
 
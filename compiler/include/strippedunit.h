@@ -0,0 +1,109 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#ifndef STRIPPEDUNIT_H_
+#define STRIPPEDUNIT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "whais.h"
+
+#include "compiledunit.h"
+
+
+namespace whais
+{
+
+
+//A unit that keeps only some of the globals and procedures of another one,
+//in their original order. The code of its procedures is changed to refer
+//them by their new indexes. The unit it is made of has to outlive it.
+class COMPILER_SHL
+StrippedUnit : public WIFunctionalUnit
+{
+public:
+  StrippedUnit(WIFunctionalUnit&           unit,
+               const std::vector<bool>&    keptGlobals,
+               const std::vector<bool>&    keptProcs);
+  virtual ~StrippedUnit() override;
+
+  StrippedUnit(StrippedUnit&) = delete;
+  StrippedUnit& operator= (StrippedUnit&) = delete;
+
+  virtual uint_t         TypeAreaSize() override;
+  virtual const uint8_t* RetriveTypeArea() override;
+  virtual uint_t         ConstsAreaSize() override;
+  virtual const uint8_t* RetrieveConstArea() override;
+
+  virtual uint_t         GlobalsCount() override;
+  virtual uint_t         GlobalNameLength(const uint_t id) override;
+  virtual const char*    RetriveGlobalName(const uint_t id) override;
+  virtual uint_t         GlobalTypeOff(const uint_t id) override;
+  virtual bool_t         IsGlobalExternal(const uint_t id) override;
+
+  virtual uint_t         ProceduresCount() override;
+  virtual uint_t         ProcSyncStatementsCount(const uint_t id) override;
+  virtual uint_t         ProcCodeAreaSize(const uint_t id) override;
+  virtual const uint8_t* RetriveProcCodeArea(const uint_t id) override;
+  virtual uint_t         ProcLocalsCount(const uint_t id) override;
+  virtual uint_t         ProcParametersCount(const uint_t id) override;
+  virtual uint_t         GetProcReturnTypeOff(const uint_t id) override;
+  virtual uint_t         GetProcNameSize(const uint_t id) override;
+  virtual const char*    RetriveProcName(const uint_t id) override;
+  virtual uint_t         GetProcLocalTypeOff(uint_t procId, uint_t localId) override;
+  virtual bool_t         IsProcExternal(uint_t procId) override;
+
+private:
+  uint_t Global(const uint_t id) const;
+  uint_t Procedure(const uint_t id) const;
+
+  WIFunctionalUnit&   mUnit;
+
+#pragma warning(disable: 4251)
+  std::vector<uint32_t>               mGlobals;   //The indexes in 'mUnit'.
+  std::vector<uint32_t>               mProcs;
+  std::vector<std::vector<uint8_t>>   mCodes;
+#pragma warning(default: 4251)
+};
+
+
+//Keep of the units, as they are to be loaded in this order, only what is
+//reached from the named entries. These are the procedures called by the
+//clients and the globals they read, and have to be defined by one of the
+//units. A procedure keeps the globals and procedures its code refers. The
+//external declarations are kept as they are used, but their definitions
+//found in the units are kept too. Throws if an entry is not defined or a
+//procedure's code cannot be decoded.
+COMPILER_SHL void
+strip_units(const std::vector<WIFunctionalUnit*>&          units,
+            const std::vector<std::string>&                entries,
+            std::vector<std::unique_ptr<StrippedUnit>>&    outUnits);
+
+
+} //namespace whais
+
+#endif /* STRIPPEDUNIT_H_ */
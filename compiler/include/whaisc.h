@@ -47,6 +47,9 @@ typedef void (*WH_MESSENGER)(WH_MESSENGER_CTXT   context,
 
 #define WHC_IGNORE_BUFFER_POS   ((uint_t)(-1))
 
+/* Compilation options. */
+#define WHC_OPTIMIZE_CODE       0x01
+
 
 typedef struct
 {
@@ -85,6 +88,15 @@ wh_compiler_load(const char* const   program,
                  WH_MESSENGER        messenger,
                  WH_MESSENGER_CTXT   messengerContext);
 
+/* Same as above, but with a set of compilation options
+   (e.g. WHC_OPTIMIZE_CODE). */
+WH_COMPILED_UNIT
+wh_compiler_load_options(const char* const   program,
+                         const uint_t        length,
+                         WH_MESSENGER        messenger,
+                         WH_MESSENGER_CTXT   messengerContext,
+                         const uint_t        options);
+
 /* Free the resources associated with a compiled unit. */
 void
 wh_compiler_discard(const WH_COMPILED_UNIT hnd);
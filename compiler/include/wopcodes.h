@@ -220,6 +220,89 @@ enum W_OPCODE
   W_AFOUT,
   W_AFIN,
 
+  /* The integer operators with both operands of the same known type, one
+   * for each type from T_INT8 to T_UINT64. */
+  W_ADDI8,
+  W_ADDI16,
+  W_ADDI32,
+  W_ADDI64,
+  W_ADDU8,
+  W_ADDU16,
+  W_ADDU32,
+  W_ADDU64,
+
+  W_SUBI8,
+  W_SUBI16,
+  W_SUBI32,
+  W_SUBI64,
+  W_SUBU8,
+  W_SUBU16,
+  W_SUBU32,
+  W_SUBU64,
+
+  W_MULI8,
+  W_MULI16,
+  W_MULI32,
+  W_MULI64,
+  W_MULU8,
+  W_MULU16,
+  W_MULU32,
+  W_MULU64,
+
+  W_EQI8,
+  W_EQI16,
+  W_EQI32,
+  W_EQI64,
+  W_EQU8,
+  W_EQU16,
+  W_EQU32,
+  W_EQU64,
+
+  W_NEI8,
+  W_NEI16,
+  W_NEI32,
+  W_NEI64,
+  W_NEU8,
+  W_NEU16,
+  W_NEU32,
+  W_NEU64,
+
+  W_LTI8,
+  W_LTI16,
+  W_LTI32,
+  W_LTI64,
+  W_LTU8,
+  W_LTU16,
+  W_LTU32,
+  W_LTU64,
+
+  W_LEI8,
+  W_LEI16,
+  W_LEI32,
+  W_LEI64,
+  W_LEU8,
+  W_LEU16,
+  W_LEU32,
+  W_LEU64,
+
+  W_GTI8,
+  W_GTI16,
+  W_GTI32,
+  W_GTI64,
+  W_GTU8,
+  W_GTU16,
+  W_GTU32,
+  W_GTU64,
+
+  W_GEI8,
+  W_GEI16,
+  W_GEI32,
+  W_GEI64,
+  W_GEU8,
+  W_GEU16,
+  W_GEU32,
+  W_GEU64,
+
   W_OP_END_MARK
 };
 
@@ -251,6 +334,99 @@ wh_compiler_encode_op(uint8_t* const        instrs,
   return (*instrs = opcode, 1);
 }
 
+/* The typed form of an integer operator whose operands are both of the given
+ * type, or the operator itself if it has no typed form. */
+static INLINE enum W_OPCODE
+wh_compiler_typed_op(const enum W_OPCODE   opcode,
+                     const uint_t          type)
+{
+  uint_t first;
+
+  if ((type < (uint_t)T_INT8) || (type > (uint_t)T_UINT64))
+    return opcode;
+
+  switch (opcode)
+  {
+  case W_ADD:
+    first = W_ADDI8;
+    break;
+
+  case W_SUB:
+    first = W_SUBI8;
+    break;
+
+  case W_MUL:
+  case W_MULU:
+    first = W_MULI8;
+    break;
+
+  case W_EQ:
+    first = W_EQI8;
+    break;
+
+  case W_NE:
+    first = W_NEI8;
+    break;
+
+  case W_LT:
+  case W_LTU:
+    first = W_LTI8;
+    break;
+
+  case W_LE:
+  case W_LEU:
+    first = W_LEI8;
+    break;
+
+  case W_GT:
+  case W_GTU:
+    first = W_GTI8;
+    break;
+
+  case W_GE:
+  case W_GEU:
+    first = W_GEI8;
+    break;
+
+  default:
+    return opcode;
+  }
+
+  return (enum W_OPCODE)(first + (type - (uint_t)T_INT8));
+}
+
+/* The type of the operands of a typed integer operator, or T_UNKNOWN. */
+static INLINE uint_t
+wh_compiler_typed_op_type(const enum W_OPCODE opcode)
+{
+  const uint_t op = opcode;
+
+  if ((op < (uint_t)W_ADDI8) || (op > (uint_t)W_GEU64))
+    return T_UNKNOWN;
+
+  return (uint_t)T_INT8 + (op - (uint_t)W_ADDI8) % ((uint_t)T_UINT64 - T_INT8 + 1);
+}
+
+/* The operator a typed integer operator stands for. */
+static INLINE enum W_OPCODE
+wh_compiler_untyped_op(const enum W_OPCODE opcode)
+{
+  static const enum W_OPCODE signedOps[] = {
+      W_ADD, W_SUB, W_MUL, W_EQ, W_NE, W_LT, W_LE, W_GT, W_GE
+    };
+  static const enum W_OPCODE unsignedOps[] = {
+      W_ADD, W_SUB, W_MULU, W_EQ, W_NE, W_LTU, W_LEU, W_GTU, W_GEU
+    };
+
+  const uint_t type = wh_compiler_typed_op_type(opcode);
+  const uint_t index = ((uint_t)opcode - W_ADDI8) / ((uint_t)T_UINT64 - T_INT8 + 1);
+
+  if (type == (uint_t)T_UNKNOWN)
+    return opcode;
+
+  return (type < (uint_t)T_UINT8) ? signedOps[index] : unsignedOps[index];
+}
+
 #ifdef __cplusplus
 }
 #endif
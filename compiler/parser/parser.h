@@ -186,6 +186,12 @@ struct ParserState
   struct Statement   *pCurrentStmt;  /* The current statement. */
   bool_t              abortError;    /* Set if parsing was aborted. */
   bool_t              externDecl;    /* Indicates the parsing of an external declaration. */
+  bool_t              optimize;      /* Optimize the procedures' code once compiled. */
+  enum INLINE_PRAGMA  inlinePragma;  /* Pragma found before the last PROCEDURE keyword. */
+  uint_t              procPos;       /* Where the last PROCEDURE keyword starts. */
+  uint_t              endProcPos;    /* Where the last ENDPROC keyword ends. */
+  struct Statement   *specialized;   /* Procedure compiled from the generic one's source. */
+  const struct Statement *generic;   /* The generic procedure being specialized. */
 };
 
 
@@ -0,0 +1,3131 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 1
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 9 "compiler/parser/whais.y"
+
+#define YYMAXDEPTH (256 * 1024)
+#define YYSTYPE struct SemValue*
+
+struct SemValue;
+struct ParserState;
+
+#include "../semantics/vardecl.h"
+#include "../semantics/expression.h"
+#include "../semantics/procdecl.h"
+#include "../semantics/brlo_stmts.h"
+#include "../semantics/table_stmts.h"
+
+int yylex(YYSTYPE *lvalp, struct ParserState *state);
+void yyerror(struct ParserState *state,  const char *msg);
+
+#define CHK_SEM_ERROR  { if (state->abortError != FALSE) YYABORT; }
+
+
+#line 91 "compiler/parser/whais.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "whais.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_ARRAY = 3,                      /* ARRAY  */
+  YYSYMBOL_BOOL = 4,                       /* BOOL  */
+  YYSYMBOL_BREAK = 5,                      /* BREAK  */
+  YYSYMBOL_CHAR = 6,                       /* CHAR  */
+  YYSYMBOL_CONTINUE = 7,                   /* CONTINUE  */
+  YYSYMBOL_DATE = 8,                       /* DATE  */
+  YYSYMBOL_DATETIME = 9,                   /* DATETIME  */
+  YYSYMBOL_DO = 10,                        /* DO  */
+  YYSYMBOL_ELSE = 11,                      /* ELSE  */
+  YYSYMBOL_END = 12,                       /* END  */
+  YYSYMBOL_ENDPROC = 13,                   /* ENDPROC  */
+  YYSYMBOL_ENDSYNC = 14,                   /* ENDSYNC  */
+  YYSYMBOL_EXTERN = 15,                    /* EXTERN  */
+  YYSYMBOL_FIELD = 16,                     /* FIELD  */
+  YYSYMBOL_FOR = 17,                       /* FOR  */
+  YYSYMBOL_HIRESTIME = 18,                 /* HIRESTIME  */
+  YYSYMBOL_IF = 19,                        /* IF  */
+  YYSYMBOL_INT8 = 20,                      /* INT8  */
+  YYSYMBOL_INT16 = 21,                     /* INT16  */
+  YYSYMBOL_INT32 = 22,                     /* INT32  */
+  YYSYMBOL_INT64 = 23,                     /* INT64  */
+  YYSYMBOL_PROCEDURE = 24,                 /* PROCEDURE  */
+  YYSYMBOL_REAL = 25,                      /* REAL  */
+  YYSYMBOL_RETURN = 26,                    /* RETURN  */
+  YYSYMBOL_RICHREAL = 27,                  /* RICHREAL  */
+  YYSYMBOL_SYNC = 28,                      /* SYNC  */
+  YYSYMBOL_TABLE = 29,                     /* TABLE  */
+  YYSYMBOL_TEXT = 30,                      /* TEXT  */
+  YYSYMBOL_UINT8 = 31,                     /* UINT8  */
+  YYSYMBOL_UINT16 = 32,                    /* UINT16  */
+  YYSYMBOL_UINT32 = 33,                    /* UINT32  */
+  YYSYMBOL_UINT64 = 34,                    /* UINT64  */
+  YYSYMBOL_UNDEFINED = 35,                 /* UNDEFINED  */
+  YYSYMBOL_UNTIL = 36,                     /* UNTIL  */
+  YYSYMBOL_VAR = 37,                       /* VAR  */
+  YYSYMBOL_WHILE = 38,                     /* WHILE  */
+  YYSYMBOL_WHAIS_NULL = 39,                /* WHAIS_NULL  */
+  YYSYMBOL_W_FALSE = 40,                   /* W_FALSE  */
+  YYSYMBOL_W_TRUE = 41,                    /* W_TRUE  */
+  YYSYMBOL_IDENTIFIER = 42,                /* IDENTIFIER  */
+  YYSYMBOL_WHAIS_INTEGER = 43,             /* WHAIS_INTEGER  */
+  YYSYMBOL_WHAIS_REAL = 44,                /* WHAIS_REAL  */
+  YYSYMBOL_WHAIS_TEXT = 45,                /* WHAIS_TEXT  */
+  YYSYMBOL_WHAIS_CHAR = 46,                /* WHAIS_CHAR  */
+  YYSYMBOL_WHAIS_TIME = 47,                /* WHAIS_TIME  */
+  YYSYMBOL_48_ = 48,                       /* '='  */
+  YYSYMBOL_SADD = 49,                      /* SADD  */
+  YYSYMBOL_SSUB = 50,                      /* SSUB  */
+  YYSYMBOL_SMUL = 51,                      /* SMUL  */
+  YYSYMBOL_SDIV = 52,                      /* SDIV  */
+  YYSYMBOL_SMOD = 53,                      /* SMOD  */
+  YYSYMBOL_SAND = 54,                      /* SAND  */
+  YYSYMBOL_SXOR = 55,                      /* SXOR  */
+  YYSYMBOL_SOR = 56,                       /* SOR  */
+  YYSYMBOL_57_ = 57,                       /* '?'  */
+  YYSYMBOL_58_ = 58,                       /* ':'  */
+  YYSYMBOL_EQ = 59,                        /* EQ  */
+  YYSYMBOL_NE = 60,                        /* NE  */
+  YYSYMBOL_AND = 61,                       /* AND  */
+  YYSYMBOL_62_ = 62,                       /* '&'  */
+  YYSYMBOL_OR = 63,                        /* OR  */
+  YYSYMBOL_64_ = 64,                       /* '|'  */
+  YYSYMBOL_XOR = 65,                       /* XOR  */
+  YYSYMBOL_66_ = 66,                       /* '^'  */
+  YYSYMBOL_67_ = 67,                       /* '<'  */
+  YYSYMBOL_68_ = 68,                       /* '>'  */
+  YYSYMBOL_LE = 69,                        /* LE  */
+  YYSYMBOL_GE = 70,                        /* GE  */
+  YYSYMBOL_71_ = 71,                       /* '+'  */
+  YYSYMBOL_72_ = 72,                       /* '-'  */
+  YYSYMBOL_73_ = 73,                       /* '*'  */
+  YYSYMBOL_74_ = 74,                       /* '/'  */
+  YYSYMBOL_75_ = 75,                       /* '%'  */
+  YYSYMBOL_NOT = 76,                       /* NOT  */
+  YYSYMBOL_77_ = 77,                       /* '!'  */
+  YYSYMBOL_78_ = 78,                       /* '~'  */
+  YYSYMBOL_UMINUS = 79,                    /* UMINUS  */
+  YYSYMBOL_80_ = 80,                       /* '@'  */
+  YYSYMBOL_FSELECT = 81,                   /* FSELECT  */
+  YYSYMBOL_82_ = 82,                       /* '['  */
+  YYSYMBOL_83_ = 83,                       /* ']'  */
+  YYSYMBOL_84_ = 84,                       /* '.'  */
+  YYSYMBOL_85_ = 85,                       /* '('  */
+  YYSYMBOL_86_ = 86,                       /* ')'  */
+  YYSYMBOL_87_ = 87,                       /* ';'  */
+  YYSYMBOL_88_ = 88,                       /* ','  */
+  YYSYMBOL_89_ = 89,                       /* '{'  */
+  YYSYMBOL_90_ = 90,                       /* '}'  */
+  YYSYMBOL_YYACCEPT = 91,                  /* $accept  */
+  YYSYMBOL_program = 92,                   /* program  */
+  YYSYMBOL_global_block_statement = 93,    /* global_block_statement  */
+  YYSYMBOL_94_1 = 94,                      /* $@1  */
+  YYSYMBOL_95_2 = 95,                      /* $@2  */
+  YYSYMBOL_var_decl_stmt = 96,             /* var_decl_stmt  */
+  YYSYMBOL_id_list = 97,                   /* id_list  */
+  YYSYMBOL_type_spec = 98,                 /* type_spec  */
+  YYSYMBOL_basic_type_spec = 99,           /* basic_type_spec  */
+  YYSYMBOL_array_type_spec = 100,          /* array_type_spec  */
+  YYSYMBOL_array_of_clause = 101,          /* array_of_clause  */
+  YYSYMBOL_field_type_spec = 102,          /* field_type_spec  */
+  YYSYMBOL_field_of_clause = 103,          /* field_of_clause  */
+  YYSYMBOL_table_type_spec = 104,          /* table_type_spec  */
+  YYSYMBOL_cont_clause = 105,              /* cont_clause  */
+  YYSYMBOL_container_type_decl = 106,      /* container_type_decl  */
+  YYSYMBOL_proc_decl_stmt = 107,           /* proc_decl_stmt  */
+  YYSYMBOL_108_3 = 108,                    /* $@3  */
+  YYSYMBOL_109_4 = 109,                    /* $@4  */
+  YYSYMBOL_extern_proc_decl_stmt = 110,    /* extern_proc_decl_stmt  */
+  YYSYMBOL_111_5 = 111,                    /* $@5  */
+  YYSYMBOL_local_block_statement = 112,    /* local_block_statement  */
+  YYSYMBOL_auto_decl_stmt = 113,           /* auto_decl_stmt  */
+  YYSYMBOL_copy_table_rows_fields_stmt = 114, /* copy_table_rows_fields_stmt  */
+  YYSYMBOL_one_statement = 115,            /* one_statement  */
+  YYSYMBOL_return_stmt = 116,              /* return_stmt  */
+  YYSYMBOL_procedure_parameter_decl = 117, /* procedure_parameter_decl  */
+  YYSYMBOL_list_of_paramaters_decl = 118,  /* list_of_paramaters_decl  */
+  YYSYMBOL_exp_stmt = 119,                 /* exp_stmt  */
+  YYSYMBOL_exp = 120,                      /* exp  */
+  YYSYMBOL_array_construction_type_spec = 121, /* array_construction_type_spec  */
+  YYSYMBOL_const_exp = 122,                /* const_exp  */
+  YYSYMBOL_parameters_list = 123,          /* parameters_list  */
+  YYSYMBOL_not_empty_parameters_list = 124, /* not_empty_parameters_list  */
+  YYSYMBOL_if_stmt = 125,                  /* if_stmt  */
+  YYSYMBOL_126_6 = 126,                    /* $@6  */
+  YYSYMBOL_127_7 = 127,                    /* $@7  */
+  YYSYMBOL_possible_no_else_if_clause = 128, /* possible_no_else_if_clause  */
+  YYSYMBOL_end_of_if_statement = 129,      /* end_of_if_statement  */
+  YYSYMBOL_else_if_clause = 130,           /* else_if_clause  */
+  YYSYMBOL_131_8 = 131,                    /* $@8  */
+  YYSYMBOL_132_9 = 132,                    /* $@9  */
+  YYSYMBOL_while_stmt = 133,               /* while_stmt  */
+  YYSYMBOL_134_10 = 134,                   /* $@10  */
+  YYSYMBOL_135_11 = 135,                   /* $@11  */
+  YYSYMBOL_until_stmt = 136,               /* until_stmt  */
+  YYSYMBOL_137_12 = 137,                   /* $@12  */
+  YYSYMBOL_for_stmt = 138,                 /* for_stmt  */
+  YYSYMBOL_139_13 = 139,                   /* $@13  */
+  YYSYMBOL_140_14 = 140,                   /* $@14  */
+  YYSYMBOL_141_15 = 141,                   /* $@15  */
+  YYSYMBOL_142_16 = 142,                   /* $@16  */
+  YYSYMBOL_143_17 = 143,                   /* $@17  */
+  YYSYMBOL_144_18 = 144,                   /* $@18  */
+  YYSYMBOL_break_stmt = 145,               /* break_stmt  */
+  YYSYMBOL_continue_stmt = 146,            /* continue_stmt  */
+  YYSYMBOL_syncronize_stmt = 147,          /* syncronize_stmt  */
+  YYSYMBOL_148_19 = 148                    /* $@19  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  14
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   1651
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  91
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  58
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  169
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  341
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   320
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    77,     2,     2,     2,    75,    62,     2,
+      85,    86,    73,    71,    88,    72,    84,    74,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    58,    87,
+      67,    48,    68,    57,    80,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    82,     2,    83,    66,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    89,    64,    90,    78,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    49,    50,    51,    52,    53,    54,    55,
+      56,    59,    60,    61,    63,    65,    69,    70,    76,    79,
+      81
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    97,    97,   100,   101,   102,   103,   105,   107,   104,
+     111,   113,   117,   119,   123,   125,   127,   129,   133,   135,
+     137,   139,   141,   145,   147,   149,   151,   153,   155,   157,
+     159,   161,   163,   165,   167,   171,   173,   178,   181,   185,
+     187,   192,   195,   197,   201,   206,   212,   221,   228,   235,
+     242,   252,   258,   251,   274,   273,   295,   296,   297,   298,
+     299,   302,   306,   308,   310,   312,   316,   317,   318,   319,
+     320,   321,   322,   323,   324,   327,   336,   337,   341,   346,
+     353,   361,   365,   370,   375,   380,   385,   390,   395,   400,
+     405,   410,   415,   420,   425,   430,   435,   440,   445,   450,
+     455,   460,   465,   470,   475,   480,   485,   490,   495,   500,
+     505,   510,   515,   520,   525,   530,   535,   540,   545,   550,
+     556,   561,   569,   572,   578,   583,   588,   593,   598,   603,
+     610,   617,   627,   630,   636,   641,   649,   648,   657,   656,
+     666,   670,   673,   678,   682,   681,   692,   691,   704,   703,
+     715,   714,   728,   727,   741,   740,   750,   749,   759,   758,
+     768,   767,   777,   776,   788,   787,   800,   807,   815,   814
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "ARRAY", "BOOL",
+  "BREAK", "CHAR", "CONTINUE", "DATE", "DATETIME", "DO", "ELSE", "END",
+  "ENDPROC", "ENDSYNC", "EXTERN", "FIELD", "FOR", "HIRESTIME", "IF",
+  "INT8", "INT16", "INT32", "INT64", "PROCEDURE", "REAL", "RETURN",
+  "RICHREAL", "SYNC", "TABLE", "TEXT", "UINT8", "UINT16", "UINT32",
+  "UINT64", "UNDEFINED", "UNTIL", "VAR", "WHILE", "WHAIS_NULL", "W_FALSE",
+  "W_TRUE", "IDENTIFIER", "WHAIS_INTEGER", "WHAIS_REAL", "WHAIS_TEXT",
+  "WHAIS_CHAR", "WHAIS_TIME", "'='", "SADD", "SSUB", "SMUL", "SDIV",
+  "SMOD", "SAND", "SXOR", "SOR", "'?'", "':'", "EQ", "NE", "AND", "'&'",
+  "OR", "'|'", "XOR", "'^'", "'<'", "'>'", "LE", "GE", "'+'", "'-'", "'*'",
+  "'/'", "'%'", "NOT", "'!'", "'~'", "UMINUS", "'@'", "FSELECT", "'['",
+  "']'", "'.'", "'('", "')'", "';'", "','", "'{'", "'}'", "$accept",
+  "program", "global_block_statement", "$@1", "$@2", "var_decl_stmt",
+  "id_list", "type_spec", "basic_type_spec", "array_type_spec",
+  "array_of_clause", "field_type_spec", "field_of_clause",
+  "table_type_spec", "cont_clause", "container_type_decl",
+  "proc_decl_stmt", "$@3", "$@4", "extern_proc_decl_stmt", "$@5",
+  "local_block_statement", "auto_decl_stmt", "copy_table_rows_fields_stmt",
+  "one_statement", "return_stmt", "procedure_parameter_decl",
+  "list_of_paramaters_decl", "exp_stmt", "exp",
+  "array_construction_type_spec", "const_exp", "parameters_list",
+  "not_empty_parameters_list", "if_stmt", "$@6", "$@7",
+  "possible_no_else_if_clause", "end_of_if_statement", "else_if_clause",
+  "$@8", "$@9", "while_stmt", "$@10", "$@11", "until_stmt", "$@12",
+  "for_stmt", "$@13", "$@14", "$@15", "$@16", "$@17", "$@18", "break_stmt",
+  "continue_stmt", "syncronize_stmt", "$@19", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-184)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-165)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+      75,    -2,   -14,    -6,    40,  -184,    75,    75,    75,    15,
+      51,  -184,  -184,   303,  -184,  -184,  -184,  -184,  -184,  -184,
+       6,   168,  -184,  -184,  -184,  -184,  1616,  -184,  -184,  -184,
+    -184,  -184,  -184,    11,  -184,    10,  -184,  -184,  -184,  -184,
+    -184,  -184,    59,    18,     8,    77,    99,  -184,    91,  -184,
+      24,    75,    68,  -184,  -184,   108,  -184,  -184,  -184,    80,
+    -184,  -184,  -184,  -184,  -184,    68,  -184,  1583,    37,  -184,
+    1616,    39,    45,    46,   101,   -67,    47,  -184,   107,    68,
+    1583,    80,    80,  1583,  -184,  -184,  -184,  -184,    58,   128,
+    -184,   334,    60,    61,  -184,    64,    70,   400,  -184,    79,
+    -184,  -184,  -184,   -43,  -184,  -184,  -184,  -184,  -184,   400,
+     400,   400,   400,   400,   225,   400,   334,   147,  -184,  -184,
+     334,  -184,  -184,   503,  -184,  -184,  -184,   334,  -184,  -184,
+    -184,   334,  -184,  -184,   334,   410,   400,    81,   628,   334,
+     400,   400,   400,   -55,   -55,   -55,   -55,   -55,    76,   828,
+     587,    78,  -184,  -184,  -184,   400,   400,   400,   400,   400,
+     400,   400,   400,   400,   400,   400,   400,   400,   400,   400,
+     400,   400,   400,   400,   400,   400,   400,   400,   400,    74,
+     400,   400,    85,   400,   127,  -184,    -6,  -184,  -184,   134,
+     -54,   461,   668,   867,   400,  -184,   164,   906,   708,    93,
+    -184,   400,  -184,   400,   168,  1432,  1432,  1432,  1432,  1432,
+    1432,  1432,  1432,  1432,  1062,   448,   448,   148,   148,   148,
+     148,   148,   148,   202,   202,   202,   202,    55,    55,   400,
+     -55,   -55,   -55,   400,  1099,   100,   -58,   400,   400,   -33,
+     400,   173,  -184,   175,  -184,  -184,  -184,  -184,  -184,  -184,
+     400,  1136,  1173,  -184,   400,   105,   748,   945,   400,   788,
+    -184,   390,   182,   390,  1432,   146,   149,  1210,   400,  -184,
+     186,   984,   400,   334,   193,   334,  -184,   400,   400,  -184,
+    1247,   390,   195,   196,  1023,    22,   200,  -184,  -184,   199,
+    1469,  1506,   165,  -184,   334,   390,   204,   214,  -184,  -184,
+    -184,   215,   390,  -184,   400,   400,   400,   223,  -184,   334,
+     390,   216,   334,  -184,  1284,  1321,   545,  -184,   224,  -184,
+     334,   226,   125,   150,   400,    -6,  -184,   227,  -184,  -184,
+    -184,  1358,   -53,  -184,   162,   169,  -184,   400,  1395,   166,
+    -184
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       3,     7,     0,     0,     0,     2,     3,     3,     3,     0,
+       0,    51,    12,     0,     1,     4,     5,     6,    54,     8,
+       0,    37,    18,    19,    20,    21,    41,    22,    23,    24,
+      25,    26,    27,     0,    28,    45,    29,    30,    31,    32,
+      33,    34,     0,     0,    14,    15,     0,    16,     0,    17,
+       0,     3,    76,    38,    36,    42,    43,    40,    11,     0,
+      44,    13,    10,    35,    39,    76,     9,     0,     0,    77,
+       0,     0,     0,    78,     0,    38,    50,    46,     0,     0,
+       0,     0,     0,     0,    79,    52,    47,    48,     0,     0,
+      55,    56,     0,     0,   152,     0,     0,     0,   168,     0,
+     129,   131,   130,    82,   124,   125,   126,   127,   128,     0,
+       0,     0,     0,     0,     0,     0,    56,     0,    67,    68,
+      56,    66,    69,     0,    81,    70,    71,    56,    72,    73,
+      74,    56,   166,   167,    56,     0,     0,    82,     0,    56,
+       0,     0,   132,    87,    85,    84,    86,    83,     0,     0,
+     134,     0,    57,    53,    58,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    80,     0,    59,    60,     0,
+      82,     0,     0,     0,     0,    75,     0,     0,     0,     0,
+     133,     0,   105,     0,   122,   109,   110,   111,   112,   113,
+     114,   115,   116,   117,     0,    97,    98,    99,   100,   101,
+     102,   103,   104,    93,    95,    94,    96,    88,    89,     0,
+      90,    91,    92,     0,     0,   107,     0,     0,     0,    82,
+       0,   138,   169,   150,    61,   119,   121,   135,   123,   120,
+       0,     0,     0,   106,     0,     0,     0,     0,     0,     0,
+     136,     0,     0,     0,   118,     0,     0,     0,     0,   153,
+     154,     0,     0,    56,   140,    56,   151,     0,     0,   108,
+       0,     0,     0,   158,     0,     0,   146,   139,   141,     0,
+       0,     0,     0,   155,    56,     0,     0,   162,   142,   137,
+     143,     0,     0,   149,     0,     0,     0,     0,   159,    56,
+       0,     0,    56,   147,     0,     0,     0,   157,     0,   163,
+      56,     0,   106,   106,     0,     0,   161,     0,   145,    64,
+      65,     0,     0,   165,   106,     0,    63,     0,     0,     0,
+      62
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -184,  -184,     2,  -184,  -184,    41,  -183,   -60,   -20,   -24,
+     240,  -184,   236,  -184,  -184,   -26,  -184,  -184,  -184,  -184,
+    -184,   -31,  -184,  -184,  -137,  -184,   217,   201,  -184,   -97,
+    -184,  -184,  -184,  -116,  -184,  -184,  -184,  -184,  -184,     0,
+    -184,  -184,  -184,  -184,  -184,  -184,  -184,  -184,  -184,  -184,
+    -184,  -184,  -184,  -184,  -184,  -184,  -184,  -184
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,     4,     5,    10,    51,   116,    13,    43,    44,    45,
+      46,    47,    48,    49,    60,    71,     7,    20,    89,     8,
+      50,   117,   118,   119,   120,   121,    68,    69,   122,   123,
+     249,   124,   199,   151,   125,   273,   261,   287,   299,   288,
+     301,   302,   126,   262,   263,   127,   134,   128,   281,   282,
+     295,   296,   310,   311,   129,   130,   131,   139
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+     138,    53,    56,   236,   238,   141,    55,    73,    15,    16,
+      17,   -38,   143,   144,   145,   146,   147,   149,   150,   -49,
+      85,    81,     9,    88,   -42,   258,   200,   183,    11,   184,
+      42,   142,   255,   286,   298,    42,    12,   335,   192,   193,
+      14,     6,   142,   197,   198,   150,    76,     6,     6,     6,
+      75,    19,   142,    66,   148,    86,    87,    18,   205,   206,
+     207,   208,   209,   210,   211,   212,   213,   214,   215,   216,
+     217,   218,   219,   220,   221,   222,   223,   224,   225,   226,
+     227,   228,   230,   231,   232,   152,   234,   247,     3,   154,
+       1,    52,     6,   -43,   145,    59,   187,   230,    58,     2,
+     188,    61,    63,   189,   246,    62,   150,    64,   196,    65,
+      67,   -38,     3,   100,   101,   102,   137,   104,   105,   106,
+     107,   108,    70,    74,   274,    77,   276,    80,   194,   180,
+     181,    78,   251,    83,    79,    82,   252,   183,    91,   184,
+     256,   257,   332,   259,   293,    90,   109,   132,   133,   135,
+     110,   111,   112,   264,   113,   136,   229,   267,   308,   114,
+     153,   271,   201,   115,   140,   313,   142,   233,   204,   235,
+     237,   280,    22,   319,    23,   284,    24,    25,   242,   245,
+     290,   291,   254,   260,   248,  -148,    27,   268,    28,    29,
+      30,    31,   275,    32,   277,    34,  -156,   278,    36,    37,
+      38,    39,    40,    41,   286,   294,  -160,   314,   315,   316,
+    -144,   303,   329,   306,   309,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,  -164,   312,   320,   331,    21,    22,
+     183,    23,   184,    24,    25,   317,   326,   330,   328,   333,
+     338,    26,   285,    27,   289,    28,    29,    30,    31,   336,
+      32,   337,    34,   340,    35,    36,    37,    38,    39,    40,
+      41,    54,    57,   307,   100,   101,   102,   137,   104,   105,
+     106,   107,   108,   177,   178,   194,   180,   181,   318,     0,
+      84,   321,    72,     0,   183,   300,   184,     0,     0,   327,
+       0,     0,     0,     0,     0,     0,     0,   109,     0,     0,
+       0,   110,   111,   112,     0,   113,    21,    22,     0,    23,
+     114,    24,    25,     0,   115,     0,     0,     0,     0,    26,
+       0,    27,     0,    28,    29,    30,    31,     0,    32,    33,
+      34,     0,    35,    36,    37,    38,    39,    40,    41,    92,
+       0,    93,     0,     0,    94,     0,     0,     0,     0,     0,
+       0,    95,     0,    96,     0,     0,     0,     0,     0,     0,
+      97,     0,    98,     0,     0,     0,     0,     0,     0,     0,
+       0,     3,    99,   100,   101,   102,   103,   104,   105,   106,
+     107,   108,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    42,     0,     0,     0,    92,     0,    93,     0,     0,
+       0,     0,     0,     0,     0,     0,   109,    95,     0,    96,
+     110,   111,   112,     0,   113,     0,    97,     0,     0,   114,
+       0,     0,     0,   115,     0,     0,     0,     0,    99,   100,
+     101,   102,   103,   104,   105,   106,   107,   108,     0,   100,
+     101,   102,   137,   104,   105,   106,   107,   108,     0,   100,
+     101,   102,   190,   104,   105,   106,   107,   108,     0,     0,
+       0,     0,   109,     0,     0,     0,   110,   111,   112,     0,
+     113,     0,   109,     0,     0,   114,   110,   111,   112,   115,
+     113,     0,   109,     0,     0,   114,   110,   191,   112,   115,
+     113,     0,     0,     0,     0,   114,     0,     0,     0,   115,
+     100,   101,   102,   239,   104,   105,   106,   107,   108,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,   109,     0,     0,     0,   110,   111,   112,
+       0,   113,     0,     0,     0,     0,   114,     0,     0,     0,
+     115,   155,   156,   157,   158,   159,   160,   161,   162,   163,
+     164,     0,   165,   166,   167,   168,   169,   170,   171,   172,
+     173,   174,   175,   176,   177,   178,   179,   180,   181,     0,
+     182,     0,     0,     0,     0,   183,     0,   184,     0,     0,
+     185,     0,   186,   155,   156,   157,   158,   159,   160,   161,
+     162,   163,   164,     0,   165,   166,   167,   168,   169,   170,
+     171,   172,   173,   174,   175,   176,   177,   178,   194,   180,
+     181,     0,     0,     0,     0,     0,     0,   324,     0,   184,
+       0,     0,     0,     0,   325,   155,   156,   157,   158,   159,
+     160,   161,   162,   163,   164,     0,   165,   166,   167,   168,
+     169,   170,   171,   172,   173,   174,   175,   176,   177,   178,
+     194,   180,   181,     0,     0,     0,     0,     0,     0,   183,
+       0,   184,     0,     0,     0,   203,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,     0,     0,   195,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,     0,     0,   240,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,     0,     0,   244,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,     0,     0,   269,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,     0,     0,   272,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,     0,   184,     0,   202,   155,   156,   157,   158,   159,
+     160,   161,   162,   163,   164,     0,   165,   166,   167,   168,
+     169,   170,   171,   172,   173,   174,   175,   176,   177,   178,
+     194,   180,   181,     0,     0,     0,     0,     0,     0,   183,
+       0,   184,     0,   241,   155,   156,   157,   158,   159,   160,
+     161,   162,   163,   164,     0,   165,   166,   167,   168,   169,
+     170,   171,   172,   173,   174,   175,   176,   177,   178,   194,
+     180,   181,     0,     0,     0,     0,     0,     0,   183,     0,
+     184,     0,   243,   155,   156,   157,   158,   159,   160,   161,
+     162,   163,   164,     0,   165,   166,   167,   168,   169,   170,
+     171,   172,   173,   174,   175,   176,   177,   178,   194,   180,
+     181,     0,     0,     0,     0,     0,     0,   183,     0,   184,
+       0,   270,   155,   156,   157,   158,   159,   160,   161,   162,
+     163,   164,     0,   165,   166,   167,   168,   169,   170,   171,
+     172,   173,   174,   175,   176,   177,   178,   194,   180,   181,
+       0,     0,     0,     0,     0,     0,   183,     0,   184,     0,
+     283,   155,   156,   157,   158,   159,   160,   161,   162,   163,
+     164,     0,   165,   166,   167,   168,   169,   170,   171,   172,
+     173,   174,   175,   176,   177,   178,   194,   180,   181,     0,
+       0,     0,     0,     0,     0,   183,     0,   184,     0,   297,
+     155,   156,   157,   158,   159,   160,   161,   162,   163,   164,
+     250,   165,   166,   167,   168,   169,   170,   171,   172,   173,
+     174,   175,   176,   177,   178,   194,   180,   181,     0,     0,
+       0,     0,     0,     0,   183,     0,   184,   155,   156,   157,
+     158,   159,   160,   161,   162,   163,   164,     0,   165,   166,
+     167,   168,   169,   170,   171,   172,   173,   174,   175,   176,
+     177,   178,   194,   180,   181,     0,     0,     0,     0,     0,
+       0,   183,   253,   184,   155,   156,   157,   158,   159,   160,
+     161,   162,   163,   164,     0,   165,   166,   167,   168,   169,
+     170,   171,   172,   173,   174,   175,   176,   177,   178,   194,
+     180,   181,     0,     0,     0,     0,     0,     0,   183,   265,
+     184,   155,   156,   157,   158,   159,   160,   161,   162,   163,
+     164,     0,   165,   166,   167,   168,   169,   170,   171,   172,
+     173,   174,   175,   176,   177,   178,   194,   180,   181,     0,
+       0,     0,     0,     0,     0,   183,   266,   184,   155,   156,
+     157,   158,   159,   160,   161,   162,   163,   164,     0,   165,
+     166,   167,   168,   169,   170,   171,   172,   173,   174,   175,
+     176,   177,   178,   194,   180,   181,     0,     0,     0,     0,
+       0,     0,   183,   279,   184,   155,   156,   157,   158,   159,
+     160,   161,   162,   163,   164,     0,   165,   166,   167,   168,
+     169,   170,   171,   172,   173,   174,   175,   176,   177,   178,
+     194,   180,   181,     0,     0,     0,     0,     0,     0,   183,
+     292,   184,   155,   156,   157,   158,   159,   160,   161,   162,
+     163,   164,     0,   165,   166,   167,   168,   169,   170,   171,
+     172,   173,   174,   175,   176,   177,   178,   194,   180,   181,
+       0,     0,     0,     0,     0,     0,   183,   322,   184,   155,
+     156,   157,   158,   159,   160,   161,   162,   163,   164,     0,
+     165,   166,   167,   168,   169,   170,   171,   172,   173,   174,
+     175,   176,   177,   178,   194,   180,   181,     0,     0,     0,
+       0,     0,     0,   183,   323,   184,   155,   156,   157,   158,
+     159,   160,   161,   162,   163,   164,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173,   174,   175,   176,   177,
+     178,   194,   180,   181,     0,     0,     0,     0,     0,     0,
+     183,   334,   184,   155,   156,   157,   158,   159,   160,   161,
+     162,   163,   164,     0,   165,   166,   167,   168,   169,   170,
+     171,   172,   173,   174,   175,   176,   177,   178,   194,   180,
+     181,     0,     0,     0,     0,     0,     0,   183,   339,   184,
+     155,   156,   157,   158,   159,   160,   161,   162,   163,   164,
+       0,   165,   166,   167,   168,   169,   170,   171,   172,   173,
+     174,   175,   176,   177,   178,   194,   180,   181,     0,     0,
+       0,     0,     0,     0,   183,     0,   184,   155,   156,   157,
+     158,   159,   160,   161,   162,   163,   164,     0,   165,   166,
+     167,   168,   169,   170,   171,   172,   173,   174,   175,   176,
+     177,   178,   194,   180,   181,     0,     0,     0,     0,     0,
+       0,   304,     0,   184,   155,   156,   157,   158,   159,   160,
+     161,   162,   163,   164,     0,   165,   166,   167,   168,   169,
+     170,   171,   172,   173,   174,   175,   176,   177,   178,   194,
+     180,   181,     0,     0,     0,     0,    21,    22,   305,    23,
+     184,    24,    25,     0,     0,     0,     0,     0,     0,    26,
+       0,    27,     0,    28,    29,    30,    31,     0,    32,     0,
+      34,     0,    35,    36,    37,    38,    39,    40,    41,    21,
+      22,     0,    23,     0,    24,    25,     0,     0,     0,     0,
+       0,     0,     0,     0,    27,     0,    28,    29,    30,    31,
+       0,    32,     0,    34,     0,     0,    36,    37,    38,    39,
+      40,    41
+};
+
+static const yytype_int16 yycheck[] =
+{
+      97,    21,    26,   186,    58,    48,    26,    67,     6,     7,
+       8,     3,   109,   110,   111,   112,   113,   114,   115,    86,
+      80,    88,    24,    83,    16,    58,   142,    82,    42,    84,
+      88,    85,    90,    11,    12,    88,    42,    90,   135,   136,
+       0,     0,    85,   140,   141,   142,    70,     6,     7,     8,
+      70,    10,    85,    51,   114,    81,    82,    42,   155,   156,
+     157,   158,   159,   160,   161,   162,   163,   164,   165,   166,
+     167,   168,   169,   170,   171,   172,   173,   174,   175,   176,
+     177,   178,   179,   180,   181,   116,   183,   203,    37,   120,
+      15,    85,    51,    16,   191,    85,   127,   194,    87,    24,
+     131,    42,     3,   134,   201,    87,   203,    16,   139,    85,
+      42,     3,    37,    39,    40,    41,    42,    43,    44,    45,
+      46,    47,    42,    86,   261,    86,   263,    26,    73,    74,
+      75,    86,   229,    26,    88,    88,   233,    82,    10,    84,
+     237,   238,   325,   240,   281,    87,    72,    87,    87,    85,
+      76,    77,    78,   250,    80,    85,    82,   254,   295,    85,
+      13,   258,    86,    89,    85,   302,    85,    82,    90,    42,
+      36,   268,     4,   310,     6,   272,     8,     9,    14,    86,
+     277,   278,    82,    10,   204,    10,    18,    82,    20,    21,
+      22,    23,    10,    25,    48,    27,    10,    48,    30,    31,
+      32,    33,    34,    35,    11,    10,    10,   304,   305,   306,
+      10,    12,    87,    48,    10,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    10,    10,    10,   324,     3,     4,
+      82,     6,    84,     8,     9,    12,    12,    87,    12,    12,
+     337,    16,   273,    18,   275,    20,    21,    22,    23,    87,
+      25,    82,    27,    87,    29,    30,    31,    32,    33,    34,
+      35,    21,    26,   294,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    71,    72,    73,    74,    75,   309,    -1,
+      79,   312,    65,    -1,    82,   285,    84,    -1,    -1,   320,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    72,    -1,    -1,
+      -1,    76,    77,    78,    -1,    80,     3,     4,    -1,     6,
+      85,     8,     9,    -1,    89,    -1,    -1,    -1,    -1,    16,
+      -1,    18,    -1,    20,    21,    22,    23,    -1,    25,    26,
+      27,    -1,    29,    30,    31,    32,    33,    34,    35,     5,
+      -1,     7,    -1,    -1,    10,    -1,    -1,    -1,    -1,    -1,
+      -1,    17,    -1,    19,    -1,    -1,    -1,    -1,    -1,    -1,
+      26,    -1,    28,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    37,    38,    39,    40,    41,    42,    43,    44,    45,
+      46,    47,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    88,    -1,    -1,    -1,     5,    -1,     7,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    72,    17,    -1,    19,
+      76,    77,    78,    -1,    80,    -1,    26,    -1,    -1,    85,
+      -1,    -1,    -1,    89,    -1,    -1,    -1,    -1,    38,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    -1,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    -1,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    -1,    -1,
+      -1,    -1,    72,    -1,    -1,    -1,    76,    77,    78,    -1,
+      80,    -1,    72,    -1,    -1,    85,    76,    77,    78,    89,
+      80,    -1,    72,    -1,    -1,    85,    76,    77,    78,    89,
+      80,    -1,    -1,    -1,    -1,    85,    -1,    -1,    -1,    89,
+      39,    40,    41,    42,    43,    44,    45,    46,    47,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    72,    -1,    -1,    -1,    76,    77,    78,
+      -1,    80,    -1,    -1,    -1,    -1,    85,    -1,    -1,    -1,
+      89,    48,    49,    50,    51,    52,    53,    54,    55,    56,
+      57,    -1,    59,    60,    61,    62,    63,    64,    65,    66,
+      67,    68,    69,    70,    71,    72,    73,    74,    75,    -1,
+      77,    -1,    -1,    -1,    -1,    82,    -1,    84,    -1,    -1,
+      87,    -1,    89,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    -1,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    -1,    -1,    -1,    -1,    -1,    -1,    82,    -1,    84,
+      -1,    -1,    -1,    -1,    89,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    -1,    59,    60,    61,    62,
+      63,    64,    65,    66,    67,    68,    69,    70,    71,    72,
+      73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,    82,
+      -1,    84,    -1,    -1,    -1,    88,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    -1,    -1,    87,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    -1,    -1,    87,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    -1,    -1,    87,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    -1,    -1,    87,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    -1,    -1,    87,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    -1,    84,    -1,    86,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    -1,    59,    60,    61,    62,
+      63,    64,    65,    66,    67,    68,    69,    70,    71,    72,
+      73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,    82,
+      -1,    84,    -1,    86,    48,    49,    50,    51,    52,    53,
+      54,    55,    56,    57,    -1,    59,    60,    61,    62,    63,
+      64,    65,    66,    67,    68,    69,    70,    71,    72,    73,
+      74,    75,    -1,    -1,    -1,    -1,    -1,    -1,    82,    -1,
+      84,    -1,    86,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    -1,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    -1,    -1,    -1,    -1,    -1,    -1,    82,    -1,    84,
+      -1,    86,    48,    49,    50,    51,    52,    53,    54,    55,
+      56,    57,    -1,    59,    60,    61,    62,    63,    64,    65,
+      66,    67,    68,    69,    70,    71,    72,    73,    74,    75,
+      -1,    -1,    -1,    -1,    -1,    -1,    82,    -1,    84,    -1,
+      86,    48,    49,    50,    51,    52,    53,    54,    55,    56,
+      57,    -1,    59,    60,    61,    62,    63,    64,    65,    66,
+      67,    68,    69,    70,    71,    72,    73,    74,    75,    -1,
+      -1,    -1,    -1,    -1,    -1,    82,    -1,    84,    -1,    86,
+      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
+      58,    59,    60,    61,    62,    63,    64,    65,    66,    67,
+      68,    69,    70,    71,    72,    73,    74,    75,    -1,    -1,
+      -1,    -1,    -1,    -1,    82,    -1,    84,    48,    49,    50,
+      51,    52,    53,    54,    55,    56,    57,    -1,    59,    60,
+      61,    62,    63,    64,    65,    66,    67,    68,    69,    70,
+      71,    72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,
+      -1,    82,    83,    84,    48,    49,    50,    51,    52,    53,
+      54,    55,    56,    57,    -1,    59,    60,    61,    62,    63,
+      64,    65,    66,    67,    68,    69,    70,    71,    72,    73,
+      74,    75,    -1,    -1,    -1,    -1,    -1,    -1,    82,    83,
+      84,    48,    49,    50,    51,    52,    53,    54,    55,    56,
+      57,    -1,    59,    60,    61,    62,    63,    64,    65,    66,
+      67,    68,    69,    70,    71,    72,    73,    74,    75,    -1,
+      -1,    -1,    -1,    -1,    -1,    82,    83,    84,    48,    49,
+      50,    51,    52,    53,    54,    55,    56,    57,    -1,    59,
+      60,    61,    62,    63,    64,    65,    66,    67,    68,    69,
+      70,    71,    72,    73,    74,    75,    -1,    -1,    -1,    -1,
+      -1,    -1,    82,    83,    84,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    -1,    59,    60,    61,    62,
+      63,    64,    65,    66,    67,    68,    69,    70,    71,    72,
+      73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,    82,
+      83,    84,    48,    49,    50,    51,    52,    53,    54,    55,
+      56,    57,    -1,    59,    60,    61,    62,    63,    64,    65,
+      66,    67,    68,    69,    70,    71,    72,    73,    74,    75,
+      -1,    -1,    -1,    -1,    -1,    -1,    82,    83,    84,    48,
+      49,    50,    51,    52,    53,    54,    55,    56,    57,    -1,
+      59,    60,    61,    62,    63,    64,    65,    66,    67,    68,
+      69,    70,    71,    72,    73,    74,    75,    -1,    -1,    -1,
+      -1,    -1,    -1,    82,    83,    84,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    -1,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,    -1,
+      82,    83,    84,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    -1,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    -1,    -1,    -1,    -1,    -1,    -1,    82,    83,    84,
+      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
+      -1,    59,    60,    61,    62,    63,    64,    65,    66,    67,
+      68,    69,    70,    71,    72,    73,    74,    75,    -1,    -1,
+      -1,    -1,    -1,    -1,    82,    -1,    84,    48,    49,    50,
+      51,    52,    53,    54,    55,    56,    57,    -1,    59,    60,
+      61,    62,    63,    64,    65,    66,    67,    68,    69,    70,
+      71,    72,    73,    74,    75,    -1,    -1,    -1,    -1,    -1,
+      -1,    82,    -1,    84,    48,    49,    50,    51,    52,    53,
+      54,    55,    56,    57,    -1,    59,    60,    61,    62,    63,
+      64,    65,    66,    67,    68,    69,    70,    71,    72,    73,
+      74,    75,    -1,    -1,    -1,    -1,     3,     4,    82,     6,
+      84,     8,     9,    -1,    -1,    -1,    -1,    -1,    -1,    16,
+      -1,    18,    -1,    20,    21,    22,    23,    -1,    25,    -1,
+      27,    -1,    29,    30,    31,    32,    33,    34,    35,     3,
+       4,    -1,     6,    -1,     8,     9,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    18,    -1,    20,    21,    22,    23,
+      -1,    25,    -1,    27,    -1,    -1,    30,    31,    32,    33,
+      34,    35
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_uint8 yystos[] =
+{
+       0,    15,    24,    37,    92,    93,    96,   107,   110,    24,
+      94,    42,    42,    97,     0,    93,    93,    93,    42,    96,
+     108,     3,     4,     6,     8,     9,    16,    18,    20,    21,
+      22,    23,    25,    26,    27,    29,    30,    31,    32,    33,
+      34,    35,    88,    98,    99,   100,   101,   102,   103,   104,
+     111,    95,    85,    99,   101,    99,   100,   103,    87,    85,
+     105,    42,    87,     3,    16,    85,    93,    42,   117,   118,
+      42,   106,   117,    98,    86,    99,   100,    86,    86,    88,
+      26,    88,    88,    26,   118,    98,   106,   106,    98,   109,
+      87,    10,     5,     7,    10,    17,    19,    26,    28,    38,
+      39,    40,    41,    42,    43,    44,    45,    46,    47,    72,
+      76,    77,    78,    80,    85,    89,    96,   112,   113,   114,
+     115,   116,   119,   120,   122,   125,   133,   136,   138,   145,
+     146,   147,    87,    87,   137,    85,    85,    42,   120,   148,
+      85,    48,    85,   120,   120,   120,   120,   120,    98,   120,
+     120,   124,   112,    13,   112,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    59,    60,    61,    62,    63,
+      64,    65,    66,    67,    68,    69,    70,    71,    72,    73,
+      74,    75,    77,    82,    84,    87,    89,   112,   112,   112,
+      42,    77,   120,   120,    73,    87,   112,   120,   120,   123,
+     124,    86,    86,    88,    90,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,    82,
+     120,   120,   120,    82,   120,    42,    97,    36,    58,    42,
+      87,    86,    14,    86,    87,    86,   120,   124,    99,   121,
+      58,   120,   120,    83,    82,    90,   120,   120,    58,   120,
+      10,   127,   134,   135,   120,    83,    83,   120,    82,    87,
+      86,   120,    87,   126,   115,    10,   115,    48,    48,    83,
+     120,   139,   140,    86,   120,   112,    11,   128,   130,   112,
+     120,   120,    83,   115,    10,   141,   142,    86,    12,   129,
+     130,   131,   132,    12,    82,    82,    48,   112,   115,    10,
+     143,   144,    10,   115,   120,   120,   120,    12,   112,   115,
+      10,   112,    83,    83,    82,    89,    12,   112,    12,    87,
+      87,   120,    97,    12,    83,    90,    87,    82,   120,    83,
+      87
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_uint8 yyr1[] =
+{
+       0,    91,    92,    93,    93,    93,    93,    94,    95,    93,
+      96,    96,    97,    97,    98,    98,    98,    98,    99,    99,
+      99,    99,    99,    99,    99,    99,    99,    99,    99,    99,
+      99,    99,    99,    99,    99,   100,   100,   101,   101,   102,
+     102,   103,   103,   103,   104,   105,   105,   106,   106,   106,
+     106,   108,   109,   107,   111,   110,   112,   112,   112,   112,
+     112,   113,   114,   114,   114,   114,   115,   115,   115,   115,
+     115,   115,   115,   115,   115,   116,   117,   117,   118,   118,
+     119,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   121,   121,   122,   122,   122,   122,   122,   122,
+     122,   122,   123,   123,   124,   124,   126,   125,   127,   125,
+     128,   128,   129,   129,   131,   130,   132,   130,   134,   133,
+     135,   133,   137,   136,   139,   138,   140,   138,   141,   138,
+     142,   138,   143,   138,   144,   138,   145,   146,   148,   147
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     0,     2,     2,     2,     0,     0,     5,
+       4,     4,     1,     3,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     2,     2,     0,     1,     2,
+       2,     0,     1,     1,     2,     0,     3,     4,     4,     2,
+       2,     0,     0,    12,     0,    10,     0,     2,     2,     2,
+       2,     4,    16,    13,    11,    11,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     3,     0,     1,     2,     4,
+       2,     1,     1,     2,     2,     2,     2,     2,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     4,     3,     6,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     5,     4,
+       4,     4,     0,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     0,     1,     1,     3,     0,     8,     0,     7,
+       0,     1,     1,     1,     0,     5,     0,     3,     0,     8,
+       0,     6,     0,     6,     0,     8,     0,    10,     0,     9,
+       0,    11,     0,    10,     0,    12,     2,     2,     0,     4
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (state, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, state); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, struct ParserState *state)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (state);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, struct ParserState *state)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, state);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, struct ParserState *state)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], state);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, state); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, struct ParserState *state)
+{
+  YY_USE (yyvaluep);
+  YY_USE (state);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (struct ParserState *state)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, state);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 7: /* $@1: %empty  */
+#line 105 "compiler/parser/whais.y"
+                            { state->externDecl = TRUE; }
+#line 1741 "compiler/parser/whais.tab.c"
+    break;
+
+  case 8: /* $@2: %empty  */
+#line 107 "compiler/parser/whais.y"
+                            { state->externDecl = FALSE; }
+#line 1747 "compiler/parser/whais.tab.c"
+    break;
+
+  case 10: /* var_decl_stmt: VAR id_list type_spec ';'  */
+#line 112 "compiler/parser/whais.y"
+                  { yyval = add_list_declaration (state, yyvsp[-2], yyvsp[-1]); CHK_SEM_ERROR; }
+#line 1753 "compiler/parser/whais.tab.c"
+    break;
+
+  case 11: /* var_decl_stmt: VAR id_list RETURN ';'  */
+#line 114 "compiler/parser/whais.y"
+                  { yyval = add_list_declaration (state, yyvsp[-2], NULL); CHK_SEM_ERROR; }
+#line 1759 "compiler/parser/whais.tab.c"
+    break;
+
+  case 12: /* id_list: IDENTIFIER  */
+#line 118 "compiler/parser/whais.y"
+            { yyval = add_id_to_list(NULL, yyvsp[0]); }
+#line 1765 "compiler/parser/whais.tab.c"
+    break;
+
+  case 13: /* id_list: id_list ',' IDENTIFIER  */
+#line 120 "compiler/parser/whais.y"
+               { yyval = add_id_to_list(yyvsp[-2], yyvsp[0]); }
+#line 1771 "compiler/parser/whais.tab.c"
+    break;
+
+  case 14: /* type_spec: basic_type_spec  */
+#line 124 "compiler/parser/whais.y"
+            { yyval = yyvsp[0]; }
+#line 1777 "compiler/parser/whais.tab.c"
+    break;
+
+  case 15: /* type_spec: array_type_spec  */
+#line 126 "compiler/parser/whais.y"
+             { yyval = yyvsp[0]; }
+#line 1783 "compiler/parser/whais.tab.c"
+    break;
+
+  case 16: /* type_spec: field_type_spec  */
+#line 128 "compiler/parser/whais.y"
+            { yyval = yyvsp[0]; }
+#line 1789 "compiler/parser/whais.tab.c"
+    break;
+
+  case 17: /* type_spec: table_type_spec  */
+#line 130 "compiler/parser/whais.y"
+             { yyval = yyvsp[0]; }
+#line 1795 "compiler/parser/whais.tab.c"
+    break;
+
+  case 18: /* basic_type_spec: BOOL  */
+#line 134 "compiler/parser/whais.y"
+                    { yyval = create_type_spec(state, T_BOOL); CHK_SEM_ERROR; }
+#line 1801 "compiler/parser/whais.tab.c"
+    break;
+
+  case 19: /* basic_type_spec: CHAR  */
+#line 136 "compiler/parser/whais.y"
+                    { yyval = create_type_spec(state, T_CHAR); CHK_SEM_ERROR; }
+#line 1807 "compiler/parser/whais.tab.c"
+    break;
+
+  case 20: /* basic_type_spec: DATE  */
+#line 138 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_DATE); CHK_SEM_ERROR; }
+#line 1813 "compiler/parser/whais.tab.c"
+    break;
+
+  case 21: /* basic_type_spec: DATETIME  */
+#line 140 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_DATETIME); CHK_SEM_ERROR;}
+#line 1819 "compiler/parser/whais.tab.c"
+    break;
+
+  case 22: /* basic_type_spec: HIRESTIME  */
+#line 142 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_HIRESTIME);
+                        CHK_SEM_ERROR;
+                       }
+#line 1827 "compiler/parser/whais.tab.c"
+    break;
+
+  case 23: /* basic_type_spec: INT8  */
+#line 146 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_INT8); CHK_SEM_ERROR; }
+#line 1833 "compiler/parser/whais.tab.c"
+    break;
+
+  case 24: /* basic_type_spec: INT16  */
+#line 148 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_INT16); CHK_SEM_ERROR; }
+#line 1839 "compiler/parser/whais.tab.c"
+    break;
+
+  case 25: /* basic_type_spec: INT32  */
+#line 150 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_INT32); CHK_SEM_ERROR; }
+#line 1845 "compiler/parser/whais.tab.c"
+    break;
+
+  case 26: /* basic_type_spec: INT64  */
+#line 152 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_INT64);  CHK_SEM_ERROR; }
+#line 1851 "compiler/parser/whais.tab.c"
+    break;
+
+  case 27: /* basic_type_spec: REAL  */
+#line 154 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_REAL); CHK_SEM_ERROR; }
+#line 1857 "compiler/parser/whais.tab.c"
+    break;
+
+  case 28: /* basic_type_spec: RICHREAL  */
+#line 156 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_RICHREAL); CHK_SEM_ERROR;}
+#line 1863 "compiler/parser/whais.tab.c"
+    break;
+
+  case 29: /* basic_type_spec: TEXT  */
+#line 158 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_TEXT); CHK_SEM_ERROR; }
+#line 1869 "compiler/parser/whais.tab.c"
+    break;
+
+  case 30: /* basic_type_spec: UINT8  */
+#line 160 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_UINT8);  CHK_SEM_ERROR; }
+#line 1875 "compiler/parser/whais.tab.c"
+    break;
+
+  case 31: /* basic_type_spec: UINT16  */
+#line 162 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_UINT16); CHK_SEM_ERROR; }
+#line 1881 "compiler/parser/whais.tab.c"
+    break;
+
+  case 32: /* basic_type_spec: UINT32  */
+#line 164 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_UINT32);  CHK_SEM_ERROR; }
+#line 1887 "compiler/parser/whais.tab.c"
+    break;
+
+  case 33: /* basic_type_spec: UINT64  */
+#line 166 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_UINT64);  CHK_SEM_ERROR; }
+#line 1893 "compiler/parser/whais.tab.c"
+    break;
+
+  case 34: /* basic_type_spec: UNDEFINED  */
+#line 168 "compiler/parser/whais.y"
+                       { yyval = create_type_spec(state, T_UNDETERMINED);  CHK_SEM_ERROR; }
+#line 1899 "compiler/parser/whais.tab.c"
+    break;
+
+  case 35: /* array_type_spec: array_of_clause ARRAY  */
+#line 172 "compiler/parser/whais.y"
+                    {    yyval = yyvsp[-1]; MARK_ARRAY ((yyval)->val.u_tspec.type); }
+#line 1905 "compiler/parser/whais.tab.c"
+    break;
+
+  case 36: /* array_type_spec: ARRAY array_of_clause  */
+#line 174 "compiler/parser/whais.y"
+                    {    yyval = yyvsp[0]; MARK_ARRAY ((yyval)->val.u_tspec.type); }
+#line 1911 "compiler/parser/whais.tab.c"
+    break;
+
+  case 37: /* array_of_clause: %empty  */
+#line 178 "compiler/parser/whais.y"
+                    { yyval = create_type_spec(state, T_UNDETERMINED); 
+                      CHK_SEM_ERROR;
+                    }
+#line 1919 "compiler/parser/whais.tab.c"
+    break;
+
+  case 38: /* array_of_clause: basic_type_spec  */
+#line 182 "compiler/parser/whais.y"
+                    { yyval = yyvsp[0]; }
+#line 1925 "compiler/parser/whais.tab.c"
+    break;
+
+  case 39: /* field_type_spec: field_of_clause FIELD  */
+#line 186 "compiler/parser/whais.y"
+                    {   yyval = yyvsp[-1]; MARK_FIELD ((yyval)->val.u_tspec.type); }
+#line 1931 "compiler/parser/whais.tab.c"
+    break;
+
+  case 40: /* field_type_spec: FIELD field_of_clause  */
+#line 188 "compiler/parser/whais.y"
+                    {   yyval = yyvsp[0]; MARK_FIELD ((yyval)->val.u_tspec.type); }
+#line 1937 "compiler/parser/whais.tab.c"
+    break;
+
+  case 41: /* field_of_clause: %empty  */
+#line 192 "compiler/parser/whais.y"
+                    { yyval = create_type_spec(state, T_UNDETERMINED); 
+                      CHK_SEM_ERROR;
+                    }
+#line 1945 "compiler/parser/whais.tab.c"
+    break;
+
+  case 42: /* field_of_clause: basic_type_spec  */
+#line 196 "compiler/parser/whais.y"
+                    { yyval = yyvsp[0]; }
+#line 1951 "compiler/parser/whais.tab.c"
+    break;
+
+  case 43: /* field_of_clause: array_type_spec  */
+#line 198 "compiler/parser/whais.y"
+                    { yyval = yyvsp[0]; }
+#line 1957 "compiler/parser/whais.tab.c"
+    break;
+
+  case 44: /* table_type_spec: TABLE cont_clause  */
+#line 202 "compiler/parser/whais.y"
+                 { MARK_TABLE (yyvsp[0]->val.u_tspec.type); yyval = yyvsp[0]; }
+#line 1963 "compiler/parser/whais.tab.c"
+    break;
+
+  case 45: /* cont_clause: %empty  */
+#line 206 "compiler/parser/whais.y"
+             {
+                /* set the type spec later */
+                yyval = create_type_spec(state, 0);
+                CHK_SEM_ERROR;
+                yyval->val.u_tspec.extra = NULL;
+             }
+#line 1974 "compiler/parser/whais.tab.c"
+    break;
+
+  case 46: /* cont_clause: '(' container_type_decl ')'  */
+#line 213 "compiler/parser/whais.y"
+                 {
+                 /* set the type spec later */
+                yyval = create_type_spec(state, 0);
+                CHK_SEM_ERROR;
+                yyval->val.u_tspec.extra = yyvsp[-1];                     
+                }
+#line 1985 "compiler/parser/whais.tab.c"
+    break;
+
+  case 47: /* container_type_decl: IDENTIFIER basic_type_spec ',' container_type_decl  */
+#line 222 "compiler/parser/whais.y"
+                        {
+                            MARK_TABLE_FIELD (yyvsp[-2]->val.u_tspec.type);
+                            yyval = add_field_declaration(state,
+                                yyvsp[-3], yyvsp[-2], (struct DeclaredVar *)yyvsp[0]);
+                            CHK_SEM_ERROR;
+                        }
+#line 1996 "compiler/parser/whais.tab.c"
+    break;
+
+  case 48: /* container_type_decl: IDENTIFIER array_type_spec ',' container_type_decl  */
+#line 229 "compiler/parser/whais.y"
+                        {
+                            MARK_TABLE_FIELD (yyvsp[-2]->val.u_tspec.type);
+                            yyval = add_field_declaration(state,
+                                yyvsp[-3], yyvsp[-2], (struct DeclaredVar *)yyvsp[0]);
+                            CHK_SEM_ERROR;
+                        }
+#line 2007 "compiler/parser/whais.tab.c"
+    break;
+
+  case 49: /* container_type_decl: IDENTIFIER basic_type_spec  */
+#line 236 "compiler/parser/whais.y"
+                        {
+                            MARK_TABLE_FIELD (yyvsp[0]->val.u_tspec.type);
+                            yyval = add_field_declaration(state,
+                                yyvsp[-1], yyvsp[0], NULL);
+                            CHK_SEM_ERROR;
+                        }
+#line 2018 "compiler/parser/whais.tab.c"
+    break;
+
+  case 50: /* container_type_decl: IDENTIFIER array_type_spec  */
+#line 243 "compiler/parser/whais.y"
+                        {
+                            MARK_TABLE_FIELD (yyvsp[0]->val.u_tspec.type);
+                            yyval = add_field_declaration(state,
+                                yyvsp[-1], yyvsp[0], NULL);
+                            CHK_SEM_ERROR;
+                        }
+#line 2029 "compiler/parser/whais.tab.c"
+    break;
+
+  case 51: /* $@3: %empty  */
+#line 252 "compiler/parser/whais.y"
+                    {
+                        install_proc_decl(state, yyvsp[0]);
+                        CHK_SEM_ERROR;
+                    }
+#line 2038 "compiler/parser/whais.tab.c"
+    break;
+
+  case 52: /* $@4: %empty  */
+#line 258 "compiler/parser/whais.y"
+                    {
+                        install_proc_args(state, yyvsp[-3]);
+                        CHK_SEM_ERROR;
+                        set_proc_rettype(state, yyvsp[0]);
+                        CHK_SEM_ERROR;
+                    }
+#line 2049 "compiler/parser/whais.tab.c"
+    break;
+
+  case 53: /* proc_decl_stmt: PROCEDURE IDENTIFIER $@3 '(' procedure_parameter_decl ')' RETURN type_spec $@4 DO local_block_statement ENDPROC  */
+#line 266 "compiler/parser/whais.y"
+                    {
+                        finish_proc_decl(state);
+                        yyval = NULL;
+                        CHK_SEM_ERROR;
+                    }
+#line 2059 "compiler/parser/whais.tab.c"
+    break;
+
+  case 54: /* $@5: %empty  */
+#line 274 "compiler/parser/whais.y"
+                            {
+                                state->externDecl = TRUE;
+                                install_proc_decl(state, yyvsp[0]);
+                                state->externDecl = FALSE;
+                                CHK_SEM_ERROR;
+                            }
+#line 2070 "compiler/parser/whais.tab.c"
+    break;
+
+  case 55: /* extern_proc_decl_stmt: EXTERN PROCEDURE IDENTIFIER $@5 '(' procedure_parameter_decl ')' RETURN type_spec ';'  */
+#line 282 "compiler/parser/whais.y"
+                            {
+                                install_proc_args(state, yyvsp[-4]);
+                                CHK_SEM_ERROR;
+                                set_proc_rettype(state, yyvsp[-1]);
+                                CHK_SEM_ERROR;
+                                state->externDecl = TRUE;
+                                finish_proc_decl(state);
+                                CHK_SEM_ERROR;
+                                state->externDecl = FALSE;
+                                yyval = NULL;
+                            }
+#line 2086 "compiler/parser/whais.tab.c"
+    break;
+
+  case 61: /* auto_decl_stmt: IDENTIFIER '=' exp ';'  */
+#line 303 "compiler/parser/whais.y"
+                  { yyval = add_auto_declaration (state, yyvsp[-3], yyvsp[-1]); CHK_SEM_ERROR; }
+#line 2092 "compiler/parser/whais.tab.c"
+    break;
+
+  case 62: /* copy_table_rows_fields_stmt: exp '{' id_list '}' '[' exp ']' '=' exp '{' id_list '}' '[' exp ']' ';'  */
+#line 307 "compiler/parser/whais.y"
+                        { yyval = translate_row_copy(state, yyvsp[-15], yyvsp[-13], yyvsp[-10], yyvsp[-7], yyvsp[-5], yyvsp[-2]); }
+#line 2098 "compiler/parser/whais.tab.c"
+    break;
+
+  case 63: /* copy_table_rows_fields_stmt: exp '{' id_list '}' '[' exp ']' '=' exp '[' exp ']' ';'  */
+#line 309 "compiler/parser/whais.y"
+                        { yyval = translate_row_copy(state, yyvsp[-12], yyvsp[-10], yyvsp[-7], yyvsp[-4], NULL, yyvsp[-2]); }
+#line 2104 "compiler/parser/whais.tab.c"
+    break;
+
+  case 64: /* copy_table_rows_fields_stmt: exp '*' '[' exp ']' '=' exp '[' exp ']' ';'  */
+#line 311 "compiler/parser/whais.y"
+                        { yyval = translate_row_copy(state, yyvsp[-10], NULL, yyvsp[-7], yyvsp[-4], NULL, yyvsp[-2]); }
+#line 2110 "compiler/parser/whais.tab.c"
+    break;
+
+  case 65: /* copy_table_rows_fields_stmt: exp '!' '[' exp ']' '=' exp '[' exp ']' ';'  */
+#line 313 "compiler/parser/whais.y"
+                        { yyval = translate_row_copy_free(state, yyvsp[-10], yyvsp[-7], yyvsp[-4], yyvsp[-2]); }
+#line 2116 "compiler/parser/whais.tab.c"
+    break;
+
+  case 75: /* return_stmt: RETURN exp ';'  */
+#line 328 "compiler/parser/whais.y"
+                {
+                   check_for_dead_statement (state);
+                   yyval = translate_return_exp(state, yyvsp[-1]); 
+                   CHK_SEM_ERROR;
+                }
+#line 2126 "compiler/parser/whais.tab.c"
+    break;
+
+  case 76: /* procedure_parameter_decl: %empty  */
+#line 336 "compiler/parser/whais.y"
+                            { yyval = NULL; }
+#line 2132 "compiler/parser/whais.tab.c"
+    break;
+
+  case 77: /* procedure_parameter_decl: list_of_paramaters_decl  */
+#line 338 "compiler/parser/whais.y"
+                            { yyval = yyvsp[0]; }
+#line 2138 "compiler/parser/whais.tab.c"
+    break;
+
+  case 78: /* list_of_paramaters_decl: IDENTIFIER type_spec  */
+#line 342 "compiler/parser/whais.y"
+                           {
+                                yyval =  add_proc_param_decl(NULL, yyvsp[-1], yyvsp[0]);
+                                CHK_SEM_ERROR;
+                           }
+#line 2147 "compiler/parser/whais.tab.c"
+    break;
+
+  case 79: /* list_of_paramaters_decl: IDENTIFIER type_spec ',' list_of_paramaters_decl  */
+#line 347 "compiler/parser/whais.y"
+                           {
+                                yyval = add_proc_param_decl(yyvsp[0], yyvsp[-3], yyvsp[-2]);
+                                CHK_SEM_ERROR;
+                           }
+#line 2156 "compiler/parser/whais.tab.c"
+    break;
+
+  case 80: /* exp_stmt: exp ';'  */
+#line 354 "compiler/parser/whais.y"
+        {
+           check_for_dead_statement (state);
+           yyval = translate_exp(state, yyvsp[-1], TRUE, FALSE); 
+           CHK_SEM_ERROR;
+        }
+#line 2166 "compiler/parser/whais.tab.c"
+    break;
+
+  case 81: /* exp: const_exp  */
+#line 362 "compiler/parser/whais.y"
+        {
+            yyval = yyvsp[0];
+        }
+#line 2174 "compiler/parser/whais.tab.c"
+    break;
+
+  case 82: /* exp: IDENTIFIER  */
+#line 366 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+            CHK_SEM_ERROR;
+        }
+#line 2183 "compiler/parser/whais.tab.c"
+    break;
+
+  case 83: /* exp: '@' exp  */
+#line 371 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_OFFSET);
+            CHK_SEM_ERROR;
+        }
+#line 2192 "compiler/parser/whais.tab.c"
+    break;
+
+  case 84: /* exp: '!' exp  */
+#line 376 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NOT);
+            CHK_SEM_ERROR;
+        }
+#line 2201 "compiler/parser/whais.tab.c"
+    break;
+
+  case 85: /* exp: NOT exp  */
+#line 381 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NOT);
+            CHK_SEM_ERROR;
+        }
+#line 2210 "compiler/parser/whais.tab.c"
+    break;
+
+  case 86: /* exp: '~' exp  */
+#line 386 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NOT);
+            CHK_SEM_ERROR;
+        }
+#line 2219 "compiler/parser/whais.tab.c"
+    break;
+
+  case 87: /* exp: '-' exp  */
+#line 391 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NEGATIVE);
+            CHK_SEM_ERROR;
+        }
+#line 2228 "compiler/parser/whais.tab.c"
+    break;
+
+  case 88: /* exp: exp '+' exp  */
+#line 396 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_ADD);
+            CHK_SEM_ERROR;
+        }
+#line 2237 "compiler/parser/whais.tab.c"
+    break;
+
+  case 89: /* exp: exp '-' exp  */
+#line 401 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SUB);
+            CHK_SEM_ERROR;
+        }
+#line 2246 "compiler/parser/whais.tab.c"
+    break;
+
+  case 90: /* exp: exp '*' exp  */
+#line 406 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_MUL);
+            CHK_SEM_ERROR;
+        }
+#line 2255 "compiler/parser/whais.tab.c"
+    break;
+
+  case 91: /* exp: exp '/' exp  */
+#line 411 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_DIV);
+            CHK_SEM_ERROR;
+        }
+#line 2264 "compiler/parser/whais.tab.c"
+    break;
+
+  case 92: /* exp: exp '%' exp  */
+#line 416 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_MOD);
+            CHK_SEM_ERROR;
+        }
+#line 2273 "compiler/parser/whais.tab.c"
+    break;
+
+  case 93: /* exp: exp '<' exp  */
+#line 421 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_LT);
+            CHK_SEM_ERROR;
+        }
+#line 2282 "compiler/parser/whais.tab.c"
+    break;
+
+  case 94: /* exp: exp LE exp  */
+#line 426 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_LE);
+            CHK_SEM_ERROR;
+        }
+#line 2291 "compiler/parser/whais.tab.c"
+    break;
+
+  case 95: /* exp: exp '>' exp  */
+#line 431 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_GT);
+            CHK_SEM_ERROR;
+        }
+#line 2300 "compiler/parser/whais.tab.c"
+    break;
+
+  case 96: /* exp: exp GE exp  */
+#line 436 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_GE);
+            CHK_SEM_ERROR;
+        }
+#line 2309 "compiler/parser/whais.tab.c"
+    break;
+
+  case 97: /* exp: exp EQ exp  */
+#line 441 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_EQ);
+            CHK_SEM_ERROR;
+        }
+#line 2318 "compiler/parser/whais.tab.c"
+    break;
+
+  case 98: /* exp: exp NE exp  */
+#line 446 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_NE);
+            CHK_SEM_ERROR;
+        }
+#line 2327 "compiler/parser/whais.tab.c"
+    break;
+
+  case 99: /* exp: exp AND exp  */
+#line 451 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_AND);
+            CHK_SEM_ERROR;
+        }
+#line 2336 "compiler/parser/whais.tab.c"
+    break;
+
+  case 100: /* exp: exp '&' exp  */
+#line 456 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_AND);
+            CHK_SEM_ERROR;
+        }
+#line 2345 "compiler/parser/whais.tab.c"
+    break;
+
+  case 101: /* exp: exp OR exp  */
+#line 461 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_OR);
+            CHK_SEM_ERROR;
+        }
+#line 2354 "compiler/parser/whais.tab.c"
+    break;
+
+  case 102: /* exp: exp '|' exp  */
+#line 466 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_OR);
+            CHK_SEM_ERROR;
+        }
+#line 2363 "compiler/parser/whais.tab.c"
+    break;
+
+  case 103: /* exp: exp XOR exp  */
+#line 471 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_XOR);
+            CHK_SEM_ERROR;
+        }
+#line 2372 "compiler/parser/whais.tab.c"
+    break;
+
+  case 104: /* exp: exp '^' exp  */
+#line 476 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_XOR);
+            CHK_SEM_ERROR;
+        }
+#line 2381 "compiler/parser/whais.tab.c"
+    break;
+
+  case 105: /* exp: '(' exp ')'  */
+#line 481 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-1], NULL, NULL, OP_GROUP);
+            CHK_SEM_ERROR;
+        }
+#line 2390 "compiler/parser/whais.tab.c"
+    break;
+
+  case 106: /* exp: exp '[' exp ']'  */
+#line 486 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-3], yyvsp[-1], NULL, OP_INDEX);
+            CHK_SEM_ERROR;
+        }
+#line 2399 "compiler/parser/whais.tab.c"
+    break;
+
+  case 107: /* exp: exp '.' IDENTIFIER  */
+#line 491 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_FIELD);
+            CHK_SEM_ERROR;
+        }
+#line 2408 "compiler/parser/whais.tab.c"
+    break;
+
+  case 108: /* exp: exp '.' IDENTIFIER '[' exp ']'  */
+#line 496 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-5], yyvsp[-1], yyvsp[-3], OP_TABVAL); 
+            CHK_SEM_ERROR;
+        }
+#line 2417 "compiler/parser/whais.tab.c"
+    break;
+
+  case 109: /* exp: exp '=' exp  */
+#line 501 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_ATTR);
+            CHK_SEM_ERROR;
+        }
+#line 2426 "compiler/parser/whais.tab.c"
+    break;
+
+  case 110: /* exp: exp SADD exp  */
+#line 506 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SADD);
+            CHK_SEM_ERROR;
+        }
+#line 2435 "compiler/parser/whais.tab.c"
+    break;
+
+  case 111: /* exp: exp SSUB exp  */
+#line 511 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SSUB);
+            CHK_SEM_ERROR;
+        }
+#line 2444 "compiler/parser/whais.tab.c"
+    break;
+
+  case 112: /* exp: exp SMUL exp  */
+#line 516 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SMUL);
+            CHK_SEM_ERROR;
+        }
+#line 2453 "compiler/parser/whais.tab.c"
+    break;
+
+  case 113: /* exp: exp SDIV exp  */
+#line 521 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SDIV);
+            CHK_SEM_ERROR;
+        }
+#line 2462 "compiler/parser/whais.tab.c"
+    break;
+
+  case 114: /* exp: exp SMOD exp  */
+#line 526 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SMOD);
+            CHK_SEM_ERROR;
+        }
+#line 2471 "compiler/parser/whais.tab.c"
+    break;
+
+  case 115: /* exp: exp SAND exp  */
+#line 531 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SAND);
+            CHK_SEM_ERROR;
+        }
+#line 2480 "compiler/parser/whais.tab.c"
+    break;
+
+  case 116: /* exp: exp SXOR exp  */
+#line 536 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SXOR);
+            CHK_SEM_ERROR;
+        }
+#line 2489 "compiler/parser/whais.tab.c"
+    break;
+
+  case 117: /* exp: exp SOR exp  */
+#line 541 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_SOR);
+            CHK_SEM_ERROR;
+        }
+#line 2498 "compiler/parser/whais.tab.c"
+    break;
+
+  case 118: /* exp: exp '?' exp ':' exp  */
+#line 546 "compiler/parser/whais.y"
+       {
+            yyval = create_exp_link(state, yyvsp[-4], yyvsp[-2], yyvsp[0], OP_EXP_SEL);
+            CHK_SEM_ERROR;
+       }
+#line 2507 "compiler/parser/whais.tab.c"
+    break;
+
+  case 119: /* exp: IDENTIFIER '(' parameters_list ')'  */
+#line 551 "compiler/parser/whais.y"
+        {
+            /* procedure call */
+            yyval = create_exp_link(state, yyvsp[-3], yyvsp[-1], NULL, OP_CALL);
+            CHK_SEM_ERROR;
+        }
+#line 2517 "compiler/parser/whais.tab.c"
+    break;
+
+  case 120: /* exp: '{' not_empty_parameters_list '}' array_construction_type_spec  */
+#line 557 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_CREATE_ARRAY);
+            CHK_SEM_ERROR;
+        }
+#line 2526 "compiler/parser/whais.tab.c"
+    break;
+
+  case 121: /* exp: '(' type_spec ')' exp  */
+#line 562 "compiler/parser/whais.y"
+        {
+            yyval = create_exp_link(state, yyvsp[-2], yyvsp[0], NULL, OP_EXP_CAST);
+            CHK_SEM_ERROR;
+        }
+#line 2535 "compiler/parser/whais.tab.c"
+    break;
+
+  case 122: /* array_construction_type_spec: %empty  */
+#line 569 "compiler/parser/whais.y"
+                               {
+                                    yyval = NULL;
+                                }
+#line 2543 "compiler/parser/whais.tab.c"
+    break;
+
+  case 123: /* array_construction_type_spec: basic_type_spec  */
+#line 573 "compiler/parser/whais.y"
+                                {
+                                    yyval = yyvsp[0];
+                                }
+#line 2551 "compiler/parser/whais.tab.c"
+    break;
+
+  case 124: /* const_exp: WHAIS_INTEGER  */
+#line 579 "compiler/parser/whais.y"
+            {
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR;
+            }
+#line 2560 "compiler/parser/whais.tab.c"
+    break;
+
+  case 125: /* const_exp: WHAIS_REAL  */
+#line 584 "compiler/parser/whais.y"
+            {
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR;
+            }
+#line 2569 "compiler/parser/whais.tab.c"
+    break;
+
+  case 126: /* const_exp: WHAIS_TEXT  */
+#line 589 "compiler/parser/whais.y"
+            {
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR;
+            }
+#line 2578 "compiler/parser/whais.tab.c"
+    break;
+
+  case 127: /* const_exp: WHAIS_CHAR  */
+#line 594 "compiler/parser/whais.y"
+            {
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR;
+            }
+#line 2587 "compiler/parser/whais.tab.c"
+    break;
+
+  case 128: /* const_exp: WHAIS_TIME  */
+#line 599 "compiler/parser/whais.y"
+            {
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR;
+            }
+#line 2596 "compiler/parser/whais.tab.c"
+    break;
+
+  case 129: /* const_exp: WHAIS_NULL  */
+#line 604 "compiler/parser/whais.y"
+            {
+                /* null operation and NULL operands means
+                   the NULL value */
+                yyval = create_exp_link(state, NULL, NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR;
+            }
+#line 2607 "compiler/parser/whais.tab.c"
+    break;
+
+  case 130: /* const_exp: W_TRUE  */
+#line 611 "compiler/parser/whais.y"
+            {
+                yyvsp[0] = alloc_bool_sem_value(state, TRUE);
+                CHK_SEM_ERROR;
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR; 
+            }
+#line 2618 "compiler/parser/whais.tab.c"
+    break;
+
+  case 131: /* const_exp: W_FALSE  */
+#line 618 "compiler/parser/whais.y"
+            {
+                yyvsp[0] = alloc_bool_sem_value(state, FALSE);
+                CHK_SEM_ERROR;
+                yyval = create_exp_link(state, yyvsp[0], NULL, NULL, OP_NULL);
+                CHK_SEM_ERROR; 
+            }
+#line 2629 "compiler/parser/whais.tab.c"
+    break;
+
+  case 132: /* parameters_list: %empty  */
+#line 627 "compiler/parser/whais.y"
+                    {
+                        yyval = NULL;
+                    }
+#line 2637 "compiler/parser/whais.tab.c"
+    break;
+
+  case 133: /* parameters_list: not_empty_parameters_list  */
+#line 631 "compiler/parser/whais.y"
+                    {
+                        yyval = yyvsp[0];
+                    }
+#line 2645 "compiler/parser/whais.tab.c"
+    break;
+
+  case 134: /* not_empty_parameters_list: exp  */
+#line 637 "compiler/parser/whais.y"
+                            {
+                                yyval = create_arg_link(state, yyvsp[0], NULL);
+                                CHK_SEM_ERROR;
+                            }
+#line 2654 "compiler/parser/whais.tab.c"
+    break;
+
+  case 135: /* not_empty_parameters_list: exp ',' not_empty_parameters_list  */
+#line 642 "compiler/parser/whais.y"
+                            {
+                                yyval = create_arg_link(state, yyvsp[-2], yyvsp[0]);
+                                CHK_SEM_ERROR;
+                            }
+#line 2663 "compiler/parser/whais.tab.c"
+    break;
+
+  case 136: /* $@6: %empty  */
+#line 649 "compiler/parser/whais.y"
+              {
+                check_for_dead_statement (state);
+                begin_if_stmt(state, yyvsp[-2], BT_IF);
+                CHK_SEM_ERROR;
+              }
+#line 2673 "compiler/parser/whais.tab.c"
+    break;
+
+  case 138: /* $@7: %empty  */
+#line 657 "compiler/parser/whais.y"
+              {
+                check_for_dead_statement (state);
+                begin_if_stmt(state, yyvsp[-1], BT_IF);
+                CHK_SEM_ERROR;
+              }
+#line 2683 "compiler/parser/whais.tab.c"
+    break;
+
+  case 140: /* possible_no_else_if_clause: %empty  */
+#line 666 "compiler/parser/whais.y"
+                               {
+                                   finalize_if_stmt(state);
+                                   CHK_SEM_ERROR;
+                               }
+#line 2692 "compiler/parser/whais.tab.c"
+    break;
+
+  case 142: /* end_of_if_statement: END  */
+#line 674 "compiler/parser/whais.y"
+                      {
+                           finalize_if_stmt (state);
+                           CHK_SEM_ERROR;
+                      }
+#line 2701 "compiler/parser/whais.tab.c"
+    break;
+
+  case 144: /* $@8: %empty  */
+#line 682 "compiler/parser/whais.y"
+                  {
+                        begin_else_stmt(state);
+                        CHK_SEM_ERROR;
+                  }
+#line 2710 "compiler/parser/whais.tab.c"
+    break;
+
+  case 145: /* else_if_clause: ELSE $@8 DO local_block_statement END  */
+#line 687 "compiler/parser/whais.y"
+                  {
+                       finalize_if_stmt(state);
+                       CHK_SEM_ERROR;
+                  }
+#line 2719 "compiler/parser/whais.tab.c"
+    break;
+
+  case 146: /* $@9: %empty  */
+#line 692 "compiler/parser/whais.y"
+                  {
+                        begin_else_stmt(state);
+                        CHK_SEM_ERROR;
+                  }
+#line 2728 "compiler/parser/whais.tab.c"
+    break;
+
+  case 147: /* else_if_clause: ELSE $@9 one_statement  */
+#line 697 "compiler/parser/whais.y"
+                  {
+                       finalize_if_stmt(state);
+                       CHK_SEM_ERROR;
+                  }
+#line 2737 "compiler/parser/whais.tab.c"
+    break;
+
+  case 148: /* $@10: %empty  */
+#line 704 "compiler/parser/whais.y"
+               {
+                    check_for_dead_statement (state);
+                    begin_while_stmt(state, yyvsp[-1]);
+                    CHK_SEM_ERROR;
+               }
+#line 2747 "compiler/parser/whais.tab.c"
+    break;
+
+  case 149: /* while_stmt: WHILE '(' exp ')' $@10 DO local_block_statement END  */
+#line 710 "compiler/parser/whais.y"
+               {
+                    finalize_while_stmt(state);
+                    CHK_SEM_ERROR;
+               }
+#line 2756 "compiler/parser/whais.tab.c"
+    break;
+
+  case 150: /* $@11: %empty  */
+#line 715 "compiler/parser/whais.y"
+               {
+                    check_for_dead_statement (state);
+                    begin_while_stmt(state, yyvsp[-1]);
+                    CHK_SEM_ERROR;
+               }
+#line 2766 "compiler/parser/whais.tab.c"
+    break;
+
+  case 151: /* while_stmt: WHILE '(' exp ')' $@11 one_statement  */
+#line 721 "compiler/parser/whais.y"
+               {
+                    finalize_while_stmt(state);
+                    CHK_SEM_ERROR;
+               }
+#line 2775 "compiler/parser/whais.tab.c"
+    break;
+
+  case 152: /* $@12: %empty  */
+#line 728 "compiler/parser/whais.y"
+              {
+                    check_for_dead_statement (state);
+                    begin_until_stmt(state);
+                    CHK_SEM_ERROR;
+              }
+#line 2785 "compiler/parser/whais.tab.c"
+    break;
+
+  case 153: /* until_stmt: DO $@12 local_block_statement UNTIL exp ';'  */
+#line 734 "compiler/parser/whais.y"
+              {
+                    finalize_until_stmt(state, yyvsp[-1]);
+                    CHK_SEM_ERROR;
+              }
+#line 2794 "compiler/parser/whais.tab.c"
+    break;
+
+  case 154: /* $@13: %empty  */
+#line 741 "compiler/parser/whais.y"
+           {
+             begin_foreach_stmt (state, yyvsp[-3], yyvsp[-1], FALSE);
+           }
+#line 2802 "compiler/parser/whais.tab.c"
+    break;
+
+  case 155: /* for_stmt: FOR '(' IDENTIFIER ':' exp ')' $@13 one_statement  */
+#line 745 "compiler/parser/whais.y"
+           {
+             finalize_for_stmt (state);
+             CHK_SEM_ERROR;
+           }
+#line 2811 "compiler/parser/whais.tab.c"
+    break;
+
+  case 156: /* $@14: %empty  */
+#line 750 "compiler/parser/whais.y"
+           {
+             begin_foreach_stmt (state, yyvsp[-3], yyvsp[-1], FALSE);
+           }
+#line 2819 "compiler/parser/whais.tab.c"
+    break;
+
+  case 157: /* for_stmt: FOR '(' IDENTIFIER ':' exp ')' $@14 DO local_block_statement END  */
+#line 754 "compiler/parser/whais.y"
+           {
+             finalize_for_stmt(state);
+             CHK_SEM_ERROR;
+           }
+#line 2828 "compiler/parser/whais.tab.c"
+    break;
+
+  case 158: /* $@15: %empty  */
+#line 759 "compiler/parser/whais.y"
+           {
+             begin_foreach_stmt (state, yyvsp[-3], yyvsp[-1], TRUE);
+           }
+#line 2836 "compiler/parser/whais.tab.c"
+    break;
+
+  case 159: /* for_stmt: FOR '(' '!' IDENTIFIER ':' exp ')' $@15 one_statement  */
+#line 763 "compiler/parser/whais.y"
+           {
+             finalize_for_stmt (state);
+             CHK_SEM_ERROR;
+           }
+#line 2845 "compiler/parser/whais.tab.c"
+    break;
+
+  case 160: /* $@16: %empty  */
+#line 768 "compiler/parser/whais.y"
+           {
+             begin_foreach_stmt (state, yyvsp[-3], yyvsp[-1], TRUE);
+           }
+#line 2853 "compiler/parser/whais.tab.c"
+    break;
+
+  case 161: /* for_stmt: FOR '(' '!' IDENTIFIER ':' exp ')' $@16 DO local_block_statement END  */
+#line 772 "compiler/parser/whais.y"
+           {
+             finalize_for_stmt(state);
+             CHK_SEM_ERROR;
+           }
+#line 2862 "compiler/parser/whais.tab.c"
+    break;
+
+  case 162: /* $@17: %empty  */
+#line 777 "compiler/parser/whais.y"
+          {
+            check_for_dead_statement (state);
+            begin_for_stmt (state, yyvsp[-5], yyvsp[-3], yyvsp[-1]);
+            CHK_SEM_ERROR;
+          }
+#line 2872 "compiler/parser/whais.tab.c"
+    break;
+
+  case 163: /* for_stmt: FOR '(' exp ';' exp ';' exp ')' $@17 one_statement  */
+#line 783 "compiler/parser/whais.y"
+          {
+            finalize_for_stmt (state);
+            CHK_SEM_ERROR;
+          }
+#line 2881 "compiler/parser/whais.tab.c"
+    break;
+
+  case 164: /* $@18: %empty  */
+#line 788 "compiler/parser/whais.y"
+          {
+            check_for_dead_statement (state);
+            begin_for_stmt (state, yyvsp[-5], yyvsp[-3], yyvsp[-1]);
+            CHK_SEM_ERROR;
+          }
+#line 2891 "compiler/parser/whais.tab.c"
+    break;
+
+  case 165: /* for_stmt: FOR '(' exp ';' exp ';' exp ')' $@18 DO local_block_statement END  */
+#line 794 "compiler/parser/whais.y"
+          {
+            finalize_for_stmt(state);
+            CHK_SEM_ERROR;
+          }
+#line 2900 "compiler/parser/whais.tab.c"
+    break;
+
+  case 166: /* break_stmt: BREAK ';'  */
+#line 801 "compiler/parser/whais.y"
+              {
+                    handle_break_stmt(state);
+                    CHK_SEM_ERROR;
+              }
+#line 2909 "compiler/parser/whais.tab.c"
+    break;
+
+  case 167: /* continue_stmt: CONTINUE ';'  */
+#line 808 "compiler/parser/whais.y"
+                 {
+                        handle_continue_stmt(state);
+                        CHK_SEM_ERROR;
+                 }
+#line 2918 "compiler/parser/whais.tab.c"
+    break;
+
+  case 168: /* $@19: %empty  */
+#line 815 "compiler/parser/whais.y"
+                   {
+                       begin_sync_stmt(state);
+                       CHK_SEM_ERROR;
+                   }
+#line 2927 "compiler/parser/whais.tab.c"
+    break;
+
+  case 169: /* syncronize_stmt: SYNC $@19 local_block_statement ENDSYNC  */
+#line 820 "compiler/parser/whais.y"
+                   {
+                       finalize_sync_stmt(state);
+                       CHK_SEM_ERROR;
+                   }
+#line 2936 "compiler/parser/whais.tab.c"
+    break;
+
+
+#line 2940 "compiler/parser/whais.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (state, YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, state);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, state);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (state, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, state);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, state);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
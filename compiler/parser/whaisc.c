@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "parser.h"
 #include "../semantics/statement.h"
 #include "../semantics/vardecl.h"
+#include "../semantics/procdecl.h"
 
 extern int yyparse(struct ParserState*);
 
@@ -39,6 +40,16 @@ wh_compiler_load(const char* const   program,
                  const uint_t        length,
                  WH_MESSENGER        messenger,
                  WH_MESSENGER_CTXT   messengerContext)
+{
+  return wh_compiler_load_options(program, length, messenger, messengerContext, 0);
+}
+
+WH_COMPILED_UNIT
+wh_compiler_load_options(const char* const   program,
+                         const uint_t        length,
+                         WH_MESSENGER        messenger,
+                         WH_MESSENGER_CTXT   messengerContext,
+                         const uint_t        options)
 {
   struct ParserState* state = mem_alloc(sizeof( *state));
 
@@ -51,6 +62,12 @@ wh_compiler_load(const char* const   program,
     state->messengerCtxt = messengerContext;
     state->abortError    = FALSE;
     state->externDecl    = FALSE;
+    state->optimize      = (options & WHC_OPTIMIZE_CODE) != 0;
+    state->inlinePragma  = INLINE_DEFAULT;
+    state->procPos       = 0;
+    state->endProcPos    = 0;
+    state->specialized   = NULL;
+    state->generic       = NULL;
     state->strings       = create_string_store();
 
     wh_array_init(&(state->values), sizeof(struct SemValue));
@@ -58,7 +75,8 @@ wh_compiler_load(const char* const   program,
     state->pCurrentStmt = &state->globalStmt;
 
     /* begin the compilation of the buffer */
-    if (yyparse( state) != 0)
+    if ((yyparse( state) != 0)
+        || (state->optimize && ! compile_specialized_procs(state)))
     {
       wh_compiler_discard((WH_COMPILED_UNIT) state);
       state = NULL;
@@ -158,7 +176,7 @@ wh_unit_procedure(const WH_COMPILED_UNIT        hnd,
   outDescription->nameLength  = stmt->spec.proc.nameLength;
   outDescription->paramsCount = wh_array_count(&(stmt->spec.proc.paramsList)) - 1;
   outDescription->localsCount = stmt->localsUsed;
-  outDescription->syncsCount  = stmt->spec.proc.syncTracker;
+  outDescription->syncsCount  = stmt->spec.proc.syncTracker / 2;
   outDescription->codeSize    = wh_ostream_size(&(stmt->spec.proc.code));
   outDescription->code        = wh_ostream_data(&(stmt->spec.proc.code));
 
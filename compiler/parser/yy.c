@@ -161,6 +161,44 @@ is_eol(const char c)
   return(c == 0x0A || c == 0x0D);
 }
 
+/* Check the commentaries skipped before a procedure's declaration for the
+ * pragmas regarding the inlining of its calls. The last one found wins. */
+static enum INLINE_PRAGMA
+inline_pragma(const char* buffer, const char* const end)
+{
+  static const char inlineTag[]   = "#@inline";
+  static const char noinlineTag[] = "#@noinline";
+
+  enum INLINE_PRAGMA result = INLINE_DEFAULT;
+
+  while (buffer < end)
+  {
+    if (*buffer != '#')
+    {
+      ++buffer;
+      continue;
+    }
+
+    if ((end - buffer >= (int)sizeof inlineTag - 1)
+        && strncmp(buffer, inlineTag, sizeof inlineTag - 1) == 0
+        && ! is_idlegal(buffer[sizeof inlineTag - 1]))
+    {
+      result = INLINE_ALWAYS;
+    }
+    else if ((end - buffer >= (int)sizeof noinlineTag - 1)
+             && strncmp(buffer, noinlineTag, sizeof noinlineTag - 1) == 0
+             && ! is_idlegal(buffer[sizeof noinlineTag - 1]))
+    {
+      result = INLINE_NEVER;
+    }
+
+    while ((buffer < end) && ! is_eol(*buffer))
+      ++buffer;
+  }
+
+  return result;
+}
+
 /* Read the next token from buffer (ignores any white spaces). */
 static TOKEN_TYPE
 next_token(const char     *buffer,
@@ -820,8 +858,12 @@ yylex(YYSTYPE * lvalp, struct ParserState* parser)
   TOKEN_TYPE   tokenType = TK_ERROR;
   uint_t       bufferOff = parser->bufferPos;
 
-  if (parser->bufferPos > parser->bufferSize)
+  if (parser->bufferPos >= parser->bufferSize)
+  {
+    /* Step over the end as the terminating character would be. */
+    parser->bufferPos = parser->bufferSize + 1;
     return 0;
+  }
 
   /* Recall where to start from */
   buffer    += bufferOff;
@@ -848,6 +890,14 @@ yylex(YYSTYPE * lvalp, struct ParserState* parser)
   {
     /* after we parsed the token we found is a keyword */
     tokenType = TK_KEYWORD;
+    if (result == PROCEDURE)
+    {
+      parser->inlinePragma = inline_pragma(buffer, pToken);
+      parser->procPos      = pToken - parser->buffer;
+    }
+    else if (result == ENDPROC)
+      parser->endProcPos = parser->bufferPos;
+
     return result;
   }
   else if (tokenLen == 1)
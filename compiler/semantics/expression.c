@@ -515,6 +515,23 @@ free_type_description(char* description)
 }
 
 
+/* Encode the opcode of a binary operator. When optimizing, the integer
+ * operators with both operands of the same type get their typed forms, so
+ * the interpreter does not have to find the operands' types at runtime. */
+static struct WOutputStream*
+encode_operator(struct ParserState* const     parser,
+                struct WOutputStream* const   instrs,
+                const enum W_OPCODE           opcode,
+                const uint_t                  ftype,
+                const uint_t                  stype)
+{
+  if (parser->optimize && (ftype == stype))
+    return encode_opcode(instrs, wh_compiler_typed_op(opcode, ftype));
+
+  return encode_opcode(instrs, opcode);
+}
+
+
 static struct ExpResultType
 translate_not_exp(struct ParserState* const           parser,
                   const struct ExpResultType* const   opType)
@@ -627,7 +644,7 @@ translate_add_exp(struct ParserState* const           parser,
       return sgResultUnk;
     }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -719,7 +736,7 @@ translate_sub_exp(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -780,7 +797,7 @@ translate_mul_exp(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -965,7 +982,7 @@ translate_less_exp(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -1024,7 +1041,7 @@ translate_exp_less_equal(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -1083,7 +1100,7 @@ translate_greater_exp(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -1142,7 +1159,7 @@ translate_exp_greater_equal(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -1201,7 +1218,7 @@ translate_equals_exp(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -1247,7 +1264,7 @@ translate_exp_not_equals(struct ParserState* const           parser,
     return sgResultUnk;
   }
 
-  if (encode_opcode(instrs, opcode) == NULL)
+  if (encode_operator(parser, instrs, opcode, ftype, stype) == NULL)
   {
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
     return sgResultUnk;
@@ -2733,6 +2750,36 @@ translate_offset_exp(struct ParserState* const   parser,
   return sgResultUnk;
 }
 
+/* Storing into a generic parameter may change the type of its value, so a
+ * procedure doing it is not compiled for the types of its arguments. */
+static bool_t
+redefines_generic_param(const struct ParserState* const     parser,
+                        const struct SemExpression* const   exp)
+{
+  const struct Statement* const generic = parser->generic;
+  uint_t param;
+
+  if ((generic == NULL)
+      || ! is_leaf_exp(exp)
+      || (exp->firstTree->val_type != VAL_ID))
+  {
+    return FALSE;
+  }
+
+  for (param = 1; param <= stmt_get_param_count(generic); ++param)
+  {
+    const struct DeclaredVar* const var = stmt_get_param(generic, param);
+
+    if ((var->labelLength == exp->firstTree->val.u_id.length)
+        && (strncmp(var->label, exp->firstTree->val.u_id.name, var->labelLength) == 0))
+    {
+      return GET_BASE_TYPE(var->type) == T_UNDETERMINED;
+    }
+  }
+
+  return FALSE;
+}
+
 static struct ExpResultType
 translate_call_exp(struct ParserState* const   parser,
                    struct Statement* const     stmt,
@@ -2746,6 +2793,7 @@ translate_call_exp(struct ParserState* const   parser,
   uint_t           argCount = 0;
 
   struct ExpResultType result;
+  uint16_t             argsTypes[MAX_SPECIALIZED_PARAMS];
   char                 temp[128];
 
   assert(exp->firstTree->val_type == VAL_ID);
@@ -2822,6 +2870,9 @@ translate_call_exp(struct ParserState* const   parser,
     else
       free_sem_value(param);
 
+    if (argCount <= MAX_SPECIALIZED_PARAMS)
+      argsTypes[argCount - 1] = GET_TYPE(result.type);
+
     if (GET_TYPE( result.type) != T_UNDETERMINED)
     {
       if (IS_FIELD(result.type) || IS_FIELD(argType.type))
@@ -2966,6 +3017,13 @@ translate_call_exp(struct ParserState* const   parser,
   }
   free_sem_value(exp->firstTree);
 
+  if (parser->optimize)
+  {
+    proc = specialize_proc_call(parser, proc, argsTypes, argCount);
+    if (proc == NULL)
+      return sgResultUnk;
+  }
+
   if (encode_opcode(instrs, W_CALL) == NULL
       || wh_ostream_wint32(instrs, stmt_get_import_id(proc)) == NULL)
   {
@@ -3780,6 +3838,13 @@ translate_tree_exp(struct ParserState* const   parser,
 
   assert(tree->firstTree->val_type == VAL_EXP_LINK);
 
+  if ((tree->opcode == OP_ATTR)
+      && redefines_generic_param(parser, &tree->firstTree->val.u_exp))
+  {
+    parser->abortError = TRUE;
+    return sgResultUnk;
+  }
+
   opType1 = translate_tree_exp(parser, stmt, &(tree->firstTree->val.u_exp));
   if (opType1.type == T_UNKNOWN)
   {
@@ -376,3 +376,61 @@ opcode_bytes(const enum W_OPCODE opcode)
 {
   return 1;
 }
+
+uint_t
+opcode_args_bytes(const enum W_OPCODE opcode)
+{
+  switch (opcode)
+  {
+  case W_LDNULL:
+  case W_LDI8:
+  case W_LDLO8:
+  case W_LDGB8:
+  case W_CTS:
+  case W_BSYNC:
+  case W_ESYNC:
+  case W_AJOIN:
+  case W_AFOUT:
+  case W_AFIN:
+    return sizeof(uint8_t);
+
+  case W_LDI16:
+  case W_LDLO16:
+  case W_LDGB16:
+    return sizeof(uint16_t);
+
+  case W_LDC:
+  case W_LDI32:
+  case W_LDD:
+  case W_LDT:
+  case W_LDLO32:
+  case W_LDGB32:
+  case W_CALL:
+  case W_JF:
+  case W_JFC:
+  case W_JT:
+  case W_JTC:
+  case W_JMP:
+  case W_INDTA:
+  case W_SELF:
+    return sizeof(uint32_t);
+
+  case W_LDDT:
+    return 5 + sizeof(uint16_t);
+
+  case W_LDHT:
+    return sizeof(uint32_t) + 5 + sizeof(uint16_t);
+
+  case W_LDI64:
+    return sizeof(uint64_t);
+
+  case W_LDRR:
+    return sizeof(uint64_t) + sizeof(uint64_t);
+
+  case W_CARR:
+    return sizeof(uint8_t) + sizeof(uint16_t);
+
+  default:
+    return 0;
+  }
+}
@@ -60,4 +60,8 @@ decode_opcode(const uint8_t *instrs);
 uint_t
 opcode_bytes(const enum W_OPCODE);
 
+/* The size of the arguments following an opcode in the compiled code. */
+uint_t
+opcode_args_bytes(const enum W_OPCODE);
+
 #endif /* OPCODES_H_ */
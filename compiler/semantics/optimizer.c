@@ -0,0 +1,2873 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "optimizer.h"
+#include "opcodes.h"
+#include "vardecl.h"
+
+
+#define NO_TARGET           0xFFFFFFFF
+#define MAX_INSTR_SIZE      20
+#define MAX_JUMP_HOPS       16
+
+/* The budgets of the inlined calls: the code sizes of the procedures inlined
+ * by default and of the ones marked with the '#@inline' pragma, and the
+ * extra code a procedure may get from its inlined calls. */
+#define INLINE_MAX_SIZE         48
+#define INLINE_MAX_FORCED_SIZE  512
+#define INLINE_MAX_GROWTH       4096
+
+#define NO_DEPTH            -1
+
+/* The loops rewritten in a procedure, and the products of their induction
+ * variables kept into locals for each of them. */
+#define MAX_HOISTED_LOOPS   16
+#define MAX_INDUCTIONS      8
+
+/* Limits for the values of the folded integer operands. Keeping the values
+ * away from the sign bit makes the signed and unsigned opcodes agree, as the
+ * loaded integer constants are unsigned while some of the operators are
+ * signed. */
+#define MAX_FOLD_VALUE      ((uint64_t)1 << 62)
+#define MAX_FOLD_FACTOR     ((uint64_t)1 << 31)
+
+
+struct Instruction
+{
+  uint32_t   pos;        /* Position in the original code. */
+  uint32_t   size;
+  uint32_t   target;     /* Index of the jump's destination instruction. */
+  bool_t     removed;
+  bool_t     targeted;   /* Some jumps may land on this instruction. */
+  uint8_t    code[MAX_INSTR_SIZE];
+};
+
+struct Optimizer
+{
+  struct Instruction  *instrs;
+  uint32_t             count;
+  uint_t               paramsCount;
+};
+
+enum CONST_KIND
+{
+  CK_NONE,
+  CK_NULL,
+  CK_BOOL,
+  CK_INT
+};
+
+struct ConstValue
+{
+  enum CONST_KIND   kind;
+  uint64_t          value;
+};
+
+
+static bool_t
+is_jump(const enum W_OPCODE opcode)
+{
+  return (opcode == W_JF)
+         || (opcode == W_JFC)
+         || (opcode == W_JT)
+         || (opcode == W_JTC)
+         || (opcode == W_JMP);
+}
+
+/* The instructions that just push a value and cannot fail. */
+static bool_t
+is_pure_push(const enum W_OPCODE opcode)
+{
+  return ((W_LDNULL <= opcode) && (opcode <= W_LDLO32));
+}
+
+/* The instructions that store a simple value through a local's reference,
+ * for which the conversion of the stored value cannot fail. */
+static bool_t
+is_scalar_store(const enum W_OPCODE opcode)
+{
+  return (W_STB <= opcode) && (opcode <= W_STUI64) && (opcode != W_STT);
+}
+
+/* The operators that pop two values and push their result. */
+static bool_t
+is_binary_operator(const enum W_OPCODE opcode)
+{
+  return ((W_ADD <= opcode) && (opcode <= W_XORB))
+         || (wh_compiler_typed_op_type(opcode) != T_UNKNOWN);
+}
+
+static enum W_OPCODE
+instr_opcode(const struct Instruction* const instr)
+{
+  return decode_opcode(instr->code);
+}
+
+static const uint8_t*
+instr_args(const struct Instruction* const instr)
+{
+  return instr->code + opcode_bytes(instr_opcode(instr));
+}
+
+static uint32_t
+local_index(const struct Instruction* const instr)
+{
+  const uint8_t* const args = instr_args(instr);
+
+  switch (instr_opcode(instr))
+  {
+  case W_LDLO8:
+    return args[0];
+
+  case W_LDLO16:
+    return load_le_int16(args);
+
+  case W_LDLO32:
+    return load_le_int32(args);
+
+  default:
+    assert(FALSE);
+  }
+
+  return NO_TARGET;
+}
+
+static struct ConstValue
+instr_const(const struct Instruction* const instr)
+{
+  const uint8_t* const args = instr_args(instr);
+  struct ConstValue result = {CK_NONE, 0};
+
+  switch (instr_opcode(instr))
+  {
+  case W_LDNULL:
+    if (args[0] == 1)
+      result.kind = CK_NULL;
+    break;
+
+  case W_LDBT:
+  case W_LDBF:
+    result.kind  = CK_BOOL;
+    result.value = (instr_opcode(instr) == W_LDBT);
+    break;
+
+  case W_LDI8:
+    result.kind  = CK_INT;
+    result.value = args[0];
+    break;
+
+  case W_LDI16:
+    result.kind  = CK_INT;
+    result.value = load_le_int16(args);
+    break;
+
+  case W_LDI32:
+    result.kind  = CK_INT;
+    result.value = load_le_int32(args);
+    break;
+
+  case W_LDI64:
+    result.kind  = CK_INT;
+    result.value = load_le_int64(args);
+    break;
+
+  default:
+    break;
+  }
+
+  return result;
+}
+
+static void
+set_instr(struct Instruction* const   instr,
+          const enum W_OPCODE         opcode,
+          const uint32_t              argsSize)
+{
+  instr->size = opcode_bytes(opcode) + argsSize;
+  instr->target = NO_TARGET;
+
+  assert(instr->size <= MAX_INSTR_SIZE);
+
+  memset(instr->code, 0, sizeof instr->code);
+  *instr->code = opcode;
+}
+
+static void
+set_const(struct Instruction* const          instr,
+          const struct ConstValue* const     value)
+{
+  uint8_t* const args = instr->code + opcode_bytes(W_LDI8);
+
+  if (value->kind == CK_BOOL)
+    set_instr(instr, value->value ? W_LDBT : W_LDBF, 0);
+
+  else if (value->value <= 0xFF)
+  {
+    set_instr(instr, W_LDI8, 1);
+    args[0] = value->value;
+  }
+  else if (value->value <= 0xFFFF)
+  {
+    set_instr(instr, W_LDI16, 2);
+    store_le_int16(value->value, args);
+  }
+  else if (value->value <= 0xFFFFFFFF)
+  {
+    set_instr(instr, W_LDI32, 4);
+    store_le_int32(value->value, args);
+  }
+  else
+  {
+    set_instr(instr, W_LDI64, 8);
+    store_le_int64(value->value, args);
+  }
+}
+
+static void
+set_cts(struct Instruction* const instr, const uint_t count)
+{
+  assert((0 < count) && (count <= 0xFF));
+
+  set_instr(instr, W_CTS, 1);
+  instr->code[opcode_bytes(W_CTS)] = count;
+}
+
+static void
+set_jump(struct Instruction* const   instr,
+         const enum W_OPCODE         opcode,
+         const uint32_t              target)
+{
+  set_instr(instr, opcode, sizeof(uint32_t));
+  instr->target = target;
+}
+
+static uint32_t
+next_live(const struct Optimizer* const opt, uint32_t index)
+{
+  while ((index < opt->count) && opt->instrs[index].removed)
+    ++index;
+
+  return index;
+}
+
+static uint32_t
+prev_live(const struct Optimizer* const opt, uint32_t index)
+{
+  while (index-- > 0)
+  {
+    if ( ! opt->instrs[index].removed)
+      return index;
+  }
+
+  return NO_TARGET;
+}
+
+static uint32_t
+jump_target(const struct Optimizer* const opt, const struct Instruction* const instr)
+{
+  return next_live(opt, instr->target);
+}
+
+/* The jumps landing on a removed instruction continue with the next one. */
+static void
+remove_instr(struct Optimizer* const opt, const uint32_t index)
+{
+  struct Instruction* const instr = opt->instrs + index;
+  uint32_t next;
+
+  assert( ! instr->removed);
+
+  instr->removed = TRUE;
+
+  next = next_live(opt, index);
+  if (instr->targeted && (next < opt->count))
+    opt->instrs[next].targeted = TRUE;
+}
+
+static void
+mark_targets(struct Optimizer* const opt)
+{
+  uint32_t i;
+
+  for (i = 0; i < opt->count; ++i)
+    opt->instrs[i].targeted = FALSE;
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+
+    if ( ! instr->removed && is_jump(instr_opcode(instr)))
+    {
+      const uint32_t target = jump_target(opt, instr);
+
+      if (target < opt->count)
+        opt->instrs[target].targeted = TRUE;
+    }
+  }
+}
+
+/* Find the 'count' live instructions that precede the one at 'index', all
+ * reachable only by falling through, except the first one. */
+static bool_t
+preceding_operands(const struct Optimizer* const   opt,
+                   const uint32_t                  index,
+                   const uint_t                    count,
+                   uint32_t* const                 outOperands)
+{
+  uint32_t it = index;
+  uint_t   i;
+
+  if (opt->instrs[index].targeted)
+    return FALSE;
+
+  for (i = count; i-- > 0; )
+  {
+    it = prev_live(opt, it);
+    if (it == NO_TARGET)
+      return FALSE;
+
+    if ((i > 0) && opt->instrs[it].targeted)
+      return FALSE;
+
+    outOperands[i] = it;
+  }
+
+  return TRUE;
+}
+
+static bool_t
+fold_int_operation(const enum W_OPCODE    opcode,
+                   const uint64_t         first,
+                   const uint64_t         second,
+                   struct ConstValue*     outResult)
+{
+  outResult->kind = CK_INT;
+
+  if ((first >= MAX_FOLD_VALUE) || (second >= MAX_FOLD_VALUE))
+    return FALSE;
+
+  switch (opcode)
+  {
+  case W_ADD:
+    outResult->value = first + second;
+    break;
+
+  case W_SUB:
+    if (first < second)
+      return FALSE;
+
+    outResult->value = first - second;
+    break;
+
+  case W_MUL:
+  case W_MULU:
+    if ((first >= MAX_FOLD_FACTOR) || (second >= MAX_FOLD_FACTOR))
+      return FALSE;
+
+    outResult->value = first * second;
+    break;
+
+  case W_DIV:
+  case W_DIVU:
+    if (second == 0)
+      return FALSE;
+
+    outResult->value = first / second;
+    break;
+
+  case W_MOD:
+  case W_MODU:
+    if (second == 0)
+      return FALSE;
+
+    outResult->value = first % second;
+    break;
+
+  case W_AND:
+    outResult->value = first & second;
+    break;
+
+  case W_OR:
+    outResult->value = first | second;
+    break;
+
+  case W_XOR:
+    outResult->value = first ^ second;
+    break;
+
+  default:
+    outResult->kind = CK_BOOL;
+
+    switch (opcode)
+    {
+    case W_EQ:
+      outResult->value = (first == second);
+      break;
+
+    case W_NE:
+      outResult->value = (first != second);
+      break;
+
+    case W_LT:
+    case W_LTU:
+      outResult->value = (first < second);
+      break;
+
+    case W_LE:
+    case W_LEU:
+      outResult->value = (first <= second);
+      break;
+
+    case W_GT:
+    case W_GTU:
+      outResult->value = (first > second);
+      break;
+
+    case W_GE:
+    case W_GEU:
+      outResult->value = (first >= second);
+      break;
+
+    default:
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+static bool_t
+fold_bool_operation(const enum W_OPCODE    opcode,
+                    const uint64_t         first,
+                    const uint64_t         second,
+                    struct ConstValue*     outResult)
+{
+  outResult->kind = CK_BOOL;
+
+  switch (opcode)
+  {
+  case W_ANDB:
+    outResult->value = first && second;
+    break;
+
+  case W_ORB:
+    outResult->value = first || second;
+    break;
+
+  case W_XORB:
+  case W_NEB:
+    outResult->value = (first != second);
+    break;
+
+  case W_EQB:
+    outResult->value = (first == second);
+    break;
+
+  default:
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Only the operations with constant non null results are folded. A null
+ * result would need a typed null value, which cannot be loaded directly. */
+static bool_t
+fold_constants(struct Optimizer* const opt, const uint32_t index)
+{
+  struct Instruction* const instr = opt->instrs + index;
+  const enum W_OPCODE opcode = wh_compiler_untyped_op(instr_opcode(instr));
+  struct ConstValue result;
+  uint32_t operands[2];
+
+  if ((opcode == W_INULL) || (opcode == W_NNULL) || (opcode == W_NOTB))
+  {
+    struct ConstValue value;
+
+    if ( ! preceding_operands(opt, index, 1, operands))
+      return FALSE;
+
+    value = instr_const(opt->instrs + operands[0]);
+    if (value.kind == CK_NONE)
+      return FALSE;
+
+    result.kind = CK_BOOL;
+    if (opcode == W_NOTB)
+    {
+      if (value.kind != CK_BOOL)
+        return FALSE;
+
+      result.value = ! value.value;
+    }
+    else
+      result.value = ((value.kind == CK_NULL) == (opcode == W_INULL));
+
+    set_const(instr, &result);
+    remove_instr(opt, operands[0]);
+
+    return TRUE;
+  }
+  else
+  {
+    struct ConstValue first, second;
+    bool_t folded = FALSE;
+
+    if ( ! preceding_operands(opt, index, 2, operands))
+      return FALSE;
+
+    first  = instr_const(opt->instrs + operands[0]);
+    second = instr_const(opt->instrs + operands[1]);
+
+    if ((first.kind == CK_INT) && (second.kind == CK_INT))
+      folded = fold_int_operation(opcode, first.value, second.value, &result);
+
+    else if ((first.kind == CK_BOOL) && (second.kind == CK_BOOL))
+      folded = fold_bool_operation(opcode, first.value, second.value, &result);
+
+    else if (((first.kind == CK_NULL) || (second.kind == CK_NULL))
+             && (first.kind != CK_NONE)
+             && (second.kind != CK_NONE))
+    {
+      /* The equality operators are the only ones that do not return a
+       * null value when one of the operands is null. */
+      if ((opcode == W_EQ) || (opcode == W_EQB)
+          || (opcode == W_NE) || (opcode == W_NEB))
+      {
+        result.kind  = CK_BOOL;
+        result.value = (first.kind == second.kind);
+        if ((opcode == W_NE) || (opcode == W_NEB))
+          result.value = ! result.value;
+
+        folded = TRUE;
+      }
+    }
+
+    if ( ! folded)
+      return FALSE;
+
+    set_const(instr, &result);
+    remove_instr(opt, operands[0]);
+    remove_instr(opt, operands[1]);
+
+    return TRUE;
+  }
+}
+
+/* The conditional jumps do not jump on null values, so a condition may not
+ * be simply negated by swapping the jumps' kind. */
+static bool_t
+fold_conditional_jump(struct Optimizer* const opt, const uint32_t index)
+{
+  struct Instruction* const instr = opt->instrs + index;
+  const enum W_OPCODE opcode = instr_opcode(instr);
+  struct Instruction* cond;
+  struct ConstValue value;
+  uint32_t operand;
+  bool_t jumps;
+
+  if ((opcode != W_JF) && (opcode != W_JFC) && (opcode != W_JT) && (opcode != W_JTC))
+    return FALSE;
+
+  if ( ! preceding_operands(opt, index, 1, &operand))
+    return FALSE;
+
+  cond = opt->instrs + operand;
+  if ((instr_opcode(cond) == W_NOTB) && ((opcode == W_JFC) || (opcode == W_JTC)))
+  {
+    set_jump(instr, (opcode == W_JFC) ? W_JTC : W_JFC, instr->target);
+    remove_instr(opt, operand);
+    return TRUE;
+  }
+
+  value = instr_const(cond);
+  if ((value.kind != CK_NULL) && (value.kind != CK_BOOL))
+    return FALSE;
+
+  jumps = (value.kind == CK_BOOL)
+          && (((opcode == W_JF) || (opcode == W_JFC)) ? ! value.value : value.value);
+
+  if ((opcode == W_JFC) || (opcode == W_JTC))
+  {
+    remove_instr(opt, operand);
+    if (jumps)
+      set_jump(instr, W_JMP, instr->target);
+
+    else
+      remove_instr(opt, index);
+  }
+  else
+  {
+    if (jumps)
+      set_jump(instr, W_JMP, instr->target);
+
+    else
+      remove_instr(opt, index);
+  }
+
+  return TRUE;
+}
+
+static bool_t
+thread_jump(struct Optimizer* const opt, const uint32_t index)
+{
+  struct Instruction* const instr = opt->instrs + index;
+  const enum W_OPCODE opcode = instr_opcode(instr);
+  const uint32_t next = next_live(opt, index + 1);
+  uint32_t target, hops;
+
+  if ( ! is_jump(opcode))
+    return FALSE;
+
+  target = jump_target(opt, instr);
+  if (target == next)
+  {
+    /* Jumping to the next instruction does nothing besides the cleaning. */
+    if ((opcode == W_JFC) || (opcode == W_JTC))
+      set_cts(instr, 1);
+
+    else
+      remove_instr(opt, index);
+
+    return TRUE;
+  }
+
+  for (hops = 0;
+       (hops < MAX_JUMP_HOPS)
+         && (target < opt->count)
+         && (instr_opcode(opt->instrs + target) == W_JMP);
+       ++hops)
+  {
+    const uint32_t nextTarget = jump_target(opt, opt->instrs + target);
+
+    if (nextTarget == target)
+      break;
+
+    target = nextTarget;
+  }
+
+  if ((opcode == W_JMP)
+      && (target < opt->count)
+      && (instr_opcode(opt->instrs + target) == W_RET))
+  {
+    set_instr(instr, W_RET, 0);
+    return TRUE;
+  }
+
+  if (target != jump_target(opt, instr))
+  {
+    instr->target = target;
+    if (target < opt->count)
+      opt->instrs[target].targeted = TRUE;
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+static bool_t
+clean_stack(struct Optimizer* const opt, const uint32_t index)
+{
+  struct Instruction* const instr = opt->instrs + index;
+  uint_t count = instr->code[opcode_bytes(W_CTS)];
+  struct Instruction* prev;
+  uint32_t operand;
+
+  if ((instr_opcode(instr) != W_CTS)
+      || ! preceding_operands(opt, index, 1, &operand))
+  {
+    return FALSE;
+  }
+
+  prev = opt->instrs + operand;
+  if (instr_opcode(prev) == W_CTS)
+  {
+    const uint_t total = count + prev->code[opcode_bytes(W_CTS)];
+
+    if (total > 0xFF)
+      return FALSE;
+
+    set_cts(instr, total);
+    remove_instr(opt, operand);
+
+    return TRUE;
+  }
+  else if ( ! is_pure_push(instr_opcode(prev)))
+    return FALSE;
+
+  if (instr_opcode(prev) == W_LDNULL)
+  {
+    uint8_t* const nullsCount = prev->code + opcode_bytes(W_LDNULL);
+
+    if (*nullsCount > count)
+    {
+      *nullsCount -= count;
+      remove_instr(opt, index);
+
+      return TRUE;
+    }
+
+    count -= *nullsCount;
+  }
+  else
+    --count;
+
+  remove_instr(opt, operand);
+  if (count == 0)
+    remove_instr(opt, index);
+
+  else
+    set_cts(instr, count);
+
+  return TRUE;
+}
+
+static bool_t
+remove_unreachable(struct Optimizer* const opt)
+{
+  uint32_t* const pending = mem_alloc((2 * opt->count + 1) * sizeof(uint32_t));
+  bool_t* const   reached = mem_alloc((opt->count + 1) * sizeof(bool_t));
+  uint32_t pendingCount = 0, i;
+  bool_t changed = FALSE;
+
+  if ((pending == NULL) || (reached == NULL))
+  {
+    if (pending != NULL)
+      mem_free(pending);
+
+    if (reached != NULL)
+      mem_free(reached);
+
+    return FALSE;
+  }
+
+  memset(reached, 0, (opt->count + 1) * sizeof(bool_t));
+
+  pending[pendingCount++] = next_live(opt, 0);
+  while (pendingCount > 0)
+  {
+    const uint32_t index = pending[--pendingCount];
+    const struct Instruction* instr;
+    enum W_OPCODE opcode;
+
+    if ((index >= opt->count) || reached[index])
+      continue;
+
+    reached[index] = TRUE;
+
+    instr  = opt->instrs + index;
+    opcode = instr_opcode(instr);
+
+    if (is_jump(opcode))
+      pending[pendingCount++] = jump_target(opt, instr);
+
+    if ((opcode != W_JMP) && (opcode != W_RET))
+      pending[pendingCount++] = next_live(opt, index + 1);
+  }
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    if ( ! opt->instrs[i].removed && ! reached[i])
+    {
+      opt->instrs[i].removed = TRUE;
+      changed = TRUE;
+    }
+  }
+
+  mem_free(pending);
+  mem_free(reached);
+
+  return changed;
+}
+
+/* A local that is never read after its stores may lose the stores, as long
+ * as the stored values cannot fail to be computed or converted. */
+static bool_t
+remove_dead_stores(struct Optimizer* const opt)
+{
+  uint32_t localsCount = 0, i;
+  uint32_t *reads, *stores;
+  bool_t changed = FALSE;
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+
+    if ( ! instr->removed && (W_LDLO8 <= opcode) && (opcode <= W_LDLO32))
+    {
+      const uint32_t local = local_index(instr);
+
+      if (local >= localsCount)
+        localsCount = local + 1;
+    }
+  }
+
+  if (localsCount <= opt->paramsCount)
+    return FALSE;
+
+  reads  = mem_alloc(localsCount * sizeof(uint32_t));
+  stores = mem_alloc(localsCount * sizeof(uint32_t));
+  if ((reads == NULL) || (stores == NULL))
+  {
+    if (reads != NULL)
+      mem_free(reads);
+
+    if (stores != NULL)
+      mem_free(stores);
+
+    return FALSE;
+  }
+
+  memset(reads, 0, localsCount * sizeof(uint32_t));
+  memset(stores, 0, localsCount * sizeof(uint32_t));
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+    uint32_t store[3], it = i, j;
+    bool_t isStore = TRUE;
+
+    if (instr->removed || (opcode < W_LDLO8) || (opcode > W_LDLO32))
+      continue;
+
+    ++reads[local_index(instr)];
+
+    for (j = 0; isStore && (j < 3); ++j)
+    {
+      it = next_live(opt, it + 1);
+      isStore = (it < opt->count) && ! opt->instrs[it].targeted;
+      store[j] = it;
+    }
+
+    isStore = isStore
+              && is_pure_push(instr_opcode(opt->instrs + store[0]))
+              && ((instr_opcode(opt->instrs + store[0]) != W_LDNULL)
+                  || (opt->instrs[store[0]].code[opcode_bytes(W_LDNULL)] == 1))
+              && is_scalar_store(instr_opcode(opt->instrs + store[1]))
+              && (instr_opcode(opt->instrs + store[2]) == W_CTS);
+
+    if (isStore)
+      ++stores[local_index(instr)];
+  }
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+    uint32_t local, it, j;
+
+    if (instr->removed || (opcode < W_LDLO8) || (opcode > W_LDLO32))
+      continue;
+
+    local = local_index(instr);
+    if ((local < opt->paramsCount) || (reads[local] != stores[local]))
+      continue;
+
+    for (it = i, j = 0; j < 2; ++j)
+    {
+      it = next_live(opt, it + 1);
+      remove_instr(opt, it);
+    }
+
+    it = next_live(opt, it + 1);
+    if (opt->instrs[it].code[opcode_bytes(W_CTS)] > 1)
+      set_cts(opt->instrs + it, opt->instrs[it].code[opcode_bytes(W_CTS)] - 1);
+
+    else
+      remove_instr(opt, it);
+
+    remove_instr(opt, i);
+    changed = TRUE;
+  }
+
+  mem_free(reads);
+  mem_free(stores);
+
+  return changed;
+}
+
+static bool_t
+run_passes(struct Optimizer* const opt)
+{
+  bool_t changed = FALSE;
+  uint32_t i;
+
+  mark_targets(opt);
+  for (i = 0; i < opt->count; ++i)
+  {
+    if (opt->instrs[i].removed)
+      continue;
+
+    if (fold_constants(opt, i)
+        || fold_conditional_jump(opt, i)
+        || thread_jump(opt, i)
+        || clean_stack(opt, i))
+    {
+      changed = TRUE;
+    }
+  }
+
+  mark_targets(opt);
+  changed |= remove_unreachable(opt);
+
+  mark_targets(opt);
+  changed |= remove_dead_stores(opt);
+
+  return changed;
+}
+
+static bool_t
+decode_code(struct Optimizer* const   opt,
+            const uint8_t* const      code,
+            const uint32_t            codeSize)
+{
+  uint32_t* const indexes = mem_alloc((codeSize + 1) * sizeof(uint32_t));
+  uint32_t pos, i;
+
+  if (indexes == NULL)
+    return FALSE;
+
+  for (pos = 0; pos <= codeSize; ++pos)
+    indexes[pos] = NO_TARGET;
+
+  for (pos = 0, opt->count = 0; pos < codeSize; ++opt->count)
+  {
+    const enum W_OPCODE opcode = decode_opcode(code + pos);
+
+    indexes[pos] = opt->count;
+    pos += opcode_bytes(opcode) + opcode_args_bytes(opcode);
+  }
+
+  if (pos != codeSize)
+    goto decode_fail;
+
+  indexes[codeSize] = opt->count;
+
+  opt->instrs = mem_alloc((opt->count + 1) * sizeof(struct Instruction));
+  if (opt->instrs == NULL)
+    goto decode_fail;
+
+  for (pos = 0, i = 0; i < opt->count; ++i)
+  {
+    struct Instruction* const instr = opt->instrs + i;
+    const enum W_OPCODE opcode = decode_opcode(code + pos);
+
+    instr->pos      = pos;
+    instr->size     = opcode_bytes(opcode) + opcode_args_bytes(opcode);
+    instr->target   = NO_TARGET;
+    instr->removed  = FALSE;
+    instr->targeted = FALSE;
+
+    assert(instr->size <= MAX_INSTR_SIZE);
+
+    memset(instr->code, 0, sizeof instr->code);
+    memcpy(instr->code, code + pos, instr->size);
+
+    if (is_jump(opcode))
+    {
+      const int64_t target = (int64_t)pos
+                             + (int32_t)load_le_int32(code + pos + opcode_bytes(opcode));
+
+      if ((target < 0) || (target > codeSize) || (indexes[target] == NO_TARGET))
+      {
+        mem_free(opt->instrs);
+        goto decode_fail;
+      }
+
+      instr->target = indexes[target];
+    }
+
+    pos += instr->size;
+  }
+
+  mem_free(indexes);
+  return TRUE;
+
+decode_fail:
+  mem_free(indexes);
+  return FALSE;
+}
+
+static bool_t
+encode_code(struct Optimizer* const opt, struct WOutputStream* const stream)
+{
+  uint32_t* const positions = mem_alloc((opt->count + 1) * sizeof(uint32_t));
+  uint32_t pos = 0, i;
+
+  if (positions == NULL)
+    return FALSE;
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    positions[i] = pos;
+    if ( ! opt->instrs[i].removed)
+      pos += opt->instrs[i].size;
+  }
+  positions[opt->count] = pos;
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    struct Instruction* const instr = opt->instrs + i;
+
+    if (instr->removed)
+      continue;
+
+    if (is_jump(instr_opcode(instr)))
+    {
+      const int32_t offset = positions[jump_target(opt, instr)] - positions[i];
+      store_le_int32(offset, instr->code + opcode_bytes(instr_opcode(instr)));
+    }
+
+    if (wh_ostream_write(stream, instr->code, instr->size) == NULL)
+    {
+      mem_free(positions);
+      return FALSE;
+    }
+  }
+
+  mem_free(positions);
+  return TRUE;
+}
+
+/* Find the procedure called through an import table entry. */
+static struct Statement*
+called_proc(const struct Statement* const glb, const uint32_t importId)
+{
+  const struct WArray* const procs = &glb->spec.glb.procsDecls;
+  uint_t i;
+
+  for (i = 0; i < wh_array_count(procs); ++i)
+  {
+    struct Statement* const proc = wh_array_get(procs, i);
+
+    if (IS_REFERRED(proc->spec.proc.procId)
+        && (RETRIVE_ID(proc->spec.proc.procId) == importId))
+    {
+      return proc;
+    }
+  }
+
+  return NULL;
+}
+
+/* How many values an instruction leaves on the stack besides the ones it
+ * takes from there. Fails for the instructions not handled here. */
+static bool_t
+stack_effect(const struct Instruction* const   instr,
+             const struct Statement* const     glb,
+             int* const                        outEffect)
+{
+  const enum W_OPCODE opcode = instr_opcode(instr);
+
+  switch (opcode)
+  {
+  case W_LDNULL:
+    *outEffect = instr_args(instr)[0];
+    break;
+
+  case W_CTS:
+    *outEffect = -(int)instr_args(instr)[0];
+    break;
+
+  case W_CALL:
+    {
+      const struct Statement* const proc = called_proc(glb,
+                                                       load_le_int32(instr_args(instr)));
+      if (proc == NULL)
+        return FALSE;
+
+      *outEffect = 1 - (int)stmt_get_param_count(proc);
+    }
+    break;
+
+  case W_INULL:
+  case W_NNULL:
+  case W_NOT:
+  case W_NOTB:
+  case W_SELF:
+  case W_JF:
+  case W_JT:
+  case W_JMP:
+  case W_RET:
+  case W_BSYNC:
+  case W_ESYNC:
+    *outEffect = 0;
+    break;
+
+  case W_JFC:
+  case W_JTC:
+    *outEffect = -1;
+    break;
+
+  default:
+    if (is_pure_push(opcode) || ((W_LDGB8 <= opcode) && (opcode <= W_LDGB32)))
+      *outEffect = 1;
+
+    else if (((W_STB <= opcode) && (opcode <= W_STUD))
+             || is_binary_operator(opcode)
+             || ((W_INDT <= opcode) && (opcode <= W_INDTA))
+             || ((W_SADD <= opcode) && (opcode <= W_SORB)))
+    {
+      *outEffect = -1;
+    }
+    else
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Find the count of the temporary values kept on the stack before each of the
+ * reachable instructions. Fails if it depends on the path taken to reach an
+ * instruction. */
+static bool_t
+stack_depths(const struct Optimizer* const   opt,
+             const struct Statement* const   glb,
+             int32_t* const                  outDepths)
+{
+  uint32_t* const pending = mem_alloc((opt->count + 1) * sizeof(uint32_t));
+  uint32_t pendingCount = 0, i;
+  bool_t result = TRUE;
+
+  if (pending == NULL)
+    return FALSE;
+
+  for (i = 0; i < opt->count; ++i)
+    outDepths[i] = NO_DEPTH;
+
+  if (opt->count > 0)
+  {
+    outDepths[0] = 0;
+    pending[pendingCount++] = 0;
+  }
+
+  while (result && (pendingCount > 0))
+  {
+    const uint32_t index = pending[--pendingCount];
+    const struct Instruction* const instr = opt->instrs + index;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+    uint32_t next[2], nextCount = 0, j;
+    int effect;
+
+    if ( ! stack_effect(instr, glb, &effect) || (outDepths[index] + effect < 0))
+    {
+      result = FALSE;
+      break;
+    }
+
+    if (is_jump(opcode))
+      next[nextCount++] = instr->target;
+
+    if ((opcode != W_JMP) && (opcode != W_RET))
+      next[nextCount++] = index + 1;
+
+    for (j = 0; j < nextCount; ++j)
+    {
+      if (next[j] >= opt->count)
+        continue;
+
+      if (outDepths[next[j]] == NO_DEPTH)
+      {
+        outDepths[next[j]] = outDepths[index] + effect;
+        pending[pendingCount++] = next[j];
+      }
+      else if (outDepths[next[j]] != outDepths[index] + effect)
+        result = FALSE;
+    }
+  }
+
+  mem_free(pending);
+
+  return result;
+}
+
+static const struct DeclaredVar*
+proc_local(const struct Statement* const proc, const uint32_t id)
+{
+  uint_t i;
+
+  for (i = 0; i < wh_array_count(&proc->decls); ++i)
+  {
+    const struct DeclaredVar* const var = wh_array_get(&proc->decls, i);
+
+    if ( ! IS_TABLE_FIELD(var->type) && (RETRIVE_ID(var->varId) == id))
+      return var;
+  }
+
+  return NULL;
+}
+
+/* The instruction storing a value into a local of a basic type, other than
+ * text, or W_NA for the other locals. */
+static enum W_OPCODE
+local_store_op(const struct DeclaredVar* const var)
+{
+  uint_t type;
+
+  if (var == NULL)
+    return W_NA;
+
+  type = GET_TYPE(var->type);
+  if ((type < T_BOOL) || (type > T_RICHREAL) || ! is_scalar_store(store_op[type][type]))
+    return W_NA;
+
+  return store_op[type][type];
+}
+
+static void
+set_local(struct Instruction* const instr, const uint32_t local)
+{
+  if (local <= 0xFF)
+  {
+    set_instr(instr, W_LDLO8, 1);
+    instr->code[opcode_bytes(W_LDLO8)] = local;
+  }
+  else if (local <= 0xFFFF)
+  {
+    set_instr(instr, W_LDLO16, 2);
+    store_le_int16(local, instr->code + opcode_bytes(W_LDLO16));
+  }
+  else
+  {
+    set_instr(instr, W_LDLO32, 4);
+    store_le_int32(local, instr->code + opcode_bytes(W_LDLO32));
+  }
+}
+
+/* Add to a procedure a local, without a name, of the same type as 'var'. */
+static bool_t
+add_hidden_local(struct Statement* const proc, const struct DeclaredVar* const var)
+{
+  struct DeclaredVar local = *var;
+
+  local.label       = NULL;
+  local.labelLength = 0;
+  local.varId       = proc->localsUsed;
+
+  if (wh_array_add(&proc->decls, &local) == NULL)
+    return FALSE;
+
+  ++proc->localsUsed;
+
+  return TRUE;
+}
+
+/* Marks the arguments taken from the results of other inlined calls. */
+#define ARG_FROM_CALL       0x80000000
+
+struct InlinedCall
+{
+  struct Statement*   proc;         /* The called procedure. */
+  struct Optimizer    body;         /* Its decoded code. */
+  uint32_t*           args;         /* Sources of the substituted arguments. */
+  uint32_t            index;        /* Index of the replaced call. */
+  uint32_t            argsDepth;    /* The temporary values below the arguments. */
+  uint32_t            localsBase;   /* Id of the local holding the call's result,
+                                       the procedure's locals follow it. */
+  uint32_t            length;       /* Count of the instructions replacing the call. */
+  bool_t              substitute;   /* The arguments are pushed where they are used. */
+  bool_t              directResult; /* The result is left on the stack by the code. */
+  bool_t              resultAsArg;  /* The result is substituted to another call. */
+  bool_t              pureBody;     /* The code does not change its parameters. */
+  bool_t              straight;     /* The code has no jumps and a single return. */
+};
+
+/* Find the instruction that pushed the value stored to by the instruction at
+ * 'index', i.e. the last one that started with it on the stack top. Returns
+ * NO_TARGET if this cannot be told. */
+static uint32_t
+store_dest(const struct Optimizer* const   opt,
+           const int32_t* const            depths,
+           const uint32_t                  index)
+{
+  uint32_t it = index;
+
+  if (depths[index] < 2)
+    return NO_TARGET;
+
+  while (it-- > 0)
+  {
+    if (is_jump(instr_opcode(opt->instrs + it)) || opt->instrs[it + 1].targeted)
+      return NO_TARGET;
+
+    if (depths[it] == depths[index] - 2)
+      return it;
+  }
+
+  return NO_TARGET;
+}
+
+/* Check if the value stored by the instruction at 'index' goes into one of
+ * the procedure's parameters, or if this cannot be told. */
+static bool_t
+stores_param(const struct Optimizer* const   body,
+             const int32_t* const            depths,
+             const uint32_t                  index)
+{
+  const uint32_t dest = store_dest(body, depths, index);
+  enum W_OPCODE opcode;
+
+  if (depths[index] == NO_DEPTH)
+    return FALSE;
+
+  else if (dest == NO_TARGET)
+    return TRUE;
+
+  opcode = instr_opcode(body->instrs + dest);
+
+  return (opcode < W_LDLO8)
+         || (opcode > W_LDLO32)
+         || (local_index(body->instrs + dest) < body->paramsCount);
+}
+
+/* Only the procedures, other than the caller, that do not use iterators or
+ * synchronized statements, do not call themselves and have only locals of
+ * basic types may have their code inlined. Their code has to return with
+ * only the result left on the stack. */
+static bool_t
+decode_inlinable(const struct Statement* const   caller,
+                 struct InlinedCall* const       call)
+{
+  const struct Statement* const glb = caller->parent;
+  struct Statement* const proc = call->proc;
+  struct Optimizer* const body = &call->body;
+  struct WOutputStream* const code = stmt_query_instrs(proc);
+  const uint_t paramsCount = stmt_get_param_count(proc);
+  const uint_t maxSize = (proc->spec.proc.inlinePragma == INLINE_ALWAYS)
+                         ? INLINE_MAX_FORCED_SIZE
+                         : INLINE_MAX_SIZE;
+  int32_t* depths;
+  bool_t result;
+  uint32_t i;
+
+  if ((proc == caller)
+      || IS_EXTERNAL(proc->spec.proc.procId)
+      || (proc->spec.proc.inlinePragma == INLINE_NEVER)
+      || (proc->spec.proc.syncTracker != 0)
+      || (paramsCount >= 0xFF)
+      || (wh_ostream_size(code) > maxSize)
+      || (local_store_op(stmt_get_param(proc, 0)) == W_NA))
+  {
+    return FALSE;
+  }
+
+  for (i = paramsCount + 1; i < proc->localsUsed; ++i)
+  {
+    if (local_store_op(proc_local(proc, i)) == W_NA)
+      return FALSE;
+  }
+
+  body->instrs      = NULL;
+  body->count       = 0;
+  body->paramsCount = paramsCount;
+
+  if ( ! decode_code(body, wh_ostream_data(code), wh_ostream_size(code)))
+    return FALSE;
+
+  mark_targets(body);
+
+  depths = mem_alloc((body->count + 1) * sizeof(int32_t));
+  result = (depths != NULL)
+           && (body->count > 0)
+           && (instr_opcode(body->instrs + body->count - 1) == W_RET)
+           && stack_depths(body, glb, depths);
+
+  call->pureBody = TRUE;
+  call->straight = TRUE;
+  for (i = 0; result && (i < body->count); ++i)
+  {
+    const struct Instruction* const instr = body->instrs + i;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+
+    if ((W_LDLO8 <= opcode) && (opcode <= W_LDLO32))
+      result = (local_index(instr) + 1 < proc->localsUsed);
+
+    else if (opcode == W_CALL)
+    {
+      const struct Statement* const called = called_proc(glb,
+                                                         load_le_int32(instr_args(instr)));
+      result = (called != proc) && (called != caller);
+
+      /* The parameters may be passed to be changed by the called procedure. */
+      call->pureBody = FALSE;
+    }
+    else if (opcode == W_RET)
+    {
+      result = (depths[i] == 1) || (depths[i] == NO_DEPTH);
+      call->straight &= (i + 1 == body->count);
+    }
+    else if ((opcode == W_BSYNC) || (opcode == W_ESYNC))
+      result = FALSE;
+
+    else if (is_jump(opcode))
+      call->straight = FALSE;
+
+    else if (((W_STB <= opcode) && (opcode <= W_STUD))
+             || ((W_SADD <= opcode) && (opcode <= W_SORB)))
+    {
+      call->pureBody &= ! stores_param(body, depths, i);
+    }
+  }
+
+  if (depths != NULL)
+    mem_free(depths);
+
+  if ( ! result)
+  {
+    mem_free(body->instrs);
+    body->instrs = NULL;
+  }
+
+  return result;
+}
+
+/* Check if the arguments of a call are pushed each by a single instruction,
+ * or are the results of other inlined calls, so they may be moved where the
+ * procedure uses its parameters, as long as the procedure does not change
+ * them. */
+static bool_t
+substitutable_args(const struct Optimizer* const   opt,
+                   const int32_t* const            depths,
+                   struct InlinedCall* const       calls,
+                   const uint32_t                  callsCount,
+                   struct InlinedCall* const       call)
+{
+  const uint_t paramsCount = call->body.paramsCount;
+  uint32_t start = call->index, i;
+  uint_t arg;
+
+  if (paramsCount == 0)
+    return TRUE;
+
+  if ( ! call->pureBody || opt->instrs[call->index].targeted)
+    return FALSE;
+
+  call->args = mem_alloc(paramsCount * sizeof(uint32_t));
+  if (call->args == NULL)
+    return FALSE;
+
+  for (arg = paramsCount; arg-- > 0; )
+  {
+    const uint32_t last = start - 1;
+    const int32_t argDepth = call->argsDepth + arg;
+    const struct Instruction* instr;
+    enum W_OPCODE opcode;
+
+    if (start == 0)
+      return FALSE;
+
+    instr  = opt->instrs + last;
+    opcode = instr_opcode(instr);
+
+    if (is_pure_push(opcode) && (depths[last] == argDepth))
+    {
+      if ((opcode == W_LDNULL) && (instr_args(instr)[0] != 1))
+        return FALSE;
+
+      call->args[arg] = last;
+      start = last;
+    }
+    else if (opcode == W_CALL)
+    {
+      uint32_t source = callsCount;
+
+      while ((source-- > 0) && (calls[source].index > last))
+        ;
+
+      if ((source >= callsCount)
+          || (calls[source].index != last)
+          || calls[source].directResult)
+      {
+        return FALSE;
+      }
+
+      /* The other call stays in place, with its arguments. */
+      for (start = last; (start > 0) && (depths[start] > argDepth); --start)
+        ;
+
+      if (depths[start] != argDepth)
+        return FALSE;
+
+      call->args[arg] = source | ARG_FROM_CALL;
+    }
+    else
+      return FALSE;
+  }
+
+  for (i = start; i < call->index; ++i)
+  {
+    if (is_jump(instr_opcode(opt->instrs + i))
+        || ((i > start) && opt->instrs[i].targeted))
+    {
+      return FALSE;
+    }
+  }
+
+  for (arg = 0; arg < paramsCount; ++arg)
+  {
+    if (call->args[arg] & ARG_FROM_CALL)
+      calls[call->args[arg] & ~ARG_FROM_CALL].resultAsArg = TRUE;
+
+    else
+      opt->instrs[call->args[arg]].removed = TRUE;
+  }
+
+  return TRUE;
+}
+
+/* Check if a local of the inlined procedure is always set before being read,
+ * so it does not need to be reset to null. */
+static bool_t
+set_before_read(const struct Optimizer* const body, const uint32_t local)
+{
+  uint32_t i;
+
+  for (i = 0; i + 3 < body->count; ++i)
+  {
+    const struct Instruction* const instr = body->instrs + i;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+    const struct Instruction* const value = body->instrs + i + 1;
+
+    if (is_jump(opcode) || (opcode == W_RET))
+      return FALSE;
+
+    if ((opcode < W_LDLO8) || (opcode > W_LDLO32) || (local_index(instr) != local))
+      continue;
+
+    return is_pure_push(instr_opcode(value))
+           && ((instr_opcode(value) < W_LDLO8)
+               || (instr_opcode(value) > W_LDLO32)
+               || (local_index(value) != local))
+           && ((instr_opcode(value) != W_LDNULL) || (instr_args(value)[0] == 1))
+           && is_scalar_store(instr_opcode(body->instrs + i + 2))
+           && (instr_opcode(body->instrs + i + 3) == W_CTS);
+  }
+
+  return FALSE;
+}
+
+/* Write the instructions replacing a call, starting at 'base', or just count
+ * them if there is no output. Unless its value is left on the stack by the
+ * code, the result is stored into a local of the caller, loaded after the
+ * call's arguments are removed from the stack. */
+static uint32_t
+emit_inlined_call(struct Instruction* const          out,
+                  const uint32_t                     base,
+                  struct InlinedCall* const          call,
+                  const struct InlinedCall* const    calls,
+                  const struct Optimizer* const      caller,
+                  const uint32_t                     frameSize)
+{
+  const struct Statement* const proc = call->proc;
+  struct Optimizer* const body = &call->body;
+  const bool_t cleanArgs = ! call->substitute && (body->paramsCount > 0);
+  const uint32_t resultLocal = call->localsBase - 1;
+  uint32_t endIndex, pos = base, id, i;
+
+  /* The procedure's locals start as null values on every call. */
+  for (id = body->paramsCount + 1; id < proc->localsUsed; ++id)
+  {
+    if (set_before_read(body, id - 1))
+      continue;
+
+    if (out != NULL)
+    {
+      set_local(out + pos, resultLocal + id - body->paramsCount);
+
+      set_instr(out + pos + 1, W_LDNULL, 1);
+      out[pos + 1].code[opcode_bytes(W_LDNULL)] = 1;
+
+      set_instr(out + pos + 2, local_store_op(proc_local(proc, id)), 0);
+      set_cts(out + pos + 3, 1);
+    }
+    pos += 4;
+  }
+
+  if ( ! call->directResult)
+  {
+    if (out != NULL)
+      set_local(out + pos, resultLocal);
+
+    ++pos;
+  }
+
+  for (i = 0, id = pos; i < body->count; ++i)
+  {
+    body->instrs[i].pos = id;
+
+    if (instr_opcode(body->instrs + i) != W_RET)
+      ++id;
+
+    else if ( ! call->directResult)
+      id += (i + 1 < body->count) ? 2 : 1;
+  }
+  endIndex = id;
+
+  if (out == NULL)
+  {
+    if (cleanArgs)
+      return endIndex - base + (call->resultAsArg ? 1 : 2);
+
+    return endIndex - base + (call->resultAsArg ? 1 : 0);
+  }
+
+  for (i = 0; i < body->count; ++i)
+  {
+    const struct Instruction* const instr = body->instrs + i;
+    const enum W_OPCODE opcode = instr_opcode(instr);
+    struct Instruction* const copy = out + pos;
+
+    if (opcode == W_RET)
+    {
+      if (call->directResult)
+        continue;
+
+      set_instr(copy, local_store_op(stmt_get_param(proc, 0)), 0);
+      if (i + 1 < body->count)
+        set_jump(out + ++pos, W_JMP, endIndex);
+    }
+    else if ((W_LDLO8 <= opcode) && (opcode <= W_LDLO32))
+    {
+      const uint32_t local = local_index(instr);
+
+      if (local >= body->paramsCount)
+        set_local(copy, resultLocal + local + 1 - body->paramsCount);
+
+      else if ( ! call->substitute)
+        set_local(copy, frameSize + call->argsDepth + local);
+
+      else if (call->args[local] & ARG_FROM_CALL)
+        set_local(copy, calls[call->args[local] & ~ARG_FROM_CALL].localsBase - 1);
+
+      else
+        *copy = caller->instrs[call->args[local]];
+    }
+    else
+    {
+      *copy = *instr;
+      if (is_jump(opcode))
+      {
+        copy->target = (instr->target < body->count)
+                       ? body->instrs[instr->target].pos
+                       : endIndex;
+      }
+    }
+
+    copy->removed  = FALSE;
+    copy->targeted = FALSE;
+    ++pos;
+  }
+
+  assert(pos == endIndex);
+
+  /* The substituted results are loaded where the other call uses them. */
+  if (cleanArgs)
+  {
+    set_cts(out + pos++, body->paramsCount + 1);
+    if ( ! call->resultAsArg)
+      set_local(out + pos++, resultLocal);
+  }
+  else if (call->resultAsArg)
+    set_cts(out + pos++, 1);
+
+  return pos - base;
+}
+
+/* Leaving the result on the stack needs the arguments out of the way and
+ * a value, not a reference, computed by the procedure's code. */
+static bool_t
+direct_result(const struct InlinedCall* const call)
+{
+  const struct Optimizer* const body = &call->body;
+  enum W_OPCODE last;
+
+  if ( ! call->substitute || ! call->straight || (body->count < 2))
+    return FALSE;
+
+  last = instr_opcode(body->instrs + body->count - 2);
+
+  return is_binary_operator(last)
+         || (last == W_INULL)
+         || (last == W_NNULL);
+}
+
+/* The arguments substituted to a call are no longer on the stack when the
+ * inlined calls computing its other arguments are run. */
+static void
+adjust_args_depth(struct InlinedCall* const    calls,
+                  const uint32_t               callsCount)
+{
+  uint32_t i, j;
+  uint_t arg;
+
+  for (i = 0; i < callsCount; ++i)
+  {
+    struct InlinedCall* const call = calls + i;
+
+    if (call->substitute || (call->body.paramsCount == 0))
+      continue;
+
+    for (j = i + 1; j < callsCount; ++j)
+    {
+      const struct InlinedCall* const user = calls + j;
+
+      if ( ! user->substitute)
+        continue;
+
+      for (arg = 0; arg < user->body.paramsCount; ++arg)
+      {
+        const uint32_t source = (user->args[arg] & ARG_FROM_CALL)
+                                ? calls[user->args[arg] & ~ARG_FROM_CALL].index
+                                : user->args[arg];
+        if (source < call->index)
+          --call->argsDepth;
+      }
+    }
+  }
+}
+
+static bool_t
+inline_calls(struct Optimizer* const opt, struct Statement* const proc)
+{
+  const struct Statement* const glb = proc->parent;
+  int32_t* const depths = mem_alloc((opt->count + 1) * sizeof(int32_t));
+  struct InlinedCall* const calls = mem_alloc((opt->count + 1) * sizeof(struct InlinedCall));
+  struct Instruction* instrs = NULL;
+  uint32_t* indexes = NULL;
+  uint32_t callsCount = 0, growth = 0, newCount, frameSize, pos, i, j;
+  bool_t result = FALSE;
+
+  if ((depths == NULL) || (calls == NULL) || ! stack_depths(opt, glb, depths))
+    goto inline_end;
+
+  mark_targets(opt);
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+    struct InlinedCall* const call = calls + callsCount;
+
+    if ((instr_opcode(instr) != W_CALL) || (depths[i] == NO_DEPTH))
+      continue;
+
+    memset(call, 0, sizeof *call);
+
+    call->index = i;
+    call->proc  = called_proc(glb, load_le_int32(instr_args(instr)));
+    if ((call->proc == NULL)
+        || (growth + wh_ostream_size(stmt_query_instrs(call->proc)) > INLINE_MAX_GROWTH)
+        || ! decode_inlinable(proc, call))
+    {
+      continue;
+    }
+
+    call->argsDepth  = depths[i] - call->body.paramsCount;
+    call->substitute = substitutable_args(opt, depths, calls, callsCount, call);
+    if ( ! call->substitute && (call->args != NULL))
+    {
+      mem_free(call->args);
+      call->args = NULL;
+    }
+
+    call->directResult = direct_result(call);
+
+    growth += wh_ostream_size(stmt_query_instrs(call->proc));
+    ++callsCount;
+  }
+
+  if (callsCount == 0)
+    goto inline_end;
+
+  adjust_args_depth(calls, callsCount);
+
+  for (j = 0; j < callsCount; ++j)
+  {
+    struct InlinedCall* const call = calls + j;
+    uint32_t id;
+
+    call->localsBase = proc->localsUsed;
+    if ( ! add_hidden_local(proc, stmt_get_param(call->proc, 0)))
+      goto inline_end;
+
+    for (id = call->body.paramsCount + 1; id < call->proc->localsUsed; ++id)
+    {
+      if ( ! add_hidden_local(proc, proc_local(call->proc, id)))
+        goto inline_end;
+    }
+  }
+
+  for (i = 0, newCount = 0, j = 0; i < opt->count; ++i)
+  {
+    if ((j < callsCount) && (calls[j].index == i))
+      newCount += emit_inlined_call(NULL, 0, calls + j++, calls, opt, 0);
+
+    else if ( ! opt->instrs[i].removed)
+      ++newCount;
+  }
+
+  instrs  = mem_alloc((newCount + 1) * sizeof(struct Instruction));
+  indexes = mem_alloc((opt->count + 1) * sizeof(uint32_t));
+  if ((instrs == NULL) || (indexes == NULL))
+    goto inline_end;
+
+  memset(instrs, 0, (newCount + 1) * sizeof(struct Instruction));
+
+  /* The temporary values of the caller are kept after all of its locals. */
+  frameSize = proc->localsUsed - 1;
+  for (i = 0, j = 0, pos = 0; i < opt->count; ++i)
+  {
+    indexes[i] = pos;
+
+    if ((j < callsCount) && (calls[j].index == i))
+      pos += emit_inlined_call(instrs, pos, calls + j++, calls, opt, frameSize);
+
+    else if ( ! opt->instrs[i].removed)
+      instrs[pos++] = opt->instrs[i];
+  }
+  indexes[opt->count] = pos;
+
+  assert(pos == newCount);
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    if ( ! opt->instrs[i].removed && is_jump(instr_opcode(opt->instrs + i)))
+      instrs[indexes[i]].target = indexes[opt->instrs[i].target];
+  }
+
+  mem_free(opt->instrs);
+  opt->instrs = instrs;
+  opt->count  = newCount;
+
+  instrs = NULL;
+  result = TRUE;
+
+inline_end:
+  for (j = 0; j < callsCount; ++j)
+  {
+    mem_free(calls[j].body.instrs);
+    if (calls[j].args != NULL)
+      mem_free(calls[j].args);
+  }
+
+  if (instrs != NULL)
+    mem_free(instrs);
+
+  if (indexes != NULL)
+    mem_free(indexes);
+
+  if (calls != NULL)
+    mem_free(calls);
+
+  if (depths != NULL)
+    mem_free(depths);
+
+  return result;
+}
+
+/* How the locals are changed inside a loop. */
+#define LOCAL_STEPPED       0x01  /* Only incremented by constant steps. */
+#define LOCAL_WRITTEN       0x02  /* Changed in some other way. */
+
+/* A value computed inside a loop by the instructions from 'start' to 'end',
+ * replaced by loading a hidden local. The local gets its value before the
+ * loop is entered, by the code of its first value. */
+struct LoopValue
+{
+  uint32_t    start;
+  uint32_t    end;
+  uint32_t    local;
+  bool_t      first;
+};
+
+/* An increment of an induction variable, ending with the CTS at 'index'. */
+struct LoopStep
+{
+  uint32_t          index;
+  uint32_t          variable;
+  enum W_OPCODE     opcode;
+  uint64_t          value;
+};
+
+/* The product of an induction variable with a constant, kept into a hidden
+ * local and updated along with the variable. */
+struct Induction
+{
+  uint32_t          variable;
+  enum W_OPCODE     opcode;
+  uint64_t          factor;
+  uint32_t          uses;
+  uint32_t          local;
+};
+
+struct LoopPlan
+{
+  uint32_t              head;         /* Where the loop is entered. */
+  uint32_t              end;          /* Its last jump back. */
+  struct LoopValue*     values;
+  uint32_t              valuesCount;
+  struct LoopStep*      steps;
+  uint32_t              stepsCount;
+  struct Induction      inductions[MAX_INDUCTIONS];
+  uint32_t              inductionsCount;
+  uint32_t              localsCount;  /* The hidden locals needed. */
+};
+
+/* Find where the loop closed by the backward jump at 'end' is entered: its
+ * first instruction, or the jump to its condition placed right before it.
+ * The code computing the loop's invariant values goes there, so any other
+ * jump entering the loop from outside makes it unsuitable. */
+static bool_t
+loop_head(const struct Optimizer* const   opt,
+          const uint32_t                  end,
+          uint32_t* const                 outHead)
+{
+  const uint32_t first = opt->instrs[end].target;
+  uint32_t head = first, i;
+
+  if ((first > 0)
+      && (instr_opcode(opt->instrs + first - 1) == W_JMP)
+      && (first < opt->instrs[first - 1].target)
+      && (opt->instrs[first - 1].target <= end))
+  {
+    head = first - 1;
+  }
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    const uint32_t target = opt->instrs[i].target;
+
+    if (((head <= i) && (i <= end)) || ! is_jump(instr_opcode(opt->instrs + i)))
+      continue;
+
+    if ((head < target) && (target <= end))
+      return FALSE;
+  }
+
+  *outHead = head;
+  return TRUE;
+}
+
+/* The parameter or the local loaded by 'LDLO local'. */
+static const struct DeclaredVar*
+frame_var(const struct Statement* const proc, const uint32_t local)
+{
+  if (local < stmt_get_param_count(proc))
+    return stmt_get_param(proc, local + 1);
+
+  return proc_local(proc, local + 1);
+}
+
+/* Check if the store at 'index' adds a constant to an integer local, leaving
+ * nothing on the stack, i.e. 'LDLO i; LDI c; SADD; CTS 1'. */
+static bool_t
+loop_step(const struct Optimizer* const   opt,
+          const struct LoopPlan* const    plan,
+          const uint32_t                  dest,
+          const uint32_t                  index,
+          struct LoopStep* const          outStep)
+{
+  const enum W_OPCODE opcode = instr_opcode(opt->instrs + index);
+  struct ConstValue step;
+
+  if (((opcode != W_SADD) && (opcode != W_SSUB))
+      || (dest + 2 != index)
+      || (index + 1 > plan->end)
+      || opt->instrs[index - 1].targeted
+      || opt->instrs[index].targeted
+      || opt->instrs[index + 1].targeted
+      || (instr_opcode(opt->instrs + index + 1) != W_CTS)
+      || (instr_args(opt->instrs + index + 1)[0] != 1))
+  {
+    return FALSE;
+  }
+
+  step = instr_const(opt->instrs + index - 1);
+  if ((step.kind != CK_INT) || (step.value >= MAX_FOLD_FACTOR))
+    return FALSE;
+
+  outStep->index    = index + 1;
+  outStep->variable = local_index(opt->instrs + dest);
+  outStep->opcode   = opcode;
+  outStep->value    = step.value;
+
+  return TRUE;
+}
+
+/* Find how the locals are changed inside a loop. The parameters are marked as
+ * aliased when they may refer to values changed by other means (e.g. the
+ * locals of the caller passed to a call). Fails if some of the changed
+ * values cannot be told. */
+static bool_t
+loop_writes(const struct Optimizer* const   opt,
+            const struct Statement* const   proc,
+            const int32_t* const            depths,
+            struct LoopPlan* const          plan,
+            uint8_t* const                  writes,
+            bool_t* const                   outAliased)
+{
+  const uint32_t frame = proc->localsUsed - 1;
+  uint32_t i;
+
+  *outAliased = FALSE;
+  memset(writes, 0, frame + 1);
+
+  for (i = plan->head; i <= plan->end; ++i)
+  {
+    const enum W_OPCODE opcode = instr_opcode(opt->instrs + i);
+
+    if (depths[i] == NO_DEPTH)
+      continue;
+
+    if (((W_STB <= opcode) && (opcode <= W_STUD))
+        || ((W_SADD <= opcode) && (opcode <= W_SORB)))
+    {
+      const uint32_t dest = store_dest(opt, depths, i);
+      struct LoopStep* const step = plan->steps + plan->stepsCount;
+      enum W_OPCODE destOpcode;
+      uint32_t local;
+
+      if (dest == NO_TARGET)
+        return FALSE;
+
+      destOpcode = instr_opcode(opt->instrs + dest);
+      if ((W_LDGB8 <= destOpcode) && (destOpcode <= W_LDGB32))
+        *outAliased = TRUE;
+
+      if ((destOpcode < W_LDLO8) || (destOpcode > W_LDLO32))
+        continue;
+
+      /* The temporary values may refer to any of the locals. */
+      local = local_index(opt->instrs + dest);
+      if (local >= frame)
+        return FALSE;
+
+      if (local < opt->paramsCount)
+        *outAliased = TRUE;
+
+      if (loop_step(opt, plan, dest, i, step))
+      {
+        writes[local] |= LOCAL_STEPPED;
+        ++plan->stepsCount;
+      }
+      else
+        writes[local] |= LOCAL_WRITTEN;
+    }
+    else if (opcode == W_CALL)
+    {
+      uint32_t it = i;
+      int32_t argsDepth;
+      int effect;
+
+      if ( ! stack_effect(opt->instrs + i, proc->parent, &effect))
+        return FALSE;
+
+      /* The arguments are passed as they were pushed, so the called
+       * procedure may change the loaded locals. */
+      *outAliased = TRUE;
+      for (argsDepth = depths[i] + effect - 1; depths[it] > argsDepth; )
+      {
+        const struct Instruction* instr;
+
+        if (it == plan->head)
+          return FALSE;
+
+        instr = opt->instrs + --it;
+        if (is_jump(instr_opcode(instr)) || opt->instrs[it + 1].targeted)
+          return FALSE;
+
+        if ((W_LDLO8 <= instr_opcode(instr)) && (instr_opcode(instr) <= W_LDLO32))
+        {
+          if (local_index(instr) >= frame)
+            return FALSE;
+
+          writes[local_index(instr)] |= LOCAL_WRITTEN;
+        }
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+static bool_t
+is_division(const enum W_OPCODE opcode)
+{
+  return (opcode == W_DIV)
+         || (opcode == W_DIVU)
+         || (opcode == W_DIVRR)
+         || (opcode == W_MOD)
+         || (opcode == W_MODU);
+}
+
+/* The operands count of the operators computing a new value, or 0 for the
+ * other instructions. Only the divisions may fail. */
+static uint_t
+invariant_operands(const enum W_OPCODE opcode)
+{
+  switch (opcode)
+  {
+  case W_INULL:
+  case W_NNULL:
+  case W_NOT:
+  case W_NOTB:
+    return 1;
+
+  default:
+    break;
+  }
+
+  return is_binary_operator(opcode) ? 2 : 0;
+}
+
+/* The constants and the basic type locals not changed by the loop. */
+static bool_t
+invariant_leaf(const struct Optimizer* const     opt,
+               const struct Statement* const     proc,
+               const struct Instruction* const   instr,
+               const uint8_t* const              writes,
+               const bool_t                      aliased)
+{
+  const enum W_OPCODE opcode = instr_opcode(instr);
+  uint32_t local;
+
+  if (opcode == W_LDNULL)
+    return instr_args(instr)[0] == 1;
+
+  else if ( ! is_pure_push(opcode))
+    return FALSE;
+
+  else if (opcode < W_LDLO8)
+    return TRUE;
+
+  local = local_index(instr);
+  if ((local >= proc->localsUsed - 1)
+      || (writes[local] != 0)
+      || (aliased && (local < opt->paramsCount)))
+  {
+    return FALSE;
+  }
+
+  return local_store_op(frame_var(proc, local)) != W_NA;
+}
+
+/* Find the largest expressions computed inside the loop only from its
+ * invariants. The ones using only constants are left to be folded. */
+static void
+plan_invariants(const struct Optimizer* const   opt,
+                const struct Statement* const   proc,
+                const int32_t* const            depths,
+                const uint8_t* const            writes,
+                const bool_t                    aliased,
+                uint32_t* const                 starts,
+                bool_t* const                   usesLocals,
+                struct LoopPlan* const          plan)
+{
+  uint32_t i;
+
+  for (i = plan->head; i <= plan->end; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+    const uint_t operands = invariant_operands(instr_opcode(instr));
+    uint32_t second;
+
+    starts[i]     = NO_TARGET;
+    usesLocals[i] = FALSE;
+
+    if (depths[i] == NO_DEPTH)
+      continue;
+
+    if (invariant_leaf(opt, proc, instr, writes, aliased))
+    {
+      starts[i]     = i;
+      usesLocals[i] = ! (instr_opcode(instr) < W_LDLO8);
+      continue;
+    }
+
+    if ((operands == 0)
+        || (i == plan->head)
+        || instr->targeted
+        || (starts[i - 1] == NO_TARGET))
+    {
+      continue;
+    }
+
+    if (operands == 1)
+    {
+      starts[i]     = starts[i - 1];
+      usesLocals[i] = usesLocals[i - 1];
+      continue;
+    }
+
+    second = starts[i - 1];
+    if ((second == plan->head)
+        || opt->instrs[second].targeted
+        || (starts[second - 1] == NO_TARGET))
+    {
+      continue;
+    }
+
+    /* The divisions are moved only if they cannot fail wherever they are. */
+    if (is_division(instr_opcode(instr)))
+    {
+      const struct ConstValue divisor = instr_const(opt->instrs + i - 1);
+
+      if ((second != i - 1)
+          || (divisor.kind != CK_INT)
+          || (divisor.value == 0)
+          || (divisor.value >= MAX_FOLD_VALUE))
+      {
+        continue;
+      }
+    }
+
+    starts[i]     = starts[second - 1];
+    usesLocals[i] = usesLocals[i - 1] || usesLocals[second - 1];
+  }
+
+  for (i = plan->end + 1; i-- > plan->head; )
+  {
+    struct LoopValue* const value = plan->values + plan->valuesCount;
+
+    if ((starts[i] == NO_TARGET) || (starts[i] == i) || ! usesLocals[i])
+      continue;
+
+    value->start = starts[i];
+    value->end   = i;
+    value->local = plan->localsCount++;
+    value->first = TRUE;
+
+    ++plan->valuesCount;
+
+    i = starts[i];
+  }
+}
+
+/* Check if the instruction at 'index' multiplies a 64 bits integer induction
+ * variable with a constant, i.e. 'LDLO i; LDI c; MUL'. */
+static bool_t
+induction_use(const struct Optimizer* const   opt,
+              const struct Statement* const   proc,
+              const int32_t* const            depths,
+              const uint8_t* const            writes,
+              const struct LoopPlan* const    plan,
+              const uint32_t                  index,
+              struct Induction* const         outUse)
+{
+  const enum W_OPCODE opcode = wh_compiler_untyped_op(instr_opcode(opt->instrs + index));
+  const struct Instruction* variable;
+  const struct Instruction* factor;
+  struct ConstValue value;
+  uint32_t local;
+  uint_t type;
+
+  if (((opcode != W_MUL) && (opcode != W_MULU))
+      || (index < plan->head + 2)
+      || (depths[index] == NO_DEPTH)
+      || opt->instrs[index - 1].targeted
+      || opt->instrs[index].targeted)
+  {
+    return FALSE;
+  }
+
+  variable = opt->instrs + index - 2;
+  factor   = opt->instrs + index - 1;
+  if ((instr_opcode(variable) < W_LDLO8) || (instr_opcode(variable) > W_LDLO32))
+  {
+    const struct Instruction* const temp = variable;
+
+    variable = factor;
+    factor   = temp;
+  }
+
+  if ((instr_opcode(variable) < W_LDLO8) || (instr_opcode(variable) > W_LDLO32))
+    return FALSE;
+
+  value = instr_const(factor);
+  local = local_index(variable);
+  if ((value.kind != CK_INT)
+      || (value.value >= MAX_FOLD_FACTOR)
+      || (local < opt->paramsCount)
+      || (local >= proc->localsUsed - 1)
+      || (writes[local] != LOCAL_STEPPED))
+  {
+    return FALSE;
+  }
+
+  /* The products keep up with the variable only if the variable does not
+   * wrap around sooner. */
+  type = GET_TYPE(frame_var(proc, local)->type);
+  if ((type != T_INT64) && (type != T_UINT64))
+    return FALSE;
+
+  outUse->variable = local;
+  outUse->opcode   = opcode;
+  outUse->factor   = value.value;
+
+  return TRUE;
+}
+
+static struct Induction*
+find_induction(struct LoopPlan* const plan, const struct Induction* const use)
+{
+  uint32_t i;
+
+  for (i = 0; i < plan->inductionsCount; ++i)
+  {
+    struct Induction* const induction = plan->inductions + i;
+
+    if ((induction->variable == use->variable)
+        && (induction->opcode == use->opcode)
+        && (induction->factor == use->factor))
+    {
+      return induction;
+    }
+  }
+
+  return NULL;
+}
+
+static uint32_t
+steps_count(const struct LoopPlan* const plan, const uint32_t variable)
+{
+  uint32_t result = 0, i;
+
+  for (i = 0; i < plan->stepsCount; ++i)
+    result += (plan->steps[i].variable == variable);
+
+  return result;
+}
+
+/* Replace the products of the induction variables with constants by hidden
+ * locals, incremented along with the variables. Each increment of a local
+ * costs as much as two of the products, so only the products used often
+ * enough are replaced. */
+static void
+plan_inductions(const struct Optimizer* const   opt,
+                const struct Statement* const   proc,
+                const int32_t* const            depths,
+                const uint8_t* const            writes,
+                struct LoopPlan* const          plan)
+{
+  struct Induction use;
+  uint32_t i, j;
+
+  for (i = plan->head; i <= plan->end; ++i)
+  {
+    struct Induction* induction;
+
+    if ( ! induction_use(opt, proc, depths, writes, plan, i, &use))
+      continue;
+
+    induction = find_induction(plan, &use);
+    if ((induction == NULL) && (plan->inductionsCount < MAX_INDUCTIONS))
+    {
+      induction = plan->inductions + plan->inductionsCount++;
+
+      *induction       = use;
+      induction->uses  = 0;
+      induction->local = NO_TARGET;
+    }
+
+    if (induction != NULL)
+      ++induction->uses;
+  }
+
+  for (j = 0; j < plan->inductionsCount; ++j)
+  {
+    struct Induction* const induction = plan->inductions + j;
+
+    if (induction->uses > 2 * steps_count(plan, induction->variable))
+      induction->local = plan->localsCount++;
+  }
+
+  for (i = plan->head; i <= plan->end; ++i)
+  {
+    const struct Induction* induction;
+    struct LoopValue* const value = plan->values + plan->valuesCount;
+
+    if ( ! induction_use(opt, proc, depths, writes, plan, i, &use))
+      continue;
+
+    induction = find_induction(plan, &use);
+    if ((induction == NULL) || (induction->local == NO_TARGET))
+      continue;
+
+    value->start = i - 2;
+    value->end   = i;
+    value->local = induction->local;
+    value->first = TRUE;
+
+    for (j = 0; j < plan->valuesCount; ++j)
+      value->first = value->first && (plan->values[j].local != induction->local);
+
+    ++plan->valuesCount;
+  }
+}
+
+/* Copy an instruction into the rewritten code, moving the temporary values
+ * loaded relatively to the procedure's frame after the added locals. */
+static void
+copy_loop_instr(struct Instruction* const         out,
+                const struct Instruction* const   instr,
+                const uint32_t                    frame,
+                const uint32_t                    added)
+{
+  const enum W_OPCODE opcode = instr_opcode(instr);
+
+  *out = *instr;
+  if ((W_LDLO8 <= opcode) && (opcode <= W_LDLO32) && (local_index(instr) >= frame))
+    set_local(out, local_index(instr) + added);
+
+  out->removed  = FALSE;
+  out->targeted = FALSE;
+}
+
+/* Write the rewritten code of the procedure, or just count its instructions
+ * if there is no output. */
+static uint32_t
+emit_loop(struct Instruction* const         out,
+          uint32_t* const                   indexes,
+          const struct Optimizer* const     opt,
+          const struct LoopPlan* const      plan,
+          const uint32_t* const             replaced,
+          const uint32_t                    frame,
+          uint32_t* const                   outEntry)
+{
+  uint32_t pos = 0, i, j, k;
+
+  for (i = 0; i < opt->count; ++i)
+  {
+    if (i == plan->head)
+    {
+      *outEntry = pos;
+      for (j = 0; j < plan->valuesCount; ++j)
+      {
+        const struct LoopValue* const value = plan->values + j;
+
+        if ( ! value->first)
+          continue;
+
+        if (out != NULL)
+        {
+          set_local(out + pos, frame + value->local);
+          for (k = value->start; k <= value->end; ++k)
+            copy_loop_instr(out + pos + 1 + k - value->start, opt->instrs + k, frame, 0);
+        }
+        pos += value->end - value->start + 2;
+
+        if (out != NULL)
+        {
+          set_instr(out + pos, W_STUD, 0);
+          set_cts(out + pos + 1, 1);
+        }
+        pos += 2;
+      }
+    }
+
+    if (indexes != NULL)
+      indexes[i] = pos;
+
+    if (replaced[i] != NO_TARGET)
+    {
+      const struct LoopValue* const value = plan->values + replaced[i];
+
+      for (k = value->start; (indexes != NULL) && (k <= value->end); ++k)
+        indexes[k] = pos;
+
+      if (out != NULL)
+        set_local(out + pos, frame + value->local);
+
+      ++pos;
+      i = value->end;
+      continue;
+    }
+
+    if (out != NULL)
+      copy_loop_instr(out + pos, opt->instrs + i, frame, plan->localsCount);
+    ++pos;
+
+    for (j = 0; j < plan->stepsCount; ++j)
+    {
+      const struct LoopStep* const step = plan->steps + j;
+
+      if (step->index != i)
+        continue;
+
+      for (k = 0; k < plan->inductionsCount; ++k)
+      {
+        const struct Induction* const induction = plan->inductions + k;
+
+        if ((induction->variable != step->variable) || (induction->local == NO_TARGET))
+          continue;
+
+        if (out != NULL)
+        {
+          const struct ConstValue value = { CK_INT, step->value * induction->factor };
+
+          set_local(out + pos, frame + induction->local);
+          set_const(out + pos + 1, &value);
+          set_instr(out + pos + 2, step->opcode, 0);
+          set_cts(out + pos + 3, 1);
+        }
+        pos += 4;
+      }
+    }
+  }
+
+  if (indexes != NULL)
+    indexes[opt->count] = pos;
+
+  return pos;
+}
+
+/* Add the hidden locals keeping the values computed before the loop. They
+ * hold any type of value, like the UNDEFINED locals. */
+static bool_t
+add_loop_locals(struct Statement* const proc, const uint32_t count)
+{
+  struct DeclaredVar var;
+  uint32_t i;
+
+  memset(&var, 0, sizeof var);
+
+  var.type        = T_UNDETERMINED;
+  var.typeSpecOff = fill_type_spec(&proc->parent->spec.glb.typesDescs, &var);
+  if ((var.typeSpecOff == TYPE_SPEC_ERROR) || (var.typeSpecOff == TYPE_SPEC_INVALID_POS))
+    return FALSE;
+
+  for (i = 0; i < count; ++i)
+  {
+    if ( ! add_hidden_local(proc, &var))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Rewrite the procedure's code according to a loop's plan. */
+static bool_t
+rewrite_loop(struct Optimizer* const        opt,
+             struct Statement* const        proc,
+             const struct LoopPlan* const   plan)
+{
+  const uint32_t frame = proc->localsUsed - 1;
+  uint32_t* const replaced = mem_alloc((opt->count + 1) * sizeof(uint32_t));
+  uint32_t* const indexes  = mem_alloc((opt->count + 1) * sizeof(uint32_t));
+  struct Instruction* instrs = NULL;
+  uint32_t newCount, entry = 0, i;
+  bool_t result = FALSE;
+
+  if ((replaced == NULL) || (indexes == NULL))
+    goto rewrite_end;
+
+  for (i = 0; i < opt->count; ++i)
+    replaced[i] = NO_TARGET;
+
+  for (i = 0; i < plan->valuesCount; ++i)
+    replaced[plan->values[i].start] = i;
+
+  newCount = emit_loop(NULL, NULL, opt, plan, replaced, frame, &entry);
+  instrs   = mem_alloc((newCount + 1) * sizeof(struct Instruction));
+  if (instrs == NULL)
+    goto rewrite_end;
+
+  memset(instrs, 0, (newCount + 1) * sizeof(struct Instruction));
+  emit_loop(instrs, indexes, opt, plan, replaced, frame, &entry);
+
+  if ( ! add_loop_locals(proc, plan->localsCount))
+    goto rewrite_end;
+
+  /* Only the jumps from inside the loop skip the code placed before it. */
+  for (i = 0; i < opt->count; ++i)
+  {
+    const struct Instruction* const instr = opt->instrs + i;
+
+    if ( ! is_jump(instr_opcode(instr)))
+      continue;
+
+    if ((instr->target == plan->head) && ((i < plan->head) || (plan->end < i)))
+      instrs[indexes[i]].target = entry;
+
+    else
+      instrs[indexes[i]].target = indexes[instr->target];
+  }
+
+  mem_free(opt->instrs);
+  opt->instrs = instrs;
+  opt->count  = newCount;
+
+  instrs = NULL;
+  result = TRUE;
+
+rewrite_end:
+  if (instrs != NULL)
+    mem_free(instrs);
+
+  if (indexes != NULL)
+    mem_free(indexes);
+
+  if (replaced != NULL)
+    mem_free(replaced);
+
+  return result;
+}
+
+/* Plan the rewrite of the loop closed by the jump at 'end'. */
+static bool_t
+plan_loop(const struct Optimizer* const   opt,
+          const struct Statement* const   proc,
+          const int32_t* const            depths,
+          const uint32_t                  end,
+          uint8_t* const                  writes,
+          uint32_t* const                 starts,
+          bool_t* const                   usesLocals,
+          struct LoopPlan* const          plan)
+{
+  bool_t aliased;
+
+  plan->end             = end;
+  plan->valuesCount     = 0;
+  plan->stepsCount      = 0;
+  plan->inductionsCount = 0;
+  plan->localsCount     = 0;
+
+  if ( ! loop_head(opt, end, &plan->head)
+      || (depths[plan->head] == NO_DEPTH)
+      || ! loop_writes(opt, proc, depths, plan, writes, &aliased))
+  {
+    return FALSE;
+  }
+
+  plan_invariants(opt, proc, depths, writes, aliased, starts, usesLocals, plan);
+  plan_inductions(opt, proc, depths, writes, plan);
+
+  return plan->valuesCount > 0;
+}
+
+/* Rewrite the outermost loop that has invariant values or products of its
+ * induction variables. Returns FALSE if there is none left. */
+static bool_t
+hoist_loop(struct Optimizer* const opt, struct Statement* const proc)
+{
+  const uint32_t frame = proc->localsUsed - 1;
+  int32_t* const depths = mem_alloc((opt->count + 1) * sizeof(int32_t));
+  uint32_t* const starts = mem_alloc((opt->count + 1) * sizeof(uint32_t));
+  bool_t* const usesLocals = mem_alloc((opt->count + 1) * sizeof(bool_t));
+  uint8_t* const writes = mem_alloc(frame + 1);
+  bool_t* const tried = mem_alloc((opt->count + 1) * sizeof(bool_t));
+  struct LoopPlan plan;
+  bool_t result = FALSE;
+  uint32_t i;
+
+  plan.values = mem_alloc((opt->count + 1) * sizeof(struct LoopValue));
+  plan.steps  = mem_alloc((opt->count + 1) * sizeof(struct LoopStep));
+
+  if ((depths == NULL)
+      || (starts == NULL)
+      || (usesLocals == NULL)
+      || (writes == NULL)
+      || (tried == NULL)
+      || (plan.values == NULL)
+      || (plan.steps == NULL)
+      || ! stack_depths(opt, proc->parent, depths))
+  {
+    goto hoist_end;
+  }
+
+  mark_targets(opt);
+
+  for (i = 0; i < opt->count; ++i)
+    tried[i] = FALSE;
+
+  while (TRUE)
+  {
+    uint32_t end = NO_TARGET, span = 0;
+
+    /* A loop is closed by the last backward jump to its start. */
+    for (i = 0; i < opt->count; ++i)
+    {
+      const struct Instruction* const instr = opt->instrs + i;
+      uint32_t j;
+
+      if (tried[i]
+          || ! is_jump(instr_opcode(instr))
+          || (instr->target > i)
+          || (depths[i] == NO_DEPTH))
+      {
+        continue;
+      }
+
+      for (j = i + 1; j < opt->count; ++j)
+      {
+        if (is_jump(instr_opcode(opt->instrs + j))
+            && (opt->instrs[j].target == instr->target))
+        {
+          break;
+        }
+      }
+
+      if ((j == opt->count) && ((end == NO_TARGET) || (i - instr->target > span)))
+      {
+        end  = i;
+        span = i - instr->target;
+      }
+    }
+
+    if (end == NO_TARGET)
+      break;
+
+    tried[end] = TRUE;
+    if (plan_loop(opt, proc, depths, end, writes, starts, usesLocals, &plan))
+    {
+      result = rewrite_loop(opt, proc, &plan);
+      break;
+    }
+  }
+
+hoist_end:
+  if (plan.steps != NULL)
+    mem_free(plan.steps);
+
+  if (plan.values != NULL)
+    mem_free(plan.values);
+
+  if (tried != NULL)
+    mem_free(tried);
+
+  if (writes != NULL)
+    mem_free(writes);
+
+  if (usesLocals != NULL)
+    mem_free(usesLocals);
+
+  if (starts != NULL)
+    mem_free(starts);
+
+  if (depths != NULL)
+    mem_free(depths);
+
+  return result;
+}
+
+/* Replace the procedure's code with the one left by the optimizer. */
+static bool_t
+replace_code(struct Optimizer* const opt, struct WOutputStream* const stream)
+{
+  struct WOutputStream optimized;
+
+  wh_ostream_init(stream->increment, &optimized);
+  if ( ! encode_code(opt, &optimized))
+  {
+    wh_ostream_clean(&optimized);
+    return FALSE;
+  }
+
+  wh_ostream_clean(stream);
+  *stream = optimized;
+
+  return TRUE;
+}
+
+bool_t
+inline_proc_calls(struct Statement* const proc)
+{
+  struct WOutputStream* const stream = stmt_query_instrs(proc);
+  struct Optimizer opt;
+  bool_t result = FALSE;
+
+  assert(proc->type == STMT_PROC);
+
+  opt.instrs      = NULL;
+  opt.count       = 0;
+  opt.paramsCount = stmt_get_param_count(proc);
+
+  if ( ! decode_code(&opt, wh_ostream_data(stream), wh_ostream_size(stream)))
+    return FALSE;
+
+  if (inline_calls(&opt, proc))
+    result = replace_code(&opt, stream);
+
+  mem_free(opt.instrs);
+
+  return result;
+}
+
+bool_t
+optimize_proc_code(struct Statement* const proc)
+{
+  struct WOutputStream* const stream = stmt_query_instrs(proc);
+  struct Optimizer opt;
+  bool_t result;
+
+  assert(proc->type == STMT_PROC);
+
+  opt.instrs      = NULL;
+  opt.count       = 0;
+  opt.paramsCount = stmt_get_param_count(proc);
+
+  if ( ! decode_code(&opt, wh_ostream_data(stream), wh_ostream_size(stream)))
+    return FALSE;
+
+  while (run_passes(&opt))
+    ;
+
+  result = replace_code(&opt, stream);
+
+  mem_free(opt.instrs);
+
+  return result;
+}
+
+bool_t
+hoist_loop_invariants(struct Statement* const proc)
+{
+  struct WOutputStream* const stream = stmt_query_instrs(proc);
+  struct Optimizer opt;
+  bool_t result = FALSE;
+  uint_t round;
+
+  assert(proc->type == STMT_PROC);
+
+  opt.instrs      = NULL;
+  opt.count       = 0;
+  opt.paramsCount = stmt_get_param_count(proc);
+
+  if ( ! decode_code(&opt, wh_ostream_data(stream), wh_ostream_size(stream)))
+    return FALSE;
+
+  for (round = 0; (round < MAX_HOISTED_LOOPS) && hoist_loop(&opt, proc); ++round)
+    result = TRUE;
+
+  if (result)
+    result = replace_code(&opt, stream);
+
+  mem_free(opt.instrs);
+
+  return result;
+}
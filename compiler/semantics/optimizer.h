@@ -0,0 +1,57 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "whais.h"
+
+#include "statement.h"
+
+
+/* Rewrite the compiled code of a procedure to a smaller equivalent one:
+ * constant folding, constant conditional jumps, jump threading, removal of
+ * the unreachable code and of the stores to the never read locals, plus
+ * some peephole rewrites. The code is left untouched if it cannot be
+ * handled (or there is not enough memory) and FALSE is returned. */
+bool_t
+optimize_proc_code(struct Statement* const proc);
+
+/* Replace the procedure's calls to the small procedures already compiled
+ * with the code of the called procedures, with their locals moved into the
+ * caller's frame. The procedures marked with the '#@noinline' pragma are
+ * never inlined, while the ones marked with '#@inline' get a bigger budget.
+ * Returns TRUE if some calls were inlined. */
+bool_t
+inline_proc_calls(struct Statement* const proc);
+
+/* Move the computations of the values that do not change inside the
+ * procedure's loops before the loops, and keep the products of the loops'
+ * induction variables with constants into locals updated along with the
+ * variables. Returns TRUE if some loops were rewritten. */
+bool_t
+hoist_loop_invariants(struct Statement* const proc);
+
+
+#endif /* OPTIMIZER_H */
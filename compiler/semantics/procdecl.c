@@ -26,10 +26,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string.h>
 
 #include "procdecl.h"
+#include "expression.h"
+#include "opcodes.h"
+#include "optimizer.h"
 #include "wlog.h"
 #include "vardecl.h"
 
 
+extern int yyparse(struct ParserState*);
+
+
 struct Statement*
 find_proc_decl(struct ParserState  *parser,
                 const char         *name,
@@ -101,6 +107,20 @@ install_proc_args(struct ParserState* const   parser,
 
   uint_t paramsCount, paramIndex;
 
+  if (parser->specialized != NULL)
+  {
+    /* The parameters are already declared, with their specialized types. */
+    while (paramsList != NULL)
+    {
+      assert(paramsList->val_type == VAL_PRCDCL_LIST);
+
+      paramsList->val_type = VAL_REUSE;
+      paramsList           = paramsList->val.u_prdcl.next;
+    }
+
+    return;
+  }
+
   if ( ! cStmt->spec.proc.checkParams)
   {
     struct SemValue identifier, type;
@@ -188,6 +208,15 @@ install_proc_decl(struct ParserState* const   parser,
   assert(parser->pCurrentStmt->type == STMT_GLOBAL);
   assert(id->val_type == VAL_ID);
 
+  if (parser->specialized != NULL)
+  {
+    parser->specialized->spec.proc.definitionPos = parser->bufferPos;
+    parser->pCurrentStmt = parser->specialized;
+
+    free_sem_value(id);
+    return;
+  }
+
   if (init_proc_stmt( parser->pCurrentStmt, &stmt) == FALSE)
     log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
 
@@ -287,7 +316,12 @@ install_proc_decl(struct ParserState* const   parser,
       parser->abortError = TRUE;
     }
     else
+    {
+      if ( ! parser->externDecl)
+        found->spec.proc.sourceStart = parser->procPos;
+
       parser->pCurrentStmt = found;
+    }
   }
 
   free_sem_value(id);
@@ -375,6 +409,20 @@ finish_proc_decl(struct ParserState* const parser)
 
   struct Statement* stmt = parser->pCurrentStmt;
   struct WArray* iteratorsOffset = stmt_query_usage_iterators_stack(stmt);
+
+  stmt->spec.proc.inlinePragma = parser->inlinePragma;
+  parser->inlinePragma = INLINE_DEFAULT;
+
+  /* The iterators are kept on the stack after the locals, whose count
+   * changes with the inlined calls and the hoisted loop invariants. */
+  if (parser->optimize
+      && ! parser->externDecl
+      && (wh_array_count(iteratorsOffset) == 0))
+  {
+    inline_proc_calls(stmt);
+    hoist_loop_invariants(stmt);
+  }
+
   uint8_t* const code = wh_ostream_data(&stmt->spec.proc.code);
   const uint32_t itOffset = stmt->localsUsed - 1;
 
@@ -389,6 +437,299 @@ finish_proc_decl(struct ParserState* const parser)
 
   wh_array_clean(iteratorsOffset);
 
+  if (parser->optimize && ! parser->externDecl)
+    optimize_proc_code(stmt);
+
+  if ( ! parser->externDecl && (parser->specialized == NULL))
+    stmt->spec.proc.sourceEnd = parser->endProcPos;
+
   parser->pCurrentStmt = &parser->globalStmt;
   return;
 }
+
+
+static bool_t
+is_generic_type(const uint_t type)
+{
+  return (type == T_UNDETERMINED) || (type == (T_ARRAY_MASK | T_UNDETERMINED));
+}
+
+/* Get the type a generic parameter gets from the argument passed, or its
+ * own type if the argument's type is not known at compile time. */
+static uint_t
+specialized_type(const uint_t paramType, const uint_t argType)
+{
+  const uint_t baseType = GET_BASE_TYPE(argType);
+
+  if (IS_FIELD(argType)
+      || IS_TABLE(argType)
+      || (IS_ARRAY(paramType) != IS_ARRAY(argType))
+      || (baseType == T_UNKNOWN)
+      || (baseType >= T_UNDETERMINED))
+  {
+    return paramType;
+  }
+
+  return GET_TYPE(argType);
+}
+
+/* Declare the parameters of a specialization of a generic procedure, with
+ * the types given. */
+static bool_t
+init_specialized_proc(struct ParserState* const       parser,
+                      const struct Statement* const   generic,
+                      const uint16_t* const           types,
+                      struct Statement* const         outStmt)
+{
+  const uint_t paramsCount = stmt_get_param_count(generic);
+  uint_t i;
+
+  if ( ! init_proc_stmt(&parser->globalStmt, outStmt))
+    return FALSE;
+
+  memcpy(wh_array_get(&outStmt->spec.proc.paramsList, 0),
+         stmt_get_param(generic, 0),
+         sizeof(struct DeclaredVar));
+  outStmt->spec.proc.checkParams = TRUE;
+
+  for (i = 0; i < paramsCount; ++i)
+  {
+    struct DeclaredVar param = *stmt_get_param(generic, i + 1);
+
+    param.type  = types[i];
+    param.extra = NULL;
+
+    if (stmt_add_declaration(outStmt, &param, TRUE) == NULL)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+
+const struct Statement*
+specialize_proc_call(struct ParserState* const       parser,
+                     const struct Statement* const   proc,
+                     const uint16_t* const           argsTypes,
+                     const uint_t                    argsCount)
+{
+  const uint_t                    paramsCount = stmt_get_param_count(proc);
+  const struct DeclaredVar* const retVar      = stmt_get_param(proc, 0);
+
+  uint16_t          types[MAX_SPECIALIZED_PARAMS];
+  char              name[512];
+  uint_t            nameLength = proc->spec.proc.nameLength;
+  bool_t            specialize = FALSE;
+  struct Statement  stmt;
+  struct Statement *result;
+  uint_t            i;
+
+  if ((paramsCount > MAX_SPECIALIZED_PARAMS)
+      || (nameLength + paramsCount * MAX_MANGLED_TYPE_LENGTH > sizeof name)
+      || IS_TABLE(retVar->type)
+      || IS_FIELD(retVar->type))
+  {
+    return proc;
+  }
+
+  for (i = 0; i < paramsCount; ++i)
+  {
+    const struct DeclaredVar* const param = stmt_get_param(proc, i + 1);
+
+    if (IS_TABLE(param->type) || IS_FIELD(param->type))
+      return proc;
+
+    types[i] = param->type;
+    if (is_generic_type(param->type) && (i < argsCount))
+    {
+      types[i] = specialized_type(param->type, argsTypes[i]);
+      specialize |= (types[i] != param->type);
+    }
+  }
+
+  if ( ! specialize)
+    return proc;
+
+  /* Name it after the types its generic parameters got, like
+   * 'get_min@INT32_ARRAY@UNDEFINED'. */
+  memcpy(name, proc->spec.proc.name, nameLength);
+  for (i = 0; i < paramsCount; ++i)
+  {
+    const char* typeName;
+
+    if ( ! is_generic_type(stmt_get_param(proc, i + 1)->type))
+      continue;
+
+    typeName = type_to_text(GET_BASE_TYPE(types[i]));
+
+    name[nameLength++] = '@';
+    memcpy(name + nameLength, typeName, strlen(typeName));
+    nameLength += strlen(typeName);
+
+    if (IS_ARRAY(types[i]))
+    {
+      memcpy(name + nameLength, "_ARRAY", sizeof "_ARRAY" - 1);
+      nameLength += sizeof "_ARRAY" - 1;
+    }
+  }
+
+  result = find_proc_decl(parser, name, nameLength, TRUE);
+  if (result != NULL)
+    return result;
+
+  if ( ! init_specialized_proc(parser, proc, types, &stmt))
+  {
+    log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
+    return NULL;
+  }
+
+  stmt.spec.proc.name = alloc_str(parser->strings, nameLength);
+  if (stmt.spec.proc.name == NULL)
+  {
+    log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
+    return NULL;
+  }
+  memcpy((char*)stmt.spec.proc.name, name, nameLength);
+
+  stmt.spec.proc.nameLength        = nameLength;
+  stmt.spec.proc.declarationPos    = proc->spec.proc.declarationPos;
+  stmt.spec.proc.definitionPos     = proc->spec.proc.definitionPos;
+  stmt.spec.proc.specializePending = TRUE;
+  stmt.spec.proc.procId            = parser->globalStmt.spec.glb.procsCount++;
+
+  /* Its code, if any, is added once the whole unit is parsed. */
+  MARK_AS_EXTERNAL(stmt.spec.proc.procId);
+  MARK_AS_REFERENCED(stmt.spec.proc.procId);
+
+  result = wh_array_add(&parser->globalStmt.spec.glb.procsDecls, &stmt);
+  if (result == NULL)
+  {
+    clear_proc_stmt(&stmt);
+    log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
+  }
+
+  return result;
+}
+
+/* Let the specialization of a generic procedure, whose code does not compile
+ * with the parameters' types, just pass its arguments to that procedure. */
+static bool_t
+forward_to_generic(struct ParserState* const       parser,
+                   struct Statement* const         proc,
+                   const struct Statement* const   generic)
+{
+  const uint_t paramsCount = stmt_get_param_count(proc);
+
+  uint16_t               types[MAX_SPECIALIZED_PARAMS];
+  struct Statement       stmt;
+  struct WOutputStream  *instrs;
+  uint_t                 i;
+
+  assert(paramsCount <= MAX_SPECIALIZED_PARAMS);
+
+  for (i = 0; i < paramsCount; ++i)
+    types[i] = stmt_get_param(proc, i + 1)->type;
+
+  if ( ! init_specialized_proc(parser, generic, types, &stmt))
+    return FALSE;
+
+  stmt.spec.proc.name           = proc->spec.proc.name;
+  stmt.spec.proc.nameLength     = proc->spec.proc.nameLength;
+  stmt.spec.proc.declarationPos = proc->spec.proc.declarationPos;
+  stmt.spec.proc.definitionPos  = proc->spec.proc.definitionPos;
+  stmt.spec.proc.procId         = proc->spec.proc.procId;
+  stmt.spec.proc.returnDetected = TRUE;
+
+  clear_proc_stmt(proc);
+  memcpy(proc, &stmt, sizeof stmt);
+
+  instrs = stmt_query_instrs(proc);
+  for (i = 0; i < paramsCount; ++i)
+  {
+    /* Locals are counted without the return value. */
+    if (encode_opcode(instrs, W_LDLO8) == NULL
+        || wh_ostream_wint8(instrs, i) == NULL)
+    {
+      return FALSE;
+    }
+  }
+
+  return encode_opcode(instrs, W_CALL) != NULL
+         && wh_ostream_wint32(instrs, stmt_get_import_id(generic)) != NULL
+         && encode_opcode(instrs, W_RET) != NULL;
+}
+
+/* Compile the code of a specialization from the source of its generic
+ * procedure, with the parameters' types known. */
+static bool_t
+compile_specialized_proc(struct ParserState* const       parser,
+                         struct Statement* const         proc,
+                         const struct Statement* const   generic)
+{
+  const WH_MESSENGER      messenger     = parser->messenger;
+  const WH_MESSENGER_CTXT messengerCtxt = parser->messengerCtxt;
+  const uint_t            bufferPos     = parser->bufferPos;
+  const uint_t            bufferSize    = parser->bufferSize;
+
+  bool_t compiled;
+
+  /* The messages were already reported for the generic procedure, while a
+   * specialization failing to compile just falls back to it. */
+  parser->messenger     = NULL;
+  parser->messengerCtxt = NULL;
+  parser->bufferPos     = generic->spec.proc.sourceStart;
+  parser->bufferSize    = generic->spec.proc.sourceEnd;
+  parser->specialized   = proc;
+  parser->generic       = generic;
+
+  compiled = (yyparse(parser) == 0) && ! parser->abortError;
+
+  parser->messenger     = messenger;
+  parser->messengerCtxt = messengerCtxt;
+  parser->bufferPos     = bufferPos;
+  parser->bufferSize    = bufferSize;
+  parser->specialized   = NULL;
+  parser->generic       = NULL;
+  parser->pCurrentStmt  = &parser->globalStmt;
+  parser->abortError    = FALSE;
+
+  return compiled || forward_to_generic(parser, proc, generic);
+}
+
+
+bool_t
+compile_specialized_procs(struct ParserState* const parser)
+{
+  const struct WArray* const procs = &parser->globalStmt.spec.glb.procsDecls;
+  uint_t i;
+
+  /* Compiling the specializations may request new ones. */
+  for (i = 0; i < wh_array_count(procs); ++i)
+  {
+    struct Statement* const proc = wh_array_get(procs, i);
+    const struct Statement* generic;
+    uint_t nameLength = 0;
+
+    if ( ! proc->spec.proc.specializePending)
+      continue;
+
+    proc->spec.proc.specializePending = FALSE;
+
+    while (proc->spec.proc.name[nameLength] != '@')
+      ++nameLength;
+
+    /* The generic procedures defined by other units get their own
+     * specializations, or are used instead when the units are linked. */
+    generic = find_proc_decl(parser, proc->spec.proc.name, nameLength, FALSE);
+    if ((generic == NULL) || (generic->spec.proc.sourceEnd == 0))
+      continue;
+
+    if ( ! compile_specialized_proc(parser, proc, generic))
+    {
+      log_message(parser, IGNORE_BUFFER_POS, MSG_NO_MEM);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
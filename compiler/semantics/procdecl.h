@@ -60,6 +60,28 @@ set_proc_rettype(struct ParserState* const   parser,
 void
 finish_proc_decl(struct ParserState* const parser);
 
+/* The most parameters of the procedures specialized for their arguments. */
+#define MAX_SPECIALIZED_PARAMS      16
+#define MAX_MANGLED_TYPE_LENGTH     (sizeof "@HIRESTIME_ARRAY" - 1)
+
+/* Get the procedure to call instead of a generic one, specialized for the
+ * types of the arguments passed to its UNDEFINED (or ARRAY) parameters. It is
+ * declared as external until compile_specialized_procs() is called. Returns
+ * the procedure itself if there is nothing to specialize. */
+const struct Statement*
+specialize_proc_call(struct ParserState* const       parser,
+                     const struct Statement* const   proc,
+                     const uint16_t* const           argsTypes,
+                     const uint_t                    argsCount);
+
+/* Once the unit is parsed, compile the code of the specializations of the
+ * generic procedures it defines, from their source with the specialized
+ * parameters' types. The specializations whose code cannot be compiled just
+ * call their generic procedures, while the ones of the procedures defined by
+ * other units are left as external. */
+bool_t
+compile_specialized_procs(struct ParserState* const parser);
+
 #endif /* PROCDECL_H */
 
 
@@ -53,6 +53,15 @@ struct _GlobalStatmentSpec
   uint32_t               procsCount;
 };
 
+/* Compiler hints for the inlining of a procedure's calls, given by the
+ * '#@inline' and '#@noinline' commentaries that precede its declaration. */
+enum INLINE_PRAGMA
+{
+  INLINE_DEFAULT = 0,
+  INLINE_ALWAYS,
+  INLINE_NEVER
+};
+
 struct _ProcStatementSpec
 {
   const char            *name;         /* Procedure name. */
@@ -68,11 +77,16 @@ struct _ProcStatementSpec
   struct WArray          iteratorsUsage; /* Keeps track of loop iterators */
   uint32_t               procId;         /* Procedure's ID in the import table. */
   uint16_t               syncTracker;    /* Keeps track of sync statements. */
+  enum INLINE_PRAGMA     inlinePragma;
   uint_t                 declarationPos;
   uint_t                 definitionPos;
+  uint_t                 sourceStart;    /* Where the procedure's definition starts. */
+  uint_t                 sourceEnd;      /* Where the procedure's definition ends. */
   bool_t                 checkParams;
   bool_t                 returnDetected;
   bool_t                 deadCodeWarned;
+  bool_t                 specializePending; /* Its code is to be compiled from its
+                                               generic procedure's source. */
 };
 
 struct Statement
@@ -213,3 +213,19 @@ UNIT_EXES+=test_msg_create_array
 test_msg_create_array_SRC=test/test_msg_create_array.c 
 test_msg_create_array_LIB=compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
 
+
+UNIT_EXES+=test_optimizer
+test_optimizer_SRC=test/test_optimizer.c 
+test_optimizer_LIB=compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_compact_code
+test_compact_code_SRC=test/test_compact_code.cpp
+test_compact_code_LIB=compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_stripped_units
+test_stripped_units_SRC=test/test_stripped_units.cpp
+test_stripped_units_LIB=compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
+
+UNIT_EXES+=test_object_file
+test_object_file_SRC=test/test_object_file.cpp
+test_object_file_LIB=compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
@@ -0,0 +1,239 @@
+/*
+ * test_compact_code.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+#include "compiler/compactcode.h"
+#include "compiler/compiledunit.h"
+#include "compiler/wopcodes.h"
+#include "custom/include/test/test_fmw.h"
+
+using namespace std;
+using namespace whais;
+
+static const uint8_t testProgram[] = ""
+    "VAR counter INT32;\n"
+    "VAR people TABLE (name TEXT, age UINT8);\n"
+    "\n"
+    "PROCEDURE greet(who TEXT) RETURN TEXT\n"
+    "DO\n"
+    "  IF (who == \"age\")\n"
+    "    RETURN \"name\";\n"
+    "  RETURN \"Hello \" + who;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE loops(n INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR s INT64;\n"
+    "  VAR r REAL;\n"
+    "  VAR d DATE;\n"
+    "  s = 0;\n"
+    "  r = 3.25;\n"
+    "  d = '2020/1/2';\n"
+    "  WHILE (n > 0) DO\n"
+    "    IF (n > 100) DO\n"
+    "      s += n * 1000000000000;\n"
+    "    ELSE DO\n"
+    "      s += n - 1;\n"
+    "    END\n"
+    "    n -= 1;\n"
+    "    counter += 1;\n"
+    "  END\n"
+    "  SYNC\n"
+    "    counter = 0;\n"
+    "  ENDSYNC\n"
+    "  RETURN s + loops(n);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE older(t TABLE (name TEXT, age UINT8), limit UINT8) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT64;\n"
+    "  VAR c UINT64;\n"
+    "  c = 0;\n"
+    "  FOR (i = 0; i < 10; i += 1)\n"
+    "    IF (t.age[i] > limit)\n"
+    "      c += 1;\n"
+    "    ELSE IF (t.name[i] == \"age\")\n"
+    "      c += 2;\n"
+    "  RETURN c;\n"
+    "ENDPROC\n";
+
+
+static void
+my_postman(WH_MESSENGER_CTXT data,
+           uint_t            buff_pos,
+           uint_t            msg_id,
+           uint_t            msgType,
+           const char*       pMsgFormat,
+           va_list           args)
+{
+  fprintf(stderr, "%u : ", msg_id);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+}
+
+
+//Compact the code of every procedure and expand it back.
+static bool
+test_round_trip(WIFunctionalUnit& unit, uint_t& outCodeSize, uint_t& outCompactSize)
+{
+  for (uint_t p = 0; p < unit.ProceduresCount(); ++p)
+  {
+    const uint8_t* const code = unit.RetriveProcCodeArea(p);
+    const uint_t codeSize = unit.ProcCodeAreaSize(p);
+
+    vector<uint8_t> compact;
+    compact_proc_code(code, codeSize, compact);
+
+    vector<uint8_t> expanded(codeSize);
+    expand_proc_code(compact.data(), compact.size(), expanded.data(), codeSize);
+
+    if (memcmp(expanded.data(), code, codeSize) != 0)
+    {
+      cout << "(" << unit.RetriveProcName(p) << ") ";
+      return false;
+    }
+
+    outCodeSize += codeSize;
+    outCompactSize += compact.size();
+  }
+
+  return true;
+}
+
+
+//Every truncated compact code has to be rejected.
+static bool
+test_truncated(WIFunctionalUnit& unit)
+{
+  for (uint_t p = 0; p < unit.ProceduresCount(); ++p)
+  {
+    const uint_t codeSize = unit.ProcCodeAreaSize(p);
+
+    vector<uint8_t> compact;
+    compact_proc_code(unit.RetriveProcCodeArea(p), codeSize, compact);
+
+    vector<uint8_t> expanded(codeSize);
+    for (uint_t size = 0; size < compact.size(); ++size)
+    {
+      try
+      {
+        expand_proc_code(compact.data(), size, expanded.data(), codeSize);
+        return false;
+      }
+      catch (FunctionalUnitException&)
+      {
+      }
+    }
+  }
+
+  return true;
+}
+
+
+static bool
+test_varints()
+{
+  const uint64_t values[] = { 0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0xFFFFFFFF, ~0ull };
+
+  for (const auto value : values)
+  {
+    vector<uint8_t> data;
+    uint64_t loaded;
+
+    store_varint(value, data);
+    if ((load_varint(data.data(), data.size(), loaded) != data.size()) || (loaded != value))
+      return false;
+
+    try
+    {
+      load_varint(data.data(), data.size() - 1, loaded);
+      return false;
+    }
+    catch (FunctionalUnitException&)
+    {
+    }
+  }
+
+  return true;
+}
+
+
+int
+main()
+{
+  bool success = true;
+
+  {
+    CompiledBufferUnit plainUnit(testProgram, sizeof testProgram, my_postman, nullptr);
+    CompiledBufferUnit optUnit(testProgram,
+                               sizeof testProgram,
+                               my_postman,
+                               nullptr,
+                               WHC_OPTIMIZE_CODE);
+
+    cout << "Testing varints ... ";
+    if (test_varints())
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+
+    uint_t codeSize = 0, compactSize = 0;
+
+    cout << "Testing compact code round trip ... ";
+    if (test_round_trip(plainUnit, codeSize, compactSize)
+        && test_round_trip(optUnit, codeSize, compactSize)
+        && (compactSize < codeSize))
+    {
+      cout << "PASSED (" << codeSize << " bytes compacted to " << compactSize << ")" << endl;
+    }
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+
+    cout << "Testing truncated compact code ... ";
+    if (test_truncated(plainUnit) && test_truncated(optUnit))
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+  }
+
+  cout << "Current memory usage: " << test_get_mem_used() << " bytes...";
+  if (test_get_mem_used() != 0)
+  {
+    cout << "FAILED" << endl;
+    success = false;
+  }
+  else
+    cout << "PASSED" << endl;
+
+  if (!success)
+  {
+    cout << "TEST RESULT: FAIL" << endl;
+    return 1;
+  }
+
+  cout << "TEST RESULT: PASS" << endl;
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,260 @@
+/*
+ * test_object_file.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "compiler/compiledunit.h"
+#include "compiler/whc/wo_format.h"
+#include "utils/endianness.h"
+#include "custom/include/test/test_fmw.h"
+
+using namespace std;
+using namespace whais;
+
+static const char objectFile[] = "t_object_file.wo";
+static const char imageFile[] = "t_object_file.wli";
+
+static const char* const globalsNames[] = { "alpha", "beta", "gamma", "delta", "epsilon" };
+static const char procName[] = "proc";
+
+
+static void
+append_le_int32(const uint32_t value, vector<uint8_t>& out)
+{
+  uint8_t buffer[sizeof(uint32_t)];
+
+  store_le_int32(value, buffer);
+  out.insert(out.end(), buffer, buffer + sizeof buffer);
+}
+
+
+//Write an object with a few globals, followed in the file by the table of
+//a procedure, as whc lays them out.
+static bool
+write_object(const uint_t format)
+{
+  const uint_t globalsCount = sizeof globalsNames / sizeof globalsNames[0];
+  const uint_t procEntrySize = (format == WH_FFVER_MAJ_FIXED)
+                               ? WHC_PROC_ENTRY_SIZE
+                               : WHC_PROC_ENTRY_V2_SIZE;
+
+  vector<uint8_t> object(WHC_TABLE_SIZE, 0);
+  vector<uint32_t> namesOffsets;
+  vector<uint8_t> symbols;
+
+  for (const auto name : globalsNames)
+  {
+    namesOffsets.push_back(symbols.size());
+    symbols.insert(symbols.end(), name, name + strlen(name) + 1);
+  }
+
+  const uint32_t procNameOffset = symbols.size();
+  symbols.insert(symbols.end(), procName, procName + sizeof procName);
+
+  object[WHC_SIGNATURE_OFF]     = WH_SIGNATURE[0];
+  object[WHC_SIGNATURE_OFF + 1] = WH_SIGNATURE[1];
+  object[WHC_FORMATMMAJ_OFF]    = format;
+  object[WHC_FORMATMIN_OFF]     = WH_FFVER_MIN;
+
+  store_le_int32(globalsCount, &object[WHC_GLOBS_COUNT_OFF]);
+  store_le_int32(1, &object[WHC_PROCS_COUNT_OFF]);
+
+  //A byte of the type area for each global, to tell them apart.
+  store_le_int32(object.size(), &object[WHC_TYPEINFO_START_OFF]);
+  store_le_int32(globalsCount, &object[WHC_TYPEINFO_SIZE_OFF]);
+  object.insert(object.end(), globalsCount, 0);
+
+  store_le_int32(object.size(), &object[WHC_SYMTABLE_START_OFF]);
+  store_le_int32(symbols.size(), &object[WHC_SYMTABLE_SIZE_OFF]);
+  store_le_int32(object.size(), &object[WHC_CONSTAREA_START_OFF]);
+  store_le_int32(0, &object[WHC_CONSTAREA_SIZE_OFF]);
+  object.insert(object.end(), symbols.begin(), symbols.end());
+
+  for (uint_t g = 0; g < globalsCount; ++g)
+  {
+    append_le_int32(((g % 2) ? EXTERN_MASK : 0) | g, object);
+    append_le_int32(namesOffsets[g], object);
+  }
+
+  //An external procedure has a body with only its locals' types, the
+  //return one being kept in its entry.
+  vector<uint8_t> procEntry(procEntrySize, 0);
+  store_le_int32(procNameOffset, &procEntry[WHC_PROC_ENTRY_NAME_OFF]);
+  store_le_int32(WHC_TABLE_SIZE, &procEntry[WHC_PROC_ENTRY_BODY_OFF]);
+  store_le_int32(EXTERN_MASK, &procEntry[WHC_PROC_ENTRY_TYPE_OFF]);
+  store_le_int16(1, &procEntry[WHC_PROC_ENTRY_NLOCAL_OFF]);
+  object.insert(object.end(), procEntry.begin(), procEntry.end());
+
+  FILE* const file = fopen(objectFile, "wb");
+  if (file == nullptr)
+    return false;
+
+  const bool result = (fwrite(object.data(), 1, object.size(), file) == object.size());
+
+  return (fclose(file) == 0) && result;
+}
+
+
+static bool
+check_tables(WIFunctionalUnit& unit)
+{
+  const uint_t globalsCount = sizeof globalsNames / sizeof globalsNames[0];
+
+  bool result = (unit.GlobalsCount() == globalsCount) && (unit.ProceduresCount() == 1);
+  for (uint_t g = 0; result && (g < globalsCount); ++g)
+  {
+    const string name(unit.RetriveGlobalName(g), unit.GlobalNameLength(g));
+
+    result = (name == globalsNames[g])
+             && (unit.GlobalTypeOff(g) == g)
+             && ((unit.IsGlobalExternal(g) != FALSE) == ((g % 2) != 0));
+  }
+
+  return result
+         && (string(unit.RetriveProcName(0), unit.GetProcNameSize(0)) == procName)
+         && unit.IsProcExternal(0)
+         && (unit.ProcLocalsCount(0) == 1)
+         && (unit.ProcParametersCount(0) == 0)
+         && (unit.GetProcReturnTypeOff(0) == 0);
+}
+
+
+static bool
+test_globals_table(const uint_t format)
+{
+  if ( ! write_object(format))
+    return false;
+
+  bool result = true;
+
+  {
+    CompiledFileUnit unit(objectFile);
+
+    result = check_tables(unit);
+  }
+
+  remove(objectFile);
+
+  return result;
+}
+
+
+static bool
+test_linked_image(const uint_t format)
+{
+  bool result = write_object(format);
+
+  remove(imageFile);
+
+  {
+    CompiledImageUnit unit(objectFile, imageFile);
+
+    result = result && ! unit.IsMapped() && ! unit.IsCodeVerified() && check_tables(unit);
+    if (result)
+      unit.SaveImage(imageFile);
+  }
+
+  //A second run maps what the first one saved.
+  {
+    CompiledImageUnit unit(objectFile, imageFile);
+
+    result = result && unit.IsMapped() && unit.IsCodeVerified() && check_tables(unit);
+  }
+
+  //The image of another content of the object is not used.
+  const uint_t otherFormat = (format == WH_FFVER_MAJ) ? WH_FFVER_MAJ_FIXED : WH_FFVER_MAJ;
+  result = result && write_object(otherFormat);
+  {
+    CompiledImageUnit unit(objectFile, imageFile);
+
+    result = result && ! unit.IsMapped() && check_tables(unit);
+  }
+
+  //Neither is a damaged one.
+  result = result && write_object(format);
+
+  FILE* const image = fopen(imageFile, "r+b");
+  if (image != nullptr)
+  {
+    fseek(image, -1, SEEK_END);
+    const int last = fgetc(image);
+    fseek(image, -1, SEEK_END);
+    fputc(last ^ 0xFF, image);
+    fclose(image);
+  }
+  else
+    result = false;
+
+  {
+    CompiledImageUnit unit(objectFile, imageFile);
+
+    result = result && ! unit.IsMapped() && check_tables(unit);
+  }
+
+  remove(imageFile);
+  remove(objectFile);
+
+  return result;
+}
+
+
+int
+main()
+{
+  bool success = true;
+
+  const uint_t formats[] = { WH_FFVER_MAJ_FIXED, WH_FFVER_MAJ };
+
+  for (const auto format : formats)
+  {
+    cout << "Testing the globals table of a version " << format << " object ... ";
+    if (test_globals_table(format))
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+
+    cout << "Testing the linked image of a version " << format << " object ... ";
+    if (test_linked_image(format))
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+  }
+
+  cout << "Current memory usage: " << test_get_mem_used() << " bytes...";
+  if (test_get_mem_used() != 0)
+  {
+    cout << "FAILED" << endl;
+    success = false;
+  }
+  else
+    cout << "PASSED" << endl;
+
+  if (!success)
+  {
+    cout << "TEST RESULT: FAIL" << endl;
+    return 1;
+  }
+
+  cout << "TEST RESULT: PASS" << endl;
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
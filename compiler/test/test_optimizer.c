@@ -0,0 +1,580 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../parser/parser.h"
+#include "../semantics/vardecl.h"
+#include "../semantics/opcodes.h"
+#include "../semantics/procdecl.h"
+
+#include "custom/include/test/test_fmw.h"
+
+extern int yyparse(struct ParserState *);
+
+static void
+init_state_for_test(struct ParserState *state, const char * buffer)
+{
+  state->buffer = buffer;
+  state->strings = create_string_store();
+  state->bufferSize = strlen(buffer);
+  wh_array_init(&state->values, sizeof(struct SemValue));
+
+  init_glbl_stmt(&state->globalStmt);
+  state->pCurrentStmt = &state->globalStmt;
+}
+
+static void
+free_state(struct ParserState *state)
+{
+  release_string_store(state->strings);
+  clear_glbl_stmt(&(state->globalStmt));
+  wh_array_clean(&state->values);
+
+}
+
+static bool_t
+check_used_vals(struct ParserState *state)
+{
+  int vals_count = wh_array_count(&state->values);
+  while (--vals_count >= 0)
+    {
+      struct SemValue *val = wh_array_get(&state->values, vals_count);
+      if (val->val_type != VAL_REUSE)
+        {
+          return TRUE;                /* found value still in use */
+        }
+
+    }
+
+  return FALSE;                        /* no value in use */
+}
+
+char proc_decl_buffer[] =
+    "      PROCEDURE consts() RETURN INT64 "
+    "      DO "
+    "           RETURN 2 + 3 * 4; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE negative() RETURN INT64 "
+    "      DO "
+    "           RETURN 3 - 5; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE div_zero() RETURN INT64 "
+    "      DO "
+    "           RETURN 3 / 0; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE conditions() RETURN BOOL "
+    "      DO "
+    "           RETURN (5 > 3) AND (1 < 2); "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE nulls() RETURN BOOL "
+    "      DO "
+    "           RETURN NULL == NULL; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE dead_branch(a INT32) RETURN INT32 "
+    "      DO "
+    "           IF (FALSE) "
+    "              a = 100; "
+    "           RETURN a; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE dead_store(a INT32) RETURN INT32 "
+    "      DO "
+    "           VAR unused INT32; "
+    "           unused = 7; "
+    "           unused = a; "
+    "           RETURN a; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE not_jump(a BOOL) RETURN INT32 "
+    "      DO "
+    "           IF (NOT a) "
+    "              RETURN 1; "
+    "           RETURN 2; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE nested_loops(a INT32) RETURN INT32 "
+    "      DO "
+    "           WHILE (a > 10) DO "
+    "              IF (a > 50) DO "
+    "                 a = a - 5; "
+    "              ELSE DO "
+    "                 a = a - 1; "
+    "              END "
+    "           END "
+    "           RETURN a; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE used_local(a INT32) RETURN INT32 "
+    "      DO "
+    "           VAR b INT32; "
+    "           b = 7; "
+    "           RETURN a + b; "
+    "      ENDPROC \n"
+    "    "
+    "      PROCEDURE typed_ops(a INT32, b UINT16) RETURN BOOL "
+    "      DO "
+    "           RETURN (a + a < a * b) AND (b != b); "
+    "      ENDPROC \n"
+    "    "
+    "      PROCEDURE twice(a INT32) RETURN INT32 "
+    "      DO "
+    "           RETURN a * 2; "
+    "      ENDPROC \n"
+    "#@noinline\n"
+    "      PROCEDURE not_inlined(a INT32) RETURN INT32 "
+    "      DO "
+    "           RETURN a - 1; "
+    "      ENDPROC \n"
+    "    "
+    "      PROCEDURE inline_caller(a INT32) RETURN INT32 "
+    "      DO "
+    "           RETURN twice(a) + not_inlined(a); "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE loop_invariant(a INT64) RETURN INT64 "
+    "      DO "
+    "           VAR s INT64; "
+    "           VAR i INT64; "
+    "           s = 0; "
+    "           FOR (i = 0; i < 10; i += 1) "
+    "              s += a * 3 + (i * 4) % 5 + (i * 4) % 7 + (i * 4) % 11; "
+    "           RETURN s; "
+    "      ENDPROC ";
+
+
+static const uint8_t consts_code[]      = { W_LDI8, 14, W_RET };
+static const uint8_t negative_code[]    = { W_LDI8, 3, W_LDI8, 5, W_SUBU64, W_RET };
+static const uint8_t div_zero_code[]    = { W_LDI8, 3, W_LDI8, 0, W_DIVU, W_RET };
+static const uint8_t conditions_code[]  = { W_LDBT, W_RET };
+static const uint8_t nulls_code[]       = { W_LDBT, W_RET };
+static const uint8_t dead_branch_code[] = { W_LDLO8, 0, W_RET };
+static const uint8_t dead_store_code[]  = { W_LDLO8, 0, W_RET };
+static const uint8_t not_jump_code[]    = { W_LDLO8, 0, W_JTC, 8, 0, 0, 0,
+                                            W_LDI8, 1, W_RET,
+                                            W_LDI8, 2, W_RET };
+
+static const uint8_t used_local_code[]  = { W_LDLO8, 1, W_LDI8, 7, W_STI32, W_CTS, 1,
+                                            W_LDLO8, 0, W_LDLO8, 1, W_ADDI32, W_RET };
+static const uint8_t typed_ops_code[]   = { W_LDLO8, 0, W_LDLO8, 0, W_ADDI32,
+                                            W_LDLO8, 0, W_LDLO8, 1, W_MUL,
+                                            W_LTI64, W_JF, 11, 0, 0, 0,
+                                            W_LDLO8, 1, W_LDLO8, 1, W_NEU16,
+                                            W_ANDB, W_RET };
+
+static const struct
+{
+  const char*     name;
+  const uint8_t*  code;
+  uint_t          codeSize;
+} expected_procs[] = {
+    { "consts",      consts_code,      sizeof consts_code      },
+    { "negative",    negative_code,    sizeof negative_code    },
+    { "div_zero",    div_zero_code,    sizeof div_zero_code    },
+    { "conditions",  conditions_code,  sizeof conditions_code  },
+    { "nulls",       nulls_code,       sizeof nulls_code       },
+    { "dead_branch", dead_branch_code, sizeof dead_branch_code },
+    { "dead_store",  dead_store_code,  sizeof dead_store_code  },
+    { "not_jump",    not_jump_code,    sizeof not_jump_code    },
+    { "used_local",  used_local_code,  sizeof used_local_code  },
+    { "typed_ops",   typed_ops_code,   sizeof typed_ops_code   }
+};
+
+
+static struct WOutputStream*
+proc_code(struct ParserState *state, const char * proc_name)
+{
+  struct Statement *stmt = find_proc_decl(state, proc_name, strlen(proc_name), FALSE);
+
+  return (stmt == NULL) ? NULL : stmt_query_instrs(stmt);
+}
+
+static bool_t
+check_expected_code(struct ParserState *state)
+{
+  uint_t i;
+
+  for (i = 0; i < sizeof expected_procs / sizeof expected_procs[0]; ++i)
+    {
+      struct WOutputStream *code = proc_code(state, expected_procs[i].name);
+
+      if (code == NULL
+          || wh_ostream_size(code) != expected_procs[i].codeSize
+          || memcmp(wh_ostream_data(code),
+                    expected_procs[i].code,
+                    expected_procs[i].codeSize) != 0)
+        {
+          printf("(%s) ", expected_procs[i].name);
+          return FALSE;
+        }
+    }
+
+  return TRUE;
+}
+
+/* Count the jumps landing on unconditional jumps. */
+static int
+count_jumps_to_jumps(struct WOutputStream *code)
+{
+  const uint8_t *data = wh_ostream_data(code);
+  uint_t pos = 0;
+  int result = 0;
+
+  while (pos < wh_ostream_size(code))
+    {
+      const enum W_OPCODE op = decode_opcode(data + pos);
+
+      if (op == W_JMP || op == W_JF || op == W_JFC || op == W_JT || op == W_JTC)
+        {
+          const int64_t target = (int64_t)pos
+                                 + (int32_t)load_le_int32(data + pos + opcode_bytes(op));
+
+          if (target < 0 || target > wh_ostream_size(code))
+            return -1;
+
+          if (target < wh_ostream_size(code) && decode_opcode(data + target) == W_JMP)
+            ++result;
+        }
+      pos += opcode_bytes(op) + opcode_args_bytes(op);
+    }
+
+  return (pos == wh_ostream_size(code)) ? result : -1;
+}
+
+static bool_t
+check_nested_loops(struct ParserState *state, struct ParserState *unoptimized)
+{
+  struct WOutputStream *code = proc_code(state, "nested_loops");
+  struct WOutputStream *original = proc_code(unoptimized, "nested_loops");
+
+  return count_jumps_to_jumps(original) > 0
+         && count_jumps_to_jumps(code) == 0
+         && wh_ostream_size(code) <= wh_ostream_size(original);
+}
+
+/* Count the procedure calls left in the code. */
+static int
+count_calls(struct WOutputStream *code)
+{
+  const uint8_t *data = wh_ostream_data(code);
+  uint_t pos = 0;
+  int result = 0;
+
+  while (pos < wh_ostream_size(code))
+    {
+      const enum W_OPCODE op = decode_opcode(data + pos);
+
+      if (op == W_CALL)
+        ++result;
+
+      pos += opcode_bytes(op) + opcode_args_bytes(op);
+    }
+
+  return result;
+}
+
+static bool_t
+check_inlined_calls(struct ParserState *state, struct ParserState *unoptimized)
+{
+  return count_calls(proc_code(unoptimized, "inline_caller")) == 2
+         && count_calls(proc_code(state, "inline_caller")) == 1;
+}
+
+/* Count the instructions with the given opcode inside and outside of the
+ * loop closed by the first backward jump. */
+static void
+count_opcodes(struct WOutputStream *code,
+              const enum W_OPCODE opcode,
+              int *outside,
+              int *inside)
+{
+  const uint8_t *data = wh_ostream_data(code);
+  uint_t pos = 0, loopStart = 0, loopEnd = 0;
+
+  while (pos < wh_ostream_size(code) && loopEnd == 0)
+    {
+      const enum W_OPCODE op = decode_opcode(data + pos);
+
+      if (op == W_JMP && (int32_t)load_le_int32(data + pos + opcode_bytes(op)) < 0)
+        {
+          loopStart = pos + (int32_t)load_le_int32(data + pos + opcode_bytes(op));
+          loopEnd   = pos;
+        }
+      pos += opcode_bytes(op) + opcode_args_bytes(op);
+    }
+
+  *outside = *inside = 0;
+  for (pos = 0; pos < wh_ostream_size(code); )
+    {
+      const enum W_OPCODE op = decode_opcode(data + pos);
+
+      if (op == opcode)
+        ++*((loopStart <= pos && pos <= loopEnd) ? inside : outside);
+
+      pos += opcode_bytes(op) + opcode_args_bytes(op);
+    }
+}
+
+static bool_t
+check_loop_invariants(struct ParserState *state, struct ParserState *unoptimized)
+{
+  int outside, inside, originalOutside, originalInside;
+
+  count_opcodes(proc_code(unoptimized, "loop_invariant"),
+                W_MUL,
+                &originalOutside,
+                &originalInside);
+  count_opcodes(proc_code(state, "loop_invariant"), W_MUL, &outside, &inside);
+
+  /* The invariant product and the induction variable's ones are computed
+   * before the loop. */
+  return (originalOutside == 0) && (originalInside == 4)
+         && (outside == 2) && (inside == 0);
+}
+
+/* The rewritten loops trade some code size for speed. */
+static const char* grown_procs[] = { "loop_invariant" };
+
+static const char specialize_buffer[] = ""
+    "      PROCEDURE pass_on(a UNDEFINED, b ARRAY) RETURN UNDEFINED "
+    "      DO "
+    "           RETURN a; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE set_arg(a UNDEFINED) RETURN UNDEFINED "
+    "      DO "
+    "           a = 5; "
+    "           RETURN a; "
+    "      ENDPROC "
+    "    "
+    "      PROCEDURE generic_caller(a INT64, b INT8 ARRAY) RETURN INT64 "
+    "      DO "
+    "           VAR r INT64; "
+    "           r = pass_on(a, b); "
+    "           r = pass_on(a, b); "
+    "           r = set_arg(a); "
+    "           RETURN r; "
+    "      ENDPROC ";
+
+static const uint8_t pass_on_code[] = { W_LDLO8, 0, W_RET };
+static const uint8_t set_arg_code[] = { W_LDLO8, 0, W_CALL, 1, 0, 0, 0, W_RET };
+
+static bool_t
+check_specialized_proc(struct ParserState *state,
+                       const char * proc_name,
+                       const uint8_t* code,
+                       uint_t codeSize)
+{
+  struct WOutputStream *instrs = proc_code(state, proc_name);
+
+  return instrs != NULL
+         && wh_ostream_size(instrs) == codeSize
+         && memcmp(wh_ostream_data(instrs), code, codeSize) == 0;
+}
+
+static bool_t
+check_specializations(struct ParserState *state)
+{
+  const struct WArray *procs = &state->globalStmt.spec.glb.procsDecls;
+
+  /* Both calls of 'pass_on' should share the same specialization, while
+   * 'set_arg' changes its parameter's type so it has to call the generic. */
+  return wh_array_count(procs) == 5
+         && check_specialized_proc(state,
+                                   "pass_on@INT64@INT8_ARRAY",
+                                   pass_on_code,
+                                   sizeof pass_on_code)
+         && check_specialized_proc(state,
+                                   "set_arg@INT64",
+                                   set_arg_code,
+                                   sizeof set_arg_code);
+}
+
+static bool_t
+may_grow(const struct Statement *stmt)
+{
+  uint_t i;
+
+  for (i = 0; i < sizeof grown_procs / sizeof grown_procs[0]; ++i)
+    {
+      if (strlen(grown_procs[i]) == stmt->spec.proc.nameLength
+          && strncmp(grown_procs[i], stmt->spec.proc.name, stmt->spec.proc.nameLength) == 0)
+        {
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+static bool_t
+check_reduced_sizes(struct ParserState *state, struct ParserState *unoptimized)
+{
+  const struct WArray *procs = &state->globalStmt.spec.glb.procsDecls;
+  uint_t optimizedSize = 0, originalSize = 0;
+  uint_t i;
+
+  for (i = 0; i < wh_array_count(procs); ++i)
+    {
+      struct Statement *stmt = (struct Statement*) wh_array_get(procs, i);
+      struct Statement *originalStmt = find_proc_decl(unoptimized,
+                                                      stmt->spec.proc.name,
+                                                      stmt->spec.proc.nameLength,
+                                                      FALSE);
+      struct WOutputStream *original = (originalStmt == NULL)
+                                       ? NULL
+                                       : stmt_query_instrs(originalStmt);
+      const uint_t size = wh_ostream_size(stmt_query_instrs(stmt));
+
+      if (original == NULL || (size > wh_ostream_size(original) && ! may_grow(stmt)))
+        return FALSE;
+
+      optimizedSize += size;
+      originalSize  += wh_ostream_size(original);
+    }
+
+  printf("(%u of %u bytes) ", optimizedSize, originalSize);
+
+  return optimizedSize < originalSize;
+}
+
+int
+main()
+{
+  bool_t test_result = TRUE;
+  struct ParserState state = { 0, };
+  struct ParserState unoptimized = { 0, };
+  struct ParserState specialized = { 0, };
+
+  init_state_for_test(&state, proc_decl_buffer);
+  init_state_for_test(&unoptimized, proc_decl_buffer);
+  init_state_for_test(&specialized, specialize_buffer);
+  state.optimize = TRUE;
+  specialized.optimize = TRUE;
+
+  printf("Testing parse..");
+  if (yyparse( &state) != 0 || yyparse( &unoptimized) != 0)
+    {
+      printf("FAILED\n");
+      test_result = FALSE;
+    }
+  else
+    {
+      printf("PASSED\n");
+    }
+
+  if (test_result)
+    {
+      printf("Testing garbage vals...");
+      if (check_used_vals( &state))
+        {
+          /* those should no be here */
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+      else
+        {
+          printf("PASSED\n");
+        }
+    }
+
+  if (test_result)
+    {
+      printf("Testing optimized code ...");
+      if (check_expected_code( &state))
+        {
+          printf("PASSED\n");
+        }
+      else
+        {
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+
+      printf("Testing jump threading ...");
+      if (check_nested_loops( &state, &unoptimized))
+        {
+          printf("PASSED\n");
+        }
+      else
+        {
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+
+      printf("Testing inlined calls ...");
+      if (check_inlined_calls( &state, &unoptimized))
+        {
+          printf("PASSED\n");
+        }
+      else
+        {
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+
+      printf("Testing loop invariants ...");
+      if (check_loop_invariants( &state, &unoptimized))
+        {
+          printf("PASSED\n");
+        }
+      else
+        {
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+
+      printf("Testing code sizes ...");
+      if (check_reduced_sizes( &state, &unoptimized))
+        {
+          printf("PASSED\n");
+        }
+      else
+        {
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+
+      printf("Testing specialized procedures ...");
+      if (yyparse( &specialized) == 0
+          && compile_specialized_procs( &specialized)
+          && check_specializations( &specialized))
+        {
+          printf("PASSED\n");
+        }
+      else
+        {
+          printf("FAILED\n");
+          test_result = FALSE;
+        }
+    }
+
+  free_state(&state);
+  free_state(&unoptimized);
+  free_state(&specialized);
+  printf("Memory peak: %u bytes \n", (uint_t)test_get_mem_peak());
+  printf("Current memory usage: %u bytes...",  (uint_t)test_get_mem_used());
+  if (test_get_mem_used() != 0)
+    {
+      test_result = FALSE;
+      printf("FAILED\n");
+    }
+  else
+    {
+      printf("PASSED\n");
+    }
+
+  if (test_result == FALSE)
+    {
+      printf("TEST RESULT: FAIL\n");
+      return -1;
+    }
+
+  printf("TEST RESULT: PASS\n");
+  return 0;
+}
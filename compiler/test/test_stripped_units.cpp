@@ -0,0 +1,257 @@
+/*
+ * test_stripped_units.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "compiler/compactcode.h"
+#include "compiler/compiledunit.h"
+#include "compiler/strippedunit.h"
+#include "compiler/wopcodes.h"
+#include "utils/endianness.h"
+#include "custom/include/test/test_fmw.h"
+
+using namespace std;
+using namespace whais;
+
+static const uint8_t libraryProgram[] = ""
+    "VAR unused INT32;\n"
+    "VAR used INT32;\n"
+    "\n"
+    "PROCEDURE dead(a INT32) RETURN INT32\n"
+    "DO\n"
+    "  unused = a;\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE helper(a INT32) RETURN INT32\n"
+    "DO\n"
+    "  RETURN a + used;\n"
+    "ENDPROC\n";
+
+static const uint8_t appProgram[] = ""
+    "EXTERN VAR other INT32;\n"
+    "EXTERN VAR used INT32;\n"
+    "\n"
+    "EXTERN PROCEDURE dead(a INT32) RETURN INT32;\n"
+    "EXTERN PROCEDURE helper(a INT32) RETURN INT32;\n"
+    "EXTERN PROCEDURE native(a INT32) RETURN INT32;\n"
+    "\n"
+    "PROCEDURE skipped() RETURN INT32\n"
+    "DO\n"
+    "  RETURN dead(other);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE entry(a INT32) RETURN INT32\n"
+    "DO\n"
+    "  RETURN helper(a) + native(a) + used;\n"
+    "ENDPROC\n";
+
+
+static void
+my_postman(WH_MESSENGER_CTXT data,
+           uint_t            buff_pos,
+           uint_t            msg_id,
+           uint_t            msgType,
+           const char*       pMsgFormat,
+           va_list           args)
+{
+  fprintf(stderr, "%u : ", msg_id);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+}
+
+
+static string
+procedure_name(WIFunctionalUnit& unit, const uint_t id)
+{
+  return string(unit.RetriveProcName(id), unit.GetProcNameSize(id));
+}
+
+
+static string
+global_name(WIFunctionalUnit& unit, const uint_t id)
+{
+  return string(unit.RetriveGlobalName(id), unit.GlobalNameLength(id));
+}
+
+
+//Collect the procedures and the globals indexes a procedure's code refers.
+static void
+code_references(WIFunctionalUnit&   unit,
+                const uint_t        procId,
+                vector<uint32_t>&   outProcs,
+                vector<uint32_t>&   outGlobals)
+{
+  const uint8_t* const code = unit.RetriveProcCodeArea(procId);
+  const uint_t codeSize = unit.ProcCodeAreaSize(procId);
+
+  for (uint_t pos = 0; pos < codeSize; pos += 1 + code_args_size(code[pos]))
+  {
+    if (code[pos] == W_CALL)
+      outProcs.push_back(load_le_int32(code + pos + 1));
+
+    else if (code[pos] == W_LDGB8)
+      outGlobals.push_back(code[pos + 1]);
+
+    else if (code[pos] == W_LDGB16)
+      outGlobals.push_back(load_le_int16(code + pos + 1));
+
+    else if (code[pos] == W_LDGB32)
+      outGlobals.push_back(load_le_int32(code + pos + 1));
+  }
+}
+
+
+static bool
+test_library(WIFunctionalUnit& unit)
+{
+  if ((unit.GlobalsCount() != 1)
+      || (global_name(unit, 0) != "used")
+      || unit.IsGlobalExternal(0))
+  {
+    return false;
+  }
+
+  if ((unit.ProceduresCount() != 1)
+      || (procedure_name(unit, 0) != "helper")
+      || unit.IsProcExternal(0))
+  {
+    return false;
+  }
+
+  vector<uint32_t> procs, globals;
+  code_references(unit, 0, procs, globals);
+
+  return procs.empty() && (globals == vector<uint32_t>{0});
+}
+
+
+static bool
+test_application(WIFunctionalUnit& unit)
+{
+  if ((unit.GlobalsCount() != 1)
+      || (global_name(unit, 0) != "used")
+      || ! unit.IsGlobalExternal(0))
+  {
+    return false;
+  }
+
+  if (unit.ProceduresCount() != 3)
+    return false;
+
+  uint_t entry = 0;
+  vector<string> names;
+
+  for (uint_t p = 0; p < unit.ProceduresCount(); ++p)
+  {
+    names.push_back(procedure_name(unit, p));
+    if (names.back() == "entry")
+      entry = p;
+
+    if ((unit.IsProcExternal(p) != FALSE) == (names.back() == "entry"))
+      return false;
+  }
+
+  vector<uint32_t> procs, globals;
+  code_references(unit, entry, procs, globals);
+
+  return (procs.size() == 2)
+         && (procs[0] < names.size()) && (names[procs[0]] == "helper")
+         && (procs[1] < names.size()) && (names[procs[1]] == "native")
+         && (globals == vector<uint32_t>{0});
+}
+
+
+static bool
+test_unknown_entry(const vector<WIFunctionalUnit*>& units)
+{
+  vector<unique_ptr<StrippedUnit>> stripped;
+
+  try
+  {
+    strip_units(units, {"entry", "missing"}, stripped);
+  }
+  catch (FunctionalUnitException&)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+
+int
+main()
+{
+  bool success = true;
+
+  {
+    CompiledBufferUnit library(libraryProgram, sizeof libraryProgram, my_postman, nullptr);
+    CompiledBufferUnit app(appProgram, sizeof appProgram, my_postman, nullptr);
+
+    const vector<WIFunctionalUnit*> units = { &library, &app };
+    vector<unique_ptr<StrippedUnit>> stripped;
+
+    strip_units(units, {"entry"}, stripped);
+
+    cout << "Testing the stripped library ... ";
+    if ((stripped.size() == 2) && test_library( *stripped[0]))
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+
+    cout << "Testing the stripped application ... ";
+    if ((stripped.size() == 2) && test_application( *stripped[1]))
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+
+    cout << "Testing an unknown entry ... ";
+    if (test_unknown_entry(units))
+      cout << "PASSED" << endl;
+
+    else
+    {
+      cout << "FAILED" << endl;
+      success = false;
+    }
+  }
+
+  cout << "Current memory usage: " << test_get_mem_used() << " bytes...";
+  if (test_get_mem_used() != 0)
+  {
+    cout << "FAILED" << endl;
+    success = false;
+  }
+  else
+    cout << "PASSED" << endl;
+
+  if (!success)
+  {
+    cout << "TEST RESULT: FAIL" << endl;
+    return 1;
+  }
+
+  cout << "TEST RESULT: PASS" << endl;
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <cstdio>
 #include <cassert>
+#include <string>
 #include <vector>
 
 #include "msglog.h"
@@ -35,6 +36,25 @@ using namespace std;
 static const char *MSG_PREFIX[] = {"", "error ", "warning ", "error ", "extra "};
 
 
+static void
+append_message(string& message, const char* const format, va_list args)
+{
+  va_list argsCopy;
+
+  va_copy(argsCopy, args);
+  const int size = vsnprintf(nullptr, 0, format, argsCopy);
+  va_end(argsCopy);
+
+  if (size <= 0)
+    return;
+
+  const size_t from = message.size();
+  message.resize(from + size + 1);
+  vsnprintf(&message[from], size + 1, format, args);
+  message.resize(from + size);
+}
+
+
 static int
 get_line_from_buffer(const vector<SourceCodeMark>& codeMarks,
                      const char* buffer,
@@ -81,6 +101,17 @@ get_line_from_buffer(const vector<SourceCodeMark>& codeMarks,
 }
 
 
+static void
+append_message(string& message, const char* const format, ...)
+{
+  va_list vl;
+
+  va_start(vl, format);
+  append_message(message, format, vl);
+  va_end(vl);
+}
+
+
 void
 whc_messenger(WH_MESSENGER_CTXT   data,
               uint_t              buffOff,
@@ -96,17 +127,20 @@ whc_messenger(WH_MESSENGER_CTXT   data,
   uint_t mark = 0;
   auto buffLine = get_line_from_buffer(codeMarks, buffer, buffOff, &mark);
 
+  //The message is written at once, as other units may be compiled in
+  //parallel and report their messages meanwhile.
+  string message;
   if (buffLine >= 0)
   {
     assert(codeMarks.size() > 0);
 
-    fprintf(stderr,
-            "%s: line %d: %s %d: ",
-            codeMarks[mark].mBufferSource.c_str(),
-            buffLine,
-            MSG_PREFIX[msgType],
-            msgId);
-    vfprintf(stderr, msgFormat, args);
+    append_message(message,
+                   "%s: line %d: %s %d: ",
+                   codeMarks[mark].mBufferSource.c_str(),
+                   buffLine,
+                   MSG_PREFIX[msgType],
+                   msgId);
+    append_message(message, msgFormat, args);
 
     while (codeMarks[mark].mLevel > 0)
     {
@@ -120,20 +154,21 @@ whc_messenger(WH_MESSENGER_CTXT   data,
 
       assert(codeMarks[mark].mLevel == prevLevel);
 
-      fprintf(stderr,
-              "\n\tincluded from '%s' at line %d%c",
-              codeMarks[mark].mBufferSource.c_str(),
-              codeMarks[mark].mBufferLine,
-              prevLevel == 0 ? '.' : ';');
+      append_message(message,
+                     "\n\tincluded from '%s' at line %d%c",
+                     codeMarks[mark].mBufferSource.c_str(),
+                     codeMarks[mark].mBufferLine,
+                     prevLevel == 0 ? '.' : ';');
     }
   }
   else
   {
-    fprintf(stderr, "%s %d: ", MSG_PREFIX[msgType], msgId);
-    vfprintf(stderr, msgFormat, args);
+    append_message(message, "%s %d: ", MSG_PREFIX[msgType], msgId);
+    append_message(message, msgFormat, args);
   }
 
-  fprintf(stderr, "\n");
+  message += '\n';
+  fputs(message.c_str(), stderr);
 }
 
 
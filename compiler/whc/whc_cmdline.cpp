@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils/tokenizer.h"
 #include "utils/license.h"
 #include "whc_cmdline.h"
+#include "wo_format.h"
 
 using namespace std;
 
@@ -41,6 +42,8 @@ static const char sProgramName[] = "Whais Compiler";
 static const char sProgramDesc[] = "A tool to create procedures for data records handling.";
 const static string outputFileExt(".wo");
 const static string inputFileExt(".w");
+const static string strippedFileExt(".strip");
+static const uint_t MAX_JOBS_COUNT = 256;
 
 
 namespace whais {
@@ -60,10 +63,15 @@ CmdLineParser::CmdLineParser(int argc, char** argv)
     mShowHelp(false),
     mPreprocessOnly(false),
     mBuildDependencies(false),
+    mOptimize(false),
+    mIncremental(false),
     mShowLogo(false),
     mShowLicense(false),
+    mJobsCount(1),
+    mObjectFormat(WH_FFVER_MAJ_FIXED), //Loaded by the older servers too.
     mInclusionPaths(),
-    mReplacementTags()
+    mReplacementTags(),
+    mStripEntries()
 {
   AddInclusionPaths(whf_current_dir());
 }
@@ -90,6 +98,11 @@ CmdLineParser::Parse()
       mPreprocessOnly = true;
       ++index;
     }
+    else if (areStrsEqual(mArgs[index], "-O"))
+    {
+      mOptimize = true;
+      ++index;
+    }
     else if (areStrsEqual(mArgs[index], "-I"))
     {
       if (++index >= mArgCount || mArgs[index][0] == '-')
@@ -128,6 +141,51 @@ CmdLineParser::Parse()
       mBuildDependencies = true;
       ++index;
     }
+    else if (areStrsEqual(mArgs[index], "--incremental"))
+    {
+      mIncremental = true;
+      ++index;
+    }
+    else if (areStrsEqual(mArgs[index], "-j"))
+    {
+      if (++index >= mArgCount || mArgs[index][0] == '-')
+        throw CmdLineException(_EXTRA(0), "Missing value for parameter '-j'.");
+
+      char* end = nullptr;
+      const long jobs = strtol(mArgs[index], &end, 10);
+      if ((*end != 0) || (jobs < 1) || (jobs > MAX_JOBS_COUNT))
+      {
+        throw CmdLineException(_EXTRA(0),
+                               "The jobs count should be a number between 1 and %u.",
+                               MAX_JOBS_COUNT);
+      }
+
+      mJobsCount = jobs;
+      ++index;
+    }
+    else if (areStrsEqual(mArgs[index], "--format"))
+    {
+      if (++index >= mArgCount || mArgs[index][0] == '-')
+        throw CmdLineException(_EXTRA(0), "Missing value for parameter '--format'.");
+
+      if (areStrsEqual(mArgs[index], "1"))
+        mObjectFormat = WH_FFVER_MAJ_FIXED;
+
+      else if (areStrsEqual(mArgs[index], "2"))
+        mObjectFormat = WH_FFVER_MAJ;
+
+      else
+        throw CmdLineException(_EXTRA(0), "The object format version should be 1 or 2.");
+
+      ++index;
+    }
+    else if (areStrsEqual(mArgs[index], "--strip"))
+    {
+      if (++index >= mArgCount || mArgs[index][0] == '-')
+        throw CmdLineException(_EXTRA(0), "Missing value for parameter '--strip'.");
+
+      AddStripEntries(mArgs[index++]);
+    }
     else if (areStrsEqual(mArgs[index], "-o"))
     {
       if (++index >= mArgCount || mArgs[index][0] == '-')
@@ -189,6 +247,28 @@ CmdLineParser::AddInclusionPaths(const char* const paths)
 }
 
 
+void
+CmdLineParser::AddStripEntries(const char* const names)
+{
+  const string list(names);
+
+  for (size_t start = 0; start <= list.size(); )
+  {
+    size_t end = list.find(';', start);
+    if (end == string::npos)
+      end = list.size();
+
+    if (end > start)
+      mStripEntries.push_back(list.substr(start, end - start));
+
+    start = end + 1;
+  }
+
+  if (mStripEntries.empty())
+    throw CmdLineException(_EXTRA(0), "Missing value for parameter '--strip'.");
+}
+
+
 void
 CmdLineParser::CheckArguments()
 {
@@ -210,6 +290,30 @@ CmdLineParser::CheckArguments()
   else if (mSourceFile.size() == 0)
     throw CmdLineException(_EXTRA(0), "The input file was not specified.");
 
+  else if (Strip() && (mPreprocessOnly || mBuildDependencies || mIncremental))
+  {
+    throw CmdLineException(_EXTRA(0),
+                           "The parameter '--strip' cannot be used with '-P',"
+                           " '--make_deps' or '--incremental'.");
+  }
+  else if (Strip() && (mOutputFile.size() < mSourceFile.size()))
+  {
+    //The stripped objects are written next to the ones they are made of.
+    for (auto i = mOutputFile.size(); i < mSourceFile.size(); ++i)
+    {
+      string output = mSourceFile[i];
+
+      if ((output.size() > outputFileExt.size())
+          && (output.compare(output.size() - outputFileExt.size(),
+                             outputFileExt.size(),
+                             outputFileExt) == 0))
+      {
+        output.resize(output.size() - outputFileExt.size());
+      }
+
+      mOutputFile.push_back(output + strippedFileExt + outputFileExt);
+    }
+  }
   else if (mOutputFile.size() < mSourceFile.size())
   {
     for (auto i = mOutputFile.size(); i < mSourceFile.size(); ++i)
@@ -282,7 +386,7 @@ CmdLineParser::DisplayUsage() const
 
   displayBanner(cout, sProgramName, WVER_MAJ, WVER_MIN);
   cout <<
-    "Usage: whc [options] input_file\n"
+    "Usage: whc [options] input_file ...\n"
     "Options:\n"
     "-D 'tag=text'   Define a replace tag(e.g -D 'user_name=The Coder' ).\n"
     "-h, --help      Display this help.\n"
@@ -291,8 +395,20 @@ CmdLineParser::DisplayUsage() const
     "                (e.g -I '/usr/local/whais/inc;C:\\whais\\inc').\n"
     "--make_deps     Generate the dependencies list of this file(in a 'make'\n"
     "                recognized way) on the standard output.\n"
+    "--format 1|2    Write the objects in the given format version. The\n"
+    "                default 1 is loaded by every server. The compact 2 is\n"
+    "                smaller, but only the servers of this version load it.\n"
+    "--incremental   Skip the input files whose sources, included files and\n"
+    "                options did not change since their last compilation.\n"
+    "                These are kept in a '.deps' file next to the output.\n"
+    "-j count        Compile up to 'count' input files in parallel.\n"
     "-o file         Use 'file' as the compilation output file.\n"
+    "-O              Optimize the code of the compiled procedures.\n"
     "-P              Preprocess only. Display the result on standard output.\n"
+    "--strip 'e1;e2' Treat the input files as compiled objects, to be loaded\n"
+    "                in the given order, and keep of them only the globals\n"
+    "                and procedures reached from the listed entries (e.g.\n"
+    "                the procedures called by the clients).\n"
     "-v, --version   Show version information.\n"
     "-l, --license   Print the license details.\n";
 }
@@ -51,8 +51,14 @@ public:
   auto OutputFile() const { return mOutputFile; }
   auto JustPreprocess() const { return mPreprocessOnly; }
   auto BuildDependencies() const { return mBuildDependencies; }
+  auto Optimize() const { return mOptimize; }
+  auto Incremental() const { return mIncremental; }
+  auto JobsCount() const { return mJobsCount; }
+  auto ObjectFormat() const { return mObjectFormat; }
   auto InclusionPaths() const { return mInclusionPaths; }
   auto ReplacementTags() const { return mReplacementTags; }
+  auto StripEntries() const { return mStripEntries; }
+  auto Strip() const { return ! mStripEntries.empty(); }
 
   void Parse();
 
@@ -60,6 +66,7 @@ private:
   void DisplayUsage() const;
   void CheckArguments();
   void AddInclusionPaths(const char* const paths);
+  void AddStripEntries(const char* const names);
 
 private:
   int         mArgCount;
@@ -67,13 +74,18 @@ private:
   bool        mShowHelp;
   bool        mPreprocessOnly;
   bool        mBuildDependencies;
+  bool        mOptimize;
+  bool        mIncremental;
   bool        mShowLogo;
   bool        mShowLicense;
+  uint_t      mJobsCount;
+  uint_t      mObjectFormat;
 
   std::vector<std::string>      mSourceFile;
   std::vector<std::string>      mOutputFile;
   std::vector<std::string>      mInclusionPaths;
   std::vector<ReplacementTag>   mReplacementTags;
+  std::vector<std::string>      mStripEntries;
 };
 
 
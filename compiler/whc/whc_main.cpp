@@ -22,13 +22,20 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <assert.h>
+#include <string.h>
 
 #include "whais.h"
+#include "compiler/compactcode.h"
 #include "compiler/compiledunit.h"
+#include "compiler/strippedunit.h"
 #include "utils/wfile.h"
+#include "utils/whash.h"
+#include "utils/wthread.h"
 #include "utils/endianness.h"
 #include "utils/woutstream.h"
 #include "msglog.h"
@@ -42,7 +49,37 @@ using namespace whais;
 using namespace whais::whc;
 
 
-uint8_t wh_header[WHC_TABLE_SIZE] = { 0, };
+static const char MANIFEST_EXT[]     = ".deps";
+static const char MANIFEST_OPTIONS[] = "#@options ";
+static const char MANIFEST_HASH[]    = "#@hash ";
+
+//The units whose code uses these tags are compiled every time.
+static const char* const TIME_TAGS[] = {
+  "_YEAR_", "_MONTH_", "_DAY_", "_HOUR_", "_MIN_", "_SEC_", "_USEC_", "_TIME_STAMP_"
+};
+
+//Get the offset of a symbol's name, reusing the place of a name or a
+//constant text already present.
+static uint32_t
+add_symbol(WOutputStream* const symbols, const char* const name, const uint_t length)
+{
+  const uint8_t* const data = wh_ostream_data(symbols);
+  const uint_t size = wh_ostream_size(symbols);
+
+  for (uint_t at = 0; at + length < size; ++at)
+  {
+    if ((data[at + length] == 0) && (memcmp(data + at, name, length) == 0))
+      return at;
+  }
+
+  if ( ! wh_ostream_write(symbols, _RC(const uint8_t*, name), length)
+      || ! wh_ostream_wint8(symbols, 0))
+  {
+    throw bad_alloc();
+  }
+
+  return size;
+}
 
 
 static void
@@ -55,17 +92,15 @@ fill_globals_table(WIFunctionalUnit&      unit,
   for (uint_t glbIt = 0; glbIt < globals_count; ++glbIt)
   {
     auto glbTypeIndex = unit.GlobalTypeOff(glbIt);
-    auto glbNameIndex = wh_ostream_size(symbols);
+    auto glbNameIndex = add_symbol(symbols,
+                                   unit.RetriveGlobalName(glbIt),
+                                   unit.GlobalNameLength(glbIt));
 
     if (unit.IsGlobalExternal(glbIt))
       glbTypeIndex |= EXTERN_MASK;
 
     if ( ! wh_ostream_wint32(glblsTable, glbTypeIndex)
-        || ! wh_ostream_wint32(glblsTable, glbNameIndex)
-        || ! wh_ostream_write(symbols,
-                              _RC(const uint8_t *, unit.RetriveGlobalName(glbIt)),
-                              unit.GlobalNameLength(glbIt))
-        || ! wh_ostream_wint8(symbols, 0))
+        || ! wh_ostream_wint32(glblsTable, glbNameIndex))
     {
       throw bad_alloc();
     }
@@ -77,7 +112,8 @@ static void
 process_procedures_table(WIFunctionalUnit&  unit,
                           File&             destFile,
                           WOutputStream    *symbols,
-                          WOutputStream    *procTable)
+                          WOutputStream    *procTable,
+                          const bool        compact)
 {
   const auto proc_count = unit.ProceduresCount();
 
@@ -91,14 +127,22 @@ process_procedures_table(WIFunctionalUnit&  unit,
 
     assert(localsCount >= paramsCound);
 
-    for (uint_t localIt = 0; localIt < localsCount; ++localIt)
+    //The compact bodies skip the return type, as the entry holds it already.
+    vector<uint8_t> body;
+    for (uint_t localIt = compact ? 1 : 0; localIt < localsCount; ++localIt)
     {
       const uint32_t localTypeOff = unit.GetProcLocalTypeOff(procIt, localIt);
 
-      uint8_t offset[sizeof(localTypeOff)];
-      store_le_int32(localTypeOff, offset);
+      if (compact)
+        store_varint(localTypeOff, body);
+
+      else
+      {
+        uint8_t offset[sizeof(localTypeOff)];
+        store_le_int32(localTypeOff, offset);
 
-      destFile.Write(offset, sizeof offset);
+        body.insert(body.end(), offset, offset + sizeof offset);
+      }
     }
 
     if (unit.IsProcExternal(procIt))
@@ -106,26 +150,29 @@ process_procedures_table(WIFunctionalUnit&  unit,
 
     else
     {
-      uint8_t n_sync_stmts = unit.ProcSyncStatementsCount(procIt);
+      const uint8_t* const code = unit.RetriveProcCodeArea(procIt);
+
+      body.push_back(unit.ProcSyncStatementsCount(procIt));
+      if (compact)
+        compact_proc_code(code, procCodeSize, body);
 
-      destFile.Write(_RC(uint8_t *, &n_sync_stmts), sizeof n_sync_stmts);
-      destFile.Write(unit.RetriveProcCodeArea(procIt), unit.ProcCodeAreaSize(procIt));
+      else
+        body.insert(body.end(), code, code + procCodeSize);
     }
 
-    if ( ! wh_ostream_wint32(procTable, wh_ostream_size(symbols))
+    destFile.Write(body.data(), body.size());
+
+    const uint32_t nameOff = add_symbol(symbols,
+                                        unit.RetriveProcName(procIt),
+                                        unit.GetProcNameSize(procIt));
+
+    if ( ! wh_ostream_wint32(procTable, nameOff)
         || ! wh_ostream_wint32(procTable, procOff)
         || ! wh_ostream_wint32(procTable, procRetType)
         || ! wh_ostream_wint16(procTable, localsCount)
         || ! wh_ostream_wint16(procTable, paramsCound)
-        || ! wh_ostream_wint32(procTable, procCodeSize))
-    {
-      throw bad_alloc();
-    }
-
-    if ( ! wh_ostream_write(symbols,
-                            _RC(const uint8_t *, unit.RetriveProcName(procIt)),
-                            unit.GetProcNameSize(procIt))
-        || ! wh_ostream_wint8(symbols, 0))
+        || ! wh_ostream_wint32(procTable, procCodeSize)
+        || (compact && ! wh_ostream_wint32(procTable, body.size())))
     {
       throw bad_alloc();
     }
@@ -134,17 +181,21 @@ process_procedures_table(WIFunctionalUnit&  unit,
 
 
 static void
-create_object_file(const char* const                  outFile,
-                    const string&                      sourceCode,
-                    const vector<SourceCodeMark>&      codeMarks)
+write_object_file(const char* const    outFile,
+                  WIFunctionalUnit&    unit,
+                  const uint_t         format)
 {
   uint_t        langVerMaj;
   uint_t        langVerMin;
+  uint8_t       wh_header[WHC_TABLE_SIZE] = { 0, };
 
   WOutputStream symbolsStream;
   WOutputStream glbsTableStream;
   WOutputStream procsTableStream;
 
+  const bool compact = (format != WH_FFVER_MAJ_FIXED);
+  const uint_t procEntrySize = compact ? WHC_PROC_ENTRY_V2_SIZE : WHC_PROC_ENTRY_SIZE;
+
   wh_compiler_language_ver(&langVerMaj, &langVerMin);
 
   wh_ostream_init(OUTSTREAM_INCREMENT_SIZE, &symbolsStream);
@@ -153,13 +204,6 @@ create_object_file(const char* const                  outFile,
 
   try
   {
-    WHC_MESSAGE_CTX ctx(codeMarks, sourceCode.c_str());
-
-    CompiledBufferUnit unit(_RC(const uint8_t*, sourceCode.c_str()),
-                             sourceCode.size(),
-                             whc_messenger,
-                             &ctx);
-
     File outputObject(outFile, WH_FILEWRITE | WH_FILECREATE);
 
     outputObject.Size(0);
@@ -168,10 +212,18 @@ create_object_file(const char* const                  outFile,
     //reserve space for header file
     outputObject.Write(wh_header, sizeof wh_header);
 
+    //The compact objects keep the symbols' names with the constant texts.
+    if (compact
+        && ! wh_ostream_write(&symbolsStream, unit.RetrieveConstArea(), unit.ConstsAreaSize()))
+    {
+      throw bad_alloc();
+    }
+
     process_procedures_table(unit,
                               outputObject,
                               &symbolsStream,
-                              &procsTableStream);
+                              &procsTableStream,
+                              compact);
     fill_globals_table(unit, &symbolsStream, &glbsTableStream);
 
     store_le_int32(wh_ostream_size(&glbsTableStream) / WHC_GLOBAL_ENTRY_SIZE,
@@ -180,10 +232,10 @@ create_object_file(const char* const                  outFile,
     assert((wh_ostream_size(&glbsTableStream) % WHC_GLOBAL_ENTRY_SIZE) == 0);
 
 
-    store_le_int32(wh_ostream_size(&procsTableStream) / WHC_PROC_ENTRY_SIZE,
+    store_le_int32(wh_ostream_size(&procsTableStream) / procEntrySize,
                     wh_header + WHC_PROCS_COUNT_OFF);
 
-    assert((wh_ostream_size(&procsTableStream) % WHC_PROC_ENTRY_SIZE) == 0);
+    assert((wh_ostream_size(&procsTableStream) % procEntrySize) == 0);
 
     store_le_int32(outputObject.Tell(), wh_header + WHC_TYPEINFO_START_OFF);
     store_le_int32(unit.TypeAreaSize(),
@@ -196,15 +248,21 @@ create_object_file(const char* const                  outFile,
     store_le_int32(wh_ostream_size(&symbolsStream),
                     wh_header + WHC_SYMTABLE_SIZE_OFF);
 
+    if (compact)
+      store_le_int32(outputObject.Tell(), wh_header + WHC_CONSTAREA_START_OFF);
+
     outputObject.Write(wh_ostream_data(&symbolsStream),
                       wh_ostream_size(&symbolsStream));
 
-    store_le_int32(outputObject.Tell(), wh_header + WHC_CONSTAREA_START_OFF);
+    if ( ! compact)
+    {
+      store_le_int32(outputObject.Tell(), wh_header + WHC_CONSTAREA_START_OFF);
+      outputObject.Write(unit.RetrieveConstArea(),
+                        unit.ConstsAreaSize());
+    }
     store_le_int32(unit.ConstsAreaSize(),
                     wh_header + WHC_CONSTAREA_SIZE_OFF);
 
-    outputObject.Write(unit.RetrieveConstArea(),
-                      unit.ConstsAreaSize());
     outputObject.Write(wh_ostream_data(&glbsTableStream),
                       wh_ostream_size(&glbsTableStream));
     outputObject.Write(wh_ostream_data(&procsTableStream),
@@ -212,7 +270,7 @@ create_object_file(const char* const                  outFile,
 
     wh_header[WHC_SIGNATURE_OFF]     = WH_SIGNATURE[0];
     wh_header[WHC_SIGNATURE_OFF + 1] = WH_SIGNATURE[1];
-    wh_header[WHC_FORMATMMAJ_OFF]    = WH_FFVER_MAJ;
+    wh_header[WHC_FORMATMMAJ_OFF]    = format;
     wh_header[WHC_FORMATMIN_OFF]     = WH_FFVER_MIN;
     wh_header[WHC_LANGVER_MAJ_OFF]   = langVerMaj;
     wh_header[WHC_LANGVER_MIN_OFF]   = langVerMin;
@@ -236,115 +294,442 @@ create_object_file(const char* const                  outFile,
 }
 
 
-int
-main(int argc, char **argv)
+static void
+create_object_file(const char* const                  outFile,
+                    const string&                      sourceCode,
+                    const vector<SourceCodeMark>&      codeMarks,
+                    const bool                         optimize,
+                    const uint_t                       format)
 {
-  CmdLineParser args(argc, argv);
+  WHC_MESSAGE_CTX ctx(codeMarks, sourceCode.c_str());
 
-  try
-  {
-    args.Parse();
-  }
-  catch(CmdLineException& e)
+  CompiledBufferUnit unit(_RC(const uint8_t*, sourceCode.c_str()),
+                           sourceCode.size(),
+                           whc_messenger,
+                           &ctx,
+                           optimize ? WHC_OPTIMIZE_CODE : 0);
+
+  write_object_file(outFile, unit, format);
+}
+
+
+static void
+write_dependencies(ostream&               os,
+                   const string&          outputFile,
+                   const vector<string>&  usedFiles)
+{
+  assert(usedFiles.size() > 0);
+
+  os << outputFile << " : ";
+  for (size_t i = 0; i < usedFiles.size(); ++i)
+    {
+      os << usedFiles[i];
+      if (i < usedFiles.size() - 1)
+        os << " \\\n ";
+
+      else
+        os << endl << endl;
+    }
+}
+
+
+static uint64_t
+options_hash(const CmdLineParser& args)
+{
+  uint_t langVerMaj, langVerMin;
+  wh_compiler_language_ver(&langVerMaj, &langVerMin);
+
+  ostringstream options;
+
+  options << args.ObjectFormat() << '.' << WH_FFVER_MIN << ' ' << langVerMaj << '.' << langVerMin;
+  options << (args.Optimize() ? " -O" : "") << endl;
+  for (const auto& path : args.InclusionPaths())
+    options << "-I " << path << endl;
+
+  for (const auto& tag : args.ReplacementTags())
   {
-    std::cerr << e.Message() << std::endl;
+    if (tag.mDefinitionOffset == ReplacementTag::CMDLINE_OFF)
+      options << "-D " << tag.mTagName << '=' << tag.mTagValue << endl;
   }
 
-  int retCode  = 0;
+  const string text = options.str();
+  return wh_hash(_RC(const uint8_t*, text.c_str()), text.size());
+}
+
 
+static bool
+uses_time_tags(const string& code)
+{
+  static const char tagsApplied[] = "#Tags applied:";
 
-  for (size_t i = 0; i < args.SourceFile().size(); ++i)
+  for (size_t at = code.find(tagsApplied); at != string::npos; at = code.find(tagsApplied, at))
   {
+    at += sizeof tagsApplied - 1;
 
-    ostringstream buffer;
-    vector<SourceCodeMark> codeMarks;
-    vector<string> usedFiles;
+    const string tags = code.substr(at, code.find('\n', at) - at) + ' ';
+    for (const auto tag : TIME_TAGS)
+    {
+      if (tags.find(string(" ") + tag + ' ') != string::npos)
+        return true;
+    }
+  }
 
+  return false;
+}
 
-    try
+
+//Check the manifest kept by the last compilation of the unit to find if it
+//has to be compiled again.
+static bool
+is_unit_changed(const string&   outputFile,
+                const uint64_t  optionsHash,
+                SourcesCache&   sources)
+{
+  ifstream manifest(outputFile + MANIFEST_EXT);
+  if ( ! manifest || ! whf_file_exists(outputFile.c_str()))
+    return true;
+
+  bool optionsChecked = false, sourcesChecked = false;
+
+  string line;
+  while (getline(manifest, line))
+  {
+    if (line.compare(0, sizeof MANIFEST_OPTIONS - 1, MANIFEST_OPTIONS) == 0)
     {
-      auto replacementTags = args.ReplacementTags();
-
-      if (! preprocess_source(args.SourceFile()[i],
-                              args.InclusionPaths(),
-                              replacementTags,
-                              buffer,
-                              codeMarks,
-                              usedFiles))
-        {
-          //In case of an error encountered during the processing stage its
-          //corresponding message was already displayed.
-          //Just return the error code here.
-          return -1;
-        }
-
-      if (args.JustPreprocess())
-        {
-          cout << endl << buffer.str() << endl;
-          continue ;
-        }
-      else if (args.BuildDependencies())
-        {
-          assert(usedFiles.size() > 0);
-
-          cout << args.OutputFile()[i] << " : ";
-          for (size_t i = 0; i < usedFiles.size(); ++i)
-            {
-              cout << usedFiles[i];
-              if (i < usedFiles.size() - 1)
-                cout << " \\\n ";
-
-              else
-                cout << endl << endl;
-            }
-          continue;
-        }
-
-      create_object_file(args.OutputFile()[i].c_str(), buffer.str(), codeMarks);
-      if (args.SourceFile().size () > 1)
-        cout << "Compiling of '" << args.SourceFile()[i] << "' done.\n";
+      if (stoull(line.substr(sizeof MANIFEST_OPTIONS - 1), nullptr, 16) != optionsHash)
+        return true;
+
+      optionsChecked = true;
     }
-    catch(FileException & e)
+    else if (line.compare(0, sizeof MANIFEST_HASH - 1, MANIFEST_HASH) == 0)
     {
-      std::cerr << "File IO error: " << e.Code();
+      size_t fileOff = 0;
+      const uint64_t hash = stoull(line.substr(sizeof MANIFEST_HASH - 1), &fileOff, 16);
+      const string file = line.substr(sizeof MANIFEST_HASH + fileOff);
 
-      if ( ! e.Message().empty())
-        std::cerr << ": " << e.Message() << std::endl;
+      if ( ! sources.Exists(file) || (sources.Hash(file) != hash))
+        return true;
 
-      else
-        std::cerr << '.' << std::endl;
-
-      return -1;
+      sourcesChecked = true;
     }
-    catch(FunctionalUnitException&)
+  }
+
+  return ! (optionsChecked && sourcesChecked);
+}
+
+
+static void
+write_manifest(const string&          outputFile,
+               const uint64_t         optionsHash,
+               const vector<string>&  usedFiles,
+               SourcesCache&          sources)
+{
+  ofstream manifest(outputFile + MANIFEST_EXT, ios_base::out | ios_base::trunc);
+
+  write_dependencies(manifest, outputFile, usedFiles);
+
+  manifest << MANIFEST_OPTIONS << hex << optionsHash << endl;
+  for (const auto& file : usedFiles)
+    manifest << MANIFEST_HASH << sources.Hash(file) << ' ' << file << endl;
+
+  if ( ! manifest)
+    throw FileException(_EXTRA(0), "Failed to write the manifest of '%s'.", outputFile.c_str());
+}
+
+
+//The outcomes of a unit's compilation. A fatal one stops the compilation of
+//the units not started yet.
+static const int UNIT_DONE  = 0;
+static const int UNIT_ERROR = -1;
+static const int UNIT_FATAL = -2;
+
+
+struct CompileJobs
+{
+  CompileJobs(const CmdLineParser& args)
+    : mSourceFiles(args.SourceFile()),
+      mOutputFiles(args.OutputFile()),
+      mInclusionPaths(args.InclusionPaths()),
+      mReplacementTags(args.ReplacementTags()),
+      mOptionsHash(options_hash(args)),
+      mJustPreprocess(args.JustPreprocess()),
+      mBuildDependencies(args.BuildDependencies()),
+      mIncremental(args.Incremental()),
+      mOptimize(args.Optimize()),
+      mObjectFormat(args.ObjectFormat()),
+      mNextUnit(0),
+      mResult(0),
+      mStop(false)
+  {
+  }
+
+  const vector<string>           mSourceFiles;
+  const vector<string>           mOutputFiles;
+  const vector<string>           mInclusionPaths;
+  const vector<ReplacementTag>   mReplacementTags;
+  const uint64_t                 mOptionsHash;
+  const bool                     mJustPreprocess;
+  const bool                     mBuildDependencies;
+  const bool                     mIncremental;
+  const bool                     mOptimize;
+  const uint_t                   mObjectFormat;
+
+  SourcesCache                   mSources;
+  Lock                           mSync;
+  size_t                         mNextUnit;
+  int                            mResult;
+  bool                           mStop;
+};
+
+
+static int
+compile_unit(CompileJobs& jobs, const size_t unit, ostringstream& out, ostringstream& err)
+{
+  const string& sourceFile = jobs.mSourceFiles[unit];
+  const string& outputFile = jobs.mOutputFiles[unit];
+
+  ostringstream buffer;
+  vector<SourceCodeMark> codeMarks;
+  vector<string> usedFiles;
+
+  try
+  {
+    if (jobs.mIncremental
+        && ! jobs.mJustPreprocess
+        && ! jobs.mBuildDependencies
+        && ! is_unit_changed(outputFile, jobs.mOptionsHash, jobs.mSources))
     {
-      retCode = -1;
-      cout << "Compiling of '" << args.SourceFile()[i] << "' failed.\n";
+      if (jobs.mSourceFiles.size () > 1)
+        out << "Compiling of '" << sourceFile << "' skipped as it is up to date.\n";
+
+      return UNIT_DONE;
     }
-    catch(Exception& e)
+
+    auto replacementTags = jobs.mReplacementTags;
+
+    if (! preprocess_source(sourceFile,
+                            jobs.mInclusionPaths,
+                            jobs.mSources,
+                            replacementTags,
+                            buffer,
+                            codeMarks,
+                            usedFiles))
+      {
+        //In case of an error encountered during the processing stage its
+        //corresponding message was already displayed.
+        //Just return the error code here.
+        return UNIT_FATAL;
+      }
+
+    if (jobs.mJustPreprocess)
+      {
+        out << endl << buffer.str() << endl;
+        return UNIT_DONE;
+      }
+    else if (jobs.mBuildDependencies)
+      {
+        write_dependencies(out, outputFile, usedFiles);
+        return UNIT_DONE;
+      }
+
+    const string code = buffer.str();
+
+    //Do not let a stale manifest describe the object being replaced.
+    const string manifest = outputFile + MANIFEST_EXT;
+    if (jobs.mIncremental && whf_file_exists(manifest.c_str()))
+      whf_remove(manifest.c_str());
+
+    create_object_file(outputFile.c_str(),
+                       code,
+                       codeMarks,
+                       jobs.mOptimize,
+                       jobs.mObjectFormat);
+
+    if (jobs.mIncremental && ! uses_time_tags(code))
+      write_manifest(outputFile, jobs.mOptionsHash, usedFiles, jobs.mSources);
+
+    if (jobs.mSourceFiles.size () > 1)
+      out << "Compiling of '" << sourceFile << "' done.\n";
+  }
+  catch(FileException & e)
+  {
+    err << "File IO error: " << e.Code();
+
+    if ( ! e.Message().empty())
+      err << ": " << e.Message() << std::endl;
+
+    else
+      err << '.' << std::endl;
+
+    return UNIT_FATAL;
+  }
+  catch(FunctionalUnitException&)
+  {
+    out << "Compiling of '" << sourceFile << "' failed.\n";
+    return UNIT_ERROR;
+  }
+  catch(Exception& e)
+  {
+    err << "error: " << e.Message() << std::endl;
+    err << "file:  " << e.File() << " : " << e.Line() << std::endl;
+    err << "extra: " << e.Code() << std::endl;
+
+    return UNIT_ERROR;
+  }
+  catch(std::bad_alloc&)
+  {
+    err << "Memory allocation failed!" << std::endl;
+
+    return UNIT_ERROR;
+  }
+  catch(...)
+  {
+    err << "Unknown exception thrown!" << std::endl;
+
+    return UNIT_ERROR;
+  }
+
+  return UNIT_DONE;
+}
+
+
+static void
+compile_units(void* const args)
+{
+  auto& jobs = *_RC(CompileJobs*, args);
+
+  while (true)
+  {
+    size_t unit;
     {
-      std::cerr << "error: " << e.Message() << std::endl;
-      std::cerr << "file:  " << e.File() << " : " << e.Line() << std::endl;
-      std::cerr << "extra: " << e.Code() << std::endl;
+      LockGuard<Lock> _l(jobs.mSync);
+      if (jobs.mStop || (jobs.mNextUnit >= jobs.mSourceFiles.size()))
+        return;
 
-      retCode = -1;
+      unit = jobs.mNextUnit++;
     }
-    catch(std::bad_alloc&)
+
+    ostringstream out, err;
+    const int result = compile_unit(jobs, unit, out, err);
+
+    LockGuard<Lock> _l(jobs.mSync);
+
+    cout << out.str() << flush;
+    cerr << err.str() << flush;
+
+    if (result != UNIT_DONE)
     {
-      std::cerr << "Memory allocation failed!" << std::endl;
+      jobs.mResult = -1;
+      jobs.mStop |= (result == UNIT_FATAL);
+    }
+  }
+}
+
+
+//Write the objects keeping only what is reached from the entries named in
+//the command line.
+static int
+strip_objects(const CmdLineParser& args)
+{
+  const auto inputs = args.SourceFile();
+  const auto outputs = args.OutputFile();
+
+  try
+  {
+    vector<unique_ptr<CompiledFileUnit>> units;
+    vector<WIFunctionalUnit*> unitsRefs;
 
-      retCode = -1;
+    for (const auto& input : inputs)
+    {
+      units.push_back(unique_ptr<CompiledFileUnit>(new CompiledFileUnit(input.c_str())));
+      unitsRefs.push_back(units.back().get());
     }
-    catch(...)
+
+    vector<unique_ptr<StrippedUnit>> stripped;
+    strip_units(unitsRefs, args.StripEntries(), stripped);
+
+    for (size_t i = 0; i < stripped.size(); ++i)
     {
-      std::cerr << "Unknown exception thrown!" << std::endl;
+      write_object_file(outputs[i].c_str(), *stripped[i], args.ObjectFormat());
 
-      retCode = -1;
+      cout << "Stripping of '" << inputs[i] << "' kept "
+           << stripped[i]->ProceduresCount() << " of "
+           << units[i]->ProceduresCount() << " procedures and "
+           << stripped[i]->GlobalsCount() << " of "
+           << units[i]->GlobalsCount() << " globals.\n";
     }
+  }
+  catch(FileException & e)
+  {
+    cerr << "File IO error: " << e.Code();
+
+    if ( ! e.Message().empty())
+      cerr << ": " << e.Message() << std::endl;
+
+    else
+      cerr << '.' << std::endl;
 
+    return UNIT_FATAL;
   }
+  catch(Exception& e)
+  {
+    cerr << "error: " << e.Message() << std::endl;
+    return UNIT_ERROR;
+  }
+  catch(std::bad_alloc&)
+  {
+    cerr << "Memory allocation failed!" << std::endl;
+    return UNIT_ERROR;
+  }
+
+  return UNIT_DONE;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  CmdLineParser args(argc, argv);
+
+  try
+  {
+    args.Parse();
+  }
+  catch(CmdLineException& e)
+  {
+    std::cerr << e.Message() << std::endl;
+  }
+
+  if (args.Strip())
+    return strip_objects(args);
+
+  CompileJobs jobs(args);
+
+  //The units compiled in parallel share the content of the included files.
+  //Their preprocessed code is not shared as it depends on the tags defined
+  //by each unit before the inclusion.
+  const size_t threadsCount = min<size_t>(args.JobsCount(), jobs.mSourceFiles.size());
+  vector<unique_ptr<Thread>> threads;
+
+  try
+  {
+    for (size_t i = 1; i < threadsCount; ++i)
+    {
+      threads.push_back(unique_ptr<Thread>(new Thread()));
+      threads.back()->Run(compile_units, &jobs);
+    }
+  }
+  catch(...)
+  {
+    std::cerr << "Could not start all the compiling jobs." << std::endl;
+  }
+
+  compile_units(&jobs);
+
+  for (auto& thread : threads)
+    thread->WaitToEnd(false);
 
-  return retCode;
+  return jobs.mResult;
 }
 
 
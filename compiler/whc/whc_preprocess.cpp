@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "whc_preprocess.h"
 #include "utils/wfile.h"
+#include "utils/whash.h"
 #include "utils/tokenizer.h"
 
 #include "msglog.h"
@@ -65,6 +66,63 @@ static const char cmdUndefine[]    = "#@undefine";
 static const uint_t MAX_INCLUDED_LEVELS = 256;
 
 
+const SourcesCache::Source&
+SourcesCache::Retrieve(const string& file)
+{
+  {
+    LockGuard<Lock> _l(mSync);
+
+    const auto cached = mSources.find(file);
+    if (cached != mSources.end())
+      return cached->second;
+  }
+
+  //Read it without holding the lock, as the other threads may want other
+  //files meanwhile. The sources are never removed from the cache, hence
+  //the returned references remain valid.
+  Source source;
+  File sourceFile(file.c_str(), WH_FILEREAD);
+
+  source.mContent.resize(sourceFile.Size(), ' ');
+  sourceFile.Read(_CC(uint8_t*, _RC(const uint8_t*, source.mContent.c_str())),
+                  source.mContent.size());
+  source.mHash = wh_hash(_RC(const uint8_t*, source.mContent.c_str()), source.mContent.size());
+
+  LockGuard<Lock> _l(mSync);
+  return mSources.emplace(file, std::move(source)).first->second;
+}
+
+
+const string&
+SourcesCache::Content(const string& file)
+{
+  return Retrieve(file).mContent;
+}
+
+
+uint64_t
+SourcesCache::Hash(const string& file)
+{
+  return Retrieve(file).mHash;
+}
+
+
+bool
+SourcesCache::Exists(const string& file)
+{
+  LockGuard<Lock> _l(mSync);
+
+  const auto cached = mExistences.find(file);
+  if (cached != mExistences.end())
+    return cached->second;
+
+  const bool result = whf_file_exists(file.c_str());
+  mExistences.emplace(file, result);
+
+  return result;
+}
+
+
 
 static void
 print_err_include_to_deep(vector<SourceCodeMark>&   codeMarks,
@@ -98,11 +156,15 @@ print_err_no_include(vector<SourceCodeMark>&   codeMarks,
 
   if (inclusionPaths.size() > 1)
     {
-      //Ignore the first entry as is always the current directory;
-      cerr << "\tI looked for it in current directory and:\n";
+      //Ignore the first entry as is always the current directory. Write it
+      //at once, as other units may be compiled in parallel.
+      ostringstream paths;
+      paths << "\tI looked for it in current directory and:\n";
 
       for (uint_t i = 1; i < inclusionPaths.size(); ++i)
-        cerr << "\t\t"  << inclusionPaths[i].c_str() << endl;
+        paths << "\t\t"  << inclusionPaths[i].c_str() << endl;
+
+      cerr << paths.str();
     }
 }
 
@@ -438,6 +500,7 @@ process_line_tags(const string&                     file,
 
 static void
 search_for_header_file(const vector<string>&    inclusionPaths,
+                        SourcesCache&            sources,
                         string&                  fileName,
                         vector<string>&          foundFiles)
 {
@@ -449,7 +512,7 @@ search_for_header_file(const vector<string>&    inclusionPaths,
 
       NormalizeFilePath(file, false);
 
-      if (whf_file_exists(file.c_str()))
+      if (sources.Exists(file))
         foundFiles.push_back(file);
     }
 }
@@ -478,6 +541,7 @@ check_preprocess_tag(const char* line,
 static bool
 preprocess_directives(const string&                    file,
                        const vector<string>&            inclusionPaths,
+                       SourcesCache&                    sources,
                        vector<string>&                  includedGuards,
                        vector<ReplacementTag>&          tagPairs,
                        const uint_t                     levelSize,
@@ -585,7 +649,7 @@ preprocess_directives(const string&                    file,
       }
 
       vector<string> foundFiles;
-      search_for_header_file(inclusionPaths, includeName, foundFiles);
+      search_for_header_file(inclusionPaths, sources, includeName, foundFiles);
 
       if (foundFiles.size() > 1)
       {
@@ -598,14 +662,7 @@ preprocess_directives(const string&                    file,
         return false;
       }
 
-      File includedFile(foundFiles[0].c_str(), WH_FILEREAD);
-      string includeContent;
-
-      includeContent.resize(includedFile.Size(), ' ');
-
-      includedFile.Read(_CC(uint8_t*, _RC(const uint8_t*, includeContent.c_str())),
-                        includeContent.size());
-
+      const string& includeContent = sources.Content(foundFiles[0]);
       const char* const guard = strstr(includeContent.c_str(), cmdGuard);
 
       string guardValue;
@@ -652,6 +709,7 @@ preprocess_directives(const string&                    file,
         istringstream includedSource(includeContent);
         if ( !preprocess_directives(foundFiles[0],
                                     inclusionPaths,
+                                    sources,
                                     includedGuards,
                                     tagPairs,
                                     levelSize + 1,
@@ -685,6 +743,7 @@ preprocess_directives(const string&                    file,
 bool
 preprocess_source(const string&                  sourceFile,
                    const vector<string>&          inclusionPaths,
+                   SourcesCache&                  sources,
                    vector<ReplacementTag>&        tagPairs,
                    ostringstream&                 sourceCode,
                    vector<SourceCodeMark>&        codeMarks,
@@ -692,14 +751,7 @@ preprocess_source(const string&                  sourceFile,
 {
   usedFiles.resize(0);
 
-  File source(sourceFile.c_str(), WH_FILEREAD);
-  const uint_t fileSize = source.Size();
-
-  string fileContent;
-  fileContent.resize(fileSize, ' ');
-  source.Read(_CC(uint8_t*,
-                    _RC(const uint8_t*, fileContent.c_str())), fileSize);
-
+  const string& fileContent = sources.Content(sourceFile);
 
   vector<string> includedGuards;
   const char* const guard = strstr(fileContent.c_str(), cmdGuard);
@@ -723,6 +775,7 @@ preprocess_source(const string&                  sourceFile,
 
   return preprocess_directives(sourceFile,
                                inclusionPaths,
+                               sources,
                                includedGuards,
                                tagPairs,
                                0,
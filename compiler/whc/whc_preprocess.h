@@ -26,10 +26,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define __WHC_PREPROCESS_H
 
 
+#include <map>
 #include <vector>
 #include <string>
 
 #include "whais.h"
+#include "utils/wthread.h"
 #include "msglog.h"
 
 
@@ -53,9 +55,41 @@ struct ReplacementTag
 };
 
 
+//Keeps the content of the source files once read, so the files included by
+//several units are read and hashed only once. It may be shared by the
+//threads compiling the units in parallel.
+class SourcesCache
+{
+public:
+  SourcesCache() = default;
+  SourcesCache(const SourcesCache&) = delete;
+  SourcesCache& operator= (const SourcesCache&) = delete;
+
+  //Throws a file exception if the file could not be read.
+  const std::string& Content(const std::string& file);
+  uint64_t           Hash(const std::string& file);
+
+  bool Exists(const std::string& file);
+
+private:
+  struct Source
+  {
+    std::string mContent;
+    uint64_t    mHash;
+  };
+
+  const Source& Retrieve(const std::string& file);
+
+  whais::Lock                     mSync;
+  std::map<std::string, Source>   mSources;
+  std::map<std::string, bool>     mExistences;
+};
+
+
 bool
 preprocess_source(const std::string&               sourceFile,
                   const std::vector<std::string>&  inclusionPaths,
+                  SourcesCache&                    sources,
                   std::vector<ReplacementTag>&     tagPairs,
                   std::ostringstream&              sourceCode,
                   std::vector<SourceCodeMark>&     codeMarks,
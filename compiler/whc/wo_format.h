@@ -29,9 +29,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 const uint8_t WH_SIGNATURE[] = { 'W', 'O' };
-const int8_t WH_FFVER_MAJ = 1;
+const int8_t WH_FFVER_MAJ = 2;
 const int8_t WH_FFVER_MIN = 0;
 
+//The first version of the format, with the procedures' code and locals kept
+//as they are loaded in memory. Still written by default, as the servers
+//older than the version 2 objects can load only these.
+const int8_t WH_FFVER_MAJ_FIXED = 1;
+
 const uint_t WHC_SIGNATURE_OFF         = 0;
 const uint_t WHC_FORMATMMAJ_OFF        = 2;
 const uint_t WHC_FORMATMIN_OFF         = 3;
@@ -61,6 +66,12 @@ const uint_t WHC_PROC_ENTRY_NPARMS_OFF   = 14;
 const uint_t WHC_PROC_ENTRY_CODE_SIZE    = 16;
 const uint_t WHC_PROC_ENTRY_SIZE         = 20;
 
+//Starting with version 2 the procedures' bodies are compacted, so their size
+//on disk is kept along with the size of the code they expand to. The symbols
+//area holds the constant area followed by the names not found in it.
+const uint_t WHC_PROC_ENTRY_BODY_SIZE_OFF = 20;
+const uint_t WHC_PROC_ENTRY_V2_SIZE       = 24;
+
 const uint_t WHC_PROC_BODY_LOCAL_ENTRY_SIZE   = sizeof(uint32_t);
 const uint_t WHC_PROC_BODY_SYNCS_ENTRY_SYZE   = sizeof(uint8_t);
 
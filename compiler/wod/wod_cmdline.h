@@ -43,6 +43,7 @@ public:
   ~CmdLineParser();
 
   auto SourceFile() const { return mSourceFile; }
+  auto ProfileFile() const { return mProfileFile; }
   auto& OutStream() const { return *mOutStream; }
 
 private:
@@ -54,6 +55,7 @@ private:
   int            mArgCount;
   char**         mArgs;
   const char    *mSourceFile;
+  const char    *mProfileFile;
   std::ostream  *mOutStream;
   bool           mShowHelp;
   bool           mShowLogo;
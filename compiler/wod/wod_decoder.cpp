@@ -556,6 +556,87 @@ const FDECODE_OPCODE wod_dec_w_ajoin  = wod_dec_w_ldi8;
 const FDECODE_OPCODE wod_dec_w_afout  = wod_dec_w_ldi8;
 const FDECODE_OPCODE wod_dec_w_afin   = wod_dec_w_ldi8;
 
+const FDECODE_OPCODE wod_dec_w_addi8  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addi16 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addi32 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addi64 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addu8  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addu16 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addu32 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_addu64 = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_subi8  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subi16 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subi32 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subi64 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subu8  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subu16 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subu32 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_subu64 = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_muli8  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_muli16 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_muli32 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_muli64 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_mulu8  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_mulu16 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_mulu32 = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_mulu64 = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_eqi8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_eqi16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_eqi32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_eqi64  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_equ8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_equ16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_equ32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_equ64  = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_nei8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_nei16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_nei32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_nei64  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_neu8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_neu16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_neu32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_neu64  = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_lti8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_lti16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_lti32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_lti64  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_ltu8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_ltu16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_ltu32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_ltu64  = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_lei8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_lei16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_lei32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_lei64  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_leu8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_leu16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_leu32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_leu64  = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_gti8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gti16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gti32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gti64  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gtu8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gtu16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gtu32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gtu64  = wod_dec_w_no_ops;
+
+const FDECODE_OPCODE wod_dec_w_gei8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gei16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gei32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_gei64  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_geu8   = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_geu16  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_geu32  = wod_dec_w_no_ops;
+const FDECODE_OPCODE wod_dec_w_geu64  = wod_dec_w_no_ops;
+
 
 FDECODE_OPCODE wod_decode_table[] = {
   wod_dec_w_na,
@@ -741,7 +822,88 @@ FDECODE_OPCODE wod_decode_table[] = {
 
   wod_dec_w_ajoin,
   wod_dec_w_afout,
-  wod_dec_w_afin
+  wod_dec_w_afin,
+
+  wod_dec_w_addi8,
+  wod_dec_w_addi16,
+  wod_dec_w_addi32,
+  wod_dec_w_addi64,
+  wod_dec_w_addu8,
+  wod_dec_w_addu16,
+  wod_dec_w_addu32,
+  wod_dec_w_addu64,
+
+  wod_dec_w_subi8,
+  wod_dec_w_subi16,
+  wod_dec_w_subi32,
+  wod_dec_w_subi64,
+  wod_dec_w_subu8,
+  wod_dec_w_subu16,
+  wod_dec_w_subu32,
+  wod_dec_w_subu64,
+
+  wod_dec_w_muli8,
+  wod_dec_w_muli16,
+  wod_dec_w_muli32,
+  wod_dec_w_muli64,
+  wod_dec_w_mulu8,
+  wod_dec_w_mulu16,
+  wod_dec_w_mulu32,
+  wod_dec_w_mulu64,
+
+  wod_dec_w_eqi8,
+  wod_dec_w_eqi16,
+  wod_dec_w_eqi32,
+  wod_dec_w_eqi64,
+  wod_dec_w_equ8,
+  wod_dec_w_equ16,
+  wod_dec_w_equ32,
+  wod_dec_w_equ64,
+
+  wod_dec_w_nei8,
+  wod_dec_w_nei16,
+  wod_dec_w_nei32,
+  wod_dec_w_nei64,
+  wod_dec_w_neu8,
+  wod_dec_w_neu16,
+  wod_dec_w_neu32,
+  wod_dec_w_neu64,
+
+  wod_dec_w_lti8,
+  wod_dec_w_lti16,
+  wod_dec_w_lti32,
+  wod_dec_w_lti64,
+  wod_dec_w_ltu8,
+  wod_dec_w_ltu16,
+  wod_dec_w_ltu32,
+  wod_dec_w_ltu64,
+
+  wod_dec_w_lei8,
+  wod_dec_w_lei16,
+  wod_dec_w_lei32,
+  wod_dec_w_lei64,
+  wod_dec_w_leu8,
+  wod_dec_w_leu16,
+  wod_dec_w_leu32,
+  wod_dec_w_leu64,
+
+  wod_dec_w_gti8,
+  wod_dec_w_gti16,
+  wod_dec_w_gti32,
+  wod_dec_w_gti64,
+  wod_dec_w_gtu8,
+  wod_dec_w_gtu16,
+  wod_dec_w_gtu32,
+  wod_dec_w_gtu64,
+
+  wod_dec_w_gei8,
+  wod_dec_w_gei16,
+  wod_dec_w_gei32,
+  wod_dec_w_gei64,
+  wod_dec_w_geu8,
+  wod_dec_w_geu16,
+  wod_dec_w_geu32,
+  wod_dec_w_geu64
 };
 
 const char *wod_str_table[] = {
@@ -928,14 +1090,90 @@ const char *wod_str_table[] = {
 
   "carr",
 
-  "adda",
-  "suba",
-  "moda",
-
   "ajoin",
   "afout",
-  "afin"
-
+  "afin",
+
+  "addi8",
+  "addi16",
+  "addi32",
+  "addi64",
+  "addu8",
+  "addu16",
+  "addu32",
+  "addu64",
+
+  "subi8",
+  "subi16",
+  "subi32",
+  "subi64",
+  "subu8",
+  "subu16",
+  "subu32",
+  "subu64",
+
+  "muli8",
+  "muli16",
+  "muli32",
+  "muli64",
+  "mulu8",
+  "mulu16",
+  "mulu32",
+  "mulu64",
+
+  "eqi8",
+  "eqi16",
+  "eqi32",
+  "eqi64",
+  "equ8",
+  "equ16",
+  "equ32",
+  "equ64",
+
+  "nei8",
+  "nei16",
+  "nei32",
+  "nei64",
+  "neu8",
+  "neu16",
+  "neu32",
+  "neu64",
+
+  "lti8",
+  "lti16",
+  "lti32",
+  "lti64",
+  "ltu8",
+  "ltu16",
+  "ltu32",
+  "ltu64",
+
+  "lei8",
+  "lei16",
+  "lei32",
+  "lei64",
+  "leu8",
+  "leu16",
+  "leu32",
+  "leu64",
+
+  "gti8",
+  "gti16",
+  "gti32",
+  "gti64",
+  "gtu8",
+  "gtu16",
+  "gtu32",
+  "gtu64",
+
+  "gei8",
+  "gei16",
+  "gei32",
+  "gei64",
+  "geu8",
+  "geu16",
+  "geu32",
+  "geu64"
 };
 
 } //namespace wod
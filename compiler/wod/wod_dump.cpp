@@ -23,7 +23,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
 #include <assert.h>
+#include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <string.h>
 
 #include "utils/endianness.h"
@@ -41,6 +43,70 @@ namespace wod {
 static const uint_t HEADER_FIELD_LENGTH     = 32;
 static const uint_t HEADER_SEPARATOR_LENGTH = 80;
 
+
+void
+wod_load_profile(const char* const fileName, PROFILE& outProfile)
+{
+  ifstream input(fileName);
+  if ( ! input)
+    throw DumpException(_EXTRA(0), "Cannot open the profile file '%s'.", fileName);
+
+  string line;
+  uint_t lineNumber = 0;
+
+  while (getline(input, line))
+  {
+    istringstream fields(line);
+    string kind, name;
+
+    ++lineNumber;
+
+    if ( ! (fields >> kind))
+      continue;
+
+    bool valid = false;
+    if (kind == "PROC")
+    {
+      ProcProfile entry;
+
+      if (fields >> name
+                 >> entry.mCalls
+                 >> entry.mInstructions
+                 >> entry.mInclusiveTime
+                 >> entry.mExclusiveTime)
+      {
+        ProcProfile& profile = outProfile[name];
+
+        profile.mCalls          = entry.mCalls;
+        profile.mInstructions   = entry.mInstructions;
+        profile.mInclusiveTime  = entry.mInclusiveTime;
+        profile.mExclusiveTime  = entry.mExclusiveTime;
+        valid = true;
+      }
+    }
+    else if (kind == "AT")
+    {
+      uint_t pos;
+      uint64_t count;
+
+      if (fields >> name >> pos >> count)
+      {
+        outProfile[name].mCounts[pos] += count;
+        valid = true;
+      }
+    }
+
+    if ( ! valid)
+    {
+      throw DumpException(_EXTRA(0),
+                          "Invalid entry at line %u of the profile file '%s'.",
+                          lineNumber,
+                          fileName);
+    }
+  }
+}
+
+
 void
 wod_dump_header(File& obj, ostream& output)
 {
@@ -400,10 +466,11 @@ wod_dump_globals_tables(WIFunctionalUnit& obj, ostream& output)
 
 
 static void
-wod_dump_code(const uint8_t  *code,
-              const uint_t    codeSize,
-              ostream&        output,
-              const char*     prefix)
+wod_dump_code(const uint8_t       *code,
+              const uint_t         codeSize,
+              ostream&             output,
+              const char*          prefix,
+              const ProcProfile*   profile)
 {
   static char conv[] = "0123456789ABCDEF";
   uint_t currPos = 0;
@@ -440,6 +507,21 @@ wod_dump_code(const uint8_t  *code,
     if (operand2[0] != 0)
       output << ", " << operand2;
 
+    if (profile != nullptr)
+    {
+      auto count = profile->mCounts.find(currPos);
+      if (count != profile->mCounts.end())
+      {
+        output << "\t\t; executed " << count->second;
+
+        if (profile->mInstructions > 0)
+        {
+          output << " (" << fixed << setprecision(1)
+                 << 100.0 * count->second / profile->mInstructions << "%)";
+        }
+      }
+    }
+
     output << endl;
 
     code += instrSize, currPos += instrSize;
@@ -450,7 +532,10 @@ wod_dump_code(const uint8_t  *code,
 
 
 void
-wod_dump_procs(WIFunctionalUnit& obj, ostream& output, bool_t showCode)
+wod_dump_procs(WIFunctionalUnit&   obj,
+               ostream&            output,
+               bool_t              showCode,
+               const PROFILE*      profile)
 {
 
   output << endl << endl << setw(HEADER_SEPARATOR_LENGTH) << setfill('*')
@@ -490,6 +575,21 @@ wod_dump_procs(WIFunctionalUnit& obj, ostream& output, bool_t showCode)
       output << endl;
     }
 
+    const ProcProfile* procProfile = nullptr;
+    if (profile != nullptr)
+    {
+      auto entry = profile->find(_RC(const char*, obj.RetriveProcName(proc)));
+      if (entry != profile->end())
+      {
+        procProfile = &entry->second;
+
+        output << "profile\t\t\tcalls " << procProfile->mCalls
+               << ", instructions " << procProfile->mInstructions
+               << ", inclusive time " << procProfile->mInclusiveTime
+               << "us, exclusive time " << procProfile->mExclusiveTime << "us" << endl;
+      }
+    }
+
     if (!externalProc)
     {
       output << endl << "Code:" << endl;
@@ -497,7 +597,8 @@ wod_dump_procs(WIFunctionalUnit& obj, ostream& output, bool_t showCode)
       wod_dump_code(obj.RetriveProcCodeArea(proc),
                     obj.ProcCodeAreaSize(proc),
                     output,
-                    obj.RetriveProcName(proc));
+                    obj.RetriveProcName(proc),
+                    procProfile);
     }
     output << endl << endl;
   }
@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define WOD_DUMP_H_
 
 #include <iostream>
+#include <map>
+#include <string>
 
 #include "whais.h"
 #include "compiler/wopcodes.h"
@@ -78,6 +80,22 @@ typedef uint_t(*FDECODE_OPCODE) (const uint8_t  *args,
 extern FDECODE_OPCODE   wod_decode_table[];
 extern const char*      wod_str_table[];
 
+//A procedure's profile, as it was written by the 'profile' command of wcmd.
+struct ProcProfile
+{
+  uint64_t                    mCalls;
+  uint64_t                    mInstructions;
+  uint64_t                    mInclusiveTime;
+  uint64_t                    mExclusiveTime;
+  std::map<uint_t, uint64_t>  mCounts;  //Executions by code position.
+};
+
+typedef std::map<std::string, ProcProfile> PROFILE;
+
+
+void
+wod_load_profile(const char* const fileName, PROFILE& outProfile);
+
 void
 wod_dump_header(File& obj, std::ostream& output);
 
@@ -90,7 +108,8 @@ wod_dump_globals_tables(WIFunctionalUnit& unit, std::ostream& output);
 void
 wod_dump_procs(WIFunctionalUnit&   unit,
                std::ostream&       output,
-               bool_t              showCode);
+               bool_t              showCode,
+               const PROFILE*      profile = nullptr);
 
 
 } //namespace wod
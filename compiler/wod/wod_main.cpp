@@ -51,11 +51,18 @@ main(int argc, char **argv)
       wod_dump_header(inFileObj, cmdLine.OutStream());
     }
 
+    PROFILE profile;
+    if (cmdLine.ProfileFile() != nullptr)
+      wod_load_profile(cmdLine.ProfileFile(), profile);
+
     CompiledFileUnit inUnit(cmdLine.SourceFile());
 
     wod_dump_const_area(inUnit, cmdLine.OutStream());
     wod_dump_globals_tables(inUnit, cmdLine.OutStream());
-    wod_dump_procs(inUnit, cmdLine.OutStream(), false);
+    wod_dump_procs(inUnit,
+                   cmdLine.OutStream(),
+                   false,
+                   (cmdLine.ProfileFile() != nullptr) ? &profile : nullptr);
 
   }
   catch (FunctionalUnitException& e)
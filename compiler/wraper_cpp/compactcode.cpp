@@ -0,0 +1,335 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "compiler/compactcode.h"
+#include "compiler/compiledunit.h"
+#include "compiler/wopcodes.h"
+#include "utils/endianness.h"
+
+
+using namespace std;
+
+namespace whais {
+
+
+//How the arguments following an opcode are kept in the compact code.
+enum ARG_KIND
+{
+  ARG_NONE,    //No arguments.
+  ARG_FIXED,   //Copied as they are.
+  ARG_INDEX,   //An unsigned index or offset, stored as a varint.
+  ARG_JUMP     //A relative jump, stored as the zigzag varint of the
+               //instructions count to its target.
+};
+
+
+static ARG_KIND
+opcode_args(const uint_t opcode, uint_t& outSize)
+{
+  switch (opcode)
+  {
+  case W_LDNULL:
+  case W_LDI8:
+  case W_LDLO8:
+  case W_LDGB8:
+  case W_CTS:
+  case W_BSYNC:
+  case W_ESYNC:
+  case W_AJOIN:
+  case W_AFOUT:
+  case W_AFIN:
+    outSize = sizeof(uint8_t);
+    return ARG_FIXED;
+
+  case W_LDI16:
+    outSize = sizeof(uint16_t);
+    return ARG_FIXED;
+
+  case W_LDI32:
+  case W_LDD:
+    outSize = sizeof(uint32_t);
+    return ARG_FIXED;
+
+  case W_LDI64:
+    outSize = sizeof(uint64_t);
+    return ARG_FIXED;
+
+  case W_LDDT:
+    outSize = 5 + sizeof(uint16_t);
+    return ARG_FIXED;
+
+  case W_LDHT:
+    outSize = sizeof(uint32_t) + 5 + sizeof(uint16_t);
+    return ARG_FIXED;
+
+  case W_LDRR:
+    outSize = sizeof(uint64_t) + sizeof(uint64_t);
+    return ARG_FIXED;
+
+  case W_CARR:
+    outSize = sizeof(uint8_t) + sizeof(uint16_t);
+    return ARG_FIXED;
+
+  case W_LDLO16:
+  case W_LDGB16:
+    outSize = sizeof(uint16_t);
+    return ARG_INDEX;
+
+  case W_LDC:
+  case W_LDT:
+  case W_LDLO32:
+  case W_LDGB32:
+  case W_CALL:
+  case W_INDTA:
+  case W_SELF:
+    outSize = sizeof(uint32_t);
+    return ARG_INDEX;
+
+  case W_JF:
+  case W_JFC:
+  case W_JT:
+  case W_JTC:
+  case W_JMP:
+    outSize = sizeof(uint32_t);
+    return ARG_JUMP;
+
+  default:
+    if (opcode >= W_OP_END_MARK)
+      throw FunctionalUnitException(_EXTRA(0), "Invalid opcode %u in a procedure's code.", opcode);
+
+    outSize = 0;
+    return ARG_NONE;
+  }
+}
+
+
+static uint64_t
+load_le_arg(const uint8_t* const from, const uint_t size)
+{
+  switch (size)
+  {
+  case sizeof(uint8_t):
+    return from[0];
+
+  case sizeof(uint16_t):
+    return load_le_int16(from);
+
+  default:
+    assert(size == sizeof(uint32_t));
+    return load_le_int32(from);
+  }
+}
+
+
+static void
+store_le_arg(const uint64_t value, const uint_t size, uint8_t* const to)
+{
+  if ((size < sizeof(uint64_t)) && ((value >> (size * 8)) != 0))
+    throw FunctionalUnitException(_EXTRA(0), "A compact code argument is out of range.");
+
+  switch (size)
+  {
+  case sizeof(uint8_t):
+    to[0] = _SC(uint8_t, value);
+    break;
+
+  case sizeof(uint16_t):
+    store_le_int16(_SC(uint16_t, value), to);
+    break;
+
+  default:
+    assert(size == sizeof(uint32_t));
+    store_le_int32(_SC(uint32_t, value), to);
+  }
+}
+
+
+uint_t
+code_args_size(const uint_t opcode)
+{
+  uint_t size;
+
+  opcode_args(opcode, size);
+
+  return size;
+}
+
+
+void
+store_varint(uint64_t value, vector<uint8_t>& out)
+{
+  while (value >= 0x80)
+  {
+    out.push_back(_SC(uint8_t, value | 0x80));
+    value >>= 7;
+  }
+
+  out.push_back(_SC(uint8_t, value));
+}
+
+
+uint_t
+load_varint(const uint8_t* const data, const uint64_t size, uint64_t& outValue)
+{
+  outValue = 0;
+  for (uint_t i = 0, shift = 0; shift < 64; ++i, shift += 7)
+  {
+    if (i >= size)
+      break;
+
+    outValue |= _SC(uint64_t, data[i] & 0x7F) << shift;
+    if ((data[i] & 0x80) == 0)
+      return i + 1;
+  }
+
+  throw FunctionalUnitException(_EXTRA(0), "A compact code value is truncated.");
+}
+
+
+void
+compact_proc_code(const uint8_t* const  code,
+                  const uint_t          codeSize,
+                  vector<uint8_t>&      out)
+{
+  //Index the instructions first, to find the jumps' targets.
+  vector<int64_t> instrIndex(codeSize + 1, -1);
+  int64_t count = 0;
+
+  for (uint_t pos = 0; pos < codeSize; ++count)
+  {
+    uint_t argsSize;
+
+    opcode_args(code[pos], argsSize);
+    instrIndex[pos] = count;
+
+    pos += 1 + argsSize;
+    if (pos > codeSize)
+      throw FunctionalUnitException(_EXTRA(0), "A procedure's code is truncated.");
+  }
+  instrIndex[codeSize] = count;
+
+  for (uint_t pos = 0; pos < codeSize; )
+  {
+    const uint8_t* const args = code + pos + 1;
+    uint_t argsSize;
+
+    const ARG_KIND kind = opcode_args(code[pos], argsSize);
+
+    out.push_back(code[pos]);
+    if (kind == ARG_FIXED)
+      out.insert(out.end(), args, args + argsSize);
+
+    else if (kind == ARG_INDEX)
+      store_varint(load_le_arg(args, argsSize), out);
+
+    else if (kind == ARG_JUMP)
+    {
+      const int64_t target = _SC(int64_t, pos) + _SC(int32_t, load_le_int32(args));
+      if ((target < 0) || (target > codeSize) || (instrIndex[target] < 0))
+        throw FunctionalUnitException(_EXTRA(0), "A jump of a procedure's code has an invalid target.");
+
+      const int64_t delta = instrIndex[target] - instrIndex[pos];
+      store_varint((_SC(uint64_t, delta) << 1) ^ _SC(uint64_t, delta >> 63), out);
+    }
+
+    pos += 1 + argsSize;
+  }
+}
+
+
+void
+expand_proc_code(const uint8_t* const  compact,
+                 const uint_t          compactSize,
+                 uint8_t* const        out,
+                 const uint_t          codeSize)
+{
+  //The positions of the expanded instructions, to restore the jumps.
+  vector<uint32_t> positions;
+  uint64_t expandedSize = 0;
+
+  for (uint_t pos = 0; pos < compactSize; )
+  {
+    uint_t argsSize;
+    uint64_t value;
+
+    const ARG_KIND kind = opcode_args(compact[pos], argsSize);
+
+    positions.push_back(_SC(uint32_t, expandedSize));
+    expandedSize += 1 + argsSize;
+    if (expandedSize > codeSize)
+      throw FunctionalUnitException(_EXTRA(0), "A compact code expands past its size.");
+
+    if ((kind == ARG_INDEX) || (kind == ARG_JUMP))
+      pos += 1 + load_varint(compact + pos + 1, _SC(uint64_t, compactSize) - pos - 1, value);
+
+    else if (pos + 1 + argsSize <= compactSize)
+      pos += 1 + argsSize;
+
+    else
+      throw FunctionalUnitException(_EXTRA(0), "A compact code is truncated.");
+  }
+
+  if (expandedSize != codeSize)
+    throw FunctionalUnitException(_EXTRA(0), "A compact code does not expand to its size.");
+
+  positions.push_back(codeSize);
+
+  const int64_t count = positions.size() - 1;
+  for (uint_t pos = 0, index = 0; pos < compactSize; ++index)
+  {
+    uint8_t* const instr = out + positions[index];
+    uint_t argsSize;
+    uint64_t value;
+
+    const ARG_KIND kind = opcode_args(compact[pos], argsSize);
+
+    instr[0] = compact[pos++];
+    if (kind == ARG_FIXED)
+    {
+      memcpy(instr + 1, compact + pos, argsSize);
+      pos += argsSize;
+    }
+    else if (kind == ARG_INDEX)
+    {
+      pos += load_varint(compact + pos, compactSize - pos, value);
+      store_le_arg(value, argsSize, instr + 1);
+    }
+    else if (kind == ARG_JUMP)
+    {
+      pos += load_varint(compact + pos, compactSize - pos, value);
+
+      const int64_t target = index + _SC(int64_t, (value >> 1) ^ (0 - (value & 1)));
+      if ((target < 0) || (target > count))
+        throw FunctionalUnitException(_EXTRA(0), "A compact code jump has an invalid target.");
+
+      store_le_int32(positions[target] - positions[index], instr + 1);
+    }
+  }
+}
+
+
+} //namespace whais
@@ -22,11 +22,15 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <algorithm>
 #include <assert.h>
 #include <string.h>
+#include <string>
 
+#include "compiler/compactcode.h"
 #include "compiler/compiledunit.h"
 #include "utils/endianness.h"
+#include "utils/whash.h"
 #include "../whc/wo_format.h"
 
 
@@ -38,18 +42,27 @@ WIFunctionalUnit::~WIFunctionalUnit()
 }
 
 
+bool_t
+WIFunctionalUnit::IsCodeVerified()
+{
+  return FALSE;
+}
+
+
 /////////////******CompiledBufferUnit********//////////////////////////////
 
 CompiledBufferUnit::CompiledBufferUnit(const uint8_t      *buffer,
                                        uint_t              bufferSize,
                                        WH_MESSENGER        messenger,
-                                       WH_MESSENGER_CTXT   messengerContext)
+                                       WH_MESSENGER_CTXT   messengerContext,
+                                       const uint_t        options)
   : mHandler(nullptr)
 {
-  mHandler = wh_compiler_load(_RC(const char*, buffer),
-                              bufferSize,
-                              messenger,
-                              messengerContext);
+  mHandler = wh_compiler_load_options(_RC(const char*, buffer),
+                                      bufferSize,
+                                      messenger,
+                                      messengerContext,
+                                      options);
   if (mHandler == nullptr)
     throw FunctionalUnitException(_EXTRA(0), "Buffer could not be compiled.");
 }
@@ -356,6 +369,7 @@ CompiledBufferUnit::IsProcExternal(uint_t procId)
 
 CompiledFileUnit::CompiledFileUnit(const char* file)
   : mFile(file, WH_FILEREAD),
+    mFormat(WH_FFVER_MAJ_FIXED),
     mGlobalsCount(0),
     mProcsCount(0),
     mTypeAreaSize(0),
@@ -394,6 +408,14 @@ CompiledFileUnit::ProcessHeader()
                                   "File signature does not match a whais compiled object.");
   }
 
+  mFormat = t_buffer[WHC_FORMATMMAJ_OFF];
+  if ((mFormat != WH_FFVER_MAJ_FIXED) && (mFormat != WH_FFVER_MAJ))
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "The compiled object's format version %u is not supported.",
+                                  mFormat);
+  }
+
   mGlobalsCount = load_le_int32(t_buffer + WHC_GLOBS_COUNT_OFF);
   mProcsCount = load_le_int32(t_buffer + WHC_PROCS_COUNT_OFF);
 
@@ -418,14 +440,32 @@ CompiledFileUnit::ProcessHeader()
   mFile.Seek(temp32, WH_SEEK_BEGIN);
   mFile.Read(mConstArea.get(), mConstAreaSize);
 
-  temp32 = mGlobalsCount * WHC_GLOBAL_ENTRY_SIZE + mProcsCount * WHC_PROC_ENTRY_SIZE;
+  const uint_t procEntrySize = (mFormat == WH_FFVER_MAJ_FIXED)
+                               ? WHC_PROC_ENTRY_SIZE
+                               : WHC_PROC_ENTRY_V2_SIZE;
+
+  temp32 = mGlobalsCount * WHC_GLOBAL_ENTRY_SIZE + mProcsCount * procEntrySize;
 
   mGlobals = unique_array_make(uint8_t, mGlobalsCount * WHC_GLOBAL_ENTRY_SIZE);
-  mProcs = unique_array_make(uint8_t, mProcsCount * WHC_PROC_ENTRY_SIZE);
+  mProcs = unique_array_make(uint8_t, mProcsCount * procEntrySize);
 
   mFile.Seek((-1 * _SC(int64_t, temp32)), WH_SEEK_END);
-  mFile.Read(mGlobals.get(), mGlobalsCount * WHC_GLOBS_COUNT_OFF);
-  mFile.Read(mProcs.get(), mProcsCount * WHC_PROC_ENTRY_SIZE);
+  mFile.Read(mGlobals.get(), mGlobalsCount * WHC_GLOBAL_ENTRY_SIZE);
+  mFile.Read(mProcs.get(), mProcsCount * procEntrySize);
+
+  if (mFormat == WH_FFVER_MAJ_FIXED)
+    return;
+
+  //Keep the procedures' entries as they are in the first version, to have
+  //them found the same way, and their bodies' sizes apart.
+  mBodiesSizes = unique_array_make(uint32_t, mProcsCount);
+  for (uint_t procIt = 0; procIt < mProcsCount; ++procIt)
+  {
+    const uint8_t* const entry = mProcs.get() + procIt * WHC_PROC_ENTRY_V2_SIZE;
+
+    mBodiesSizes[procIt] = load_le_int32(entry + WHC_PROC_ENTRY_BODY_SIZE_OFF);
+    memmove(mProcs.get() + procIt * WHC_PROC_ENTRY_SIZE, entry, WHC_PROC_ENTRY_SIZE);
+  }
 }
 
 
@@ -444,9 +484,46 @@ CompiledFileUnit::LoadProcInMemory(const uint_t id)
   const uint_t   bodySize = (WHC_PROC_BODY_LOCAL_ENTRY_SIZE * nlocals) +
                               WHC_PROC_BODY_SYNCS_ENTRY_SYZE + codeSize;
 
-  mProcData.get()[id] = new uint8_t[bodySize];
+  if (mFormat == WH_FFVER_MAJ_FIXED)
+  {
+    mProcData.get()[id] = new uint8_t[bodySize];
+    mFile.Seek(bodyPos, WH_SEEK_BEGIN);
+    mFile.Read(mProcData.get()[id], bodySize);
+
+    return;
+  }
+
+  //Expand a compact body to the layout of the first version, as the
+  //interpreter works only with fixed width instruction arguments.
+  const uint32_t compactSize = mBodiesSizes[id];
+  std::unique_ptr<uint8_t[]> compact = unique_array_make(uint8_t, compactSize);
+  std::unique_ptr<uint8_t[]> body = unique_array_make(uint8_t, bodySize);
+
   mFile.Seek(bodyPos, WH_SEEK_BEGIN);
-  mFile.Read(mProcData.get()[id], bodySize);
+  mFile.Read(compact.get(), compactSize);
+
+  uint_t pos = 0;
+  store_le_int32(load_le_int32(proc + WHC_PROC_ENTRY_TYPE_OFF) & ~EXTERN_MASK, body.get());
+  for (uint_t localIt = 1; localIt < nlocals; ++localIt)
+  {
+    uint64_t type;
+    pos += load_varint(compact.get() + pos, compactSize - pos, type);
+    store_le_int32(type, body.get() + localIt * WHC_PROC_BODY_LOCAL_ENTRY_SIZE);
+  }
+
+  uint8_t* const syncs = body.get() + nlocals * WHC_PROC_BODY_LOCAL_ENTRY_SIZE;
+  if (pos < compactSize)
+  {
+    *syncs = compact[pos++];
+    expand_proc_code(compact.get() + pos, compactSize - pos, syncs + 1, codeSize);
+  }
+  else if (codeSize == 0)
+    *syncs = 0;
+
+  else
+    throw FunctionalUnitException(_EXTRA(0), "Procedure(%d) body is truncated.", id);
+
+  mProcData.get()[id] = body.release();
 }
 
 
@@ -583,8 +660,7 @@ CompiledFileUnit::ProcSyncStatementsCount(const uint_t id)
 
   const uint8_t *const proc = mProcData.get()[id];
 
-  return proc[ProcLocalsCount(id) * WHC_PROC_BODY_LOCAL_ENTRY_SIZE +
-                WHC_PROC_BODY_SYNCS_ENTRY_SYZE];
+  return proc[ProcLocalsCount(id) * WHC_PROC_BODY_LOCAL_ENTRY_SIZE];
 }
 
 uint_t
@@ -747,6 +823,677 @@ CompiledFileUnit::IsProcExternal(uint_t procId)
          & EXTERN_MASK) != 0;
 }
 
+
+/////////////******CompiledImageUnit********//////////////////////////////
+
+
+//The layout of a linked image. It holds the tables of a compiled object
+//resolved ahead (the names with their lengths, the checked types offsets
+//and the types of every procedure's locals), then the object's type,
+//symbols and constant areas as they are and the procedures' code in the
+//fixed width format. It is stored little endian and used as it is mapped.
+static const uint8_t WLI_SIGNATURE[]         = {'W', 'L', 'I', 1};
+static const uint_t  WLI_SIGNATURE_SIZE      = sizeof WLI_SIGNATURE;
+static const uint_t  WLI_OBJ_SIZE_OFF        = 8;
+static const uint_t  WLI_OBJ_HASH_OFF        = 16;
+static const uint_t  WLI_IMAGE_HASH_OFF      = 24;
+static const uint_t  WLI_GLOBS_COUNT_OFF     = 32;  //The image's hash starts here.
+static const uint_t  WLI_PROCS_COUNT_OFF     = 36;
+static const uint_t  WLI_LOCALS_COUNT_OFF    = 40;
+static const uint_t  WLI_TYPEINFO_START_OFF  = 44;
+static const uint_t  WLI_SYMBOLS_START_OFF   = 52;
+static const uint_t  WLI_CONSTAREA_START_OFF = 60;
+static const uint_t  WLI_CODE_START_OFF      = 68;
+static const uint_t  WLI_AREA_SIZE_OFF       = 4;   //Relative to an area's start.
+static const uint_t  WLI_HEADER_SIZE         = 76;
+
+static const uint_t  WLI_GLB_NAME_OFF        = 0;
+static const uint_t  WLI_GLB_NAME_SIZE_OFF   = 4;
+static const uint_t  WLI_GLB_TYPE_OFF        = 8;
+static const uint_t  WLI_GLB_ENTRY_SIZE      = 12;
+
+static const uint_t  WLI_PROC_NAME_OFF       = 0;
+static const uint_t  WLI_PROC_NAME_SIZE_OFF  = 4;
+static const uint_t  WLI_PROC_CODE_OFF       = 8;
+static const uint_t  WLI_PROC_CODE_SIZE_OFF  = 12;
+static const uint_t  WLI_PROC_LOCALS_OFF     = 16;
+static const uint_t  WLI_PROC_NLOCALS_OFF    = 20;
+static const uint_t  WLI_PROC_NPARAMS_OFF    = 22;
+static const uint_t  WLI_PROC_NSYNCS_OFF     = 24;
+static const uint_t  WLI_PROC_EXTERN_OFF     = 25;
+static const uint_t  WLI_PROC_ENTRY_SIZE     = 28;
+
+static const uint_t  WLI_LOCAL_ENTRY_SIZE    = 4;
+
+
+static uint64_t
+image_hash(const uint8_t* const image, const uint64_t imageSize)
+{
+  return wh_hash(image + WLI_GLOBS_COUNT_OFF, imageSize - WLI_GLOBS_COUNT_OFF);
+}
+
+
+static uint64_t
+object_hash(const char* const file, const FileMapping& object)
+{
+  if ((object.Size() < WHC_TABLE_SIZE) || (object.Size() > 0xFFFFFFFFull))
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "File '%s' does not have the size of a whais compiled object.",
+                                  file);
+  }
+
+  return wh_hash(object.Data(), object.Size());
+}
+
+
+CompiledImageUnit::CompiledImageUnit(const char* file)
+  : mBase(nullptr),
+    mImageSize(0),
+    mObjectSize(0),
+    mObjectHash(0),
+    mGlobalsCount(0),
+    mProcsCount(0),
+    mTypeAreaSize(0),
+    mConstAreaSize(0),
+    mGlobals(nullptr),
+    mProcs(nullptr),
+    mLocalsTypes(nullptr),
+    mTypeInfo(nullptr),
+    mSymbols(nullptr),
+    mConstArea(nullptr),
+    mCode(nullptr)
+{
+  FileMapping object(file);
+
+  LinkObject(object.Data(), object.Size(), object_hash(file, object));
+}
+
+
+CompiledImageUnit::CompiledImageUnit(const char* file, const char* imageFile)
+  : mBase(nullptr),
+    mImageSize(0),
+    mObjectSize(0),
+    mObjectHash(0),
+    mGlobalsCount(0),
+    mProcsCount(0),
+    mTypeAreaSize(0),
+    mConstAreaSize(0),
+    mGlobals(nullptr),
+    mProcs(nullptr),
+    mLocalsTypes(nullptr),
+    mTypeInfo(nullptr),
+    mSymbols(nullptr),
+    mConstArea(nullptr),
+    mCode(nullptr)
+{
+  FileMapping object(file);
+
+  const uint64_t objectHash = object_hash(file, object);
+
+  if ( ! MapImage(imageFile, object.Size(), objectHash))
+    LinkObject(object.Data(), object.Size(), objectHash);
+}
+
+
+CompiledImageUnit::~CompiledImageUnit()
+{
+}
+
+
+bool
+CompiledImageUnit::MapImage(const char* const imageFile,
+                            const uint64_t     objectSize,
+                            const uint64_t     objectHash)
+{
+  if ( ! whf_file_exists(imageFile))
+    return false;
+
+  try
+  {
+    std::unique_ptr<FileMapping> mapping(new FileMapping(imageFile));
+
+    const uint8_t* const image = mapping->Data();
+    const uint64_t imageSize = mapping->Size();
+
+    //An image left from another version of the object, or a damaged one,
+    //is not used; the object is linked again instead.
+    if ((imageSize < WLI_HEADER_SIZE)
+        || (imageSize > 0xFFFFFFFFull)
+        || (memcmp(image, WLI_SIGNATURE, WLI_SIGNATURE_SIZE) != 0)
+        || (load_le_int64(image + WLI_OBJ_SIZE_OFF) != objectSize)
+        || (load_le_int64(image + WLI_OBJ_HASH_OFF) != objectHash)
+        || (load_le_int64(image + WLI_IMAGE_HASH_OFF) != image_hash(image, imageSize)))
+    {
+      return false;
+    }
+
+    AttachImage(image, imageSize);
+
+    mMapping = std::move(mapping);
+    return true;
+  }
+  catch (Exception&)
+  {
+    return false;
+  }
+}
+
+
+void
+CompiledImageUnit::LinkObject(const uint8_t* const object,
+                              const uint64_t       objectSize,
+                              const uint64_t       objectHash)
+{
+  if ((object[WHC_SIGNATURE_OFF] != WH_SIGNATURE[0])
+      || (object[WHC_SIGNATURE_OFF + 1] != WH_SIGNATURE[1]))
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "File signature does not match a whais compiled object.");
+  }
+
+  const uint8_t format = object[WHC_FORMATMMAJ_OFF];
+  if ((format != WH_FFVER_MAJ_FIXED) && (format != WH_FFVER_MAJ))
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "The compiled object's format version %u is not supported.",
+                                  format);
+  }
+
+  const bool compact = (format != WH_FFVER_MAJ_FIXED);
+  const uint_t procEntrySize = compact ? WHC_PROC_ENTRY_V2_SIZE : WHC_PROC_ENTRY_SIZE;
+
+  const uint32_t globalsCount = load_le_int32(object + WHC_GLOBS_COUNT_OFF);
+  const uint32_t procsCount = load_le_int32(object + WHC_PROCS_COUNT_OFF);
+
+  const uint64_t tablesSize = _SC(uint64_t, globalsCount) * WHC_GLOBAL_ENTRY_SIZE
+                              + _SC(uint64_t, procsCount) * procEntrySize;
+  if (tablesSize > objectSize - WHC_TABLE_SIZE)
+    throw FunctionalUnitException(_EXTRA(0), "The compiled object's tables are truncated.");
+
+  const uint64_t tablesOff = objectSize - tablesSize;
+  const auto area_of = [object, tablesOff] (const uint_t startOff,
+                                            const uint_t sizeOff,
+                                            uint32_t&    outSize) -> const uint8_t*
+  {
+    const uint32_t start = load_le_int32(object + startOff);
+    outSize = load_le_int32(object + sizeOff);
+
+    if ((start < WHC_TABLE_SIZE) || (_SC(uint64_t, start) + outSize > tablesOff))
+      throw FunctionalUnitException(_EXTRA(0), "The compiled object's areas are truncated.");
+
+    return object + start;
+  };
+
+  uint32_t typeAreaSize, symbolsSize, constAreaSize;
+
+  const uint8_t* const typeInfo = area_of(WHC_TYPEINFO_START_OFF,
+                                          WHC_TYPEINFO_SIZE_OFF,
+                                          typeAreaSize);
+  const uint8_t* const symbols = area_of(WHC_SYMTABLE_START_OFF,
+                                         WHC_SYMTABLE_SIZE_OFF,
+                                         symbolsSize);
+  const uint8_t* const constArea = area_of(WHC_CONSTAREA_START_OFF,
+                                           WHC_CONSTAREA_SIZE_OFF,
+                                           constAreaSize);
+
+  const auto check_name = [symbols, symbolsSize] (const uint32_t offset) -> uint32_t
+  {
+    const void* const end = (offset < symbolsSize)
+                            ? memchr(symbols + offset, 0, symbolsSize - offset)
+                            : nullptr;
+    if (end == nullptr)
+    {
+      throw FunctionalUnitException(_EXTRA(0),
+                                    "Symbol offset %u is out of the compiled object's symbols.",
+                                    offset);
+    }
+
+    return _SC(const uint8_t*, end) - (symbols + offset);
+  };
+
+  const auto check_type = [typeAreaSize] (const uint64_t offset) -> uint32_t
+  {
+    if (offset >= typeAreaSize)
+    {
+      throw FunctionalUnitException(_EXTRA(0),
+                                    "Type offset %u is out of the compiled object's type area.",
+                                    _SC(uint_t, std::min<uint64_t>(offset, ~0u)));
+    }
+
+    return _SC(uint32_t, offset);
+  };
+
+  //Check where the procedures' bodies are and count their locals and their
+  //code first, to know how large the image is.
+  const uint8_t* const procsTable = object + tablesOff + globalsCount * WHC_GLOBAL_ENTRY_SIZE;
+  uint64_t localsCount = 0, codeSize = 0;
+  for (uint_t procIt = 0; procIt < procsCount; ++procIt)
+  {
+    const uint8_t* const entry = procsTable + procIt * procEntrySize;
+    const bool external = (load_le_int32(entry + WHC_PROC_ENTRY_TYPE_OFF) & EXTERN_MASK) != 0;
+    const uint16_t nlocals = load_le_int16(entry + WHC_PROC_ENTRY_NLOCAL_OFF);
+    const uint16_t nparams = load_le_int16(entry + WHC_PROC_ENTRY_NPARMS_OFF);
+    const uint32_t procCodeSize = load_le_int32(entry + WHC_PROC_ENTRY_CODE_SIZE);
+    const uint32_t bodyOff = load_le_int32(entry + WHC_PROC_ENTRY_BODY_OFF);
+
+    if ((nlocals == 0) || (nparams >= nlocals))
+    {
+      throw FunctionalUnitException(_EXTRA(0),
+                                    "Procedure(%d) has an invalid count of locals.",
+                                    procIt);
+    }
+
+    const uint64_t bodySize = compact
+                              ? load_le_int32(entry + WHC_PROC_ENTRY_BODY_SIZE_OFF)
+                              : _SC(uint64_t, nlocals) * WHC_PROC_BODY_LOCAL_ENTRY_SIZE
+                                + (external ? 0 : WHC_PROC_BODY_SYNCS_ENTRY_SYZE + procCodeSize);
+    if ((bodyOff < WHC_TABLE_SIZE) || (bodyOff + bodySize > tablesOff))
+    {
+      throw FunctionalUnitException(_EXTRA(0),
+                                    "Procedure(%d) body is out of the compiled object.",
+                                    procIt);
+    }
+
+    //No instruction grows more than three times when it is expanded.
+    if (compact && (procCodeSize > 3 * bodySize))
+    {
+      throw FunctionalUnitException(_EXTRA(0),
+                                    "Procedure(%d) has an invalid code size.",
+                                    procIt);
+    }
+
+    localsCount += nlocals;
+    if ( ! external)
+      codeSize += procCodeSize;
+  }
+
+  const uint64_t globalsOff = WLI_HEADER_SIZE;
+  const uint64_t procsOff = globalsOff + _SC(uint64_t, globalsCount) * WLI_GLB_ENTRY_SIZE;
+  const uint64_t localsOff = procsOff + _SC(uint64_t, procsCount) * WLI_PROC_ENTRY_SIZE;
+  const uint64_t typeInfoOff = localsOff + localsCount * WLI_LOCAL_ENTRY_SIZE;
+  const uint64_t symbolsOff = typeInfoOff + typeAreaSize;
+  const uint64_t constAreaOff = symbolsOff + symbolsSize;
+  const uint64_t codeOff = constAreaOff + constAreaSize;
+  const uint64_t imageSize = codeOff + codeSize;
+
+  if (imageSize > 0xFFFFFFFFull)
+    throw FunctionalUnitException(_EXTRA(0), "The compiled object is too large to be linked.");
+
+  std::unique_ptr<uint8_t[]> linked = unique_array_make(uint8_t, imageSize);
+  uint8_t* const image = linked.get();
+
+  memset(image, 0, WLI_HEADER_SIZE);
+  memcpy(image, WLI_SIGNATURE, WLI_SIGNATURE_SIZE);
+  store_le_int64(objectSize, image + WLI_OBJ_SIZE_OFF);
+  store_le_int64(objectHash, image + WLI_OBJ_HASH_OFF);
+  store_le_int32(globalsCount, image + WLI_GLOBS_COUNT_OFF);
+  store_le_int32(procsCount, image + WLI_PROCS_COUNT_OFF);
+  store_le_int32(localsCount, image + WLI_LOCALS_COUNT_OFF);
+  store_le_int32(typeInfoOff, image + WLI_TYPEINFO_START_OFF);
+  store_le_int32(typeAreaSize, image + WLI_TYPEINFO_START_OFF + WLI_AREA_SIZE_OFF);
+  store_le_int32(symbolsOff, image + WLI_SYMBOLS_START_OFF);
+  store_le_int32(symbolsSize, image + WLI_SYMBOLS_START_OFF + WLI_AREA_SIZE_OFF);
+  store_le_int32(constAreaOff, image + WLI_CONSTAREA_START_OFF);
+  store_le_int32(constAreaSize, image + WLI_CONSTAREA_START_OFF + WLI_AREA_SIZE_OFF);
+  store_le_int32(codeOff, image + WLI_CODE_START_OFF);
+  store_le_int32(codeSize, image + WLI_CODE_START_OFF + WLI_AREA_SIZE_OFF);
+
+  memcpy(image + typeInfoOff, typeInfo, typeAreaSize);
+  memcpy(image + symbolsOff, symbols, symbolsSize);
+  memcpy(image + constAreaOff, constArea, constAreaSize);
+
+  for (uint_t glbIt = 0; glbIt < globalsCount; ++glbIt)
+  {
+    const uint8_t* const entry = object + tablesOff + glbIt * WHC_GLOBAL_ENTRY_SIZE;
+    const uint32_t nameOff = load_le_int32(entry + WHC_GLB_ENTRY_NAME_OFF);
+    const uint32_t type = load_le_int32(entry + WHC_GLB_ENTRY_TYPE_OFF);
+
+    uint8_t* const global = image + globalsOff + glbIt * WLI_GLB_ENTRY_SIZE;
+
+    store_le_int32(nameOff, global + WLI_GLB_NAME_OFF);
+    store_le_int32(check_name(nameOff), global + WLI_GLB_NAME_SIZE_OFF);
+    store_le_int32(check_type(type & ~EXTERN_MASK) | (type & EXTERN_MASK),
+                   global + WLI_GLB_TYPE_OFF);
+  }
+
+  uint32_t localIndex = 0, codePos = 0;
+  for (uint_t procIt = 0; procIt < procsCount; ++procIt)
+  {
+    const uint8_t* const entry = procsTable + procIt * procEntrySize;
+    const uint32_t nameOff = load_le_int32(entry + WHC_PROC_ENTRY_NAME_OFF);
+    const uint32_t type = load_le_int32(entry + WHC_PROC_ENTRY_TYPE_OFF);
+    const bool external = (type & EXTERN_MASK) != 0;
+    const uint16_t nlocals = load_le_int16(entry + WHC_PROC_ENTRY_NLOCAL_OFF);
+    const uint32_t procCodeSize = load_le_int32(entry + WHC_PROC_ENTRY_CODE_SIZE);
+    const uint8_t* const body = object + load_le_int32(entry + WHC_PROC_ENTRY_BODY_OFF);
+
+    uint8_t* const proc = image + procsOff + procIt * WLI_PROC_ENTRY_SIZE;
+    uint8_t* const locals = image + localsOff + localIndex * WLI_LOCAL_ENTRY_SIZE;
+
+    store_le_int32(nameOff, proc + WLI_PROC_NAME_OFF);
+    store_le_int32(check_name(nameOff), proc + WLI_PROC_NAME_SIZE_OFF);
+    store_le_int32(external ? 0 : codePos, proc + WLI_PROC_CODE_OFF);
+    store_le_int32(procCodeSize, proc + WLI_PROC_CODE_SIZE_OFF);
+    store_le_int32(localIndex, proc + WLI_PROC_LOCALS_OFF);
+    store_le_int16(nlocals, proc + WLI_PROC_NLOCALS_OFF);
+    store_le_int16(load_le_int16(entry + WHC_PROC_ENTRY_NPARMS_OFF), proc + WLI_PROC_NPARAMS_OFF);
+    proc[WLI_PROC_NSYNCS_OFF] = 0;
+    proc[WLI_PROC_EXTERN_OFF] = external ? 1 : 0;
+
+    localIndex += nlocals;
+
+    //The first local holds the procedure's return value.
+    store_le_int32(check_type(type & ~EXTERN_MASK), locals);
+
+    if ( ! compact)
+    {
+      for (uint_t localIt = 1; localIt < nlocals; ++localIt)
+      {
+        const uint32_t localType = load_le_int32(body + localIt * WHC_PROC_BODY_LOCAL_ENTRY_SIZE);
+        store_le_int32(check_type(localType), locals + localIt * WLI_LOCAL_ENTRY_SIZE);
+      }
+
+      if (external)
+        continue;
+
+      const uint8_t* const syncs = body + nlocals * WHC_PROC_BODY_LOCAL_ENTRY_SIZE;
+
+      proc[WLI_PROC_NSYNCS_OFF] = *syncs;
+      memcpy(image + codeOff + codePos, syncs + WHC_PROC_BODY_SYNCS_ENTRY_SYZE, procCodeSize);
+
+      codePos += procCodeSize;
+      continue;
+    }
+
+    const uint64_t bodySize = load_le_int32(entry + WHC_PROC_ENTRY_BODY_SIZE_OFF);
+    uint64_t pos = 0;
+    for (uint_t localIt = 1; localIt < nlocals; ++localIt)
+    {
+      uint64_t localType;
+      pos += load_varint(body + pos, bodySize - pos, localType);
+      store_le_int32(check_type(localType), locals + localIt * WLI_LOCAL_ENTRY_SIZE);
+    }
+
+    if (external)
+      continue;
+
+    else if (pos >= bodySize)
+      throw FunctionalUnitException(_EXTRA(0), "Procedure(%d) body is truncated.", procIt);
+
+    proc[WLI_PROC_NSYNCS_OFF] = body[pos++];
+    expand_proc_code(body + pos, bodySize - pos, image + codeOff + codePos, procCodeSize);
+
+    codePos += procCodeSize;
+  }
+
+  assert(localIndex == localsCount);
+  assert(codePos == codeSize);
+
+  store_le_int64(image_hash(image, imageSize), image + WLI_IMAGE_HASH_OFF);
+
+  AttachImage(image, imageSize);
+  mImage = std::move(linked);
+}
+
+
+void
+CompiledImageUnit::AttachImage(const uint8_t* const image, const uint64_t imageSize)
+{
+  const uint32_t globalsCount = load_le_int32(image + WLI_GLOBS_COUNT_OFF);
+  const uint32_t procsCount = load_le_int32(image + WLI_PROCS_COUNT_OFF);
+  const uint32_t localsCount = load_le_int32(image + WLI_LOCALS_COUNT_OFF);
+
+  const uint64_t tablesSize = _SC(uint64_t, globalsCount) * WLI_GLB_ENTRY_SIZE
+                              + _SC(uint64_t, procsCount) * WLI_PROC_ENTRY_SIZE
+                              + _SC(uint64_t, localsCount) * WLI_LOCAL_ENTRY_SIZE;
+  if (WLI_HEADER_SIZE + tablesSize > imageSize)
+    throw FunctionalUnitException(_EXTRA(0), "The linked image's tables are truncated.");
+
+  const auto area_of = [image, imageSize] (const uint_t startOff,
+                                           uint32_t&    outSize) -> const uint8_t*
+  {
+    const uint32_t start = load_le_int32(image + startOff);
+    outSize = load_le_int32(image + startOff + WLI_AREA_SIZE_OFF);
+
+    if (_SC(uint64_t, start) + outSize > imageSize)
+      throw FunctionalUnitException(_EXTRA(0), "The linked image's areas are truncated.");
+
+    return image + start;
+  };
+
+  uint32_t symbolsSize, codeSize;
+
+  mTypeInfo = area_of(WLI_TYPEINFO_START_OFF, mTypeAreaSize);
+  mSymbols = area_of(WLI_SYMBOLS_START_OFF, symbolsSize);
+  mConstArea = area_of(WLI_CONSTAREA_START_OFF, mConstAreaSize);
+  mCode = area_of(WLI_CODE_START_OFF, codeSize);
+
+  mBase = image;
+  mImageSize = imageSize;
+  mObjectSize = load_le_int64(image + WLI_OBJ_SIZE_OFF);
+  mObjectHash = load_le_int64(image + WLI_OBJ_HASH_OFF);
+  mGlobalsCount = globalsCount;
+  mProcsCount = procsCount;
+  mGlobals = image + WLI_HEADER_SIZE;
+  mProcs = mGlobals + globalsCount * WLI_GLB_ENTRY_SIZE;
+  mLocalsTypes = mProcs + procsCount * WLI_PROC_ENTRY_SIZE;
+}
+
+
+void
+CompiledImageUnit::SaveImage(const char* const imageFile) const
+{
+  //Write it aside first, so a failure does not leave half of an image.
+  const std::string tempFile = std::string(imageFile) + ".tmp";
+
+  File image(tempFile.c_str(), WH_FILECREATE | WH_FILETRUNC | WH_FILEWRITE);
+
+  image.Write(mBase, mImageSize);
+  image.Close();
+
+  if (whf_file_exists(imageFile))
+    whf_remove(imageFile);
+
+  whf_move_file(tempFile.c_str(), imageFile);
+}
+
+
+const uint8_t*
+CompiledImageUnit::Global(const uint_t id) const
+{
+  if (id >= mGlobalsCount)
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "Global value index out of range(%d of %d).",
+                                  id,
+                                  mGlobalsCount);
+  }
+
+  return mGlobals + id * WLI_GLB_ENTRY_SIZE;
+}
+
+
+const uint8_t*
+CompiledImageUnit::Procedure(const uint_t id) const
+{
+  if (id >= mProcsCount)
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "Procedure index out of range(%d of %d).",
+                                  id,
+                                  mProcsCount);
+  }
+
+  return mProcs + id * WLI_PROC_ENTRY_SIZE;
+}
+
+
+bool_t
+CompiledImageUnit::IsCodeVerified()
+{
+  return mMapping ? TRUE : FALSE;
+}
+
+
+uint_t
+CompiledImageUnit::TypeAreaSize()
+{
+  return mTypeAreaSize;
+}
+
+
+const uint8_t*
+CompiledImageUnit::RetriveTypeArea()
+{
+  return mTypeInfo;
+}
+
+
+uint_t
+CompiledImageUnit::ConstsAreaSize()
+{
+  return mConstAreaSize;
+}
+
+
+const uint8_t*
+CompiledImageUnit::RetrieveConstArea()
+{
+  return mConstArea;
+}
+
+
+uint_t
+CompiledImageUnit::GlobalsCount()
+{
+  return mGlobalsCount;
+}
+
+
+uint_t
+CompiledImageUnit::GlobalNameLength(const uint_t id)
+{
+  return load_le_int32(Global(id) + WLI_GLB_NAME_SIZE_OFF);
+}
+
+
+const char*
+CompiledImageUnit::RetriveGlobalName(const uint_t id)
+{
+  return _RC(const char*, mSymbols + load_le_int32(Global(id) + WLI_GLB_NAME_OFF));
+}
+
+
+uint_t
+CompiledImageUnit::GlobalTypeOff(const uint_t id)
+{
+  return load_le_int32(Global(id) + WLI_GLB_TYPE_OFF) & ~EXTERN_MASK;
+}
+
+
+bool_t
+CompiledImageUnit::IsGlobalExternal(const uint_t id)
+{
+  return (load_le_int32(Global(id) + WLI_GLB_TYPE_OFF) & EXTERN_MASK) != 0;
+}
+
+
+uint_t
+CompiledImageUnit::ProceduresCount()
+{
+  return mProcsCount;
+}
+
+
+uint_t
+CompiledImageUnit::ProcSyncStatementsCount(const uint_t id)
+{
+  return Procedure(id)[WLI_PROC_NSYNCS_OFF];
+}
+
+
+uint_t
+CompiledImageUnit::ProcCodeAreaSize(const uint_t id)
+{
+  return load_le_int32(Procedure(id) + WLI_PROC_CODE_SIZE_OFF);
+}
+
+
+const uint8_t*
+CompiledImageUnit::RetriveProcCodeArea(const uint_t id)
+{
+  const uint8_t* const proc = Procedure(id);
+
+  if (proc[WLI_PROC_EXTERN_OFF] != 0)
+    return nullptr;
+
+  return mCode + load_le_int32(proc + WLI_PROC_CODE_OFF);
+}
+
+
+uint_t
+CompiledImageUnit::ProcLocalsCount(const uint_t id)
+{
+  return load_le_int16(Procedure(id) + WLI_PROC_NLOCALS_OFF);
+}
+
+
+uint_t
+CompiledImageUnit::ProcParametersCount(const uint_t id)
+{
+  return load_le_int16(Procedure(id) + WLI_PROC_NPARAMS_OFF);
+}
+
+
+uint_t
+CompiledImageUnit::GetProcReturnTypeOff(const uint_t id)
+{
+  return GetProcLocalTypeOff(id, 0);
+}
+
+
+uint_t
+CompiledImageUnit::GetProcNameSize(const uint_t id)
+{
+  return load_le_int32(Procedure(id) + WLI_PROC_NAME_SIZE_OFF);
+}
+
+
+const char*
+CompiledImageUnit::RetriveProcName(const uint_t id)
+{
+  return _RC(const char*, mSymbols + load_le_int32(Procedure(id) + WLI_PROC_NAME_OFF));
+}
+
+
+uint_t
+CompiledImageUnit::GetProcLocalTypeOff(uint_t procId, uint_t localId)
+{
+  const uint8_t* const proc = Procedure(procId);
+  const uint_t localsCount = load_le_int16(proc + WLI_PROC_NLOCALS_OFF);
+
+  if (localId >= localsCount)
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "Procedure(%d) local index out of range( %d of %d).",
+                                  procId,
+                                  localId,
+                                  localsCount);
+  }
+
+  const uint32_t local = load_le_int32(proc + WLI_PROC_LOCALS_OFF) + localId;
+  return load_le_int32(mLocalsTypes + local * WLI_LOCAL_ENTRY_SIZE);
+}
+
+
+bool_t
+CompiledImageUnit::IsProcExternal(uint_t procId)
+{
+  return Procedure(procId)[WLI_PROC_EXTERN_OFF] != 0;
+}
+
+
 FunctionalUnitException::FunctionalUnitException(const uint32_t   code,
                                                  const char      *file,
                                                  const uint32_t   line,
@@ -0,0 +1,469 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <map>
+
+#include "compiler/compactcode.h"
+#include "compiler/strippedunit.h"
+#include "compiler/wopcodes.h"
+#include "utils/endianness.h"
+
+
+using namespace std;
+
+namespace whais {
+
+
+//Where a global or a procedure is defined.
+struct Definition
+{
+  uint_t mUnit;
+  uint_t mIndex;
+};
+
+typedef map<string, Definition> DEFINITIONS;
+
+
+//Call 'visit' with the opcode and the arguments of every instruction of a
+//procedure's code.
+template<typename T, typename VISITOR> static void
+for_each_instruction(T* const code, const uint_t codeSize, VISITOR visit)
+{
+  for (uint_t pos = 0; pos < codeSize; )
+  {
+    const uint_t opcode = code[pos];
+    if (opcode == W_NA)
+      throw FunctionalUnitException(_EXTRA(0), "Invalid opcode %u in a procedure's code.", opcode);
+
+    const uint_t argsSize = code_args_size(opcode);
+    if (pos + 1 + argsSize > codeSize)
+      throw FunctionalUnitException(_EXTRA(0), "A procedure's code is truncated.");
+
+    visit(opcode, code + pos + 1);
+
+    pos += 1 + argsSize;
+  }
+}
+
+
+static uint32_t
+global_arg(const uint_t opcode, const uint8_t* const args)
+{
+  if (opcode == W_LDGB8)
+    return args[0];
+
+  return (opcode == W_LDGB16) ? load_le_int16(args) : load_le_int32(args);
+}
+
+
+static string
+global_name(WIFunctionalUnit& unit, const uint_t id)
+{
+  return string(unit.RetriveGlobalName(id), unit.GlobalNameLength(id));
+}
+
+
+static string
+procedure_name(WIFunctionalUnit& unit, const uint_t id)
+{
+  return string(unit.RetriveProcName(id), unit.GetProcNameSize(id));
+}
+
+
+//Find the definition of an external procedure. The procedures the compiler
+//specialized for the types of the arguments passed to generic ones
+//('name@TYPE...') fall back to the more generic ones, as they do when loaded.
+static const Definition*
+find_procedure(const DEFINITIONS& procs, string name)
+{
+  while (true)
+  {
+    const auto found = procs.find(name);
+    if (found != procs.end())
+      return &found->second;
+
+    const size_t at = name.rfind('@');
+    if ((at == string::npos) || (at == 0))
+      return nullptr;
+
+    name.resize(at);
+  }
+}
+
+
+StrippedUnit::StrippedUnit(WIFunctionalUnit&      unit,
+                           const vector<bool>&    keptGlobals,
+                           const vector<bool>&    keptProcs)
+  : mUnit(unit),
+    mGlobals(),
+    mProcs(),
+    mCodes()
+{
+  static const uint32_t DROPPED = 0xFFFFFFFF;
+
+  vector<uint32_t> globalIds(unit.GlobalsCount(), DROPPED);
+  vector<uint32_t> procIds(unit.ProceduresCount(), DROPPED);
+
+  for (uint_t id = 0; id < globalIds.size(); ++id)
+  {
+    if ((id < keptGlobals.size()) && keptGlobals[id])
+    {
+      globalIds[id] = mGlobals.size();
+      mGlobals.push_back(id);
+    }
+  }
+
+  for (uint_t id = 0; id < procIds.size(); ++id)
+  {
+    if ((id < keptProcs.size()) && keptProcs[id])
+    {
+      procIds[id] = mProcs.size();
+      mProcs.push_back(id);
+    }
+  }
+
+  auto newId = [](const vector<uint32_t>& ids, const uint32_t id) {
+    if ((id >= ids.size()) || (ids[id] == DROPPED))
+      throw FunctionalUnitException(_EXTRA(0), "A kept procedure refers a dropped symbol.");
+
+    return ids[id];
+  };
+
+  for (const auto id : mProcs)
+  {
+    mCodes.emplace_back();
+    if (unit.IsProcExternal(id))
+      continue;
+
+    const uint8_t* const code = unit.RetriveProcCodeArea(id);
+    auto& newCode = mCodes.back();
+
+    newCode.assign(code, code + unit.ProcCodeAreaSize(id));
+
+    //The new indexes are never greater, so they fit in the same space.
+    for_each_instruction(newCode.data(),
+                         newCode.size(),
+                         [&](const uint_t opcode, uint8_t* const args) {
+      if (opcode == W_CALL)
+        store_le_int32(newId(procIds, load_le_int32(args)), args);
+
+      else if (opcode == W_LDGB8)
+        args[0] = newId(globalIds, args[0]);
+
+      else if (opcode == W_LDGB16)
+        store_le_int16(newId(globalIds, load_le_int16(args)), args);
+
+      else if (opcode == W_LDGB32)
+        store_le_int32(newId(globalIds, load_le_int32(args)), args);
+    });
+  }
+}
+
+
+StrippedUnit::~StrippedUnit()
+{
+}
+
+
+uint_t
+StrippedUnit::Global(const uint_t id) const
+{
+  if (id >= mGlobals.size())
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "Global value index out of range(%d of %d).",
+                                  id,
+                                  _SC(uint_t, mGlobals.size()));
+  }
+
+  return mGlobals[id];
+}
+
+
+uint_t
+StrippedUnit::Procedure(const uint_t id) const
+{
+  if (id >= mProcs.size())
+  {
+    throw FunctionalUnitException(_EXTRA(0),
+                                  "Procedure index out of range(%d of %d).",
+                                  id,
+                                  _SC(uint_t, mProcs.size()));
+  }
+
+  return mProcs[id];
+}
+
+
+uint_t
+StrippedUnit::TypeAreaSize()
+{
+  return mUnit.TypeAreaSize();
+}
+
+
+const uint8_t*
+StrippedUnit::RetriveTypeArea()
+{
+  return mUnit.RetriveTypeArea();
+}
+
+
+uint_t
+StrippedUnit::ConstsAreaSize()
+{
+  return mUnit.ConstsAreaSize();
+}
+
+
+const uint8_t*
+StrippedUnit::RetrieveConstArea()
+{
+  return mUnit.RetrieveConstArea();
+}
+
+
+uint_t
+StrippedUnit::GlobalsCount()
+{
+  return mGlobals.size();
+}
+
+
+uint_t
+StrippedUnit::GlobalNameLength(const uint_t id)
+{
+  return mUnit.GlobalNameLength(Global(id));
+}
+
+
+const char*
+StrippedUnit::RetriveGlobalName(const uint_t id)
+{
+  return mUnit.RetriveGlobalName(Global(id));
+}
+
+
+uint_t
+StrippedUnit::GlobalTypeOff(const uint_t id)
+{
+  return mUnit.GlobalTypeOff(Global(id));
+}
+
+
+bool_t
+StrippedUnit::IsGlobalExternal(const uint_t id)
+{
+  return mUnit.IsGlobalExternal(Global(id));
+}
+
+
+uint_t
+StrippedUnit::ProceduresCount()
+{
+  return mProcs.size();
+}
+
+
+uint_t
+StrippedUnit::ProcSyncStatementsCount(const uint_t id)
+{
+  return mUnit.ProcSyncStatementsCount(Procedure(id));
+}
+
+
+uint_t
+StrippedUnit::ProcCodeAreaSize(const uint_t id)
+{
+  return mUnit.ProcCodeAreaSize(Procedure(id));
+}
+
+
+const uint8_t*
+StrippedUnit::RetriveProcCodeArea(const uint_t id)
+{
+  const uint_t procedure = Procedure(id);
+
+  if (mCodes[id].empty())
+    return mUnit.RetriveProcCodeArea(procedure);
+
+  return mCodes[id].data();
+}
+
+
+uint_t
+StrippedUnit::ProcLocalsCount(const uint_t id)
+{
+  return mUnit.ProcLocalsCount(Procedure(id));
+}
+
+
+uint_t
+StrippedUnit::ProcParametersCount(const uint_t id)
+{
+  return mUnit.ProcParametersCount(Procedure(id));
+}
+
+
+uint_t
+StrippedUnit::GetProcReturnTypeOff(const uint_t id)
+{
+  return mUnit.GetProcReturnTypeOff(Procedure(id));
+}
+
+
+uint_t
+StrippedUnit::GetProcNameSize(const uint_t id)
+{
+  return mUnit.GetProcNameSize(Procedure(id));
+}
+
+
+const char*
+StrippedUnit::RetriveProcName(const uint_t id)
+{
+  return mUnit.RetriveProcName(Procedure(id));
+}
+
+
+uint_t
+StrippedUnit::GetProcLocalTypeOff(uint_t procId, uint_t localId)
+{
+  return mUnit.GetProcLocalTypeOff(Procedure(procId), localId);
+}
+
+
+bool_t
+StrippedUnit::IsProcExternal(uint_t procId)
+{
+  return mUnit.IsProcExternal(Procedure(procId));
+}
+
+
+void
+strip_units(const vector<WIFunctionalUnit*>&       units,
+            const vector<string>&                  entries,
+            vector<unique_ptr<StrippedUnit>>&      outUnits)
+{
+  DEFINITIONS globals, procs;
+  vector<vector<bool>> keptGlobals, keptProcs;
+
+  //When a symbol is defined twice only its first definition is loaded.
+  for (uint_t u = 0; u < units.size(); ++u)
+  {
+    WIFunctionalUnit& unit = *units[u];
+
+    keptGlobals.emplace_back(unit.GlobalsCount(), false);
+    keptProcs.emplace_back(unit.ProceduresCount(), false);
+
+    for (uint_t id = 0; id < unit.GlobalsCount(); ++id)
+    {
+      if ( ! unit.IsGlobalExternal(id))
+        globals.emplace(global_name(unit, id), Definition{u, id});
+    }
+
+    for (uint_t id = 0; id < unit.ProceduresCount(); ++id)
+    {
+      if ( ! unit.IsProcExternal(id))
+        procs.emplace(procedure_name(unit, id), Definition{u, id});
+    }
+  }
+
+  vector<Definition> pending;
+  auto keepProcedure = [&](const Definition& def) {
+    if ( ! keptProcs[def.mUnit][def.mIndex])
+    {
+      keptProcs[def.mUnit][def.mIndex] = true;
+      pending.push_back(def);
+    }
+  };
+
+  for (const auto& entry : entries)
+  {
+    const auto proc = procs.find(entry);
+    const auto global = globals.find(entry);
+
+    if ((proc == procs.end()) && (global == globals.end()))
+      throw FunctionalUnitException(_EXTRA(0), "Cannot find the definition of '%s'.", entry.c_str());
+
+    if (proc != procs.end())
+      keepProcedure(proc->second);
+
+    if (global != globals.end())
+      keptGlobals[global->second.mUnit][global->second.mIndex] = true;
+  }
+
+  while ( ! pending.empty())
+  {
+    const Definition def = pending.back();
+    WIFunctionalUnit& unit = *units[def.mUnit];
+
+    pending.pop_back();
+
+    for_each_instruction(unit.RetriveProcCodeArea(def.mIndex),
+                         unit.ProcCodeAreaSize(def.mIndex),
+                         [&](const uint_t opcode, const uint8_t* const args) {
+      if (opcode == W_CALL)
+      {
+        const uint32_t id = load_le_int32(args);
+        if (id >= unit.ProceduresCount())
+          throw FunctionalUnitException(_EXTRA(0), "A procedure calls an unknown procedure.");
+
+        if ( ! unit.IsProcExternal(id))
+          keepProcedure(Definition{def.mUnit, id});
+
+        else
+        {
+          keptProcs[def.mUnit][id] = true;
+
+          const Definition* const found = find_procedure(procs, procedure_name(unit, id));
+          if (found != nullptr)
+            keepProcedure( *found);
+        }
+      }
+      else if ((W_LDGB8 <= opcode) && (opcode <= W_LDGB32))
+      {
+        const uint32_t id = global_arg(opcode, args);
+        if (id >= unit.GlobalsCount())
+          throw FunctionalUnitException(_EXTRA(0), "A procedure uses an unknown global value.");
+
+        keptGlobals[def.mUnit][id] = true;
+        if (unit.IsGlobalExternal(id))
+        {
+          const auto found = globals.find(global_name(unit, id));
+          if (found != globals.end())
+            keptGlobals[found->second.mUnit][found->second.mIndex] = true;
+        }
+      }
+    });
+  }
+
+  outUnits.clear();
+  for (uint_t u = 0; u < units.size(); ++u)
+    outUnits.emplace_back(new StrippedUnit( *units[u], keptGlobals[u], keptProcs[u]));
+}
+
+
+} //namespace whais
@@ -125,6 +125,14 @@ File::Sync()
 }
 
 
+void
+File::Prefetch(const uint64_t offset, const uint64_t size)
+{
+  //This is only a hint, the data will be read anyway if needed.
+  whf_prefetch(mHandle, offset, size);
+}
+
+
 uint64_t
 File::Size() const
 {
@@ -175,5 +183,27 @@ File::operator= (File&& src)
 }
 
 
+FileMapping::FileMapping(const char* name)
+  : mData(nullptr),
+    mSize(0)
+{
+  File file(name, WH_FILEREAD);
+
+  mSize = file.Size();
+  if (mSize == 0)
+    throw FileException(_EXTRA(0), "Cannot map the empty file '%s'.", name);
+
+  mData = whf_map(file.mHandle, mSize);
+  if (mData == nullptr)
+    throw FileException(_EXTRA(whf_last_error()), "Failed to map file '%s'.", name);
+}
+
+
+FileMapping::~FileMapping()
+{
+  whf_unmap(mData, mSize);
+}
+
+
 } //namespace whais
 
@@ -99,6 +99,80 @@ Lock::unlock()
 
 
 
+Condition::Condition()
+{
+  const uint_t result = wh_cond_init(&mCond);
+
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to initialize a condition.");
+  }
+}
+
+
+Condition::~Condition()
+{
+  const uint_t result = wh_cond_destroy(&mCond);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+void
+Condition::Wait(Lock& lock)
+{
+  const uint_t result = wh_cond_wait(&mCond, &lock.mLock);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to wait for a condition.");
+  }
+}
+
+
+bool
+Condition::Wait(Lock& lock, const uint_t millisecs)
+{
+  bool_t timeout;
+
+  const uint_t result = wh_cond_timed_wait(&mCond, &lock.mLock, millisecs, &timeout);
+  if (result != WOP_OK)
+  {
+    assert(false);
+
+    throw LockException(_EXTRA(result), "Failed to wait for a condition.");
+  }
+
+  return timeout == FALSE;
+}
+
+
+void
+Condition::Signal()
+{
+  const uint_t result = wh_cond_signal(&mCond);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+void
+Condition::Broadcast()
+{
+  const uint_t result = wh_cond_broadcast(&mCond);
+
+  (void)result;
+  assert(result == WOP_OK);
+}
+
+
+
+
 SpinLock::SpinLock()
   : mLock(0)
 {
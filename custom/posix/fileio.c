@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <unistd.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -193,6 +194,20 @@ whf_sync(WH_FILE hnd)
 }
 
 
+bool_t
+whf_prefetch(WH_FILE hnd, uint64_t offset, uint64_t size)
+{
+#ifdef POSIX_FADV_WILLNEED
+  /* The kernel starts reading the data in background, and returns
+   * immediately. */
+  return posix_fadvise64(hnd, offset, size, POSIX_FADV_WILLNEED) == 0;
+#else
+  (void)hnd, (void)offset, (void)size;
+  return TRUE;
+#endif
+}
+
+
 bool_t
 whf_tell_size(WH_FILE hnd, uint64_t* const outSize)
 {
@@ -206,6 +221,25 @@ whf_tell_size(WH_FILE hnd, uint64_t* const outSize)
 }
 
 
+const uint8_t*
+whf_map(WH_FILE hnd, uint64_t size)
+{
+  void* const result = mmap(NULL, size, PROT_READ, MAP_PRIVATE, hnd, 0);
+
+  if (result == MAP_FAILED)
+    return NULL;
+
+  return (const uint8_t*)result;
+}
+
+
+bool_t
+whf_unmap(const uint8_t* const mapping, uint64_t size)
+{
+  return munmap((void*)mapping, size) == 0;
+}
+
+
 bool_t
 whf_set_size(WH_FILE hnd, const uint64_t newSize)
 {
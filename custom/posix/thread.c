@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 #include <errno.h>
 #include <sched.h>
+#include <time.h>
 #include <unistd.h>
 #include <pthread.h>
 
@@ -134,6 +135,115 @@ wh_lock_release(WH_LOCK* const lock)
 }
 
 
+uint_t
+wh_cond_init(WH_COND* const cond)
+{
+  pthread_condattr_t attrs;
+
+  uint_t result = pthread_condattr_init(&attrs);
+  if (result != 0)
+    return result;
+
+  /* Do not let the timed waits be affected by the system's time changes. */
+  result = pthread_condattr_setclock(&attrs, CLOCK_MONOTONIC);
+  if (result == 0)
+    {
+      do
+        result = pthread_cond_init(cond, &attrs);
+      while (result == EAGAIN);
+    }
+
+  pthread_condattr_destroy(&attrs);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_destroy(WH_COND* const cond)
+{
+  uint_t result;
+
+  do
+    result = pthread_cond_destroy(cond);
+  while (result == EAGAIN);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_wait(WH_COND* const cond, WH_LOCK* const lock)
+{
+  const uint_t result = pthread_cond_wait(cond, lock);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_timed_wait(WH_COND* const cond,
+                    WH_LOCK* const lock,
+                    const uint_t   millisecs,
+                    bool_t* const  outTimeout)
+{
+  struct timespec deadline;
+  int result;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &deadline) != 0)
+    return errno;
+
+  deadline.tv_sec  += millisecs / 1000;
+  deadline.tv_nsec += (millisecs % 1000) * 1000000l;
+  if (deadline.tv_nsec >= 1000000000l)
+    {
+      deadline.tv_sec  += 1;
+      deadline.tv_nsec -= 1000000000l;
+    }
+
+  result = pthread_cond_timedwait(cond, lock, &deadline);
+
+  *outTimeout = (result == ETIMEDOUT) ? TRUE : FALSE;
+  if ((result == 0) || (result == ETIMEDOUT))
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_signal(WH_COND* const cond)
+{
+  const uint_t result = pthread_cond_signal(cond);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
+uint_t
+wh_cond_broadcast(WH_COND* const cond)
+{
+  const uint_t result = pthread_cond_broadcast(cond);
+
+  if (result == 0)
+    return WOP_OK;
+
+  return result;
+}
+
+
 uint_t
 wh_thread_create(WH_THREAD*  const             outThread,
                   const WH_THREAD_ROUTINE       routine,
@@ -211,12 +211,43 @@ whf_sync(WH_FILE hnd)
   return FlushFileBuffers(handler);
 }
 
+bool_t
+whf_prefetch(WH_FILE hnd, uint64_t offset, uint64_t size)
+{
+  /* No read ahead hints on this platform. */
+  (void)hnd, (void)offset, (void)size;
+  return TRUE;
+}
+
 bool_t
 whf_tell_size(WH_FILE hnd, uint64_t* const outSize)
 {
   return GetFileSizeEx(hnd, (LARGE_INTEGER*) outSize);
 }
 
+const uint8_t*
+whf_map(WH_FILE hnd, uint64_t size)
+{
+  const uint8_t* result = NULL;
+
+  /* The view keeps the mapping object alive once it is closed. */
+  HANDLE mapping = CreateFileMapping(hnd, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL)
+    return NULL;
+
+  result = (const uint8_t*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)size);
+  CloseHandle(mapping);
+
+  return result;
+}
+
+bool_t
+whf_unmap(const uint8_t* const mapping, uint64_t size)
+{
+  (void)size;
+  return UnmapViewOfFile(mapping) != 0;
+}
+
 bool_t
 whf_set_size(WH_FILE hnd, const uint64_t newSize)
 {
@@ -74,6 +74,78 @@ wh_lock_release(WH_LOCK* const lock)
 }
 
 
+uint_t
+wh_cond_init(WH_COND* const cond)
+{
+  InitializeConditionVariable(cond);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_destroy(WH_COND* const cond)
+{
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_wait(WH_COND* const cond, WH_LOCK* const lock)
+{
+  if (SleepConditionVariableCS(cond, lock, INFINITE) == 0)
+    {
+      const uint_t result = GetLastError();
+
+      return(result == WOP_OK) ? WOP_UNKNOW : result;
+    }
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_timed_wait(WH_COND* const cond,
+                    WH_LOCK* const lock,
+                    const uint_t   millisecs,
+                    bool_t* const  outTimeout)
+{
+  *outTimeout = FALSE;
+  if (SleepConditionVariableCS(cond, lock, millisecs) == 0)
+    {
+      const uint_t result = GetLastError();
+
+      if (result == ERROR_TIMEOUT)
+        {
+          *outTimeout = TRUE;
+          return WOP_OK;
+        }
+
+      return(result == WOP_OK) ? WOP_UNKNOW : result;
+    }
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_signal(WH_COND* const cond)
+{
+  WakeConditionVariable(cond);
+
+  return WOP_OK;
+}
+
+
+uint_t
+wh_cond_broadcast(WH_COND* const cond)
+{
+  WakeAllConditionVariable(cond);
+
+  return WOP_OK;
+}
+
+
 uint_t
 wh_thread_create(WH_THREAD* const              outThread,
                   const WH_THREAD_ROUTINE       routine,
@@ -25,6 +25,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef DBS_TABLE_H_
 #define DBS_TABLE_H_
 
+#include <map>
+#include <vector>
+
 #include "dbs_types.h"
 #include "dbs_values.h"
 
@@ -44,6 +47,118 @@ class IDBSHandler;
 
 typedef void CREATE_INDEX_CALLBACK_FUNC(CreateIndexCallbackContext* cbContext);
 
+
+/* Holds the leading values of a composite index key. The values are kept
+ * in the same order preserving binary form the index uses for its entries,
+ * so keys may be compared as plain byte strings. A key holding fewer values
+ * than the index's fields count is used as prefix for range matching. */
+class DBS_SHL DBSCompositeKey
+{
+public:
+  DBSCompositeKey& Add(const DBool& value);
+  DBSCompositeKey& Add(const DChar& value);
+  DBSCompositeKey& Add(const DDate& value);
+  DBSCompositeKey& Add(const DDateTime& value);
+  DBSCompositeKey& Add(const DHiresTime& value);
+  DBSCompositeKey& Add(const DInt8& value);
+  DBSCompositeKey& Add(const DInt16& value);
+  DBSCompositeKey& Add(const DInt32& value);
+  DBSCompositeKey& Add(const DInt64& value);
+  DBSCompositeKey& Add(const DReal& value);
+  DBSCompositeKey& Add(const DRichReal& value);
+  DBSCompositeKey& Add(const DUInt8& value);
+  DBSCompositeKey& Add(const DUInt16& value);
+  DBSCompositeKey& Add(const DUInt32& value);
+  DBSCompositeKey& Add(const DUInt64& value);
+
+  uint_t Count() const { return mTypes.size(); }
+  DBS_FIELD_TYPE Type(const uint_t part) const { return mTypes.at(part); }
+  uint_t RawSize() const { return mRawKey.size(); }
+  const uint8_t* RawData() const { return mRawKey.data(); }
+
+private:
+  std::vector<DBS_FIELD_TYPE>   mTypes;
+  std::vector<uint8_t>          mRawKey;
+};
+
+/* A set of table rows kept as a compressed bitmap. The rows are grouped
+ * in chunks of 64K; a chunk keeps a sorted list of its rows while it is
+ * sparse and switches to a plain bit set when it becomes dense. */
+class DBS_SHL DBSRowsBitmap
+{
+public:
+  void Add(const ROW_INDEX row);
+  void Remove(const ROW_INDEX row);
+  bool Contains(const ROW_INDEX row) const;
+  ROW_INDEX Count() const;
+  bool IsEmpty() const { return mChunks.empty(); }
+
+  DBSRowsBitmap& And(const DBSRowsBitmap& other);
+  DBSRowsBitmap& Or(const DBSRowsBitmap& other);
+  DBSRowsBitmap& AndNot(const DBSRowsBitmap& other);
+  DBSRowsBitmap& Not(const ROW_INDEX rowsCount);
+  DBSRowsBitmap& Crop(const ROW_INDEX fromRow, const ROW_INDEX toRow);
+
+  DArray Rows() const;
+  static DBSRowsBitmap FromRows(const DArray& rows);
+
+  struct Chunk
+  {
+    std::vector<uint16_t>  mRows;
+    std::vector<uint64_t>  mBits;
+    uint_t                 mCount = 0;
+  };
+
+private:
+  std::map<uint64_t, Chunk>   mChunks;
+};
+
+/* Describes a block of consecutive rows for which a table keeps a summary
+ * of a field's values (see ITable::RetrieveZone()). The bounds reported
+ * along with a zone may be looser than the values the zone actually holds,
+ * but never narrower; they are null if the zone never held a value. */
+struct DBSZone
+{
+  ROW_INDEX   mFirstRow;
+  ROW_INDEX   mLastRow;
+  ROW_INDEX   mNullsCount;
+};
+
+
+/* A table's field resolved for repeated reads of its values (see
+ * ITable::AccessField()). It keeps the block of rows the last read went
+ * to, so the rows following it are read without looking again for the
+ * field's description and without taking the table's rows lock. It has
+ * to be released before the table it was obtained from, and it shall
+ * not be used by two threads at once. */
+class DBS_SHL IFieldAccess
+{
+public:
+  virtual FIELD_INDEX Field() const = 0;
+
+  virtual void Get(const ROW_INDEX row, DBool& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DChar& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DDate& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DDateTime& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DHiresTime& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DUInt8& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DUInt16& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DUInt32& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DUInt64& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DInt8& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DInt16& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DInt32& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DInt64& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DReal& outValue) = 0;
+  virtual void Get(const ROW_INDEX row, DRichReal& outValue) = 0;
+
+  virtual void Release() = 0;
+
+protected:
+  virtual ~IFieldAccess() = default;
+};
+
+
 class DBS_SHL ITable
 {
 public:
@@ -61,6 +176,8 @@ public:
   virtual ROW_INDEX GetReusableRow(const bool forceAdd) = 0;
   virtual ROW_INDEX ReusableRowsCount() = 0;
   virtual void MarkRowForReuse(const ROW_INDEX row) = 0;
+  virtual ROW_INDEX MarkRowsForReuse(const DArray& rows) = 0;
+  virtual ROW_INDEX MarkRowsForReuse(const ROW_INDEX fromRow, const ROW_INDEX toRow) = 0;
 
   virtual void CreateIndex(const FIELD_INDEX                   field,
                            CREATE_INDEX_CALLBACK_FUNC* const   cbFunc,
@@ -68,6 +185,22 @@ public:
   virtual void RemoveIndex(const FIELD_INDEX field) = 0;
   virtual bool IsIndexed(const FIELD_INDEX field) const = 0;
 
+  virtual void CreateCompositeIndex(const FIELD_INDEX* const          fields,
+                                    const uint_t                      fieldsCount,
+                                    CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
+                                    CreateIndexCallbackContext* const cbContext) = 0;
+  virtual void RemoveCompositeIndex(const FIELD_INDEX* const fields,
+                                    const uint_t             fieldsCount) = 0;
+  virtual bool IsCompositeIndexed(const FIELD_INDEX* const fields,
+                                  const uint_t             fieldsCount) const = 0;
+
+  /* Only the list of the bitmap indexed fields is saved with the table. The
+   * bitmaps themselves are rebuilt in memory the first time one is needed
+   * after the table was opened. */
+  virtual void CreateBitmapIndex(const FIELD_INDEX field) = 0;
+  virtual void RemoveBitmapIndex(const FIELD_INDEX field) = 0;
+  virtual bool IsBitmapIndexed(const FIELD_INDEX field) const = 0;
+
   virtual void Set(const ROW_INDEX     row,
                    const FIELD_INDEX   field,
                    const DBool&        value,
@@ -292,6 +425,108 @@ public:
                            const ROW_INDEX     fromRow,
                            const ROW_INDEX     toRow,
                            const FIELD_INDEX   field) = 0;
+  virtual DArray MatchCompositeRows(const DBSCompositeKey&   min,
+                                    const DBSCompositeKey&   max,
+                                    const ROW_INDEX          fromRow,
+                                    const ROW_INDEX          toRow,
+                                    const FIELD_INDEX* const fields,
+                                    const uint_t             fieldsCount) = 0;
+
+  virtual DBSRowsBitmap MatchRowsBitmap(const DBool&        min,
+                                        const DBool&        max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) = 0;
+  virtual DBSRowsBitmap MatchRowsBitmap(const DChar&        min,
+                                        const DChar&        max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) = 0;
+  virtual DBSRowsBitmap MatchRowsBitmap(const DUInt8&       min,
+                                        const DUInt8&       max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) = 0;
+
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DBool&            outMin,
+                               DBool&            outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DChar&            outMin,
+                               DChar&            outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DDate&            outMin,
+                               DDate&            outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DDateTime&        outMin,
+                               DDateTime&        outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DHiresTime&       outMin,
+                               DHiresTime&       outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt8&           outMin,
+                               DUInt8&           outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt16&          outMin,
+                               DUInt16&          outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt32&          outMin,
+                               DUInt32&          outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt64&          outMin,
+                               DUInt64&          outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt8&            outMin,
+                               DInt8&            outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt16&           outMin,
+                               DInt16&           outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt32&           outMin,
+                               DInt32&           outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt64&           outMin,
+                               DInt64&           outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DReal&            outMin,
+                               DReal&            outMax,
+                               const bool        skipThreadSafety = false) = 0;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DRichReal&        outMin,
+                               DRichReal&        outMax,
+                               const bool        skipThreadSafety = false) = 0;
+
+  //Only the fields of fixed size types (e.g. no text and no arrays)
+  //may be accessed this way.
+  virtual IFieldAccess& AccessField(const FIELD_INDEX field) = 0;
 
   virtual void Flush() = 0;
   virtual void LockTable() = 0;
@@ -0,0 +1,572 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include <algorithm>
+#include <iterator>
+
+#include "dbs/dbs_table.h"
+
+#include "ps_bitmap_index.h"
+
+
+using namespace std;
+
+namespace whais {
+
+
+static const uint_t CHUNK_BITS         = 16;
+static const uint_t CHUNK_ROWS         = 1 << CHUNK_BITS;
+static const uint_t CHUNK_WORDS        = CHUNK_ROWS / 64;
+
+//Past this count a chunk's rows take less memory kept as a bit set.
+static const uint_t CHUNK_SPARSE_LIMIT = CHUNK_WORDS * sizeof(uint64_t) / sizeof(uint16_t);
+
+
+typedef DBSRowsBitmap::Chunk Chunk;
+
+
+static uint_t
+count_bits(uint64_t word)
+{
+  word = word - ((word >> 1) & 0x5555555555555555ull);
+  word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+  word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+
+  return (word * 0x0101010101010101ull) >> 56;
+}
+
+
+static void
+recount_chunk(Chunk& chunk)
+{
+  if (chunk.mBits.empty())
+  {
+    chunk.mCount = chunk.mRows.size();
+    return;
+  }
+
+  chunk.mCount = 0;
+  for (auto word : chunk.mBits)
+    chunk.mCount += count_bits(word);
+}
+
+
+static void
+chunk_to_bits(Chunk& chunk)
+{
+  if ( ! chunk.mBits.empty())
+    return;
+
+  chunk.mBits.assign(CHUNK_WORDS, 0);
+  for (auto row : chunk.mRows)
+    chunk.mBits[row / 64] |= 1ull << (row % 64);
+
+  chunk.mRows.clear();
+  chunk.mRows.shrink_to_fit();
+}
+
+
+static void
+chunk_to_rows(Chunk& chunk)
+{
+  if (chunk.mBits.empty())
+    return;
+
+  chunk.mRows.clear();
+  chunk.mRows.reserve(chunk.mCount);
+  for (uint_t w = 0; w < CHUNK_WORDS; ++w)
+  {
+    uint64_t word = chunk.mBits[w];
+    for (uint_t bit = 0; word != 0; ++bit, word >>= 1)
+    {
+      if (word & 1)
+        chunk.mRows.push_back(w * 64 + bit);
+    }
+  }
+
+  chunk.mBits.clear();
+  chunk.mBits.shrink_to_fit();
+}
+
+
+static void
+normalize_chunk(Chunk& chunk)
+{
+  if (chunk.mBits.empty())
+  {
+    if (chunk.mCount > CHUNK_SPARSE_LIMIT)
+      chunk_to_bits(chunk);
+  }
+  else if (chunk.mCount <= CHUNK_SPARSE_LIMIT)
+    chunk_to_rows(chunk);
+}
+
+
+static bool
+chunk_contains(const Chunk& chunk, const uint16_t row)
+{
+  if (chunk.mBits.empty())
+    return binary_search(chunk.mRows.begin(), chunk.mRows.end(), row);
+
+  return (chunk.mBits[row / 64] & (1ull << (row % 64))) != 0;
+}
+
+
+void
+DBSRowsBitmap::Add(const ROW_INDEX row)
+{
+  Chunk& chunk = mChunks[row >> CHUNK_BITS];
+  const uint16_t offset = row & (CHUNK_ROWS - 1);
+
+  if (chunk.mBits.empty())
+  {
+    auto it = lower_bound(chunk.mRows.begin(), chunk.mRows.end(), offset);
+    if ((it != chunk.mRows.end()) && (*it == offset))
+      return;
+
+    chunk.mRows.insert(it, offset);
+  }
+  else
+  {
+    uint64_t& word = chunk.mBits[offset / 64];
+    const uint64_t mask = 1ull << (offset % 64);
+    if (word & mask)
+      return;
+
+    word |= mask;
+  }
+
+  chunk.mCount++;
+  normalize_chunk(chunk);
+}
+
+
+void
+DBSRowsBitmap::Remove(const ROW_INDEX row)
+{
+  auto it = mChunks.find(row >> CHUNK_BITS);
+  if (it == mChunks.end())
+    return;
+
+  Chunk& chunk = it->second;
+  const uint16_t offset = row & (CHUNK_ROWS - 1);
+
+  if (chunk.mBits.empty())
+  {
+    auto pos = lower_bound(chunk.mRows.begin(), chunk.mRows.end(), offset);
+    if ((pos == chunk.mRows.end()) || (*pos != offset))
+      return;
+
+    chunk.mRows.erase(pos);
+  }
+  else
+  {
+    uint64_t& word = chunk.mBits[offset / 64];
+    const uint64_t mask = 1ull << (offset % 64);
+    if ((word & mask) == 0)
+      return;
+
+    word &= ~mask;
+  }
+
+  if (--chunk.mCount == 0)
+    mChunks.erase(it);
+
+  else
+    normalize_chunk(chunk);
+}
+
+
+bool
+DBSRowsBitmap::Contains(const ROW_INDEX row) const
+{
+  auto it = mChunks.find(row >> CHUNK_BITS);
+  if (it == mChunks.end())
+    return false;
+
+  return chunk_contains(it->second, row & (CHUNK_ROWS - 1));
+}
+
+
+ROW_INDEX
+DBSRowsBitmap::Count() const
+{
+  ROW_INDEX result = 0;
+
+  for (auto& chunk : mChunks)
+    result += chunk.second.mCount;
+
+  return result;
+}
+
+
+DBSRowsBitmap&
+DBSRowsBitmap::And(const DBSRowsBitmap& other)
+{
+  for (auto it = mChunks.begin(); it != mChunks.end(); )
+  {
+    auto otherIt = other.mChunks.find(it->first);
+    if (otherIt == other.mChunks.end())
+    {
+      it = mChunks.erase(it);
+      continue;
+    }
+
+    Chunk& chunk = it->second;
+    const Chunk& otherChunk = otherIt->second;
+
+    if (chunk.mBits.empty() && otherChunk.mBits.empty())
+    {
+      vector<uint16_t> rows;
+      set_intersection(chunk.mRows.begin(), chunk.mRows.end(),
+                       otherChunk.mRows.begin(), otherChunk.mRows.end(),
+                       back_inserter(rows));
+      chunk.mRows.swap(rows);
+    }
+    else if (chunk.mBits.empty() || otherChunk.mBits.empty())
+    {
+      const Chunk& sparse = chunk.mBits.empty() ? chunk : otherChunk;
+      const Chunk& dense = chunk.mBits.empty() ? otherChunk : chunk;
+
+      vector<uint16_t> rows;
+      for (auto row : sparse.mRows)
+      {
+        if (chunk_contains(dense, row))
+          rows.push_back(row);
+      }
+      chunk.mBits.clear();
+      chunk.mRows.swap(rows);
+    }
+    else
+    {
+      for (uint_t w = 0; w < CHUNK_WORDS; ++w)
+        chunk.mBits[w] &= otherChunk.mBits[w];
+    }
+
+    recount_chunk(chunk);
+    if (chunk.mCount == 0)
+    {
+      it = mChunks.erase(it);
+      continue;
+    }
+
+    normalize_chunk(chunk);
+    ++it;
+  }
+
+  return *this;
+}
+
+
+DBSRowsBitmap&
+DBSRowsBitmap::Or(const DBSRowsBitmap& other)
+{
+  for (auto& otherIt : other.mChunks)
+  {
+    Chunk& chunk = mChunks[otherIt.first];
+    const Chunk& otherChunk = otherIt.second;
+
+    if (chunk.mBits.empty() && otherChunk.mBits.empty())
+    {
+      vector<uint16_t> rows;
+      set_union(chunk.mRows.begin(), chunk.mRows.end(),
+                otherChunk.mRows.begin(), otherChunk.mRows.end(),
+                back_inserter(rows));
+      chunk.mRows.swap(rows);
+    }
+    else
+    {
+      chunk_to_bits(chunk);
+      if (otherChunk.mBits.empty())
+      {
+        for (auto row : otherChunk.mRows)
+          chunk.mBits[row / 64] |= 1ull << (row % 64);
+      }
+      else
+      {
+        for (uint_t w = 0; w < CHUNK_WORDS; ++w)
+          chunk.mBits[w] |= otherChunk.mBits[w];
+      }
+    }
+
+    recount_chunk(chunk);
+    normalize_chunk(chunk);
+  }
+
+  return *this;
+}
+
+
+DBSRowsBitmap&
+DBSRowsBitmap::AndNot(const DBSRowsBitmap& other)
+{
+  for (auto it = mChunks.begin(); it != mChunks.end(); )
+  {
+    auto otherIt = other.mChunks.find(it->first);
+    if (otherIt == other.mChunks.end())
+    {
+      ++it;
+      continue;
+    }
+
+    Chunk& chunk = it->second;
+    const Chunk& otherChunk = otherIt->second;
+
+    if (chunk.mBits.empty())
+    {
+      vector<uint16_t> rows;
+      for (auto row : chunk.mRows)
+      {
+        if ( ! chunk_contains(otherChunk, row))
+          rows.push_back(row);
+      }
+      chunk.mRows.swap(rows);
+    }
+    else if (otherChunk.mBits.empty())
+    {
+      for (auto row : otherChunk.mRows)
+        chunk.mBits[row / 64] &= ~(1ull << (row % 64));
+    }
+    else
+    {
+      for (uint_t w = 0; w < CHUNK_WORDS; ++w)
+        chunk.mBits[w] &= ~otherChunk.mBits[w];
+    }
+
+    recount_chunk(chunk);
+    if (chunk.mCount == 0)
+    {
+      it = mChunks.erase(it);
+      continue;
+    }
+
+    normalize_chunk(chunk);
+    ++it;
+  }
+
+  return *this;
+}
+
+
+DBSRowsBitmap&
+DBSRowsBitmap::Not(const ROW_INDEX rowsCount)
+{
+  map<uint64_t, Chunk> result;
+
+  const uint64_t chunksCount = (rowsCount + CHUNK_ROWS - 1) >> CHUNK_BITS;
+  for (uint64_t key = 0; key < chunksCount; ++key)
+  {
+    Chunk chunk;
+    chunk.mBits.assign(CHUNK_WORDS, ~0ull);
+
+    const ROW_INDEX chunkRows = MIN(rowsCount - (key << CHUNK_BITS), CHUNK_ROWS);
+    for (uint_t row = chunkRows; row < CHUNK_ROWS; ++row)
+      chunk.mBits[row / 64] &= ~(1ull << (row % 64));
+
+    auto it = mChunks.find(key);
+    if (it != mChunks.end())
+    {
+      const Chunk& current = it->second;
+      if (current.mBits.empty())
+      {
+        for (auto row : current.mRows)
+          chunk.mBits[row / 64] &= ~(1ull << (row % 64));
+      }
+      else
+      {
+        for (uint_t w = 0; w < CHUNK_WORDS; ++w)
+          chunk.mBits[w] &= ~current.mBits[w];
+      }
+    }
+
+    recount_chunk(chunk);
+    if (chunk.mCount == 0)
+      continue;
+
+    normalize_chunk(chunk);
+    result[key] = move(chunk);
+  }
+
+  mChunks.swap(result);
+  return *this;
+}
+
+
+DBSRowsBitmap&
+DBSRowsBitmap::Crop(const ROW_INDEX fromRow, const ROW_INDEX toRow)
+{
+  if (fromRow > toRow)
+  {
+    mChunks.clear();
+    return *this;
+  }
+
+  const uint64_t firstKey = fromRow >> CHUNK_BITS;
+  const uint64_t lastKey = toRow >> CHUNK_BITS;
+
+  mChunks.erase(mChunks.begin(), mChunks.lower_bound(firstKey));
+  mChunks.erase(mChunks.upper_bound(lastKey), mChunks.end());
+
+  for (auto key : {firstKey, lastKey})
+  {
+    auto it = mChunks.find(key);
+    if (it == mChunks.end())
+      continue;
+
+    Chunk& chunk = it->second;
+    const uint_t from = (key == firstKey) ? (fromRow & (CHUNK_ROWS - 1)) : 0;
+    const uint_t to = (key == lastKey) ? (toRow & (CHUNK_ROWS - 1)) : CHUNK_ROWS - 1;
+
+    chunk_to_bits(chunk);
+    for (uint_t row = 0; row < from; ++row)
+      chunk.mBits[row / 64] &= ~(1ull << (row % 64));
+
+    for (uint_t row = to + 1; row < CHUNK_ROWS; ++row)
+      chunk.mBits[row / 64] &= ~(1ull << (row % 64));
+
+    recount_chunk(chunk);
+    if (chunk.mCount == 0)
+      mChunks.erase(it);
+
+    else
+      normalize_chunk(chunk);
+  }
+
+  return *this;
+}
+
+
+DArray
+DBSRowsBitmap::Rows() const
+{
+  DArray result;
+
+  for (auto& it : mChunks)
+  {
+    const ROW_INDEX base = it.first << CHUNK_BITS;
+    const Chunk& chunk = it.second;
+
+    if (chunk.mBits.empty())
+    {
+      for (auto row : chunk.mRows)
+        result.Add(DROW_INDEX(base + row));
+
+      continue;
+    }
+
+    for (uint_t w = 0; w < CHUNK_WORDS; ++w)
+    {
+      uint64_t word = chunk.mBits[w];
+      for (uint_t bit = 0; word != 0; ++bit, word >>= 1)
+      {
+        if (word & 1)
+          result.Add(DROW_INDEX(base + w * 64 + bit));
+      }
+    }
+  }
+
+  return result;
+}
+
+
+DBSRowsBitmap
+DBSRowsBitmap::FromRows(const DArray& rows)
+{
+  DBSRowsBitmap result;
+
+  const uint64_t rowsCount = rows.Count();
+  for (uint64_t i = 0; i < rowsCount; ++i)
+  {
+    DROW_INDEX row;
+
+    rows.Get(i, row);
+    if ( ! row.IsNull())
+      result.Add(row.mValue);
+  }
+
+  return result;
+}
+
+
+
+namespace pastra {
+
+
+
+void
+FieldBitmapIndex::Insert(const bool isNull, const uint32_t key, const ROW_INDEX row)
+{
+  if (isNull)
+    mNulls.Add(row);
+
+  else
+    mValues[key].Add(row);
+}
+
+
+void
+FieldBitmapIndex::Remove(const bool isNull, const uint32_t key, const ROW_INDEX row)
+{
+  if (isNull)
+  {
+    mNulls.Remove(row);
+    return;
+  }
+
+  auto it = mValues.find(key);
+  if (it == mValues.end())
+    return;
+
+  it->second.Remove(row);
+  if (it->second.IsEmpty())
+    mValues.erase(it);
+}
+
+
+DBSRowsBitmap
+FieldBitmapIndex::Match(const bool       minIsNull,
+                        const uint32_t   minKey,
+                        const bool       maxIsNull,
+                        const uint32_t   maxKey) const
+{
+  DBSRowsBitmap result;
+
+  //Null values are smaller than any other value.
+  if (minIsNull)
+    result.Or(mNulls);
+
+  if (maxIsNull)
+    return result;
+
+  auto it = minIsNull ? mValues.begin() : mValues.lower_bound(minKey);
+  for (; (it != mValues.end()) && (it->first <= maxKey); ++it)
+    result.Or(it->second);
+
+  return result;
+}
+
+
+} //namespace pastra
+} //namespace whais
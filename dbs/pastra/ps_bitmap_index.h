@@ -0,0 +1,114 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#ifndef PS_BITMAP_INDEX_H_
+#define PS_BITMAP_INDEX_H_
+
+#include <assert.h>
+#include <map>
+
+#include "whais.h"
+
+#include "dbs/dbs_table.h"
+
+
+namespace whais {
+namespace pastra {
+
+
+static const uint_t BITMAP_INDEXES_MAX_COUNT = 8;
+
+
+/* Bitmap indexes are meant for fields with only a few distinct values,
+ * hence they are available only for these types. */
+inline bool
+bitmap_index_supported(const uint_t type)
+{
+  return (type == T_BOOL) || (type == T_CHAR) || (type == T_UINT8);
+}
+
+inline uint32_t
+bitmap_index_key(const DBool& value)
+{
+  return value.mValue ? 1 : 0;
+}
+
+inline uint32_t
+bitmap_index_key(const DChar& value)
+{
+  return value.mValue;
+}
+
+inline uint32_t
+bitmap_index_key(const DUInt8& value)
+{
+  return value.mValue;
+}
+
+template<class T> uint32_t
+bitmap_index_key(const T&)
+{
+  assert(false);
+  return 0;
+}
+
+
+/* Keeps one rows bitmap for every distinct value of a field. The index
+ * lives only in memory and it's built the first time is needed after the
+ * table was opened. */
+class FieldBitmapIndex
+{
+public:
+  explicit FieldBitmapIndex(const FIELD_INDEX field)
+    : mField(field),
+      mBuilt(false)
+  {
+  }
+
+  FIELD_INDEX Field() const { return mField; }
+  bool IsBuilt() const { return mBuilt; }
+  void MarkBuilt() { mBuilt = true; }
+
+  void Insert(const bool isNull, const uint32_t key, const ROW_INDEX row);
+  void Remove(const bool isNull, const uint32_t key, const ROW_INDEX row);
+
+  DBSRowsBitmap Match(const bool       minIsNull,
+                      const uint32_t   minKey,
+                      const bool       maxIsNull,
+                      const uint32_t   maxKey) const;
+
+private:
+  const FIELD_INDEX                   mField;
+  bool                                mBuilt;
+  DBSRowsBitmap                       mNulls;
+  std::map<uint32_t, DBSRowsBitmap>   mValues;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+
+#endif /* PS_BITMAP_INDEX_H_ */
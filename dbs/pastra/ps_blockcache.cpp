@@ -36,6 +36,9 @@ BlockCache::BlockCache()
     mItemSize(0),
     mBlockSize(0),
     mMaxCachedBlocks(0),
+    mSkipFlush(false),
+    mLastLoadedBlock(~0ull),
+    mReadAheadEnd(0),
     mCachedBlocks()
 {
 }
@@ -121,7 +124,10 @@ BlockCache::RetriveItem(const uint64_t item)
     while (it != mCachedBlocks.end())
     {
       if (it->second.IsInUse())
+      {
+        ++it;
         continue;
+      }
 
       uint8_t* const data_ = it->second.Data();
 
@@ -145,9 +151,37 @@ BlockCache::RetriveItem(const uint64_t item)
 
   mManager->RetrieveItems(baseBlockItem, itemsPerBlock, data_);
 
+  ReadAhead(baseBlockItem);
+
   return StoredItem(mCachedBlocks.find(baseBlockItem)->second, (item % itemsPerBlock) * mItemSize);
 }
 
+void
+BlockCache::ReadAhead(const uint64_t baseBlockItem)
+{
+  const uint_t itemsPerBlock = mBlockSize / mItemSize;
+  const bool sequential = (mLastLoadedBlock + itemsPerBlock == baseBlockItem);
+
+  mLastLoadedBlock = baseBlockItem;
+
+  /* Ask for the next blocks only when the loads follow each other, and
+   * only for the part that was not requested already. */
+  if ( ! sequential)
+  {
+    mReadAheadEnd = 0;
+    return;
+  }
+
+  const uint64_t readAheadEnd = baseBlockItem + (READ_AHEAD_BLOCKS + 1) * itemsPerBlock;
+  const uint64_t readAheadStart = MAX(baseBlockItem + itemsPerBlock, mReadAheadEnd);
+
+  if (readAheadStart >= readAheadEnd)
+    return;
+
+  mManager->PrefetchItems(readAheadStart, readAheadEnd - readAheadStart);
+  mReadAheadEnd = readAheadEnd;
+}
+
 void
 BlockCache::FlushItem(const uint64_t item)
 {
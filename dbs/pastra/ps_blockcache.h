@@ -44,6 +44,9 @@ public:
 
   virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from) = 0;
   virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) = 0;
+
+  //Hints that the items are likely to be retrieved soon.
+  virtual void PrefetchItems(uint64_t, uint_t) {}
 };
 
 
@@ -145,12 +148,21 @@ public:
   void RefreshItem(const uint64_t item);
   StoredItem RetriveItem(const uint64_t item);
 
+  uint_t ItemsPerBlock() const { return mBlockSize / mItemSize; }
+
+  //How many blocks to read ahead once the blocks are loaded in sequence.
+  static const uint_t READ_AHEAD_BLOCKS = 8;
+
 private:
+  void ReadAhead(const uint64_t baseBlockItem);
+
   IBlocksManager  *mManager;
   uint_t           mItemSize;
   uint_t           mBlockSize;
   uint_t           mMaxCachedBlocks;
   bool             mSkipFlush;
+  uint64_t         mLastLoadedBlock;
+  uint64_t         mReadAheadEnd;
 
   std::map<uint64_t, BlockEntry> mCachedBlocks;
 };
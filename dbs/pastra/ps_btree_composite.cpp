@@ -0,0 +1,617 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#include "dbs/dbs_table.h"
+
+#include "ps_btree_composite.h"
+
+
+using namespace std;
+
+namespace whais {
+namespace pastra {
+
+
+static void
+store_ordered_chunk(const uint8_t* const   src,
+                    const uint_t           size,
+                    const bool             isSigned,
+                    uint8_t* const         dest)
+{
+  //Serialized values are little endian, but the keys are compared byte by byte.
+  for (uint_t i = 0; i < size; ++i)
+    dest[i] = src[size - 1 - i];
+
+  if (isSigned)
+    dest[0] ^= 0x80;
+}
+
+
+uint_t
+composite_key_part_size(const DBS_FIELD_TYPE type)
+{
+  if ((type <= T_UNKNOWN) || (type >= T_TEXT))
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
+                       "Composite indexes are available only for fields of basic "
+                       "types (e.g. no text or arrays).");
+  }
+
+  return sizeof(uint8_t) + Serializer::Size(type, false);
+}
+
+
+void
+composite_key_store_part(const DBS_FIELD_TYPE    type,
+                         const uint8_t* const    serialized,
+                         uint8_t* const          dest)
+{
+  const uint_t valueSize = composite_key_part_size(type) - 1;
+
+  if (serialized == nullptr)
+  {
+    dest[0] = COMPOSITE_KEY_NULL_PART;
+    memset(dest + 1, 0, valueSize);
+
+    return;
+  }
+
+  dest[0] = COMPOSITE_KEY_VALUE_PART;
+
+  uint8_t* const value = dest + 1;
+  switch (type)
+  {
+  case T_BOOL:
+  case T_CHAR:
+  case T_UINT8:
+  case T_UINT16:
+  case T_UINT32:
+  case T_UINT64:
+    store_ordered_chunk(serialized, valueSize, false, value);
+    break;
+
+  case T_INT8:
+  case T_INT16:
+  case T_INT32:
+  case T_INT64:
+    store_ordered_chunk(serialized, valueSize, true, value);
+    break;
+
+  case T_DATE:
+  case T_DATETIME:
+    //The year goes first, followed by the rest of the fields in the right order.
+    store_ordered_chunk(serialized, 2, true, value);
+    memcpy(value + 2, serialized + 2, valueSize - 2);
+    break;
+
+  case T_HIRESTIME:
+    store_ordered_chunk(serialized + 4, 2, true, value);
+    memcpy(value + 2, serialized + 6, 5);
+    store_ordered_chunk(serialized, 4, true, value + 7);
+    break;
+
+  case T_REAL:
+    store_ordered_chunk(serialized, 5, true, value);
+    store_ordered_chunk(serialized + 5, 3, true, value + 5);
+    break;
+
+  case T_RICHREAL:
+    store_ordered_chunk(serialized, 8, true, value);
+    store_ordered_chunk(serialized + 8, 6, true, value + 8);
+    break;
+
+  default:
+    assert(false);
+  }
+}
+
+
+CompositeBTreeNode::CompositeBTreeNode(IBTreeNodeManager& nodesManager,
+                                       const NODE_INDEX   node,
+                                       const uint_t       keySize)
+  : IBTreeFieldIndexNode(nodesManager, node),
+    mKeySize(keySize),
+    mSentinelData(unique_array_make(uint8_t, keySize)),
+    mSentinel(mSentinelData.get(), keySize, ~_SC(ROW_INDEX, 0))
+{
+  //The null flag of a key part is never bigger than COMPOSITE_KEY_VALUE_PART.
+  memset(mSentinelData.get(), 0xFF, mKeySize);
+}
+
+
+uint_t
+CompositeBTreeNode::KeysPerNode() const
+{
+  assert(sizeof(NodeHeader) % 16 == 0);
+
+  uint_t result = mRawNodeSize - sizeof(NodeHeader);
+
+  if (IsLeaf())
+    result /= sizeof(ROW_INDEX) + mKeySize;
+
+  else
+    result /= sizeof(ROW_INDEX) + sizeof(NODE_INDEX) + mKeySize;
+
+  return result;
+}
+
+
+KEY_INDEX
+CompositeBTreeNode::GetParentKeyIndex(const IBTreeNode& parent) const
+{
+  assert(KeysCount() > 0);
+
+  KEY_INDEX result = ~0;
+
+  parent.FindBiggerOrEqual(GetKey(0), &result);
+
+  assert(parent.CompareKey(GetKey(0), result) == 0);
+  assert(NodeId() == parent.NodeIdOfKey(result));
+
+  return result;
+}
+
+
+NODE_INDEX
+CompositeBTreeNode::NodeIdOfKey(const KEY_INDEX keyIndex) const
+{
+  assert(keyIndex < KeysCount());
+  assert(IsLeaf() == false);
+
+  const auto rows = _RC(const ROW_INDEX*, DataForRead());
+  const auto childNodes = _RC(const NODE_INDEX*, rows + KeysPerNode());
+
+  return Serializer::LoadNode(childNodes + keyIndex);
+}
+
+
+void
+CompositeBTreeNode::SetNodeOfKey(const KEY_INDEX keyIndex, const NODE_INDEX childNode)
+{
+  assert(keyIndex < KeysCount());
+  assert(IsLeaf() == false);
+
+  const auto rows = _RC(ROW_INDEX*, DataForWrite());
+  const auto childNodes = _RC(NODE_INDEX*, rows + KeysPerNode());
+
+  Serializer::StoreNode(childNode, childNodes + keyIndex);
+}
+
+
+void
+CompositeBTreeNode::AdjustKeyNode(const IBTreeNode& childNode, const KEY_INDEX keyIndex)
+{
+  const auto& node = _SC(const CompositeBTreeNode&, childNode);
+
+  SetKey(node.GetKey(0), keyIndex);
+}
+
+
+KEY_INDEX
+CompositeBTreeNode::InsertKey(const IBTreeKey& key)
+{
+  const auto& theKey = _SC(const CompositeBTreeKey&, key);
+  KEY_INDEX keyIndex = ~0;
+
+  assert(theKey.mKeySize == mKeySize);
+
+  if (KeysCount() == 0)
+  {
+    KeysCount(1);
+    SetKey(theKey, 0);
+
+    return 0;
+  }
+  else if (FindBiggerOrEqual(key, &keyIndex) == false)
+    keyIndex = 0;
+
+  else
+    ++keyIndex;
+
+  const auto rows = _RC(ROW_INDEX*, DataForWrite());
+  const KEY_INDEX lastKey = KeysCount() - 1;
+
+  make_array_room(lastKey, keyIndex, sizeof(ROW_INDEX), _RC(uint8_t*, rows));
+  if (IsLeaf() == false)
+  {
+    const auto childNodes = _RC(NODE_INDEX*, rows + KeysPerNode());
+    make_array_room(lastKey, keyIndex, sizeof(NODE_INDEX), _RC(uint8_t*, childNodes));
+  }
+  make_array_room(lastKey, keyIndex, mKeySize, KeysForWrite());
+
+  KeysCount(KeysCount() + 1);
+  SetKey(theKey, keyIndex);
+
+  return keyIndex;
+}
+
+
+void
+CompositeBTreeNode::RemoveKey(const KEY_INDEX keyIndex)
+{
+  assert(keyIndex < KeysCount());
+
+  const uint_t lastKey = KeysCount() - 1;
+  const auto rows = _RC(ROW_INDEX*, DataForWrite());
+
+  remove_array_elemes(lastKey, keyIndex, sizeof(ROW_INDEX), _RC(uint8_t*, rows));
+  if (IsLeaf() == false)
+  {
+    const auto childNodes = _RC(NODE_INDEX*, rows + KeysPerNode());
+    remove_array_elemes(lastKey, keyIndex, sizeof(NODE_INDEX), _RC(uint8_t*, childNodes));
+  }
+  remove_array_elemes(lastKey, keyIndex, mKeySize, KeysForWrite());
+
+  KeysCount(KeysCount() - 1);
+}
+
+
+void
+CompositeBTreeNode::Split(const NODE_INDEX parent)
+{
+  assert(NeedsSpliting());
+
+  const KEY_INDEX splitKeyIndex = KeysCount() / 2;
+  const CompositeBTreeKey splitKey = GetKey(splitKeyIndex);
+
+  auto parentNode = mNodesMgr.RetrieveNode(parent);
+
+  const KEY_INDEX insertPosition = parentNode->InsertKey(splitKey);
+  const NODE_INDEX allocatedNodeId = mNodesMgr.AllocateNode(parent, insertPosition);
+  auto allocatedNode = mNodesMgr.RetrieveNode(allocatedNodeId);
+  const auto node = _SC(CompositeBTreeNode*, allocatedNode.get());
+
+  allocatedNode->Leaf(IsLeaf());
+  allocatedNode->MarkAsUsed();
+  allocatedNode->KeysCount(KeysCount() - splitKeyIndex);
+  allocatedNode->NullKeysCount(0);
+
+  for (KEY_INDEX index = splitKeyIndex; index < KeysCount(); ++index)
+    node->SetKey(GetKey(index), index - splitKeyIndex);
+
+  if ( ! IsLeaf())
+  {
+    for (KEY_INDEX index = splitKeyIndex; index < KeysCount(); ++index)
+      node->SetNodeOfKey(index - splitKeyIndex, NodeIdOfKey(index));
+  }
+
+  KeysCount(splitKeyIndex);
+
+  allocatedNode->Next(NodeId());
+  allocatedNode->Prev(Prev());
+  Prev(allocatedNodeId);
+  if (allocatedNode->Prev() != NIL_NODE)
+    mNodesMgr.RetrieveNode(allocatedNode->Prev())->Next(allocatedNodeId);
+}
+
+
+void
+CompositeBTreeNode::Join(const bool toRight)
+{
+  if (toRight)
+  {
+    assert(Next() != NIL_NODE);
+
+    auto next = mNodesMgr.RetrieveNode(Next());
+
+    const auto nextNode = _SC(CompositeBTreeNode*, next.get());
+    const KEY_INDEX oldKeysCount = nextNode->KeysCount();
+
+    nextNode->KeysCount(oldKeysCount + KeysCount());
+
+    for (KEY_INDEX index = 0; index < KeysCount(); ++index)
+      nextNode->SetKey(GetKey(index), index + oldKeysCount);
+
+    if ( ! IsLeaf())
+    {
+      for (KEY_INDEX index = 0; index < KeysCount(); ++index)
+        nextNode->SetNodeOfKey(index + oldKeysCount, NodeIdOfKey(index));
+    }
+
+    nextNode->Prev(Prev());
+    if (Prev() != NIL_NODE)
+      mNodesMgr.RetrieveNode(Prev())->Next(Next());
+
+    assert(nextNode->KeysCount() <= nextNode->KeysPerNode());
+  }
+  else
+  {
+    assert(Prev() != NIL_NODE);
+
+    auto prev = mNodesMgr.RetrieveNode(Prev());
+
+    const auto prevNode = _SC(CompositeBTreeNode*, prev.get());
+    const KEY_INDEX oldKeysCount = KeysCount();
+
+    KeysCount(oldKeysCount + prevNode->KeysCount());
+
+    for (KEY_INDEX index = 0; index < prevNode->KeysCount(); ++index)
+      SetKey(prevNode->GetKey(index), index + oldKeysCount);
+
+    if ( ! IsLeaf())
+    {
+      for (KEY_INDEX index = 0; index < prevNode->KeysCount(); ++index)
+        SetNodeOfKey(index + oldKeysCount, prevNode->NodeIdOfKey(index));
+    }
+
+    Prev(prev->Prev());
+    if (Prev() != NIL_NODE)
+      mNodesMgr.RetrieveNode(Prev())->Next(NodeId());
+
+    assert(KeysCount() <= KeysPerNode());
+  }
+}
+
+
+int
+CompositeBTreeNode::CompareKey(const IBTreeKey& key, const KEY_INDEX nodeKeyIndex) const
+{
+  assert(nodeKeyIndex < KeysCount());
+
+  return _SC(const CompositeBTreeKey&, key).CompareWith(GetKey(nodeKeyIndex));
+}
+
+
+const IBTreeKey&
+CompositeBTreeNode::SentinelKey() const
+{
+  return mSentinel;
+}
+
+
+void
+CompositeBTreeNode::GetRows(KEY_INDEX          fromPos,
+                            KEY_INDEX          toPos,
+                            const ROW_INDEX    fromRow,
+                            const ROW_INDEX    toRow,
+                            DArray&            output) const
+{
+  assert(fromPos >= toPos);
+  assert(fromPos < KeysCount());
+
+  const ROW_INDEX* const rows = _RC(const ROW_INDEX*, DataForRead());
+
+  if ((toPos == 0) && (CompareKey(SentinelKey(), toPos) == 0))
+    ++toPos;
+
+  while (fromPos >= toPos)
+  {
+    const auto row = Serializer::LoadRow(rows + fromPos);
+    if (fromRow <= row && row <= toRow)
+      output.Add(DROW_INDEX(row));
+
+    if (fromPos == 0)
+      break;
+
+    fromPos--;
+  }
+}
+
+
+const CompositeBTreeKey
+CompositeBTreeNode::GetKey(const KEY_INDEX keyIndex) const
+{
+  assert(keyIndex < KeysCount());
+
+  const auto rows = _RC(const ROW_INDEX*, DataForRead());
+
+  return CompositeBTreeKey(KeysForRead() + keyIndex * mKeySize,
+                           mKeySize,
+                           Serializer::LoadRow(rows + keyIndex));
+}
+
+
+void
+CompositeBTreeNode::SetKey(const CompositeBTreeKey& key, const KEY_INDEX keyIndex)
+{
+  assert(keyIndex < KeysCount());
+  assert(key.mKeySize == mKeySize);
+
+  const auto rows = _RC(ROW_INDEX*, DataForWrite());
+
+  memcpy(KeysForWrite() + keyIndex * mKeySize, key.mKeyPart, mKeySize);
+  Serializer::StoreRow(key.mRowPart, rows + keyIndex);
+}
+
+
+const uint8_t*
+CompositeBTreeNode::KeysForRead() const
+{
+  const auto rows = _RC(const ROW_INDEX*, DataForRead());
+
+  if (IsLeaf())
+    return _RC(const uint8_t*, rows + KeysPerNode());
+
+  const auto childNodes = _RC(const NODE_INDEX*, rows + KeysPerNode());
+  return _RC(const uint8_t*, childNodes + KeysPerNode());
+}
+
+
+uint8_t*
+CompositeBTreeNode::KeysForWrite()
+{
+  const auto rows = _RC(ROW_INDEX*, DataForWrite());
+
+  if (IsLeaf())
+    return _RC(uint8_t*, rows + KeysPerNode());
+
+  const auto childNodes = _RC(NODE_INDEX*, rows + KeysPerNode());
+  return _RC(uint8_t*, childNodes + KeysPerNode());
+}
+
+
+} //namespace pastra
+
+
+
+template<class T> static void
+add_composite_part(const DBS_FIELD_TYPE    type,
+                   const T&                value,
+                   vector<DBS_FIELD_TYPE>& types,
+                   vector<uint8_t>&        rawKey)
+{
+  using namespace pastra;
+
+  uint8_t serialized[16];
+  const uint_t partSize = composite_key_part_size(type);
+  const size_t offset = rawKey.size();
+
+  assert(partSize <= sizeof serialized + 1);
+
+  rawKey.resize(offset + partSize);
+  if (value.IsNull())
+    composite_key_store_part(type, nullptr, rawKey.data() + offset);
+
+  else
+  {
+    Serializer::Store(serialized, value);
+    composite_key_store_part(type, serialized, rawKey.data() + offset);
+  }
+
+  types.push_back(type);
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DBool& value)
+{
+  add_composite_part(T_BOOL, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DChar& value)
+{
+  add_composite_part(T_CHAR, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DDate& value)
+{
+  add_composite_part(T_DATE, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DDateTime& value)
+{
+  add_composite_part(T_DATETIME, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DHiresTime& value)
+{
+  add_composite_part(T_HIRESTIME, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DInt8& value)
+{
+  add_composite_part(T_INT8, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DInt16& value)
+{
+  add_composite_part(T_INT16, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DInt32& value)
+{
+  add_composite_part(T_INT32, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DInt64& value)
+{
+  add_composite_part(T_INT64, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DReal& value)
+{
+  add_composite_part(T_REAL, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DRichReal& value)
+{
+  add_composite_part(T_RICHREAL, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DUInt8& value)
+{
+  add_composite_part(T_UINT8, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DUInt16& value)
+{
+  add_composite_part(T_UINT16, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DUInt32& value)
+{
+  add_composite_part(T_UINT32, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+DBSCompositeKey&
+DBSCompositeKey::Add(const DUInt64& value)
+{
+  add_composite_part(T_UINT64, value, mTypes, mRawKey);
+  return *this;
+}
+
+
+} //namespace whais
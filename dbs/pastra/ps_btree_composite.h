@@ -0,0 +1,135 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#ifndef PS_BTREE_COMPOSITE_H_
+#define PS_BTREE_COMPOSITE_H_
+
+#include <assert.h>
+#include <cstring>
+
+#include "whais.h"
+#include "ps_btree_fields.h"
+
+
+namespace whais {
+namespace pastra {
+
+
+static const uint_t COMPOSITE_INDEXES_MAX_COUNT  = 3;
+static const uint_t COMPOSITE_INDEX_MAX_FIELDS   = 6;
+static const uint_t COMPOSITE_KEY_MAX_SIZE       = COMPOSITE_INDEX_MAX_FIELDS * 16;
+
+static const uint8_t COMPOSITE_KEY_NULL_PART     = 0;
+static const uint8_t COMPOSITE_KEY_VALUE_PART    = 1;
+
+
+/* Size of one composite key part (e.g. the null flag plus the value). */
+uint_t
+composite_key_part_size(const DBS_FIELD_TYPE type);
+
+/* Translate a serialized value of the specified type into the order
+ * preserving form used by composite keys. If the serialized value is
+ * not provided the part will be encoded as a null value. */
+void
+composite_key_store_part(const DBS_FIELD_TYPE    type,
+                         const uint8_t* const    serialized,
+                         uint8_t* const          dest);
+
+
+class CompositeBTreeKey : public IBTreeKey
+{
+public:
+  CompositeBTreeKey(const uint8_t* const key, const uint_t keySize, const ROW_INDEX row)
+    : mRowPart(row),
+      mKeySize(keySize),
+      mKeyPart(key)
+  {
+  }
+
+  int CompareWith(const CompositeBTreeKey& key) const
+  {
+    assert(mKeySize == key.mKeySize);
+
+    const int result = memcmp(mKeyPart, key.mKeyPart, mKeySize);
+    if (result != 0)
+      return result;
+
+    if (mRowPart < key.mRowPart)
+      return -1;
+
+    else if (mRowPart == key.mRowPart)
+      return 0;
+
+    return 1;
+  }
+
+  const ROW_INDEX        mRowPart;
+  const uint_t           mKeySize;
+  const uint8_t* const   mKeyPart;
+};
+
+
+class CompositeBTreeNode : public IBTreeFieldIndexNode
+{
+public:
+  CompositeBTreeNode(IBTreeNodeManager& nodesManager,
+                     const NODE_INDEX   node,
+                     const uint_t       keySize);
+
+  virtual uint_t KeysPerNode() const override;
+  virtual KEY_INDEX GetParentKeyIndex(const IBTreeNode& parent) const override;
+  virtual NODE_INDEX NodeIdOfKey(const KEY_INDEX keyIndex) const override;
+  virtual void SetNodeOfKey(const KEY_INDEX keyIndex, const NODE_INDEX childNode) override;
+  virtual void AdjustKeyNode(const IBTreeNode& childNode, const KEY_INDEX keyIndex) override;
+  virtual KEY_INDEX InsertKey(const IBTreeKey& key) override;
+  virtual void RemoveKey(const KEY_INDEX keyIndex) override;
+  virtual void Split(const NODE_INDEX parent) override;
+  virtual void Join(const bool toRight) override;
+  virtual int CompareKey(const IBTreeKey& key, const KEY_INDEX nodeKeyIndex) const override;
+  virtual const IBTreeKey& SentinelKey() const override;
+
+  virtual void GetRows(KEY_INDEX fromPos,
+                       KEY_INDEX toPos,
+                       const ROW_INDEX fromRow,
+                       const ROW_INDEX toRow,
+                       DArray& output) const override;
+
+private:
+  const CompositeBTreeKey GetKey(const KEY_INDEX keyIndex) const;
+  void SetKey(const CompositeBTreeKey& key, const KEY_INDEX keyIndex);
+  const uint8_t* KeysForRead() const;
+  uint8_t* KeysForWrite();
+
+  const uint_t                 mKeySize;
+  std::unique_ptr<uint8_t[]>   mSentinelData;
+  const CompositeBTreeKey      mSentinel;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+
+#endif /* PS_BTREE_COMPOSITE_H_ */
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
 #include "ps_btree_fields.h"
+#include "ps_btree_composite.h"
 
 
 using namespace std;
@@ -41,7 +42,8 @@ FieldIndexNodeManager::FieldIndexNodeManager(unique_ptr<IDataContainer>&   conta
     mRootNode(NIL_NODE),
     mFirstFreeNode(NIL_NODE),
     mContainer(container.release()),
-    mFieldType(fieldType)
+    mFieldType(fieldType),
+    mKeySize(0)
 {
 
   if (create)
@@ -50,6 +52,28 @@ FieldIndexNodeManager::FieldIndexNodeManager(unique_ptr<IDataContainer>&   conta
   InitFromContainer();
 }
 
+
+FieldIndexNodeManager::FieldIndexNodeManager(unique_ptr<IDataContainer>&   container,
+                                             const uint_t                  nodeSize,
+                                             const uint_t                  maxCacheMem,
+                                             const uint_t                  compositeKeySize,
+                                             const bool                    create)
+  : mNodeSize(nodeSize),
+    mMaxCachedMem(maxCacheMem),
+    mRootNode(NIL_NODE),
+    mFirstFreeNode(NIL_NODE),
+    mContainer(container.release()),
+    mFieldType(T_UNDETERMINED),
+    mKeySize(compositeKeySize)
+{
+  assert(mKeySize > 0);
+
+  if (create)
+    InitContainer();
+
+  InitFromContainer();
+}
+
 FieldIndexNodeManager::~FieldIndexNodeManager()
 {
   FlushNodes();
@@ -182,6 +206,14 @@ FieldIndexNodeManager::LoadNode(const NODE_INDEX nodeId)
   return node;
 }
 
+void
+FieldIndexNodeManager::PrefetchNodeData(const NODE_INDEX nodeId)
+{
+  assert(nodeId > 0);
+
+  mContainer->Prefetch(nodeId * NodeRawSize(), NodeRawSize());
+}
+
 void
 FieldIndexNodeManager::SaveNode(IBTreeNode* const node)
 {
@@ -297,6 +329,10 @@ FieldIndexNodeManager::NodeFactory(const NODE_INDEX nodeId)
     result = new RichRealBTreeNode(*this, nodeId);
     break;
 
+  case T_UNDETERMINED:
+    result = new CompositeBTreeNode(*this, nodeId, mKeySize);
+    break;
+
   default:
     assert(false);
     }
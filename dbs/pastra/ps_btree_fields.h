@@ -514,6 +514,11 @@ public:
                         const uint_t                       maxCacheMem,
                         const DBS_FIELD_TYPE               nodeType,
                         const bool                         create);
+  FieldIndexNodeManager(std::unique_ptr<IDataContainer>&   container,
+                        const uint_t                       nodeSize,
+                        const uint_t                       maxCacheMem,
+                        const uint_t                       compositeKeySize,
+                        const bool                         create);
 
   virtual ~FieldIndexNodeManager() override;
 
@@ -522,6 +527,7 @@ public:
 
   void MarkForRemoval();
   uint64_t IndexRawSize() const;
+  uint_t NodeKeySize() const { return mKeySize; }
   virtual uint64_t NodeRawSize() const override;
   virtual NODE_INDEX AllocateNode(const NODE_INDEX parent, const KEY_INDEX  parentKey) override;
   virtual void FreeNode(const NODE_INDEX nodeId) override;
@@ -532,6 +538,7 @@ protected:
   virtual uint_t MaxCachedNodes() override;
   virtual std::shared_ptr<IBTreeNode> LoadNode(const NODE_INDEX nodeId) override;
   virtual void SaveNode(IBTreeNode* const nodeId) override;
+  virtual void PrefetchNodeData(const NODE_INDEX nodeId) override;
 
   void InitContainer();
   void UpdateContainer();
@@ -545,6 +552,7 @@ protected:
   NODE_INDEX                        mFirstFreeNode;
   std::unique_ptr<IDataContainer>   mContainer;
   const DBS_FIELD_TYPE              mFieldType;
+  const uint_t                      mKeySize;
 };
 
 
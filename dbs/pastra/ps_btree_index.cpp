@@ -297,6 +297,18 @@ IBTreeNodeManager::RetrieveNode(const NODE_INDEX nodeId)
   return result;
 }
 
+void
+IBTreeNodeManager::PrefetchNode(const NODE_INDEX nodeId)
+{
+  if (nodeId == NIL_NODE)
+    return;
+
+  LockGuard<Lock> syncHolder(mSync);
+
+  if (mNodesKeeper.find(nodeId) == mNodesKeeper.end())
+    PrefetchNodeData(nodeId);
+}
+
 void
 IBTreeNodeManager::ReleaseNode(const NODE_INDEX nodeId)
 {
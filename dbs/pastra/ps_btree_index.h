@@ -148,6 +148,7 @@ public:
   void Join(const NODE_INDEX parentId, const NODE_INDEX nodeId);
 
   std::shared_ptr<IBTreeNode> RetrieveNode(const NODE_INDEX nodeId);
+  void PrefetchNode(const NODE_INDEX nodeId);
   void ReleaseNode(const NODE_INDEX nodeId);
   void ReleaseNode(IBTreeNode* const node) { ReleaseNode(node->NodeId()); }
   void FlushNodes();
@@ -178,6 +179,7 @@ protected:
   virtual uint_t MaxCachedNodes() = 0;
   virtual std::shared_ptr<IBTreeNode> LoadNode(const NODE_INDEX nodeId) = 0;
   virtual void SaveNode(IBTreeNode* const node) = 0;
+  virtual void PrefetchNodeData(const NODE_INDEX) {}
 
 
   Lock                               mSync;
@@ -300,6 +300,28 @@ FileContainer::Read(uint64_t from, uint64_t size, uint8_t* buffer)
 }
 
 
+void
+FileContainer::Prefetch(uint64_t from, uint64_t size)
+{
+  const uint64_t containerSize = Size();
+
+  if (from >= containerSize)
+    return;
+
+  size = MIN(size, containerSize - from);
+  while (size > 0)
+  {
+    const uint64_t unitIndex = from / mMaxFileUnitSize;
+    const uint64_t unitPosition = from % mMaxFileUnitSize;
+    const uint64_t chunkSize = MIN(size, mMaxFileUnitSize - unitPosition);
+
+    mFilesHandles[unitIndex].Prefetch(unitPosition, chunkSize);
+
+    from += chunkSize, size -= chunkSize;
+  }
+}
+
+
 void
 FileContainer::Colapse(uint64_t from, uint64_t to)
 {
@@ -93,6 +93,10 @@ public:
   virtual uint64_t Size() const = 0;
   virtual void MarkForRemoval() = 0;
   virtual void Flush() = 0;
+
+  //Hints that a range is about to be read. Containers that keep their
+  //data in memory have nothing to do about it.
+  virtual void Prefetch(uint64_t, uint64_t) {}
 };
 
 
@@ -110,6 +114,7 @@ public:
   virtual void Write(uint64_t to, uint64_t size, const uint8_t* buffer) override;
   virtual void Read(uint64_t from, uint64_t size, uint8_t* buffer) override;
   virtual void Colapse(uint64_t from, uint64_t to) override;
+  virtual void Prefetch(uint64_t from, uint64_t size) override;
 
   virtual uint64_t Size() const override;
 
@@ -46,6 +46,7 @@ namespace pastra {
 static const char PS_TEMP_TABLE_SUFFIX[]   = "pttable_";
 static const char PS_TABLE_FIXFIELDS_EXT[] = "_f";
 static const char PS_TABLE_VARFIELDS_EXT[] = "_v";
+static const char PS_TABLE_COMPOSITE_EXT[] = "_ci-";
 static const uint8_t PS_TABLE_SIGNATURE[]  = { 0x50, 0x41, 0x53, 0x54, 0x52, 0x41, 0x54, 0x42 };
 
 static const uint_t PS_HEADER_SIZE = 128;
@@ -76,12 +77,34 @@ static const uint_t PS_TABLE_FLAGS_LEN             = 4;
 static const uint_t PS_RESEVED_FOR_FUTURE_OFF   = 64;
 static const uint_t PS_RESEVED_FOR_FUTURE_LEN   = PS_HEADER_SIZE - PS_RESEVED_FOR_FUTURE_OFF;
 
+//The composite indexes descriptors are kept in the former reserved area.
+static const uint_t PS_TABLE_COMPOSITE_INDEXES_OFF = PS_RESEVED_FOR_FUTURE_OFF;
+static const uint_t PS_TABLE_COMPOSITE_INDEXES_LEN = sizeof(CompositeIndexDescriptor)
+                                                     * COMPOSITE_INDEXES_MAX_COUNT;
+
+//Every bitmap index keeps the index of its field increased by one, so a
+//zero entry stands for an unused slot.
+static const uint_t PS_TABLE_BITMAP_INDEXES_OFF    = PS_TABLE_COMPOSITE_INDEXES_OFF
+                                                     + PS_TABLE_COMPOSITE_INDEXES_LEN;
+static const uint_t PS_TABLE_BITMAP_INDEXES_LEN    = sizeof(uint16_t) * BITMAP_INDEXES_MAX_COUNT;
+
+static_assert(PS_TABLE_COMPOSITE_INDEXES_LEN + PS_TABLE_BITMAP_INDEXES_LEN
+                <= PS_RESEVED_FOR_FUTURE_LEN,
+              "The indexes descriptors do not fit in the table header.");
+
 static const uint32_t PS_TABLE_MODIFIED_MASK    = 1;
 static const uint32_t PS_TABLE_TO_REPAIR_MASK   = 2;
 
 
 
 
+static string
+composite_index_container_name(const string& fileNamePrefix, const uint_t index)
+{
+  return fileNamePrefix + PS_TABLE_COMPOSITE_EXT + to_string(index) + "_bt";
+}
+
+
 static const char*
 field_type_to_text(const uint_t type)
 {
@@ -802,7 +825,24 @@ PersistentTable::~PersistentTable()
       delete mvIndexNodeMgrs[fieldIndex];
     }
   }
+
+  for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+  {
+    if (mvCompositeNodeMgrs[i] == nullptr)
+      continue;
+
+    uint64_t unitsCount = mMaxFileSize - 1;
+
+    unitsCount += mvCompositeNodeMgrs[i]->IndexRawSize();
+    unitsCount /= mMaxFileSize;
+
+    mCompositeIndexes[i].IndexUnitsCount(unitsCount);
+    delete mvCompositeNodeMgrs[i];
+  }
   MakeHeaderPersistent();
+
+  for (auto bitmapIndex : mvBitmapIndexes)
+    delete bitmapIndex;
 }
 
 
@@ -851,6 +891,19 @@ PersistentTable::InitFromFile(const string& tableName)
   mMaxFileSize     = load_le_int64(tableHdr + PS_TABLE_MAX_FILE_SIZE_OFF);
   mainTableSize    = load_le_int64(tableHdr + PS_TABLE_MAINTABLE_SIZE_OFF);
 
+  memcpy(mCompositeIndexes,
+         tableHdr + PS_TABLE_COMPOSITE_INDEXES_OFF,
+         PS_TABLE_COMPOSITE_INDEXES_LEN);
+
+  for (uint_t i = 0; i < BITMAP_INDEXES_MAX_COUNT; ++i)
+  {
+    const uint_t entry = load_le_int16(tableHdr
+                                       + PS_TABLE_BITMAP_INDEXES_OFF
+                                       + i * sizeof(uint16_t));
+    if (entry > 0)
+      mvBitmapIndexes[i] = new FieldBitmapIndex(entry - 1);
+  }
+
   if (mFieldsCount == 0
      || mDescriptorsSize < sizeof(FieldDescriptor) * mFieldsCount
      || mainTableSize < PS_HEADER_SIZE)
@@ -939,6 +992,31 @@ PersistentTable::InitIndexedFields()
                                                         _SC(DBS_FIELD_TYPE, field.Type()),
                                                         false));
   }
+
+  for (uint_t i = 0; i < COMPOSITE_INDEXES_MAX_COUNT; ++i)
+  {
+    const CompositeIndexDescriptor& desc = mCompositeIndexes[i];
+
+    if (desc.FieldsCount() == 0)
+      continue;
+
+    FIELD_INDEX fields[COMPOSITE_INDEX_MAX_FIELDS];
+    for (uint_t f = 0; f < desc.FieldsCount(); ++f)
+      fields[f] = desc.Field(f);
+
+    const string containerName = composite_index_container_name(mFileNamePrefix, i);
+    unique_ptr<IDataContainer> indexContainer(unique_make(FileContainer,
+                                                          containerName.c_str(),
+                                                          mMaxFileSize,
+                                                          desc.IndexUnitsCount(),
+                                                          false));
+    mvCompositeNodeMgrs[i] = new FieldIndexNodeManager(indexContainer,
+                                                       desc.IndexNodeSizeKB() * 1024,
+                                                       0x400000, //4MB
+                                                       CompositeKeySize(fields,
+                                                                        desc.FieldsCount()),
+                                                       false);
+  }
 }
 
 void
@@ -970,6 +1048,15 @@ PersistentTable::MakeHeaderPersistent()
                  tableHdr + PS_TABLE_VARSTORAGE_SIZE_OFF);
 
   memset(tableHdr + PS_RESEVED_FOR_FUTURE_OFF, 0, PS_RESEVED_FOR_FUTURE_LEN);
+  memcpy(tableHdr + PS_TABLE_COMPOSITE_INDEXES_OFF,
+         mCompositeIndexes,
+         PS_TABLE_COMPOSITE_INDEXES_LEN);
+
+  for (uint_t i = 0; i < BITMAP_INDEXES_MAX_COUNT; ++i)
+  {
+    store_le_int16((mvBitmapIndexes[i] != nullptr) ? mvBitmapIndexes[i]->Field() + 1 : 0,
+                   tableHdr + PS_TABLE_BITMAP_INDEXES_OFF + i * sizeof(uint16_t));
+  }
 
   mTableData->Write(0, sizeof tableHdr, tableHdr);
   mTableData->Write(sizeof tableHdr, mDescriptorsSize, mFieldsDescriptors.get());
@@ -991,6 +1078,12 @@ PersistentTable::RemoveFromDatabase()
       mvIndexNodeMgrs[i]->MarkForRemoval();
   }
 
+  for (auto nodeMgr : mvCompositeNodeMgrs)
+  {
+    if (nodeMgr != nullptr)
+      nodeMgr->MarkForRemoval();
+  }
+
   mTableData->MarkForRemoval();
   mRemoved = true;
 }
@@ -1008,6 +1101,17 @@ PersistentTable::CreateIndexContainer(const FIELD_INDEX field)
 }
 
 
+IDataContainer*
+PersistentTable::CreateCompositeIndexContainer(const uint_t index)
+{
+  assert(!mFileNamePrefix.empty());
+
+  const string containerName = composite_index_container_name(mFileNamePrefix, index);
+
+  return new FileContainer(containerName.c_str(), mDbsSettings.mMaxFileSize, 0, false);
+}
+
+
 void
 PersistentTable::FlushEpilog()
 {
@@ -1267,6 +1371,59 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
                                                       true));
   }
 
+  CompositeIndexDescriptor compositeIndexes[COMPOSITE_INDEXES_MAX_COUNT];
+  std::vector<FieldIndexNodeManager*> compositeNodeMgrs;
+
+  memcpy(compositeIndexes,
+         tableHeader.get() + PS_TABLE_COMPOSITE_INDEXES_OFF,
+         PS_TABLE_COMPOSITE_INDEXES_LEN);
+
+  for (uint_t i = 0; i < COMPOSITE_INDEXES_MAX_COUNT; ++i)
+  {
+    CompositeIndexDescriptor& desc = compositeIndexes[i];
+
+    bool validIndex = (desc.FieldsCount() > 0)
+                      && (desc.FieldsCount() <= COMPOSITE_INDEX_MAX_FIELDS)
+                      && (desc.IndexNodeSizeKB() > 0);
+    uint_t keySize = 0;
+    for (uint_t f = 0; validIndex && (f < desc.FieldsCount()); ++f)
+    {
+      const uint_t type = (desc.Field(f) < fieldsCount) ? fds[desc.Field(f)].Type() : T_UNKNOWN;
+
+      if (IS_ARRAY(type) || (type <= T_UNKNOWN) || (type >= T_TEXT))
+        validIndex = false;
+
+      else
+        keySize += composite_key_part_size(_SC(DBS_FIELD_TYPE, type));
+    }
+
+    if ( ! validIndex)
+    {
+      if (desc.FieldsCount() > 0)
+        fixCallback(FIX_INFO, "Removed the invalid description of composite index %u.", i);
+
+      desc.Reset();
+      compositeNodeMgrs.push_back(nullptr);
+      continue;
+    }
+
+    desc.IndexUnitsCount(0);
+
+    const string containerName = composite_index_container_name(fileNamePrefix, i);
+
+    FileContainer::Fix(containerName.c_str(), settings.mMaxFileSize, 0);
+    unique_ptr<IDataContainer> indexContainer(unique_make(FileContainer,
+                                                          containerName.c_str(),
+                                                          settings.mMaxFileSize,
+                                                          0,
+                                                          false));
+    compositeNodeMgrs.push_back(new FieldIndexNodeManager(indexContainer,
+                                                          desc.IndexNodeSizeKB() * 1024,
+                                                          0x400000, //4MB
+                                                          keySize,
+                                                          true));
+  }
+
   FileContainer tableData(fileNamePrefix.c_str(), settings.mMaxFileSize, 1, false);
   FileContainer rowsData((fileNamePrefix + PS_TABLE_FIXFIELDS_EXT).c_str(),
                          settings.mMaxFileSize,
@@ -1636,6 +1793,34 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
     }
     rowsData.Write(row * rowSize, rowSize, rowData);
 
+    for (uint_t i = 0; i < COMPOSITE_INDEXES_MAX_COUNT; ++i)
+    {
+      if (compositeNodeMgrs[i] == nullptr)
+        continue;
+
+      uint8_t key[COMPOSITE_KEY_MAX_SIZE];
+      uint8_t* keyPart = key;
+
+      for (uint_t f = 0; f < compositeIndexes[i].FieldsCount(); ++f)
+      {
+        const FieldDescriptor& fd = fds[compositeIndexes[i].Field(f)];
+        const DBS_FIELD_TYPE type = _SC(DBS_FIELD_TYPE, fd.Type());
+        const bool isNullValue = (rowData[fd.NullBitIndex() / 8]
+                                  & (1 << (fd.NullBitIndex() % 8))) != 0;
+
+        composite_key_store_part(type,
+                                 isNullValue ? nullptr : rowData + fd.RowDataOff(),
+                                 keyPart);
+        keyPart += composite_key_part_size(type);
+      }
+
+      BTree(*compositeNodeMgrs[i]).InsertKey(CompositeBTreeKey(key,
+                                                               compositeNodeMgrs[i]->NodeKeySize(),
+                                                               row),
+                                             &dummyNode,
+                                             &dummyKey);
+    }
+
     if (allFieldsAreNull)
     {
       BTree removedNodes(tableNodeMgr);
@@ -1689,6 +1874,40 @@ PersistentTable::RepairTable(DbsHandler&           dbs,
     delete indexNodeMgrs[field];
   }
 
+  for (uint_t i = 0; i < COMPOSITE_INDEXES_MAX_COUNT; ++i)
+  {
+    if (compositeNodeMgrs[i] == nullptr)
+      continue;
+
+    uint64_t unitsCount = compositeNodeMgrs[i]->IndexRawSize();
+    unitsCount += settings.mMaxFileSize - 1;
+    unitsCount /= settings.mMaxFileSize;
+
+    compositeIndexes[i].IndexUnitsCount(unitsCount);
+    delete compositeNodeMgrs[i];
+  }
+
+  memcpy(tableHeader.get() + PS_TABLE_COMPOSITE_INDEXES_OFF,
+         compositeIndexes,
+         PS_TABLE_COMPOSITE_INDEXES_LEN);
+
+  for (uint_t i = 0; i < BITMAP_INDEXES_MAX_COUNT; ++i)
+  {
+    uint8_t* const entry = tableHeader.get() + PS_TABLE_BITMAP_INDEXES_OFF + i * sizeof(uint16_t);
+    const uint_t field = load_le_int16(entry);
+
+    if ((field == 0)
+        || ((field <= fieldsCount)
+            && ! IS_ARRAY(fds[field - 1].Type())
+            && bitmap_index_supported(fds[field - 1].Type())))
+    {
+      continue;
+    }
+
+    fixCallback(FIX_INFO, "Removed the invalid description of bitmap index %u.", i);
+    store_le_int16(0, entry);
+  }
+
   tableData.Write(0, PS_HEADER_SIZE, tableHeader.get());
   tableData.Write(PS_HEADER_SIZE, descSize, fieldsDescs.get());
 
@@ -1769,6 +1988,12 @@ TemporalTable::~TemporalTable()
 {
   for (FIELD_INDEX fieldIndex = 0; fieldIndex < mFieldsCount; ++fieldIndex)
     delete mvIndexNodeMgrs[fieldIndex];
+
+  for (auto nodeMgr : mvCompositeNodeMgrs)
+    delete nodeMgr;
+
+  for (auto bitmapIndex : mvBitmapIndexes)
+    delete bitmapIndex;
 }
 
 bool
@@ -1806,6 +2031,12 @@ TemporalTable::CreateIndexContainer(const FIELD_INDEX)
   return new TemporalContainer();
 }
 
+IDataContainer*
+TemporalTable::CreateCompositeIndexContainer(const uint_t)
+{
+  return new TemporalContainer();
+}
+
 IDataContainer&
 TemporalTable::TableContainer()
 {
@@ -65,6 +65,7 @@ public:
 protected:
   virtual void MakeHeaderPersistent() override;
   virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field) override;
+  virtual IDataContainer* CreateCompositeIndexContainer(const uint_t index) override;
   virtual IDataContainer& RowsContainer() override;
   virtual IDataContainer& TableContainer() override;
   virtual VariableSizeStoreSPtr VSStore() override;
@@ -103,6 +104,7 @@ public:
 protected:
   virtual void MakeHeaderPersistent() override;
   virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field) override;
+  virtual IDataContainer* CreateCompositeIndexContainer(const uint_t index) override;
   virtual IDataContainer& RowsContainer() override;
   virtual IDataContainer& TableContainer() override;
   virtual VariableSizeStoreSPtr VSStore() override;
@@ -22,6 +22,9 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+
 #include "utils/endianness.h"
 #include "utils/wutf.h"
 #include "utils/wunicode.h"
@@ -38,6 +41,26 @@ namespace whais {
 namespace pastra {
 
 
+//Marks the rows' content as being changed for as long as it is in scope.
+class RowsChangeGuard
+{
+public:
+  explicit RowsChangeGuard(volatile int32_t& changes)
+    : mChanges(changes)
+  {
+    wh_atomic_fetch_inc32(&mChanges);
+  }
+
+  ~RowsChangeGuard()
+  {
+    wh_atomic_fetch_inc32(&mChanges);
+  }
+
+private:
+  volatile int32_t& mChanges;
+};
+
+
 PrototypeTable::PrototypeTable(DbsHandler& dbs)
   : mDbs(dbs),
     mRowsCount(0),
@@ -46,6 +69,10 @@ PrototypeTable::PrototypeTable(DbsHandler& dbs)
     mRowSize(0),
     mDescriptorsSize(0),
     mFieldsCount(0),
+    mvCompositeNodeMgrs(COMPOSITE_INDEXES_MAX_COUNT, nullptr),
+    mvBitmapIndexes(BITMAP_INDEXES_MAX_COUNT, nullptr),
+    mvZoneMaps(),
+    mRowsChanges(0),
     mRowModified(false),
     mLockInProgress(false)
 {
@@ -62,8 +89,13 @@ PrototypeTable::PrototypeTable(const PrototypeTable& prototype)
     mFieldsCount(prototype.mFieldsCount),
     mFieldsDescriptors(),
     mvIndexNodeMgrs(),
+    mCompositeIndexes(),
+    mvCompositeNodeMgrs(COMPOSITE_INDEXES_MAX_COUNT, nullptr),
+    mvBitmapIndexes(BITMAP_INDEXES_MAX_COUNT, nullptr),
+    mvZoneMaps(),
     mRowsSync(),
     mIndexesSync(),
+    mRowsChanges(0),
     mRowModified(false),
     mLockInProgress(false)
 {
@@ -184,6 +216,7 @@ PrototypeTable::AddRow(const bool skipThreadSafety)
 {
   LockGuard<Lock> syncGuard(mRowsSync, skipThreadSafety);
   MarkRowModification(skipThreadSafety ? nullptr : &syncGuard);
+  RowsChangeGuard changeGuard(mRowsChanges);
 
   uint64_t lastRowPosition = mRowsCount * mRowSize;
   uint_t toWrite = mRowSize;
@@ -309,6 +342,35 @@ PrototypeTable::AddRow(const bool skipThreadSafety)
     }
   }
 
+  uint8_t nullKey[COMPOSITE_KEY_MAX_SIZE];
+  memset(nullKey, 0, sizeof nullKey);
+
+  for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+  {
+    if (mvCompositeNodeMgrs[i] == nullptr)
+      continue;
+
+    //A composite key made only from null parts has all its bytes set to 0.
+    BTree compositeTree( *mvCompositeNodeMgrs[i]);
+    compositeTree.InsertKey(CompositeBTreeKey(nullKey,
+                                              mvCompositeNodeMgrs[i]->NodeKeySize(),
+                                              mRowsCount),
+                            &dummyNode,
+                            &dummyKey);
+  }
+
+  for (auto bitmapIndex : mvBitmapIndexes)
+  {
+    if ((bitmapIndex != nullptr) && bitmapIndex->IsBuilt())
+      bitmapIndex->Insert(true, 0, mRowsCount);
+  }
+
+  for (auto& zoneMap : mvZoneMaps)
+  {
+    if (zoneMap)
+      zoneMap->AddNullRow(mRowsCount);
+  }
+
   // The rows count has to be update before the procedure code is executed.
   // Other way the new content will not be refreshed.
   mRowCache.RefreshItem(mRowsCount++);
@@ -673,6 +735,376 @@ PrototypeTable::IsIndexed(const FIELD_INDEX field) const
 }
 
 
+void
+PrototypeTable::CreateCompositeIndex(const FIELD_INDEX* const            fields,
+                                     const uint_t                        fieldsCount,
+                                     CREATE_INDEX_CALLBACK_FUNC* const   cbFunc,
+                                     CreateIndexCallbackContext* const   cbContext)
+{
+  if (((cbFunc == nullptr) && (cbContext != nullptr))
+      || (fields == nullptr)
+      || (fieldsCount == 0)
+      || (fieldsCount > COMPOSITE_INDEX_MAX_FIELDS))
+  {
+    throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS));
+  }
+
+  for (uint_t i = 0; i < fieldsCount; ++i)
+  {
+    if (fields[i] >= mFieldsCount)
+    {
+      throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
+                         "Table field index is invalid %u(%u),",
+                         fields[i],
+                         mFieldsCount);
+    }
+
+    for (uint_t j = 0; j < i; ++j)
+    {
+      if (fields[i] == fields[j])
+      {
+        throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS),
+                           "Field %u is used twice by the same composite index.",
+                           fields[i]);
+      }
+    }
+  }
+
+  LockGuard<Lock> syncHolder(mRowsSync);
+
+  if (FindCompositeIndex(fields, fieldsCount) >= 0)
+    throw DBSException(_EXTRA(DBSException::FIELD_INDEXED));
+
+  uint_t index = 0;
+  while ((index < COMPOSITE_INDEXES_MAX_COUNT) && (mvCompositeNodeMgrs[index] != nullptr))
+    ++index;
+
+  if (index >= COMPOSITE_INDEXES_MAX_COUNT)
+  {
+    throw DBSException(_EXTRA(DBSException::OPER_NOT_SUPPORTED),
+                       "A table cannot have more than %u composite indexes.",
+                       COMPOSITE_INDEXES_MAX_COUNT);
+  }
+
+  const uint_t keySize = CompositeKeySize(fields, fieldsCount);
+  const uint_t nodeSizeKB = 16; //16KB
+
+  unique_ptr<IDataContainer> indexContainer(CreateCompositeIndexContainer(index));
+  unique_ptr<FieldIndexNodeManager> nodeMgr(new FieldIndexNodeManager(indexContainer,
+                                                                      nodeSizeKB * 1024,
+                                                                      0x400000, //4MB
+                                                                      keySize,
+                                                                      true));
+  uint8_t key[COMPOSITE_KEY_MAX_SIZE];
+  BTree indexTree( *nodeMgr.get());
+  for (ROW_INDEX row = 0; row < mRowsCount; ++row)
+  {
+    NODE_INDEX dummyNode;
+    KEY_INDEX dummyKey;
+
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    BuildCompositeKey(cachedItem.GetDataForRead(), fields, fieldsCount, key);
+
+    indexTree.InsertKey(CompositeBTreeKey(key, keySize, row), &dummyNode, &dummyKey);
+
+    if (cbFunc != nullptr)
+    {
+      if (cbContext != nullptr)
+      {
+        cbContext->mRowsCount = mRowsCount;
+        cbContext->mRowIndex = row;
+      }
+      cbFunc(cbContext);
+    }
+  }
+
+  CompositeIndexDescriptor& desc = mCompositeIndexes[index];
+
+  desc.FieldsCount(fieldsCount);
+  for (uint_t i = 0; i < fieldsCount; ++i)
+    desc.Field(i, fields[i]);
+
+  desc.IndexNodeSizeKB(nodeSizeKB);
+  desc.IndexUnitsCount(1);
+
+  MakeHeaderPersistent();
+
+  mvCompositeNodeMgrs[index] = nodeMgr.release();
+}
+
+
+void
+PrototypeTable::RemoveCompositeIndex(const FIELD_INDEX* const fields, const uint_t fieldsCount)
+{
+  LockGuard<Lock> syncHolder(mRowsSync);
+
+  const int index = FindCompositeIndex(fields, fieldsCount);
+  if (index < 0)
+    throw DBSException(_EXTRA(DBSException::FIELD_NOT_INDEXED));
+
+  unique_ptr<FieldIndexNodeManager> nodeMgr(mvCompositeNodeMgrs[index]);
+  nodeMgr->MarkForRemoval();
+
+  mvCompositeNodeMgrs[index] = nullptr;
+  mCompositeIndexes[index].Reset();
+
+  MakeHeaderPersistent();
+}
+
+
+bool
+PrototypeTable::IsCompositeIndexed(const FIELD_INDEX* const fields,
+                                   const uint_t             fieldsCount) const
+{
+  LockGuard<Lock> syncHolder(_CC(Lock&, mRowsSync));
+
+  return FindCompositeIndex(fields, fieldsCount) >= 0;
+}
+
+
+void
+PrototypeTable::CreateBitmapIndex(const FIELD_INDEX field)
+{
+  if (field >= mFieldsCount)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
+                       "Table field index is invalid %u(%u),",
+                       field,
+                       mFieldsCount);
+  }
+
+  const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+  if (IS_ARRAY(desc.Type()) || ! bitmap_index_supported(desc.Type()))
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
+                       "Bitmap indexes are available only for BOOL, CHAR and UINT8 fields.");
+  }
+
+  LockGuard<Lock> syncHolder(mRowsSync);
+
+  if (FindBitmapIndex(field) != nullptr)
+    throw DBSException(_EXTRA(DBSException::FIELD_INDEXED));
+
+  uint_t index = 0;
+  while ((index < BITMAP_INDEXES_MAX_COUNT) && (mvBitmapIndexes[index] != nullptr))
+    ++index;
+
+  if (index >= BITMAP_INDEXES_MAX_COUNT)
+  {
+    throw DBSException(_EXTRA(DBSException::OPER_NOT_SUPPORTED),
+                       "A table cannot have more than %u bitmap indexes.",
+                       BITMAP_INDEXES_MAX_COUNT);
+  }
+
+  unique_ptr<FieldBitmapIndex> bitmapIndex(new FieldBitmapIndex(field));
+  BuildBitmapIndex(*bitmapIndex);
+
+  mvBitmapIndexes[index] = bitmapIndex.release();
+
+  MakeHeaderPersistent();
+}
+
+
+void
+PrototypeTable::RemoveBitmapIndex(const FIELD_INDEX field)
+{
+  LockGuard<Lock> syncHolder(mRowsSync);
+
+  for (auto& bitmapIndex : mvBitmapIndexes)
+  {
+    if ((bitmapIndex != nullptr) && (bitmapIndex->Field() == field))
+    {
+      delete bitmapIndex;
+      bitmapIndex = nullptr;
+
+      MakeHeaderPersistent();
+      return;
+    }
+  }
+
+  throw DBSException(_EXTRA(DBSException::FIELD_NOT_INDEXED));
+}
+
+
+bool
+PrototypeTable::IsBitmapIndexed(const FIELD_INDEX field) const
+{
+  LockGuard<Lock> syncHolder(_CC(Lock&, mRowsSync));
+
+  if (field >= mFieldsCount)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_NOT_FOUND),
+                       "Table field index is invalid %u(%u),",
+                       field,
+                       mFieldsCount);
+  }
+
+  return FindBitmapIndex(field) != nullptr;
+}
+
+
+FieldBitmapIndex*
+PrototypeTable::FindBitmapIndex(const FIELD_INDEX field) const
+{
+  for (auto bitmapIndex : mvBitmapIndexes)
+  {
+    if ((bitmapIndex != nullptr) && (bitmapIndex->Field() == field))
+      return bitmapIndex;
+  }
+
+  return nullptr;
+}
+
+
+template<class T> void
+PrototypeTable::BuildBitmapIndex(FieldBitmapIndex& index)
+{
+  for (ROW_INDEX row = 0; row < mRowsCount; ++row)
+  {
+    T value;
+
+    RetrieveEntry(row, index.Field(), false, value);
+    index.Insert(value.IsNull(), bitmap_index_key(value), row);
+  }
+
+  index.MarkBuilt();
+}
+
+
+void
+PrototypeTable::BuildBitmapIndex(FieldBitmapIndex& index)
+{
+  switch (GetFieldDescriptorInternal(index.Field()).Type())
+  {
+  case T_BOOL:
+    BuildBitmapIndex<DBool>(index);
+    break;
+
+  case T_CHAR:
+    BuildBitmapIndex<DChar>(index);
+    break;
+
+  case T_UINT8:
+    BuildBitmapIndex<DUInt8>(index);
+    break;
+
+  default:
+    throw DBSException(_EXTRA(DBSException::GENERAL_CONTROL_ERROR));
+  }
+}
+
+
+int
+PrototypeTable::FindCompositeIndex(const FIELD_INDEX* const fields, const uint_t fieldsCount) const
+{
+  if (fields == nullptr)
+    return -1;
+
+  for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+  {
+    if ((mvCompositeNodeMgrs[i] != nullptr) && mCompositeIndexes[i].Matches(fields, fieldsCount))
+      return i;
+  }
+
+  return -1;
+}
+
+
+uint_t
+PrototypeTable::CompositeKeySize(const FIELD_INDEX* const fields, const uint_t fieldsCount) const
+{
+  uint_t result = 0;
+
+  for (uint_t i = 0; i < fieldsCount; ++i)
+  {
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(fields[i]);
+
+    if (desc.Type() & PS_TABLE_ARRAY_MASK)
+    {
+      throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
+                         "This implementation does not support indexing text "
+                         "or array fields.");
+    }
+    result += composite_key_part_size(_SC(DBS_FIELD_TYPE, desc.Type()));
+  }
+
+  assert(result <= COMPOSITE_KEY_MAX_SIZE);
+
+  return result;
+}
+
+
+void
+PrototypeTable::BuildCompositeKey(const uint8_t* const       rowData,
+                                  const FIELD_INDEX* const   fields,
+                                  const uint_t               fieldsCount,
+                                  uint8_t*                   outKey) const
+{
+  for (uint_t i = 0; i < fieldsCount; ++i)
+  {
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(fields[i]);
+    const DBS_FIELD_TYPE type = _SC(DBS_FIELD_TYPE, desc.Type());
+    const uint_t byteOff = desc.NullBitIndex() / 8;
+    const uint8_t bitOff = desc.NullBitIndex() % 8;
+
+    if (rowData[byteOff] & (1 << bitOff))
+      composite_key_store_part(type, nullptr, outKey);
+
+    else
+      composite_key_store_part(type, rowData + desc.RowDataOff(), outKey);
+
+    outKey += composite_key_part_size(type);
+  }
+}
+
+
+bool
+PrototypeTable::IsFieldInCompositeIndex(const FIELD_INDEX field) const
+{
+  for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+  {
+    if ((mvCompositeNodeMgrs[i] != nullptr) && mCompositeIndexes[i].Contains(field))
+      return true;
+  }
+
+  return false;
+}
+
+
+void
+PrototypeTable::UpdateCompositeIndexes(const ROW_INDEX        row,
+                                       const FIELD_INDEX      field,
+                                       const uint8_t* const   oldRowData,
+                                       const uint8_t* const   newRowData)
+{
+  for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+  {
+    const CompositeIndexDescriptor& desc = mCompositeIndexes[i];
+
+    if ((mvCompositeNodeMgrs[i] == nullptr) || ! desc.Contains(field))
+      continue;
+
+    FIELD_INDEX fields[COMPOSITE_INDEX_MAX_FIELDS];
+    for (uint_t f = 0; f < desc.FieldsCount(); ++f)
+      fields[f] = desc.Field(f);
+
+    uint8_t oldKey[COMPOSITE_KEY_MAX_SIZE];
+    uint8_t newKey[COMPOSITE_KEY_MAX_SIZE];
+    const uint_t keySize = mvCompositeNodeMgrs[i]->NodeKeySize();
+
+    BuildCompositeKey(oldRowData, fields, desc.FieldsCount(), oldKey);
+    BuildCompositeKey(newRowData, fields, desc.FieldsCount(), newKey);
+
+    NODE_INDEX dummyNode;
+    KEY_INDEX dummyKey;
+    BTree indexTree( *mvCompositeNodeMgrs[i]);
+
+    indexTree.RemoveKey(CompositeBTreeKey(oldKey, keySize, row));
+    indexTree.InsertKey(CompositeBTreeKey(newKey, keySize, row), &dummyNode, &dummyKey);
+  }
+}
+
+
 uint_t
 PrototypeTable::RowSize() const
 {
@@ -851,62 +1283,381 @@ PrototypeTable::RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* co
 
 
 void
-PrototypeTable::CheckRowToDelete(const ROW_INDEX row)
+PrototypeTable::PrefetchItems(uint64_t firstItem, uint_t itemsCount)
 {
-  assert(mRowModified);
+  if (firstItem >= mRowsCount)
+    return;
 
-  bool allFieldsNull = true;
+  if (itemsCount + firstItem > mRowsCount)
+    itemsCount = mRowsCount - firstItem;
 
-  StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t* const rowData = cachedItem.GetDataForUpdate();
+  RowsContainer().Prefetch(firstItem * mRowSize, itemsCount * mRowSize);
+}
 
-  for (FIELD_INDEX index = 0; index < mFieldsCount; index += 8)
+
+template<class T> void
+PrototypeTable::ClearRowsField(const FIELD_INDEX field, const std::vector<ROW_INDEX>& rows)
+{
+  FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+  FieldBitmapIndex* bitmapIndex = FindBitmapIndex(field);
+  if ((bitmapIndex != nullptr) && ! bitmapIndex->IsBuilt())
+    bitmapIndex = nullptr;
+
+  T_FieldZoneMap<T>* const zoneMap = FindZoneMap<T>(field);
+
+  const T nullValue;
+  std::vector<std::pair<T, ROW_INDEX>> oldKeys;
+  std::vector<ROW_INDEX> clearedRows;
+
+  for (auto row : rows)
   {
-    const FieldDescriptor& fieldDesc = GetFieldDescriptorInternal(index);
-    const uint8_t bitsSet = ~0;
+    T value;
+    RetrieveEntry(row, field, false, value);
 
-    if (rowData[fieldDesc.NullBitIndex() / 8] != bitsSet)
+    if (value.IsNull())
+      continue;
+
+    if (bitmapIndex != nullptr)
     {
-      allFieldsNull = false;
-      break;
+      bitmapIndex->Remove(false, bitmap_index_key(value), row);
+      bitmapIndex->Insert(true, bitmap_index_key(nullValue), row);
+    }
+
+    if (zoneMap != nullptr)
+      zoneMap->Update(row, value, nullValue);
+
+    if (mvIndexNodeMgrs[field] != nullptr)
+    {
+      oldKeys.push_back(std::make_pair(value, row));
+      clearedRows.push_back(row);
     }
   }
 
-  if (allFieldsNull)
+  if (oldKeys.empty())
+    return;
+
+  //Work the keys in the tree's order, so consecutive changes hit the same leaves.
+  std::sort(oldKeys.begin(), oldKeys.end());
+
+  AcquireFieldIndex( &desc);
+  try
   {
     NODE_INDEX dummyNode;
     KEY_INDEX dummyKey;
-    BTree removedNodes( *this);
-    TableRmKey key(row);
+    BTree fieldIndexTree( *mvIndexNodeMgrs[field]);
 
-    removedNodes.InsertKey(key, &dummyNode, &dummyKey);
+    for (const auto& key : oldKeys)
+      fieldIndexTree.RemoveKey(T_BTreeKey<T>(key.first, key.second));
+
+    for (auto row : clearedRows)
+      fieldIndexTree.InsertKey(T_BTreeKey<T>(nullValue, row), &dummyNode, &dummyKey);
+  }
+  catch (...)
+  {
+    ReleaseIndexField( &desc);
+    throw;
   }
+  ReleaseIndexField( &desc);
 }
 
 
-void
-PrototypeTable::CheckRowToReuse(const ROW_INDEX row)
+ROW_INDEX
+PrototypeTable::MarkRowsForReuse(const DArray& rows)
 {
-  assert(mRowModified);
+  std::vector<ROW_INDEX> rowsList;
+  rowsList.reserve(rows.Count());
 
-  bool allFieldsNull = true;
+  for (uint64_t i = 0; i < rows.Count(); ++i)
+  {
+    DROW_INDEX row;
+    rows.Get(i, row);
 
-  StoredItem cachedItem = mRowCache.RetriveItem(row);
-  uint8_t* const rowData = cachedItem.GetDataForUpdate();
+    if ( ! row.IsNull())
+      rowsList.push_back(row.mValue);
+  }
 
-  for (FIELD_INDEX index = 0; index < mFieldsCount; index += 8)
+  std::sort(rowsList.begin(), rowsList.end());
+  rowsList.erase(std::unique(rowsList.begin(), rowsList.end()), rowsList.end());
+
+  return MarkRowsForReuseInternal(rowsList);
+}
+
+
+ROW_INDEX
+PrototypeTable::MarkRowsForReuse(const ROW_INDEX fromRow, const ROW_INDEX toRow)
+{
+  const ROW_INDEX rowsCount = AllocatedRows();
+  if ((fromRow > toRow) || (fromRow >= rowsCount))
+    return 0;
+
+  std::vector<ROW_INDEX> rowsList;
+  const ROW_INDEX lastRow = MIN(toRow, rowsCount - 1);
+
+  rowsList.reserve(lastRow - fromRow + 1);
+  for (ROW_INDEX row = fromRow; row <= lastRow; ++row)
+    rowsList.push_back(row);
+
+  return MarkRowsForReuseInternal(rowsList);
+}
+
+
+/* Empties a sorted set of rows at once. Unlike clearing the rows one field
+ * at a time, every index is visited once and in order, the variable store
+ * records are released together and the rows enter the reuse tree in
+ * ascending order. */
+ROW_INDEX
+PrototypeTable::MarkRowsForReuseInternal(std::vector<ROW_INDEX>& rows)
+{
+  LockGuard<Lock> syncHolder(mRowsSync);
+  MarkRowModification( &syncHolder);
+
+  //The rows already empty are in the reuse tree and their index keys are null.
+  size_t count = 0;
+  for (auto row : rows)
   {
-    const FieldDescriptor& fieldDesc = GetFieldDescriptorInternal(index);
-    const uint8_t bitsSet = ~0;
+    if (row >= mRowsCount)
+      break;
 
-    if (rowData[fieldDesc.NullBitIndex() / 8] != bitsSet)
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    if ( ! IsRowEmpty(cachedItem.GetDataForRead()))
+      rows[count++] = row;
+  }
+  rows.resize(count);
+
+  if (rows.empty())
+    return 0;
+
+  std::vector<FIELD_INDEX> varFields;
+  for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+  {
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+    if (IS_ARRAY(desc.Type()) || (GET_BASE_TYPE(desc.Type()) == T_TEXT))
+      varFields.push_back(field);
+  }
+
+  std::vector<std::vector<uint8_t>> compositeKeys(mvCompositeNodeMgrs.size());
+  std::vector<uint64_t> records;
+
+  for (auto row : rows)
+  {
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    const uint8_t* const rowData = cachedItem.GetDataForRead();
+
+    for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+    {
+      if (mvCompositeNodeMgrs[i] == nullptr)
+        continue;
+
+      const CompositeIndexDescriptor& desc = mCompositeIndexes[i];
+
+      FIELD_INDEX fields[COMPOSITE_INDEX_MAX_FIELDS];
+      for (uint_t f = 0; f < desc.FieldsCount(); ++f)
+        fields[f] = desc.Field(f);
+
+      std::vector<uint8_t>& keys = compositeKeys[i];
+      const size_t keyOffset = keys.size();
+
+      keys.resize(keyOffset + mvCompositeNodeMgrs[i]->NodeKeySize());
+      BuildCompositeKey(rowData, fields, desc.FieldsCount(), keys.data() + keyOffset);
+    }
+
+    for (auto field : varFields)
+    {
+      const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+      const uint_t byteOff = desc.NullBitIndex() / 8;
+      const uint8_t bitOff = desc.NullBitIndex() % 8;
+
+      if ((rowData[byteOff] & (1 << bitOff)) != 0)
+        continue;
+
+      const uint8_t* const fieldData = rowData + desc.RowDataOff();
+      if ((load_le_int64(fieldData + sizeof(uint64_t)) & 0x8000000000000000ull) == 0)
+        records.push_back(load_le_int64(fieldData));
+    }
+  }
+
+  for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+  {
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+    if (IS_ARRAY(desc.Type()) || (GET_BASE_TYPE(desc.Type()) == T_TEXT))
+      continue;
+
+    else if ((mvIndexNodeMgrs[field] == nullptr)
+             && (FindBitmapIndex(field) == nullptr)
+             && ((field >= mvZoneMaps.size()) || ! mvZoneMaps[field]))
+    {
+      continue; //Nothing keeps track of this field's values.
+    }
+
+    switch (GET_BASE_TYPE(desc.Type()))
     {
-      allFieldsNull = false;
+    case T_BOOL:
+      ClearRowsField<DBool>(field, rows);
+      break;
+
+    case T_CHAR:
+      ClearRowsField<DChar>(field, rows);
+      break;
+
+    case T_DATE:
+      ClearRowsField<DDate>(field, rows);
+      break;
+
+    case T_DATETIME:
+      ClearRowsField<DDateTime>(field, rows);
+      break;
+
+    case T_HIRESTIME:
+      ClearRowsField<DHiresTime>(field, rows);
+      break;
+
+    case T_INT8:
+      ClearRowsField<DInt8>(field, rows);
+      break;
+
+    case T_INT16:
+      ClearRowsField<DInt16>(field, rows);
+      break;
+
+    case T_INT32:
+      ClearRowsField<DInt32>(field, rows);
+      break;
+
+    case T_INT64:
+      ClearRowsField<DInt64>(field, rows);
+      break;
+
+    case T_UINT8:
+      ClearRowsField<DUInt8>(field, rows);
+      break;
+
+    case T_UINT16:
+      ClearRowsField<DUInt16>(field, rows);
+      break;
+
+    case T_UINT32:
+      ClearRowsField<DUInt32>(field, rows);
+      break;
+
+    case T_UINT64:
+      ClearRowsField<DUInt64>(field, rows);
       break;
+
+    case T_REAL:
+      ClearRowsField<DReal>(field, rows);
+      break;
+
+    case T_RICHREAL:
+      ClearRowsField<DRichReal>(field, rows);
+      break;
+
+    default:
+      assert(false);
+    }
+  }
+
+  uint8_t nullKey[COMPOSITE_KEY_MAX_SIZE];
+  memset(nullKey, 0, sizeof nullKey);
+
+  for (uint_t i = 0; i < mvCompositeNodeMgrs.size(); ++i)
+  {
+    if (mvCompositeNodeMgrs[i] == nullptr)
+      continue;
+
+    NODE_INDEX dummyNode;
+    KEY_INDEX dummyKey;
+    BTree indexTree( *mvCompositeNodeMgrs[i]);
+    const uint_t keySize = mvCompositeNodeMgrs[i]->NodeKeySize();
+
+    for (size_t r = 0; r < rows.size(); ++r)
+    {
+      const uint8_t* const oldKey = compositeKeys[i].data() + r * keySize;
+      indexTree.RemoveKey(CompositeBTreeKey(oldKey, keySize, rows[r]));
+    }
+
+    for (auto row : rows)
+      indexTree.InsertKey(CompositeBTreeKey(nullKey, keySize, row), &dummyNode, &dummyKey);
+  }
+
+  RowsChangeGuard changeGuard(mRowsChanges);
+  for (auto row : rows)
+  {
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    uint8_t* const rowData = cachedItem.GetDataForUpdate();
+
+    for (FIELD_INDEX field = 0; field < mFieldsCount; ++field)
+    {
+      const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+
+      rowData[desc.NullBitIndex() / 8] |= (1 << (desc.NullBitIndex() % 8));
     }
+    assert(IsRowEmpty(rowData));
+  }
+
+  if ( ! records.empty())
+  {
+    std::sort(records.begin(), records.end());
+    VSStore()->DecrementRecordsRefs(records);
+  }
+
+  NODE_INDEX dummyNode;
+  KEY_INDEX dummyKey;
+  BTree removedRows( *this);
+
+  for (auto row : rows)
+    removedRows.InsertKey(TableRmKey(row), &dummyNode, &dummyKey);
+
+  return rows.size();
+}
+
+
+bool
+PrototypeTable::IsRowEmpty(const uint8_t* const rowData) const
+{
+  const uint8_t bitsSet = ~0;
+
+  for (FIELD_INDEX index = 0; index < mFieldsCount; index += 8)
+  {
+    const FieldDescriptor& fieldDesc = GetFieldDescriptorInternal(index);
+
+    if (rowData[fieldDesc.NullBitIndex() / 8] != bitsSet)
+      return false;
+  }
+
+  return true;
+}
+
+
+void
+PrototypeTable::CheckRowToDelete(const ROW_INDEX row)
+{
+  assert(mRowModified);
+
+  StoredItem cachedItem = mRowCache.RetriveItem(row);
+
+  if (IsRowEmpty(cachedItem.GetDataForRead()))
+  {
+    NODE_INDEX dummyNode;
+    KEY_INDEX dummyKey;
+    BTree removedNodes( *this);
+    TableRmKey key(row);
+
+    removedNodes.InsertKey(key, &dummyNode, &dummyKey);
   }
+}
+
+
+void
+PrototypeTable::CheckRowToReuse(const ROW_INDEX row)
+{
+  assert(mRowModified);
 
-  if (allFieldsNull)
+  StoredItem cachedItem = mRowCache.RetriveItem(row);
+
+  if (IsRowEmpty(cachedItem.GetDataForRead()))
   {
     BTree removedNodes( *this);
     TableRmKey key(row);
@@ -945,6 +1696,54 @@ PrototypeTable::ReleaseIndexField(FieldDescriptor* const field)
 }
 
 
+template<class T> T_FieldZoneMap<T>*
+PrototypeTable::FindZoneMap(const FIELD_INDEX field) const
+{
+  if ((field >= mvZoneMaps.size()) || ! mvZoneMaps[field])
+    return nullptr;
+
+  return _SC(T_FieldZoneMap<T>*, mvZoneMaps[field].get());
+}
+
+
+template<class T> T_FieldZoneMap<T>&
+PrototypeTable::RetrieveZoneMap(const FIELD_INDEX field)
+{
+  if (mvZoneMaps.size() < mFieldsCount)
+    mvZoneMaps.resize(mFieldsCount);
+
+  if ( ! mvZoneMaps[field])
+    mvZoneMaps[field].reset(new T_FieldZoneMap<T>());
+
+  return *_SC(T_FieldZoneMap<T>*, mvZoneMaps[field].get());
+}
+
+
+template<class T> ZoneSummary<T>&
+PrototypeTable::RetrieveZoneSummary(const ROW_INDEX row, const FIELD_INDEX field)
+{
+  assert(row < mRowsCount);
+
+  ZoneSummary<T>& zone = RetrieveZoneMap<T>(field).Zone(row);
+  if (zone.mBuilt)
+    return zone;
+
+  const ROW_INDEX firstRow = row - row % ZONE_MAP_ROWS;
+  const ROW_INDEX lastRow  = MIN(firstRow + ZONE_MAP_ROWS, mRowsCount) - 1;
+
+  for (ROW_INDEX r = firstRow; r <= lastRow; ++r)
+  {
+    T value;
+    RetrieveEntry(r, field, false, value);
+
+    zone.Add(value);
+  }
+
+  zone.mBuilt = true;
+  return zone;
+}
+
+
 template <class T> void
 PrototypeTable::StoreEntry(const ROW_INDEX row,
                            const FIELD_INDEX field,
@@ -963,6 +1762,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX row,
     return; //Nothing to change
 
   MarkRowModification(threadSafe ? &syncHolder : nullptr);
+  RowsChangeGuard changeGuard(mRowsChanges);
 
   const uint8_t bitsSet = ~0;
   FieldDescriptor& desc = GetFieldDescriptorInternal(field);
@@ -972,6 +1772,10 @@ PrototypeTable::StoreEntry(const ROW_INDEX row,
   StoredItem cachedItem = mRowCache.RetriveItem(row);
   uint8_t * const rowData = cachedItem.GetDataForUpdate();
 
+  std::vector<uint8_t> oldRowData;
+  if (IsFieldInCompositeIndex(field))
+    oldRowData.assign(rowData, rowData + mRowSize);
+
   if (value.IsNull())
   {
     assert((rowData[byteOff] & (1 << bitOff)) == 0);
@@ -991,6 +1795,20 @@ PrototypeTable::StoreEntry(const ROW_INDEX row,
     Serializer::Store(rowData + desc.RowDataOff(), value);
   }
 
+  if ( ! oldRowData.empty())
+    UpdateCompositeIndexes(row, field, oldRowData.data(), rowData);
+
+  FieldBitmapIndex* const bitmapIndex = FindBitmapIndex(field);
+  if ((bitmapIndex != nullptr) && bitmapIndex->IsBuilt())
+  {
+    bitmapIndex->Remove(currentValue.IsNull(), bitmap_index_key(currentValue), row);
+    bitmapIndex->Insert(value.IsNull(), bitmap_index_key(value), row);
+  }
+
+  T_FieldZoneMap<T>* const zoneMap = FindZoneMap<T>(field);
+  if (zoneMap != nullptr)
+    zoneMap->Update(row, currentValue, value);
+
   //Update the field index if it exists
   if (mvIndexNodeMgrs[field] != nullptr)
   {
@@ -1105,6 +1923,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
   if (row == mRowsCount)
     AddRow(true);
 
+  RowsChangeGuard changeGuard(mRowsChanges);
   StoredItem cachedItem = mRowCache.RetriveItem(row);
   uint8_t* const rowData = cachedItem.GetDataForUpdate();
   const uint8_t bitsSet = ~0;
@@ -1232,6 +2051,7 @@ PrototypeTable::StoreEntry(const ROW_INDEX        row,
   if (row == mRowsCount)
     AddRow(true);
 
+  RowsChangeGuard changeGuard(mRowsChanges);
   StoredItem cachedItem = mRowCache.RetriveItem(row);
   uint8_t * const rowData = cachedItem.GetDataForUpdate();
 
@@ -2034,21 +2854,85 @@ private:
 };
 
 
-void
-PrototypeTable::Sort(const FIELD_INDEX field,
-                        const ROW_INDEX fromRow,
-                        const ROW_INDEX toRow,
-                        const bool reverse)
+template<class T> bool
+PrototypeTable::IsRangeSorted(const FIELD_INDEX field,
+                              const ROW_INDEX   fromRow,
+                              const ROW_INDEX   toRow,
+                              const bool        reverse)
 {
-  const DBSFieldDescriptor fd = DescribeField(field);
+  assert(fromRow < toRow);
+  assert(toRow < mRowsCount);
 
-  if (fd.isArray)
+  //The zones already summarised might prove quickly that the rows are not
+  //in order. Only the zones fully contained by the range are considered.
+  const T_FieldZoneMap<T>* const zoneMap = FindZoneMap<T>(field);
+  if (zoneMap != nullptr)
   {
-    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
-                       "This implementation does not sort array fields.");
-  }
+    const ZoneSummary<T>* previous = nullptr;
+    for (ROW_INDEX zoneRow = (fromRow + ZONE_MAP_ROWS - 1) / ZONE_MAP_ROWS * ZONE_MAP_ROWS;
+         zoneRow + ZONE_MAP_ROWS - 1 <= toRow;
+         zoneRow += ZONE_MAP_ROWS)
+    {
+      const ZoneSummary<T>* const current = zoneMap->BuiltZone(zoneRow);
+      if ((previous != nullptr) && (current != nullptr))
+      {
+        const bool previousHasValues = previous->mNullsCount < ZONE_MAP_ROWS;
+        const bool currentHasValues  = current->mNullsCount < ZONE_MAP_ROWS;
 
-  LockGuard<Lock> _l(mRowsSync);
+        if (reverse)
+        {
+          if ((previous->mNullsCount > 0) && currentHasValues)
+            return false;
+
+          if (previousHasValues && currentHasValues && (previous->mMax < current->mMin))
+            return false;
+        }
+        else
+        {
+          if (previousHasValues && (current->mNullsCount > 0))
+            return false;
+
+          if (previousHasValues && currentHasValues && (current->mMax < previous->mMin))
+            return false;
+        }
+      }
+      previous = current;
+    }
+  }
+
+  T previousValue;
+  RetrieveEntry(fromRow, field, false, previousValue);
+
+  for (ROW_INDEX row = fromRow + 1; row <= toRow; ++row)
+  {
+    T value;
+    RetrieveEntry(row, field, false, value);
+
+    if (reverse ? (previousValue < value) : (value < previousValue))
+      return false;
+
+    previousValue = value;
+  }
+
+  return true;
+}
+
+
+void
+PrototypeTable::Sort(const FIELD_INDEX field,
+                        const ROW_INDEX fromRow,
+                        const ROW_INDEX toRow,
+                        const bool reverse)
+{
+  const DBSFieldDescriptor fd = DescribeField(field);
+
+  if (fd.isArray)
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID),
+                       "This implementation does not sort array fields.");
+  }
+
+  LockGuard<Lock> _l(mRowsSync);
 
   const ROW_INDEX from = MIN(fromRow, toRow);
   const ROW_INDEX to = MIN(MAX(fromRow, toRow), AllocatedRows() - 1);
@@ -2064,6 +2948,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
   {
   case T_BOOL:
   {
+    if (IsRangeSorted<DBool>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DBool> temp( *this, field);
     quick_sort<DBool, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2071,6 +2958,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_CHAR:
   {
+    if (IsRangeSorted<DChar>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DChar> temp( *this, field);
     quick_sort<DChar, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2078,6 +2968,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_DATE:
   {
+    if (IsRangeSorted<DDate>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DDate> temp( *this, field);
     quick_sort<DDate, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2085,6 +2978,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_DATETIME:
   {
+    if (IsRangeSorted<DDateTime>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DDateTime> temp( *this, field);
     quick_sort<DDateTime, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2092,6 +2988,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_HIRESTIME:
   {
+    if (IsRangeSorted<DHiresTime>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DHiresTime> temp( *this, field);
     quick_sort<DHiresTime, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2099,6 +2998,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_UINT8:
   {
+    if (IsRangeSorted<DUInt8>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DUInt8> temp( *this, field);
     quick_sort<DUInt8, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2106,6 +3008,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_UINT16:
   {
+    if (IsRangeSorted<DUInt16>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DUInt16> temp( *this, field);
     quick_sort<DUInt16, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2113,6 +3018,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_UINT32:
   {
+    if (IsRangeSorted<DUInt32>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DUInt32> temp( *this, field);
     quick_sort<DUInt32, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2120,6 +3028,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_UINT64:
   {
+    if (IsRangeSorted<DUInt64>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DUInt64> temp( *this, field);
     quick_sort<DUInt64, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2127,6 +3038,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_REAL:
   {
+    if (IsRangeSorted<DReal>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DReal> temp( *this, field);
     quick_sort<DReal, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2134,6 +3048,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_RICHREAL:
   {
+    if (IsRangeSorted<DRichReal>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DRichReal> temp( *this, field);
     quick_sort<DRichReal, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2141,6 +3058,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_INT8:
   {
+    if (IsRangeSorted<DInt8>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DInt8> temp( *this, field);
     quick_sort<DInt8, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2148,6 +3068,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_INT16:
   {
+    if (IsRangeSorted<DInt16>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DInt16> temp( *this, field);
     quick_sort<DInt16, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2155,6 +3078,9 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_INT32:
   {
+    if (IsRangeSorted<DInt32>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DInt32> temp( *this, field);
     quick_sort<DInt32, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2162,12 +3088,18 @@ PrototypeTable::Sort(const FIELD_INDEX field,
 
   case T_INT64:
   {
+    if (IsRangeSorted<DInt64>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DInt64> temp( *this, field);
     quick_sort<DInt64, decltype(temp)>(from, to, reverse, temp);
   }
     break;
   case T_TEXT:
   {
+    if (IsRangeSorted<DText>(field, from, to, reverse))
+      break;
+
     SortTableContainer<DText> temp( *this, field);
     quick_sort<DText, decltype(temp)>(from, to, reverse, temp);
   }
@@ -2189,6 +3121,9 @@ PrototypeTable::MatchRows(const DBool&       min,
   if (mvIndexNodeMgrs[field] != nullptr)
     return MatchRowsWithIndex(min, max, fromRow, toRow, field);
 
+  if (FindBitmapIndex(field) != nullptr)
+    return MatchRowsWithBitmap(min, max, fromRow, toRow, field).Rows();
+
   return MatchRowsNoIndex(min, max, fromRow, toRow, field);
 }
 
@@ -2203,6 +3138,9 @@ PrototypeTable::MatchRows(const DChar&         min,
   if (mvIndexNodeMgrs[field] != nullptr)
     return MatchRowsWithIndex(min, max, fromRow, toRow, field);
 
+  if (FindBitmapIndex(field) != nullptr)
+    return MatchRowsWithBitmap(min, max, fromRow, toRow, field).Rows();
+
   return MatchRowsNoIndex(min, max, fromRow, toRow, field);
 }
 
@@ -2259,6 +3197,9 @@ PrototypeTable::MatchRows(const DUInt8&        min,
   if (mvIndexNodeMgrs[field] != nullptr)
     return MatchRowsWithIndex(min, max, fromRow, toRow, field);
 
+  if (FindBitmapIndex(field) != nullptr)
+    return MatchRowsWithBitmap(min, max, fromRow, toRow, field).Rows();
+
   return MatchRowsNoIndex(min, max, fromRow, toRow, field);
 }
 
@@ -2448,6 +3389,10 @@ PrototypeTable::MatchRowsWithIndex(const T&          min,
       else
         toKey = 0;
 
+      //Let the next leaf load while this one's rows are collected.
+      if ( ! lastNode)
+        nodeMgr->PrefetchNode(node->Next());
+
       if (fromKey >= toKey)
         node->GetRows(fromKey, toKey, fromRow, toRow, result);
 
@@ -2488,18 +3433,481 @@ PrototypeTable::MatchRowsNoIndex(const T&          min,
 {
   DArray result;
 
+  LockGuard<Lock> syncHolder(mRowsSync);
+
   if (mRowsCount == 0)
     return result;
 
   toRow = MIN(toRow, mRowsCount - 1);
+
+  T_FieldZoneMap<T>& zoneMap = RetrieveZoneMap<T>(field);
+
+  ROW_INDEX row = fromRow;
+  while (row <= toRow)
+  {
+    ZoneSummary<T>& zone = zoneMap.Zone(row);
+
+    const ROW_INDEX zoneFirstRow = row - row % ZONE_MAP_ROWS;
+    const ROW_INDEX zoneLastRow  = MIN(zoneFirstRow + ZONE_MAP_ROWS, mRowsCount) - 1;
+    const ROW_INDEX lastRow      = MIN(zoneLastRow, toRow);
+
+    if (zone.mBuilt && ! zone.MayMatch(min, max))
+    {
+      row = lastRow + 1;
+      continue;
+    }
+
+    //Summarise the zone while scanning it, if all its rows are visited.
+    const bool summarise = ! zone.mBuilt
+                           && (row == zoneFirstRow)
+                           && (lastRow == zoneLastRow);
+    for (; row <= lastRow; ++row)
+    {
+      T rowValue;
+      RetrieveEntry(row, field, false, rowValue);
+
+      if (summarise)
+        zone.Add(rowValue);
+
+      if ((rowValue < min) || (max < rowValue))
+        continue;
+
+      result.Add(DROW_INDEX(row));
+    }
+
+    if (summarise)
+      zone.mBuilt = true;
+  }
+
+  return result;
+}
+
+
+template<class T> DBSRowsBitmap
+PrototypeTable::MatchRowsWithBitmap(const T&            min,
+                                    const T&            max,
+                                    const ROW_INDEX     fromRow,
+                                    ROW_INDEX           toRow,
+                                    const FIELD_INDEX   field)
+{
+  const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+  if (desc.Type() != _SC(uint_t, min.DBSType()))
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+
+  DBSRowsBitmap result;
+
+  LockGuard<Lock> syncHolder(mRowsSync);
+
+  if ((mRowsCount == 0) || (fromRow > toRow) || (max < min))
+    return result;
+
+  toRow = MIN(toRow, mRowsCount - 1);
+
+  FieldBitmapIndex* const bitmapIndex = FindBitmapIndex(field);
+  if (bitmapIndex != nullptr)
+  {
+    if ( ! bitmapIndex->IsBuilt())
+      BuildBitmapIndex(*bitmapIndex);
+
+    result = bitmapIndex->Match(min.IsNull(),
+                                bitmap_index_key(min),
+                                max.IsNull(),
+                                bitmap_index_key(max));
+    return result.Crop(fromRow, toRow);
+  }
+
   for (ROW_INDEX row = fromRow; row <= toRow; ++row)
   {
     T rowValue;
-    Get(row, field, rowValue);
+    RetrieveEntry(row, field, false, rowValue);
 
     if ((rowValue < min) || (max < rowValue))
       continue;
 
+    result.Add(row);
+  }
+
+  return result;
+}
+
+
+DBSRowsBitmap
+PrototypeTable::MatchRowsBitmap(const DBool&        min,
+                                const DBool&        max,
+                                const ROW_INDEX     fromRow,
+                                const ROW_INDEX     toRow,
+                                const FIELD_INDEX   field)
+{
+  return MatchRowsWithBitmap(min, max, fromRow, toRow, field);
+}
+
+
+DBSRowsBitmap
+PrototypeTable::MatchRowsBitmap(const DChar&        min,
+                                const DChar&        max,
+                                const ROW_INDEX     fromRow,
+                                const ROW_INDEX     toRow,
+                                const FIELD_INDEX   field)
+{
+  return MatchRowsWithBitmap(min, max, fromRow, toRow, field);
+}
+
+
+DBSRowsBitmap
+PrototypeTable::MatchRowsBitmap(const DUInt8&       min,
+                                const DUInt8&       max,
+                                const ROW_INDEX     fromRow,
+                                const ROW_INDEX     toRow,
+                                const FIELD_INDEX   field)
+{
+  return MatchRowsWithBitmap(min, max, fromRow, toRow, field);
+}
+
+
+template<class T> DBSZone
+PrototypeTable::RetrieveZoneInternal(const ROW_INDEX     row,
+                                     const FIELD_INDEX   field,
+                                     T&                  outMin,
+                                     T&                  outMax,
+                                     const bool          skipThreadSafety)
+{
+  const FieldDescriptor& desc = GetFieldDescriptorInternal(field);
+  if (desc.Type() != _SC(uint_t, outMin.DBSType()))
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+
+  LockGuard<Lock> syncHolder(mRowsSync, skipThreadSafety);
+
+  if (row >= mRowsCount)
+    throw DBSException(_EXTRA(DBSException::ROW_NOT_ALLOCATED));
+
+  const ZoneSummary<T>& zone = RetrieveZoneSummary<T>(row, field);
+
+  DBSZone result;
+  result.mFirstRow   = row - row % ZONE_MAP_ROWS;
+  result.mLastRow    = MIN(result.mFirstRow + ZONE_MAP_ROWS, mRowsCount) - 1;
+  result.mNullsCount = zone.mNullsCount;
+
+  outMin = zone.mMin;
+  outMax = zone.mMax;
+
+  return result;
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DBool&            outMin,
+                             DBool&            outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DChar&            outMin,
+                             DChar&            outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DDate&            outMin,
+                             DDate&            outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DDateTime&        outMin,
+                             DDateTime&        outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DHiresTime&       outMin,
+                             DHiresTime&       outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DUInt8&           outMin,
+                             DUInt8&           outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DUInt16&          outMin,
+                             DUInt16&          outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DUInt32&          outMin,
+                             DUInt32&          outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DUInt64&          outMin,
+                             DUInt64&          outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DInt8&            outMin,
+                             DInt8&            outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DInt16&           outMin,
+                             DInt16&           outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DInt32&           outMin,
+                             DInt32&           outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DInt64&           outMin,
+                             DInt64&           outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DReal&            outMin,
+                             DReal&            outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DBSZone
+PrototypeTable::RetrieveZone(const ROW_INDEX   row,
+                             const FIELD_INDEX field,
+                             DRichReal&        outMin,
+                             DRichReal&        outMax,
+                             const bool        skipThreadSafety)
+{
+  return RetrieveZoneInternal(row, field, outMin, outMax, skipThreadSafety);
+}
+
+
+DArray
+PrototypeTable::MatchCompositeRows(const DBSCompositeKey&     min,
+                                   const DBSCompositeKey&     max,
+                                   const ROW_INDEX            fromRow,
+                                   const ROW_INDEX            toRow,
+                                   const FIELD_INDEX* const   fields,
+                                   const uint_t               fieldsCount)
+{
+  if ((fields == nullptr)
+      || (fieldsCount == 0)
+      || (fieldsCount > COMPOSITE_INDEX_MAX_FIELDS)
+      || (min.Count() > fieldsCount)
+      || (max.Count() > fieldsCount))
+  {
+    throw DBSException(_EXTRA(DBSException::INVALID_PARAMETERS));
+  }
+
+  for (uint_t i = 0; i < fieldsCount; ++i)
+  {
+    const FieldDescriptor& desc = GetFieldDescriptorInternal(fields[i]);
+
+    if (((i < min.Count()) && (min.Type(i) != _SC(DBS_FIELD_TYPE, desc.Type())))
+        || ((i < max.Count()) && (max.Type(i) != _SC(DBS_FIELD_TYPE, desc.Type()))))
+    {
+      throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+    }
+  }
+
+  const uint_t keySize = CompositeKeySize(fields, fieldsCount);
+
+  //The missing key parts are filled such as the bounds cover all the values.
+  uint8_t minKey[COMPOSITE_KEY_MAX_SIZE];
+  uint8_t maxKey[COMPOSITE_KEY_MAX_SIZE];
+
+  memset(minKey, 0, keySize);
+  if (min.RawSize() > 0)
+    memcpy(minKey, min.RawData(), min.RawSize());
+
+  memset(maxKey, 0xFF, keySize);
+  if (max.RawSize() > 0)
+    memcpy(maxKey, max.RawData(), max.RawSize());
+
+  LockGuard<Lock> syncHolder(mRowsSync);
+
+  if ((mRowsCount == 0)
+      || (fromRow > toRow)
+      || (memcmp(minKey, maxKey, keySize) > 0))
+  {
+    return DArray();
+  }
+
+  const int index = FindCompositeIndex(fields, fieldsCount);
+  if (index >= 0)
+    return MatchCompositeRowsWithIndex(minKey, maxKey, fromRow, toRow, index);
+
+  return MatchCompositeRowsNoIndex(minKey, maxKey, fromRow, toRow, fields, fieldsCount);
+}
+
+
+DArray
+PrototypeTable::MatchCompositeRowsWithIndex(const uint8_t* const   minKey,
+                                            const uint8_t* const   maxKey,
+                                            const ROW_INDEX        fromRow,
+                                            ROW_INDEX              toRow,
+                                            const uint_t           index)
+{
+  DArray result;
+
+  toRow = MIN(toRow, mRowsCount - 1);
+
+  FieldIndexNodeManager* const nodeMgr = mvCompositeNodeMgrs[index];
+  const uint_t keySize = nodeMgr->NodeKeySize();
+
+  NODE_INDEX nodeId;
+  KEY_INDEX fromKey;
+  const CompositeBTreeKey firstKey(minKey, keySize, fromRow);
+  const CompositeBTreeKey lastKey(maxKey, keySize, toRow);
+
+  BTree indexTree( *nodeMgr);
+
+  if ( ! indexTree.FindBiggerOrEqual(firstKey, &nodeId, &fromKey))
+    return result;
+
+  auto currentNode = nodeMgr->RetrieveNode(nodeId);
+
+  assert(fromKey < currentNode->KeysCount());
+  while (true)
+  {
+    IBTreeFieldIndexNode* node = _SC(IBTreeFieldIndexNode*, &*currentNode);
+    KEY_INDEX toKey = ~0;
+
+    bool lastNode = false;
+
+    if (node->FindBiggerOrEqual(lastKey, &toKey))
+    {
+      lastNode = true;
+
+      if (node->CompareKey(lastKey, toKey) < 0)
+        toKey++;
+    }
+    else
+      toKey = 0;
+
+    //Let the next leaf load while this one's rows are collected.
+    if ( ! lastNode)
+      nodeMgr->PrefetchNode(node->Next());
+
+    if (fromKey >= toKey)
+      node->GetRows(fromKey, toKey, fromRow, toRow, result);
+
+    if (lastNode || (node->Next() == NIL_NODE))
+      break;
+
+    else
+    {
+      currentNode = nodeMgr->RetrieveNode(node->Next());
+
+      assert(currentNode->KeysCount() > 0);
+
+      fromKey = currentNode->KeysCount() - 1;
+    }
+  }
+
+  return result;
+}
+
+
+DArray
+PrototypeTable::MatchCompositeRowsNoIndex(const uint8_t* const       minKey,
+                                          const uint8_t* const       maxKey,
+                                          const ROW_INDEX            fromRow,
+                                          ROW_INDEX                  toRow,
+                                          const FIELD_INDEX* const   fields,
+                                          const uint_t               fieldsCount)
+{
+  DArray result;
+
+  const uint_t keySize = CompositeKeySize(fields, fieldsCount);
+  uint8_t key[COMPOSITE_KEY_MAX_SIZE];
+
+  toRow = MIN(toRow, mRowsCount - 1);
+  for (ROW_INDEX row = fromRow; row <= toRow; ++row)
+  {
+    StoredItem cachedItem = mRowCache.RetriveItem(row);
+    BuildCompositeKey(cachedItem.GetDataForRead(), fields, fieldsCount, key);
+
+    if ((memcmp(key, minKey, keySize) < 0) || (memcmp(maxKey, key, keySize) < 0))
+      continue;
+
     result.Add(DROW_INDEX(row));
   }
 
@@ -2547,6 +3955,12 @@ PrototypeTable::FlushInternal()
     mvIndexNodeMgrs[field]->FlushNodes();
   }
 
+  for (auto nodeMgr : mvCompositeNodeMgrs)
+  {
+    if (nodeMgr != nullptr)
+      nodeMgr->FlushNodes();
+  }
+
   FlushEpilog();
 
   mRowModified = false;
@@ -2852,5 +4266,220 @@ TableRmNode::SentinelKey() const
 }
 
 
+IFieldAccess&
+PrototypeTable::AccessField(const FIELD_INDEX field)
+{
+  return *(new TableFieldAccess( *this, field));
+}
+
+
+TableFieldAccess::TableFieldAccess(PrototypeTable& table, const FIELD_INDEX field)
+  : mTable(table),
+    mBlock(),
+    mBlockData(nullptr),
+    mBlockFirstRow(0),
+    mBlockRowsCount(0),
+    mRowSize(table.mRowSize),
+    mField(field)
+{
+  const FieldDescriptor& desc = mTable.GetFieldDescriptorInternal(field);
+
+  if ((desc.Type() & PS_TABLE_ARRAY_MASK)
+      || ((desc.Type() & PS_TABLE_FIELD_TYPE_MASK) == T_TEXT))
+  {
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+  }
+
+  mType        = desc.Type() & PS_TABLE_FIELD_TYPE_MASK;
+  mRowDataOff  = desc.RowDataOff();
+  mNullByteOff = desc.NullBitIndex() / 8;
+  mNullBitMask = 1 << (desc.NullBitIndex() % 8);
+}
+
+
+TableFieldAccess::~TableFieldAccess()
+{
+}
+
+
+FIELD_INDEX
+TableFieldAccess::Field() const
+{
+  return mField;
+}
+
+
+void
+TableFieldAccess::Release()
+{
+  delete this;
+}
+
+
+template<class T> void
+TableFieldAccess::Load(const uint8_t* const rowData, T& outValue) const
+{
+  if (rowData[mNullByteOff] & mNullBitMask)
+    outValue = T();
+
+  else
+  {
+    outValue.~T();
+    Serializer::Load(rowData + mRowDataOff, &outValue);
+  }
+}
+
+
+/* The rows of the block kept from the previous reads are read without the
+ * table's rows lock. The value is taken only if no change of the rows was
+ * in progress or has started meanwhile; otherwise the read is done again
+ * under the lock, which also moves the kept block to the one of the row. */
+template<class T> void
+TableFieldAccess::Retrieve(const ROW_INDEX row, T& outValue)
+{
+  if (mType != _SC(uint_t, outValue.DBSType()))
+    throw DBSException(_EXTRA(DBSException::FIELD_TYPE_INVALID));
+
+  const int32_t changes = mTable.mRowsChanges;
+  atomic_thread_fence(memory_order_acquire);
+
+  if (((changes & 1) == 0)
+      && (row - mBlockFirstRow < mBlockRowsCount)
+      && (row < mTable.mRowsCount))
+  {
+    T value;
+    Load(mBlockData + (row - mBlockFirstRow) * mRowSize, value);
+
+    atomic_thread_fence(memory_order_acquire);
+    if (changes == mTable.mRowsChanges)
+    {
+      outValue = value;
+      return;
+    }
+  }
+
+  LockGuard<Lock> syncHolder(mTable.mRowsSync);
+
+  if (row >= mTable.mRowsCount)
+    throw DBSException(_EXTRA(DBSException::ROW_NOT_ALLOCATED));
+
+  const ROW_INDEX rowsPerBlock = mTable.mRowCache.ItemsPerBlock();
+
+  mBlock.reset(nullptr);
+  mBlock.reset(new StoredItem(mTable.mRowCache.RetriveItem(row)));
+
+  mBlockFirstRow  = row - row % rowsPerBlock;
+  mBlockRowsCount = rowsPerBlock;
+  mBlockData      = mBlock->GetDataForRead() - (row % rowsPerBlock) * mRowSize;
+
+  Load(mBlock->GetDataForRead(), outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DBool& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DChar& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DDate& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DDateTime& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DHiresTime& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DUInt8& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DUInt16& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DUInt32& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DUInt64& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DInt8& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DInt16& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DInt32& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DInt64& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DReal& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
+void
+TableFieldAccess::Get(const ROW_INDEX row, DRichReal& outValue)
+{
+  Retrieve(row, outValue);
+}
+
+
 } //namespace pastra
 } //namespace whais
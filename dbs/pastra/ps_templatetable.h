@@ -37,6 +37,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "ps_blockcache.h"
 #include "ps_varstorage.h"
 #include "ps_btree_fields.h"
+#include "ps_btree_composite.h"
+#include "ps_bitmap_index.h"
+#include "ps_zone_map.h"
 
 
 namespace whais {
@@ -89,10 +92,68 @@ private:
   uint8_t  mIndexNodeSizeKB;
 };
 
+class CompositeIndexDescriptor
+{
+public:
+  CompositeIndexDescriptor()
+  {
+    Reset();
+  }
+
+  void Reset()
+  {
+    mFieldsCount = 0;
+    mIndexNodeSizeKB = 0;
+    IndexUnitsCount(0);
+    memset(mFields, 0, sizeof mFields);
+  }
+
+  uint_t FieldsCount() const { return mFieldsCount; }
+  void FieldsCount(const uint_t count) { assert(count <= COMPOSITE_INDEX_MAX_FIELDS); mFieldsCount = count; }
+  FIELD_INDEX Field(const uint_t index) const { assert(index < FieldsCount()); return load_le_int16(mFields[index]); }
+  void Field(const uint_t index, const FIELD_INDEX field) { assert(index < FieldsCount()); store_le_int16(field, mFields[index]); }
+  uint_t IndexNodeSizeKB() const { return mIndexNodeSizeKB; }
+  void IndexNodeSizeKB(const uint_t kb) { assert(kb <= 255); mIndexNodeSizeKB = kb; }
+  uint_t IndexUnitsCount() const { return load_le_int16(mIndexUnitsCount); }
+  void IndexUnitsCount(const uint_t count) { store_le_int16(count, mIndexUnitsCount); }
+
+  bool Matches(const FIELD_INDEX* const fields, const uint_t fieldsCount) const
+  {
+    if (fieldsCount != FieldsCount())
+      return false;
+
+    for (uint_t i = 0; i < fieldsCount; ++i)
+    {
+      if (Field(i) != fields[i])
+        return false;
+    }
+    return true;
+  }
+
+  bool Contains(const FIELD_INDEX field) const
+  {
+    for (uint_t i = 0; i < FieldsCount(); ++i)
+    {
+      if (Field(i) == field)
+        return true;
+    }
+    return false;
+  }
+
+private:
+  uint8_t  mFieldsCount;
+  uint8_t  mIndexNodeSizeKB;
+  uint8_t  mIndexUnitsCount[2];
+  uint8_t  mFields[COMPOSITE_INDEX_MAX_FIELDS][2];
+};
+
+
 class PrototypeTable : public ITable,
                        public IBlocksManager,
                        public IBTreeNodeManager
 {
+  friend class TableFieldAccess;
+
 public:
   PrototypeTable(DbsHandler& dbs);
   PrototypeTable(const PrototypeTable& prototype);
@@ -104,6 +165,7 @@ public:
   virtual void RootNodeId(const NODE_INDEX node) override;
   virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from) override;
   virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) override;
+  virtual void PrefetchItems(uint64_t firstItem, uint_t itemsCount) override;
   virtual FIELD_INDEX FieldsCount() override;
   virtual FIELD_INDEX RetrieveField(const char* name) override;
   virtual DBSFieldDescriptor DescribeField(const FIELD_INDEX field) override;
@@ -112,11 +174,25 @@ public:
   virtual ROW_INDEX GetReusableRow(const bool forceAdd) override;
   virtual ROW_INDEX ReusableRowsCount() override;
   virtual void MarkRowForReuse(const ROW_INDEX row) override;
+  virtual ROW_INDEX MarkRowsForReuse(const DArray& rows) override;
+  virtual ROW_INDEX MarkRowsForReuse(const ROW_INDEX fromRow, const ROW_INDEX toRow) override;
   virtual void CreateIndex(const FIELD_INDEX                   field,
                            CREATE_INDEX_CALLBACK_FUNC* const   cbFunc,
                            CreateIndexCallbackContext* const   cbContext);
   virtual void RemoveIndex(const FIELD_INDEX field) override;
   virtual bool IsIndexed(const FIELD_INDEX field) const override;
+  virtual void CreateCompositeIndex(const FIELD_INDEX* const          fields,
+                                    const uint_t                      fieldsCount,
+                                    CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
+                                    CreateIndexCallbackContext* const cbContext) override;
+  virtual void RemoveCompositeIndex(const FIELD_INDEX* const fields,
+                                    const uint_t             fieldsCount) override;
+  virtual bool IsCompositeIndexed(const FIELD_INDEX* const fields,
+                                  const uint_t             fieldsCount) const override;
+
+  virtual void CreateBitmapIndex(const FIELD_INDEX field) override;
+  virtual void RemoveBitmapIndex(const FIELD_INDEX field) override;
+  virtual bool IsBitmapIndexed(const FIELD_INDEX field) const override;
 
   virtual void Set(const ROW_INDEX row,
                    const FIELD_INDEX field,
@@ -386,6 +462,105 @@ public:
                            const ROW_INDEX fromRow,
                            const ROW_INDEX toRow,
                            const FIELD_INDEX field);
+
+  virtual DArray MatchCompositeRows(const DBSCompositeKey&   min,
+                                    const DBSCompositeKey&   max,
+                                    const ROW_INDEX          fromRow,
+                                    const ROW_INDEX          toRow,
+                                    const FIELD_INDEX* const fields,
+                                    const uint_t             fieldsCount) override;
+
+  virtual DBSRowsBitmap MatchRowsBitmap(const DBool&        min,
+                                        const DBool&        max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) override;
+  virtual DBSRowsBitmap MatchRowsBitmap(const DChar&        min,
+                                        const DChar&        max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) override;
+  virtual DBSRowsBitmap MatchRowsBitmap(const DUInt8&       min,
+                                        const DUInt8&       max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DBool&            outMin,
+                               DBool&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DChar&            outMin,
+                               DChar&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DDate&            outMin,
+                               DDate&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DDateTime&        outMin,
+                               DDateTime&        outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DHiresTime&       outMin,
+                               DHiresTime&       outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt8&           outMin,
+                               DUInt8&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt16&          outMin,
+                               DUInt16&          outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt32&          outMin,
+                               DUInt32&          outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt64&          outMin,
+                               DUInt64&          outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt8&            outMin,
+                               DInt8&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt16&           outMin,
+                               DInt16&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt32&           outMin,
+                               DInt32&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt64&           outMin,
+                               DInt64&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DReal&            outMin,
+                               DReal&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DRichReal&        outMin,
+                               DRichReal&        outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual IFieldAccess& AccessField(const FIELD_INDEX field) override;
   virtual void LockTable() override;
   virtual void UnlockTable() override;
   virtual void Flush() override;
@@ -401,12 +576,14 @@ public:
 protected:
   virtual void MakeHeaderPersistent() = 0;
   virtual IDataContainer* CreateIndexContainer(const FIELD_INDEX field) = 0;
+  virtual IDataContainer* CreateCompositeIndexContainer(const uint_t index) = 0;
   virtual IDataContainer& RowsContainer() = 0;
   virtual IDataContainer& TableContainer() = 0;
   virtual VariableSizeStoreSPtr VSStore() = 0;
   virtual void FlushEpilog() = 0;
   void MarkRowModification(LockGuard<Lock>* const guard);
   void FlushInternal();
+  uint_t CompositeKeySize(const FIELD_INDEX* const fields, const uint_t fieldsCount) const;
 
   //Data members
   DbsHandler&                           mDbs;
@@ -418,9 +595,16 @@ protected:
   FIELD_INDEX                           mFieldsCount;
   std::unique_ptr<uint8_t>              mFieldsDescriptors;
   std::vector<FieldIndexNodeManager*>   mvIndexNodeMgrs;
+  CompositeIndexDescriptor              mCompositeIndexes[COMPOSITE_INDEXES_MAX_COUNT];
+  std::vector<FieldIndexNodeManager*>   mvCompositeNodeMgrs;
+  std::vector<FieldBitmapIndex*>        mvBitmapIndexes;
+  std::vector<std::unique_ptr<FieldZoneMap>> mvZoneMaps;
   BlockCache                            mRowCache;
   Lock                                  mRowsSync;
   Lock                                  mIndexesSync;
+  //Incremented when a change of the rows' content starts and when it
+  //ends, for the field accesses that read them without the rows lock.
+  volatile int32_t                      mRowsChanges;
   bool                                  mRowModified;
   bool                                  mLockInProgress;
 
@@ -440,6 +624,52 @@ private:
                                             const ROW_INDEX fromRow,
                                             ROW_INDEX toRow,
                                             const FIELD_INDEX filedIndex);
+  int FindCompositeIndex(const FIELD_INDEX* const fields, const uint_t fieldsCount) const;
+  void BuildCompositeKey(const uint8_t* const       rowData,
+                         const FIELD_INDEX* const   fields,
+                         const uint_t               fieldsCount,
+                         uint8_t* const             outKey) const;
+  bool IsFieldInCompositeIndex(const FIELD_INDEX field) const;
+  void UpdateCompositeIndexes(const ROW_INDEX        row,
+                              const FIELD_INDEX      field,
+                              const uint8_t* const   oldRowData,
+                              const uint8_t* const   newRowData);
+  DArray MatchCompositeRowsWithIndex(const uint8_t* const   minKey,
+                                     const uint8_t* const   maxKey,
+                                     const ROW_INDEX        fromRow,
+                                     const ROW_INDEX        toRow,
+                                     const uint_t           index);
+  DArray MatchCompositeRowsNoIndex(const uint8_t* const       minKey,
+                                   const uint8_t* const       maxKey,
+                                   const ROW_INDEX            fromRow,
+                                   const ROW_INDEX            toRow,
+                                   const FIELD_INDEX* const   fields,
+                                   const uint_t               fieldsCount);
+  FieldBitmapIndex* FindBitmapIndex(const FIELD_INDEX field) const;
+  void BuildBitmapIndex(FieldBitmapIndex& index);
+  template<class T> void BuildBitmapIndex(FieldBitmapIndex& index);
+  template<class T> DBSRowsBitmap MatchRowsWithBitmap(const T& min,
+                                                      const T& max,
+                                                      const ROW_INDEX fromRow,
+                                                      ROW_INDEX toRow,
+                                                      const FIELD_INDEX field);
+  template<class T> T_FieldZoneMap<T>* FindZoneMap(const FIELD_INDEX field) const;
+  template<class T> T_FieldZoneMap<T>& RetrieveZoneMap(const FIELD_INDEX field);
+  template<class T> ZoneSummary<T>& RetrieveZoneSummary(const ROW_INDEX row,
+                                                        const FIELD_INDEX field);
+  template<class T> DBSZone RetrieveZoneInternal(const ROW_INDEX row,
+                                                 const FIELD_INDEX field,
+                                                 T& outMin,
+                                                 T& outMax,
+                                                 const bool skipThreadSafety);
+  template<class T> bool IsRangeSorted(const FIELD_INDEX field,
+                                       const ROW_INDEX fromRow,
+                                       const ROW_INDEX toRow,
+                                       const bool reverse);
+  ROW_INDEX MarkRowsForReuseInternal(std::vector<ROW_INDEX>& rows);
+  template<class T> void ClearRowsField(const FIELD_INDEX field,
+                                        const std::vector<ROW_INDEX>& rows);
+  bool IsRowEmpty(const uint8_t* const rowData) const;
   void CheckRowToReuse(const ROW_INDEX row);
   void CheckRowToDelete(const ROW_INDEX row);
   void AcquireFieldIndex(FieldDescriptor* const field);
@@ -451,6 +681,51 @@ private:
 
 };
 
+class TableFieldAccess : public IFieldAccess
+{
+public:
+  TableFieldAccess(PrototypeTable& table, const FIELD_INDEX field);
+
+  virtual FIELD_INDEX Field() const override;
+
+  virtual void Get(const ROW_INDEX row, DBool& outValue) override;
+  virtual void Get(const ROW_INDEX row, DChar& outValue) override;
+  virtual void Get(const ROW_INDEX row, DDate& outValue) override;
+  virtual void Get(const ROW_INDEX row, DDateTime& outValue) override;
+  virtual void Get(const ROW_INDEX row, DHiresTime& outValue) override;
+  virtual void Get(const ROW_INDEX row, DUInt8& outValue) override;
+  virtual void Get(const ROW_INDEX row, DUInt16& outValue) override;
+  virtual void Get(const ROW_INDEX row, DUInt32& outValue) override;
+  virtual void Get(const ROW_INDEX row, DUInt64& outValue) override;
+  virtual void Get(const ROW_INDEX row, DInt8& outValue) override;
+  virtual void Get(const ROW_INDEX row, DInt16& outValue) override;
+  virtual void Get(const ROW_INDEX row, DInt32& outValue) override;
+  virtual void Get(const ROW_INDEX row, DInt64& outValue) override;
+  virtual void Get(const ROW_INDEX row, DReal& outValue) override;
+  virtual void Get(const ROW_INDEX row, DRichReal& outValue) override;
+
+  virtual void Release() override;
+
+private:
+  virtual ~TableFieldAccess() override;
+
+  template<class T> void Retrieve(const ROW_INDEX row, T& outValue);
+  template<class T> void Load(const uint8_t* const rowData, T& outValue) const;
+
+  PrototypeTable&               mTable;
+  std::unique_ptr<StoredItem>   mBlock;
+  const uint8_t*                mBlockData;
+  ROW_INDEX                     mBlockFirstRow;
+  ROW_INDEX                     mBlockRowsCount;
+  const uint_t                  mRowSize;
+  uint_t                        mType;
+  uint_t                        mRowDataOff;
+  uint_t                        mNullByteOff;
+  uint8_t                       mNullBitMask;
+  const FIELD_INDEX             mField;
+};
+
+
 class TableRmKey : public IBTreeKey
 {
 public:
@@ -938,6 +938,23 @@ VariableSizeStore::DecrementRecordRef(const uint64_t recordFirstEntry)
 {
   LockGuard<Lock> sync(mSync);
 
+  DecrementRecordRefInternal(recordFirstEntry);
+}
+
+
+void
+VariableSizeStore::DecrementRecordsRefs(const std::vector<uint64_t>& recordsFirstEntries)
+{
+  LockGuard<Lock> sync(mSync);
+
+  for (auto recordFirstEntry : recordsFirstEntries)
+    DecrementRecordRefInternal(recordFirstEntry);
+}
+
+
+void
+VariableSizeStore::DecrementRecordRefInternal(const uint64_t recordFirstEntry)
+{
   StoredItem cachedItem = mEntriesCache.RetriveItem(recordFirstEntry);
   const auto entry = _RC(StoreEntry*, cachedItem.GetDataForUpdate());
 
@@ -995,6 +1012,20 @@ VariableSizeStore::RetrieveItems(uint64_t    firstItem,
 }
 
 
+void
+VariableSizeStore::PrefetchItems(uint64_t firstItem, uint_t itemsCount)
+{
+  if (firstItem >= mEntriesCount)
+    return;
+
+  if (firstItem + itemsCount > mEntriesCount)
+    itemsCount = mEntriesCount - firstItem;
+
+  mEntriesContainer->Prefetch(firstItem * sizeof(StoreEntry),
+                              itemsCount * sizeof(StoreEntry));
+}
+
+
 uint64_t
 VariableSizeStore::AllocateEntry(const uint64_t prevEntryId)
 {
@@ -1177,7 +1208,7 @@ VariableSizeStore::AddToFreeList(const uint64_t entryId)
   StoredItem neighborCachedItem = cachedItem;
   StoreEntry* neighborEntry = nullptr;
 
-  assert(entry > 0);
+  assert(entry != nullptr);
   assert(entry->IsDeleted() == false);
 
   entry->MarkAsDeleted(true);
@@ -146,11 +146,13 @@ public:
 
   void IncrementRecordRef(const uint64_t recordFirstEntry);
   void DecrementRecordRef(const uint64_t recordFirstEntry);
+  void DecrementRecordsRefs(const std::vector<uint64_t>& recordsFirstEntries);
 
   uint64_t Size() const;
 
   virtual void StoreItems(uint64_t firstItem, uint_t itemsCount, const uint8_t* const from) override;
   virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) override;
+  virtual void PrefetchItems(uint64_t firstItem, uint_t itemsCount) override;
 
   void PrepareToCheckStorage();
   bool CheckArrayEntry(const uint64_t recordFirstEntry,
@@ -165,6 +167,7 @@ private:
   uint64_t AllocateEntry(const uint64_t prevEntryId);
   uint64_t ExtentFreeList();
   void RemoveRecord(uint64_t recordFirstEntry);
+  void DecrementRecordRefInternal(const uint64_t recordFirstEntry);
   void ExtractFromFreeList(const uint64_t entryId);
   void AddToFreeList(const uint64_t entryId);
 
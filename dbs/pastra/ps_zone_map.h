@@ -0,0 +1,161 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+
+#ifndef PS_ZONE_MAP_H_
+#define PS_ZONE_MAP_H_
+
+#include <assert.h>
+#include <vector>
+
+#include "whais.h"
+
+#include "dbs/dbs_values.h"
+
+
+namespace whais {
+namespace pastra {
+
+
+static const ROW_INDEX ZONE_MAP_ROWS = 1024;
+
+
+/* The bounds and the nulls count of a field's values in a block of
+ * ZONE_MAP_ROWS consecutive rows. The bounds are only widened as rows are
+ * updated, so they might be looser than the actual values but never
+ * narrower. The nulls count is always exact. */
+template<class T> struct ZoneSummary
+{
+  ZoneSummary()
+    : mNullsCount(0),
+      mBuilt(false)
+  {
+  }
+
+  void Add(const T& value)
+  {
+    if (value.IsNull())
+    {
+      ++mNullsCount;
+      return;
+    }
+
+    if (mMin.IsNull() || (value < mMin))
+      mMin = value;
+
+    if (mMax.IsNull() || (mMax < value))
+      mMax = value;
+  }
+
+  void Remove(const T& value)
+  {
+    if (value.IsNull())
+    {
+      assert(mNullsCount > 0);
+      --mNullsCount;
+    }
+  }
+
+  bool MayMatch(const T& min, const T& max) const
+  {
+    //A null value is smaller than any other value.
+    if ((mNullsCount > 0) && min.IsNull())
+      return true;
+
+    if (mMin.IsNull())
+      return false;
+
+    return ! (mMax < min) && ! (max < mMin);
+  }
+
+  T           mMin;
+  T           mMax;
+  ROW_INDEX   mNullsCount;
+  bool        mBuilt;
+};
+
+
+class FieldZoneMap
+{
+public:
+  virtual ~FieldZoneMap() = default;
+
+  virtual void AddNullRow(const ROW_INDEX row) = 0;
+};
+
+
+/* Keeps the summaries of a field's zones. A zone is summarised the first
+ * time it's needed and it's kept up to date as its rows change. */
+template<class T> class T_FieldZoneMap : public FieldZoneMap
+{
+public:
+  virtual void AddNullRow(const ROW_INDEX row) override
+  {
+    const ROW_INDEX zone = row / ZONE_MAP_ROWS;
+
+    if ((zone < mZones.size()) && mZones[zone].mBuilt)
+      ++mZones[zone].mNullsCount;
+  }
+
+  void Update(const ROW_INDEX row, const T& oldValue, const T& newValue)
+  {
+    const ROW_INDEX zone = row / ZONE_MAP_ROWS;
+
+    if ((zone >= mZones.size()) || ! mZones[zone].mBuilt)
+      return;
+
+    mZones[zone].Remove(oldValue);
+    mZones[zone].Add(newValue);
+  }
+
+  ZoneSummary<T>& Zone(const ROW_INDEX row)
+  {
+    const ROW_INDEX zone = row / ZONE_MAP_ROWS;
+
+    if (zone >= mZones.size())
+      mZones.resize(zone + 1);
+
+    return mZones[zone];
+  }
+
+  const ZoneSummary<T>* BuiltZone(const ROW_INDEX row) const
+  {
+    const ROW_INDEX zone = row / ZONE_MAP_ROWS;
+
+    if ((zone >= mZones.size()) || ! mZones[zone].mBuilt)
+      return nullptr;
+
+    return &mZones[zone];
+  }
+
+private:
+  std::vector<ZoneSummary<T>>   mZones;
+};
+
+
+} //namespace pastra
+} //namespace whais
+
+
+#endif /* PS_ZONE_MAP_H_ */
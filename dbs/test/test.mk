@@ -122,3 +122,19 @@ test_autofix_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmema
 UNIT_EXES+=test_field_variable_values
 test_field_variable_values_SRC=test/test_field_variable_values.cpp
 test_field_variable_values_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_compositeindex
+test_compositeindex_SRC=test/test_compositeindex.cpp
+test_compositeindex_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_bitmapindex
+test_bitmapindex_SRC=test/test_bitmapindex.cpp
+test_bitmapindex_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_zonemap
+test_zonemap_SRC=test/test_zonemap.cpp
+test_zonemap_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_bulkreuse
+test_bulkreuse_SRC=test/test_bulkreuse.cpp
+test_bulkreuse_LIB=dbs/wslpastra utils/wslutils custom/wslcustom custom/wslcppmemalloc 
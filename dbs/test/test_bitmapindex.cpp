@@ -0,0 +1,421 @@
+/*
+ * test_bitmapindex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "utils/wrandom.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+
+#include "../pastra/ps_table.h"
+
+using namespace whais;
+using namespace pastra;
+
+struct DBSFieldDescriptor field_desc[] = {
+    {"flag", T_BOOL, false},
+    {"grade", T_UINT8, false},
+    {"letter", T_CHAR, false}
+};
+
+const char db_name[] = "t_baza_date_1";
+const char tb_name[] = "t_test_tab";
+
+static uint_t _rowsCount = 150000;
+
+//The table does not keep the fields in the order they were declared.
+static FIELD_INDEX _flagField;
+static FIELD_INDEX _gradeField;
+static FIELD_INDEX _letterField;
+
+
+struct RowValues
+{
+  DBool  flag;
+  DUInt8 grade;
+  DChar  letter;
+};
+
+
+static bool
+same_rows(const DBSRowsBitmap& bitmap, const std::set<ROW_INDEX>& expected)
+{
+  if (bitmap.Count() != expected.size())
+    return false;
+
+  const DArray rows = bitmap.Rows();
+  if (rows.Count() != expected.size())
+    return false;
+
+  uint64_t i = 0;
+  for (auto row : expected)
+    {
+      DROW_INDEX value;
+      rows.Get(i++, value);
+
+      if (value.mValue != row || ! bitmap.Contains(row))
+        return false;
+    }
+
+  return true;
+}
+
+
+static std::set<ROW_INDEX>
+random_rows_set(const ROW_INDEX maxRow, const uint_t count)
+{
+  std::set<ROW_INDEX> result;
+
+  for (uint_t i = 0; i < count; ++i)
+    result.insert(wh_rnd() % maxRow);
+
+  return result;
+}
+
+
+static DBSRowsBitmap
+bitmap_from_set(const std::set<ROW_INDEX>& rows)
+{
+  DBSRowsBitmap result;
+
+  for (auto row : rows)
+    result.Add(row);
+
+  return result;
+}
+
+
+static bool
+test_bitmap_operations()
+{
+  std::cout << "Testing rows bitmaps operations ... ";
+
+  bool result = true;
+
+  wh_rnd_set_seed(3);
+  for (uint_t iteration = 0; (iteration < 8) && result; ++iteration)
+    {
+      //Mix sparse and dense chunks.
+      const ROW_INDEX maxRow = 200000;
+      const std::set<ROW_INDEX> s1 = random_rows_set(maxRow, (iteration % 2) ? 1000 : 90000);
+      const std::set<ROW_INDEX> s2 = random_rows_set(maxRow, (iteration % 3) ? 50000 : 3000);
+
+      DBSRowsBitmap b1 = bitmap_from_set(s1);
+      DBSRowsBitmap b2 = bitmap_from_set(s2);
+
+      result &= same_rows(b1, s1);
+
+      std::set<ROW_INDEX> expected;
+      for (auto row : s1)
+        {
+          if (s2.count(row) > 0)
+            expected.insert(row);
+        }
+      result &= same_rows(DBSRowsBitmap(b1).And(b2), expected);
+
+      expected = s1;
+      expected.insert(s2.begin(), s2.end());
+      result &= same_rows(DBSRowsBitmap(b1).Or(b2), expected);
+
+      expected.clear();
+      for (auto row : s1)
+        {
+          if (s2.count(row) == 0)
+            expected.insert(row);
+        }
+      result &= same_rows(DBSRowsBitmap(b1).AndNot(b2), expected);
+
+      const ROW_INDEX rowsCount = maxRow - 1234;
+      expected.clear();
+      for (ROW_INDEX row = 0; row < rowsCount; ++row)
+        {
+          if (s1.count(row) == 0)
+            expected.insert(row);
+        }
+      result &= same_rows(DBSRowsBitmap(b1).Not(rowsCount), expected);
+
+      const ROW_INDEX from = 70000 + iteration, to = 140000 - iteration;
+      expected.clear();
+      for (auto row : s1)
+        {
+          if ((from <= row) && (row <= to))
+            expected.insert(row);
+        }
+      result &= same_rows(DBSRowsBitmap(b1).Crop(from, to), expected);
+
+      for (auto row : s2)
+        b1.Remove(row);
+
+      expected.clear();
+      for (auto row : s1)
+        {
+          if (s2.count(row) == 0)
+            expected.insert(row);
+        }
+      result &= same_rows(b1, expected);
+      result &= same_rows(DBSRowsBitmap::FromRows(b1.Rows()), expected);
+    }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static void
+generate_values(RowValues& values)
+{
+  values.flag   = (wh_rnd() % 10 == 0) ? DBool() : DBool(wh_rnd() % 2 == 0);
+  values.grade  = (wh_rnd() % 13 == 0) ? DUInt8() : DUInt8(wh_rnd() % 6);
+  values.letter = DChar('a' + wh_rnd() % 4);
+}
+
+
+static void
+set_row_values(ITable& table, const ROW_INDEX row, const RowValues& values)
+{
+  table.Set(row, _flagField, values.flag);
+  table.Set(row, _gradeField, values.grade);
+  table.Set(row, _letterField, values.letter);
+}
+
+
+template<typename T> static std::set<ROW_INDEX>
+expected_rows(const std::vector<RowValues>& values,
+              T RowValues::*member,
+              const T& min,
+              const T& max)
+{
+  std::set<ROW_INDEX> result;
+
+  for (ROW_INDEX row = 0; row < values.size(); ++row)
+    {
+      const T& value = values[row].*member;
+
+      if ((value < min) || (max < value))
+        continue;
+
+      result.insert(row);
+    }
+
+  return result;
+}
+
+
+static bool
+check_matches(ITable& table, const std::vector<RowValues>& values)
+{
+  bool result = true;
+
+  result &= same_rows(table.MatchRowsBitmap(DBool(true), DBool(true), 0, ~0, _flagField),
+                      expected_rows(values, &RowValues::flag, DBool(true), DBool(true)));
+  result &= same_rows(table.MatchRowsBitmap(DBool(), DBool(), 0, ~0, _flagField),
+                      expected_rows(values, &RowValues::flag, DBool(), DBool()));
+  result &= same_rows(table.MatchRowsBitmap(DUInt8(2), DUInt8(4), 0, ~0, _gradeField),
+                      expected_rows(values, &RowValues::grade, DUInt8(2), DUInt8(4)));
+  std::set<ROW_INDEX> expected = expected_rows(values,
+                                               &RowValues::grade,
+                                               DUInt8(),
+                                               DUInt8(1));
+  expected.erase(expected.begin(), expected.lower_bound(100));
+  expected.erase(expected.upper_bound(90000), expected.end());
+  result &= same_rows(table.MatchRowsBitmap(DUInt8(), DUInt8(1), 100, 90000, _gradeField),
+                      expected);
+
+  //A two predicates filter: flag = TRUE AND grade IN [2, 4].
+  DBSRowsBitmap filter = table.MatchRowsBitmap(DBool(true), DBool(true), 0, ~0, _flagField);
+  filter.And(table.MatchRowsBitmap(DUInt8(2), DUInt8(4), 0, ~0, _gradeField));
+
+  expected.clear();
+  for (ROW_INDEX row = 0; row < values.size(); ++row)
+    {
+      if ((values[row].flag == DBool(true))
+          && ! (values[row].grade < DUInt8(2))
+          && ! (DUInt8(4) < values[row].grade))
+        {
+          expected.insert(row);
+        }
+    }
+  result &= same_rows(filter, expected);
+
+  const DArray rows = table.MatchRows(DUInt8(5), DUInt8(5), 0, ~0, _gradeField);
+  result &= same_rows(DBSRowsBitmap::FromRows(rows),
+                      expected_rows(values, &RowValues::grade, DUInt8(5), DUInt8(5)));
+
+  return result;
+}
+
+
+static bool
+test_index_creation(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Creating bitmap indexes ... ";
+
+  wh_rnd_set_seed(1);
+  for (uint_t row = 0; row < _rowsCount; ++row)
+    {
+      RowValues rowValues;
+      generate_values(rowValues);
+
+      if (table.AddRow() != row)
+        return false;
+
+      set_row_values(table, row, rowValues);
+      values.push_back(rowValues);
+    }
+
+  bool result = check_matches(table, values);
+
+  table.CreateBitmapIndex(_flagField);
+  table.CreateBitmapIndex(_gradeField);
+
+  result = result && table.IsBitmapIndexed(_flagField);
+  result = result && table.IsBitmapIndexed(_gradeField);
+  result = result && ! table.IsBitmapIndexed(_letterField);
+  result = result && ! table.IsIndexed(_flagField);
+  result = result && check_matches(table, values);
+
+  try
+    {
+      table.CreateBitmapIndex(_flagField);
+      result = false;
+    }
+  catch (DBSException& e)
+    {
+      if (e.Code() != DBSException::FIELD_INDEXED)
+        result = false;
+    }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_index_update(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Updating bitmap indexed rows ... ";
+
+  wh_rnd_set_seed(2);
+  for (uint_t i = 0; i < _rowsCount / 4; ++i)
+    {
+      const ROW_INDEX row = wh_rnd() % values.size();
+
+      generate_values(values[row]);
+      set_row_values(table, row, values[row]);
+    }
+
+  for (uint_t i = 0; i < 100; ++i)
+    {
+      RowValues rowValues;
+      generate_values(rowValues);
+
+      const ROW_INDEX row = table.AddRow();
+      if (row != values.size())
+        return false;
+
+      set_row_values(table, row, rowValues);
+      values.push_back(rowValues);
+    }
+
+  table.ExchangeRows(0, values.size() - 1);
+  std::swap(values[0], values[values.size() - 1]);
+
+  const bool result = check_matches(table, values);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_index_survival(IDBSHandler& dbsHnd, std::vector<RowValues>& values)
+{
+  std::cout << "Checking bitmap indexes after reopening ... ";
+
+  ITable& table = dbsHnd.RetrievePersistentTable(tb_name);
+
+  bool result = table.IsBitmapIndexed(_flagField) && table.IsBitmapIndexed(_gradeField);
+
+  //Changes made before the index is needed again must be caught too.
+  values[7].grade = DUInt8(5);
+  table.Set(7, _gradeField, values[7].grade);
+
+  result = result && check_matches(table, values);
+
+  table.RemoveBitmapIndex(_flagField);
+  result = result && ! table.IsBitmapIndexed(_flagField);
+  result = result && check_matches(table, values);
+
+  dbsHnd.ReleaseTable(table);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  if (argc > 1)
+    {
+      _rowsCount = atol(argv[1]);
+    }
+
+  bool success = true;
+  {
+    DBSInit(DBSSettings());
+    DBSCreateDatabase(db_name);
+  }
+
+  success = success && test_bitmap_operations();
+
+  IDBSHandler& handler = DBSRetrieveDatabase(db_name);
+  handler.AddTable(tb_name, sizeof field_desc / sizeof(field_desc[0]), field_desc);
+
+  {
+    std::vector<RowValues> values;
+    {
+      ITable& table = handler.RetrievePersistentTable(tb_name);
+
+      _flagField   = table.RetrieveField("flag");
+      _gradeField  = table.RetrieveField("grade");
+      _letterField = table.RetrieveField("letter");
+
+      success = success && test_index_creation(table, values);
+      success = success && test_index_update(table, values);
+
+      handler.ReleaseTable(table);
+    }
+
+    success = success && test_index_survival(handler, values);
+  }
+
+  DBSReleaseDatabase(handler);
+  DBSRemoveDatabase(db_name);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
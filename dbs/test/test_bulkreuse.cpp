@@ -0,0 +1,367 @@
+/*
+ * test_bulkreuse.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "utils/wrandom.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+
+#include "../pastra/ps_table.h"
+
+using namespace whais;
+using namespace pastra;
+
+struct DBSFieldDescriptor field_desc[] = {
+    {"id", T_UINT32, false},
+    {"grade", T_UINT8, false},
+    {"stamp", T_UINT64, false},
+    {"note", T_TEXT, false}
+};
+
+const char db_name[] = "t_baza_date_1";
+const char tb_name[] = "t_test_tab";
+
+static uint_t _rowsCount = 20000;
+
+//The table does not keep the fields in the order they were declared.
+static FIELD_INDEX _idField;
+static FIELD_INDEX _gradeField;
+static FIELD_INDEX _stampField;
+static FIELD_INDEX _noteField;
+static FIELD_INDEX _compositeFields[2];
+
+static const char* _notes[] = {
+    "",
+    "short",
+    "A note long enough to be kept into the variable size store.",
+    "Another long note that has to be kept into the variable size store."
+};
+
+
+struct RowValues
+{
+  DUInt32  id;
+  DUInt8   grade;
+  DUInt64  stamp;
+  DText    note;
+};
+
+
+static void
+set_row_values(ITable& table, const ROW_INDEX row, const RowValues& values)
+{
+  table.Set(row, _idField, values.id);
+  table.Set(row, _gradeField, values.grade);
+  table.Set(row, _stampField, values.stamp);
+  table.Set(row, _noteField, values.note);
+}
+
+
+static std::set<ROW_INDEX>
+rows_set(const DArray& rows)
+{
+  std::set<ROW_INDEX> result;
+
+  for (uint64_t i = 0; i < rows.Count(); ++i)
+  {
+    DROW_INDEX row;
+    rows.Get(i, row);
+    result.insert(row.mValue);
+  }
+
+  return result;
+}
+
+
+template<typename T> static std::set<ROW_INDEX>
+expected_rows(const std::vector<RowValues>& values,
+              T RowValues::*member,
+              const T& min,
+              const T& max)
+{
+  std::set<ROW_INDEX> result;
+
+  for (ROW_INDEX row = 0; row < values.size(); ++row)
+  {
+    const T& value = values[row].*member;
+
+    if ((value < min) || (max < value))
+      continue;
+
+    result.insert(row);
+  }
+
+  return result;
+}
+
+
+static bool
+check_table(ITable& table, const std::vector<RowValues>& values)
+{
+  ROW_INDEX emptyRows = 0;
+
+  for (ROW_INDEX row = 0; row < values.size(); ++row)
+  {
+    RowValues rowValues;
+
+    table.Get(row, _idField, rowValues.id);
+    table.Get(row, _gradeField, rowValues.grade);
+    table.Get(row, _stampField, rowValues.stamp);
+    table.Get(row, _noteField, rowValues.note);
+
+    if ((rowValues.id != values[row].id)
+        || (rowValues.grade != values[row].grade)
+        || (rowValues.stamp != values[row].stamp)
+        || (rowValues.note != values[row].note))
+    {
+      return false;
+    }
+
+    if (values[row].id.IsNull()
+        && values[row].grade.IsNull()
+        && values[row].stamp.IsNull()
+        && values[row].note.IsNull())
+    {
+      ++emptyRows;
+    }
+  }
+
+  if (table.ReusableRowsCount() != emptyRows)
+    return false;
+
+  bool result = true;
+
+  result &= rows_set(table.MatchRows(DUInt32(), DUInt32(), 0, ~0, _idField))
+            == expected_rows(values, &RowValues::id, DUInt32(), DUInt32());
+  result &= rows_set(table.MatchRows(DUInt32(100), DUInt32(5000), 0, ~0, _idField))
+            == expected_rows(values, &RowValues::id, DUInt32(100), DUInt32(5000));
+  result &= rows_set(table.MatchRowsBitmap(DUInt8(2), DUInt8(4), 0, ~0, _gradeField).Rows())
+            == expected_rows(values, &RowValues::grade, DUInt8(2), DUInt8(4));
+  result &= rows_set(table.MatchRowsBitmap(DUInt8(), DUInt8(), 0, ~0, _gradeField).Rows())
+            == expected_rows(values, &RowValues::grade, DUInt8(), DUInt8());
+  result &= rows_set(table.MatchRows(DUInt64(3000), DUInt64(9000), 0, ~0, _stampField))
+            == expected_rows(values, &RowValues::stamp, DUInt64(3000), DUInt64(9000));
+
+  for (ROW_INDEX row = 0; (row < values.size()) && result; row += 97)
+  {
+    DBSCompositeKey key;
+    key.Add(DUInt32(row)).Add(values[row].grade);
+
+    const std::set<ROW_INDEX> matched = rows_set(table.MatchCompositeRows(key,
+                                                                          key,
+                                                                          0,
+                                                                          ~0,
+                                                                          _compositeFields,
+                                                                          2));
+    if (values[row].id.IsNull())
+      result = matched.empty();
+
+    else
+      result = (matched.size() == 1) && (*matched.begin() == row);
+  }
+
+  return result;
+}
+
+
+static bool
+fill_table(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Filling table with " << _rowsCount << " rows ... ";
+
+  wh_rnd_set_seed(1);
+  for (uint_t row = 0; row < _rowsCount; ++row)
+  {
+    RowValues rowValues;
+
+    rowValues.id    = DUInt32(row);
+    rowValues.grade = (wh_rnd() % 11 == 0) ? DUInt8() : DUInt8(wh_rnd() % 6);
+    rowValues.stamp = DUInt64(row * 3);
+    rowValues.note  = DText(_notes[wh_rnd() % 4]);
+
+    if (table.AddRow() != row)
+      return false;
+
+    set_row_values(table, row, rowValues);
+    values.push_back(rowValues);
+  }
+
+  table.CreateIndex(_idField, nullptr, nullptr);
+  table.CreateBitmapIndex(_gradeField);
+  table.CreateCompositeIndex(_compositeFields, 2, nullptr, nullptr);
+
+  const bool result = check_table(table, values);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static ROW_INDEX
+empty_values(std::vector<RowValues>& values, const ROW_INDEX row)
+{
+  if (values[row].id.IsNull())
+    return 0;
+
+  values[row] = RowValues();
+  return 1;
+}
+
+
+static bool
+test_rows_list(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Emptying a list of rows ... ";
+
+  DArray rows;
+  ROW_INDEX expected = 0;
+
+  //Unsorted, with duplicates and with rows out of the table.
+  wh_rnd_set_seed(2);
+  for (uint_t i = 0; i < _rowsCount / 3; ++i)
+  {
+    const ROW_INDEX row = wh_rnd() % values.size();
+
+    rows.Add(DUInt32(row));
+    expected += empty_values(values, row);
+  }
+  rows.Add(DUInt32(_rowsCount + 10));
+
+  bool result = (table.MarkRowsForReuse(rows) == expected);
+  result = result && check_table(table, values);
+
+  //Nothing left to do the second time.
+  result = result && (table.MarkRowsForReuse(rows) == 0);
+  result = result && (table.MarkRowsForReuse(DArray()) == 0);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_rows_range(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Emptying a range of rows ... ";
+
+  ROW_INDEX expected = 0;
+  for (ROW_INDEX row = 1000; row <= 7000; ++row)
+    expected += empty_values(values, row);
+
+  bool result = (table.MarkRowsForReuse(1000, 7000) == expected);
+  result = result && check_table(table, values);
+
+  expected = 0;
+  for (ROW_INDEX row = values.size() - 50; row < values.size(); ++row)
+    expected += empty_values(values, row);
+
+  result = result && (table.MarkRowsForReuse(values.size() - 50, ~0) == expected);
+  result = result && (table.MarkRowsForReuse(7000, 1000) == 0);
+  result = result && (table.MarkRowsForReuse(values.size(), ~0) == 0);
+  result = result && check_table(table, values);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_rows_reuse(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Reusing the emptied rows ... ";
+
+  bool result = true;
+
+  wh_rnd_set_seed(3);
+  for (uint_t i = 0; (i < 3000) && result; ++i)
+  {
+    const ROW_INDEX row = table.GetReusableRow(false);
+
+    result = (row < values.size()) && values[row].id.IsNull();
+    if ( ! result)
+      break;
+
+    RowValues rowValues;
+
+    rowValues.id    = DUInt32(row);
+    rowValues.grade = DUInt8(wh_rnd() % 6);
+    rowValues.note  = DText(_notes[2 + wh_rnd() % 2]);
+
+    set_row_values(table, row, rowValues);
+    values[row] = rowValues;
+  }
+
+  result = result && check_table(table, values);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    _rowsCount = atol(argv[1]);
+  }
+
+  bool success = true;
+  {
+    DBSInit(DBSSettings());
+    DBSCreateDatabase(db_name);
+  }
+
+  IDBSHandler& handler = DBSRetrieveDatabase(db_name);
+  handler.AddTable(tb_name, sizeof field_desc / sizeof(field_desc[0]), field_desc);
+
+  {
+    std::vector<RowValues> values;
+    ITable& table = handler.RetrievePersistentTable(tb_name);
+
+    _idField    = table.RetrieveField("id");
+    _gradeField = table.RetrieveField("grade");
+    _stampField = table.RetrieveField("stamp");
+    _noteField  = table.RetrieveField("note");
+
+    _compositeFields[0] = _idField;
+    _compositeFields[1] = _gradeField;
+
+    success = success && fill_table(table, values);
+    success = success && test_rows_list(table, values);
+    success = success && test_rows_range(table, values);
+    success = success && test_rows_reuse(table, values);
+
+    handler.ReleaseTable(table);
+  }
+
+  DBSReleaseDatabase(handler);
+  DBSRemoveDatabase(db_name);
+  DBSShoutdown();
+
+  if (!success)
+  {
+    std::cout << "TEST RESULT: FAIL" << std::endl;
+    return 1;
+  }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
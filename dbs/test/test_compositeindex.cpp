@@ -0,0 +1,357 @@
+/*
+ * test_compositeindex.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "utils/wrandom.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+
+#include "../pastra/ps_table.h"
+
+using namespace whais;
+using namespace pastra;
+
+struct DBSFieldDescriptor field_desc[] = {
+    {"customer", T_UINT32, false},
+    {"day", T_DATE, false},
+    {"amount", T_INT16, false}
+};
+
+const char db_name[] = "t_baza_date_1";
+const char tb_name[] = "t_test_tab";
+
+static const uint_t _customersCount = 50;
+
+//The table does not keep the fields in the order they were declared.
+static FIELD_INDEX _customerField;
+static FIELD_INDEX _dayField;
+static FIELD_INDEX _amountField;
+static FIELD_INDEX _indexedFields[2];
+
+static uint_t _rowsCount = 20000;
+
+
+struct RowValues
+{
+  DUInt32 customer;
+  DDate   day;
+};
+
+
+static DDate
+generate_date()
+{
+  if ((wh_rnd() % 37) == 0)
+    return DDate();
+
+  return DDate(2000 + wh_rnd() % 20, 1 + wh_rnd() % 12, 1 + wh_rnd() % 28);
+}
+
+
+static DUInt32
+generate_customer()
+{
+  if ((wh_rnd() % 41) == 0)
+    return DUInt32();
+
+  return DUInt32(wh_rnd() % _customersCount);
+}
+
+
+static bool
+in_range(const RowValues& row,
+         const DUInt32& customer,
+         const DDate& minDay,
+         const DDate& maxDay)
+{
+  if ( ! (row.customer == customer))
+    return false;
+
+  if (minDay.IsNull() && maxDay.IsNull())
+    return true;
+
+  if (row.day.IsNull())
+    return false;
+
+  return ! (row.day < minDay) && ! (maxDay < row.day);
+}
+
+
+static bool
+check_match(ITable& table,
+            const std::vector<RowValues>& values,
+            const DUInt32& customer,
+            const DDate& minDay,
+            const DDate& maxDay)
+{
+  DBSCompositeKey minKey, maxKey;
+
+  minKey.Add(customer);
+  maxKey.Add(customer);
+  if ( ! (minDay.IsNull() && maxDay.IsNull()))
+    {
+      minKey.Add(minDay);
+      maxKey.Add(maxDay);
+    }
+
+  DArray matched = table.MatchCompositeRows(minKey,
+                                            maxKey,
+                                            0,
+                                            ~0,
+                                            _indexedFields,
+                                            2);
+
+  std::vector<ROW_INDEX> result, expected;
+  for (uint64_t i = 0; i < matched.Count(); ++i)
+    {
+      DROW_INDEX row;
+      matched.Get(i, row);
+      result.push_back(row.mValue);
+    }
+
+  for (ROW_INDEX row = 0; row < values.size(); ++row)
+    {
+      if (in_range(values[row], customer, minDay, maxDay))
+        expected.push_back(row);
+    }
+
+  std::sort(result.begin(), result.end());
+
+  return result == expected;
+}
+
+
+static bool
+check_matches(ITable& table, const std::vector<RowValues>& values)
+{
+  bool result = true;
+
+  for (uint_t c = 0; (c < _customersCount) && result; ++c)
+    {
+      result &= check_match(table, values, DUInt32(c), DDate(), DDate());
+      result &= check_match(table,
+                            values,
+                            DUInt32(c),
+                            DDate(2005, 1, 1),
+                            DDate(2010, 6, 15));
+    }
+
+  return result;
+}
+
+
+static bool
+fill_table_with_values(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Filling table with " << _rowsCount << " rows ... ";
+
+  wh_rnd_set_seed(1);
+  for (uint_t row = 0; row < _rowsCount; ++row)
+    {
+      RowValues rowValues;
+
+      rowValues.customer = generate_customer();
+      rowValues.day      = generate_date();
+
+      if (table.AddRow() != row)
+        return false;
+
+      table.Set(row, _customerField, rowValues.customer);
+      table.Set(row, _dayField, rowValues.day);
+      table.Set(row, _amountField, DInt16(row % 1000));
+
+      values.push_back(rowValues);
+    }
+
+  const bool result = check_matches(table, values);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_index_creation(ITable& table, const std::vector<RowValues>& values)
+{
+  std::cout << "Creating composite index ... ";
+
+  bool result = ! table.IsCompositeIndexed(_indexedFields, 2);
+
+  table.CreateCompositeIndex(_indexedFields, 2, nullptr, nullptr);
+
+  result = result && table.IsCompositeIndexed(_indexedFields, 2);
+  result = result && ! table.IsIndexed(_customerField);
+  result = result && check_matches(table, values);
+
+  try
+    {
+      table.CreateCompositeIndex(_indexedFields, 2, nullptr, nullptr);
+      result = false;
+    }
+  catch (DBSException& e)
+    {
+      if (e.Code() != DBSException::FIELD_INDEXED)
+        result = false;
+    }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_index_update(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Updating indexed rows ... ";
+
+  wh_rnd_set_seed(2);
+  for (uint_t i = 0; i < _rowsCount / 4; ++i)
+    {
+      const ROW_INDEX row = wh_rnd() % _rowsCount;
+
+      if (i % 2)
+        {
+          values[row].customer = generate_customer();
+          table.Set(row, _customerField, values[row].customer);
+        }
+      else
+        {
+          values[row].day = generate_date();
+          table.Set(row, _dayField, values[row].day);
+        }
+
+      //Not part of the index, it should not disturb it.
+      table.Set(row, _amountField, DInt16());
+    }
+
+  for (uint_t i = 0; i < 100; ++i)
+    {
+      RowValues rowValues;
+
+      rowValues.customer = generate_customer();
+      rowValues.day      = generate_date();
+
+      const ROW_INDEX row = table.AddRow();
+
+      if (row != values.size())
+        return false;
+
+      table.Set(row, _customerField, rowValues.customer);
+      table.Set(row, _dayField, rowValues.day);
+
+      values.push_back(rowValues);
+    }
+
+  const bool result = check_matches(table, values);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_index_survival(IDBSHandler& dbsHnd, const std::vector<RowValues>& values)
+{
+  std::cout << "Checking composite index after reopening ... ";
+
+  ITable& table = dbsHnd.RetrievePersistentTable(tb_name);
+
+  bool result = table.IsCompositeIndexed(_indexedFields, 2);
+  result = result && check_matches(table, values);
+
+  dbsHnd.ReleaseTable(table);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_index_removal(IDBSHandler& dbsHnd, const std::vector<RowValues>& values)
+{
+  std::cout << "Removing composite index ... ";
+
+  ITable& table = dbsHnd.RetrievePersistentTable(tb_name);
+
+  table.RemoveCompositeIndex(_indexedFields, 2);
+
+  bool result = ! table.IsCompositeIndexed(_indexedFields, 2);
+  result = result && check_matches(table, values);
+
+  dbsHnd.ReleaseTable(table);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  if (argc > 1)
+    {
+      _rowsCount = atol(argv[1]);
+    }
+
+  bool success = true;
+  {
+    DBSInit(DBSSettings());
+    DBSCreateDatabase(db_name);
+  }
+
+  IDBSHandler& handler = DBSRetrieveDatabase(db_name);
+  handler.AddTable(tb_name, sizeof field_desc / sizeof(field_desc[0]), field_desc);
+
+  {
+    std::vector<RowValues> values;
+    {
+      ITable& table = handler.RetrievePersistentTable(tb_name);
+
+      _customerField = table.RetrieveField("customer");
+      _dayField      = table.RetrieveField("day");
+      _amountField   = table.RetrieveField("amount");
+
+      _indexedFields[0] = _customerField;
+      _indexedFields[1] = _dayField;
+
+      success = success && fill_table_with_values(table, values);
+      success = success && test_index_creation(table, values);
+      success = success && test_index_update(table, values);
+
+      handler.ReleaseTable(table);
+    }
+
+    success = success && test_index_survival(handler, values);
+    success = success && test_index_removal(handler, values);
+  }
+
+  DBSReleaseDatabase(handler);
+  DBSRemoveDatabase(db_name);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
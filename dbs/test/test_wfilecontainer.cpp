@@ -8,12 +8,15 @@
 #include <assert.h>
 #include <memory.h>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "dbs/dbs_mgr.h"
 #include "utils/wrandom.h"
 
 #include "custom/include/test/test_fmw.h"
 #include "../pastra/ps_container.h"
+#include "../pastra/ps_blockcache.h"
 
 using namespace whais;
 using namespace pastra;
@@ -59,9 +62,14 @@ check_container(uint_t max_file_size,
   if (container.Size() != container_size)
     return false;
 
+  //Read ahead hints may span units and go past the end.
+  container.Prefetch(0, max_file_size + 1);
+  container.Prefetch(container_size - 1, 2 * sizeof buffer);
+
   while (left_to_read > 0)
     {
       uint_t read_size = MIN(sizeof(buffer), left_to_read);
+      container.Prefetch(current_pos + read_size, sizeof buffer);
       container.Read(current_pos, read_size, buffer);
 
       for (uint_t index = 0; index < read_size; ++index)
@@ -155,6 +163,118 @@ check_temp_container(uint_t uTestContainerSize)
 }
 
 
+//Serves items holding their own index and keeps the read ahead hints the
+//blocks' cache issues.
+class ReadAheadRecorder : public IBlocksManager
+{
+public:
+  virtual void StoreItems(uint64_t, uint_t, const uint8_t* const) override
+  {
+    assert(false);
+  }
+
+  virtual void RetrieveItems(uint64_t firstItem, uint_t itemsCount, uint8_t* const to) override
+  {
+    for (uint_t i = 0; i < itemsCount; ++i)
+    {
+      const uint64_t value = firstItem + i;
+      memcpy(to + i * sizeof value, &value, sizeof value);
+    }
+
+    ++mLoads;
+  }
+
+  virtual void PrefetchItems(uint64_t firstItem, uint_t itemsCount) override
+  {
+    mHints.push_back(std::make_pair(firstItem, itemsCount));
+  }
+
+  uint_t                                     mLoads = 0;
+  std::vector<std::pair<uint64_t, uint_t>>   mHints;
+};
+
+
+static bool
+read_block(BlockCache& cache, const uint64_t block, const uint_t itemInBlock)
+{
+  const uint64_t item = block * cache.ItemsPerBlock() + itemInBlock;
+
+  uint64_t value;
+  memcpy(&value, cache.RetriveItem(item).GetDataForRead(), sizeof value);
+
+  return value == item;
+}
+
+
+static bool
+check_read_ahead()
+{
+  std::cout << "Testing the blocks read ahead ... ";
+
+  const uint_t readAhead = BlockCache::READ_AHEAD_BLOCKS;
+  const uint_t blocksCount = 4 * readAhead;
+
+  ReadAheadRecorder recorder;
+  BlockCache cache;
+
+  cache.Init(recorder, sizeof(uint64_t), 16 * sizeof(uint64_t), 4, true);
+
+  const uint_t itemsPerBlock = cache.ItemsPerBlock();
+  bool result = (itemsPerBlock == 16);
+
+  //A single load gives no direction to read ahead into.
+  result = result && read_block(cache, 0, 3) && recorder.mHints.empty();
+
+  //Once the blocks are loaded in sequence, the next ones are hinted, each
+  //of them only once.
+  for (uint64_t block = 1; result && (block < blocksCount); ++block)
+  {
+    result = read_block(cache, block, block % itemsPerBlock)
+             && read_block(cache, block, 0)
+             && (recorder.mHints.size() == block);
+  }
+
+  result = result
+           && (recorder.mLoads == blocksCount)
+           && (recorder.mHints[0].first == 2 * itemsPerBlock)
+           && (recorder.mHints[0].second == readAhead * itemsPerBlock);
+
+  for (uint_t i = 1; result && (i < recorder.mHints.size()); ++i)
+  {
+    result = (recorder.mHints[i].first == (i + readAhead + 1) * itemsPerBlock)
+             && (recorder.mHints[i].second == itemsPerBlock);
+  }
+
+  //Blocks loaded out of order are not followed by any hint.
+  const uint64_t randomBlocks[] = { 100, 37, 250, 64, 63, 181, 2, 90, 150, 5 };
+
+  recorder.mHints.clear();
+  recorder.mLoads = 0;
+  for (auto block : randomBlocks)
+    result = result && read_block(cache, block, block % itemsPerBlock);
+
+  result = result
+           && (recorder.mLoads == sizeof randomBlocks / sizeof randomBlocks[0])
+           && recorder.mHints.empty();
+
+  //Cached blocks (the lowest ones are dropped first) are not loaded again,
+  //so they do not count as a sequence.
+  result = result
+           && read_block(cache, 5, 0) && read_block(cache, 250, 1)
+           && (recorder.mLoads == sizeof randomBlocks / sizeof randomBlocks[0])
+           && recorder.mHints.empty();
+
+  //A new sequence starts the read ahead again, from its own position.
+  result = result
+           && read_block(cache, 6, 0)
+           && (recorder.mHints.size() == 1)
+           && (recorder.mHints[0].first == 7 * itemsPerBlock)
+           && (recorder.mHints[0].second == readAhead * itemsPerBlock);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
 
 int
 main()
@@ -199,6 +319,9 @@ main()
   if (!check_temp_container(23400))
     success = false;
 
+  if (!check_read_ahead())
+    success = false;
+
   DBSShoutdown();
 
   if (!success)
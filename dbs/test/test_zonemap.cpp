@@ -0,0 +1,345 @@
+/*
+ * test_zonemap.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+#include "utils/wrandom.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "dbs/dbs_mgr.h"
+#include "dbs/dbs_exception.h"
+
+#include "../pastra/ps_table.h"
+
+using namespace whais;
+using namespace pastra;
+
+struct DBSFieldDescriptor field_desc[] = {
+    {"stamp", T_UINT64, false},
+    {"amount", T_INT32, false}
+};
+
+const char db_name[] = "t_baza_date_1";
+const char tb_name[] = "t_test_tab";
+
+static uint_t _rowsCount = 10000;
+
+//The table does not keep the fields in the order they were declared.
+static FIELD_INDEX _stampField;
+static FIELD_INDEX _amountField;
+
+
+struct RowValues
+{
+  DUInt64 stamp;
+  DInt32  amount;
+};
+
+
+static DInt32
+generate_amount()
+{
+  if ((wh_rnd() % 17) == 0)
+    return DInt32();
+
+  return DInt32(_SC(int32_t, wh_rnd() % 2000) - 1000);
+}
+
+
+template<typename T> static bool
+check_match(ITable& table,
+            const std::vector<RowValues>& values,
+            T RowValues::*member,
+            const FIELD_INDEX field,
+            const T& min,
+            const T& max,
+            const ROW_INDEX fromRow,
+            const ROW_INDEX toRow)
+{
+  const DArray matched = table.MatchRows(min, max, fromRow, toRow, field);
+
+  uint64_t found = 0;
+  for (ROW_INDEX row = fromRow; (row <= toRow) && (row < values.size()); ++row)
+  {
+    const T& value = values[row].*member;
+
+    if ((value < min) || (max < value))
+      continue;
+
+    if (found >= matched.Count())
+      return false;
+
+    DROW_INDEX matchedRow;
+    matched.Get(found++, matchedRow);
+
+    if (matchedRow.mValue != row)
+      return false;
+  }
+
+  return found == matched.Count();
+}
+
+
+static bool
+check_matches(ITable& table, const std::vector<RowValues>& values)
+{
+  const ROW_INDEX lastRow = values.size() - 1;
+  bool result = true;
+
+  result &= check_match(table, values, &RowValues::stamp, _stampField,
+                        DUInt64(100000), DUInt64(100500), 0, ~0);
+  result &= check_match(table, values, &RowValues::stamp, _stampField,
+                        DUInt64(), DUInt64(), 0, ~0);
+  result &= check_match(table, values, &RowValues::stamp, _stampField,
+                        DUInt64(), DUInt64(2000), 10, lastRow - 10);
+  result &= check_match(table, values, &RowValues::amount, _amountField,
+                        DInt32(-10), DInt32(10), 0, ~0);
+  result &= check_match(table, values, &RowValues::amount, _amountField,
+                        DInt32(), DInt32(-990), 1500, 30000);
+  result &= check_match(table, values, &RowValues::amount, _amountField,
+                        DInt32(2000), DInt32(3000), 0, ~0);
+
+  return result;
+}
+
+
+template<typename T> static bool
+check_zones(ITable& table,
+            const std::vector<RowValues>& values,
+            T RowValues::*member,
+            const FIELD_INDEX field)
+{
+  ROW_INDEX row = 0;
+  while (row < values.size())
+  {
+    T zoneMin, zoneMax;
+    const DBSZone zone = table.RetrieveZone(row, field, zoneMin, zoneMax);
+
+    if ((zone.mFirstRow > row) || (zone.mLastRow < row))
+      return false;
+
+    ROW_INDEX nullsCount = 0;
+    for (row = zone.mFirstRow; row <= zone.mLastRow; ++row)
+    {
+      const T& value = values[row].*member;
+
+      if (value.IsNull())
+        ++nullsCount;
+
+      else if ((value < zoneMin) || (zoneMax < value))
+        return false;
+    }
+
+    if (nullsCount != zone.mNullsCount)
+      return false;
+  }
+
+  return true;
+}
+
+
+static bool
+fill_table_with_values(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Filling table with " << _rowsCount << " rows ... ";
+
+  wh_rnd_set_seed(1);
+  for (uint_t row = 0; row < _rowsCount; ++row)
+  {
+    RowValues rowValues;
+
+    //Append mostly in order, like a table of events.
+    rowValues.stamp  = (row % 1000 == 7) ? DUInt64() : DUInt64(1000 + row * 5 + wh_rnd() % 3);
+    rowValues.amount = generate_amount();
+
+    if (table.AddRow() != row)
+      return false;
+
+    table.Set(row, _stampField, rowValues.stamp);
+    table.Set(row, _amountField, rowValues.amount);
+
+    values.push_back(rowValues);
+  }
+
+  bool result = check_matches(table, values);
+  result = result && check_zones(table, values, &RowValues::stamp, _stampField);
+  result = result && check_zones(table, values, &RowValues::amount, _amountField);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_zones_update(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Updating rows of summarised zones ... ";
+
+  wh_rnd_set_seed(2);
+  for (uint_t i = 0; i < _rowsCount / 10; ++i)
+  {
+    const ROW_INDEX row = wh_rnd() % values.size();
+
+    values[row].amount = (i % 3 == 0) ? DInt32(_SC(int32_t, wh_rnd() % 5000)) : generate_amount();
+    table.Set(row, _amountField, values[row].amount);
+
+    if (i % 7 == 0)
+    {
+      values[row].stamp = DUInt64(wh_rnd() % 300000);
+      table.Set(row, _stampField, values[row].stamp);
+    }
+  }
+
+  for (uint_t i = 0; i < 1500; ++i)
+  {
+    const ROW_INDEX row = table.AddRow();
+    if (row != values.size())
+      return false;
+
+    RowValues rowValues;
+    if (i % 2)
+    {
+      rowValues.amount = generate_amount();
+      table.Set(row, _amountField, rowValues.amount);
+    }
+    values.push_back(rowValues);
+  }
+
+  bool result = check_matches(table, values);
+  result = result && check_match(table, values, &RowValues::amount, _amountField,
+                                 DInt32(2000), DInt32(3000), 0, ~0);
+  result = result && check_zones(table, values, &RowValues::stamp, _stampField);
+  result = result && check_zones(table, values, &RowValues::amount, _amountField);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+template<typename T> static bool
+is_sorted(ITable& table, const FIELD_INDEX field, const bool reverse)
+{
+  const ROW_INDEX rowsCount = table.AllocatedRows();
+
+  T previous;
+  table.Get(0, field, previous);
+  for (ROW_INDEX row = 1; row < rowsCount; ++row)
+  {
+    T value;
+    table.Get(row, field, value);
+
+    if (reverse ? (previous < value) : (value < previous))
+      return false;
+
+    previous = value;
+  }
+
+  return true;
+}
+
+
+static bool
+test_sort(ITable& table, std::vector<RowValues>& values)
+{
+  std::cout << "Sorting the table ... ";
+
+  const ROW_INDEX lastRow = values.size() - 1;
+
+  table.Sort(_stampField, 0, lastRow, false);
+  bool result = is_sorted<DUInt64>(table, _stampField, false);
+
+  //Sorting again has to leave the rows in place.
+  std::vector<DInt32> amounts;
+  for (ROW_INDEX row = 0; row <= lastRow; ++row)
+  {
+    DInt32 amount;
+    table.Get(row, _amountField, amount);
+    amounts.push_back(amount);
+  }
+
+  table.Sort(_stampField, 0, lastRow, false);
+  for (ROW_INDEX row = 0; (row <= lastRow) && result; ++row)
+  {
+    DInt32 amount;
+    table.Get(row, _amountField, amount);
+    result = (amount == amounts[row]);
+  }
+  result = result && is_sorted<DUInt64>(table, _stampField, false);
+
+  table.Sort(_amountField, 0, lastRow, true);
+  result = result && is_sorted<DInt32>(table, _amountField, true);
+
+  table.Sort(_amountField, 0, lastRow, false);
+  result = result && is_sorted<DInt32>(table, _amountField, false);
+
+  for (ROW_INDEX row = 0; row <= lastRow; ++row)
+  {
+    table.Get(row, _stampField, values[row].stamp);
+    table.Get(row, _amountField, values[row].amount);
+  }
+
+  result = result && check_matches(table, values);
+  result = result && check_zones(table, values, &RowValues::amount, _amountField);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    _rowsCount = atol(argv[1]);
+  }
+
+  bool success = true;
+  {
+    DBSInit(DBSSettings());
+    DBSCreateDatabase(db_name);
+  }
+
+  IDBSHandler& handler = DBSRetrieveDatabase(db_name);
+  handler.AddTable(tb_name, sizeof field_desc / sizeof(field_desc[0]), field_desc);
+
+  {
+    std::vector<RowValues> values;
+    ITable& table = handler.RetrievePersistentTable(tb_name);
+
+    _stampField  = table.RetrieveField("stamp");
+    _amountField = table.RetrieveField("amount");
+
+    success = success && fill_table_with_values(table, values);
+    success = success && test_zones_update(table, values);
+    success = success && test_sort(table, values);
+
+    handler.ReleaseTable(table);
+  }
+
+  DBSReleaseDatabase(handler);
+  DBSRemoveDatabase(db_name);
+  DBSShoutdown();
+
+  if (!success)
+  {
+    std::cout << "TEST RESULT: FAIL" << std::endl;
+    return 1;
+  }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
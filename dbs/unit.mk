@@ -11,7 +11,8 @@ wpastra_INC:=
 wpastra_SRC:=pastra/ps_values.cpp pastra/ps_container.cpp pastra/ps_table.cpp\
 		   	pastra/ps_dbsmgr.cpp pastra/ps_serializer.cpp pastra/ps_varstorage.cpp\
 		   	pastra/ps_blockcache.cpp pastra/ps_textstrategy.cpp pastra/ps_arraystrategy.cpp\
-		   	pastra/ps_btree_index.cpp pastra/ps_btree_fields.cpp pastra/ps_templatetable.cpp\
+		   	pastra/ps_btree_index.cpp pastra/ps_btree_fields.cpp pastra/ps_btree_composite.cpp pastra/ps_bitmap_index.cpp\
+		   	pastra/ps_templatetable.cpp\
 		   	pastra/ps_exception.cpp pastra/ps_valtranslator.cpp
 
 wpastra_cmn_DEF:=WVER_MAJ=1 WVER_MIN=0
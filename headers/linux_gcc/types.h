@@ -35,6 +35,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 typedef int             WH_FILE;
 typedef pthread_mutex_t WH_LOCK;
+typedef pthread_cond_t  WH_COND;
 typedef pthread_t       WH_THREAD;
 typedef int             WH_SOCKET;
 typedef void*           WH_SHLIB;
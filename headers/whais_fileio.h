@@ -62,9 +62,20 @@ whf_tell(WH_FILE hnd, uint64_t* const outPosition);
 CUSTOM_SHL bool_t 
 whf_sync(WH_FILE hnd);
 
+CUSTOM_SHL bool_t 
+whf_prefetch(WH_FILE hnd, uint64_t offset, uint64_t size);
+
 CUSTOM_SHL bool_t 
 whf_tell_size(WH_FILE hnd, uint64_t* const outSize);
 
+/* Map the first 'size' bytes of the file for reading. The mapping stays
+ * valid after the file is closed, until it is unmapped. */
+CUSTOM_SHL const uint8_t* 
+whf_map(WH_FILE hnd, uint64_t size);
+
+CUSTOM_SHL bool_t 
+whf_unmap(const uint8_t* const mapping, uint64_t size);
+
 CUSTOM_SHL bool_t 
 whf_set_size(WH_FILE, const uint64_t newSize);
 
@@ -58,6 +58,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <map>
 #include <memory>
 #include <new>
+#include <type_traits>
+#include <utility>
 
 extern "C"
 {
@@ -147,6 +149,12 @@ _placement_new(void* place)
   new(place) T;
 }
 
+template <class T> static inline void
+_placement_move(void* place, T&& value)
+{
+  new(place) typename std::decay<T>::type(std::forward<T>(value));
+}
+
 
 #ifdef ENABLE_MEMORY_TRACE
 
@@ -48,6 +48,27 @@ wh_lock_try_acquire(WH_LOCK* const lock,
 CUSTOM_SHL uint_t 
 wh_lock_release(WH_LOCK* const lock);
 
+CUSTOM_SHL uint_t 
+wh_cond_init(WH_COND* const cond);
+
+CUSTOM_SHL uint_t 
+wh_cond_destroy(WH_COND* const cond);
+
+CUSTOM_SHL uint_t 
+wh_cond_wait(WH_COND* const cond, WH_LOCK* const lock);
+
+CUSTOM_SHL uint_t 
+wh_cond_timed_wait(WH_COND* const cond,
+                    WH_LOCK* const lock,
+                    const uint_t   millisecs,
+                    bool_t* const  outTimeout);
+
+CUSTOM_SHL uint_t 
+wh_cond_signal(WH_COND* const cond);
+
+CUSTOM_SHL uint_t 
+wh_cond_broadcast(WH_COND* const cond);
+
 CUSTOM_SHL uint_t 
 wh_thread_create(WH_THREAD*                    outThread,
                   const WH_THREAD_ROUTINE       routine,
@@ -72,6 +72,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 typedef HANDLE              WH_FILE;
 typedef CRITICAL_SECTION    WH_LOCK;
+typedef CONDITION_VARIABLE  WH_COND;
 typedef HANDLE              WH_THREAD;
 typedef SOCKET              WH_SOCKET;
 typedef HMODULE             WH_SHLIB;
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define INTERPRETER_H_
 
 #include <string>
+#include <memory>
 
 #include "whais.h"
 
@@ -91,6 +92,7 @@ public:
 
     STACK_TOO_BIG,
     SERVER_STOPPED,
+    SYNC_WAIT_TIMEOUT,
 
     //The exception codes below this line cause an application stop.
     __CRITICAL_EXCEPTIONS,
@@ -99,12 +101,58 @@ public:
     INVALID_UNIT_GLB_INDEX,
     INVALID_UNIT_PROC_INDEX,
     INVALID_UNIT_DATA_OFF,
+    INVALID_UNIT_CODE,
     INTERNAL_ERROR
   };
 };
 
 
 
+//How much a procedure's synchronised statement has been contended for.
+//The times are measured in milliseconds.
+struct SyncStatementStats
+{
+  uint64_t  mAquires;
+  uint64_t  mContentions;   //Times a caller had to wait to enter it.
+  uint64_t  mTimeouts;      //Waits given up as they took too long.
+  uint64_t  mWaitTime;
+  uint64_t  mMaxWaitTime;
+  uint32_t  mWaiting;       //Callers waiting right now to enter it.
+  bool      mHeld;
+};
+
+
+
+//How a procedure has run since the procedures' profiling was enabled.
+//The times are measured in microseconds.
+struct ProcedureProfileStats
+{
+  uint64_t  mCalls;
+  uint64_t  mInstructions;    //Executed from the procedure's own code.
+  uint64_t  mInclusiveTime;   //Including the procedures it has called.
+  uint64_t  mExclusiveTime;   //Spent only in its own code.
+};
+
+
+
+//A procedure execution that may be suspended before it ends, to be resumed
+//later, eventually from a different thread.
+class INTERP_SHL IResumableCall
+{
+public:
+  virtual ~IResumableCall() = default;
+
+  //Run the procedure until it ends (returns true) or it is suspended again.
+  virtual bool Resume() = 0;
+  virtual uint_t SuspendReason() const = 0;
+
+  static const uint_t NOT_SUSPENDED           = 0;
+  static const uint_t TIME_SLICE_ENDED        = 1;
+  static const uint_t SYNC_WAIT               = 2;
+};
+
+
+
 class INTERP_SHL ISession
 {
 public:
@@ -116,6 +164,11 @@ public:
 
   virtual void ExecuteProcedure(const char* const name, SessionStack& stack) = 0;
 
+  //The stack has to be kept alive until the returned call ends or
+  //it is released.
+  virtual std::unique_ptr<IResumableCall> StartProcedure(const char* const name,
+                                                         SessionStack& stack) = 0;
+
   virtual uint_t GlobalValuesCount() const = 0;
   virtual uint_t ProceduresCount() const = 0;
 
@@ -132,6 +185,25 @@ public:
   virtual uint_t GlobalValueFieldType(const uint32_t index, const uint32_t field) = 0;
   virtual uint_t GlobalValueFieldType(const char* const name, const uint32_t field) = 0;
 
+  virtual uint_t ProcedureSyncStatementsCount(const uint_t id) const = 0;
+  virtual uint_t ProcedureSyncStatementsCount(const char* const name) const = 0;
+
+  virtual void ProcedureSyncStatementStats(const uint_t id,
+                                           const uint_t sync,
+                                           SyncStatementStats& outStats) = 0;
+  virtual void ProcedureSyncStatementStats(const char* const name,
+                                           const uint_t sync,
+                                           SyncStatementStats& outStats) = 0;
+
+  //The code counts are indexed by the instructions' positions in the
+  //procedure's code and tell how many times each one was executed.
+  virtual void ProcedureProfile(const uint_t id,
+                                ProcedureProfileStats& outStats,
+                                std::vector<uint64_t>* const outCodeCounts = nullptr) = 0;
+  virtual void ProcedureProfile(const char* const name,
+                                ProcedureProfileStats& outStats,
+                                std::vector<uint64_t>* const outCodeCounts = nullptr) = 0;
+
   virtual uint_t ProcedureParametersCount(const uint_t id) const = 0;
   virtual uint_t ProcedureParametersCount(const char* const name) const = 0;
 
@@ -162,6 +234,8 @@ public:
   static const uint_t MAX_PROCS_TMO           = 2;
   static const uint_t MAX_STACK_COUNT         = 3;
   static const uint_t MAX_PROCS_CALL_DEPTH    = 4;
+  static const uint_t PROCS_TIME_SLICE        = 5;
+  static const uint_t SYNC_WAIT_TMO           = 6;
 
 protected:
 
@@ -189,6 +263,33 @@ CleanInterpreter(const bool force = false);
 INTERP_SHL const char*
 DescribeInterpreterEngineVersion();
 
+
+//Count the opcodes sequences the procedures execute, to find out offline
+//which ones are worth to be fused by the decoder. The procedures run slower
+//while this is enabled.
+INTERP_SHL void
+EnableOpcodeProfile(const bool enable);
+
+
+INTERP_SHL bool
+DumpOpcodeProfile(const char* const fileName);
+
+
+//Count the procedures' calls, the instructions they execute and the time
+//spent in them. It's meant to find the hot procedures of a running server,
+//the procedures being only slightly slower while this is enabled.
+INTERP_SHL void
+EnableProcedureProfile(const bool enable);
+
+
+INTERP_SHL bool
+IsProcedureProfileEnabled();
+
+
+//Start the procedures' profiles anew.
+INTERP_SHL void
+ResetProcedureProfile();
+
 } // namespace whais
 
 #endif /* INTERPRETER_H_ */
@@ -150,13 +150,17 @@ class INTERP_SHL StackValue
 public:
   StackValue();
 
-  template <class OP_T>
-  explicit StackValue(const OP_T& op)
+  //The temporary operands are moved in, so their values are not copied.
+  template <class OP_T,
+            class = typename std::enable_if<
+                        std::is_base_of<IOperand, typename std::decay<OP_T>::type>::value
+                      >::type>
+  explicit StackValue(OP_T&& op)
   {
-    static_assert(sizeof(OP_T) <= sizeof(mStorage), "Stack value storage not big enough!");
-    static_assert(std::is_base_of<IOperand, OP_T>::value);
+    static_assert(sizeof(typename std::decay<OP_T>::type) <= sizeof(mStorage),
+                  "Stack value storage not big enough!");
 
-    _placement_new(mStorage, op);
+    _placement_move(mStorage, std::forward<OP_T>(op));
 
     assert (mStorage[0] != 0);
   }
@@ -169,7 +173,7 @@ public:
       memcpy(mStorage, &source.mStorage, sizeof mStorage);
   }
 
-  StackValue(StackValue&& source)
+  StackValue(StackValue&& source) noexcept
   {
     memcpy(mStorage, &source.mStorage, sizeof mStorage);
     source.mStorage[0] = 0;
@@ -181,7 +185,7 @@ public:
   }
 
   StackValue&
-  operator= (StackValue&& source)
+  operator= (StackValue&& source) noexcept
   {
     Clear();
 
@@ -260,16 +264,36 @@ public:
   void  Push(INativeObject& object);
   void  Push(StackValue&& value);
 
+  /* Push copies of values that don't need a custom copy (e.g. basic types),
+     by copying their raw memory all at once. */
+  void  PushPlain(const StackValue* const values, const uint_t count);
+
   void  Pop(const uint_t count);
 
+  /* Make room for at least 'count' values, so pushing them later
+     will not move the stack's content around. */
+  void  Reserve(const size_t count);
+
   size_t Size() const;
+  size_t Capacity() const;
+
+  /* How many times the stack had to grow its storage. */
+  uint_t ReallocationsCount() const;
+
   StackValue& operator[] (const uint_t index);
 
+  /* The same as 'operator[]' and 'Pop()' but with no checks, for the
+     interpreter's use only. The code it runs was verified at load to
+     never reach outside of the stack. */
+  StackValue& At(const uint_t index) { return mStack[index]; }
+  void Drop(uint_t count) { while (count-- > 0) mStack.pop_back(); }
+
 private:
 
 #pragma warning(disable: 4251)
   std::vector<StackValue> mStack;
 #pragma warning(default: 4251)
+  uint_t                  mReallocationsCount;
 
 };
 
@@ -148,6 +148,9 @@ InterException::Description() const
   case SERVER_STOPPED:
     return "Server was asked to stop.";
 
+  case SYNC_WAIT_TIMEOUT:
+    return "Waited too long to acquire a procedure synchronized statement.";
+
   case ALREADY_INITED:
     return "Cannot initialize the interpreter as it was already initialized.";
 
@@ -163,6 +166,9 @@ InterException::Description() const
   case INVALID_UNIT_DATA_OFF:
     return "Cannot find a unit constant data.";
 
+  case INVALID_UNIT_CODE:
+    return "A unit procedure's code failed to be verified.";
+
   case INTERNAL_ERROR:
     return "GENERAL FAILURE: Program execution must stop due to a interpreter internal error.";
     }
@@ -97,6 +97,20 @@ GenericTable::MarkRowForReuse(const ROW_INDEX)
 }
 
 
+ROW_INDEX
+GenericTable::MarkRowsForReuse(const DArray&)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+ROW_INDEX
+GenericTable::MarkRowsForReuse(const ROW_INDEX, const ROW_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
 void
 GenericTable::CreateIndex(const FIELD_INDEX,
                            CREATE_INDEX_CALLBACK_FUNC* const,
@@ -120,6 +134,51 @@ GenericTable::IsIndexed(const FIELD_INDEX) const
 }
 
 
+void
+GenericTable::CreateCompositeIndex(const FIELD_INDEX* const,
+                                   const uint_t,
+                                   CREATE_INDEX_CALLBACK_FUNC* const,
+                                   CreateIndexCallbackContext* const)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+void
+GenericTable::RemoveCompositeIndex(const FIELD_INDEX* const, const uint_t)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+bool
+GenericTable::IsCompositeIndexed(const FIELD_INDEX* const, const uint_t) const
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+void
+GenericTable::CreateBitmapIndex(const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+void
+GenericTable::RemoveBitmapIndex(const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+bool
+GenericTable::IsBitmapIndexed(const FIELD_INDEX) const
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
 void
 GenericTable::Set(const ROW_INDEX, const FIELD_INDEX, const DChar&, const bool)
 {
@@ -536,6 +595,222 @@ GenericTable::MatchRows(const DRichReal&,
   throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
 }
 
+
+DArray
+GenericTable::MatchCompositeRows(const DBSCompositeKey&,
+                                 const DBSCompositeKey&,
+                                 const ROW_INDEX,
+                                 const ROW_INDEX,
+                                 const FIELD_INDEX* const,
+                                 const uint_t)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSRowsBitmap
+GenericTable::MatchRowsBitmap(const DBool&,
+                              const DBool&,
+                              const ROW_INDEX,
+                              const ROW_INDEX,
+                              const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSRowsBitmap
+GenericTable::MatchRowsBitmap(const DChar&,
+                              const DChar&,
+                              const ROW_INDEX,
+                              const ROW_INDEX,
+                              const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSRowsBitmap
+GenericTable::MatchRowsBitmap(const DUInt8&,
+                              const DUInt8&,
+                              const ROW_INDEX,
+                              const ROW_INDEX,
+                              const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DBool&,
+                           DBool&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DChar&,
+                           DChar&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DDate&,
+                           DDate&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DDateTime&,
+                           DDateTime&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DHiresTime&,
+                           DHiresTime&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DUInt8&,
+                           DUInt8&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DUInt16&,
+                           DUInt16&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DUInt32&,
+                           DUInt32&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DUInt64&,
+                           DUInt64&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DInt8&,
+                           DInt8&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DInt16&,
+                           DInt16&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DInt32&,
+                           DInt32&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DInt64&,
+                           DInt64&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DReal&,
+                           DReal&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+
+DBSZone
+GenericTable::RetrieveZone(const ROW_INDEX,
+                           const FIELD_INDEX,
+                           DRichReal&,
+                           DRichReal&,
+                           const bool)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
+IFieldAccess&
+GenericTable::AccessField(const FIELD_INDEX)
+{
+  throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+}
+
 void
 GenericTable::Flush()
 {
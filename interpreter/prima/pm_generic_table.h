@@ -48,6 +48,8 @@ public:
   virtual ROW_INDEX GetReusableRow(const bool forceAdd) override;
   virtual ROW_INDEX ReusableRowsCount() override;
   virtual void MarkRowForReuse(const ROW_INDEX row) override;
+  virtual ROW_INDEX MarkRowsForReuse(const DArray& rows) override;
+  virtual ROW_INDEX MarkRowsForReuse(const ROW_INDEX fromRow, const ROW_INDEX toRow) override;
 
   virtual void CreateIndex(const FIELD_INDEX field,
                            CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
@@ -55,6 +57,19 @@ public:
   virtual void RemoveIndex(const FIELD_INDEX field) override;
   virtual bool IsIndexed(const FIELD_INDEX field) const override;
 
+  virtual void CreateCompositeIndex(const FIELD_INDEX* const fields,
+                                    const uint_t fieldsCount,
+                                    CREATE_INDEX_CALLBACK_FUNC* const cbFunc,
+                                    CreateIndexCallbackContext* const cbCotext) override;
+  virtual void RemoveCompositeIndex(const FIELD_INDEX* const fields,
+                                    const uint_t fieldsCount) override;
+  virtual bool IsCompositeIndexed(const FIELD_INDEX* const fields,
+                                  const uint_t fieldsCount) const override;
+
+  virtual void CreateBitmapIndex(const FIELD_INDEX field) override;
+  virtual void RemoveBitmapIndex(const FIELD_INDEX field) override;
+  virtual bool IsBitmapIndexed(const FIELD_INDEX field) const override;
+
   virtual void Set(const ROW_INDEX   row,
                    const FIELD_INDEX field,
                    const DBool&      value,
@@ -323,6 +338,106 @@ public:
                            const ROW_INDEX       fromRow,
                            const ROW_INDEX       toRow,
                            const FIELD_INDEX     field);
+
+  virtual DArray MatchCompositeRows(const DBSCompositeKey&   min,
+                                    const DBSCompositeKey&   max,
+                                    const ROW_INDEX          fromRow,
+                                    const ROW_INDEX          toRow,
+                                    const FIELD_INDEX* const fields,
+                                    const uint_t             fieldsCount) override;
+
+  virtual DBSRowsBitmap MatchRowsBitmap(const DBool&        min,
+                                        const DBool&        max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) override;
+  virtual DBSRowsBitmap MatchRowsBitmap(const DChar&        min,
+                                        const DChar&        max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) override;
+  virtual DBSRowsBitmap MatchRowsBitmap(const DUInt8&       min,
+                                        const DUInt8&       max,
+                                        const ROW_INDEX     fromRow,
+                                        const ROW_INDEX     toRow,
+                                        const FIELD_INDEX   field) override;
+
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DBool&            outMin,
+                               DBool&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DChar&            outMin,
+                               DChar&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DDate&            outMin,
+                               DDate&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DDateTime&        outMin,
+                               DDateTime&        outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DHiresTime&       outMin,
+                               DHiresTime&       outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt8&           outMin,
+                               DUInt8&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt16&          outMin,
+                               DUInt16&          outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt32&          outMin,
+                               DUInt32&          outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DUInt64&          outMin,
+                               DUInt64&          outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt8&            outMin,
+                               DInt8&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt16&           outMin,
+                               DInt16&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt32&           outMin,
+                               DInt32&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DInt64&           outMin,
+                               DInt64&           outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DReal&            outMin,
+                               DReal&            outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual DBSZone RetrieveZone(const ROW_INDEX   row,
+                               const FIELD_INDEX field,
+                               DRichReal&        outMin,
+                               DRichReal&        outMax,
+                               const bool        skipThreadSafety = false) override;
+  virtual IFieldAccess& AccessField(const FIELD_INDEX field) override;
   virtual void Flush() override;
   virtual void LockTable() override;
   virtual void UnlockTable() override;
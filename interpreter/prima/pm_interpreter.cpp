@@ -24,16 +24,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <string.h>
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <map>
 #include <memory.h>
 
 #include "utils/wthread.h"
+#include "utils/endianness.h"
 #include "dbs/dbs_mgr.h"
 #include "stdlib/interface.h"
 
 #include "pm_interpreter.h"
 #include "pm_processor.h"
+#include "pm_opprofile.h"
 
 
 using namespace std;
@@ -164,6 +167,48 @@ DescribeInterpreterEngineVersion()
 }
 
 
+INTERP_SHL void
+EnableOpcodeProfile(const bool enable)
+{
+  prima::OpcodeProfile::Enable(enable);
+}
+
+
+INTERP_SHL bool
+DumpOpcodeProfile(const char* const fileName)
+{
+  ofstream profile(fileName, ios::out | ios::trunc);
+
+  if ( ! profile)
+    return false;
+
+  prima::OpcodeProfile::Dump(profile);
+
+  return profile.good();
+}
+
+
+INTERP_SHL void
+EnableProcedureProfile(const bool enable)
+{
+  prima::ProcedureProfile::Enable(enable);
+}
+
+
+INTERP_SHL bool
+IsProcedureProfileEnabled()
+{
+  return prima::ProcedureProfile::IsEnabled();
+}
+
+
+INTERP_SHL void
+ResetProcedureProfile()
+{
+  prima::ProcedureProfile::Reset();
+}
+
+
 
 
 ISession::ISession(Logger& log)
@@ -191,6 +236,8 @@ Session::Session(Logger&           log,
     mGlobalNames(globalNames),
     mPrivateNames(privateNames),
     mMaxStackCount(~0),
+    mTimeSlice(0),
+    mSyncWaitTmo(0),
     mServerStopped(false)
 {
   DefineTablesGlobalValues();
@@ -221,6 +268,31 @@ Session::LoadCompiledUnit(WIFunctionalUnit& unit)
                                              unit.ConstsAreaSize());
   try
   {
+    //Reject a malformed unit before any of its definitions is added. The
+    //external procedures have to match their definitions, so the arguments
+    //counts declared by the unit are the ones the calls will find. The code
+    //of a unit linked by a previous run was already checked then.
+    vector<uint32_t> procsArgs;
+    for (uint_t procIt = 0; procIt < unit.ProceduresCount(); ++procIt)
+      procsArgs.push_back(unit.ProcParametersCount(procIt));
+
+    for (uint_t procIt = 0;
+         (procIt < unit.ProceduresCount()) && (unit.IsCodeVerified() == FALSE);
+         ++procIt)
+    {
+      if (unit.IsProcExternal(procIt) != FALSE)
+        continue;
+
+      const string name(unit.RetriveProcName(procIt), unit.GetProcNameSize(procIt));
+
+      unitMgr.GetUnit(unitIndex).VerifyCode(unit.RetriveProcCodeArea(procIt),
+                                            unit.ProcCodeAreaSize(procIt),
+                                            unit.ProcLocalsCount(procIt),
+                                            unit.ProcSyncStatementsCount(procIt),
+                                            procsArgs.data(),
+                                            name.c_str());
+    }
+
     TypeManager& typeMgr = mPrivateNames->GetTypeManager();
     for (uint_t glbIt = 0; glbIt < unit.GlobalsCount(); ++glbIt)
     {
@@ -281,6 +353,17 @@ Session::LoadCompiledUnit(WIFunctionalUnit& unit)
 
       unitMgr.SetProcedureIndex(unitIndex, procIt, procIndex);
     }
+
+    //Now that all the unit's globals and procedures are resolved, decode
+    //the code of its procedures ahead of their first execution.
+    for (uint_t procIt = 0; procIt < unit.ProceduresCount(); ++procIt)
+    {
+      if (unit.IsProcExternal(procIt) != FALSE)
+        continue;
+
+      const Procedure& proc = GetProcedure(unitMgr.GetProcedureIndex(unitIndex, procIt));
+      proc.mProcMgr->Instructions(proc, *this);
+    }
   }
   catch (...)
   {
@@ -393,21 +476,63 @@ Session::LoadSharedLib(WH_SHLIB shl)
   return true;
 }
 
+const Procedure&
+Session::ClientProcedure(const char* const procedure)
+{
+  //Procedures are never removed and their names are unique, so once found
+  //a procedure is not looked up again.
+  LockGuard<Lock> holder(mProcsIdsSync);
+
+  auto cached = mProcsIds.find(procedure);
+  if (cached == mProcsIds.end())
+  {
+    const uint32_t procId = FindProcedure(_RC(const uint8_t*, procedure), strlen(procedure));
+
+    if ( !ProcedureManager::IsValid(procId))
+    {
+      throw InterException(_EXTRA(InterException::INVALID_PROC_REQ),
+                           "Cannot find procedure '%s' to execute.",
+                           procedure);
+    }
+
+    cached = mProcsIds.emplace(procedure, procId).first;
+  }
+
+  return GetProcedure(cached->second);
+}
+
+
 void
 Session::ExecuteProcedure(const char* const procedure, SessionStack& stack)
 {
-  const uint32_t procId = FindProcedure(_RC(const uint8_t*, procedure), strlen(procedure));
+  const Procedure& proc = ClientProcedure(procedure);
 
-  if ( !ProcedureManager::IsValid(procId))
+  if (mTimeSlice == 0)
   {
-    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ),
-                         "Cannot find procedure '%s' to execute.",
-                         procedure);
+    ProcedureCall( *this, stack, proc);
+    return;
   }
 
-  const Procedure& proc = GetProcedure(procId);
+  //Let the other threads run between the time slices of a long procedure.
+  //While it waits for a synchronisation statement it sleeps in its queue.
+  ProcedureCall call( *this, stack, proc, mTimeSlice);
+  while ( ! call.Resume())
+  {
+    if (call.SuspendReason() == IResumableCall::SYNC_WAIT)
+      call.WaitSync();
 
-  ProcedureCall( *this, stack, proc);
+    else
+      wh_yield();
+  }
+}
+
+
+unique_ptr<IResumableCall>
+Session::StartProcedure(const char* const procedure, SessionStack& stack)
+{
+  const Procedure& proc = ClientProcedure(procedure);
+
+  return unique_ptr<IResumableCall>(new ProcedureCall( *this, stack, proc, mTimeSlice));
 }
 
 
@@ -537,6 +662,78 @@ Session::GlobalValueFieldType(const char* const name, const uint32_t field)
 }
 
 
+uint_t
+Session::ProcedureSyncStatementsCount(const uint_t id) const
+{
+  ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
+
+  if (id >= procMgr.Count())
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ));
+
+  return procMgr.GetProcedure(id).mSyncCount;
+}
+
+
+void
+Session::ProcedureSyncStatementStats(const uint_t id,
+                                     const uint_t sync,
+                                     SyncStatementStats& outStats)
+{
+  ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
+
+  if (id >= procMgr.Count())
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ));
+
+  procMgr.SyncStatistics(procMgr.GetProcedure(id), sync, outStats);
+}
+
+
+uint_t
+Session::ProcedureSyncStatementsCount(const char* const name) const
+{
+  ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
+  const uint_t procId = procMgr.GetProcedure(_RC(const uint8_t*, name), strlen(name));
+  return ProcedureSyncStatementsCount(procId);
+}
+
+
+void
+Session::ProcedureSyncStatementStats(const char* const name,
+                                     const uint_t sync,
+                                     SyncStatementStats& outStats)
+{
+  ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
+  const uint_t procId = procMgr.GetProcedure(_RC(const uint8_t*, name), strlen(name));
+  ProcedureSyncStatementStats(procId, sync, outStats);
+}
+
+
+void
+Session::ProcedureProfile(const uint_t id,
+                          ProcedureProfileStats& outStats,
+                          vector<uint64_t>* const outCodeCounts)
+{
+  ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
+
+  if (id >= procMgr.Count())
+    throw InterException(_EXTRA(InterException::INVALID_PROC_REQ));
+
+  const Procedure& procedure = procMgr.GetProcedure(id);
+  procMgr.Profile(procedure).Statistics(outStats, outCodeCounts);
+}
+
+
+void
+Session::ProcedureProfile(const char* const name,
+                          ProcedureProfileStats& outStats,
+                          vector<uint64_t>* const outCodeCounts)
+{
+  ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
+  const uint_t procId = procMgr.GetProcedure(_RC(const uint8_t*, name), strlen(name));
+  ProcedureProfile(procId, outStats, outCodeCounts);
+}
+
+
 uint_t
 Session::ProcedureParametersCount(const uint_t id) const
 {
@@ -681,6 +878,43 @@ Session::NotifyEvent(const uint_t event, uint64_t* const extra)
     log.Log(LT_INFO, s.str());
     mMaxStackCount = *extra;
   }
+  else if (event == ISession::PROCS_TIME_SLICE)
+  {
+    if (extra == nullptr)
+    {
+      log.Log(LT_ERROR, "Could not set the procedures' time slice because the value is missing.");
+      return false;
+    }
+
+    std::stringstream s;
+    if (*extra == 0)
+      s << "Procedures are run without time slicing.";
+
+    else
+      s << "Setting the procedures' time slice at " << *extra << " instructions.";
+
+    log.Log(LT_INFO, s.str());
+    mTimeSlice = *extra;
+  }
+  else if (event == ISession::SYNC_WAIT_TMO)
+  {
+    if (extra == nullptr)
+    {
+      log.Log(LT_ERROR, "Could not set the synchronised statements' wait timeout because "
+                        "the value is missing.");
+      return false;
+    }
+
+    std::stringstream s;
+    if (*extra == 0)
+      s << "Procedures wait to enter the synchronised statements with no timeout.";
+
+    else
+      s << "Setting the synchronised statements' wait timeout at " << *extra << " ms.";
+
+    log.Log(LT_INFO, s.str());
+    mSyncWaitTmo = *extra;
+  }
   else
     return false;
 
@@ -901,6 +1135,21 @@ Session::DefineGlobalValue(const uint8_t* const name,
 }
 
 
+//Check if a generic procedure's parameter takes the values of a parameter
+//specialized from it.
+static bool
+is_generic_of(const uint8_t* const genericTypeDesc, const uint8_t* const typeDesc)
+{
+  const uint16_t genericType = load_le_int16(genericTypeDesc);
+  const uint16_t type        = load_le_int16(typeDesc);
+
+  if (genericType == T_UNDETERMINED)
+    return (T_UNKNOWN < type) && (type < T_UNDETERMINED);
+
+  return (genericType == (T_ARRAY_MASK | T_UNDETERMINED)) && IS_ARRAY(type);
+}
+
+
 uint32_t
 Session::DefineProcedure(const uint8_t* const name,
                                   const uint_t nameLength,
@@ -936,10 +1185,22 @@ Session::DefineProcedure(const uint8_t* const name,
   }
 
   ProcedureManager& procMgr = mPrivateNames->GetProcedureManager();
-  const uint32_t procIndex = FindProcedure(name, nameLength);
+  uint32_t procIndex = FindProcedure(name, nameLength);
 
   if (external)
   {
+    //The procedures the compiler specialized for the types of the arguments
+    //passed to generic ones ('name@TYPE...') fall back to more generic ones.
+    uint_t foundLength = nameLength;
+    while ((ProcedureManager::IsValid(procIndex) == false) && (foundLength > 0))
+    {
+      while ((--foundLength > 0) && (name[foundLength] != '@'))
+        ;
+
+      if (foundLength > 0)
+        procIndex = FindProcedure(name, foundLength);
+    }
+
     if (ProcedureManager::IsValid(procIndex) == false)
     {
       string message = "Couldn't not find the definition for external procedure '";
@@ -959,7 +1220,9 @@ Session::DefineProcedure(const uint8_t* const name,
                  FindLocalTI(procIndex, localIt),
                  TypeManager::GetTypeLength(typeDesc)) != 0)
       {
-        argsMatch = false;
+        argsMatch = (foundLength < nameLength)
+                    && (localIt > 0)
+                    && is_generic_of(FindLocalTI(procIndex, localIt), typeDesc);
       }
     }
 
@@ -25,6 +25,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PM_INTERPRETER_H_
 #define PM_INTERPRETER_H_
 
+#include <string>
+#include <map>
+
 #include "interpreter.h"
 
 #include "pm_typemanager.h"
@@ -71,6 +74,9 @@ public:
   virtual void ExecuteProcedure(const char* const   procedure,
                                  SessionStack&       stack);
 
+  virtual std::unique_ptr<IResumableCall> StartProcedure(const char* const procedure,
+                                                         SessionStack& stack) override;
+
   virtual uint_t GlobalValuesCount() const override;
 
   virtual uint_t ProceduresCount() const override;
@@ -91,6 +97,23 @@ public:
   virtual uint_t GlobalValueFieldType(const uint32_t index, const uint32_t field) override;
   virtual uint_t GlobalValueFieldType(const char* const name, const uint32_t field) override;
 
+  virtual uint_t ProcedureSyncStatementsCount(const uint_t id) const override;
+  virtual uint_t ProcedureSyncStatementsCount(const char* const name) const override;
+
+  virtual void ProcedureSyncStatementStats(const uint_t id,
+                                           const uint_t sync,
+                                           SyncStatementStats& outStats) override;
+  virtual void ProcedureSyncStatementStats(const char* const name,
+                                           const uint_t sync,
+                                           SyncStatementStats& outStats) override;
+
+  virtual void ProcedureProfile(const uint_t id,
+                                ProcedureProfileStats& outStats,
+                                std::vector<uint64_t>* const outCodeCounts) override;
+  virtual void ProcedureProfile(const char* const name,
+                                ProcedureProfileStats& outStats,
+                                std::vector<uint64_t>* const outCodeCounts) override;
+
   virtual uint_t ProcedureParametersCount(const uint_t id) const override;
   virtual uint_t ProcedureParametersCount(const char* const name) const override;
 
@@ -132,12 +155,16 @@ public:
 
   bool IsServerShoutdowing() const { return mServerStopped; }
   uint_t MaxStackCount() const { return mMaxStackCount; }
+  uint_t TimeSlice() const { return mTimeSlice; }
+  uint_t SyncWaitTimeout() const { return mSyncWaitTmo; }
 
   void LogMessage(const std::string& msg) {/* TODO: It needs to be implemented */ }
 
 private:
   void DefineTablesGlobalValues();
 
+  const Procedure& ClientProcedure(const char* const procedure);
+
   uint32_t DefineGlobalValue(const uint8_t* const name,
                              const uint_t nameLength,
                              const uint8_t* const typeDesc,
@@ -159,7 +186,11 @@ private:
   NameSpaceHolder            mGlobalNames;
   NameSpaceHolder            mPrivateNames;
   std::vector<WH_SHLIB>      mNativeLibs;
+  std::map<std::string, uint32_t> mProcsIds; //Client invoked procedures.
+  Lock                       mProcsIdsSync;
   volatile uint_t            mMaxStackCount;
+  volatile uint_t            mTimeSlice;
+  volatile uint_t            mSyncWaitTmo;
   volatile bool              mServerStopped;
 };
 
@@ -478,6 +478,20 @@ BaseOperand::RedifineValue(StackValue& source)
 }
 
 
+bool
+BaseOperand::StackReference(uint64_t&) const
+{
+  return false;
+}
+
+
+bool
+BaseOperand::MovableValue() const
+{
+  return false;
+}
+
+
 
 template <typename T>
 static void assign_null(T& output)
@@ -2746,6 +2760,13 @@ TextOperand::CustomCopyIncomplete(void* const dest)
 }
 
 
+bool
+TextOperand::MovableValue() const
+{
+  return true;
+}
+
+
 
 
 bool
@@ -3722,6 +3743,14 @@ LocalOperand::RedifineValue(StackValue& source)
 }
 
 
+bool
+LocalOperand::StackReference(uint64_t& outIndex) const
+{
+  outIndex = mIndex;
+  return true;
+}
+
+
 } //namespace prima
 
 
@@ -3859,7 +3888,8 @@ StackValue::Create(INativeObject& value)
 
 
 SessionStack::SessionStack()
-  : mStack()
+  : mStack(),
+    mReallocationsCount(0)
 {
 }
 
@@ -4005,20 +4035,33 @@ SessionStack::Push(ITable& table)
 void
 SessionStack::Push(INativeObject& object)
 {
-  UndefinedOperand stackOp(object);
-
-  StackValue stackValue(stackOp);
-
   Push(StackValue(UndefinedOperand(object)));
 }
 
 void
 SessionStack::Push(StackValue&& value)
 {
+  if (mStack.size() == mStack.capacity())
+    ++mReallocationsCount;
+
   mStack.push_back(move(value));
 }
 
 
+void
+SessionStack::PushPlain(const StackValue* const values, const uint_t count)
+{
+  const size_t size = mStack.size();
+
+  if (size + count > mStack.capacity())
+    ++mReallocationsCount;
+
+  //The new entries hold undefined values that don't need to be released.
+  mStack.resize(size + count);
+  memcpy(_SC(void*, &mStack[size]), values, count * sizeof(StackValue));
+}
+
+
 
 void
 SessionStack::Pop(const uint_t count)
@@ -4033,6 +4076,14 @@ SessionStack::Pop(const uint_t count)
 }
 
 
+void
+SessionStack::Reserve(const size_t count)
+{
+  if (count > mStack.capacity())
+    mStack.reserve(count);
+}
+
+
 size_t
 SessionStack::Size() const
 {
@@ -4040,6 +4091,20 @@ SessionStack::Size() const
 }
 
 
+size_t
+SessionStack::Capacity() const
+{
+  return mStack.capacity();
+}
+
+
+uint_t
+SessionStack::ReallocationsCount() const
+{
+  return mReallocationsCount;
+}
+
+
 StackValue&
 SessionStack::operator[] (const uint_t index)
 {
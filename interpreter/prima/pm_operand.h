@@ -123,9 +123,28 @@ class LocalOperand;
 class GlobalOperand;
 
 
+//The operands' classes the typed operators read directly, by casting them
+//to the right class. Anything else is accessed through its virtual methods.
+enum OPERAND_KIND
+{
+  OK_GENERIC,
+  OK_LOCAL,
+  OK_INT8,
+  OK_INT16,
+  OK_INT32,
+  OK_INT64,
+  OK_UINT8,
+  OK_UINT16,
+  OK_UINT32,
+  OK_UINT64
+};
+
+
 class BaseOperand : public IOperand
 {
 public:
+  virtual OPERAND_KIND Kind() const { return OK_GENERIC; }
+
   virtual bool IsNull() const override;
   virtual bool IsNullExpression() const override;
 
@@ -205,6 +224,13 @@ public:
   virtual void CopyFieldOp(const FieldOperand& source);
   virtual TableReference& GetTableReference();
   virtual void RedifineValue(StackValue& source);
+
+  //Tell if the operand refers to the value of an other stack entry.
+  virtual bool StackReference(uint64_t& outIndex) const;
+
+  //Tell if the operand keeps by itself a value that is expensive to clone,
+  //so it's better to move it around when its stack entry is discarded.
+  virtual bool MovableValue() const;
 };
 
 
@@ -381,6 +407,10 @@ public:
   {
   }
 
+  const DUInt8& Value() const { return mValue; }
+  void Value(const DUInt8& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_UINT8; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -434,6 +464,10 @@ public:
   {
   }
 
+  const DUInt16& Value() const { return mValue; }
+  void Value(const DUInt16& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_UINT16; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -485,6 +519,10 @@ public:
   {
   }
 
+  const DUInt32& Value() const { return mValue; }
+  void Value(const DUInt32& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_UINT32; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -538,6 +576,10 @@ public:
   {
   }
 
+  const DUInt64& Value() const { return mValue; }
+  void Value(const DUInt64& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_UINT64; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -591,6 +633,10 @@ public:
   {
   }
 
+  const DInt8& Value() const { return mValue; }
+  void Value(const DInt8& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_INT8; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -644,6 +690,10 @@ public:
   {
   }
 
+  const DInt16& Value() const { return mValue; }
+  void Value(const DInt16& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_INT16; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -697,6 +747,10 @@ public:
   {
   }
 
+  const DInt32& Value() const { return mValue; }
+  void Value(const DInt32& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_INT32; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -750,6 +804,10 @@ public:
   {
   }
 
+  const DInt64& Value() const { return mValue; }
+  void Value(const DInt64& value) { mValue = value; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_INT64; }
   virtual bool IsNull() const override;
 
   virtual void GetValue(DInt8& outValue) const override;
@@ -911,6 +969,7 @@ public:
   virtual bool StartIterate(const bool reverse, StackValue& outStartItem) override;
 
   virtual bool CustomCopyIncomplete(void* const dest) override;
+  virtual bool MovableValue() const override;
 
 private:
   std::shared_ptr<DText>* mValue;
@@ -1009,6 +1068,7 @@ public:
 
   virtual bool StartIterate(const bool reverse, StackValue& outStartItem) override;
   virtual bool CustomCopyIncomplete(void* const) override;
+  virtual bool MovableValue() const override;
 
 private:
   std::shared_ptr<DArray>* mValue;
@@ -1760,6 +1820,10 @@ public:
 
   virtual FieldOperand GetFieldOp() override;
 
+  //The element of an already resolved field, read through its access
+  //handle if the field has one.
+  static StackValue GetValueAt(FieldAccessReference& access, const uint64_t index);
+
   virtual void CopyFieldOp(const FieldOperand& source) override;
 
   virtual TableReference& GetTableReference() override;
@@ -1773,6 +1837,7 @@ private:
 
 class BaseFieldElOperand : public BaseOperand
 {
+  friend class FixedFieldElOperand;
   friend class CharTextFieldElOperand;
   friend class TextFieldElOperand;
   friend class ArrayFieldElOperand;
@@ -1831,11 +1896,66 @@ private:
 };
 
 
-class BoolFieldElOperand : public BaseFieldElOperand
+//The elements of the fields with fixed size values. They are read through
+//the field's access handle, if the operand was created with one.
+class FixedFieldElOperand : public BaseFieldElOperand
+{
+protected:
+  FixedFieldElOperand(TableReference* const tableRef,
+                      const ROW_INDEX row,
+                      const FIELD_INDEX field,
+                      FieldAccessReference* const access)
+    : BaseFieldElOperand(tableRef, row, field),
+      mAccess(access)
+  {
+    if (mAccess != nullptr)
+      mAccess->IncrementRefCount();
+  }
+
+  FixedFieldElOperand(const FixedFieldElOperand& source)
+    : BaseFieldElOperand(source),
+      mAccess(source.mAccess)
+  {
+    if (mAccess != nullptr)
+      mAccess->IncrementRefCount();
+  }
+
+  virtual ~FixedFieldElOperand() override;
+
+  template<typename DBS_T> void Get(DBS_T& out) const
+  {
+    if (mAccess == nullptr)
+    {
+      BaseFieldElOperand::Get(out);
+      return;
+    }
+
+    if (mTableRef->GetTable().AllocatedRows() <= mRow)
+    {
+      out = DBS_T();
+      return;
+    }
+
+    mAccess->GetAccess().Get(mRow, out);
+  }
+
+  virtual bool CustomCopyIncomplete(void* const dest) override;
+
+private:
+  FixedFieldElOperand& operator= (const FixedFieldElOperand* source);
+
+  FieldAccessReference*   mAccess;
+};
+
+
+class BoolFieldElOperand : public FixedFieldElOperand
 {
 public:
-  BoolFieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  BoolFieldElOperand(TableReference* const tableRef,
+                     const ROW_INDEX row,
+                     const FIELD_INDEX field,
+                     FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -1858,11 +1978,14 @@ public:
 };
 
 
-class CharFieldElOperand : public BaseFieldElOperand
+class CharFieldElOperand : public FixedFieldElOperand
 {
 public:
-  CharFieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  CharFieldElOperand(TableReference* const tableRef,
+                     const ROW_INDEX row,
+                     const FIELD_INDEX field,
+                     FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -1879,11 +2002,14 @@ public:
 };
 
 
-class DateFieldElOperand : public BaseFieldElOperand
+class DateFieldElOperand : public FixedFieldElOperand
 {
 public:
-  DateFieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  DateFieldElOperand(TableReference* const tableRef,
+                     const ROW_INDEX row,
+                     const FIELD_INDEX field,
+                     FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -1902,14 +2028,14 @@ public:
 };
 
 
-class DateTimeFieldElOperand : public BaseFieldElOperand
+class DateTimeFieldElOperand : public FixedFieldElOperand
 {
 public:
-
   DateTimeFieldElOperand(TableReference* const tableRef,
                          const ROW_INDEX row,
-                         const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+                         const FIELD_INDEX field,
+                         FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -1928,13 +2054,14 @@ public:
 };
 
 
-class HiresTimeFieldElOperand : public BaseFieldElOperand
+class HiresTimeFieldElOperand : public FixedFieldElOperand
 {
 public:
   HiresTimeFieldElOperand(TableReference* const tableRef,
                           const ROW_INDEX row,
-                          const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+                          const FIELD_INDEX field,
+                          FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -1953,11 +2080,14 @@ public:
 };
 
 
-class UInt8FieldElOperand : public BaseFieldElOperand
+class UInt8FieldElOperand : public FixedFieldElOperand
 {
 public:
-  UInt8FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  UInt8FieldElOperand(TableReference* const tableRef,
+                      const ROW_INDEX row,
+                      const FIELD_INDEX field,
+                      FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2003,11 +2133,14 @@ public:
 };
 
 
-class UInt16FieldElOperand : public BaseFieldElOperand
+class UInt16FieldElOperand : public FixedFieldElOperand
 {
 public:
-  UInt16FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-      : BaseFieldElOperand(tableRef, row, field)
+  UInt16FieldElOperand(TableReference* const tableRef,
+                       const ROW_INDEX row,
+                       const FIELD_INDEX field,
+                       FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2053,11 +2186,14 @@ public:
 };
 
 
-class UInt32FieldElOperand : public BaseFieldElOperand
+class UInt32FieldElOperand : public FixedFieldElOperand
 {
 public:
-  UInt32FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  UInt32FieldElOperand(TableReference* const tableRef,
+                       const ROW_INDEX row,
+                       const FIELD_INDEX field,
+                       FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2103,11 +2239,14 @@ public:
 };
 
 
-class UInt64FieldElOperand : public BaseFieldElOperand
+class UInt64FieldElOperand : public FixedFieldElOperand
 {
 public:
-  UInt64FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  UInt64FieldElOperand(TableReference* const tableRef,
+                       const ROW_INDEX row,
+                       const FIELD_INDEX field,
+                       FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2153,11 +2292,14 @@ public:
 };
 
 
-class Int8FieldElOperand : public BaseFieldElOperand
+class Int8FieldElOperand : public FixedFieldElOperand
 {
 public:
-  Int8FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-      : BaseFieldElOperand(tableRef, row, field)
+  Int8FieldElOperand(TableReference* const tableRef,
+                     const ROW_INDEX row,
+                     const FIELD_INDEX field,
+                     FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2203,11 +2345,14 @@ public:
 };
 
 
-class Int16FieldElOperand : public BaseFieldElOperand
+class Int16FieldElOperand : public FixedFieldElOperand
 {
 public:
-  Int16FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  Int16FieldElOperand(TableReference* const tableRef,
+                      const ROW_INDEX row,
+                      const FIELD_INDEX field,
+                      FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2253,11 +2398,14 @@ public:
 };
 
 
-class Int32FieldElOperand : public BaseFieldElOperand
+class Int32FieldElOperand : public FixedFieldElOperand
 {
 public:
-  Int32FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  Int32FieldElOperand(TableReference* const tableRef,
+                      const ROW_INDEX row,
+                      const FIELD_INDEX field,
+                      FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2303,11 +2451,14 @@ public:
 };
 
 
-class Int64FieldElOperand : public BaseFieldElOperand
+class Int64FieldElOperand : public FixedFieldElOperand
 {
 public:
-  Int64FieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  Int64FieldElOperand(TableReference* const tableRef,
+                      const ROW_INDEX row,
+                      const FIELD_INDEX field,
+                      FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2354,11 +2505,14 @@ public:
 };
 
 
-class RealFieldElOperand : public BaseFieldElOperand
+class RealFieldElOperand : public FixedFieldElOperand
 {
 public:
-  RealFieldElOperand(TableReference* const tableRef, const ROW_INDEX row, const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+  RealFieldElOperand(TableReference* const tableRef,
+                     const ROW_INDEX row,
+                     const FIELD_INDEX field,
+                     FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -2388,13 +2542,14 @@ public:
 };
 
 
-class RichRealFieldElOperand : public BaseFieldElOperand
+class RichRealFieldElOperand : public FixedFieldElOperand
 {
 public:
   RichRealFieldElOperand(TableReference* const tableRef,
                          const ROW_INDEX row,
-                         const FIELD_INDEX field)
-    : BaseFieldElOperand(tableRef, row, field)
+                         const FIELD_INDEX field,
+                         FieldAccessReference* const access = nullptr)
+    : FixedFieldElOperand(tableRef, row, field, access)
   {
   }
 
@@ -3500,6 +3655,10 @@ class LocalOperand : public BaseOperand
 public:
   LocalOperand(SessionStack& stack, const uint64_t index);
 
+  StackValue& Referenced() const { return mStack[mIndex]; }
+
+  virtual OPERAND_KIND Kind() const override { return OK_LOCAL; }
+
   virtual bool IsNull() const override;
   virtual bool IsNullExpression() const override;
 
@@ -3579,6 +3738,7 @@ public:
   virtual FieldOperand GetFieldOp() override;
   virtual void CopyFieldOp(const FieldOperand& source) override;
   virtual void RedifineValue(StackValue& source) override;
+  virtual bool StackReference(uint64_t& outIndex) const override;
 
   virtual INativeObject& NativeObject() override;
 
@@ -145,6 +145,13 @@ ArrayOperand::CustomCopyIncomplete(void* const dest)
 }
 
 
+bool
+ArrayOperand::MovableValue() const
+{
+  return true;
+}
+
+
 bool
 BaseArrayElOperand::IsNull() const
 {
@@ -242,71 +242,92 @@ FieldOperand::GetTable()
 }
 
 
-StackValue
-FieldOperand::GetValueAt(const uint64_t index)
+static StackValue
+field_element_at(TableReference* const        tableRef,
+                 const FIELD_INDEX           field,
+                 const uint_t                fieldType,
+                 const uint64_t              index,
+                 FieldAccessReference* const access)
 {
+  if (IS_ARRAY(fieldType))
+    return StackValue(ArrayFieldElOperand(tableRef, index, field));
 
-  if ((mFieldType == T_UNKNOWN) || (mTableRef == nullptr))
-    throw InterException(_EXTRA(InterException::FIELD_TYPE_MISMATCH));
-
-  if (IS_ARRAY(mFieldType))
-    return StackValue(ArrayFieldElOperand(mTableRef, index, mField));
-
-  switch(mFieldType)
+  switch(fieldType)
   {
   case T_BOOL:
-    return StackValue(BoolFieldElOperand(mTableRef, index, mField));
+    return StackValue(BoolFieldElOperand(tableRef, index, field, access));
 
   case T_CHAR:
-    return StackValue(CharFieldElOperand(mTableRef, index, mField));
+    return StackValue(CharFieldElOperand(tableRef, index, field, access));
 
   case T_DATE:
-    return StackValue(DateFieldElOperand(mTableRef, index, mField));
+    return StackValue(DateFieldElOperand(tableRef, index, field, access));
 
   case T_DATETIME:
-    return StackValue(DateTimeFieldElOperand(mTableRef, index, mField));
+    return StackValue(DateTimeFieldElOperand(tableRef, index, field, access));
 
   case T_HIRESTIME:
-    return StackValue(HiresTimeFieldElOperand(mTableRef, index, mField));
+    return StackValue(HiresTimeFieldElOperand(tableRef, index, field, access));
 
   case T_UINT8:
-    return StackValue(UInt8FieldElOperand(mTableRef, index, mField));
+    return StackValue(UInt8FieldElOperand(tableRef, index, field, access));
 
   case T_UINT16:
-    return StackValue(UInt16FieldElOperand(mTableRef, index, mField));
+    return StackValue(UInt16FieldElOperand(tableRef, index, field, access));
 
   case T_UINT32:
-    return StackValue(UInt32FieldElOperand(mTableRef, index, mField));
+    return StackValue(UInt32FieldElOperand(tableRef, index, field, access));
 
   case T_UINT64:
-    return StackValue(UInt64FieldElOperand(mTableRef, index, mField));
+    return StackValue(UInt64FieldElOperand(tableRef, index, field, access));
 
   case T_INT8:
-    return StackValue(Int8FieldElOperand(mTableRef, index, mField));
+    return StackValue(Int8FieldElOperand(tableRef, index, field, access));
 
   case T_INT16:
-    return StackValue(Int16FieldElOperand(mTableRef, index, mField));
+    return StackValue(Int16FieldElOperand(tableRef, index, field, access));
 
   case T_INT32:
-    return StackValue(Int32FieldElOperand(mTableRef, index, mField));
+    return StackValue(Int32FieldElOperand(tableRef, index, field, access));
 
   case T_INT64:
-    return StackValue(Int64FieldElOperand(mTableRef, index, mField));
+    return StackValue(Int64FieldElOperand(tableRef, index, field, access));
 
   case T_REAL:
-    return StackValue(RealFieldElOperand(mTableRef, index, mField));
+    return StackValue(RealFieldElOperand(tableRef, index, field, access));
 
   case T_RICHREAL:
-    return StackValue(RichRealFieldElOperand(mTableRef, index, mField));
+    return StackValue(RichRealFieldElOperand(tableRef, index, field, access));
 
   case T_TEXT:
-    return StackValue(TextFieldElOperand(mTableRef, index, mField));
+    return StackValue(TextFieldElOperand(tableRef, index, field));
   }
 
   throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
 }
 
 
+StackValue
+FieldOperand::GetValueAt(const uint64_t index)
+{
+  if ((mFieldType == T_UNKNOWN) || (mTableRef == nullptr))
+    throw InterException(_EXTRA(InterException::FIELD_TYPE_MISMATCH));
+
+  return field_element_at(mTableRef, mField, mFieldType, index, nullptr);
+}
+
+
+StackValue
+FieldOperand::GetValueAt(FieldAccessReference& access, const uint64_t index)
+{
+  return field_element_at( &access.GetTableReference(),
+                          access.GetField(),
+                          access.GetFieldType(),
+                          index,
+                          &access);
+}
+
+
 StackValue
 FieldOperand::Clone() const
 {
@@ -323,7 +344,22 @@ FieldOperand::StartIterate(const bool reverse, StackValue& outStartItem)
   if (mTableRef->GetTable().AllocatedRows() <= 0)
     return false;
 
-  outStartItem = GetValueAt(reverse ? mTableRef->GetTable().AllocatedRows() - 1 : 0);
+  //The iteration goes through the rows in sequence, so it keeps its own
+  //access handle for as long as it lasts.
+  const ROW_INDEX startRow = reverse ? mTableRef->GetTable().AllocatedRows() - 1 : 0;
+  FieldAccessReference* const access = new FieldAccessReference( *mTableRef, mField);
+
+  access->IncrementRefCount();
+  try
+  {
+    outStartItem = GetValueAt( *access, startRow);
+  }
+  catch (...)
+  {
+    access->DecrementRefCount();
+    throw;
+  }
+  access->DecrementRefCount();
 
   return true;
 }
@@ -406,6 +442,23 @@ BaseFieldElOperand::CustomCopyIncomplete(void* const)
 }
 
 
+FixedFieldElOperand::~FixedFieldElOperand()
+{
+  if (mAccess != nullptr)
+    mAccess->DecrementRefCount();
+}
+
+
+bool
+FixedFieldElOperand::CustomCopyIncomplete(void* const dest)
+{
+  if (mAccess != nullptr)
+    mAccess->IncrementRefCount();
+
+  return BaseFieldElOperand::CustomCopyIncomplete(dest);
+}
+
+
 bool
 BoolFieldElOperand::IsNull() const
 {
@@ -0,0 +1,267 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "compiler/wopcodes.h"
+#include "utils/wthread.h"
+#include "utils/endianness.h"
+
+#include "pm_opprofile.h"
+#include "pm_processor.h"
+
+
+using namespace std;
+
+
+namespace whais {
+namespace prima {
+
+
+static const char* opcodesNames[] = {
+                                      "NA", "LDNULL", "LDC", "LDI8", "LDI16", "LDI32", "LDI64",
+                                      "LDD", "LDDT", "LDHT", "LDRR", "LDT", "LDBT", "LDBF",
+                                      "LDLO8", "LDLO16", "LDLO32", "LDGB8", "LDGB16", "LDGB32", "CTS",
+                                      "STB", "STC", "STD", "STDT", "STHT", "STI8", "STI16",
+                                      "STI32", "STI64", "STR", "STRR", "STT", "STUI8", "STUI16",
+                                      "STUI32", "STUI64", "STTA", "STF", "STA", "STUD", "INULL",
+                                      "NNULL", "CALL", "RET", "ADD", "ADDRR", "ADDT", "AND",
+                                      "ANDB", "DIV", "DIVU", "DIVRR", "EQ", "EQB", "EQC",
+                                      "EQD", "EQDT", "EQHT", "EQRR", "EQT", "GE", "GEU",
+                                      "GEC", "GED", "GEDT", "GEHT", "GERR", "GT", "GTU",
+                                      "GTC", "GTD", "GTDT", "GTHT", "GTRR", "LE", "LEU",
+                                      "LEC", "LED", "LEDT", "LEHT", "LERR", "LT", "LTU",
+                                      "LTC", "LTD", "LTDT", "LTHT", "LTRR", "MOD", "MODU",
+                                      "MUL", "MULU", "MULRR", "NE", "NEB", "NEC", "NED",
+                                      "NEDT", "NEHT", "NERR", "NET", "NOT", "NOTB", "OR",
+                                      "ORB", "SUB", "SUBRR", "XOR", "XORB", "JF", "JFC",
+                                      "JT", "JTC", "JMP", "INDT", "INDA", "INDF", "INDTA",
+                                      "SELF", "BSYNC", "ESYNC", "SADD", "SADDRR", "SADDC", "SADDT",
+                                      "SSUB", "SSUBRR", "SMUL", "SMULU", "SMULRR", "SDIV", "SDIVU",
+                                      "SDIVRR", "SMOD", "SMODU", "SAND", "SANDB", "SXOR", "SXORB",
+                                      "SOR", "SORB", "ITF", "ITL", "ITN", "ITP", "ITOFF",
+                                      "FID", "CARR", "AJOIN", "AFOUT", "AFIN",
+                                      "ADDI8", "ADDI16", "ADDI32", "ADDI64", "ADDU8", "ADDU16", "ADDU32", "ADDU64",
+                                      "SUBI8", "SUBI16", "SUBI32", "SUBI64", "SUBU8", "SUBU16", "SUBU32", "SUBU64",
+                                      "MULI8", "MULI16", "MULI32", "MULI64", "MULU8", "MULU16", "MULU32", "MULU64",
+                                      "EQI8", "EQI16", "EQI32", "EQI64", "EQU8", "EQU16", "EQU32", "EQU64",
+                                      "NEI8", "NEI16", "NEI32", "NEI64", "NEU8", "NEU16", "NEU32", "NEU64",
+                                      "LTI8", "LTI16", "LTI32", "LTI64", "LTU8", "LTU16", "LTU32", "LTU64",
+                                      "LEI8", "LEI16", "LEI32", "LEI64", "LEU8", "LEU16", "LEU32", "LEU64",
+                                      "GTI8", "GTI16", "GTI32", "GTI64", "GTU8", "GTU16", "GTU32", "GTU64",
+                                      "GEI8", "GEI16", "GEI32", "GEI64", "GEU8", "GEU16", "GEU32", "GEU64"
+                                    };
+
+static_assert(sizeof opcodesNames / sizeof opcodesNames[0] == W_OP_END_MARK,
+              "The opcodes' names do not match the opcodes.");
+
+
+struct ProcedureCounters
+{
+  vector<uint8_t>   mCode;
+  vector<uint64_t>  mCounts;
+  vector<bool>      mInlined;
+  vector<bool>      mJumpTargets;
+};
+
+
+static Lock                           gProfileSync;
+static map<string, ProcedureCounters> gProfile;
+
+
+static bool
+is_flow_change(const uint_t opcode)
+{
+  return (opcode == W_RET) || ((W_JF <= opcode) && (opcode <= W_JMP));
+}
+
+
+static void
+mark_jump_targets(const Procedure& procedure,
+                  const uint8_t* const code,
+                  vector<bool>& outJumpTargets)
+{
+  outJumpTargets.assign(procedure.mCodeSize + 1, false);
+
+  for (uint32_t pos = 0; pos < procedure.mCodeSize; )
+  {
+    const uint_t size = ProcedureCall::InstructionSize(code + pos);
+
+    if ((W_JF <= code[pos]) && (code[pos] <= W_JMP) && (pos + size <= procedure.mCodeSize))
+    {
+      const int64_t target = _SC(int64_t, pos) + _SC(int32_t, load_le_int32(code + pos + 1));
+
+      if ((0 <= target) && (target < procedure.mCodeSize))
+        outJumpTargets[target] = true;
+    }
+    pos += size;
+  }
+}
+
+
+volatile bool OpcodeProfile::smEnabled = false;
+
+
+void
+OpcodeProfile::Enable(const bool enable)
+{
+  smEnabled = enable;
+}
+
+
+void
+OpcodeProfile::Record(const Procedure& procedure,
+                      const uint8_t* const code,
+                      Session& session,
+                      const vector<uint64_t>& counts)
+{
+  assert(counts.size() == procedure.mCodeSize);
+
+  const string name(_RC(const char*, procedure.mProcMgr->Name(procedure.mId)));
+
+  LockGuard<Lock> syncHolder(gProfileSync);
+
+  ProcedureCounters& counters = gProfile[name];
+
+  //A procedure with the same name but with a different code starts anew.
+  if ((counters.mCode.size() != procedure.mCodeSize)
+      || ! equal(counters.mCode.begin(), counters.mCode.end(), code))
+  {
+    counters.mCode.assign(code, code + procedure.mCodeSize);
+    counters.mCounts.assign(procedure.mCodeSize, 0);
+
+    ProcedureCall::InlinedPositions(procedure, code, session, counters.mInlined);
+    mark_jump_targets(procedure, code, counters.mJumpTargets);
+  }
+
+  for (size_t i = 0; i < counts.size(); ++i)
+    counters.mCounts[i] += counts[i];
+}
+
+
+bool
+OpcodeProfile::Counts(const char* const procName, vector<uint64_t>& outCounts)
+{
+  LockGuard<Lock> syncHolder(gProfileSync);
+
+  auto it = gProfile.find(procName);
+  if (it == gProfile.end())
+    return false;
+
+  outCounts = it->second.mCounts;
+  return true;
+}
+
+
+void
+OpcodeProfile::Dump(ostream& out)
+{
+  typedef vector<uint8_t> NGRAM;
+
+  LockGuard<Lock> syncHolder(gProfileSync);
+
+  for (auto& proc : gProfile)
+  {
+    const vector<uint8_t>& code = proc.second.mCode;
+    const vector<uint64_t>& counts = proc.second.mCounts;
+    const vector<bool>& inlined = proc.second.mInlined;
+    const vector<bool>& jumpTargets = proc.second.mJumpTargets;
+
+    //Every time an instruction is executed, all the sequences it starts are
+    //executed too, as long as they do not go over a jump.
+    map<NGRAM, uint64_t> ngrams;
+    for (uint32_t pos = 0; pos < counts.size(); ++pos)
+    {
+      if (counts[pos] == 0)
+        continue;
+
+      NGRAM ngram(1, code[pos]);
+      ngrams[ngram] += counts[pos];
+
+      if (is_flow_change(code[pos]) || inlined[pos])
+        continue;
+
+      uint32_t it = pos + ProcedureCall::InstructionSize(&code[pos]);
+      while ((it < code.size())
+             && (ngram.size() < MAX_NGRAM)
+             && ! (inlined[it] || jumpTargets[it]))
+      {
+        ngram.push_back(code[it]);
+        ngrams[ngram] += counts[pos];
+
+        if (is_flow_change(code[it]))
+          break;
+
+        it += ProcedureCall::InstructionSize(&code[it]);
+      }
+    }
+
+    vector<pair<uint64_t, const NGRAM*>> sorted;
+    for (auto& ngram : ngrams)
+      sorted.push_back(make_pair(ngram.second, &ngram.first));
+
+    sort(sorted.begin(),
+         sorted.end(),
+         [](const pair<uint64_t, const NGRAM*>& a, const pair<uint64_t, const NGRAM*>& b) {
+           return (a.first > b.first) || ((a.first == b.first) && (*a.second < *b.second));
+         });
+
+    for (auto& ngram : sorted)
+    {
+      out << proc.first << ' ' << ngram.first;
+      for (auto opcode : *ngram.second)
+        out << ' ' << OpcodeName(opcode);
+
+      out << '\n';
+    }
+  }
+
+  out.flush();
+}
+
+
+void
+OpcodeProfile::Reset()
+{
+  LockGuard<Lock> syncHolder(gProfileSync);
+
+  gProfile.clear();
+}
+
+
+const char*
+OpcodeProfile::OpcodeName(const uint_t opcode)
+{
+  if (opcode >= sizeof opcodesNames / sizeof opcodesNames[0])
+    return opcodesNames[W_NA];
+
+  return opcodesNames[opcode];
+}
+
+
+} //namespace prima
+} //namespace whais
+
@@ -0,0 +1,82 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PM_OPPROFILE_H_
+#define PM_OPPROFILE_H_
+
+#include <ostream>
+#include <vector>
+
+#include "pm_procedures.h"
+
+
+namespace whais {
+namespace prima {
+
+
+//Counts how many times the procedures' instructions are executed, so the
+//most frequent opcodes sequences (n-grams) may be found offline and fused
+//by the decoder. It is meant for offline runs only: while it is
+//enabled the procedures are run from their original code, without the
+//decoded form, so the profile is not bent by the already fused sequences.
+class OpcodeProfile
+{
+public:
+  //The longest opcodes sequence that is reported.
+  static const uint_t MAX_NGRAM = 4;
+
+  static void Enable(const bool enable);
+  static bool IsEnabled() { return smEnabled; }
+
+  //Add the execution counts of a procedure's instructions. These are
+  //indexed by the instructions' positions in the procedure's code.
+  static void Record(const Procedure& procedure,
+                     const uint8_t* const code,
+                     Session& session,
+                     const std::vector<uint64_t>& counts);
+
+  //Get the recorded execution counts of a procedure's instructions.
+  static bool Counts(const char* const procName, std::vector<uint64_t>& outCounts);
+
+  //Write a '<procedure> <count> <opcode> ...' line for every executed
+  //opcode and for every sequence of up to MAX_NGRAM instructions that the
+  //decoded code still dispatches to their generic handlers. So the
+  //sequences do not go over the instructions already fused or specialised,
+  //the jump targets, the jumps and the returns.
+  static void Dump(std::ostream& out);
+
+  static void Reset();
+
+  static const char* OpcodeName(const uint_t opcode);
+
+private:
+  static volatile bool smEnabled;
+};
+
+
+} //namespace prima
+} //namespace whais
+
+
+#endif //PM_OPPROFILE_H_
@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "pm_procedures.h"
 #include "pm_interpreter.h"
 #include "pm_typemanager.h"
+#include "pm_processor.h"
 
 
 using namespace std;
@@ -68,10 +69,19 @@ ProcedureManager::AddProcedure(const uint8_t* const name,
   entry.mUnit        = unit;
   entry.mProcMgr     = this;
   entry.mNativeCode  = (unit == nullptr) ? _RC(WLIB_PROCEDURE, code) : nullptr;
+  entry.mPlainLocals = true;
+
+  //Locals of basic types hold nothing that need to be shared or released.
+  for (uint_t i = argsCount + 1; (i < localsCount) && entry.mPlainLocals; ++i)
+  {
+    const uint_t type = localValues[i].Operand().GetType();
+    entry.mPlainLocals = (T_BOOL <= type) && (type <= T_RICHREAL);
+  }
 
   const uint32_t result = mProcsEntrys.size();
 
-  mSyncStmts.insert(mSyncStmts.end(), syncCount, false);
+  for (uint_t i = 0; i < syncCount; ++i)
+    mSyncStmts.emplace_back();
 
   for (uint_t i = 0; i < localsCount; ++i)
     mLocalsValues.push_back(StackValue(localValues[i]));
@@ -82,6 +92,9 @@ ProcedureManager::AddProcedure(const uint8_t* const name,
   mLocalsTypes.insert(mLocalsTypes.end(), typesOffset, typesOffset + localsCount);
 
   mProcsEntrys.push_back(entry);
+  mDecodedCode.emplace_back(nullptr);
+  mChangedCode.emplace_back(false);
+  mProfiles.emplace_back();
 
   return result;
 }
@@ -186,7 +199,84 @@ ProcedureManager::Code(const Procedure& proc, uint_t* const outCodeSize) const
 }
 
 void
-ProcedureManager::AquireSync(const Procedure& proc, const uint32_t sync)
+ProcedureManager::InvalidateDecoded(const Procedure& proc)
+{
+  assert(proc.mProcMgr == this);
+
+  LockGuard<Lock> holder(mSync);
+
+  mChangedCode[proc.mId].store(true, memory_order_release);
+  atomic_store_explicit(&mDecodedCode[proc.mId], SHARED_DECODED_CODE(), memory_order_release);
+}
+
+void
+ProcedureManager::VerifyChanged(const Procedure& proc, Session& session)
+{
+  assert(proc.mProcMgr == this);
+
+  if ( ! mChangedCode[proc.mId].load(memory_order_acquire))
+    return;
+
+  LockGuard<Lock> holder(mSync);
+
+  VerifyCode(proc, session);
+}
+
+void
+ProcedureManager::VerifyCode(const Procedure& proc, Session& session)
+{
+  if ( ! mChangedCode[proc.mId].load(memory_order_relaxed))
+    return;
+
+  const Unit& unit = *proc.mUnit;
+
+  vector<uint32_t> procsArgs;
+  for (uint32_t p = 0; p < unit.mProcsCount; ++p)
+    procsArgs.push_back(session.GetProcedure(unit.GetProcedureId(p)).mArgsCount);
+
+  unit.VerifyCode(&mDefinitions[proc.mCodeIndex],
+                  proc.mCodeSize,
+                  proc.mLocalsCount,
+                  proc.mSyncCount,
+                  procsArgs.data(),
+                  _RC(const char*, Name(proc.mId)));
+
+  mChangedCode[proc.mId].store(false, memory_order_release);
+}
+
+SHARED_DECODED_CODE
+ProcedureManager::Instructions(const Procedure& proc, Session& session)
+{
+  assert(proc.mProcMgr == this);
+  assert(proc.mNativeCode == nullptr);
+
+  SHARED_DECODED_CODE& decoded = mDecodedCode[proc.mId];
+
+  SHARED_DECODED_CODE instructions = atomic_load_explicit(&decoded, memory_order_acquire);
+  if (instructions)
+    return instructions;
+
+  LockGuard<Lock> holder(mSync);
+
+  //Some one might have decoded it while we were waiting.
+  instructions = atomic_load_explicit(&decoded, memory_order_relaxed);
+  if ( ! instructions)
+  {
+    VerifyCode(proc, session);
+
+    shared_ptr<DECODED_CODE> newInstructions = make_shared<DECODED_CODE>();
+
+    ProcedureCall::DecodeCode(proc, &mDefinitions[proc.mCodeIndex], session, *newInstructions);
+
+    instructions = move(newInstructions);
+    atomic_store_explicit(&decoded, instructions, memory_order_release);
+  }
+
+  return instructions;
+}
+
+bool
+ProcedureManager::AquireSync(const Procedure& proc, const uint32_t sync, const uint_t timeout)
 {
   assert(proc.mProcMgr == this);
   assert(sync < proc.mSyncCount);
@@ -194,24 +284,10 @@ ProcedureManager::AquireSync(const Procedure& proc, const uint32_t sync)
   if (sync >= proc.mSyncCount)
     throw InterException(_EXTRA(InterException::INVALID_SYNC_REQ));
 
-  do
-  {
-    LockGuard<Lock> holder(mSync);
-    const bool aquired = mSyncStmts[proc.mSyncIndex + sync];
-    if (aquired)
-    {
-      //Some one has taken this before us! Prepare to try again!
-      holder.unlock();
-      wh_yield();
-    }
-    else
-    {
-      mSyncStmts[proc.mSyncIndex + sync] = true;
-      break;
-    }
-  } while (true);
+  return mSyncStmts[proc.mSyncIndex + sync].Aquire(timeout);
 }
 
+
 void
 ProcedureManager::ReleaseSync(const Procedure& proc, const uint32_t sync)
 {
@@ -221,9 +297,238 @@ ProcedureManager::ReleaseSync(const Procedure& proc, const uint32_t sync)
   if (sync >= proc.mSyncCount)
     throw InterException( _EXTRA(InterException::INVALID_SYNC_REQ));
 
-  assert(mSyncStmts[proc.mSyncIndex + sync] == true);
+  mSyncStmts[proc.mSyncIndex + sync].Release();
+}
+
+
+bool
+ProcedureManager::EnqueueSync(const Procedure& proc,
+                              const uint32_t sync,
+                              SyncStatement::Waiter& waiter)
+{
+  assert(proc.mProcMgr == this);
+  assert(sync < proc.mSyncCount);
+
+  if (sync >= proc.mSyncCount)
+    throw InterException(_EXTRA(InterException::INVALID_SYNC_REQ));
+
+  return mSyncStmts[proc.mSyncIndex + sync].Enqueue(waiter);
+}
+
+
+SyncStatement::WAIT_RESULT
+ProcedureManager::WaitSync(const Procedure& proc,
+                           const uint32_t sync,
+                           SyncStatement::Waiter& waiter,
+                           const uint_t timeout,
+                           const bool block)
+{
+  assert(proc.mProcMgr == this);
+  assert(sync < proc.mSyncCount);
+
+  if (sync >= proc.mSyncCount)
+    throw InterException(_EXTRA(InterException::INVALID_SYNC_REQ));
+
+  return mSyncStmts[proc.mSyncIndex + sync].Wait(waiter, timeout, block);
+}
+
+
+void
+ProcedureManager::WithdrawSync(const Procedure& proc,
+                               const uint32_t sync,
+                               SyncStatement::Waiter& waiter)
+{
+  assert(proc.mProcMgr == this);
+  assert(sync < proc.mSyncCount);
+
+  if (sync >= proc.mSyncCount)
+    throw InterException(_EXTRA(InterException::INVALID_SYNC_REQ));
+
+  mSyncStmts[proc.mSyncIndex + sync].Withdraw(waiter);
+}
+
+
+void
+ProcedureManager::SyncStatistics(const Procedure& proc,
+                                 const uint32_t sync,
+                                 SyncStatementStats& outStats)
+{
+  assert(proc.mProcMgr == this);
+
+  if (sync >= proc.mSyncCount)
+    throw InterException( _EXTRA(InterException::INVALID_SYNC_REQ));
+
+  mSyncStmts[proc.mSyncIndex + sync].Statistics(outStats);
+}
+
 
-  mSyncStmts[proc.mSyncIndex + sync] = false;
+ProcedureProfile&
+ProcedureManager::Profile(const Procedure& proc)
+{
+  assert(proc.mProcMgr == this);
+  assert(proc.mId < mProfiles.size());
+
+  return mProfiles[proc.mId];
+}
+
+
+SyncStatement::SyncStatement()
+{
+  memset(&mStats, 0, sizeof mStats);
+}
+
+
+bool
+SyncStatement::Aquire(const uint_t timeout)
+{
+  Waiter waiter;
+
+  if (Enqueue(waiter))
+    return true;
+
+  return Wait(waiter, timeout, true) == WAIT_GRANTED;
+}
+
+
+void
+SyncStatement::Release()
+{
+  LockGuard<Lock> holder(mLock);
+
+  HandOver();
+}
+
+
+bool
+SyncStatement::Enqueue(Waiter& waiter)
+{
+  LockGuard<Lock> holder(mLock);
+
+  if ( ! mStats.mHeld)
+  {
+    Entered(0);
+    return true;
+  }
+
+  waiter.mWaitStart = wh_msec_ticks();
+  waiter.mGranted = false;
+  waiter.mEntered = false;
+
+  mWaiters.push_back(&waiter);
+  ++mStats.mContentions, ++mStats.mWaiting;
+
+  return false;
+}
+
+
+SyncStatement::WAIT_RESULT
+SyncStatement::Wait(Waiter& waiter, const uint_t timeout, const bool block)
+{
+  LockGuard<Lock> holder(mLock);
+
+  while ( ! waiter.mGranted)
+  {
+    const WTICKS waited = wh_msec_ticks() - waiter.mWaitStart;
+
+    if ((timeout != 0) && (waited >= timeout))
+    {
+      RemoveWaiter(waiter);
+
+      --mStats.mWaiting, ++mStats.mTimeouts;
+      mStats.mWaitTime += waited;
+
+      return WAIT_TIMEOUT;
+    }
+    else if ( ! block)
+      return WAIT_PENDING;
+
+    else if (timeout == 0)
+      waiter.mCond.Wait(mLock);
+
+    else
+      waiter.mCond.Wait(mLock, timeout - waited);
+  }
+
+  if ( ! waiter.mEntered)
+  {
+    waiter.mEntered = true;
+
+    --mStats.mWaiting;
+    Entered(wh_msec_ticks() - waiter.mWaitStart);
+  }
+
+  return WAIT_GRANTED;
+}
+
+
+void
+SyncStatement::Withdraw(Waiter& waiter)
+{
+  LockGuard<Lock> holder(mLock);
+
+  if ( ! waiter.mEntered)
+    --mStats.mWaiting;
+
+  if (waiter.mGranted)
+    HandOver();
+
+  else
+    RemoveWaiter(waiter);
+}
+
+
+void
+SyncStatement::Statistics(SyncStatementStats& outStats)
+{
+  LockGuard<Lock> holder(mLock);
+
+  outStats = mStats;
+}
+
+
+void
+SyncStatement::Entered(const uint64_t waited)
+{
+  mStats.mHeld = true;
+  ++mStats.mAquires;
+
+  mStats.mWaitTime += waited;
+  if (mStats.mMaxWaitTime < waited)
+    mStats.mMaxWaitTime = waited;
+}
+
+
+void
+SyncStatement::HandOver()
+{
+  assert(mStats.mHeld);
+
+  if (mWaiters.empty())
+  {
+    mStats.mHeld = false;
+    return;
+  }
+
+  //Hand it directly to the first waiting, so no one else can take it over.
+  Waiter* const next = mWaiters.front();
+  mWaiters.pop_front();
+
+  next->mGranted = true;
+  next->mCond.Signal();
+}
+
+
+void
+SyncStatement::RemoveWaiter(Waiter& waiter)
+{
+  for (auto it = mWaiters.begin(); it != mWaiters.end(); ++it)
+  {
+    if (*it == &waiter)
+    {
+      mWaiters.erase(it);
+      break;
+    }
+  }
 }
 
 
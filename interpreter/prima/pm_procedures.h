@@ -25,9 +25,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PM_PROCEDURES_H_
 #define PM_PROCEDURES_H_
 
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "whais.h"
+#include "utils/wthread.h"
 #include "stdlib/interface.h"
 #include "pm_operand.h"
 
@@ -39,6 +43,48 @@ namespace prima {
 class  NameSpace;
 struct Unit;
 class  ProcedureManager;
+class  ProcedureCall;
+class  Session;
+
+struct DecodedInstruction;
+struct Procedure;
+
+typedef void (*OPCODE_HANDLER) (ProcedureCall& call, int64_t& ioOffset);
+typedef bool (*FUSED_HANDLER) (ProcedureCall& call, const DecodedInstruction& instr);
+
+//A procedure's instruction with its operands already unpacked and its
+//references (globals, procedures, constants, jump targets) already resolved.
+//A call keeps the procedure it invokes, so it is not looked up again.
+//A sequence of simple instructions working on locals may be fused into one,
+//that keeps the arguments of the sequence in 'mArgs'.
+struct DecodedInstruction
+{
+  union
+  {
+    OPCODE_HANDLER  mHandler;
+    FUSED_HANDLER   mFusedHandler;
+  };
+  union
+  {
+    uint64_t          mValue;
+    const uint8_t*    mData;
+    const Procedure*  mProcedure;
+  };
+  uint32_t          mArgs[3];
+  uint32_t          mCodePos;
+  uint32_t          mTarget;
+  uint8_t           mKind;
+  uint8_t           mOpcode;
+  uint8_t           mOpLength;
+  uint8_t           mLength;
+  uint8_t           mArgTypes[3];
+};
+
+typedef std::vector<DecodedInstruction> DECODED_CODE;
+
+//The calls running a decoded code share it, so it is released by the last
+//of them once the procedure's code has been decoded again.
+typedef std::shared_ptr<const DECODED_CODE> SHARED_DECODED_CODE;
 
 struct Procedure
 {
@@ -55,8 +101,110 @@ struct Procedure
   WLIB_PROCEDURE    mNativeCode;
   Unit*             mUnit;
   ProcedureManager* mProcMgr;
+  bool              mPlainLocals; //Locals' defaults may be copied as raw memory.
+};
+
+//A procedure's synchronised statement. The callers waiting to enter it are
+//queued and it is handed to them in the order they have arrived.
+class SyncStatement
+{
+public:
+  //A caller's place in the queue. A call that can be suspended keeps it
+  //while it does not run, to check later if it was handed the statement.
+  struct Waiter
+  {
+    Condition   mCond;
+    WTICKS      mWaitStart;
+    bool        mGranted;
+    bool        mEntered;
+  };
+
+  enum WAIT_RESULT
+  {
+    WAIT_GRANTED,
+    WAIT_PENDING,
+    WAIT_TIMEOUT
+  };
+
+  SyncStatement();
+  SyncStatement(const SyncStatement&) = delete;
+  SyncStatement& operator= (const SyncStatement&) = delete;
+
+  //Returns false if it could not be entered in 'timeout' milliseconds.
+  //A 0 timeout means to wait as long as it takes.
+  bool Aquire(const uint_t timeout);
+  void Release();
+
+  //Enter it if it is free, otherwise add 'waiter' at the end of the queue
+  //and return false.
+  bool Enqueue(Waiter& waiter);
+
+  //Check if a queued 'waiter' was handed the statement, waiting for it if
+  //'block' is set. It is taken out of the queue if it has waited more than
+  //'timeout' milliseconds since it was queued. Once granted, it is
+  //reported as such until it is released.
+  WAIT_RESULT Wait(Waiter& waiter, const uint_t timeout, const bool block);
+
+  //Take a queued 'waiter' out of the queue, passing the statement to the
+  //next one if it was already handed to it.
+  void Withdraw(Waiter& waiter);
+
+  void Statistics(SyncStatementStats& outStats);
+
+private:
+  void Entered(const uint64_t waited);
+  void HandOver();
+  void RemoveWaiter(Waiter& waiter);
+
+  Lock                  mLock;
+  std::deque<Waiter*>   mWaiters;
+  SyncStatementStats    mStats;
 };
 
+
+//What was found about a procedure's executions while the procedures'
+//profiling was enabled. Unlike the opcodes' profile, this one is collected
+//while the procedures run from their decoded code, so it is cheap enough
+//to be turned on for a production server.
+class ProcedureProfile
+{
+public:
+  ProcedureProfile();
+  ProcedureProfile(const ProcedureProfile&) = delete;
+  ProcedureProfile& operator= (const ProcedureProfile&) = delete;
+
+  //Add what a call has found. The counts are indexed by the procedure's
+  //decoded instructions, as these are executed.
+  void Record(const Procedure& procedure,
+              const DECODED_CODE* const instructions,
+              const uint64_t calls,
+              const uint64_t inclusiveTime,
+              const uint64_t exclusiveTime,
+              const std::vector<uint64_t>& counts);
+
+  //The counts are indexed by the instructions' positions in the procedure's
+  //code. Each instruction of a fused sequence has its own count.
+  void Statistics(ProcedureProfileStats& outStats, std::vector<uint64_t>* const outCodeCounts);
+
+  static void Enable(const bool enable) { smEnabled = enable; }
+  static bool IsEnabled() { return smEnabled; }
+
+  //Drop what was recorded so far for all procedures.
+  static void Reset();
+
+private:
+  void CheckGeneration();
+
+  Lock                  mLock;
+  ProcedureProfileStats mStats;
+  std::vector<uint64_t> mCodeCounts;
+  uint32_t              mGeneration;
+
+  static volatile bool      smEnabled;
+  static volatile uint32_t  smGeneration;
+};
+
+
 class ProcedureManager
 {
 public:
@@ -89,9 +237,39 @@ public:
   const uint8_t* LocalTypeDescription(const uint_t procId, const uint32_t local) const;
   const uint8_t* Code(const Procedure& proc, uint_t* const outCodeSize) const;
 
-  void AquireSync(const Procedure& proc, const uint32_t sync);
+  //Drop the decoded form of a procedure whose code was changed in place,
+  //so it is verified and decoded again before its next execution. The
+  //calls already running keep the old one, released once they end.
+  void InvalidateDecoded(const Procedure& proc);
+
+  //Verify again the code of a procedure changed since it was loaded, as
+  //the instructions' handlers rely on it. Throws if it is not valid.
+  void VerifyChanged(const Procedure& proc, Session& session);
+
+  //The session resolves the procedures called from the decoded code.
+  SHARED_DECODED_CODE Instructions(const Procedure& proc, Session& session);
+
+  bool AquireSync(const Procedure& proc, const uint32_t sync, const uint_t timeout);
   void ReleaseSync(const Procedure& proc, const uint32_t sync);
 
+  bool EnqueueSync(const Procedure& proc,
+                   const uint32_t sync,
+                   SyncStatement::Waiter& waiter);
+  SyncStatement::WAIT_RESULT WaitSync(const Procedure& proc,
+                                      const uint32_t sync,
+                                      SyncStatement::Waiter& waiter,
+                                      const uint_t timeout,
+                                      const bool block);
+  void WithdrawSync(const Procedure& proc,
+                    const uint32_t sync,
+                    SyncStatement::Waiter& waiter);
+
+  void SyncStatistics(const Procedure& proc,
+                      const uint32_t sync,
+                      SyncStatementStats& outStats);
+
+  ProcedureProfile& Profile(const Procedure& proc);
+
   static bool IsValid(const uint32_t entry) { return entry != INVALID_ENTRY; }
   static bool IsGlobalEntry(const uint32_t entry)
   {
@@ -101,16 +279,21 @@ public:
 
 
 private:
+  void VerifyCode(const Procedure& proc, Session& session);
+
   static const uint32_t GLOBAL_ID     = 0x80000000;
   static const uint32_t INVALID_ENTRY = 0xFFFFFFFF;
 
   NameSpace&                  mNameSpace;
-  std::vector<Procedure>      mProcsEntrys;
+  std::deque<Procedure>       mProcsEntrys; //Keeps the entries' addresses.
   std::vector<uint8_t>        mIdentifiers;
   std::vector<StackValue>     mLocalsValues;
   std::vector<uint32_t>       mLocalsTypes;
   std::vector<uint8_t>        mDefinitions;
-  std::vector<bool>           mSyncStmts;
+  std::deque<SyncStatement>   mSyncStmts; //Keeps the statements' addresses.
+  std::deque<ProcedureProfile> mProfiles;
+  std::deque<SHARED_DECODED_CODE> mDecodedCode; //Accessed atomically.
+  std::deque<std::atomic<bool>> mChangedCode;
   Lock                        mSync;
 };
 
@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "compiler/wopcodes.h"
 #include "utils/endianness.h"
 #include "pm_processor.h"
+#include "pm_opprofile.h"
 #include "pm_operand_undefined.h"
 
 
@@ -227,7 +228,9 @@ op_func_ldlo16(ProcedureCall& call, int64_t& offset)
   const uint8_t* const data = call.Code() + call.CurrentOffset() + offset;
   const uint16_t localIndex = load_le_int16(data);
 
-  assert(localIndex < call.LocalsCount());
+  //The iterators and the arguments of the inlined calls are loaded from
+  //the temporary values kept after the procedure's locals.
+  assert(call.StackBegin() + localIndex < call.GetStack().Size());
 
   LocalOperand localOp(call.GetStack(), call.StackBegin() + localIndex);
 
@@ -303,7 +306,7 @@ op_func_cts(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= call.GetStack().Size());
 
-  call.GetStack().Pop(*data);
+  call.GetStack().Drop(*data);
   offset += sizeof (uint8_t);
 }
 
@@ -316,15 +319,15 @@ op_func_stXX(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& src = stack[stackSize - 1].Operand();
-  IOperand& dest = stack[stackSize - 2].Operand();
+  IOperand& src = stack.At(stackSize - 1).Operand();
+  IOperand& dest = stack.At(stackSize - 2).Operand();
 
   T value;
 
   src.GetValue(value);
   dest.SetValue(value);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -336,8 +339,8 @@ op_func_stta(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  BaseOperand& src = _SC(BaseOperand&, stack[stackSize - 1].Operand());
-  BaseOperand& dest = _SC(BaseOperand&, stack[stackSize - 2].Operand());
+  BaseOperand& src = _SC(BaseOperand&, stack.At(stackSize - 1).Operand());
+  BaseOperand& dest = _SC(BaseOperand&, stack.At(stackSize - 2).Operand());
 
   if (src.GetType() == T_UNKNOWN)
   {
@@ -350,7 +353,7 @@ op_func_stta(ProcedureCall& call, int64_t& offset)
   else
     dest.CopyTableOp(src.GetTableOp());
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -362,8 +365,8 @@ op_func_stf(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  BaseOperand& src = _SC(BaseOperand&, stack[stackSize - 1].Operand());
-  BaseOperand& dest = _SC(BaseOperand&, stack[stackSize - 2].Operand());
+  BaseOperand& src = _SC(BaseOperand&, stack.At(stackSize - 1).Operand());
+  BaseOperand& dest = _SC(BaseOperand&, stack.At(stackSize - 2).Operand());
 
   if (src.GetType() == T_UNKNOWN)
   {
@@ -375,7 +378,7 @@ op_func_stf(ProcedureCall& call, int64_t& offset)
   else
     dest.CopyFieldOp(src.GetFieldOp());
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -387,11 +390,16 @@ op_func_stud(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  auto& op = _SC(BaseOperand&, stack[stackSize-2].Operand());
-  StackValue source = stack[stackSize-1].Operand().Clone();
+  auto& op = _SC(BaseOperand&, stack.At(stackSize-2).Operand());
+  StackValue& top = stack.At(stackSize-1);
+
+  //The top entry is discarded anyway, so don't clone a value it owns.
+  StackValue source = _SC(BaseOperand&, top.Operand()).MovableValue()
+                      ? move(top)
+                      : top.Operand().Clone();
   op.RedifineValue(source);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -403,10 +411,10 @@ op_func_inull(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  IOperand& source = stack[stackSize - 1].Operand();
+  IOperand& source = stack.At(stackSize - 1).Operand();
   DBool result(source.IsNull());
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(result);
 }
 
@@ -419,10 +427,10 @@ op_func_nnull(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  IOperand& source = stack[stackSize - 1].Operand();
+  IOperand& source = stack.At(stackSize - 1).Operand();
   DBool result( !source.IsNull());
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(result);
 }
 
@@ -444,6 +452,30 @@ op_func_call(ProcedureCall& call, int64_t& offset)
 }
 
 
+//Get the value returned from the stack's top. The procedure's stack entries
+//are about to be discarded, so the values kept there by the procedure's own
+//locals (e.g. 'RETURN text;') are moved out rather than cloned.
+static StackValue
+return_value(SessionStack& stack, const size_t stackBegin)
+{
+  size_t index = stack.Size() - 1;
+
+  uint64_t refIndex;
+  while (_SC(BaseOperand&, stack.At(index).Operand()).StackReference(refIndex)
+         && (refIndex >= stackBegin))
+  {
+    assert(refIndex < index);
+    index = refIndex;
+  }
+
+  StackValue& value = stack.At(index);
+  if (_SC(BaseOperand&, value.Operand()).MovableValue())
+    return move(value);
+
+  return value.Operand().Clone();
+}
+
+
 static void
 op_func_ret(ProcedureCall& call, int64_t& offset)
 {
@@ -452,9 +484,9 @@ op_func_ret(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount()) <= stackSize);
 
-  StackValue result = stack[stackSize - 1].Operand().Clone();
+  StackValue result = return_value(stack, call.StackBegin());
 
-  stack.Pop(stackSize - call.StackBegin());
+  stack.Drop(stackSize - call.StackBegin());
 
   if (result.Operand().GetType() == T_UNKNOWN)
   {
@@ -477,26 +509,26 @@ op_func_addXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   const DBS_T result(firstOp.mValue + secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -510,10 +542,10 @@ op_func_addt(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DText firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
 
   DText secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
 
   DText result;
   if (firstOp.IsNull())
@@ -528,7 +560,7 @@ op_func_addt(ProcedureCall& call, int64_t& offset)
     result.Append(secondOp);
   }
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -542,26 +574,26 @@ op_func_andXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T result(firstOp.mValue & secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -575,19 +607,19 @@ op_func_divXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
@@ -597,7 +629,7 @@ op_func_divXX(ProcedureCall& call, int64_t& offset)
 
   DBS_T result(firstOp.mValue / secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -611,14 +643,14 @@ op_func_eqXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
 
   DBool result(firstOp == secondOp);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -632,26 +664,26 @@ op_func_geXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBool result((firstOp < secondOp) == false);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -665,26 +697,26 @@ op_func_gtXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBool result(((firstOp < secondOp) || (firstOp == secondOp)) == false);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -698,26 +730,26 @@ op_func_leXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBool result((firstOp < secondOp) || (firstOp == secondOp));
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -731,26 +763,26 @@ op_func_ltXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBool());
     return;
   }
 
   DBool result(firstOp < secondOp);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -764,19 +796,19 @@ op_func_mod(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DInt64 firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DInt64());
     return;
   }
 
   DInt64 secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DInt64());
     return;
   }
@@ -786,7 +818,7 @@ op_func_mod(ProcedureCall& call, int64_t& offset)
 
   DInt64 result(firstOp.mValue % secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -800,19 +832,19 @@ op_func_modu(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DUInt64 firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DUInt64());
     return;
   }
 
   DUInt64 secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DUInt64());
     return;
   };
@@ -822,7 +854,7 @@ op_func_modu(ProcedureCall& call, int64_t& offset)
 
   DUInt64 result(firstOp.mValue % secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -837,26 +869,26 @@ op_func_mulXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T result(firstOp.mValue * secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -870,14 +902,14 @@ op_func_neXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
 
   DBool result((firstOp == secondOp) == false);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -891,13 +923,13 @@ op_func_notXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DBS_T operand;
-  stack[stackSize - 1].Operand().GetValue(operand);
+  stack.At(stackSize - 1).Operand().GetValue(operand);
 
   DBS_T result;
   if (operand.IsNull() == false)
     result = DBS_T( ~operand.mValue);
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(result);
 }
 
@@ -911,13 +943,13 @@ op_func_notXX<DBool> (ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DBool operand;
-  stack[stackSize - 1].Operand().GetValue(operand);
+  stack.At(stackSize - 1).Operand().GetValue(operand);
 
   DBool result;
   if (operand.IsNull() == false)
     result = DBool( !operand.mValue);
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(result);
 }
 
@@ -931,26 +963,26 @@ op_func_orXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T result(firstOp.mValue | secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -964,26 +996,26 @@ op_func_subXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   const DBS_T result(firstOp.mValue - secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -997,26 +1029,26 @@ op_func_xorXX(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
   DBS_T firstOp;
-  stack[stackSize - 2].Operand().GetValue(firstOp);
+  stack.At(stackSize - 2).Operand().GetValue(firstOp);
   if (firstOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T secondOp;
-  stack[stackSize - 1].Operand().GetValue(secondOp);
+  stack.At(stackSize - 1).Operand().GetValue(secondOp);
   if (secondOp.IsNull())
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(DBS_T());
     return;
   }
 
   DBS_T result(firstOp.mValue ^ secondOp.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(result);
 }
 
@@ -1030,7 +1062,7 @@ op_func_jf(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DBool firstOp;
-  stack[stackSize - 1].Operand().GetValue(firstOp);
+  stack.At(stackSize - 1).Operand().GetValue(firstOp);
 
   if ((firstOp.IsNull() == false) && (firstOp.mValue == false))
   {
@@ -1054,8 +1086,8 @@ op_func_jfc(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DBool firstOp;
-  stack[stackSize - 1].Operand().GetValue(firstOp);
-  stack.Pop(1);
+  stack.At(stackSize - 1).Operand().GetValue(firstOp);
+  stack.Drop(1);
 
   if ((firstOp.IsNull() == false) && (firstOp.mValue == false))
   {
@@ -1078,7 +1110,7 @@ op_func_jt(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DBool firstOp;
-  stack[stackSize - 1].Operand().GetValue(firstOp);
+  stack.At(stackSize - 1).Operand().GetValue(firstOp);
 
   if ((firstOp.IsNull() == false) && firstOp.mValue)
   {
@@ -1101,8 +1133,8 @@ op_func_jtc(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DBool firstOp;
-  stack[stackSize - 1].Operand().GetValue(firstOp);
-  stack.Pop(1);
+  stack.At(stackSize - 1).Operand().GetValue(firstOp);
+  stack.Drop(1);
 
   if ((firstOp.IsNull() == false) && firstOp.mValue)
   {
@@ -1135,14 +1167,14 @@ op_func_ind(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DUInt64 index;
-  stack[stackSize - 1].Operand().GetValue(index);
+  stack.At(stackSize - 1).Operand().GetValue(index);
 
   if (index.IsNull())
     throw InterException(_EXTRA(EXCEPTION_CODE));
 
-  StackValue result = stack[stackSize - 2].Operand().GetValueAt(index.mValue);
+  StackValue result = stack.At(stackSize - 2).Operand().GetValueAt(index.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(move(result));
 }
 
@@ -1156,12 +1188,12 @@ op_func_indta(ProcedureCall& call, int64_t& offset)
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
   DUInt64 index;
-  stack[stackSize - 1].Operand().GetValue(index);
+  stack.At(stackSize - 1).Operand().GetValue(index);
 
   if (index.IsNull())
     throw InterException(_EXTRA(InterException::ROW_INDEX_NULL));
 
-  BaseOperand& op = _SC(BaseOperand&, stack[stackSize - 2].Operand());
+  BaseOperand& op = _SC(BaseOperand&, stack.At(stackSize - 2).Operand());
 
   const uint8_t* const pData = call.Code() + call.CurrentOffset() + offset;
   const uint32_t textOff = load_le_int32(pData);
@@ -1169,11 +1201,12 @@ op_func_indta(ProcedureCall& call, int64_t& offset)
 
   offset += sizeof(uint32_t);
 
-  FIELD_INDEX field = op.GetTable().RetrieveField(_RC(const char*, text));
-  FieldOperand fieldOp(op.GetTableReference(), field);
-  StackValue result = fieldOp.GetValueAt(index.mValue);
+  FieldAccessReference& access = call.AccessField(pData,
+                                                  op.GetTableReference(),
+                                                  _RC(const char*, text));
+  StackValue result = FieldOperand::GetValueAt(access, index.mValue);
 
-  stack.Pop(2);
+  stack.Drop(2);
   stack.Push(move(result));
 }
 
@@ -1186,7 +1219,7 @@ op_func_self(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  BaseOperand& op = _SC(BaseOperand&, stack[stackSize - 1].Operand());
+  BaseOperand& op = _SC(BaseOperand&, stack.At(stackSize - 1).Operand());
 
   const uint8_t* const data = call.Code() + call.CurrentOffset() + offset;
   const uint32_t textOff = load_le_int32(data);
@@ -1194,12 +1227,13 @@ op_func_self(ProcedureCall& call, int64_t& offset)
 
   offset += sizeof(uint32_t);
 
-  FIELD_INDEX field = op.GetTable().RetrieveField(_RC(const char*, text));
-
-  FieldOperand fieldOp(op.GetTableReference(), field);
+  const FieldAccessReference& access = call.AccessField(data,
+                                                        op.GetTableReference(),
+                                                        _RC(const char*, text));
+  FieldOperand fieldOp(op.GetTableReference(), access.GetField());
   StackValue result(fieldOp);
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(move(result));
 }
 
@@ -1236,14 +1270,14 @@ op_func_sadd(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfAdd(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1255,14 +1289,14 @@ op_func_ssub(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfSub(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1274,14 +1308,14 @@ op_func_smul(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfMul(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1293,14 +1327,14 @@ op_func_sdiv(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfDiv(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1312,14 +1346,14 @@ op_func_smod(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfMod(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1331,14 +1365,14 @@ op_func_sand(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfAnd(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1350,14 +1384,14 @@ op_func_sxor(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfXor(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1369,14 +1403,14 @@ op_func_sor(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
 
-  IOperand& destOp = stack[stackSize - 2].Operand();
+  IOperand& destOp = stack.At(stackSize - 2).Operand();
 
   DBS_T delta;
-  stack[stackSize - 1].Operand().GetValue(delta);
+  stack.At(stackSize - 1).Operand().GetValue(delta);
 
   destOp.SelfOr(delta);
 
-  stack.Pop(1);
+  stack.Drop(1);
 }
 
 
@@ -1388,7 +1422,7 @@ op_start_iterate(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  IOperand& container = stack[stackSize - 1].Operand();
+  IOperand& container = stack.At(stackSize - 1).Operand();
   if (container.IsNull())
   {
     stack.Push(DBool(false));
@@ -1398,7 +1432,7 @@ op_start_iterate(ProcedureCall& call, int64_t& offset)
   StackValue it{NullOperand{}};;
   const bool started = container.StartIterate(reverse, it);
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(move(it));
   stack.Push(DBool(started));
 }
@@ -1412,7 +1446,7 @@ op_iterate(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  IOperand& iteratorOp = stack[stackSize - 1].Operand();
+  IOperand& iteratorOp = stack.At(stackSize - 1).Operand();
 
   const bool started = iteratorOp.Iterate(reverse);
   stack.Push(DBool(started));
@@ -1426,11 +1460,11 @@ op_iterator_offset(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  IOperand& iteratorOp = stack[stackSize - 1].Operand();
+  IOperand& iteratorOp = stack.At(stackSize - 1).Operand();
 
   const uint64_t itOffset = iteratorOp.IteratorOffset();
 
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(DUInt64(itOffset));
 }
 
@@ -1443,19 +1477,19 @@ op_field_id(ProcedureCall& call, int64_t& offset)
 
   assert((call.StackBegin() + call.LocalsCount() - 1 + 1) <= stackSize);
 
-  IOperand& field = stack[stackSize - 1].Operand();
+  IOperand& field = stack.At(stackSize - 1).Operand();
   if (field.IsNullExpression() || field.IsNull())
   {
     call.GetSession().LogMessage("Cannot get a field index due to NULL field value, "
                                  "returning NULL also!");
 
-    stack.Pop(1);
+    stack.Drop(1);
     stack.Push(DUInt64());
     return ;
   }
 
   DUInt64 result(field.GetField());
-  stack.Pop(1);
+  stack.Drop(1);
   stack.Push(result);
 }
 
@@ -1467,7 +1501,7 @@ op_fill_array_elems (SessionStack& stack, DArray& result, const uint_t count)
 
   for (auto index = stackSize - count ; index < stackSize; ++index)
   {
-    IOperand& op = stack[index].Operand();
+    IOperand& op = stack.At(index).Operand();
     if (op.IsNullExpression() || op.IsNull())
       continue;
 
@@ -1485,7 +1519,7 @@ op_fill_array_field_elems(SessionStack& stack, DArray& result, const uint_t coun
 
   for (auto index = stackSize - count ; index < stackSize; ++index)
   {
-    IOperand& op = stack[index].Operand();
+    IOperand& op = stack.At(index).Operand();
     if (op.IsNullExpression() || op.IsNull())
       continue;
 
@@ -1601,7 +1635,7 @@ op_create_array(ProcedureCall& call, int64_t& offset)
     }
   }
 
-  stack.Pop(count);
+  stack.Drop(count);
   stack.Push(result);
 }
 
@@ -1790,8 +1824,8 @@ op_do_array_op(ProcedureCall& call, int64_t& offset)
   const uint8_t* const data = call.Code() + call.CurrentOffset() + offset;
   offset += sizeof(uint8_t);
 
-  IOperand& opA = stack[stack.Size() - 2].Operand();
-  IOperand& opB = stack[stack.Size() - 1].Operand();
+  IOperand& opA = stack.At(stack.Size() - 2).Operand();
+  IOperand& opB = stack.At(stack.Size() - 1).Operand();
 
   const bool opBIsArray = (*data & A_OPB_A_MASK) != 0;
   const bool selfOperation = (*data & A_SELF_MASK) != 0;
@@ -1851,20 +1885,201 @@ op_do_array_op(ProcedureCall& call, int64_t& offset)
   if (selfOperation)
   {
     opA.SetValue(result);
-    stack.Pop(1);
+    stack.Drop(1);
   }
   else
   {
-    stack.Pop(2);
+    stack.Drop(2);
     stack.Push(result);
   }
 }
 
 
+template <class DBS_T> struct IntegerOperand;
+
+template <> struct IntegerOperand<DInt8>
+{
+  typedef Int8Operand OPERAND;
+  static const uint_t TYPE = T_INT8;
+  static const OPERAND_KIND KIND = OK_INT8;
+};
+
+template <> struct IntegerOperand<DInt16>
+{
+  typedef Int16Operand OPERAND;
+  static const uint_t TYPE = T_INT16;
+  static const OPERAND_KIND KIND = OK_INT16;
+};
+
+template <> struct IntegerOperand<DInt32>
+{
+  typedef Int32Operand OPERAND;
+  static const uint_t TYPE = T_INT32;
+  static const OPERAND_KIND KIND = OK_INT32;
+};
+
+template <> struct IntegerOperand<DInt64>
+{
+  typedef Int64Operand OPERAND;
+  static const uint_t TYPE = T_INT64;
+  static const OPERAND_KIND KIND = OK_INT64;
+};
+
+template <> struct IntegerOperand<DUInt8>
+{
+  typedef UInt8Operand OPERAND;
+  static const uint_t TYPE = T_UINT8;
+  static const OPERAND_KIND KIND = OK_UINT8;
+};
+
+template <> struct IntegerOperand<DUInt16>
+{
+  typedef UInt16Operand OPERAND;
+  static const uint_t TYPE = T_UINT16;
+  static const OPERAND_KIND KIND = OK_UINT16;
+};
+
+template <> struct IntegerOperand<DUInt32>
+{
+  typedef UInt32Operand OPERAND;
+  static const uint_t TYPE = T_UINT32;
+  static const OPERAND_KIND KIND = OK_UINT32;
+};
+
+template <> struct IntegerOperand<DUInt64>
+{
+  typedef UInt64Operand OPERAND;
+  static const uint_t TYPE = T_UINT64;
+  static const OPERAND_KIND KIND = OK_UINT64;
+};
+
+
+//Get the value of an operand the compiler found to be of the DBS_T type.
+//The temporary values and the locals holding values of that type are read
+//directly, anything else (e.g. fields, array elements, global values or
+//parameters referencing the caller's values) through its operand.
+template <class DBS_T, class DBS_R> static inline void
+typed_operand_value(StackValue& value, DBS_R& outValue)
+{
+  typedef typename IntegerOperand<DBS_T>::OPERAND OPERAND;
+
+  BaseOperand* op = &_SC(BaseOperand&, value.Operand());
+
+  if (op->Kind() == OK_LOCAL)
+    op = &_SC(BaseOperand&, _SC(LocalOperand*, op)->Referenced().Operand());
+
+  if (op->Kind() == IntegerOperand<DBS_T>::KIND)
+    number_convert(_SC(OPERAND*, op)->Value(), outValue);
+
+  else
+    op->GetValue(outValue);
+}
+
+
+//An integer operator with both operands of the DBS_T type. The result is
+//computed as the generic operator would, on DBS_R values.
+template <uint_t OPCODE, class DBS_T, class DBS_R> static void
+op_func_typed_arithm(ProcedureCall& call, int64_t& offset)
+{
+  SessionStack& stack = call.GetStack();
+  const size_t stackSize = stack.Size();
+
+  assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
+
+  DBS_R firstOp, secondOp, result;
+
+  typed_operand_value<DBS_T>(stack.At(stackSize - 2), firstOp);
+  if ( ! firstOp.IsNull())
+  {
+    typed_operand_value<DBS_T>(stack.At(stackSize - 1), secondOp);
+    if ( ! secondOp.IsNull())
+    {
+      if (OPCODE == W_ADD)
+        result = DBS_R(firstOp.mValue + secondOp.mValue);
+
+      else if (OPCODE == W_SUB)
+        result = DBS_R(firstOp.mValue - secondOp.mValue);
+
+      else
+        result = DBS_R(firstOp.mValue * secondOp.mValue);
+    }
+  }
+
+  stack.Drop(2);
+  stack.Push(result);
+}
+
+
+template <uint_t OPCODE, class DBS_T, class DBS_R> static void
+op_func_typed_compare(ProcedureCall& call, int64_t& offset)
+{
+  SessionStack& stack = call.GetStack();
+  const size_t stackSize = stack.Size();
+
+  assert((call.StackBegin() + call.LocalsCount() - 1 + 2) <= stackSize);
+
+  DBS_R firstOp, secondOp;
+  DBool result;
+
+  typed_operand_value<DBS_T>(stack.At(stackSize - 2), firstOp);
+  typed_operand_value<DBS_T>(stack.At(stackSize - 1), secondOp);
+
+  if ((OPCODE == W_EQ) || (OPCODE == W_NE))
+    result = DBool((firstOp == secondOp) == (OPCODE == W_EQ));
+
+  else if ( ! (firstOp.IsNull() || secondOp.IsNull()))
+  {
+    switch (OPCODE)
+    {
+    case W_LT:
+      result = DBool(firstOp < secondOp);
+      break;
+
+    case W_LE:
+      result = DBool((firstOp < secondOp) || (firstOp == secondOp));
+      break;
+
+    case W_GT:
+      result = DBool(((firstOp < secondOp) || (firstOp == secondOp)) == false);
+      break;
+
+    default:
+      result = DBool((firstOp < secondOp) == false);
+    }
+  }
+
+  stack.Drop(2);
+  stack.Push(result);
+}
+
+
+//The handlers of an operator's typed forms, from T_INT8 to T_UINT64. The
+//unsigned operands are compared as unsigned values, as W_LTU & co. do.
+#define TYPED_ARITHM_HANDLERS(OPCODE, SIGNED_R, UNSIGNED_R)                     \
+                                op_func_typed_arithm<OPCODE, DInt8, SIGNED_R>,   \
+                                op_func_typed_arithm<OPCODE, DInt16, SIGNED_R>,  \
+                                op_func_typed_arithm<OPCODE, DInt32, SIGNED_R>,  \
+                                op_func_typed_arithm<OPCODE, DInt64, SIGNED_R>,  \
+                                op_func_typed_arithm<OPCODE, DUInt8, UNSIGNED_R>,  \
+                                op_func_typed_arithm<OPCODE, DUInt16, UNSIGNED_R>, \
+                                op_func_typed_arithm<OPCODE, DUInt32, UNSIGNED_R>, \
+                                op_func_typed_arithm<OPCODE, DUInt64, UNSIGNED_R>
+
+#define TYPED_COMPARE_HANDLERS(OPCODE, UNSIGNED_R)                              \
+                                op_func_typed_compare<OPCODE, DInt8, DInt64>,    \
+                                op_func_typed_compare<OPCODE, DInt16, DInt64>,   \
+                                op_func_typed_compare<OPCODE, DInt32, DInt64>,   \
+                                op_func_typed_compare<OPCODE, DInt64, DInt64>,   \
+                                op_func_typed_compare<OPCODE, DUInt8, UNSIGNED_R>,  \
+                                op_func_typed_compare<OPCODE, DUInt16, UNSIGNED_R>, \
+                                op_func_typed_compare<OPCODE, DUInt32, UNSIGNED_R>, \
+                                op_func_typed_compare<OPCODE, DUInt64, UNSIGNED_R>
+
+
 typedef void(*OP_FUNC) (ProcedureCall& call, int64_t& ioOffset);
 
 
-static OP_FUNC operations[] = {
+static const OP_FUNC operations[] = {
                                 nullptr,
                                 op_func_ldnull,
                                 op_func_ldc,
@@ -2047,158 +2262,2088 @@ static OP_FUNC operations[] = {
                                 op_create_array,
                                 op_do_array_op<OP_JOIN>,
                                 op_do_array_op<OP_FILTER_OUT>,
-                                op_do_array_op<OP_FILTER_IN>
+                                op_do_array_op<OP_FILTER_IN>,
+
+                                TYPED_ARITHM_HANDLERS(W_ADD, DInt64, DInt64),
+                                TYPED_ARITHM_HANDLERS(W_SUB, DInt64, DInt64),
+                                TYPED_ARITHM_HANDLERS(W_MUL, DInt64, DUInt64),
+                                TYPED_COMPARE_HANDLERS(W_EQ, DInt64),
+                                TYPED_COMPARE_HANDLERS(W_NE, DInt64),
+                                TYPED_COMPARE_HANDLERS(W_LT, DUInt64),
+                                TYPED_COMPARE_HANDLERS(W_LE, DUInt64),
+                                TYPED_COMPARE_HANDLERS(W_GT, DUInt64),
+                                TYPED_COMPARE_HANDLERS(W_GE, DUInt64)
 };
 
+static_assert(sizeof operations / sizeof operations[0] == W_OP_END_MARK,
+              "Every opcode needs a handler!");
 
 
-ProcedureCall::ProcedureCall(Session& session, SessionStack& stack, const Procedure& procedure)
-  : mProcedure(procedure),
-    mSession(session),
-    mStack(stack),
-    mCode(mProcedure.mNativeCode
-           ? nullptr
-           : procedure.mProcMgr->Code(procedure, nullptr)),
-    mStackBegin(stack.Size() - procedure.mArgsCount),
-    mCodePos(0),
-    mAquiredSync(NO_INDEX)
+//How the execution loop has to handle a decoded instruction. The most used
+//instructions are executed in place, the rest through their handlers.
+enum DECODED_KIND
+{
+  DK_GENERIC = 0,
+  DK_LDNULL,
+  DK_LDC,
+  DK_LDI8,
+  DK_LDI16,
+  DK_LDI32,
+  DK_LDI64,
+  DK_LDT,
+  DK_LDBT,
+  DK_LDBF,
+  DK_LDLO,
+  DK_LDGB,
+  DK_CTS,
+  DK_CALL,
+  DK_TAIL_CALL,
+  DK_RET,
+  DK_JF,
+  DK_JFC,
+  DK_JT,
+  DK_JTC,
+  DK_JMP,
+  DK_BSYNC,
+  DK_ESYNC,
+  DK_FUSED,
+  DK_FUSED_JUMP,
+  DK_INVALID,
+  DK_END,
+
+  DK_COUNT
+};
+
+
+static const uint32_t INVALID_INSTRUCTION = 0xFFFFFFFF;
+
+
+static uint_t
+opcode_args_size(const W_OPCODE opcode)
 {
-  if (mProcedure.mNativeCode != nullptr)
+  switch (opcode)
   {
-    const WLIB_STATUS status = procedure.mNativeCode(stack, session);
-    if (status != WOP_OK)
-    {
-      throw InterException(_EXTRA(InterException::NATIVE_CALL_FAILED),
-                           "Native procedure '%s' execution returned unexpected error code '%d'.",
-                           mProcedure.mProcMgr->Name(mProcedure.mId),
-                           status);
-    }
+  case W_LDNULL:
+  case W_LDI8:
+  case W_LDLO8:
+  case W_LDGB8:
+  case W_CTS:
+  case W_BSYNC:
+  case W_ESYNC:
+  case W_AJOIN:
+  case W_AFOUT:
+  case W_AFIN:
+    return sizeof(uint8_t);
+
+  case W_LDI16:
+  case W_LDLO16:
+  case W_LDGB16:
+    return sizeof(uint16_t);
+
+  case W_LDC:
+  case W_LDI32:
+  case W_LDD:
+  case W_LDT:
+  case W_LDLO32:
+  case W_LDGB32:
+  case W_CALL:
+  case W_JF:
+  case W_JFC:
+  case W_JT:
+  case W_JTC:
+  case W_JMP:
+  case W_INDTA:
+  case W_SELF:
+    return sizeof(uint32_t);
+
+  case W_LDDT:
+    return 5 + sizeof(uint16_t);
+
+  case W_LDHT:
+    return sizeof(uint32_t) + 5 + sizeof(uint16_t);
+
+  case W_LDI64:
+    return sizeof(uint64_t);
+
+  case W_LDRR:
+    return sizeof(uint64_t) + sizeof(uint64_t);
+
+  case W_CARR:
+    return sizeof(uint8_t) + sizeof(uint16_t);
 
-    if (stack.Size() != mStackBegin + 1)
-    {
-      std::ostringstream log;
-      log << "Native procedure called '"
-          << _RC(const char*, mProcedure.mProcMgr->Name(mProcedure.mId)) << "'.";
+  default:
+    return 0;
+  }
+}
 
-      throw InterException(_EXTRA(InterException::STACK_CORRUPTED),
-                           "Stack corruption detected after native procedure '%s' execution.",
-                           mProcedure.mProcMgr->Name(mProcedure.mId));
-    }
+
+static void
+resolve_instruction(Session& session,
+                    const Unit& unit,
+                    const uint8_t* const args,
+                    DecodedInstruction& instr)
+{
+  switch (instr.mOpcode)
+  {
+  case W_LDNULL:
+    instr.mKind  = DK_LDNULL;
+    instr.mValue = args[0];
+    break;
+
+  case W_LDC:
+    instr.mKind  = DK_LDC;
+    instr.mValue = load_le_int32(args);
+    break;
+
+  case W_LDI8:
+    instr.mKind  = DK_LDI8;
+    instr.mValue = args[0];
+    break;
+
+  case W_LDI16:
+    instr.mKind  = DK_LDI16;
+    instr.mValue = load_le_int16(args);
+    break;
+
+  case W_LDI32:
+    instr.mKind  = DK_LDI32;
+    instr.mValue = load_le_int32(args);
+    break;
+
+  case W_LDI64:
+    instr.mKind  = DK_LDI64;
+    instr.mValue = load_le_int64(args);
+    break;
+
+  case W_LDT:
+    instr.mData = unit.GetConstData(load_le_int32(args));
+    instr.mKind = DK_LDT;
+    break;
+
+  case W_LDBT:
+    instr.mKind = DK_LDBT;
+    break;
+
+  case W_LDBF:
+    instr.mKind = DK_LDBF;
+    break;
+
+  case W_LDLO8:
+    instr.mKind  = DK_LDLO;
+    instr.mValue = args[0];
+    break;
+
+  case W_LDLO16:
+    instr.mKind  = DK_LDLO;
+    instr.mValue = load_le_int16(args);
+    break;
+
+  case W_LDLO32:
+    instr.mKind  = DK_LDLO;
+    instr.mValue = load_le_int32(args);
+    break;
+
+  case W_LDGB8:
+    instr.mValue = unit.GetGlobalId(args[0]);
+    instr.mKind  = DK_LDGB;
+    break;
+
+  case W_LDGB16:
+    instr.mValue = unit.GetGlobalId(load_le_int16(args));
+    instr.mKind  = DK_LDGB;
+    break;
+
+  case W_LDGB32:
+    instr.mValue = unit.GetGlobalId(load_le_int32(args));
+    instr.mKind  = DK_LDGB;
+    break;
+
+  case W_CTS:
+    instr.mKind  = DK_CTS;
+    instr.mValue = args[0];
+    break;
+
+  case W_CALL:
+    instr.mProcedure = &session.GetProcedure(unit.GetProcedureId(load_le_int32(args)));
+    instr.mKind      = DK_CALL;
+    break;
+
+  case W_RET:
+    instr.mKind = DK_RET;
+    break;
+
+  case W_JF:
+  case W_JFC:
+  case W_JT:
+  case W_JTC:
+  case W_JMP:
+    //The jump offset is resolved to an instruction once all are decoded.
+    instr.mKind  = _SC(uint_t, DK_JF) + (instr.mOpcode - W_JF);
+    instr.mValue = _SC(int64_t, _SC(int32_t, load_le_int32(args)));
+    break;
+
+  case W_BSYNC:
+    instr.mKind  = DK_BSYNC;
+    instr.mValue = args[0];
+    break;
+
+  case W_ESYNC:
+    instr.mKind  = DK_ESYNC;
+    instr.mValue = args[0];
+    break;
+
+  default:
+    break;
+  }
+}
+
+
+//How a fused instruction gets an argument: as an immediate value, through
+//the operand of a local or, for locals of integer types, directly from their
+//value (the type of the local is used as the tag).
+static const uint8_t FA_LOCAL     = T_UNKNOWN;
+static const uint8_t FA_IMMEDIATE = 0xFF;
+
+
+//The operand of a local is accessed as one of the type the local had when
+//the code was decoded. A procedure's own locals keep their operands, as the
+//stores convert the values to their types.
+static inline bool
+fused_type_kept(IOperand& op, const uint8_t type)
+{
+  return (type == FA_LOCAL) || (type == FA_IMMEDIATE) || (op.GetType() == type);
+}
+
+
+template <class DBS_T> static inline void
+fused_arg(ProcedureCall& call,
+          const DecodedInstruction& instr,
+          const uint_t arg,
+          DBS_T& outValue)
+{
+  if (instr.mArgTypes[arg] == FA_IMMEDIATE)
+  {
+    number_convert(DUInt32(instr.mArgs[arg]), outValue);
     return;
   }
+
+  IOperand& op = call.GetStack().At(call.StackBegin() + instr.mArgs[arg]).Operand();
+
+  assert(fused_type_kept(op, instr.mArgTypes[arg]));
+
+  switch (instr.mArgTypes[arg])
+  {
+  case T_INT8:
+    number_convert(_SC(Int8Operand&, op).Value(), outValue);
+    break;
+
+  case T_INT16:
+    number_convert(_SC(Int16Operand&, op).Value(), outValue);
+    break;
+
+  case T_INT32:
+    number_convert(_SC(Int32Operand&, op).Value(), outValue);
+    break;
+
+  case T_INT64:
+    number_convert(_SC(Int64Operand&, op).Value(), outValue);
+    break;
+
+  case T_UINT8:
+    number_convert(_SC(UInt8Operand&, op).Value(), outValue);
+    break;
+
+  case T_UINT16:
+    number_convert(_SC(UInt16Operand&, op).Value(), outValue);
+    break;
+
+  case T_UINT32:
+    number_convert(_SC(UInt32Operand&, op).Value(), outValue);
+    break;
+
+  case T_UINT64:
+    number_convert(_SC(UInt64Operand&, op).Value(), outValue);
+    break;
+
+  default:
+    op.GetValue(outValue);
+  }
+}
+
+
+template <class T> static inline void
+fused_store(ProcedureCall& call, const DecodedInstruction& instr, const T& value)
+{
+  IOperand& dest = call.GetStack().At(call.StackBegin() + instr.mArgs[0]).Operand();
+
+  assert(fused_type_kept(dest, instr.mArgTypes[0]));
+
+  if (instr.mArgTypes[0] == IntegerOperand<T>::TYPE)
+    _SC(typename IntegerOperand<T>::OPERAND&, dest).Value(value);
+
   else
+    dest.SetValue(value);
+}
+
+
+template <uint_t OPCODE, class OP_T> static inline void
+fused_self_update(OP_T& op, const DInt64& delta)
+{
+  if (OPCODE == W_SADD)
+    op.Value(internal_add(op.Value(), delta));
+
+  else
+    op.Value(internal_sub(op.Value(), delta));
+}
+
+
+//local += <arg>, local -= <arg>
+template <uint_t OPCODE> static bool
+fused_self_op(ProcedureCall& call, const DecodedInstruction& instr)
+{
+  DInt64 delta;
+  fused_arg(call, instr, 1, delta);
+
+  IOperand& dest = call.GetStack().At(call.StackBegin() + instr.mArgs[0]).Operand();
+
+  assert(fused_type_kept(dest, instr.mArgTypes[0]));
+
+  switch (instr.mArgTypes[0])
   {
-    if (stack.Size() + LocalsCount() > session.MaxStackCount())
-    {
-      throw InterException(_EXTRA(InterException::STACK_TOO_BIG),
-                           "Failed to call procedure '%s' as it will exceed the maximum stack "
-                           "count of %u elements limit.",
-                           mProcedure.mProcMgr->Name(mProcedure.mId),
-                           session.MaxStackCount());
-    }
+  case T_INT8:
+    fused_self_update<OPCODE>(_SC(Int8Operand&, dest), delta);
+    break;
 
-    //Fill the stack with default values for the local values(don't
-    //include the arguments as they should be on the stack already and the
-    uint32_t local = mProcedure.mArgsCount + 1;
-    if (local < LocalsCount())
-    {
-      const StackValue *localValue = &GetLocalDefault(local);
-      while (local < LocalsCount())
-      {
-        StackValue defaultValue(*localValue);
-        if (IS_TABLE(defaultValue.Operand().GetType())) defaultValue.Operand().GetTable();
+  case T_INT16:
+    fused_self_update<OPCODE>(_SC(Int16Operand&, dest), delta);
+    break;
 
-        stack.Push(move(defaultValue));
-        ++local, ++localValue;
-      }
-    }
+  case T_INT32:
+    fused_self_update<OPCODE>(_SC(Int32Operand&, dest), delta);
+    break;
 
-    //Count only procedure's parameters and local values,
-    //but not the result value too.
-    if (LocalsCount() - 1 > stack.Size())
-    {
-      throw InterException(_EXTRA(InterException::STACK_CORRUPTED),
-                           "Stack corruption detected after procedure '%s' execution.",
-                           mProcedure.mProcMgr->Name(mProcedure.mId));
-    }
+  case T_INT64:
+    fused_self_update<OPCODE>(_SC(Int64Operand&, dest), delta);
+    break;
 
-    try
-    {
-      Run();
-    }
-    catch (Exception& e)
-    {
-      const std::string message = e.Message();
+  case T_UINT8:
+    fused_self_update<OPCODE>(_SC(UInt8Operand&, dest), delta);
+    break;
 
-      if ( !message.empty())
-      {
-        e.Message("%s\n\tCalled from '%s' (PC: %04u).",
-                  message.c_str(),
-                  mProcedure.mProcMgr->Name(mProcedure.mId),
-                  mCodePos);
-      }
-      else
-      {
-        e.Message("Current procedure '%s'(PC: %04u).",
-                  mProcedure.mProcMgr->Name(mProcedure.mId),
-                  mCodePos);
-      }
-      throw;
-    }
+  case T_UINT16:
+    fused_self_update<OPCODE>(_SC(UInt16Operand&, dest), delta);
+    break;
+
+  case T_UINT32:
+    fused_self_update<OPCODE>(_SC(UInt32Operand&, dest), delta);
+    break;
+
+  case T_UINT64:
+    fused_self_update<OPCODE>(_SC(UInt64Operand&, dest), delta);
+    break;
+
+  default:
+    if (OPCODE == W_SADD)
+      dest.SelfAdd(delta);
+
+    else
+      dest.SelfSub(delta);
   }
 
-  assert(mAquiredSync == NO_INDEX);
+  return false;
 }
 
-void
-ProcedureCall::Run()
+
+//local = <arg>
+template <class T> static bool
+fused_store_arg(ProcedureCall& call, const DecodedInstruction& instr)
 {
-  W_OPCODE opcode;
+  T value;
 
-  try
+  fused_arg(call, instr, 1, value);
+  fused_store(call, instr, value);
+
+  return false;
+}
+
+
+//local = <arg> op <arg>
+template <uint_t OPCODE, class DBS_T, class T> static bool
+fused_binop_store(ProcedureCall& call, const DecodedInstruction& instr)
+{
+  DBS_T firstOp, secondOp, result;
+
+  fused_arg(call, instr, 1, firstOp);
+  if ( ! firstOp.IsNull())
   {
-    while (mCodePos < CodeSize())
+    fused_arg(call, instr, 2, secondOp);
+    if ( ! secondOp.IsNull())
     {
-      if (mSession.IsServerShoutdowing())
-        throw InterException(_EXTRA(InterException::SERVER_STOPPED));
+      if (OPCODE == W_ADD)
+        result = DBS_T(firstOp.mValue + secondOp.mValue);
 
-      int64_t offset = wh_compiler_decode_op(mCode + mCodePos, &opcode);
+      else if (OPCODE == W_SUB)
+        result = DBS_T(firstOp.mValue - secondOp.mValue);
 
-      assert(opcode < _SC(int, (sizeof operations / sizeof operations[0])));
-      assert(opcode != 0);
-      assert((offset > 0) && (offset < 3));
+      else
+        result = DBS_T(firstOp.mValue * secondOp.mValue);
+    }
+  }
 
-      operations[opcode]( *this, offset);
+  T value;
 
-      mCodePos += offset;
+  number_convert(result, value);
+  fused_store(call, instr, value);
 
-      assert((mCodePos <= CodeSize()) || (_SC(uint64_t, offset) == CodeSize()));
-    }
+  return false;
+}
 
-    if (mAquiredSync != NO_INDEX)
-      ReleaseSync(mAquiredSync);
+
+//<arg> cmp <arg>, followed by a jump that consumes the result.
+template <uint_t OPCODE, class DBS_T> static bool
+fused_compare_jump(ProcedureCall& call, const DecodedInstruction& instr)
+{
+  DBS_T firstOp, secondOp;
+  DBool result;
+
+  fused_arg(call, instr, 0, firstOp);
+  if ((OPCODE == W_EQ) || (OPCODE == W_NE))
+  {
+    fused_arg(call, instr, 1, secondOp);
+    result = DBool((firstOp == secondOp) == (OPCODE == W_EQ));
   }
-  catch (...)
+  else if ( ! firstOp.IsNull())
   {
-    if (mAquiredSync != NO_INDEX)
-      ReleaseSync(mAquiredSync);
+    fused_arg(call, instr, 1, secondOp);
+    if ( ! secondOp.IsNull())
+    {
+      switch (OPCODE)
+      {
+      case W_LT:
+      case W_LTU:
+        result = DBool(firstOp < secondOp);
+        break;
 
-    throw;
+      case W_LE:
+      case W_LEU:
+        result = DBool((firstOp < secondOp) || (firstOp == secondOp));
+        break;
+
+      case W_GT:
+      case W_GTU:
+        result = DBool(((firstOp < secondOp) || (firstOp == secondOp)) == false);
+        break;
+
+      default:
+        result = DBool((firstOp < secondOp) == false);
+      }
+    }
   }
 
-  //After a procedure execution, only the return value should be present
-  //on the stack
-  assert(mStack.Size() == (mStackBegin + 1));
+  return (result.IsNull() == false) && (result.mValue == (instr.mValue != 0));
 }
 
-void
-ProcedureCall::AquireSync(const uint8_t sync)
+
+template <class T> static FUSED_HANDLER
+store_handler()
 {
-  if (mAquiredSync != NO_INDEX)
-    throw InterException(_EXTRA(InterException::NEESTED_SYNC_REQ));
+  return fused_store_arg<T>;
+}
 
-  mProcedure.mProcMgr->AquireSync(mProcedure, sync);
-  mAquiredSync = sync;
+
+template <uint_t OPCODE, class DBS_T> static FUSED_HANDLER
+binop_store_handler(const uint_t stOpcode)
+{
+  switch (stOpcode)
+  {
+  case W_STI8:
+    return fused_binop_store<OPCODE, DBS_T, DInt8>;
+
+  case W_STI16:
+    return fused_binop_store<OPCODE, DBS_T, DInt16>;
+
+  case W_STI32:
+    return fused_binop_store<OPCODE, DBS_T, DInt32>;
+
+  case W_STI64:
+    return fused_binop_store<OPCODE, DBS_T, DInt64>;
+
+  case W_STUI8:
+    return fused_binop_store<OPCODE, DBS_T, DUInt8>;
+
+  case W_STUI16:
+    return fused_binop_store<OPCODE, DBS_T, DUInt16>;
+
+  case W_STUI32:
+    return fused_binop_store<OPCODE, DBS_T, DUInt32>;
+
+  case W_STUI64:
+    return fused_binop_store<OPCODE, DBS_T, DUInt64>;
+  }
+
+  return nullptr;
+}
+
+
+static FUSED_HANDLER
+store_handler(const uint_t stOpcode)
+{
+  switch (stOpcode)
+  {
+  case W_STI8:
+    return store_handler<DInt8>();
+
+  case W_STI16:
+    return store_handler<DInt16>();
+
+  case W_STI32:
+    return store_handler<DInt32>();
+
+  case W_STI64:
+    return store_handler<DInt64>();
+
+  case W_STUI8:
+    return store_handler<DUInt8>();
+
+  case W_STUI16:
+    return store_handler<DUInt16>();
+
+  case W_STUI32:
+    return store_handler<DUInt32>();
+
+  case W_STUI64:
+    return store_handler<DUInt64>();
+  }
+
+  return nullptr;
+}
+
+
+static FUSED_HANDLER
+binop_store_handler(const uint_t opcode, const uint_t stOpcode)
+{
+  switch (opcode)
+  {
+  case W_ADD:
+    return binop_store_handler<W_ADD, DInt64>(stOpcode);
+
+  case W_SUB:
+    return binop_store_handler<W_SUB, DInt64>(stOpcode);
+
+  case W_MUL:
+    return binop_store_handler<W_MUL, DInt64>(stOpcode);
+
+  case W_MULU:
+    return binop_store_handler<W_MULU, DUInt64>(stOpcode);
+  }
+
+  return nullptr;
+}
+
+
+static FUSED_HANDLER
+compare_handler(const uint_t opcode)
+{
+  switch (opcode)
+  {
+  case W_EQ:
+    return fused_compare_jump<W_EQ, DInt64>;
+
+  case W_NE:
+    return fused_compare_jump<W_NE, DInt64>;
+
+  case W_LT:
+    return fused_compare_jump<W_LT, DInt64>;
+
+  case W_LTU:
+    return fused_compare_jump<W_LTU, DUInt64>;
+
+  case W_LE:
+    return fused_compare_jump<W_LE, DInt64>;
+
+  case W_LEU:
+    return fused_compare_jump<W_LEU, DUInt64>;
+
+  case W_GT:
+    return fused_compare_jump<W_GT, DInt64>;
+
+  case W_GTU:
+    return fused_compare_jump<W_GTU, DUInt64>;
+
+  case W_GE:
+    return fused_compare_jump<W_GE, DInt64>;
+
+  case W_GEU:
+    return fused_compare_jump<W_GEU, DUInt64>;
+  }
+
+  return nullptr;
+}
+
+
+static uint8_t
+fused_local_type(const Procedure& procedure, const uint32_t local)
+{
+  //Parameters may hold references to the caller's values, so only the
+  //procedure's own locals have their types known in advance.
+  if ((local < procedure.mArgsCount) || (local + 1 >= procedure.mLocalsCount))
+    return FA_LOCAL;
+
+  const StackValue& value = procedure.mProcMgr->LocalValue(procedure.mId, local + 1);
+  const uint_t type = _CC(StackValue&, value).Operand().GetType();
+
+  if ((T_INT8 <= type) && (type <= T_UINT64))
+    return type;
+
+  return FA_LOCAL;
+}
+
+
+static bool
+fused_argument(const Procedure& procedure,
+               const DecodedInstruction& instr,
+               uint32_t& outArg,
+               uint8_t& outType)
+{
+  switch (instr.mKind)
+  {
+  case DK_LDI8:
+  case DK_LDI16:
+  case DK_LDI32:
+    outArg  = instr.mValue;
+    outType = FA_IMMEDIATE;
+    return true;
+
+  case DK_LDLO:
+    outArg  = instr.mValue;
+    outType = fused_local_type(procedure, outArg);
+    return true;
+  }
+
+  return false;
+}
+
+
+//Try to replace a sequence of instructions that starts at 'from' with a
+//fused one. Returns the count of the replaced instructions.
+static uint_t
+fuse_instructions(const Procedure& procedure,
+                  const DECODED_CODE& code,
+                  const size_t from,
+                  const vector<bool>& jumpTargets,
+                  DecodedInstruction& outInstr)
+{
+  static const uint_t MAX_FUSED = 6;
+
+  //Only the first instruction of a fused sequence may be a jump target.
+  uint_t count = 1;
+  while ((count < MAX_FUSED)
+         && (from + count < code.size())
+         && (jumpTargets[code[from + count].mCodePos] == false))
+  {
+    ++count;
+  }
+
+  if (count < 4)
+    return 0;
+
+  const DecodedInstruction* const instrs = &code[from];
+
+  outInstr = instrs[0];
+  outInstr.mHandler = nullptr;
+
+  if ( ! fused_argument(procedure, instrs[0], outInstr.mArgs[0], outInstr.mArgTypes[0])
+      || ! fused_argument(procedure, instrs[1], outInstr.mArgs[1], outInstr.mArgTypes[1]))
+  {
+    return 0;
+  }
+
+  const bool isLocalDest = (instrs[0].mKind == DK_LDLO);
+  //The typed operators compute the same values as their generic forms.
+  const uint_t opcode = (instrs[2].mKind == DK_GENERIC)
+                        ? wh_compiler_untyped_op(_SC(W_OPCODE, instrs[2].mOpcode))
+                        : W_NA;
+
+  if (((instrs[3].mKind == DK_JFC) || (instrs[3].mKind == DK_JTC))
+      && (compare_handler(opcode) != nullptr))
+  {
+    outInstr.mKind         = DK_FUSED_JUMP;
+    outInstr.mFusedHandler = compare_handler(opcode);
+    outInstr.mValue        = (instrs[3].mKind == DK_JTC);
+    outInstr.mTarget       = instrs[3].mTarget;
+    outInstr.mLength       = instrs[0].mLength + instrs[1].mLength
+                             + instrs[2].mLength + instrs[3].mLength;
+    return 4;
+  }
+
+  const bool popsDest = (instrs[3].mKind == DK_CTS) && (instrs[3].mValue == 1);
+
+  if (isLocalDest && popsDest && ((opcode == W_SADD) || (opcode == W_SSUB)))
+  {
+    outInstr.mKind         = DK_FUSED;
+    outInstr.mFusedHandler = (opcode == W_SADD) ? fused_self_op<W_SADD> : fused_self_op<W_SSUB>;
+    outInstr.mLength       = instrs[0].mLength + instrs[1].mLength
+                             + instrs[2].mLength + instrs[3].mLength;
+    return 4;
+  }
+
+  if (isLocalDest && popsDest && (store_handler(opcode) != nullptr))
+  {
+    outInstr.mKind         = DK_FUSED;
+    outInstr.mFusedHandler = store_handler(opcode);
+    outInstr.mLength       = instrs[0].mLength + instrs[1].mLength
+                             + instrs[2].mLength + instrs[3].mLength;
+    return 4;
+  }
+
+  if ( ! isLocalDest
+      || (count < 6)
+      || ! fused_argument(procedure, instrs[2], outInstr.mArgs[2], outInstr.mArgTypes[2])
+      || (instrs[3].mKind != DK_GENERIC)
+      || (instrs[4].mKind != DK_GENERIC)
+      || (instrs[5].mKind != DK_CTS)
+      || (instrs[5].mValue != 1))
+  {
+    return 0;
+  }
+
+  const FUSED_HANDLER handler = binop_store_handler(
+                                  wh_compiler_untyped_op(_SC(W_OPCODE, instrs[3].mOpcode)),
+                                  instrs[4].mOpcode
+                                );
+  if (handler == nullptr)
+    return 0;
+
+  outInstr.mKind         = DK_FUSED;
+  outInstr.mFusedHandler = handler;
+  outInstr.mLength       = instrs[0].mLength + instrs[1].mLength + instrs[2].mLength
+                           + instrs[3].mLength + instrs[4].mLength + instrs[5].mLength;
+  return 6;
+}
+
+
+void
+ProcedureCall::InlinedPositions(const Procedure& procedure,
+                                const uint8_t* const code,
+                                Session& session,
+                                vector<bool>& outInlined)
+{
+  DECODED_CODE instructions;
+
+  DecodeCode(procedure, code, session, instructions);
+
+  outInlined.assign(procedure.mCodeSize + 1, false);
+  for (auto& instr : instructions)
+  {
+    if (instr.mKind == DK_GENERIC)
+      continue;
+
+    for (uint32_t pos = instr.mCodePos; pos < instr.mCodePos + instr.mLength; ++pos)
+      outInlined[pos] = true;
+  }
+}
+
+
+uint_t
+ProcedureCall::InstructionSize(const uint8_t* const code)
+{
+  W_OPCODE opcode;
+
+  const uint_t opLength = wh_compiler_decode_op(code, &opcode);
+
+  return opLength + opcode_args_size(opcode);
+}
+
+
+bool ProcedureCall::smUseDecodedCode = true;
+
+
+void
+ProcedureCall::DecodeCode(const Procedure& procedure,
+                          const uint8_t* const code,
+                          Session& session,
+                          DECODED_CODE& outInstructions)
+{
+  assert(procedure.mUnit != nullptr);
+
+  const uint32_t codeSize = procedure.mCodeSize;
+
+  DECODED_CODE instructions;
+  vector<bool> jumpTargets(codeSize + 1, false);
+
+  uint32_t codePos = 0;
+  while (codePos < codeSize)
+  {
+    W_OPCODE opcode;
+    const uint_t opLength = wh_compiler_decode_op(code + codePos, &opcode);
+
+    DecodedInstruction instr{};
+
+    instr.mCodePos  = codePos;
+    instr.mKind     = DK_INVALID;
+    instr.mOpcode   = opcode;
+    instr.mOpLength = opLength;
+    instr.mLength   = opLength;
+
+    //Whatever follows an invalid instruction cannot be decoded (e.g. some
+    //garbage left after the last return). Fail only if it is reached.
+    if ((opcode == W_NA) || (opcode >= W_OP_END_MARK))
+    {
+      instructions.push_back(instr);
+      break;
+    }
+
+    const uint_t argsSize = opcode_args_size(opcode);
+    if (codePos + opLength + argsSize > codeSize)
+    {
+      instructions.push_back(instr);
+      break;
+    }
+
+    instr.mHandler = operations[opcode];
+    instr.mLength  = opLength + argsSize;
+    instr.mKind    = DK_GENERIC;
+
+    try
+    {
+      resolve_instruction(session, *procedure.mUnit, code + codePos + opLength, instr);
+    }
+    catch (InterException&)
+    {
+      //Let the handler complain about the bad reference when executed.
+      instr.mKind  = DK_GENERIC;
+      instr.mValue = 0;
+    }
+
+    if ((DK_JF <= instr.mKind) && (instr.mKind <= DK_JMP))
+    {
+      const int64_t target = _SC(int64_t, codePos) + _SC(int64_t, instr.mValue);
+
+      if ((target < 0) || (target > codeSize))
+        instr.mKind = DK_INVALID;
+
+      else
+      {
+        instr.mTarget = target;
+        jumpTargets[target] = true;
+      }
+    }
+
+    instructions.push_back(instr);
+    codePos += instr.mLength;
+  }
+
+  outInstructions.clear();
+  for (size_t i = 0; i < instructions.size(); )
+  {
+    DecodedInstruction fused;
+    const uint_t fusedCount = fuse_instructions(procedure, instructions, i, jumpTargets, fused);
+
+    if (fusedCount > 0)
+    {
+      outInstructions.push_back(fused);
+      i += fusedCount;
+    }
+    else
+      outInstructions.push_back(instructions[i++]);
+  }
+
+  DecodedInstruction end{};
+
+  end.mCodePos  = codeSize;
+  end.mKind     = DK_END;
+  end.mOpcode   = W_NA;
+
+  outInstructions.push_back(end);
+
+  //Jumps get the index of their target instruction instead of its position.
+  vector<uint32_t> instrIndexes(codeSize + 1, INVALID_INSTRUCTION);
+  for (uint32_t i = 0; i < outInstructions.size(); ++i)
+  {
+    instrIndexes[outInstructions[i].mCodePos] = i;
+
+    //The caller has nothing left to do after such a call, so the called
+    //procedure may take its place.
+    if ((outInstructions[i].mKind == DK_CALL) && (outInstructions[i + 1].mKind == DK_RET))
+      outInstructions[i].mKind = DK_TAIL_CALL;
+  }
+
+  for (auto& instr : outInstructions)
+  {
+    if ((instr.mKind != DK_FUSED_JUMP)
+        && ((instr.mKind < DK_JF) || (instr.mKind > DK_JMP)))
+    {
+      continue;
+    }
+
+    if (instrIndexes[instr.mTarget] == INVALID_INSTRUCTION)
+      instr.mKind = DK_INVALID;
+
+    else
+      instr.mTarget = instrIndexes[instr.mTarget];
+  }
+}
+
+
+
+static void
+add_call_trace(Exception& e, const Procedure& procedure, const uint32_t codePos)
+{
+  const std::string message = e.Message();
+
+  if ( !message.empty())
+  {
+    e.Message("%s\n\tCalled from '%s' (PC: %04u).",
+              message.c_str(),
+              procedure.mProcMgr->Name(procedure.mId),
+              codePos);
+  }
+  else
+  {
+    e.Message("Current procedure '%s'(PC: %04u).",
+              procedure.mProcMgr->Name(procedure.mId),
+              codePos);
+  }
+}
+
+
+ProcedureCall::ProcedureCall(Session& session, SessionStack& stack, const Procedure& procedure)
+  : mProcedure(&procedure),
+    mSession(session),
+    mStack(stack),
+    mCode(procedure.mNativeCode
+           ? nullptr
+           : procedure.mProcMgr->Code(procedure, nullptr)),
+    mInstructions(nullptr),
+    mDecoded(),
+    mResumeIp(nullptr),
+    mStackBegin(stack.Size() - procedure.mArgsCount),
+    mCodePos(0),
+    mTimeSlice(0),
+    mSuspendReason(NOT_SUSPENDED),
+    mAquiredSync(NO_INDEX),
+    mWaitedSync(NO_INDEX),
+    mSuspendable(false),
+    mEnded(false),
+    mFrames(),
+    mFieldAccesses(),
+    mProfile(),
+    mSyncWaiter(),
+    mProfileCounts(nullptr)
+{
+  if (procedure.mNativeCode != nullptr)
+  {
+    RunNative();
+    return;
+  }
+
+  procedure.mProcMgr->VerifyChanged(procedure, session);
+  PrepareLocals();
+
+  //The profile is collected from the procedures' original code.
+  if (smUseDecodedCode && ! OpcodeProfile::IsEnabled())
+  {
+    mDecoded      = procedure.mProcMgr->Instructions(procedure, session);
+    mInstructions = &mDecoded->front();
+
+    if (ProcedureProfile::IsEnabled())
+      StartProfile(mDecoded);
+  }
+
+  try
+  {
+    Resume();
+  }
+  catch (...)
+  {
+    //The destructor is not called when the constructor fails, and the
+    //cached accesses would keep the tables of the call referenced.
+    ReleaseFieldAccesses();
+    throw;
+  }
+
+  assert(mEnded);
+  assert(mAquiredSync == NO_INDEX);
+}
+
+
+ProcedureCall::ProcedureCall(Session& session,
+                             SessionStack& stack,
+                             const Procedure& procedure,
+                             const uint32_t timeSlice)
+  : mProcedure(&procedure),
+    mSession(session),
+    mStack(stack),
+    mCode(procedure.mNativeCode
+           ? nullptr
+           : procedure.mProcMgr->Code(procedure, nullptr)),
+    mInstructions(nullptr),
+    mDecoded(),
+    mResumeIp(nullptr),
+    mStackBegin(stack.Size() - procedure.mArgsCount),
+    mCodePos(0),
+    mTimeSlice(timeSlice),
+    mSuspendReason(NOT_SUSPENDED),
+    mAquiredSync(NO_INDEX),
+    mWaitedSync(NO_INDEX),
+    mSuspendable(true),
+    mEnded(false),
+    mFrames(),
+    mFieldAccesses(),
+    mProfile(),
+    mSyncWaiter(),
+    mProfileCounts(nullptr)
+{
+  if (procedure.mNativeCode != nullptr)
+    return;
+
+  procedure.mProcMgr->VerifyChanged(procedure, session);
+  PrepareLocals();
+
+  //The profile is collected from the procedures' original code.
+  if (smUseDecodedCode && ! OpcodeProfile::IsEnabled())
+  {
+    mDecoded      = procedure.mProcMgr->Instructions(procedure, session);
+    mInstructions = &mDecoded->front();
+
+    if (ProcedureProfile::IsEnabled())
+      StartProfile(mDecoded);
+  }
+}
+
+
+ProcedureCall::~ProcedureCall()
+{
+  ReleaseFieldAccesses();
+
+  if (mEnded)
+    return;
+
+  //A call abandoned before its end must not keep the synchronisation
+  //statements it has entered.
+  try
+  {
+    if (mProfile)
+      mProfile->Continue();
+
+    //Leave the queue of the statement it was suspended for, before going
+    //back from the procedure it is part of.
+    if (mWaitedSync != NO_INDEX)
+      mProcedure->mProcMgr->WithdrawSync( *mProcedure, mWaitedSync, *mSyncWaiter);
+
+    UnwindFrames(nullptr);
+
+    if (mAquiredSync != NO_INDEX)
+      ReleaseSync(mAquiredSync);
+
+    if (mProfile)
+      mProfile->Flush();
+  }
+  catch (...)
+  {
+    assert(false);
+  }
+}
+
+
+FieldAccessReference&
+ProcedureCall::AccessField(const uint8_t* const site,
+                           TableReference& tableRef,
+                           const char* const fieldName)
+{
+  FieldAccessSlot& slot = mFieldAccesses[_RC(uintptr_t, site) % FIELD_ACCESS_SLOTS];
+
+  if ((slot.mSite == site)
+      && ( &slot.mAccess->GetTableReference() == &tableRef))
+  {
+    return *slot.mAccess;
+  }
+
+  const FIELD_INDEX field = tableRef.GetTable().RetrieveField(fieldName);
+  FieldAccessReference* const access = new FieldAccessReference(tableRef, field);
+
+  access->IncrementRefCount();
+
+  if (slot.mAccess != nullptr)
+    slot.mAccess->DecrementRefCount();
+
+  slot.mSite = site;
+  slot.mAccess = access;
+
+  return *access;
+}
+
+
+void
+ProcedureCall::ReleaseFieldAccesses()
+{
+  for (auto& slot : mFieldAccesses)
+  {
+    if (slot.mAccess != nullptr)
+      slot.mAccess->DecrementRefCount();
+
+    slot.mSite = nullptr;
+    slot.mAccess = nullptr;
+  }
+}
+
+
+bool
+ProcedureCall::Resume()
+{
+  if (mEnded)
+    return true;
+
+  if (mProcedure->mNativeCode != nullptr)
+  {
+    RunNative();
+    return true;
+  }
+
+  mSuspendReason = NOT_SUSPENDED;
+
+  try
+  {
+    Run();
+  }
+  catch (Exception& e)
+  {
+    mEnded = true;
+    add_call_trace(e, *mProcedure, mCodePos);
+    throw;
+  }
+  catch (...)
+  {
+    mEnded = true;
+    throw;
+  }
+
+  if (mSuspendReason != NOT_SUSPENDED)
+    return false;
+
+  mEnded = true;
+
+  assert(mAquiredSync == NO_INDEX);
+  return true;
+}
+
+
+void
+ProcedureCall::RunNative()
+{
+  const Procedure& procedure = *mProcedure;
+
+  mEnded = true;
+
+  const WLIB_STATUS status = procedure.mNativeCode(mStack, mSession);
+  if (status != WOP_OK)
+  {
+    throw InterException(_EXTRA(InterException::NATIVE_CALL_FAILED),
+                         "Native procedure '%s' execution returned unexpected error code '%d'.",
+                         procedure.mProcMgr->Name(procedure.mId),
+                         status);
+  }
+
+  if (mStack.Size() != mStackBegin + 1)
+  {
+    throw InterException(_EXTRA(InterException::STACK_CORRUPTED),
+                         "Stack corruption detected after native procedure '%s' execution.",
+                         procedure.mProcMgr->Name(procedure.mId));
+  }
+}
+
+
+//How many temporary values a procedure's expressions are expected to need.
+static const size_t STACK_TEMP_VALUES = 16;
+
+
+void
+ProcedureCall::PrepareLocals()
+{
+  if (mStack.Size() + LocalsCount() > mSession.MaxStackCount())
+  {
+    throw InterException(_EXTRA(InterException::STACK_TOO_BIG),
+                         "Failed to call procedure '%s' as it will exceed the maximum stack "
+                         "count of %u elements limit.",
+                         mProcedure->mProcMgr->Name(mProcedure->mId),
+                         mSession.MaxStackCount());
+  }
+
+  //Make room for the procedure's locals and for a few of its temporary values
+  //at once, growing the stack at the same pace as it would do by itself.
+  const size_t needed = mStack.Size() + LocalsCount() + STACK_TEMP_VALUES;
+  if (needed > mStack.Capacity())
+    mStack.Reserve(max(needed, 2 * mStack.Capacity()));
+
+  //Fill the stack with default values for the local values(don't
+  //include the arguments as they should be on the stack already and the
+  uint32_t local = mProcedure->mArgsCount + 1;
+  if ((local < LocalsCount()) && mProcedure->mPlainLocals)
+    mStack.PushPlain(&GetLocalDefault(local), LocalsCount() - local);
+
+  else if (local < LocalsCount())
+  {
+    const StackValue *localValue = &GetLocalDefault(local);
+    while (local < LocalsCount())
+    {
+      StackValue defaultValue(*localValue);
+      if (IS_TABLE(defaultValue.Operand().GetType())) defaultValue.Operand().GetTable();
+
+      mStack.Push(move(defaultValue));
+      ++local, ++localValue;
+    }
+  }
+
+  //Count only procedure's parameters and local values,
+  //but not the result value too.
+  if (LocalsCount() - 1 > mStack.Size())
+  {
+    throw InterException(_EXTRA(InterException::STACK_CORRUPTED),
+                         "Stack corruption detected after procedure '%s' execution.",
+                         mProcedure->mProcMgr->Name(mProcedure->mId));
+  }
+}
+
+
+void
+ProcedureCall::StartProfile(const SHARED_DECODED_CODE& instructions)
+{
+  mProfile.reset(new CallProfile());
+  mProfileCounts = mProfile->Enter( *mProcedure, instructions);
+}
+
+
+void
+ProcedureCall::EnterProcedure(const Procedure& procedure,
+                              const DecodedInstruction* const returnIp)
+{
+  assert(procedure.mNativeCode == nullptr);
+
+  mFrames.push_back(CallFrame{
+                               mProcedure,
+                               mCode,
+                               mInstructions,
+                               returnIp,
+                               mStackBegin,
+                               mAquiredSync,
+                               move(mDecoded)
+                             });
+
+  mProcedure   = &procedure;
+  mCode        = procedure.mProcMgr->Code(procedure, nullptr);
+  mStackBegin  = mStack.Size() - procedure.mArgsCount;
+  mCodePos     = 0;
+  mAquiredSync = NO_INDEX;
+
+  try
+  {
+    PrepareLocals();
+
+    mDecoded      = procedure.mProcMgr->Instructions(procedure, mSession);
+    mInstructions = &mDecoded->front();
+  }
+  catch (...)
+  {
+    //Report the failure as the caller's, like the call never happened.
+    CallFrame& frame = mFrames.back();
+
+    mProcedure    = frame.mProcedure;
+    mCode         = frame.mCode;
+    mInstructions = frame.mInstructions;
+    mStackBegin   = frame.mStackBegin;
+    mAquiredSync  = frame.mAquiredSync;
+    mDecoded      = move(frame.mDecoded);
+
+    mFrames.pop_back();
+    throw;
+  }
+
+  if (mProfile)
+    mProfileCounts = mProfile->Enter(procedure, mDecoded);
+}
+
+
+bool
+ProcedureCall::ReplaceFrame(const Procedure& procedure)
+{
+  assert(procedure.mNativeCode == nullptr);
+  assert(mAquiredSync == NO_INDEX);
+
+  const size_t stackSize  = mStack.Size();
+  const size_t argsBegin  = stackSize - procedure.mArgsCount;
+
+  //The arguments may not refer to the values about to be discarded.
+  for (size_t arg = argsBegin; arg < stackSize; ++arg)
+  {
+    uint64_t index;
+    if (_SC(BaseOperand&, mStack.At(arg).Operand()).StackReference(index)
+        && (index >= mStackBegin))
+    {
+      return false;
+    }
+  }
+
+  if (argsBegin > mStackBegin)
+  {
+    for (uint_t arg = 0; arg < procedure.mArgsCount; ++arg)
+      mStack.At(mStackBegin + arg) = move(mStack.At(argsBegin + arg));
+
+    mStack.Drop(stackSize - (mStackBegin + procedure.mArgsCount));
+  }
+
+  mProcedure   = &procedure;
+  mCode        = procedure.mProcMgr->Code(procedure, nullptr);
+  mCodePos     = 0;
+
+  PrepareLocals();
+
+  mDecoded      = procedure.mProcMgr->Instructions(procedure, mSession);
+  mInstructions = &mDecoded->front();
+
+  if (mProfile)
+  {
+    mProfile->Leave();
+    mProfileCounts = mProfile->Enter(procedure, mDecoded);
+  }
+
+  return true;
+}
+
+
+const DecodedInstruction*
+ProcedureCall::LeaveProcedure()
+{
+  if (mAquiredSync != NO_INDEX)
+    ReleaseSync(mAquiredSync);
+
+  if (mProfile)
+    mProfileCounts = mProfile->Leave();
+
+  if (mFrames.empty())
+    return nullptr;
+
+  CallFrame& frame = mFrames.back();
+  const DecodedInstruction* const result = frame.mReturn;
+
+  mProcedure    = frame.mProcedure;
+  mCode         = frame.mCode;
+  mInstructions = frame.mInstructions;
+  mStackBegin   = frame.mStackBegin;
+  mAquiredSync  = frame.mAquiredSync;
+  mDecoded      = move(frame.mDecoded);
+
+  mFrames.pop_back();
+
+  return result;
+}
+
+
+void
+ProcedureCall::UnwindFrames(Exception* const e)
+{
+  //Enough to follow a failure but not too much to slow down its report
+  //from deep recursive calls.
+  static const uint_t MAX_TRACED_CALLS = 32;
+
+  uint_t unwoundCalls = 0;
+
+  //Leave the calls in progress as their nested constructions used to do,
+  //except for the first one, which is left to the constructor.
+  while ( ! mFrames.empty())
+  {
+    if (mAquiredSync != NO_INDEX)
+    {
+      mProcedure->mProcMgr->ReleaseSync( *mProcedure, mAquiredSync);
+      mAquiredSync = NO_INDEX;
+    }
+
+    if ((e != nullptr) && (unwoundCalls++ < MAX_TRACED_CALLS))
+      add_call_trace( *e, *mProcedure, mCodePos);
+
+    if (mProfile)
+      mProfileCounts = mProfile->Leave();
+
+    CallFrame& frame = mFrames.back();
+
+    mProcedure    = frame.mProcedure;
+    mCode         = frame.mCode;
+    mInstructions = frame.mInstructions;
+    mStackBegin   = frame.mStackBegin;
+    mAquiredSync  = frame.mAquiredSync;
+    mDecoded      = move(frame.mDecoded);
+    mCodePos      = (frame.mReturn - 1)->mCodePos;
+
+    mFrames.pop_back();
+  }
+
+  if ((e != nullptr) && (unwoundCalls > MAX_TRACED_CALLS))
+  {
+    const std::string message = e->Message();
+
+    e->Message("%s\n\t... %u more calls.",
+               message.c_str(),
+               unwoundCalls - MAX_TRACED_CALLS);
+  }
+}
+
+
+void
+ProcedureCall::Run()
+{
+  W_OPCODE opcode;
+
+  try
+  {
+    if (mInstructions != nullptr)
+    {
+      RunDecoded();
+
+      //Keep the synchronisation statement entered until the call is resumed.
+      if (mSuspendReason != NOT_SUSPENDED)
+        return;
+
+      if (mProfile)
+        mProfile->Flush();
+    }
+    else
+    {
+      vector<uint64_t> counts;
+
+      if (OpcodeProfile::IsEnabled())
+        counts.resize(CodeSize(), 0);
+
+      while (mCodePos < CodeSize())
+      {
+        if (mSession.IsServerShoutdowing())
+          throw InterException(_EXTRA(InterException::SERVER_STOPPED));
+
+        int64_t offset = wh_compiler_decode_op(mCode + mCodePos, &opcode);
+
+        assert(opcode < _SC(int, (sizeof operations / sizeof operations[0])));
+        assert(opcode != 0);
+        assert((offset > 0) && (offset < 3));
+
+        if ( ! counts.empty())
+          ++counts[mCodePos];
+
+        operations[opcode]( *this, offset);
+
+        mCodePos += offset;
+
+        assert((mCodePos <= CodeSize()) || (_SC(uint64_t, offset) == CodeSize()));
+      }
+
+      if ( ! counts.empty())
+        OpcodeProfile::Record( *mProcedure, mCode, mSession, counts);
+    }
+
+    if (mAquiredSync != NO_INDEX)
+      ReleaseSync(mAquiredSync);
+  }
+  catch (...)
+  {
+    if (mAquiredSync != NO_INDEX)
+      ReleaseSync(mAquiredSync);
+
+    if (mProfile)
+      mProfile->Flush();
+
+    throw;
+  }
+
+  //After a procedure execution, only the return value should be present
+  //on the stack
+  assert(mStack.Size() == (mStackBegin + 1));
+}
+
+
+#if defined(__GNUC__)
+#define WH_THREADED_DISPATCH      1
+#define DECODED_CASE(kind)        label_##kind
+#define DECODED_NEXT()            goto *dispatch[ip->mKind]
+#else
+#define WH_THREADED_DISPATCH      0
+#define DECODED_CASE(kind)        case kind
+#define DECODED_NEXT()            continue
+#endif
+
+void
+ProcedureCall::RunDecoded()
+{
+  const DecodedInstruction* ip = (mResumeIp != nullptr) ? mResumeIp : mInstructions;
+
+  //The loops are charged with their body's length on every backward jump
+  //and the calls with a fixed cost, so the instructions are not counted
+  //one by one.
+  int64_t budget = (mTimeSlice != 0) ? mTimeSlice : _SC(int64_t, ~0ull >> 1);
+
+  mResumeIp = nullptr;
+
+  if (mProfile)
+    mProfile->Continue();
+
+  try
+  {
+#if WH_THREADED_DISPATCH
+    static const void* const labels[DK_COUNT] = {
+                                                  &&label_DK_GENERIC,
+                                                  &&label_DK_LDNULL,
+                                                  &&label_DK_LDC,
+                                                  &&label_DK_LDI8,
+                                                  &&label_DK_LDI16,
+                                                  &&label_DK_LDI32,
+                                                  &&label_DK_LDI64,
+                                                  &&label_DK_LDT,
+                                                  &&label_DK_LDBT,
+                                                  &&label_DK_LDBF,
+                                                  &&label_DK_LDLO,
+                                                  &&label_DK_LDGB,
+                                                  &&label_DK_CTS,
+                                                  &&label_DK_CALL,
+                                                  &&label_DK_TAIL_CALL,
+                                                  &&label_DK_RET,
+                                                  &&label_DK_JF,
+                                                  &&label_DK_JFC,
+                                                  &&label_DK_JT,
+                                                  &&label_DK_JTC,
+                                                  &&label_DK_JMP,
+                                                  &&label_DK_BSYNC,
+                                                  &&label_DK_ESYNC,
+                                                  &&label_DK_FUSED,
+                                                  &&label_DK_FUSED_JUMP,
+                                                  &&label_DK_INVALID,
+                                                  &&label_DK_END
+                                                };
+
+    //When profiled, every instruction goes first through the counting.
+    const void* profiledLabels[DK_COUNT];
+    const void* const* dispatch = labels;
+
+    if (mProfile)
+    {
+      for (auto& label : profiledLabels)
+        label = &&label_profile;
+
+      dispatch = profiledLabels;
+    }
+
+    DECODED_NEXT();
+
+  label_profile:
+    ++mProfileCounts[ip - mInstructions];
+    goto *labels[ip->mKind];
+#else
+    while (true)
+    {
+      if (mProfile)
+        ++mProfileCounts[ip - mInstructions];
+
+      switch (ip->mKind)
+      {
+#endif
+
+    DECODED_CASE(DK_GENERIC):
+      {
+        int64_t offset = ip->mOpLength;
+
+        mCodePos = ip->mCodePos;
+        ip->mHandler( *this, offset);
+
+        assert(offset == ip->mLength);
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDNULL):
+      {
+        assert(ip->mValue != 0);
+
+        for (uint64_t i = 0; i < ip->mValue; ++i)
+          mStack.Push();
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDC):
+      {
+        mStack.Push(DChar(_SC(uint32_t, ip->mValue)));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDI8):
+      {
+        mStack.Push(DUInt8(_SC(uint8_t, ip->mValue)));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDI16):
+      {
+        mStack.Push(DUInt16(_SC(uint16_t, ip->mValue)));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDI32):
+      {
+        mStack.Push(DUInt32(_SC(uint32_t, ip->mValue)));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDI64):
+      {
+        mStack.Push(DUInt64(ip->mValue));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDT):
+      {
+        assert(ip->mData != nullptr);
+
+        mStack.Push(DText(ip->mData));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDBT):
+      {
+        mStack.Push(DBool(true));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDBF):
+      {
+        mStack.Push(DBool(false));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDLO):
+      {
+        assert(mStackBegin + ip->mValue < mStack.Size());
+
+        LocalOperand localOp(mStack, mStackBegin + ip->mValue);
+
+        mStack.Push(StackValue(localOp));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_LDGB):
+      {
+        StackValue glbValue = mSession.GetGlobalValue(_SC(uint32_t, ip->mValue));
+
+        mStack.Push(move(glbValue));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_CTS):
+      {
+        assert((mStackBegin + LocalsCount()) <= mStack.Size());
+
+        mStack.Drop(ip->mValue);
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_CALL):
+      {
+        goto run_call;
+      }
+
+    DECODED_CASE(DK_TAIL_CALL):
+      {
+        const Procedure& procedure = *ip->mProcedure;
+
+        if ((procedure.mNativeCode != nullptr) || (mAquiredSync != NO_INDEX))
+          goto run_call;
+
+        mCodePos = ip->mCodePos;
+
+        if (mSession.IsServerShoutdowing())
+          throw InterException(_EXTRA(InterException::SERVER_STOPPED));
+
+        if ( ! ReplaceFrame(procedure))
+          goto run_call;
+
+        ip = mInstructions;
+
+        if ((budget -= CALL_COST) <= 0)
+          goto run_slice_end;
+
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_RET):
+      {
+        int64_t offset = ip->mOpLength;
+
+        mCodePos = ip->mCodePos;
+        op_func_ret( *this, offset);
+
+        goto run_return;
+      }
+
+    DECODED_CASE(DK_JF):
+      {
+        DBool firstOp;
+        mStack.At(mStack.Size() - 1).Operand().GetValue(firstOp);
+
+        if ((firstOp.IsNull() == false) && (firstOp.mValue == false))
+          goto run_jump;
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_JFC):
+      {
+        DBool firstOp;
+        mStack.At(mStack.Size() - 1).Operand().GetValue(firstOp);
+        mStack.Drop(1);
+
+        if ((firstOp.IsNull() == false) && (firstOp.mValue == false))
+          goto run_jump;
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_JT):
+      {
+        DBool firstOp;
+        mStack.At(mStack.Size() - 1).Operand().GetValue(firstOp);
+
+        if ((firstOp.IsNull() == false) && firstOp.mValue)
+          goto run_jump;
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_JTC):
+      {
+        DBool firstOp;
+        mStack.At(mStack.Size() - 1).Operand().GetValue(firstOp);
+        mStack.Drop(1);
+
+        if ((firstOp.IsNull() == false) && firstOp.mValue)
+          goto run_jump;
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_JMP):
+      {
+        goto run_jump;
+      }
+
+    DECODED_CASE(DK_BSYNC):
+      {
+        mCodePos = ip->mCodePos;
+
+        if ( ! mSuspendable)
+          AquireSync(_SC(uint8_t, ip->mValue));
+
+        else if ( ! QueueSync(_SC(uint8_t, ip->mValue)))
+        {
+          //Check again from this instruction when resumed.
+          mSuspendReason = SYNC_WAIT;
+          goto run_suspend;
+        }
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_ESYNC):
+      {
+        mCodePos = ip->mCodePos;
+        ReleaseSync(_SC(uint8_t, ip->mValue));
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_FUSED):
+      {
+        ip->mFusedHandler( *this, *ip);
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_FUSED_JUMP):
+      {
+        if (ip->mFusedHandler( *this, *ip))
+          goto run_jump;
+
+        ++ip;
+        DECODED_NEXT();
+      }
+
+    DECODED_CASE(DK_INVALID):
+      {
+        throw InterException(_EXTRA(InterException::INVALID_OP_REQ),
+                             "Cannot execute the instruction with opcode %u.",
+                             _SC(uint_t, ip->mOpcode));
+      }
+
+    DECODED_CASE(DK_END):
+      {
+        goto run_return;
+      }
+
+    run_call:
+      {
+        const Procedure& procedure = *ip->mProcedure;
+
+        mCodePos = ip->mCodePos;
+
+        if (mSession.IsServerShoutdowing())
+          throw InterException(_EXTRA(InterException::SERVER_STOPPED));
+
+        //Only the native procedures are still run by a nested call.
+        if ((procedure.mNativeCode != nullptr) && mProfile)
+        {
+          mProfile->Enter(procedure, nullptr);
+
+          try
+          {
+            ProcedureCall(mSession, mStack, procedure);
+          }
+          catch (...)
+          {
+            mProfile->Leave();
+            throw;
+          }
+
+          mProfileCounts = mProfile->Leave();
+          ++ip;
+        }
+        else if (procedure.mNativeCode != nullptr)
+        {
+          ProcedureCall(mSession, mStack, procedure);
+
+          ++ip;
+        }
+        else
+        {
+          EnterProcedure(procedure, ip + 1);
+
+          ip = mInstructions;
+        }
+
+        if ((budget -= CALL_COST) <= 0)
+          goto run_slice_end;
+
+        DECODED_NEXT();
+      }
+
+    run_return:
+      {
+        ip = LeaveProcedure();
+        if (ip == nullptr)
+          goto run_end;
+
+        DECODED_NEXT();
+      }
+
+    run_jump:
+      {
+        const DecodedInstruction* const target = mInstructions + ip->mTarget;
+
+        //Check for the server shutdown only on loops, not on every instruction.
+        if (target <= ip)
+        {
+          if (mSession.IsServerShoutdowing())
+            throw InterException(_EXTRA(InterException::SERVER_STOPPED));
+
+          budget -= (ip - target) + 1;
+        }
+
+        ip = target;
+
+        if (budget <= 0)
+          goto run_slice_end;
+
+        DECODED_NEXT();
+      }
+
+    run_slice_end:
+      {
+        mSuspendReason = TIME_SLICE_ENDED;
+        goto run_suspend;
+      }
+
+    run_suspend:
+      {
+        mResumeIp = ip;
+        mCodePos  = ip->mCodePos;
+
+        if (mProfile)
+          mProfile->Pause();
+
+        return;
+      }
+
+#if ! WH_THREADED_DISPATCH
+      default:
+        assert(false);
+        throw InterException(_EXTRA(InterException::INTERNAL_ERROR));
+      }
+    }
+#endif
+  }
+  catch (Exception& e)
+  {
+    mCodePos = ip->mCodePos;
+    UnwindFrames( &e);
+    throw;
+  }
+  catch (...)
+  {
+    mCodePos = ip->mCodePos;
+    UnwindFrames(nullptr);
+    throw;
+  }
+
+run_end:
+  mCodePos = CodeSize();
+}
+
+#undef DECODED_NEXT
+#undef DECODED_CASE
+#undef WH_THREADED_DISPATCH
+
+void
+ProcedureCall::AquireSync(const uint8_t sync)
+{
+  if (mAquiredSync != NO_INDEX)
+    throw InterException(_EXTRA(InterException::NEESTED_SYNC_REQ));
+
+  const uint_t timeout = mSession.SyncWaitTimeout();
+  if ( ! mProcedure->mProcMgr->AquireSync( *mProcedure, sync, timeout))
+  {
+    throw InterException(_EXTRA(InterException::SYNC_WAIT_TIMEOUT),
+                         "Could not enter the synchronized statement %u of procedure '%s' "
+                         "in %u ms.",
+                         _SC(uint_t, sync),
+                         mProcedure->mProcMgr->Name(mProcedure->mId),
+                         timeout);
+  }
+  mAquiredSync = sync;
+}
+
+
+bool
+ProcedureCall::QueueSync(const uint8_t sync)
+{
+  if (mWaitedSync == NO_INDEX)
+  {
+    if (mAquiredSync != NO_INDEX)
+      throw InterException(_EXTRA(InterException::NEESTED_SYNC_REQ));
+
+    if ( ! mSyncWaiter)
+      mSyncWaiter.reset(new SyncStatement::Waiter());
+
+    if (mProcedure->mProcMgr->EnqueueSync( *mProcedure, sync, *mSyncWaiter))
+    {
+      mAquiredSync = sync;
+      return true;
+    }
+
+    mWaitedSync = sync;
+  }
+
+  assert(mWaitedSync == sync);
+
+  if ( ! CheckSync(false))
+    return false;
+
+  mAquiredSync = mWaitedSync;
+  mWaitedSync = NO_INDEX;
+
+  return true;
+}
+
+
+bool
+ProcedureCall::CheckSync(const bool block)
+{
+  assert(mWaitedSync != NO_INDEX);
+
+  const uint_t timeout = mSession.SyncWaitTimeout();
+  const SyncStatement::WAIT_RESULT result = mProcedure->mProcMgr->WaitSync( *mProcedure,
+                                                                           mWaitedSync,
+                                                                           *mSyncWaiter,
+                                                                           timeout,
+                                                                           block);
+  if (result == SyncStatement::WAIT_TIMEOUT)
+  {
+    const uint_t sync = mWaitedSync;
+
+    mWaitedSync = NO_INDEX;
+    throw InterException(_EXTRA(InterException::SYNC_WAIT_TIMEOUT),
+                         "Could not enter the synchronized statement %u of procedure '%s' "
+                         "in %u ms.",
+                         sync,
+                         mProcedure->mProcMgr->Name(mProcedure->mId),
+                         timeout);
+  }
+
+  return result == SyncStatement::WAIT_GRANTED;
+}
+
+
+void
+ProcedureCall::WaitSync()
+{
+  if (mEnded || (mWaitedSync == NO_INDEX))
+    return;
+
+  try
+  {
+    CheckSync(true);
+  }
+  catch (Exception& e)
+  {
+    //End it as if the wait had failed while it was running.
+    mEnded = true;
+
+    if (mProfile)
+      mProfile->Continue();
+
+    UnwindFrames( &e);
+
+    if (mAquiredSync != NO_INDEX)
+      ReleaseSync(mAquiredSync);
+
+    if (mProfile)
+      mProfile->Flush();
+
+    add_call_trace(e, *mProcedure, mCodePos);
+    throw;
+  }
 }
 
 
@@ -2208,7 +4353,7 @@ ProcedureCall::ReleaseSync(const uint8_t sync)
   if (mAquiredSync != sync)
     throw InterException(_EXTRA(InterException::SYNC_NOT_AQUIRED));
 
-  mProcedure.mProcMgr->ReleaseSync(mProcedure, sync);
+  mProcedure->mProcMgr->ReleaseSync( *mProcedure, sync);
   mAquiredSync = NO_INDEX;
 }
 
@@ -25,55 +25,159 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef PM_PROCESSOR_H_
 #define PM_PROCESSOR_H_
 
+#include <memory>
+#include <vector>
+
 #include "pm_interpreter.h"
 #include "pm_procedures.h"
+#include "pm_procprofile.h"
 
 
 namespace whais {
 namespace prima {
 
 
-class ProcedureCall
+class ProcedureCall : public IResumableCall
 {
 public:
   ProcedureCall(Session& session, SessionStack& stack, const Procedure& procedure);
 
+  //Prepare a call that is run only when it is resumed. It is suspended
+  //every time it runs about 'timeSlice' instructions (never if it is 0),
+  //or when it has to wait for a synchronisation statement.
+  ProcedureCall(Session& session,
+                SessionStack& stack,
+                const Procedure& procedure,
+                const uint32_t timeSlice);
+
+  ProcedureCall(const ProcedureCall&) = delete;
+  ProcedureCall& operator= (const ProcedureCall&) = delete;
+
+  virtual ~ProcedureCall() override;
+
+  virtual bool Resume() override;
+  virtual uint_t SuspendReason() const override { return mSuspendReason; }
+
   void AquireSync(const uint8_t sync);
   void ReleaseSync(const uint8_t sync);
 
+  //Block until the synchronisation statement the call was suspended for
+  //is handed to it. Throws if it has waited for it too long.
+  void WaitSync();
+
   Session& GetSession() const { return mSession; }
   SessionStack& GetStack() const { return mStack; }
 
   const Unit& GetUnit() const
   {
-    assert(mProcedure.mUnit != nullptr);
+    assert(mProcedure->mUnit != nullptr);
 
-    return *mProcedure.mUnit;
+    return *mProcedure->mUnit;
   }
 
   const uint8_t* Code() const { return mCode; }
-  uint32_t CodeSize() const { return mProcedure.mCodeSize; }
+  uint32_t CodeSize() const { return mProcedure->mCodeSize; }
   uint32_t CurrentOffset() const { return mCodePos; }
-  size_t LocalsCount() const { return mProcedure.mLocalsCount; }
+  size_t LocalsCount() const { return mProcedure->mLocalsCount; }
 
   const StackValue& GetLocalDefault(const uint_t local) const
   {
-    return mProcedure.mProcMgr->LocalValue(mProcedure.mId, local);
+    return mProcedure->mProcMgr->LocalValue(mProcedure->mId, local);
   }
   uint32_t StackBegin() const { return mStackBegin; }
 
+  static void DecodeCode(const Procedure& procedure,
+                         const uint8_t* const code,
+                         Session& session,
+                         DECODED_CODE& outInstructions);
+
+  //Select between running the pre-decoded instructions (the default) and
+  //decoding the procedures' code while it is executed.
+  static void UseDecodedCode(const bool enable) { smUseDecodedCode = enable; }
+  static bool UseDecodedCode() { return smUseDecodedCode; }
+
+  //Resolve the field the table element instruction found at 'site'
+  //refers to. It is kept for the next runs of the instruction, as long
+  //as these are applied on the same table.
+  FieldAccessReference& AccessField(const uint8_t* const site,
+                                    TableReference& tableRef,
+                                    const char* const fieldName);
+
+  //The size of the instruction found at the start of 'code'.
+  static uint_t InstructionSize(const uint8_t* const code);
+
+  //Mark the code of the instructions the decoded code does not leave to
+  //their generic handlers, i.e. the fused and the specialised ones.
+  static void InlinedPositions(const Procedure& procedure,
+                               const uint8_t* const code,
+                               Session& session,
+                               std::vector<bool>& outInlined);
+
 private:
+  //The state of a procedure that waits for a procedure it has called to
+  //return, when the code is run from its decoded form.
+  struct CallFrame
+  {
+    const Procedure*          mProcedure;
+    const uint8_t*            mCode;
+    const DecodedInstruction* mInstructions;
+    const DecodedInstruction* mReturn;
+    uint32_t                  mStackBegin;
+    uint16_t                  mAquiredSync;
+    SHARED_DECODED_CODE       mDecoded;
+  };
+
+  //A field resolved by a table element instruction.
+  struct FieldAccessSlot
+  {
+    const uint8_t*          mSite;
+    FieldAccessReference*   mAccess;
+  };
+
+  void PrepareLocals();
+  void RunNative();
   void Run();
+  void RunDecoded();
+
+  bool QueueSync(const uint8_t sync);
+  bool CheckSync(const bool block);
+  void ReleaseFieldAccesses();
+
+  void StartProfile(const SHARED_DECODED_CODE& instructions);
+  void EnterProcedure(const Procedure& procedure, const DecodedInstruction* const returnIp);
+  bool ReplaceFrame(const Procedure& procedure);
+  const DecodedInstruction* LeaveProcedure();
+  void UnwindFrames(Exception* const e);
 
   static const uint16_t NO_INDEX = 0xFFFF;
 
-  const Procedure&        mProcedure;
+  //The instructions charged for a call against the time slice.
+  static const uint32_t CALL_COST = 16;
+
+  static const uint_t FIELD_ACCESS_SLOTS = 16;
+
+  static bool             smUseDecodedCode;
+
+  const Procedure*        mProcedure;
   Session&                mSession;
   SessionStack&           mStack;
   const uint8_t*          mCode;
+  const DecodedInstruction* mInstructions;
+  SHARED_DECODED_CODE     mDecoded;   //Keeps mInstructions alive.
+  const DecodedInstruction* mResumeIp;
   uint32_t                mStackBegin;
   uint32_t                mCodePos;
+  const uint32_t          mTimeSlice;
+  uint_t                  mSuspendReason;
   uint16_t                mAquiredSync;
+  uint16_t                mWaitedSync;
+  const bool              mSuspendable;
+  bool                    mEnded;
+  std::vector<CallFrame>  mFrames;
+  FieldAccessSlot         mFieldAccesses[FIELD_ACCESS_SLOTS];
+  std::unique_ptr<CallProfile> mProfile;
+  std::unique_ptr<SyncStatement::Waiter> mSyncWaiter;
+  uint64_t*               mProfileCounts;
 };
 
 
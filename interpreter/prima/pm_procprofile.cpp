@@ -0,0 +1,239 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <chrono>
+#include <cstring>
+
+#include "pm_procprofile.h"
+#include "pm_processor.h"
+
+
+using namespace std;
+
+
+namespace whais {
+namespace prima {
+
+
+static uint64_t
+now_nsec()
+{
+  const auto now = chrono::steady_clock::now().time_since_epoch();
+  return chrono::duration_cast<chrono::nanoseconds>(now).count();
+}
+
+
+volatile bool     ProcedureProfile::smEnabled    = false;
+volatile uint32_t ProcedureProfile::smGeneration = 0;
+
+
+ProcedureProfile::ProcedureProfile()
+  : mGeneration(smGeneration)
+{
+  memset(&mStats, 0, sizeof mStats);
+}
+
+
+void
+ProcedureProfile::CheckGeneration()
+{
+  if (mGeneration == smGeneration)
+    return;
+
+  memset(&mStats, 0, sizeof mStats);
+  mCodeCounts.clear();
+  mGeneration = smGeneration;
+}
+
+
+void
+ProcedureProfile::Record(const Procedure& procedure,
+                         const DECODED_CODE* const instructions,
+                         const uint64_t calls,
+                         const uint64_t inclusiveTime,
+                         const uint64_t exclusiveTime,
+                         const vector<uint64_t>& counts)
+{
+  LockGuard<Lock> holder(mLock);
+
+  CheckGeneration();
+
+  mStats.mCalls         += calls;
+  mStats.mInclusiveTime += inclusiveTime;
+  mStats.mExclusiveTime += exclusiveTime;
+
+  if ((instructions == nullptr) || (instructions->size() != counts.size()))
+    return;
+
+  const uint8_t* const code = procedure.mProcMgr->Code(procedure, nullptr);
+
+  mCodeCounts.resize(procedure.mCodeSize, 0);
+
+  //A decoded instruction may stand for a sequence of the code's instructions.
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    if (counts[i] == 0)
+      continue;
+
+    const DecodedInstruction& instr = (*instructions)[i];
+    const uint32_t end = min(instr.mCodePos + instr.mLength, procedure.mCodeSize);
+
+    for (uint32_t pos = instr.mCodePos; pos < end; pos += ProcedureCall::InstructionSize(code + pos))
+    {
+      mCodeCounts[pos]      += counts[i];
+      mStats.mInstructions  += counts[i];
+    }
+  }
+}
+
+
+void
+ProcedureProfile::Statistics(ProcedureProfileStats& outStats, vector<uint64_t>* const outCodeCounts)
+{
+  LockGuard<Lock> holder(mLock);
+
+  CheckGeneration();
+
+  outStats = mStats;
+  outStats.mInclusiveTime /= 1000;
+  outStats.mExclusiveTime /= 1000;
+
+  if (outCodeCounts != nullptr)
+    *outCodeCounts = mCodeCounts;
+}
+
+
+void
+ProcedureProfile::Reset()
+{
+  wh_atomic_fetch_inc32(_RC(volatile int32_t*, &smGeneration));
+}
+
+
+CallProfile::CallProfile()
+  : mPausedAt(0)
+{
+}
+
+
+uint64_t*
+CallProfile::Enter(const Procedure& procedure, const SHARED_DECODED_CODE& instructions)
+{
+  uint32_t entry = 0;
+  while ((entry < mEntries.size())
+         && ((mEntries[entry].mProcedure != &procedure)
+             || (mEntries[entry].mInstructions != instructions)))
+  {
+    ++entry;
+  }
+
+  if (entry == mEntries.size())
+  {
+    mEntries.push_back(Entry{&procedure, instructions, 0, 0, 0, 0, vector<uint64_t>()});
+
+    if (instructions != nullptr)
+      mEntries.back().mCounts.resize(instructions->size(), 0);
+  }
+
+  Entry& e = mEntries[entry];
+
+  ++e.mCalls, ++e.mActive;
+  mFrames.push_back(Frame{entry, now_nsec(), 0});
+
+  return e.mCounts.empty() ? nullptr : e.mCounts.data();
+}
+
+
+uint64_t*
+CallProfile::Leave()
+{
+  assert( ! mFrames.empty());
+
+  const Frame frame = mFrames.back();
+  const uint64_t elapsed = now_nsec() - frame.mStart;
+
+  mFrames.pop_back();
+
+  Entry& e = mEntries[frame.mEntry];
+
+  e.mExclusiveTime += elapsed - min(elapsed, frame.mChildren);
+
+  //A recursive procedure's time is counted only once.
+  if (--e.mActive == 0)
+    e.mInclusiveTime += elapsed;
+
+  if (mFrames.empty())
+    return nullptr;
+
+  mFrames.back().mChildren += elapsed;
+
+  Entry& caller = mEntries[mFrames.back().mEntry];
+  return caller.mCounts.empty() ? nullptr : caller.mCounts.data();
+}
+
+
+void
+CallProfile::Pause()
+{
+  mPausedAt = now_nsec();
+}
+
+
+void
+CallProfile::Continue()
+{
+  if (mPausedAt == 0)
+    return;
+
+  const uint64_t paused = now_nsec() - mPausedAt;
+
+  for (auto& frame : mFrames)
+    frame.mStart += paused;
+
+  mPausedAt = 0;
+}
+
+
+void
+CallProfile::Flush()
+{
+  while ( ! mFrames.empty())
+    Leave();
+
+  for (auto& e : mEntries)
+  {
+    e.mProcedure->mProcMgr->Profile( *e.mProcedure).Record( *e.mProcedure,
+                                                            e.mInstructions.get(),
+                                                            e.mCalls,
+                                                            e.mInclusiveTime,
+                                                            e.mExclusiveTime,
+                                                            e.mCounts);
+  }
+
+  mEntries.clear();
+}
+
+
+} //namespace prima
+} //namespace whais
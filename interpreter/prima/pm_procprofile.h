@@ -0,0 +1,90 @@
+/******************************************************************************
+WHAIS - An advanced database system
+Copyright(C) 2014-2018  Iulian Popa
+
+Address: Str Olimp nr. 6
+         Pantelimon Ilfov,
+         Romania
+Phone:   +40721939650
+e-mail:  popaiulian@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PM_PROCPROFILE_H_
+#define PM_PROCPROFILE_H_
+
+#include <vector>
+
+#include "pm_procedures.h"
+
+
+namespace whais {
+namespace prima {
+
+
+//Collects the profile of a call's procedures as they are run, to be added
+//to their profiles only when the call ends, so the procedures' profiles
+//are not locked for every nested call. The times of the procedures are
+//measured in nanoseconds and exclude the times the call was suspended.
+class CallProfile
+{
+public:
+  CallProfile();
+  CallProfile(const CallProfile&) = delete;
+  CallProfile& operator= (const CallProfile&) = delete;
+
+  //Returns the place where the procedure's decoded instructions are counted
+  //(none for the native procedures).
+  uint64_t* Enter(const Procedure& procedure, const SHARED_DECODED_CODE& instructions);
+
+  //Returns the place where the returned to procedure's instructions are counted.
+  uint64_t* Leave();
+
+  void Pause();
+  void Continue();
+
+  //Leave the procedures still in progress and add everything to the profiles.
+  void Flush();
+
+private:
+  struct Entry
+  {
+    const Procedure*      mProcedure;
+    SHARED_DECODED_CODE   mInstructions;
+    uint64_t              mCalls;
+    uint64_t              mInclusiveTime;
+    uint64_t              mExclusiveTime;
+    uint32_t              mActive;  //Recursive calls in progress.
+    std::vector<uint64_t> mCounts;
+  };
+
+  struct Frame
+  {
+    uint32_t  mEntry;
+    uint64_t  mStart;
+    uint64_t  mChildren;
+  };
+
+  std::vector<Entry>  mEntries;
+  std::vector<Frame>  mFrames;
+  uint64_t            mPausedAt;
+};
+
+
+} //namespace prima
+} //namespace whais
+
+
+#endif //PM_PROCPROFILE_H_
@@ -39,6 +39,8 @@ public:
   T* Alloc()
   {
     whais::LockGuard<decltype(mLock)> _l(mLock);
+
+    ++mAllocationsCount;
     return new T();
   }
 
@@ -48,6 +50,12 @@ public:
     delete obj;
   }
 
+  //How many objects were allocated since the store was created.
+  uint64_t AllocationsCount() const
+  {
+    return mAllocationsCount;
+  }
+
   static Store<T>& Instance()
   {
     static Store<T> instance;
@@ -58,6 +66,7 @@ protected:
   Store<T>() = default;
 
   whais::Lock       mLock;
+  uint64_t          mAllocationsCount = 0;
 };
 
 using SharedArrayStore = Store<std::shared_ptr<DArray>>;
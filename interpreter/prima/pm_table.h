@@ -85,6 +85,77 @@ private:
   Lock             mLock;
 };
 
+
+/* A table's field as the table element instructions resolve it. For the
+ * fields of fixed size types it holds an access handle the field elements
+ * operands read the rows with. It is shared only by a procedure call and
+ * by the operands it has created, which are never used by two threads at
+ * once, hence its reference count needs no lock. */
+class FieldAccessReference
+{
+public:
+  FieldAccessReference(TableReference& tableRef, const FIELD_INDEX field)
+    : mTableRef(tableRef),
+      mAccess(nullptr),
+      mRefCount(0),
+      mFieldType(T_UNKNOWN),
+      mField(field)
+  {
+    ITable& table = mTableRef.GetTable();
+    const DBSFieldDescriptor fieldDesc = table.DescribeField(field);
+
+    mFieldType = fieldDesc.type;
+    if (fieldDesc.isArray)
+      MARK_ARRAY(mFieldType);
+
+    else if (mFieldType != T_TEXT)
+      mAccess = &table.AccessField(field);
+
+    mTableRef.IncrementRefCount();
+  }
+
+  FieldAccessReference(const FieldAccessReference&) = delete;
+  FieldAccessReference& operator= (const FieldAccessReference&) = delete;
+
+  void IncrementRefCount()
+  {
+    ++mRefCount;
+  }
+
+  void DecrementRefCount()
+  {
+    assert(mRefCount > 0);
+
+    if (--mRefCount == 0)
+      delete this;
+  }
+
+  TableReference& GetTableReference() { return mTableRef; }
+  FIELD_INDEX GetField() const { return mField; }
+  uint_t GetFieldType() const { return mFieldType; }
+
+  IFieldAccess& GetAccess()
+  {
+    assert(mAccess != nullptr);
+    return *mAccess;
+  }
+
+private:
+  ~FieldAccessReference()
+  {
+    if (mAccess != nullptr)
+      mAccess->Release();
+
+    mTableRef.DecrementRefCount();
+  }
+
+  TableReference&    mTableRef;
+  IFieldAccess*      mAccess;
+  uint64_t           mRefCount;
+  uint_t             mFieldType;
+  const FIELD_INDEX  mField;
+};
+
 } //namespace whais
 } //namespace prima
 
@@ -25,7 +25,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 #include <memory.h>
 
+#include "compiler/wopcodes.h"
+#include "utils/endianness.h"
+#include "utils/wtypes.h"
+
 #include "pm_units.h"
+#include "pm_processor.h"
 #include "interpreter.h"
 
 
@@ -86,6 +91,310 @@ Unit::GetConstData(const uint32_t offset) const
 }
 
 
+static void
+code_error(const char* const procName, const uint32_t codePos, const char* const reason)
+{
+  throw InterException(_EXTRA(InterException::INVALID_UNIT_CODE),
+                       "The code of procedure '%s' %s (PC: %04u).",
+                       procName,
+                       reason,
+                       codePos);
+}
+
+
+static bool
+is_array_type(const uint_t type)
+{
+  return (T_BOOL <= type) && (type <= T_RICHREAL);
+}
+
+
+void
+Unit::VerifyCode(const uint8_t* const  code,
+                 const uint32_t        codeSize,
+                 const uint32_t        localsCount,
+                 const uint32_t        syncsCount,
+                 const uint32_t* const procsArgs,
+                 const char* const     procName) const
+{
+  static const int64_t NOT_REACHED = -1;
+
+  //Find where the instructions start, up to the first one that cannot be
+  //decoded. Whatever follows it (e.g. some garbage left after the last
+  //return) is fine as long as it is not reached.
+  vector<bool> starts(codeSize, false);
+  for (uint32_t codePos = 0; codePos < codeSize; )
+  {
+    W_OPCODE opcode;
+    wh_compiler_decode_op(code + codePos, &opcode);
+
+    if ((opcode == W_NA) || (opcode >= W_OP_END_MARK))
+      break;
+
+    const uint_t size = ProcedureCall::InstructionSize(code + codePos);
+    if (codePos + size > codeSize)
+      break;
+
+    starts[codePos] = true;
+    codePos += size;
+  }
+
+  //The count of temporary values kept on the stack, after the procedure's
+  //locals, when each reachable instruction starts.
+  vector<int64_t> depths(codeSize, NOT_REACHED);
+  vector<uint32_t> pending;
+
+  if (codeSize == 0)
+    code_error(procName, 0, "is empty");
+
+  depths[0] = 0;
+  pending.push_back(0);
+
+  while ( ! pending.empty())
+  {
+    const uint32_t codePos = pending.back();
+    const int64_t depth = depths[codePos];
+
+    pending.pop_back();
+
+    if ( ! starts[codePos])
+      code_error(procName, codePos, "reaches an invalid instruction");
+
+    W_OPCODE opcode;
+    const uint_t opLength = wh_compiler_decode_op(code + codePos, &opcode);
+    const uint8_t* const args = code + codePos + opLength;
+
+    int64_t needed = 0, effect = 0;
+    bool fallsThrough = true, jumps = false;
+
+    switch (opcode)
+    {
+    case W_LDNULL:
+      if (args[0] == 0)
+        code_error(procName, codePos, "loads no NULL values");
+
+      effect = args[0];
+      break;
+
+    case W_LDT:
+      if ( ! IsConstText(load_le_int32(args)))
+        code_error(procName, codePos, "loads a text constant that does not exist");
+
+      effect = 1;
+      break;
+
+    case W_LDC:
+    case W_LDI8:
+    case W_LDI16:
+    case W_LDI32:
+    case W_LDI64:
+    case W_LDD:
+    case W_LDDT:
+    case W_LDHT:
+    case W_LDRR:
+    case W_LDBT:
+    case W_LDBF:
+      effect = 1;
+      break;
+
+    case W_LDLO8:
+    case W_LDLO16:
+    case W_LDLO32:
+      {
+        const uint32_t local = (opcode == W_LDLO8)
+                               ? args[0]
+                               : ((opcode == W_LDLO16) ? load_le_int16(args) : load_le_int32(args));
+
+        //Besides its locals (without the result) a procedure may load the
+        //temporary values kept after them (e.g. the iterators).
+        if (local + _SC(int64_t, 1) > _SC(int64_t, localsCount) - 1 + depth)
+          code_error(procName, codePos, "loads a local value that does not exist");
+
+        effect = 1;
+      }
+      break;
+
+    case W_LDGB8:
+    case W_LDGB16:
+    case W_LDGB32:
+      {
+        const uint32_t global = (opcode == W_LDGB8)
+                                ? args[0]
+                                : ((opcode == W_LDGB16) ? load_le_int16(args) : load_le_int32(args));
+        if (global >= mGlbsCount)
+          code_error(procName, codePos, "loads a global value that does not exist");
+
+        effect = 1;
+      }
+      break;
+
+    case W_CTS:
+      needed = args[0];
+      effect = -needed;
+      break;
+
+    case W_CALL:
+      {
+        const uint32_t proc = load_le_int32(args);
+        if (proc >= mProcsCount)
+          code_error(procName, codePos, "calls a procedure that does not exist");
+
+        needed = procsArgs[proc];
+        effect = 1 - needed;
+      }
+      break;
+
+    case W_RET:
+      needed = 1;
+      fallsThrough = false;
+      break;
+
+    case W_JF:
+    case W_JT:
+      needed = 1;
+      jumps = true;
+      break;
+
+    case W_JFC:
+    case W_JTC:
+      needed = 1;
+      effect = -1;
+      jumps = true;
+      break;
+
+    case W_JMP:
+      fallsThrough = false;
+      jumps = true;
+      break;
+
+    case W_INULL:
+    case W_NNULL:
+    case W_NOT:
+    case W_NOTB:
+    case W_ITOFF:
+    case W_FID:
+      needed = 1;
+      break;
+
+    case W_SELF:
+      if ( ! IsConstText(load_le_int32(args)))
+        code_error(procName, codePos, "refers a field name that does not exist");
+
+      needed = 1;
+      break;
+
+    case W_INDTA:
+      if ( ! IsConstText(load_le_int32(args)))
+        code_error(procName, codePos, "refers a field name that does not exist");
+
+      needed = 2;
+      effect = -1;
+      break;
+
+    case W_ITF:
+    case W_ITL:
+    case W_ITN:
+    case W_ITP:
+      needed = 1;
+      effect = 1;
+      break;
+
+    case W_BSYNC:
+    case W_ESYNC:
+      if (args[0] >= syncsCount)
+        code_error(procName, codePos, "uses a synchronised statement that does not exist");
+      break;
+
+    case W_CARR:
+      {
+        const uint_t type = args[0];
+        const uint_t count = load_le_int16(args + 1);
+
+        if ((type & CARR_FROM_FIELD)
+            ? ((type & ~CARR_FROM_FIELD) < T_INT8) || ((type & ~CARR_FROM_FIELD) > T_UINT64)
+            : ! is_array_type(type))
+        {
+          code_error(procName, codePos, "creates an array of an invalid type");
+        }
+        else if (count == 0)
+          code_error(procName, codePos, "creates an array with no elements");
+
+        needed = count;
+        effect = 1 - needed;
+      }
+      break;
+
+    case W_AJOIN:
+    case W_AFOUT:
+    case W_AFIN:
+      if ( ! is_array_type(GET_BASE_TYPE(args[0])))
+        code_error(procName, codePos, "works with arrays of an invalid type");
+
+      needed = 2;
+      effect = -1;
+      break;
+
+    default:
+      //The stores, the binary operators, the self operators and the
+      //indexing instructions.
+      needed = 2;
+      effect = -1;
+    }
+
+    if (depth < needed)
+      code_error(procName, codePos, "uses more values than it has on the stack");
+
+    uint32_t next[2];
+    uint_t nextCount = 0;
+
+    if (jumps)
+    {
+      const int64_t target = codePos + _SC(int64_t, _SC(int32_t, load_le_int32(args)));
+      if ((target < 0) || (target >= codeSize) || ! starts[target])
+        code_error(procName, codePos, "jumps outside of its instructions");
+
+      next[nextCount++] = target;
+    }
+
+    if (fallsThrough)
+    {
+      const uint32_t following = codePos + ProcedureCall::InstructionSize(code + codePos);
+      if (following >= codeSize)
+        code_error(procName, codePos, "ends without a return");
+
+      next[nextCount++] = following;
+    }
+
+    for (uint_t i = 0; i < nextCount; ++i)
+    {
+      if (depths[next[i]] == NOT_REACHED)
+      {
+        depths[next[i]] = depth + effect;
+        pending.push_back(next[i]);
+      }
+      else if (depths[next[i]] != depth + effect)
+      {
+        code_error(procName,
+                   next[i],
+                   "reaches an instruction with different counts of values on the stack");
+      }
+    }
+  }
+}
+
+
+bool
+Unit::IsConstText(const uint32_t offset) const
+{
+  if (offset >= mConstSize)
+    return false;
+
+  const uint8_t* const text = GetConstData(offset);
+
+  return memchr(text, 0, mConstSize - offset) != nullptr;
+}
+
+
 UnitsManager::~UnitsManager()
 {
   for (uint32_t index = 0; index < mUnits.size(); ++index)
@@ -44,6 +44,25 @@ struct Unit
 
   const uint8_t* GetConstData(const uint32_t offset) const;
 
+  //Check a procedure's code before it is run for the first time. Every
+  //instruction reachable from its start has to be well formed, to use only
+  //the values it finds on the stack, to refer only locals, globals,
+  //procedures, constants and synchronised statements that exist and to jump
+  //only to the start of another instruction. The stack has to hold the same
+  //count of values each time an instruction is reached, and the code may not
+  //be left but through a return. 'procsArgs' holds the arguments count of
+  //each of the unit's procedures. Throws if any of these do not hold, so the
+  //handlers of the instructions don't have to check them again.
+  void VerifyCode(const uint8_t* const code,
+                  const uint32_t codeSize,
+                  const uint32_t localsCount,
+                  const uint32_t syncsCount,
+                  const uint32_t* const procsArgs,
+                  const char* const procName) const;
+
+  //Check if at 'offset' the constant data holds a null terminated text.
+  bool IsConstText(const uint32_t offset) const;
+
   uint32_t mGlbsCount;
   uint32_t mProcsCount;
   uint32_t mConstSize;
@@ -119,3 +119,43 @@ UNIT_EXES+=test_stackvalue_size
 test_stackvalue_size_SRC=test/test_stackvalue_size.cpp
 test_stackvalue_size_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
 
+
+UNIT_EXES+=test_bench_dispatch
+test_bench_dispatch_SRC=test/test_bench_dispatch.cpp
+test_bench_dispatch_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_call_frames
+test_call_frames_SRC=test/test_call_frames.cpp
+test_call_frames_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_time_slices
+test_time_slices_SRC=test/test_time_slices.cpp
+test_time_slices_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_sync_queues
+test_sync_queues_SRC=test/test_sync_queues.cpp
+test_sync_queues_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_opcode_profile
+test_opcode_profile_SRC=test/test_opcode_profile.cpp
+test_opcode_profile_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_field_access
+test_field_access_SRC=test/test_field_access.cpp
+test_field_access_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_value_moves
+test_value_moves_SRC=test/test_value_moves.cpp
+test_value_moves_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_proc_profile
+test_proc_profile_SRC=test/test_proc_profile.cpp
+test_proc_profile_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_optimized_code
+test_optimized_code_SRC=test/test_optimized_code.cpp
+test_optimized_code_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc 
+
+UNIT_EXES+=test_code_verifier
+test_code_verifier_SRC=test/test_code_verifier.cpp
+test_code_verifier_LIB=dbs/wslpastra   interpreter/wslprima compiler/wslcompiler utils/wslutils custom/wslcustom custom/wslcppmemalloc
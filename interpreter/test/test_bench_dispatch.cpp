@@ -0,0 +1,432 @@
+/*
+ * test_bench_dispatch.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+#include "interpreter/prima/pm_opprofile.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t benchProgram[] = ""
+    "VAR gStep UINT64;\n"
+    "\n"
+    "PROCEDURE sum_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += i * 3;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE branch_loop(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR r INT64;\n"
+    "  r = 0;\n"
+    "  i = 0;\n"
+    "  WHILE (i < n) DO\n"
+    "    IF (i % 3 == 0)\n"
+    "      r += 2;\n"
+    "    ELSE IF (i % 3 == 1)\n"
+    "      r -= 1;\n"
+    "    ELSE\n"
+    "      r += i;\n"
+    "    i += 1;\n"
+    "  END\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE global_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  gStep = 7;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += gStep;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE numeric_loop(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR a INT32;\n"
+    "  VAR b INT16;\n"
+    "  VAR c INT64;\n"
+    "  VAR r INT64;\n"
+    "  a = 1; b = 2; c = 3; r = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    a = b + c;\n"
+    "    b = a - i;\n"
+    "    c = 5;\n"
+    "    r = r + b;\n"
+    "    IF (b >= a)\n"
+    "      r -= 1;\n"
+    "  END\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE null_locals(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR a INT32;\n"
+    "  VAR b INT64;\n"
+    "  VAR r INT64;\n"
+    "  r = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    a += 1;\n"
+    "    b = a * 2;\n"
+    "    IF (a < b)\n"
+    "      r += 1;\n"
+    "    IF (a == b)\n"
+    "      r += 2;\n"
+    "    IF (b != a)\n"
+    "      r += 3;\n"
+    "  END\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE add3(a INT64, b INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR t INT64;\n"
+    "  VAR u INT32;\n"
+    "  VAR f BOOL;\n"
+    "  t = a + b;\n"
+    "  u = 3;\n"
+    "  RETURN t + u;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE call_loop(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR r INT64;\n"
+    "  r = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    r = add3(r, i);\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE fib(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n < 2)\n"
+    "    RETURN n;\n"
+    "  RETURN fib(n - 1) + fib(n - 2);\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+template <typename DBS_T> static bool
+run_procedure(Session& session,
+              const char* const procName,
+              const uint32_t arg,
+              const bool decoded,
+              DBS_T& outResult,
+              WTICKS& outTicks)
+{
+  SessionStack stack;
+
+  stack.Push(DUInt32(arg));
+
+  ProcedureCall::UseDecodedCode(decoded);
+
+  const WTICKS start = wh_msec_ticks();
+  session.ExecuteProcedure(procName, stack);
+  outTicks = wh_msec_ticks() - start;
+
+  if (stack.Size() != 1)
+    return false;
+
+  stack[0].Operand().GetValue(outResult);
+
+  return true;
+}
+
+
+//When no expected value is given, the legacy dispatch loop sets the reference.
+template <typename DBS_T> static bool
+bench_procedure(Session& session,
+                const char* const procName,
+                const uint32_t arg,
+                const DBS_T* const expected = nullptr)
+{
+  std::cout << "Benchmarking '" << procName << "(" << arg << ")' ... ";
+
+  DBS_T legacyResult, decodedResult;
+  WTICKS legacyTicks = 0, decodedTicks = 0;
+
+  bool result = run_procedure(session, procName, arg, false, legacyResult, legacyTicks);
+  result = result && run_procedure(session, procName, arg, true, decodedResult, decodedTicks);
+
+  result = result
+           && ((expected == nullptr) || (legacyResult == *expected))
+           && (decodedResult == legacyResult);
+
+  std::cout << "legacy " << legacyTicks << "ms, decoded " << decodedTicks << "ms ";
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+
+  return result;
+}
+
+
+static uint64_t
+expected_sum_loop(const uint32_t n)
+{
+  uint64_t result = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    result += i * 3;
+
+  return result;
+}
+
+
+static int64_t
+expected_branch_loop(const uint32_t n)
+{
+  int64_t result = 0;
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    if (i % 3 == 0)
+      result += 2;
+
+    else if (i % 3 == 1)
+      result -= 1;
+
+    else
+      result += i;
+  }
+
+  return result;
+}
+
+
+static int64_t
+expected_numeric_loop(const uint32_t n)
+{
+  int32_t a = 1;
+  int16_t b = 2;
+  int64_t c = 3, r = 0;
+
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    a = _SC(int32_t, b + c);
+    b = _SC(int16_t, a - _SC(int64_t, i));
+    c = 5;
+    r = r + b;
+    if (b >= a)
+      r -= 1;
+  }
+
+  return r;
+}
+
+
+//Measure the procedures' invocations as they are requested by clients.
+static bool
+bench_client_calls(Session& session, const uint32_t callsCount)
+{
+  std::cout << "Benchmarking " << callsCount << " client calls of 'add3' ... ";
+
+  SessionStack stack;
+  bool result = true;
+
+  const WTICKS start = wh_msec_ticks();
+  for (uint32_t i = 0; (i < callsCount) && result; ++i)
+  {
+    stack.Push(DInt64(i));
+    stack.Push(DInt64(1));
+
+    session.ExecuteProcedure("add3", stack);
+
+    DInt64 value;
+    stack[0].Operand().GetValue(value);
+    stack.Pop(1);
+
+    result = (stack.Size() == 0) && (value == DInt64(i + 4));
+  }
+  const WTICKS ticks = wh_msec_ticks() - start;
+
+  std::cout << ticks << "ms ";
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+
+  return result;
+}
+
+
+static uint64_t
+expected_fib(const uint32_t n)
+{
+  return (n < 2) ? n : expected_fib(n - 1) + expected_fib(n - 2);
+}
+
+
+//Profile the opcodes of the benchmarked procedures, to find the sequences
+//the decoded code still leaves to the generic handlers.
+static bool
+profile_procedures(Session& session,
+                   const uint32_t loopsCount,
+                   const uint32_t fibArg,
+                   const char* const profileFile)
+{
+  static const char* const procedures[] = { "sum_loop", "branch_loop", "global_loop",
+                                            "numeric_loop", "null_locals", "call_loop",
+                                            "fib" };
+
+  std::cout << "Profiling the procedures' opcodes ... ";
+
+  EnableOpcodeProfile(true);
+  for (auto procName : procedures)
+  {
+    SessionStack stack;
+
+    stack.Push(DUInt32((strcmp(procName, "fib") == 0) ? fibArg : loopsCount));
+    session.ExecuteProcedure(procName, stack);
+  }
+  EnableOpcodeProfile(false);
+
+  const bool result = DumpOpcodeProfile(profileFile);
+  OpcodeProfile::Reset();
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+//Run it with a third argument to keep the opcodes' profile in that file.
+int
+main(int argc, char **argv)
+{
+  uint32_t loopsCount = 200000;
+  uint32_t fibArg = 20;
+
+  if (argc > 1)
+    loopsCount = atol(argv[1]);
+
+  if (argc > 2)
+    fibArg = atol(argv[2]);
+
+  const char* const profileFile = (argc > 3) ? argv[3] : nullptr;
+
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& commonSession = GetInstance(nullptr);
+    Session& session = _SC(Session&, commonSession);
+
+    CompiledBufferUnit benchUnit(benchProgram,
+                                 sizeof benchProgram,
+                                 my_postman,
+                                 benchProgram);
+
+    commonSession.LoadCompiledUnit(benchUnit);
+
+    const DUInt64 sumLoop(expected_sum_loop(loopsCount));
+    const DInt64 branchLoop(expected_branch_loop(loopsCount));
+    const DUInt64 globalLoop(7ull * loopsCount);
+    const DInt64 numericLoop(expected_numeric_loop(loopsCount));
+    const DInt64 callLoop((_SC(int64_t, loopsCount) - 1) * loopsCount / 2 + 3ll * loopsCount);
+    const DUInt64 fibResult(expected_fib(fibArg));
+
+    success = success && bench_procedure(session, "sum_loop", loopsCount, &sumLoop);
+    success = success && bench_procedure(session, "branch_loop", loopsCount, &branchLoop);
+    success = success && bench_procedure(session, "global_loop", loopsCount, &globalLoop);
+    success = success && bench_procedure(session, "numeric_loop", loopsCount, &numericLoop);
+    success = success && bench_procedure<DInt64>(session, "null_locals", loopsCount);
+    success = success && bench_procedure(session, "call_loop", loopsCount, &callLoop);
+    success = success && bench_procedure(session, "fib", fibArg, &fibResult);
+    success = success && bench_client_calls(session, loopsCount);
+
+    if (profileFile != nullptr)
+      success = success && profile_procedures(session, loopsCount, fibArg, profileFile);
+
+    ProcedureCall::UseDecodedCode(true);
+    ReleaseInstance(commonSession);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
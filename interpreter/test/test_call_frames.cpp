@@ -0,0 +1,311 @@
+/*
+ * test_call_frames.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+//Deep enough to exhaust the native stack of a nested call per procedure.
+static uint32_t _callsDepth = 100000;
+
+const uint8_t callsProgram[] = ""
+    "PROCEDURE deep_sum(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n == 0)\n"
+    "    RETURN 0;\n"
+    "  RETURN deep_sum(n - 1) + n;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE tail_sum(n UINT32, acc UINT64) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n == 0)\n"
+    "    RETURN acc;\n"
+    "  RETURN tail_sum(n - 1, acc + n);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE tail_start(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  RETURN tail_sum(n, 0);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE modify(v UINT64) RETURN UINT64\n"
+    "DO\n"
+    "  v += 10;\n"
+    "  RETURN v;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE forward_param(p UINT64) RETURN UINT64\n"
+    "DO\n"
+    "  RETURN modify(p);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE forward_local(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR x UINT64;\n"
+    "  x = n;\n"
+    "  RETURN modify(x);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE by_reference(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR x UINT64;\n"
+    "  x = n;\n"
+    "  forward_param(x);\n"
+    "  RETURN x + forward_local(n);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE fail_deep(n UINT32) RETURN UINT32\n"
+    "DO\n"
+    "  IF (n == 0)\n"
+    "    RETURN 10 / n;\n"
+    "  RETURN fail_deep(n - 1) + 1;\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+static bool
+call_procedure(Session& session,
+               const char* const procName,
+               const uint32_t arg,
+               const bool decoded,
+               DUInt64& outResult)
+{
+  SessionStack stack;
+
+  stack.Push(DUInt32(arg));
+
+  ProcedureCall::UseDecodedCode(decoded);
+  session.ExecuteProcedure(procName, stack);
+
+  if (stack.Size() != 1)
+    return false;
+
+  stack[0].Operand().GetValue(outResult);
+
+  return true;
+}
+
+
+static void
+set_max_stack(Session& session, uint64_t count)
+{
+  session.NotifyEvent(ISession::MAX_STACK_COUNT, &count);
+}
+
+
+static bool
+test_deep_recursion(Session& session)
+{
+  std::cout << "Testing deep recursion ... ";
+
+  const uint32_t depth = _callsDepth;
+
+  DUInt64 result;
+  bool success = call_procedure(session, "deep_sum", depth, true, result)
+                 && (result == DUInt64(_SC(uint64_t, depth) * (depth + 1) / 2));
+
+  set_max_stack(session, depth);
+  try
+  {
+    call_procedure(session, "deep_sum", depth, true, result);
+    success = false;
+  }
+  catch (InterException& e)
+  {
+    success = success && (e.Code() == InterException::STACK_TOO_BIG);
+  }
+  set_max_stack(session, ~0);
+
+  std::cout << (success ? "OK" : "FAIL") << std::endl;
+  return success;
+}
+
+
+static bool
+test_tail_calls(Session& session)
+{
+  std::cout << "Testing tail calls ... ";
+
+  const uint32_t depth = 2 * _callsDepth;
+
+  //The frames are reused, so the stack is not allowed to grow.
+  set_max_stack(session, 64);
+
+  DUInt64 result;
+  bool success = call_procedure(session, "tail_start", depth, true, result)
+                 && (result == DUInt64(_SC(uint64_t, depth) * (depth + 1) / 2));
+
+  set_max_stack(session, ~0);
+
+  std::cout << (success ? "OK" : "FAIL") << std::endl;
+  return success;
+}
+
+
+static bool
+test_references(Session& session)
+{
+  std::cout << "Testing arguments passed by reference ... ";
+
+  DUInt64 legacyResult, decodedResult;
+
+  bool success = call_procedure(session, "by_reference", 5, false, legacyResult);
+  success = success && call_procedure(session, "by_reference", 5, true, decodedResult);
+  success = success && (legacyResult == decodedResult);
+
+  std::cout << (success ? "OK" : "FAIL") << std::endl;
+  return success;
+}
+
+
+static bool
+test_failure_trace(Session& session)
+{
+  std::cout << "Checking the errors of nested calls ... ";
+
+  const uint32_t depth = 3;
+
+  std::string legacyMessage, decodedMessage;
+  for (int decoded = 0; decoded < 2; ++decoded)
+  {
+    try
+    {
+      DUInt64 result;
+      call_procedure(session, "fail_deep", depth, decoded != 0, result);
+    }
+    catch (InterException& e)
+    {
+      (decoded ? decodedMessage : legacyMessage) = e.Message();
+    }
+  }
+
+  size_t calls = 0;
+  for (size_t pos = decodedMessage.find("fail_deep");
+       pos != std::string::npos;
+       pos = decodedMessage.find("fail_deep", pos + 1))
+  {
+    ++calls;
+  }
+
+  const bool success = ( ! decodedMessage.empty())
+                       && (legacyMessage == decodedMessage)
+                       && (calls == depth + 1);
+
+  std::cout << (success ? "OK" : "FAIL") << std::endl;
+  return success;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  if (argc > 1)
+    _callsDepth = atol(argv[1]);
+
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& commonSession = GetInstance(nullptr);
+    Session& session = _SC(Session&, commonSession);
+
+    CompiledBufferUnit callsUnit(callsProgram,
+                                 sizeof callsProgram,
+                                 my_postman,
+                                 callsProgram);
+
+    commonSession.LoadCompiledUnit(callsUnit);
+
+    success = success && test_deep_recursion(session);
+    success = success && test_tail_calls(session);
+    success = success && test_references(session);
+    success = success && test_failure_trace(session);
+
+    ProcedureCall::UseDecodedCode(true);
+    ReleaseInstance(commonSession);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
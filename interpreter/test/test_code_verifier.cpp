@@ -0,0 +1,328 @@
+/*
+ * test_code_verifier.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+#include <memory>
+
+#include "compiler/compiledunit.h"
+#include "compiler/wopcodes.h"
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[]  = "administrator";
+static const char testDb[] = "t_testdb_verifier";
+
+//The positions the code is altered at are of this procedure's plain code:
+//
+//  0000 ldlo8 2        0017 ldlo8 2        0031 ldlo8 2
+//  0002 ldi8 00h       0019 ldlo8 1        0033 ldi8 01h
+//  0004 sti32          0021 sadd           0035 sadd
+//  0005 cts 01h        0022 cts 01h        0036 cts 01h
+//  0007 ldlo8 2        0024 jmp -17        0038 esync 0
+//  0009 ldlo8 0        0029 bsync 0        0040 ldlo8 2
+//  0011 lt                                 0042 ret
+//  0012 jfc 17
+const uint8_t testProgram[] = ""
+    "PROCEDURE p(a INT32, b INT32) RETURN INT32\n"
+    "DO\n"
+    "  VAR i INT32;\n"
+    "  i = 0;\n"
+    "  WHILE (i < a) DO\n"
+    "    i += b;\n"
+    "  END\n"
+    "  SYNC\n"
+    "    i += 1;\n"
+    "  ENDSYNC\n"
+    "  RETURN i;\n"
+    "ENDPROC\n"
+    "\n";
+
+static const uint_t TEST_CODE_SIZE = 43;
+
+
+struct CodeChange
+{
+  const char* mDescription;
+  uint_t      mPosition;
+  uint8_t     mValue;
+};
+
+
+static const CodeChange codeChanges[] = {
+    { "an unknown local",              1,  3 },
+    { "a stack underflow",             6,  3 },
+    { "a jump inside an instruction",  13, 18 },
+    { "a jump outside the code",       28, 0x7F },
+    { "different stack depths",        12, W_JF },
+    { "an unknown sync statement",     30, 1 },
+    { "an invalid opcode",             21, W_OP_END_MARK },
+    { "a missing return",              42, W_NOT }
+  };
+
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+//A unit whose procedure's code was altered has to be rejected when loaded.
+static bool
+test_rejected(ISession& session, const CodeChange& change)
+{
+  std::cout << "Testing the rejection of " << change.mDescription << " ... ";
+
+  CompiledBufferUnit unit(testProgram, sizeof testProgram, my_postman, testProgram);
+
+  if (unit.ProcCodeAreaSize(0) != TEST_CODE_SIZE)
+  {
+    std::cout << "FAIL (the code has changed)" << std::endl;
+    return false;
+  }
+
+  uint8_t* const code = _CC(uint8_t*, unit.RetriveProcCodeArea(0));
+  code[change.mPosition] = change.mValue;
+
+  bool result = false;
+  try
+  {
+    session.LoadCompiledUnit(unit);
+  }
+  catch (InterException& e)
+  {
+    result = (e.Code() == InterException::INVALID_UNIT_CODE);
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+//The unaltered unit has to load fine after the rejected ones, as these
+//should have left nothing defined.
+static bool
+test_accepted(ISession& session)
+{
+  std::cout << "Testing the unaltered code ... ";
+
+  CompiledBufferUnit unit(testProgram, sizeof testProgram, my_postman, testProgram);
+
+  session.LoadCompiledUnit(unit);
+
+  SessionStack stack;
+  stack.Push(DInt32(5));
+  stack.Push(DInt32(2));
+
+  session.ExecuteProcedure("p", stack);
+
+  DInt32 result;
+  stack[0].Operand().GetValue(result);
+  stack.Pop(1);
+
+  const bool success = (result == DInt32(7));
+
+  std::cout << (success ? "OK" : "FAIL") << std::endl;
+  return success;
+}
+
+
+//The code changed in place after the unit was loaded has to be verified
+//again before it runs.
+static bool
+test_changed(ISession& session)
+{
+  std::cout << "Testing the code changed after its loading ... ";
+
+  Session& prima = _SC(Session&, session);
+  const Procedure& proc = prima.GetProcedure(prima.FindProcedure(_RC(const uint8_t*, "p"), 1));
+  uint8_t* const code = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+
+  const CodeChange& change = codeChanges[0];
+  const uint8_t original = code[change.mPosition];
+
+  SessionStack stack;
+  bool result = false;
+
+  code[change.mPosition] = change.mValue;
+  proc.mProcMgr->InvalidateDecoded(proc);
+
+  try
+  {
+    stack.Push(DInt32(5));
+    stack.Push(DInt32(2));
+
+    session.ExecuteProcedure("p", stack);
+  }
+  catch (InterException& e)
+  {
+    result = (e.Code() == InterException::INVALID_UNIT_CODE);
+  }
+
+  code[change.mPosition] = original;
+  proc.mProcMgr->InvalidateDecoded(proc);
+
+  stack.Pop(stack.Size());
+  stack.Push(DInt32(5));
+  stack.Push(DInt32(2));
+
+  session.ExecuteProcedure("p", stack);
+
+  DInt32 value;
+  stack[0].Operand().GetValue(value);
+  stack.Pop(1);
+
+  result = result && (value == DInt32(7));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+run_p(ISession& session)
+{
+  SessionStack stack;
+
+  stack.Push(DInt32(5));
+  stack.Push(DInt32(2));
+
+  session.ExecuteProcedure("p", stack);
+
+  DInt32 value;
+  stack[0].Operand().GetValue(value);
+  stack.Pop(1);
+
+  return value == DInt32(7);
+}
+
+
+static bool
+test_dropped_decoded(ISession& session)
+{
+  std::cout << "Testing the release of the dropped decoded code ... ";
+
+  Session& prima = _SC(Session&, session);
+  const Procedure& proc = prima.GetProcedure(prima.FindProcedure(_RC(const uint8_t*, "p"), 1));
+
+  //The decoded code is kept as long as some one still runs it.
+  SHARED_DECODED_CODE running = proc.mProcMgr->Instructions(proc, prima);
+  std::weak_ptr<const DECODED_CODE> dropped = running;
+
+  proc.mProcMgr->InvalidateDecoded(proc);
+
+  bool result = run_p(session) && ! dropped.expired();
+
+  running.reset();
+  result = result && dropped.expired();
+
+  //Changing the code again and again does not pile up its decoded forms.
+  const size_t memUsed = test_get_mem_used();
+  for (uint_t i = 0; result && (i < 100); ++i)
+  {
+    proc.mProcMgr->InvalidateDecoded(proc);
+    result = run_p(session);
+  }
+
+  result = result && (test_get_mem_used() == memUsed);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  DBSCreateDatabase(testDb);
+  InitInterpreter();
+
+  {
+    ISession& session = GetInstance(testDb);
+
+    for (const auto& change : codeChanges)
+      success = test_rejected(session, change) && success;
+
+    success = success && test_accepted(session);
+    success = success && test_changed(session);
+    success = success && test_dropped_decoded(session);
+
+    ReleaseInstance(session);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSRemoveDatabase(testDb);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
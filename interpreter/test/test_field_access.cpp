@@ -0,0 +1,424 @@
+/*
+ * test_field_access.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t fieldsProgram[] = ""
+    "PROCEDURE scan_rows(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR t TABLE(id UINT32, v INT64, r REAL);\n"
+    "  VAR i UINT32;\n"
+    "  VAR s1 INT64;\n"
+    "  VAR s2 INT64;\n"
+    "  VAR s3 INT64;\n"
+    "  VAR nulls INT64;\n"
+    "  VAR f INT64 FIELD;\n"
+    "\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    t.id[i] = i;\n"
+    "    IF (i % 7 != 0)\n"
+    "      t.v[i] = i * 3;\n"
+    "  END\n"
+    "\n"
+    "  s1 = 0; s2 = 0; s3 = 0; nulls = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    IF (t.v[i] == NULL)\n"
+    "      nulls += 1;\n"
+    "    ELSE\n"
+    "      s1 += t.v[i];\n"
+    "  END\n"
+    "\n"
+    "  FOR (x : t.v)\n"
+    "    s2 += x;\n"
+    "\n"
+    "  f = t.v;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s3 += f[i];\n"
+    "\n"
+    "  IF ((s1 != s2) OR (s1 != s3))\n"
+    "    RETURN -1;\n"
+    "\n"
+    "  RETURN s1 * 1000 + nulls;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE scan_updates(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR t TABLE(v INT64);\n"
+    "  VAR i UINT32;\n"
+    "  VAR s INT64;\n"
+    "\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    t.v[i] = i;\n"
+    "\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    t.v[i] = t.v[i] * 2;\n"
+    "    s += t.v[i];\n"
+    "    IF (i + 1 < n)\n"
+    "      s += t.v[i + 1];\n"
+    "  END\n"
+    "\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE scan_passes(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR t TABLE(v INT32);\n"
+    "  VAR i UINT32;\n"
+    "  VAR p UINT32;\n"
+    "  VAR s INT64;\n"
+    "\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    t.v[i] = i % 100;\n"
+    "\n"
+    "  s = 0;\n"
+    "  FOR (p = 0; p < 20; p += 1)\n"
+    "    FOR (i = 0; i < n; i += 1)\n"
+    "      s += t.v[i];\n"
+    "\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE scan_tables(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR t1 TABLE(v INT64);\n"
+    "  VAR t2 TABLE(v INT64);\n"
+    "  VAR t TABLE(v INT64);\n"
+    "  VAR i UINT32;\n"
+    "  VAR s INT64;\n"
+    "\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    t1.v[i] = 1;\n"
+    "    t2.v[i] = 2;\n"
+    "  END\n"
+    "\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "  DO\n"
+    "    IF (i % 2 == 0)\n"
+    "      t = t1;\n"
+    "    ELSE\n"
+    "      t = t2;\n"
+    "    s += t.v[i];\n"
+    "  END\n"
+    "\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE scan_fails(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR t TABLE(v INT64);\n"
+    "  VAR a INT64 ARRAY;\n"
+    "  VAR i UINT32;\n"
+    "\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    t.v[i] = i;\n"
+    "\n"
+    "  a[1] = t.v[0];\n"
+    "  RETURN a[1];\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+static bool
+run_procedure(ISession& session,
+              const char* const procName,
+              const uint32_t arg,
+              const DInt64& expected)
+{
+  std::cout << "Running '" << procName << "(" << arg << ")' ... ";
+
+  SessionStack stack;
+  stack.Push(DUInt32(arg));
+
+  const WTICKS start = wh_msec_ticks();
+  session.ExecuteProcedure(procName, stack);
+  const WTICKS ticks = wh_msec_ticks() - start;
+
+  DInt64 result;
+  stack[0].Operand().GetValue(result);
+
+  const bool success = (stack.Size() == 1) && (result == expected);
+
+  std::cout << ticks << "ms " << (success ? "OK" : "FAIL") << std::endl;
+  return success;
+}
+
+
+static bool
+test_procedures(ISession& session, const uint32_t rowsCount)
+{
+  int64_t sum = 0, nulls = 0;
+  for (uint32_t i = 0; i < rowsCount; ++i)
+  {
+    if (i % 7 == 0)
+      ++nulls;
+
+    else
+      sum += i * 3;
+  }
+
+  int64_t updates = 0;
+  for (uint32_t i = 0; i < rowsCount; ++i)
+    updates += 2 * i + ((i + 1 < rowsCount) ? i + 1 : 0);
+
+  bool result = run_procedure(session, "scan_rows", rowsCount, DInt64(sum * 1000 + nulls));
+  result = result && run_procedure(session, "scan_updates", rowsCount, DInt64(updates));
+  int64_t passes = 0;
+  for (uint32_t i = 0; i < rowsCount; ++i)
+    passes += 20 * (i % 100);
+
+  result = result && run_procedure(session, "scan_passes", rowsCount, DInt64(passes));
+  result = result && run_procedure(session, "scan_tables", rowsCount, DInt64(rowsCount / 2 * 3));
+
+  return result;
+}
+
+
+//A call that fails must not keep referenced the tables its cached field
+//accesses are bound to.
+static bool
+run_failing_call(ISession& session)
+{
+  SessionStack stack;
+  stack.Push(DUInt32(100));
+
+  try
+  {
+    session.ExecuteProcedure("scan_fails", stack);
+  }
+  catch (Exception&)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+
+//A call that fails must not keep referenced the tables its cached field
+//accesses are bound to.
+static bool
+test_failed_call(ISession& session)
+{
+  std::cout << "Releasing the tables of a failed call ... ";
+
+  bool result = run_failing_call(session);
+
+  const size_t memUsed = test_get_mem_used();
+  for (uint_t i = 0; i < 10; ++i)
+    result = run_failing_call(session) && result;
+
+  result = result && (test_get_mem_used() == memUsed);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+struct WriterContext
+{
+  ITable*         mTable;
+  ROW_INDEX       mRowsCount;
+  volatile bool   mEnd;
+};
+
+
+//Keep the rows values either all of their bytes set or all of them clear.
+static void
+writer_routine(void* args)
+{
+  WriterContext* const context = _RC(WriterContext*, args);
+
+  for (uint_t pass = 0; ! context->mEnd; ++pass)
+  {
+    const DUInt64 value((pass & 1) ? ~_SC(uint64_t, 0) : 0);
+
+    for (ROW_INDEX row = 0; row < context->mRowsCount; ++row)
+      context->mTable->Set(row, 0, value);
+  }
+}
+
+
+static bool
+test_concurrent_writes(IDBSHandler& dbs, const ROW_INDEX rowsCount)
+{
+  std::cout << "Reading the rows while they are changed ... ";
+
+  DBSFieldDescriptor field = {"v", T_UINT64, false};
+  ITable& table = dbs.CreateTempTable(1, &field);
+
+  for (ROW_INDEX row = 0; row < rowsCount; ++row)
+    table.Set(row, 0, DUInt64(0));
+
+  IFieldAccess& access = table.AccessField(0);
+  WriterContext context = {&table, rowsCount, false};
+
+  Thread writer;
+  writer.Run(writer_routine, &context);
+
+  bool result = true;
+  for (uint_t pass = 0; (pass < 20) && result; ++pass)
+  {
+    for (ROW_INDEX row = 0; (row < rowsCount) && result; ++row)
+    {
+      DUInt64 value;
+      access.Get(row, value);
+
+      result = (value == DUInt64(0)) || (value == DUInt64(~_SC(uint64_t, 0)));
+    }
+  }
+
+  context.mEnd = true;
+  writer.WaitToEnd();
+
+  DUInt64 value;
+  bool typeChecked = false;
+  try
+  {
+    DInt64 wrongType;
+    access.Get(0, wrongType);
+  }
+  catch (DBSException&)
+  {
+    typeChecked = true;
+  }
+
+  access.Get(rowsCount - 1, value);
+  result = result && typeChecked && ! value.IsNull();
+
+  access.Release();
+  dbs.ReleaseTable(table);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  uint32_t rowsCount = 20000;
+
+  if (argc > 1)
+    rowsCount = atol(argv[1]);
+
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& session = GetInstance(nullptr);
+
+    CompiledBufferUnit fieldsUnit(fieldsProgram,
+                                  sizeof fieldsProgram,
+                                  my_postman,
+                                  fieldsProgram);
+
+    session.LoadCompiledUnit(fieldsUnit);
+
+    success = success && test_procedures(session, rowsCount);
+    success = success && test_failed_call(session);
+
+    ReleaseInstance(session);
+  }
+
+  CleanInterpreter();
+
+  {
+    IDBSHandler& dbs = DBSRetrieveDatabase(admin);
+
+    success = success && test_concurrent_writes(dbs, 5000);
+
+    DBSReleaseDatabase(dbs);
+  }
+
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,379 @@
+/*
+ * test_opcode_profile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+#include "interpreter/prima/pm_opprofile.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t profileProgram[] = ""
+    "VAR gStep UINT64;\n"
+    "\n"
+    "PROCEDURE sum_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += i * 3;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE global_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  gStep = 7;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += gStep;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE array_loop(n UINT32) RETURN INT64\n"
+    "DO\n"
+    "  VAR a INT64 ARRAY;\n"
+    "  VAR i UINT32;\n"
+    "  VAR r INT64;\n"
+    "  r = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    a[i] = i * 2;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    r += a[i];\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE text_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR t TEXT;\n"
+    "  VAR i UINT32;\n"
+    "  VAR c UINT64;\n"
+    "  t = \"whais\";\n"
+    "  c = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    IF (t[i % 5] == 'a')\n"
+    "      c += 1;\n"
+    "  RETURN c;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE fib(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n < 2)\n"
+    "    RETURN n;\n"
+    "  RETURN fib(n - 1) + fib(n - 2);\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+struct ProcedureRun
+{
+  const char*   mName;
+  uint32_t      mArg;
+  uint64_t      mExpected;
+};
+
+
+static const Procedure&
+get_procedure(Session& session, const char* const procName)
+{
+  const uint32_t procId = session.FindProcedure(_RC(const uint8_t*, procName),
+                                                strlen(procName));
+  return session.GetProcedure(procId);
+}
+
+
+template <typename DBS_T> static bool
+run_procedure(Session& session, const ProcedureRun& run)
+{
+  SessionStack stack;
+
+  stack.Push(DUInt32(run.mArg));
+
+  session.ExecuteProcedure(run.mName, stack);
+
+  if (stack.Size() != 1)
+    return false;
+
+  DBS_T result;
+  stack[0].Operand().GetValue(result);
+
+  return result == DBS_T(run.mExpected);
+}
+
+
+static bool
+run_procedure(Session& session, const ProcedureRun& run)
+{
+  if ((strcmp(run.mName, "array_loop") == 0))
+    return run_procedure<DInt64>(session, run);
+
+  return run_procedure<DUInt64>(session, run);
+}
+
+
+//Count how many instructions are dispatched when the procedure's code runs
+//as it was profiled.
+static uint64_t
+dispatches_count(Session& session,
+                 const Procedure& proc,
+                 const std::vector<uint64_t>& counts)
+{
+  const uint8_t* const code = proc.mProcMgr->Code(proc, nullptr);
+
+  DECODED_CODE instructions;
+
+  ProcedureCall::DecodeCode(proc, code, session, instructions);
+
+  uint64_t result = 0;
+  for (auto& instr : instructions)
+  {
+    if (instr.mCodePos < counts.size())
+      result += counts[instr.mCodePos];
+  }
+
+  return result;
+}
+
+
+static bool
+test_profile(Session& session,
+             const ProcedureRun* const runs,
+             const uint_t runsCount,
+             const char* const dumpFile)
+{
+  std::cout << "Profiling the procedures' opcodes ... ";
+
+  bool result = true;
+
+  OpcodeProfile::Reset();
+  EnableOpcodeProfile(true);
+  for (uint_t i = 0; (i < runsCount) && result; ++i)
+  {
+    result = run_procedure(session, runs[i]);
+  }
+  EnableOpcodeProfile(false);
+
+  //The single opcodes' counts have to add up to the executed instructions.
+  std::ostringstream dump;
+  OpcodeProfile::Dump(dump);
+
+  uint_t sequences = 0;
+  for (uint_t i = 0; (i < runsCount) && result; ++i)
+  {
+    std::vector<uint64_t> counts;
+    result = OpcodeProfile::Counts(runs[i].mName, counts);
+
+    uint64_t total = 0;
+    for (auto count : counts)
+      total += count;
+
+    std::istringstream lines(dump.str());
+    std::string line;
+    uint64_t dumped = 0;
+    uint_t ngrams = 0;
+
+    while (std::getline(lines, line))
+    {
+      std::istringstream fields(line);
+      std::string procName, opcode;
+      uint64_t count;
+      uint_t length = 0;
+
+      fields >> procName >> count;
+      while (fields >> opcode)
+        ++length;
+
+      if (procName != runs[i].mName)
+        continue;
+
+      ++ngrams;
+      if (length == 1)
+        dumped += count;
+
+      else
+        ++sequences;
+    }
+
+    result = result && (total > runs[i].mArg) && (dumped == total) && (ngrams > 5);
+  }
+
+  //Only a few sequences are left to the generic handlers, but some are.
+  result = result && (sequences > 0);
+
+  if (result && (dumpFile != nullptr))
+    result = DumpOpcodeProfile(dumpFile);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_dispatches(Session& session, const ProcedureRun* const runs, const uint_t runsCount)
+{
+  bool result = true;
+  uint64_t totalExecuted = 0, totalDecoded = 0;
+
+  for (uint_t i = 0; (i < runsCount) && result; ++i)
+  {
+    std::cout << "Counting the dispatches of '" << runs[i].mName << "' ... ";
+
+    std::vector<uint64_t> counts;
+    result = OpcodeProfile::Counts(runs[i].mName, counts);
+
+    uint64_t executed = 0;
+    for (auto count : counts)
+      executed += count;
+
+    const Procedure& proc = get_procedure(session, runs[i].mName);
+    const uint64_t decoded = dispatches_count(session, proc, counts);
+
+    result = result && (decoded <= executed);
+
+    totalExecuted += executed;
+    totalDecoded += decoded;
+
+    std::cout << "opcodes " << executed << ", decoded " << decoded << ' ';
+    std::cout << (result ? "OK" : "FAIL") << std::endl;
+  }
+
+  std::cout << "The decoded code dispatches " << totalDecoded << " out of "
+            << totalExecuted << " instructions ... ";
+
+  result = result && (totalDecoded < totalExecuted);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static uint64_t
+expected_fib(const uint32_t n)
+{
+  return (n < 2) ? n : expected_fib(n - 1) + expected_fib(n - 2);
+}
+
+
+//Run it with a file name to keep the profile.
+int
+main(int argc, char **argv)
+{
+  const uint32_t n = 50000;
+  const uint32_t fibArg = 18;
+
+  const ProcedureRun runs[] = {
+      {"sum_loop", n, 3ull * n * (n - 1) / 2},
+      {"global_loop", n, 7ull * n},
+      {"array_loop", n / 10, (n / 10ull) * (n / 10 - 1)},
+      {"text_loop", n, n / 5},
+      {"fib", fibArg, expected_fib(fibArg)}
+  };
+  const uint_t runsCount = sizeof runs / sizeof runs[0];
+
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& commonSession = GetInstance(nullptr);
+    Session& session = _SC(Session&, commonSession);
+
+    CompiledBufferUnit profileUnit(profileProgram,
+                                 sizeof profileProgram,
+                                 my_postman,
+                                 profileProgram);
+
+    commonSession.LoadCompiledUnit(profileUnit);
+
+    success = success && test_profile(session, runs, runsCount, (argc > 1) ? argv[1] : nullptr);
+    success = success && test_dispatches(session, runs, runsCount);
+
+    OpcodeProfile::Reset();
+    ReleaseInstance(commonSession);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
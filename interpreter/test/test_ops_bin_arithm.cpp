@@ -93,6 +93,7 @@ test_op_addXX(Session& session,
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -135,6 +136,7 @@ test_op_addt(Session& session,
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -178,6 +180,7 @@ test_op_subXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -219,6 +222,7 @@ test_op_mulXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -261,6 +265,7 @@ test_op_divXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -302,6 +307,7 @@ test_op_mod(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
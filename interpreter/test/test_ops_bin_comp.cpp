@@ -92,6 +92,7 @@ test_op_eqXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -133,6 +134,7 @@ test_op_neXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -174,6 +176,7 @@ test_op_ltXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -215,6 +218,7 @@ test_op_leXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -256,6 +260,7 @@ test_op_gtXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -297,6 +302,7 @@ test_op_geXX(Session& session,
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -201,6 +201,7 @@ test_op_cts(Session& session)
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DInt8 op(-10);
@@ -232,6 +233,7 @@ test_op_inull(Session& session)
                                                  sizeof inull_proc - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DDate op;
@@ -266,6 +268,7 @@ test_op_nnull(Session& session)
                                                  sizeof nnull_proc - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DDate op;
@@ -473,6 +476,7 @@ test_op_jfc(Session& session)
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBool op(false);
@@ -532,6 +536,7 @@ test_op_jtc(Session& session)
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBool op(true);
@@ -591,6 +596,7 @@ test_op_jf(Session& session)
                                                  sizeof field_proc - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBool op(false);
@@ -649,6 +655,7 @@ test_op_jt(Session& session)
                                                  sizeof field_proc - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBool op(true);
@@ -708,6 +715,7 @@ test_op_jmp(Session& session)
                                                  sizeof field_proc - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBool op(true);
@@ -88,6 +88,7 @@ test_op_ldnull(Session& session)
   const uint32_t procId = session.FindProcedure(_RC(const uint8_t*, procName), sizeof procName - 1);
   const Procedure& proc = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -117,6 +118,7 @@ test_op_ldc(Session& session)
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -151,6 +153,7 @@ test_op_ldi8(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -183,6 +186,7 @@ test_op_ldi16(Session& session)
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -215,6 +219,7 @@ test_op_ldi32(Session& session)
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -248,6 +253,7 @@ test_op_ldi64(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -285,6 +291,7 @@ test_op_ldd(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -319,6 +326,7 @@ test_op_lddt(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -356,6 +364,7 @@ test_op_ldht(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -398,6 +407,7 @@ test_op_ldrr(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -448,6 +458,7 @@ test_op_ldt(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -484,6 +495,7 @@ test_op_ldbt(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
@@ -514,6 +526,7 @@ test_op_ldbf(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
 
   SessionStack stack;
 
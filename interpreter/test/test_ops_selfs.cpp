@@ -91,6 +91,7 @@ test_op_saddXX(Session& session,
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -139,6 +140,7 @@ test_op_ssubXX(Session& session,
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -186,6 +188,7 @@ test_op_smulXX(Session& session,
                                                  sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -233,6 +236,7 @@ test_op_sdivXX(Session& session,
                                                  sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -281,6 +285,7 @@ test_op_smodXX(Session& session,
 
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -328,6 +333,7 @@ test_op_sandXX(Session& session,
                                                  sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -375,6 +381,7 @@ test_op_sxorXX(Session& session,
                                                  sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -422,6 +429,7 @@ test_op_sorXX(Session& session,
                                                  sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -89,6 +89,7 @@ test_op_stb(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBool op;
@@ -133,6 +134,7 @@ test_op_stc(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DChar op;
@@ -177,6 +179,7 @@ test_op_std(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DDate op;
@@ -222,6 +225,7 @@ test_op_stdt(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DDateTime op;
@@ -266,6 +270,7 @@ test_op_stht(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DHiresTime op;
@@ -308,6 +313,7 @@ test_op_stXX(Session& session, const W_OPCODE code, const char*  pText)
                                                 sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DBS_T op;
@@ -350,6 +356,7 @@ test_op_stud(Session& session, const DBS_T refValue, const char*  pText)
                                                 sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -395,6 +402,7 @@ test_op_stud_array(Session& session, const DBS_T refValue, const char*  pText)
                                                 sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -458,6 +466,7 @@ test_op_stud_text(Session& session, const DText& refValue)
                                                 sizeof procName - 1);
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   uint8_t opSize = 0;
@@ -514,6 +523,7 @@ test_op_stt(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DText op;
@@ -558,6 +568,7 @@ test_op_stta(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   const DUInt32 firstVal(0x31);
@@ -616,6 +627,7 @@ test_op_stf(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   const DUInt32 firstVal(0x31);
@@ -676,6 +688,7 @@ test_op_sta(Session& session)
                                                 );
   const Procedure& proc   = session.GetProcedure(procId);
   uint8_t* testCode = _CC(uint8_t*, proc.mProcMgr->Code(proc, nullptr));
+  proc.mProcMgr->InvalidateDecoded(proc);
   SessionStack stack;
 
   DArray op;
@@ -0,0 +1,459 @@
+/*
+ * test_optimized_code.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+#include <chrono>
+
+#include "compiler/compiledunit.h"
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+using namespace whais;
+
+static const char admin[]    = "administrator";
+static const char plainDb[]  = "t_testdb_plain";
+static const char optDb[]    = "t_testdb_opt";
+
+const uint8_t testProgram[] = ""
+    "PROCEDURE consts() RETURN INT64\n"
+    "DO\n"
+    "  RETURN 2 + 3 * 4 - 100 / 7 + 17 % 5;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE negative() RETURN INT64\n"
+    "DO\n"
+    "  RETURN 3 - 5;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE branches(a INT32) RETURN INT32\n"
+    "DO\n"
+    "  VAR unused INT32;\n"
+    "  unused = 7;\n"
+    "  IF (TRUE) DO\n"
+    "    a = a + 1;\n"
+    "  ELSE DO\n"
+    "    a = a - 1;\n"
+    "  END\n"
+    "  IF (FALSE)\n"
+    "    a = 100;\n"
+    "  WHILE (a > 10) DO\n"
+    "    IF (a > 50) DO\n"
+    "      a = a - 5;\n"
+    "    ELSE DO\n"
+    "      a = a - 1;\n"
+    "    END\n"
+    "  END\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE nulls(a INT32) RETURN BOOL\n"
+    "DO\n"
+    "  IF (NOT (a == NULL))\n"
+    "    RETURN NULL == NULL;\n"
+    "  RETURN (5 > 3) AND (1 < 2) AND (a != NULL);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE not_cond(a BOOL) RETURN INT32\n"
+    "DO\n"
+    "  IF (NOT a)\n"
+    "    RETURN 1;\n"
+    "  IF (NOT (a AND TRUE)) DO\n"
+    "    RETURN 2;\n"
+    "  ELSE DO\n"
+    "    RETURN 3;\n"
+    "  END\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE mixed(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR t INT64;\n"
+    "  VAR d INT64;\n"
+    "  d = 4;\n"
+    "  t = 100 / 7 + (a % 3);\n"
+    "  IF (3 > 4)\n"
+    "    t = 0;\n"
+    "  RETURN t * 2 - 1;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE sum_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += i * 3;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE sq(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  RETURN a * a + 1;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE clamp(a INT64, lo INT64, hi INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR t INT64;\n"
+    "  t = a;\n"
+    "  IF (t < lo)\n"
+    "    RETURN lo;\n"
+    "  IF (t > hi)\n"
+    "    RETURN hi;\n"
+    "  RETURN t;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE maybe(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR t INT64;\n"
+    "  IF (a > 5)\n"
+    "    t = a;\n"
+    "  RETURN t;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE inc_arg(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  a = a + 1;\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "#@noinline\n"
+    "PROCEDURE kept(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  RETURN a - 1;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE inlined(x INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR s INT64;\n"
+    "  VAR i INT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < 10; i += 1) DO\n"
+    "    s += sq(i) + clamp(x, i, 2 * i) + inc_arg(x) + kept(i) + clamp(sq(i), x, 100);\n"
+    "    IF (maybe(i) == NULL)\n"
+    "      s += 1000;\n"
+    "  END\n"
+    "  RETURN s * 1000 + x;\n"
+    "ENDPROC\n"
+    "\n"
+    "#@noinline\n"
+    "PROCEDURE bump(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  a = a + 1;\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE hoisted(n INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR s INT64;\n"
+    "  VAR i INT64;\n"
+    "  VAR j INT64;\n"
+    "  VAR k INT64;\n"
+    "  s = 0;\n"
+    "  k = n % 7;\n"
+    "  IF (n > 3)\n"
+    "    k = k + 1;\n"
+    "  FOR (i = 0; i < (n % 10) * 2; i += 1) DO\n"
+    "    j = 10;\n"
+    "    WHILE (j > k - 2) DO\n"
+    "      s += i * 5 + (i * 5) % 3 + (i * 5) / 4 + k * k + j * (n % 3 + 1);\n"
+    "      j -= 1;\n"
+    "    END\n"
+    "    IF (i * 5 > 20)\n"
+    "      k = k + 1;\n"
+    "  END\n"
+    "  FOR (i = 20; i > 0; i -= 2)\n"
+    "    s += i * 3 + (i * 3) % 7 + (i * 3) / 5 + (n - k);\n"
+    "  FOR (i = 0; i < 3; i += 1)\n"
+    "    s += bump(n) + n * 2;\n"
+    "  RETURN s * 1000 + k;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE licm_bench(n INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR s INT64;\n"
+    "  VAR i INT64;\n"
+    "  VAR k INT64;\n"
+    "  s = 0;\n"
+    "  k = n % 7;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += (i * 3) % 11 + (i * 3) % 13 + (i * 3) % 17 + (k * k + 1);\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE bench(n INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR s INT64;\n"
+    "  VAR i INT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += clamp(sq(i % 100), 10, 5000);\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE pass_on(a UNDEFINED) RETURN UNDEFINED\n"
+    "DO\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE pass_twice(a UNDEFINED, b ARRAY) RETURN UNDEFINED\n"
+    "DO\n"
+    "  IF (b == NULL)\n"
+    "    RETURN pass_on(a);\n"
+    "  RETURN pass_on(pass_on(a));\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE set_arg(a UNDEFINED) RETURN UNDEFINED\n"
+    "DO\n"
+    "  a = 5;\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE specialized(x INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR r INT64;\n"
+    "  VAR t INT64;\n"
+    "  VAR b INT8 ARRAY;\n"
+    "  r = pass_twice(x, b);\n"
+    "  b[0] = 1;\n"
+    "  t = pass_twice(x, b);\n"
+    "  r = r + t;\n"
+    "  t = pass_on(x);\n"
+    "  r = r + t * 2;\n"
+    "  t = set_arg(x);\n"
+    "  RETURN r + t;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE typed_ops(a INT64) RETURN INT64\n"
+    "DO\n"
+    "  VAR i INT32;\n"
+    "  VAR u UINT16;\n"
+    "  VAR w UINT64;\n"
+    "  VAR r INT64;\n"
+    "  i = a; u = a; w = a;\n"
+    "  r = i * i - i + i;\n"
+    "  IF (r == NULL) r = -1;\n"
+    "  IF (i < i + 1) r += 1;\n"
+    "  IF (u >= u) r += 2;\n"
+    "  IF (w * w > w) r += 4;\n"
+    "  IF (u == u) r += 8;\n"
+    "  IF (i != i + 2) r += 16;\n"
+    "  IF (a <= a - 1) r += 32;\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+//Run the same procedure with both versions of the code and compare the results.
+template <typename DBS_R, typename DBS_A> static bool
+test_same_result(ISession& plain,
+                 ISession& optimized,
+                 const char* const procedure,
+                 const DBS_A* const arg)
+{
+  DBS_R results[2];
+  ISession* const sessions[] = { &plain, &optimized };
+
+  for (uint_t i = 0; i < 2; ++i)
+  {
+    SessionStack stack;
+
+    if (arg != nullptr)
+      stack.Push( *arg);
+
+    sessions[i]->ExecuteProcedure(procedure, stack);
+
+    if (stack.Size() != 1)
+      return false;
+
+    stack[0].Operand().GetValue(results[i]);
+    stack.Pop(1);
+  }
+
+  return results[0] == results[1];
+}
+
+
+template <typename DBS_R, typename DBS_A> static bool
+test_procedure(ISession& plain,
+               ISession& optimized,
+               const char* const procedure,
+               const std::vector<DBS_A>& args)
+{
+  std::cout << "Testing '" << procedure << "' ... ";
+
+  bool result = true;
+  if (args.empty())
+    result = test_same_result<DBS_R, DBS_A>(plain, optimized, procedure, nullptr);
+
+  for (const auto& arg : args)
+    result = result && test_same_result<DBS_R, DBS_A>(plain, optimized, procedure, &arg);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+//Time the calls of a procedure in both versions of the code.
+static void
+benchmark_procedure(ISession& plain,
+                    ISession& optimized,
+                    const char* const procedure,
+                    const DInt64& arg)
+{
+  ISession* const sessions[] = { &plain, &optimized };
+  double times[2];
+
+  for (uint_t i = 0; i < 2; ++i)
+  {
+    SessionStack stack;
+    stack.Push(arg);
+
+    const auto start = std::chrono::steady_clock::now();
+    sessions[i]->ExecuteProcedure(procedure, stack);
+    const auto end = std::chrono::steady_clock::now();
+
+    times[i] = std::chrono::duration<double, std::milli>(end - start).count();
+    stack.Pop(1);
+  }
+
+  std::cout << "Benchmark '" << procedure << "': " << times[0] << " ms plain, "
+            << times[1] << " ms optimized" << std::endl;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  DBSCreateDatabase(plainDb);
+  DBSCreateDatabase(optDb);
+  InitInterpreter();
+
+  {
+    ISession& plainSession = GetInstance(plainDb);
+    ISession& optSession   = GetInstance(optDb);
+
+    CompiledBufferUnit plainUnit(testProgram,
+                                 sizeof testProgram,
+                                 my_postman,
+                                 testProgram);
+
+    CompiledBufferUnit optUnit(testProgram,
+                               sizeof testProgram,
+                               my_postman,
+                               testProgram,
+                               WHC_OPTIMIZE_CODE);
+
+    plainSession.LoadCompiledUnit(plainUnit);
+    optSession.LoadCompiledUnit(optUnit);
+
+    //A null value would make the loops of 'branches', 'hoisted' and 'bench' endless.
+    const std::vector<DInt32> ints = { DInt32(0), DInt32(5), DInt32(11),
+                                       DInt32(52), DInt32(100), DInt32(-20) };
+    const std::vector<DInt32> nullInts = { DInt32(), DInt32(0), DInt32(5) };
+    const std::vector<DInt64> longs = { DInt64(), DInt64(0), DInt64(7), DInt64(-8) };
+    const std::vector<DInt64> sizes = { DInt64(0), DInt64(1), DInt64(250) };
+    const std::vector<DInt64> bounds = { DInt64(0), DInt64(7), DInt64(13), DInt64(-8) };
+    const std::vector<DBool> bools = { DBool(), DBool(true), DBool(false) };
+    const std::vector<DUInt32> counts = { DUInt32(0), DUInt32(1), DUInt32(1000) };
+
+    success = success && test_procedure<DInt64, DInt32>(plainSession, optSession, "consts", {});
+    success = success && test_procedure<DInt64, DInt32>(plainSession, optSession, "negative", {});
+    success = success && test_procedure<DInt32>(plainSession, optSession, "branches", ints);
+    success = success && test_procedure<DBool>(plainSession, optSession, "nulls", nullInts);
+    success = success && test_procedure<DInt32>(plainSession, optSession, "not_cond", bools);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "mixed", longs);
+    success = success && test_procedure<DUInt64>(plainSession, optSession, "sum_loop", counts);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "inlined", longs);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "hoisted", bounds);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "licm_bench", sizes);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "bench", sizes);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "specialized", longs);
+    success = success && test_procedure<DInt64>(plainSession, optSession, "typed_ops", longs);
+
+    if (success)
+    {
+      benchmark_procedure(plainSession, optSession, "bench", DInt64(1000000));
+      benchmark_procedure(plainSession, optSession, "licm_bench", DInt64(1000000));
+    }
+
+    ReleaseInstance(plainSession);
+    ReleaseInstance(optSession);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSRemoveDatabase(plainDb);
+  DBSRemoveDatabase(optDb);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,329 @@
+/*
+ * test_proc_profile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+#include <algorithm>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t profileProgram[] = ""
+    "PROCEDURE sum_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += i;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE fib(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n < 2)\n"
+    "    RETURN n;\n"
+    "  RETURN fib(n - 1) + fib(n - 2);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE twice(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  RETURN sum_loop(n) + sum_loop(n);\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+static bool
+run_procedure(ISession& session, const char* const name, const uint32_t n, const uint64_t expected)
+{
+  SessionStack stack;
+  stack.Push(DUInt32(n));
+
+  session.ExecuteProcedure(name, stack);
+
+  DUInt64 result;
+  stack[0].Operand().GetValue(result);
+
+  return (stack.Size() == 1) && (result == DUInt64(expected));
+}
+
+
+static bool
+test_disabled(ISession& session)
+{
+  std::cout << "Running with the profile disabled ... ";
+
+  EnableProcedureProfile(false);
+
+  bool result = run_procedure(session, "sum_loop", 1000, 999 * 1000 / 2);
+
+  ProcedureProfileStats stats;
+  std::vector<uint64_t> counts;
+  session.ProcedureProfile("sum_loop", stats, &counts);
+
+  result = result && ! IsProcedureProfileEnabled();
+  result = result && (stats.mCalls == 0) && (stats.mInstructions == 0);
+  result = result && counts.empty();
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_instruction_counts(ISession& session)
+{
+  std::cout << "Counting a loop's instructions ... ";
+
+  EnableProcedureProfile(true);
+  ResetProcedureProfile();
+
+  bool result = run_procedure(session, "sum_loop", 1000, 999 * 1000 / 2);
+  result = result && run_procedure(session, "sum_loop", 1000, 999 * 1000 / 2);
+
+  ProcedureProfileStats stats;
+  std::vector<uint64_t> counts;
+  session.ProcedureProfile("sum_loop", stats, &counts);
+
+  uint64_t total = 0, hottest = 0;
+  for (auto count : counts)
+    total += count, hottest = std::max(hottest, count);
+
+  result = result && (stats.mCalls == 2);
+  result = result && (stats.mInstructions == total);
+  result = result && (stats.mInstructions > 2 * 1000 * 3);
+
+  //The loop's condition is checked once more than its body is run.
+  result = result && (hottest >= 2 * 1000) && (hottest <= 2 * 1001);
+  result = result && (stats.mInclusiveTime == stats.mExclusiveTime);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_nested_calls(ISession& session)
+{
+  std::cout << "Separating the called procedures' times ... ";
+
+  ResetProcedureProfile();
+
+  bool result = run_procedure(session, "twice", 100000, 2ull * 99999 * 100000 / 2);
+
+  ProcedureProfileStats outer, inner;
+  session.ProcedureProfile("twice", outer);
+  session.ProcedureProfile("sum_loop", inner);
+
+  result = result && (outer.mCalls == 1) && (inner.mCalls == 2);
+  result = result && (outer.mInclusiveTime >= inner.mInclusiveTime);
+  result = result && (outer.mExclusiveTime < inner.mExclusiveTime);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_recursive_calls(ISession& session)
+{
+  std::cout << "Profiling recursive calls ... ";
+
+  ResetProcedureProfile();
+
+  bool result = run_procedure(session, "fib", 20, 6765);
+
+  ProcedureProfileStats stats;
+  session.ProcedureProfile("fib", stats);
+
+  //A recursive call's time is counted only once.
+  result = result && (stats.mCalls == 2 * 10946 - 1);
+  result = result && (stats.mInclusiveTime >= stats.mExclusiveTime);
+  result = result && (stats.mInclusiveTime <= stats.mExclusiveTime + stats.mExclusiveTime / 10 + 10);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_suspended_calls(ISession& session)
+{
+  std::cout << "Profiling the calls run in time slices ... ";
+
+  ResetProcedureProfile();
+
+  uint64_t timeSlice = 500;
+  session.NotifyEvent(ISession::PROCS_TIME_SLICE, &timeSlice);
+
+  SessionStack stack;
+  stack.Push(DUInt32(15));
+
+  std::unique_ptr<IResumableCall> call = session.StartProcedure("fib", stack);
+
+  uint_t suspends = 0;
+  while ( ! call->Resume())
+    ++suspends;
+
+  timeSlice = 0;
+  session.NotifyEvent(ISession::PROCS_TIME_SLICE, &timeSlice);
+
+  ProcedureProfileStats stats;
+  session.ProcedureProfile("fib", stats);
+
+  bool result = (suspends > 1) && (stats.mCalls == 2 * 987 - 1);
+
+  //An abandoned call has its profile recorded too.
+  stack.Pop(stack.Size());
+  stack.Push(DUInt32(15));
+
+  timeSlice = 500;
+  session.NotifyEvent(ISession::PROCS_TIME_SLICE, &timeSlice);
+
+  call = session.StartProcedure("fib", stack);
+  result = result && ! call->Resume();
+  call.reset();
+
+  timeSlice = 0;
+  session.NotifyEvent(ISession::PROCS_TIME_SLICE, &timeSlice);
+
+  session.ProcedureProfile("fib", stats);
+  result = result && (stats.mCalls > 2 * 987 - 1) && (stats.mCalls < 2 * (2 * 987 - 1));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_reset(ISession& session)
+{
+  std::cout << "Resetting the profile ... ";
+
+  ResetProcedureProfile();
+
+  ProcedureProfileStats stats;
+  std::vector<uint64_t> counts;
+  session.ProcedureProfile("sum_loop", stats, &counts);
+
+  bool result = (stats.mCalls == 0) && (stats.mInstructions == 0) && counts.empty();
+
+  EnableProcedureProfile(false);
+
+  result = result && run_procedure(session, "sum_loop", 10, 45);
+  session.ProcedureProfile("sum_loop", stats);
+  result = result && (stats.mCalls == 0);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& session = GetInstance(nullptr);
+
+    CompiledBufferUnit profileUnit(profileProgram,
+                                   sizeof profileProgram,
+                                   my_postman,
+                                   profileProgram);
+
+    session.LoadCompiledUnit(profileUnit);
+
+    success = success && test_disabled(session);
+    success = success && test_instruction_counts(session);
+    success = success && test_nested_calls(session);
+    success = success && test_recursive_calls(session);
+    success = success && test_suspended_calls(session);
+    success = success && test_reset(session);
+
+    ReleaseInstance(session);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
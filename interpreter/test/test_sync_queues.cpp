@@ -0,0 +1,427 @@
+/*
+ * test_sync_queues.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t queuesProgram[] = ""
+    "VAR gCounter UINT64;\n"
+    "\n"
+    "PROCEDURE reset_counter() RETURN UINT64\n"
+    "DO\n"
+    "  gCounter = 0;\n"
+    "  RETURN gCounter;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE sync_step(id UINT32, n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  SYNC\n"
+    "    s = gCounter;\n"
+    "    FOR (i = 0; i < n; i += 1)\n"
+    "      s += 1;\n"
+    "    gCounter = s * 10 + id;\n"
+    "  ENDSYNC\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE sync_add(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  SYNC\n"
+    "    s = gCounter;\n"
+    "    FOR (i = 0; i < n; i += 1)\n"
+    "      s += 1;\n"
+    "    gCounter = s;\n"
+    "  ENDSYNC\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+static void
+set_time_slice(ISession& session, const uint64_t instructions)
+{
+  uint64_t timeSlice = instructions;
+  session.NotifyEvent(ISession::PROCS_TIME_SLICE, &timeSlice);
+}
+
+
+static void
+set_wait_timeout(ISession& session, const uint64_t millisecs)
+{
+  uint64_t timeout = millisecs;
+  session.NotifyEvent(ISession::SYNC_WAIT_TMO, &timeout);
+}
+
+
+static uint64_t
+reset_counter(ISession& session)
+{
+  SessionStack stack;
+
+  session.ExecuteProcedure("reset_counter", stack);
+
+  DUInt64 result;
+  stack[0].Operand().GetValue(result);
+
+  return result.mValue;
+}
+
+
+static SyncStatementStats
+sync_stats(ISession& session, const char* const procName)
+{
+  SyncStatementStats stats;
+  session.ProcedureSyncStatementStats(procName, 0, stats);
+
+  return stats;
+}
+
+
+struct CallContext
+{
+  ISession*   mSession;
+  const char* mProcName;
+  uint32_t    mId;
+  uint32_t    mLoops;
+  uint_t      mCallsCount;
+  bool        mTimedOut;
+};
+
+
+static void
+call_routine(void* args)
+{
+  CallContext* const context = _RC(CallContext*, args);
+
+  for (uint_t i = 0; i < context->mCallsCount; ++i)
+  {
+    SessionStack stack;
+
+    if (strcmp(context->mProcName, "sync_step") == 0)
+      stack.Push(DUInt32(context->mId));
+
+    stack.Push(DUInt32(context->mLoops));
+
+    try
+    {
+      context->mSession->ExecuteProcedure(context->mProcName, stack);
+    }
+    catch (InterException& e)
+    {
+      if (e.Code() != InterException::SYNC_WAIT_TIMEOUT)
+        throw;
+
+      context->mTimedOut = true;
+    }
+  }
+}
+
+
+//Hold the synchronized statement of a procedure with a suspended call.
+static std::unique_ptr<IResumableCall>
+hold_sync(ISession& session, SessionStack& stack, const uint32_t loops)
+{
+  set_time_slice(session, 1000);
+
+  stack.Push(DUInt32(0));
+  stack.Push(DUInt32(loops));
+
+  std::unique_ptr<IResumableCall> call = session.StartProcedure("sync_step", stack);
+  call->Resume();
+
+  //The calls requested by the other threads have to block.
+  set_time_slice(session, 0);
+
+  return call;
+}
+
+
+static void
+run_to_end(IResumableCall& call)
+{
+  while ( ! call.Resume())
+    continue;
+}
+
+
+static bool
+test_contention(ISession& session, const uint64_t timeSlice)
+{
+  std::cout << "Contending for a synchronized statement (time slice "
+            << timeSlice << ") ... ";
+
+  const uint_t threadsCount = 4;
+  const uint_t callsCount   = 25;
+  const uint32_t loops      = 2000;
+
+  //The sliced calls wait in the same queue as the others.
+  set_time_slice(session, timeSlice);
+
+  bool result = (reset_counter(session) == 0);
+
+  const SyncStatementStats before = sync_stats(session, "sync_add");
+
+  Thread threads[threadsCount];
+  CallContext contexts[threadsCount];
+  for (uint_t t = 0; t < threadsCount; ++t)
+  {
+    contexts[t] = {&session, "sync_add", t, loops, callsCount, false};
+    threads[t].Run(call_routine, &contexts[t]);
+  }
+
+  for (uint_t t = 0; t < threadsCount; ++t)
+    threads[t].WaitToEnd();
+
+  set_time_slice(session, 0);
+
+  SessionStack stack;
+  stack.Push(DUInt32(0));
+  session.ExecuteProcedure("sync_add", stack);
+
+  DUInt64 counter;
+  stack[0].Operand().GetValue(counter);
+
+  const SyncStatementStats after = sync_stats(session, "sync_add");
+
+  result = result && (counter == DUInt64(threadsCount * callsCount * loops));
+  result = result && (after.mAquires - before.mAquires == threadsCount * callsCount + 1);
+  result = result && (after.mContentions <= after.mAquires);
+  result = result && (after.mTimeouts == before.mTimeouts);
+  result = result && (after.mWaiting == 0) && ! after.mHeld;
+  result = result && (after.mMaxWaitTime <= after.mWaitTime);
+  result = result && (session.ProcedureSyncStatementsCount("sync_add") == 1);
+  result = result && (session.ProcedureSyncStatementsCount("reset_counter") == 0);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_fifo_handoff(ISession& session)
+{
+  std::cout << "Entering the synchronized statement in the waiting order ... ";
+
+  const uint_t threadsCount = 3;
+
+  set_time_slice(session, 0);
+  set_wait_timeout(session, 0);
+
+  bool result = (reset_counter(session) == 0);
+
+  SessionStack holderStack;
+  std::unique_ptr<IResumableCall> holder = hold_sync(session, holderStack, 100000);
+
+  result = result && (holder->SuspendReason() == IResumableCall::TIME_SLICE_ENDED);
+  result = result && sync_stats(session, "sync_step").mHeld;
+
+  Thread threads[threadsCount];
+  CallContext contexts[threadsCount];
+  for (uint_t t = 0; (t < threadsCount) && result; ++t)
+  {
+    contexts[t] = {&session, "sync_step", t + 1, 0, 1, false};
+    threads[t].Run(call_routine, &contexts[t]);
+
+    //Let it queue before starting the next one.
+    while (sync_stats(session, "sync_step").mWaiting != t + 1)
+      wh_sleep(1);
+  }
+
+  run_to_end( *holder);
+
+  for (uint_t t = 0; t < threadsCount; ++t)
+    threads[t].WaitToEnd();
+
+  //Every call appends its identifier to the counter's decimal digits.
+  SessionStack stack;
+  stack.Push(DUInt32(0));
+  stack.Push(DUInt32(0));
+  session.ExecuteProcedure("sync_step", stack);
+
+  DUInt64 counter;
+  stack[0].Operand().GetValue(counter);
+
+  const SyncStatementStats stats = sync_stats(session, "sync_step");
+
+  result = result && (counter == DUInt64(1000000123));
+  result = result && (stats.mContentions >= threadsCount);
+  result = result && (stats.mWaiting == 0) && ! stats.mHeld;
+  result = result && (stats.mMaxWaitTime > 0);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_wait_timeout(ISession& session)
+{
+  std::cout << "Giving up waiting for a synchronized statement ... ";
+
+  set_time_slice(session, 0);
+
+  bool result = (reset_counter(session) == 0);
+
+  const SyncStatementStats before = sync_stats(session, "sync_step");
+
+  SessionStack holderStack;
+  std::unique_ptr<IResumableCall> holder = hold_sync(session, holderStack, 100000);
+
+  set_wait_timeout(session, 20);
+
+  CallContext context = {&session, "sync_step", 1, 0, 1, false};
+  call_routine(&context);
+
+  result = result && context.mTimedOut;
+
+  const SyncStatementStats stats = sync_stats(session, "sync_step");
+  result = result && stats.mHeld && (stats.mWaiting == 0);
+  result = result && (stats.mTimeouts == before.mTimeouts + 1);
+  result = result && (stats.mWaitTime >= before.mWaitTime + 20);
+
+  //An abandoned call has to hand over the synchronized statement.
+  context.mTimedOut = false;
+
+  Thread waiter;
+  set_wait_timeout(session, 0);
+  waiter.Run(call_routine, &context);
+
+  while (sync_stats(session, "sync_step").mWaiting != 1)
+    wh_sleep(1);
+
+  holder.reset();
+  waiter.WaitToEnd();
+
+  result = result && ! context.mTimedOut;
+  result = result && ! sync_stats(session, "sync_step").mHeld;
+
+  try
+  {
+    SyncStatementStats unused;
+    session.ProcedureSyncStatementStats("sync_step", 1, unused);
+    result = false;
+  }
+  catch (InterException& e)
+  {
+    result = result && (e.Code() == InterException::INVALID_SYNC_REQ);
+  }
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& session = GetInstance(nullptr);
+
+    CompiledBufferUnit queuesUnit(queuesProgram,
+                                  sizeof queuesProgram,
+                                  my_postman,
+                                  queuesProgram);
+
+    session.LoadCompiledUnit(queuesUnit);
+
+    success = success && test_contention(session, 0);
+    success = success && test_contention(session, 1000);
+    success = success && test_fifo_handoff(session);
+    success = success && test_wait_timeout(session);
+
+    ReleaseInstance(session);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
@@ -0,0 +1,435 @@
+/*
+ * test_time_slices.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "utils/wthread.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t slicesProgram[] = ""
+    "VAR gCounter UINT64;\n"
+    "\n"
+    "PROCEDURE sum_loop(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  s = 0;\n"
+    "  FOR (i = 0; i < n; i += 1)\n"
+    "    s += i * 3;\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE fib(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n < 2)\n"
+    "    RETURN n;\n"
+    "  RETURN fib(n - 1) + fib(n - 2);\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE reset_counter() RETURN UINT64\n"
+    "DO\n"
+    "  gCounter = 0;\n"
+    "  RETURN gCounter;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE sync_add(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  VAR i UINT32;\n"
+    "  VAR s UINT64;\n"
+    "  SYNC\n"
+    "    s = gCounter;\n"
+    "    FOR (i = 0; i < n; i += 1)\n"
+    "      s += 1;\n"
+    "    gCounter = s;\n"
+    "  ENDSYNC\n"
+    "  RETURN s;\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+static void
+set_time_slice(ISession& session, const uint64_t instructions)
+{
+  uint64_t timeSlice = instructions;
+  session.NotifyEvent(ISession::PROCS_TIME_SLICE, &timeSlice);
+}
+
+
+template <typename DBS_T> static bool
+check_result(SessionStack& stack, const DBS_T& expected)
+{
+  if (stack.Size() != 1)
+    return false;
+
+  DBS_T result;
+  stack[0].Operand().GetValue(result);
+  stack.Pop(1);
+
+  return result == expected;
+}
+
+
+//Resume the call until it ends and count how many times it was suspended.
+static uint_t
+run_to_end(IResumableCall& call)
+{
+  uint_t suspends = 0;
+
+  while ( ! call.Resume())
+  {
+    if (call.SuspendReason() == IResumableCall::NOT_SUSPENDED)
+      return 0;
+
+    ++suspends;
+  }
+
+  return suspends;
+}
+
+
+static bool
+test_sliced_loop(ISession& session)
+{
+  std::cout << "Running a loop in time slices ... ";
+
+  const uint32_t n = 100000;
+  uint64_t expected = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    expected += i * 3;
+
+  SessionStack stack;
+  stack.Push(DUInt32(n));
+
+  set_time_slice(session, 1000);
+  std::unique_ptr<IResumableCall> call = session.StartProcedure("sum_loop", stack);
+
+  bool result = ! call->Resume();
+  result = result && (call->SuspendReason() == IResumableCall::TIME_SLICE_ENDED);
+  result = result && (run_to_end( *call) > 100);
+  result = result && call->Resume();
+  result = result && check_result(stack, DUInt64(expected));
+
+  //Without time slicing the procedure has to end on its first run.
+  set_time_slice(session, 0);
+  stack.Push(DUInt32(n));
+  call = session.StartProcedure("sum_loop", stack);
+
+  result = result && call->Resume();
+  result = result && check_result(stack, DUInt64(expected));
+
+  //The procedures requested the usual way end before returning.
+  set_time_slice(session, 1000);
+  stack.Push(DUInt32(n));
+  session.ExecuteProcedure("sum_loop", stack);
+
+  result = result && check_result(stack, DUInt64(expected));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_sliced_calls(ISession& session)
+{
+  std::cout << "Running recursive calls in time slices ... ";
+
+  SessionStack stack;
+  stack.Push(DUInt32(20));
+
+  set_time_slice(session, 500);
+  std::unique_ptr<IResumableCall> call = session.StartProcedure("fib", stack);
+
+  bool result = (run_to_end( *call) > 10);
+  result = result && check_result(stack, DUInt64(6765));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_round_robin(ISession& session)
+{
+  std::cout << "Sharing a thread between two calls ... ";
+
+  SessionStack stack1, stack2;
+
+  stack1.Push(DUInt32(40000));
+  stack2.Push(DUInt32(20000));
+
+  set_time_slice(session, 2000);
+  std::unique_ptr<IResumableCall> call1 = session.StartProcedure("sum_loop", stack1);
+  std::unique_ptr<IResumableCall> call2 = session.StartProcedure("sum_loop", stack2);
+
+  uint_t slices1 = 0, slices2 = 0;
+  bool ended1 = false, ended2 = false;
+
+  while ( ! (ended1 && ended2))
+  {
+    if ( ! ended1)
+      ended1 = call1->Resume(), ++slices1;
+
+    if ( ! ended2)
+      ended2 = call2->Resume(), ++slices2;
+  }
+
+  //The longer call needs about twice as many slices.
+  bool result = (slices2 > 10) && (slices1 > slices2 * 3 / 2) && (slices1 < slices2 * 5 / 2);
+
+  result = result && check_result(stack1, DUInt64(3ull * 40000 * 39999 / 2));
+  result = result && check_result(stack2, DUInt64(3ull * 20000 * 19999 / 2));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_sync_wait(ISession& session)
+{
+  std::cout << "Suspending the calls waiting for a synchronisation ... ";
+
+  SessionStack stack1, stack2, stack3;
+
+  set_time_slice(session, 1000);
+
+  session.ExecuteProcedure("reset_counter", stack1);
+
+  bool result = check_result(stack1, DUInt64(0));
+
+  stack1.Push(DUInt32(5000));
+  stack2.Push(DUInt32(5000));
+  std::unique_ptr<IResumableCall> call1 = session.StartProcedure("sync_add", stack1);
+  std::unique_ptr<IResumableCall> call2 = session.StartProcedure("sync_add", stack2);
+
+  //The first one gets suspended inside the synchronised statement.
+  result = result && ! call1->Resume();
+  result = result && (call1->SuspendReason() == IResumableCall::TIME_SLICE_ENDED);
+  result = result && ! call2->Resume();
+  result = result && (call2->SuspendReason() == IResumableCall::SYNC_WAIT);
+  result = result && ! call2->Resume();
+  result = result && (call2->SuspendReason() == IResumableCall::SYNC_WAIT);
+
+  //The suspended call waits in the statement's queue.
+  SyncStatementStats stats;
+  session.ProcedureSyncStatementStats("sync_add", 0, stats);
+  result = result && (stats.mWaiting == 1) && (stats.mContentions == 1);
+
+  run_to_end( *call1);
+  run_to_end( *call2);
+
+  result = result && check_result(stack1, DUInt64(5000));
+  result = result && check_result(stack2, DUInt64(10000));
+
+  //An abandoned call has to leave the synchronised statement.
+  stack1.Push(DUInt32(5000));
+  stack3.Push(DUInt32(5000));
+
+  call1 = session.StartProcedure("sync_add", stack1);
+  std::unique_ptr<IResumableCall> call3 = session.StartProcedure("sync_add", stack3);
+
+  result = result && ! call1->Resume();
+  result = result && ! call3->Resume();
+  result = result && (call3->SuspendReason() == IResumableCall::SYNC_WAIT);
+
+  call1.reset();
+
+  run_to_end( *call3);
+  result = result && check_result(stack3, DUInt64(15000));
+
+  //A suspended call gives up when it has waited too long.
+  uint64_t timeout = 20;
+  session.NotifyEvent(ISession::SYNC_WAIT_TMO, &timeout);
+
+  SessionStack stack4, stack5;
+  stack4.Push(DUInt32(5000));
+  stack5.Push(DUInt32(5000));
+
+  call1 = session.StartProcedure("sync_add", stack4);
+  call2 = session.StartProcedure("sync_add", stack5);
+
+  result = result && ! call1->Resume();
+  result = result && ! call2->Resume();
+
+  wh_sleep(timeout * 2);
+  try
+  {
+    call2->Resume();
+    result = false;
+  }
+  catch (InterException& e)
+  {
+    result = result && (e.Code() == InterException::SYNC_WAIT_TIMEOUT);
+  }
+
+  session.ProcedureSyncStatementStats("sync_add", 0, stats);
+  result = result && (stats.mWaiting == 0) && (stats.mTimeouts == 1);
+
+  run_to_end( *call1);
+  result = result && check_result(stack4, DUInt64(20000));
+
+  timeout = 0;
+  session.NotifyEvent(ISession::SYNC_WAIT_TMO, &timeout);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+struct ResumeContext
+{
+  IResumableCall* mCall;
+  bool            mEnded;
+};
+
+
+static void
+resume_routine(void* args)
+{
+  ResumeContext* const context = _RC(ResumeContext*, args);
+
+  context->mEnded = context->mCall->Resume();
+}
+
+
+static bool
+test_resume_threads(ISession& session)
+{
+  std::cout << "Resuming a call from different threads ... ";
+
+  SessionStack stack;
+  stack.Push(DUInt32(20));
+
+  set_time_slice(session, 500);
+  std::unique_ptr<IResumableCall> call = session.StartProcedure("fib", stack);
+
+  ResumeContext context = {call.get(), false};
+  uint_t resumes = 0;
+
+  while ( ! context.mEnded)
+  {
+    Thread worker;
+
+    worker.Run(resume_routine, &context);
+    worker.WaitToEnd();
+
+    ++resumes;
+  }
+
+  const bool result = (resumes > 10) && check_result(stack, DUInt64(6765));
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& session = GetInstance(nullptr);
+
+    CompiledBufferUnit slicesUnit(slicesProgram,
+                                  sizeof slicesProgram,
+                                  my_postman,
+                                  slicesProgram);
+
+    session.LoadCompiledUnit(slicesUnit);
+
+    success = success && test_sliced_loop(session);
+    success = success && test_sliced_calls(session);
+    success = success && test_round_robin(session);
+    success = success && test_sync_wait(session);
+    success = success && test_resume_threads(session);
+
+    ReleaseInstance(session);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
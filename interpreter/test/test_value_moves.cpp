@@ -0,0 +1,327 @@
+/*
+ * test_value_moves.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <iostream>
+
+#include "dbs/dbs_mgr.h"
+#include "interpreter.h"
+#include "custom/include/test/test_fmw.h"
+
+#include "interpreter/prima/pm_interpreter.h"
+#include "interpreter/prima/pm_processor.h"
+#include "interpreter/prima/pm_store.h"
+
+using namespace whais;
+using namespace prima;
+
+static const char admin[] = "administrator";
+
+const uint8_t movesProgram[] = ""
+    "PROCEDURE echo_text(t TEXT) RETURN TEXT\n"
+    "DO\n"
+    "  RETURN t;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE echo_array(a INT32 ARRAY) RETURN INT32 ARRAY\n"
+    "DO\n"
+    "  RETURN a;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE make_text() RETURN TEXT\n"
+    "DO\n"
+    "  VAR r TEXT;\n"
+    "  r = \"A returned \";\n"
+    "  r += \"text value.\";\n"
+    "  RETURN r;\n"
+    "ENDPROC\n"
+    "\n"
+    "PROCEDURE fib(n UINT32) RETURN UINT64\n"
+    "DO\n"
+    "  IF (n < 2)\n"
+    "    RETURN n;\n"
+    "  RETURN fib(n - 1) + fib(n - 2);\n"
+    "ENDPROC\n"
+    "\n";
+
+static const char *MSG_PREFIX[] = {
+                                      "", "error ", "warning ", "error "
+                                    };
+
+static uint_t
+get_line_from_buffer(const char * buffer, uint_t buff_pos)
+{
+  uint_t count = 0;
+  int result = 1;
+
+  if (buff_pos == WHC_IGNORE_BUFFER_POS)
+    return -1;
+
+  while (count < buff_pos)
+    {
+      if (buffer[count] == '\n')
+        ++result;
+      else if (buffer[count] == 0)
+        {
+          assert(0);
+        }
+      ++count;
+    }
+  return result;
+}
+
+void
+my_postman(WH_MESSENGER_CTXT data,
+            uint_t            buff_pos,
+            uint_t            msg_id,
+            uint_t            msgType,
+            const char*     pMsgFormat,
+            va_list           args)
+{
+  const char *buffer = (const char *) data;
+  int buff_line = get_line_from_buffer(buffer, buff_pos);
+
+  fprintf(stderr, MSG_PREFIX[msgType]);
+  fprintf(stderr, "%d : line %d: ", msg_id, buff_line);
+  vfprintf(stderr, pMsgFormat, args);
+  fprintf(stderr, "\n");
+};
+
+
+static uint64_t
+text_allocations()
+{
+  return SharedTextStore::Instance().AllocationsCount();
+}
+
+
+static uint64_t
+array_allocations()
+{
+  return SharedArrayStore::Instance().AllocationsCount();
+}
+
+
+static bool
+test_stack_growth()
+{
+  std::cout << "Growing a stack of text values ... ";
+
+  const uint_t valuesCount = 1000;
+  const DText value("A text value long enough to need its own storage.");
+
+  SessionStack stack;
+
+  const uint64_t allocations = text_allocations();
+  for (uint_t i = 0; i < valuesCount; ++i)
+    stack.Push(value);
+
+  //Growing the stack has to move its values, not to copy them.
+  bool result = (text_allocations() - allocations == valuesCount);
+  result = result && (stack.ReallocationsCount() > 0);
+  result = result && (stack.ReallocationsCount() < 16);
+
+  for (uint_t i = 0; (i < valuesCount) && result; ++i)
+  {
+    DText text;
+    stack[i].Operand().GetValue(text);
+
+    result = (text == value);
+  }
+  stack.Pop(valuesCount);
+
+  //Nothing has to move when there is room enough.
+  SessionStack reserved;
+  reserved.Reserve(valuesCount);
+
+  for (uint_t i = 0; i < valuesCount; ++i)
+    reserved.Push(value);
+
+  result = result && (reserved.ReallocationsCount() == 0);
+  result = result && (reserved.Capacity() >= valuesCount);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_text_returns(ISession& session)
+{
+  std::cout << "Returning text values ... ";
+
+  const uint_t callsCount = 1000;
+  const DText value("A text value long enough to need its own storage.");
+
+  SessionStack stack;
+  bool result = true;
+
+  uint64_t allocations = text_allocations();
+  for (uint_t i = 0; (i < callsCount) && result; ++i)
+  {
+    stack.Push(value);
+    session.ExecuteProcedure("echo_text", stack);
+
+    DText text;
+    stack[0].Operand().GetValue(text);
+    stack.Pop(1);
+
+    result = (stack.Size() == 0) && (text == value);
+  }
+
+  //Only the arguments pushed here need new storage, the returned values are moved.
+  const uint64_t echoAllocations = text_allocations() - allocations;
+  result = result && (echoAllocations == callsCount);
+
+  allocations = text_allocations();
+  for (uint_t i = 0; (i < callsCount) && result; ++i)
+  {
+    session.ExecuteProcedure("make_text", stack);
+
+    DText text;
+    stack[0].Operand().GetValue(text);
+    stack.Pop(1);
+
+    result = (stack.Size() == 0) && (text == DText("A returned text value."));
+  }
+
+  //The local's default value and the constants, but nothing for the returned local.
+  const uint64_t makeAllocations = text_allocations() - allocations;
+  result = result && (makeAllocations == 3 * callsCount);
+
+  std::cout << echoAllocations / callsCount << " and "
+            << makeAllocations / callsCount << " allocations per call ";
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_array_returns(ISession& session)
+{
+  std::cout << "Returning array values ... ";
+
+  const uint_t callsCount = 1000;
+
+  DArray value;
+  for (int32_t i = 0; i < 100; ++i)
+    value.Add(DInt32(i));
+
+  SessionStack stack;
+  bool result = true;
+
+  const uint64_t allocations = array_allocations();
+  for (uint_t i = 0; (i < callsCount) && result; ++i)
+  {
+    stack.Push(value);
+    session.ExecuteProcedure("echo_array", stack);
+
+    DArray array;
+    stack[0].Operand().GetValue(array);
+    stack.Pop(1);
+
+    result = (stack.Size() == 0) && (array.Count() == value.Count());
+    for (uint64_t e = 0; (e < array.Count()) && result; ++e)
+    {
+      DInt32 v1, v2;
+      array.Get(e, v1);
+      value.Get(e, v2);
+
+      result = (v1 == v2);
+    }
+  }
+
+  const uint64_t echoAllocations = array_allocations() - allocations;
+  result = result && (echoAllocations == callsCount);
+
+  std::cout << echoAllocations / callsCount << " allocations per call ";
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+static bool
+test_recursive_calls(ISession& session)
+{
+  std::cout << "Checking the stack growth of recursive calls ... ";
+
+  SessionStack stack;
+  stack.Push(DUInt32(20));
+
+  session.ExecuteProcedure("fib", stack);
+
+  DUInt64 value;
+  stack[0].Operand().GetValue(value);
+  stack.Pop(1);
+
+  bool result = (value == DUInt64(6765));
+  result = result && (stack.ReallocationsCount() < 8);
+
+  //The second time the stack has already room for the call.
+  const uint_t reallocations = stack.ReallocationsCount();
+
+  stack.Push(DUInt32(20));
+  session.ExecuteProcedure("fib", stack);
+  stack.Pop(1);
+
+  result = result && (stack.ReallocationsCount() == reallocations);
+
+  std::cout << (result ? "OK" : "FAIL") << std::endl;
+  return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+  bool success = true;
+
+  {
+    DBSInit(DBSSettings());
+  }
+
+  DBSCreateDatabase(admin);
+  InitInterpreter();
+
+  {
+    ISession& session = GetInstance(nullptr);
+
+    CompiledBufferUnit movesUnit(movesProgram,
+                                 sizeof movesProgram,
+                                 my_postman,
+                                 movesProgram);
+
+    session.LoadCompiledUnit(movesUnit);
+
+    success = success && test_stack_growth();
+    success = success && test_text_returns(session);
+    success = success && test_array_returns(session);
+    success = success && test_recursive_calls(session);
+
+    ReleaseInstance(session);
+  }
+
+  CleanInterpreter();
+  DBSRemoveDatabase(admin);
+  DBSShoutdown();
+
+  if (!success)
+    {
+      std::cout << "TEST RESULT: FAIL" << std::endl;
+      return 1;
+    }
+
+  std::cout << "TEST RESULT: PASS" << std::endl;
+
+  return 0;
+}
+
+#ifdef ENABLE_MEMORY_TRACE
+uint32_t WMemoryTracker::smInitCount = 0;
+const char* WMemoryTracker::smModule = "T";
+#endif
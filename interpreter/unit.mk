@@ -13,7 +13,8 @@ wprima_SRC:=prima/pm_globals.cpp prima/pm_operand.cpp prima/pm_interpreter.cpp\
            prima/pm_processor.cpp prima/pm_operand_arrayfields.cpp\
            prima/pm_operand_fields.cpp prima/pm_operand_array.cpp\
            prima/pm_generic_table.cpp prima/pm_operand_undefined.cpp\
-           prima/pm_exception.cpp
+           prima/pm_exception.cpp prima/pm_opprofile.cpp\
+           prima/pm_procprofile.cpp
 
 wprima_cmn_DEF=WVER_MAJ=1 WVER_MIN=0
 wprima_DEF:=USE_CUSTOM_SHL USE_DBS_SHL USE_INTERP_SHL INTERP_EXPORTING $(wprima_cmn_DEF)
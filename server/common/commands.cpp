@@ -810,12 +810,231 @@ cmd_procedure_param_desc_err:
 }
 
 
+static void
+cmd_procedure_sync_stats(ClientConnection& conn)
+{
+  static const uint_t RSP_SIZE = 2 * sizeof(uint32_t) + 2 * sizeof(uint16_t) +
+                                 5 * sizeof(uint64_t);
+
+  uint32_t result = WCS_OK;
+
+  if ((conn.DataSize() < 2 * sizeof(uint16_t) + 2 * sizeof(uint8_t))
+      || (conn.Data()[conn.DataSize() - 1] != 0))
+  {
+    throw ConnectionException(_EXTRA(0),
+                              "Command used to retrieve the statistics of a procedure's"
+                              " synchronized statement has invalid format.");
+  }
+
+  ISession& session = *conn.Dbs().mSession;
+  uint8_t* data_ = conn.Data();
+  const uint16_t sync = load_le_int16(data_);
+  const std::string procName = _RC(const char*, data_ + 2 * sizeof(uint16_t));
+  uint_t syncsCount = 0;
+  uint16_t offset = 0;
+
+  SyncStatementStats stats;
+  memset(&stats, 0, sizeof stats);
+
+  try
+  {
+    syncsCount = session.ProcedureSyncStatementsCount(procName.c_str());
+    if (sync < syncsCount)
+      session.ProcedureSyncStatementStats(procName.c_str(), sync, stats);
+
+    else if (syncsCount > 0)
+      result = WCS_INVALID_ARGS;
+  }
+  catch (InterException&)
+  {
+    result = WCS_INVALID_ARGS;
+  }
+
+  if (result != WCS_OK)
+  {
+    conn.DataSize(sizeof(result));
+    store_le_int32(result, conn.Data());
+    conn.SendCmdResponse(CMD_PROC_SYNC_STATS_RSP);
+
+    return;
+  }
+
+  conn.DataSize(RSP_SIZE);
+  data_ = conn.Data();
+
+  store_le_int32(WCS_OK, data_ + offset);
+  offset += sizeof(uint32_t);
+
+  store_le_int16(syncsCount, data_ + offset);
+  offset += sizeof(uint16_t);
+
+  data_[offset++] = stats.mHeld ? 1 : 0;
+  data_[offset++] = 0; //reserved
+
+  store_le_int32(stats.mWaiting, data_ + offset);
+  offset += sizeof(uint32_t);
+
+  store_le_int64(stats.mAquires, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mContentions, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mTimeouts, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mWaitTime, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mMaxWaitTime, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  assert(offset == RSP_SIZE);
+
+  conn.SendCmdResponse(CMD_PROC_SYNC_STATS_RSP);
+}
+
+
+static void
+cmd_procedure_profile(ClientConnection& conn)
+{
+  static const uint_t RSP_FIXED_SIZE = 3 * sizeof(uint32_t) + 4 * sizeof(uint64_t);
+  static const uint_t RSP_COUNT_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+
+  uint32_t result = WCS_OK;
+
+  if ((conn.DataSize() < 2 * sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint8_t))
+      || (conn.Data()[conn.DataSize() - 1] != 0))
+  {
+    throw ConnectionException(_EXTRA(0),
+                              "Command used to retrieve the profile of a procedure"
+                              " has invalid format.");
+  }
+
+  ISession& session = *conn.Dbs().mSession;
+  uint8_t* data_ = conn.Data();
+  const uint16_t action = load_le_int16(data_);
+  uint32_t fromPos = load_le_int32(data_ + 2 * sizeof(uint16_t));
+  const std::string procName = _RC(const char*,
+                                   data_ + 2 * sizeof(uint16_t) + sizeof(uint32_t));
+
+  if ((action != CMD_PROC_PROFILE_QUERY) && ! conn.IsAdmin())
+  {
+    throw ConnectionException(_EXTRA(0),
+                              "Only an admin may change how the procedures are profiled.");
+  }
+
+  switch (action)
+  {
+  case CMD_PROC_PROFILE_QUERY:
+    break;
+
+  case CMD_PROC_PROFILE_ENABLE:
+    EnableProcedureProfile(true);
+    break;
+
+  case CMD_PROC_PROFILE_DISABLE:
+    EnableProcedureProfile(false);
+    break;
+
+  case CMD_PROC_PROFILE_RESET:
+    ResetProcedureProfile();
+    break;
+
+  default:
+    result = WCS_INVALID_ARGS;
+  }
+
+  ProcedureProfileStats stats;
+  memset(&stats, 0, sizeof stats);
+
+  std::vector<uint64_t> counts;
+
+  try
+  {
+    if ((result == WCS_OK) && ! procName.empty())
+      session.ProcedureProfile(procName.c_str(), stats, &counts);
+  }
+  catch (InterException&)
+  {
+    result = WCS_INVALID_ARGS;
+  }
+
+  if (result != WCS_OK)
+  {
+    conn.DataSize(sizeof(result));
+    store_le_int32(result, conn.Data());
+    conn.SendCmdResponse(CMD_PROC_PROFILE_RSP);
+
+    return;
+  }
+
+  conn.DataSize(conn.MaxSize());
+  data_ = conn.Data();
+
+  uint16_t countsCount = 0;
+  uint_t offset = RSP_FIXED_SIZE;
+
+  while ((fromPos < counts.size()) && (offset + RSP_COUNT_SIZE <= conn.DataSize()))
+  {
+    if (counts[fromPos] > 0)
+    {
+      store_le_int32(fromPos, data_ + offset);
+      offset += sizeof(uint32_t);
+
+      store_le_int64(counts[fromPos], data_ + offset);
+      offset += sizeof(uint64_t);
+
+      ++countsCount;
+    }
+
+    ++fromPos;
+  }
+
+  const uint_t dataSize = offset;
+
+  offset = 0;
+
+  store_le_int32(WCS_OK, data_ + offset);
+  offset += sizeof(uint32_t);
+
+  data_[offset++] = IsProcedureProfileEnabled() ? 1 : 0;
+  data_[offset++] = 0; //reserved
+
+  store_le_int16(countsCount, data_ + offset);
+  offset += sizeof(uint16_t);
+
+  //Let the client know where to continue from, if there are counts left.
+  store_le_int32((fromPos < counts.size()) ? fromPos : 0, data_ + offset);
+  offset += sizeof(uint32_t);
+
+  store_le_int64(stats.mCalls, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mInstructions, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mInclusiveTime, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  store_le_int64(stats.mExclusiveTime, data_ + offset);
+  offset += sizeof(uint64_t);
+
+  assert(offset == RSP_FIXED_SIZE);
+
+  conn.DataSize(dataSize);
+  conn.SendCmdResponse(CMD_PROC_PROFILE_RSP);
+}
+
+
 static COMMAND_HANDLER saAdminCmds[] =
     {
         cmd_invalid,                     // CMD_INVALID
         cmd_list_globals,                // CMD_LIST_GLOBALS
         cmd_list_procedures,             // CMD_LIST_PROC
-        cmd_procedure_param_desc         // CMD_DESC_PROC_PARAM
+        cmd_procedure_param_desc,        // CMD_DESC_PROC_PARAM
+        cmd_procedure_sync_stats,        // CMD_PROC_SYNC_STATS
+        cmd_procedure_profile            // CMD_PROC_PROFILE
     };
 
 static COMMAND_HANDLER saUserCmds[] =
@@ -86,6 +86,8 @@ static const string gEntNativeLib("load_native");
 static const string gEntRootPasswrd("admin_password");
 static const string gEntUserPasswrd("user_password");
 static const string gEntStackCount("max_stack_count");
+static const string gEntTimeSlice("procs_time_slice");
+static const string gEntSyncWaitTmo("sync_wait_timeout");
 
 static ServerSettings gMainSettings;
 
@@ -840,6 +842,47 @@ bool ParseContextSection(Logger& log,
         return false;
       }
     }
+    else if (token == gEntTimeSlice)
+    {
+      token = NextToken(line, pos, delimiters);
+      if ((token.length() == 0) || (token.at(0) == COMMENT_CHAR))
+      {
+        cerr << "Configuration error at line " << inoutConfigLine << ".\n";
+
+        return false;
+      }
+
+      //A value of 0 lets the procedures run without being interrupted.
+      const int timeSlice = atoi(token.c_str());
+      if (timeSlice < 0)
+      {
+        cerr << "At line " << inoutConfigLine << " the procedures' time slice parameter should"
+            " be a positive integer value(currently set to " << timeSlice << " ).\n";
+        return false;
+      }
+      output.mTimeSlice = timeSlice;
+    }
+    else if (token == gEntSyncWaitTmo)
+    {
+      token = NextToken(line, pos, delimiters);
+      if ((token.length() == 0) || (token.at(0) == COMMENT_CHAR))
+      {
+        cerr << "Configuration error at line " << inoutConfigLine << ".\n";
+
+        return false;
+      }
+
+      //A value of 0 lets the procedures wait as long as it takes.
+      const int syncWaitTmo = atoi(token.c_str());
+      if (syncWaitTmo < 0)
+      {
+        cerr << "At line " << inoutConfigLine << " the synchronized statements' wait timeout"
+            " parameter should be a positive integer value(currently set to " << syncWaitTmo
+            << " ).\n";
+        return false;
+      }
+      output.mSyncWaitTmo = syncWaitTmo;
+    }
     else
     {
       logEntry << "At line " << inoutConfigLine << ": Don't know what to do " << "with '" << token
@@ -37,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define UNSET_VALUE             0
 #define DEFAULT_MAX_STACK_CNT   4096
+#define DEFAULT_TIME_SLICE      0     //Off, nothing requeues the suspended calls.
 
 
 struct ListenEntry
@@ -93,6 +94,8 @@ struct DBSDescriptors
       mSyncInterval(UNSET_VALUE),
       mWaitReqTmo(UNSET_VALUE),
       mStackCount(DEFAULT_MAX_STACK_CNT),
+      mTimeSlice(DEFAULT_TIME_SLICE),
+      mSyncWaitTmo(UNSET_VALUE),
       mDbs(nullptr),
       mSession(nullptr),
       mLogger(nullptr),
@@ -103,6 +106,8 @@ struct DBSDescriptors
   int                              mSyncInterval;
   int                              mWaitReqTmo;
   uint_t                           mStackCount;
+  uint_t                           mTimeSlice;
+  uint_t                           mSyncWaitTmo;
   std::string                      mDbsName;
   std::string                      mDbsDirectory;
   std::string                      mDbsLogFile;
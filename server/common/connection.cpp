@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <assert.h>
 #include <memory.h>
+#include <algorithm>
 
 #include "whais.h"
 #include "utils/endianness.h"
@@ -37,6 +38,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 using namespace std;
 
 
+//How many stack values the connections make room for, from the start.
+static const size_t CONNECTION_STACK_RESERVE = 256;
+
+
 ConnectionException::ConnectionException(const uint32_t  code,
                                          const char*     file,
                                          uint32_t        line,
@@ -164,6 +169,9 @@ ClientConnection::ClientConnection(UserHandler& client, vector<DBSDescriptors>&
 
   mUserHandler.mRoot = (mData[FRAME_HDR_SIZE + FRAME_AUTH_RSP_USR_OFF] == 0);
 
+  //Don't let the first procedure calls grow the connection's stack step by step.
+  mStack.Reserve(min<size_t>(mUserHandler.mDesc->mStackCount, CONNECTION_STACK_RESERVE));
+
 
   const string& password = mUserHandler.mRoot
                            ? mUserHandler.mDesc->mRootPass
@@ -22,6 +22,8 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <map>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -30,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "interpreter/interpreter.h"
 #include "compiler//compiledunit.h"
 #include "utils/logger.h"
+#include "utils/whash.h"
 #include "loader.h"
 
 
@@ -39,11 +42,103 @@ using namespace whais;
 
 static const char CLEAR_LOG_STREAM[] = "";
 
+//The object units are linked once and shared by all the databases using
+//them, as the sessions keep their own copies of what they need from a unit.
+//They are dropped once all the databases are loaded. The linked images are
+//saved in the temporary directory, so the next runs map them instead of
+//linking the objects again, for as long as the objects stay the same.
+static map<string, shared_ptr<CompiledImageUnit>> sObjectUnits;
+static WTICKS   sLoadTicks;
+static uint_t   sUnitsLinked;
+static uint_t   sUnitsMapped;
+static uint_t   sUnitsShared;
+static uint64_t sUnitsBytes;
+
+
+//The image of an object unit is named after the object's file name and the
+//hash of its path, as objects with the same name may be found elsewhere.
+static string
+object_image_file(const string& obj)
+{
+  const size_t delim = obj.find_last_of(whf_dir_delim());
+  const string name = (delim == string::npos) ? obj : obj.substr(delim + 1);
+
+  ostringstream file;
+  file << GetAdminSettings().mTempDirectory << name << '_' << hex
+       << wh_hash(_RC(const uint8_t*, obj.c_str()), obj.length()) << ".wli";
+
+  return file.str();
+}
+
+
+static CompiledImageUnit&
+load_object_unit(const string& obj, ostringstream& logEntry, bool& outLinked)
+{
+  outLinked = false;
+
+  auto& unit = sObjectUnits[obj];
+  if (unit)
+  {
+    logEntry << "shared unit (hash " << hex << unit->ObjectHash() << dec << ')';
+    ++sUnitsShared;
+
+    return *unit;
+  }
+
+  const WTICKS start = wh_msec_ticks();
+  try
+  {
+    unit = make_shared<CompiledImageUnit>(obj.c_str(), object_image_file(obj).c_str());
+  }
+  catch (...)
+  {
+    sObjectUnits.erase(obj);
+    throw;
+  }
+
+  logEntry << (unit->IsMapped() ? "mapped the linked image of " : "linked ")
+           << unit->ObjectSize() << " bytes in " << wh_msec_ticks() - start
+           << " ms (hash " << hex << unit->ObjectHash() << dec << ')';
+
+  if (unit->IsMapped())
+    ++sUnitsMapped;
+
+  else
+  {
+    ++sUnitsLinked;
+    outLinked = true;
+  }
+  sUnitsBytes += unit->ObjectSize();
+
+  return *unit;
+}
+
+
+//Keep the image of a unit the interpreter has just verified and loaded.
+static void
+save_object_image(const string& obj, CompiledImageUnit& unit, ostringstream& logEntry)
+{
+  const string imageFile = object_image_file(obj);
+
+  try
+  {
+    unit.SaveImage(imageFile.c_str());
+    logEntry << ", image saved as '" << imageFile << '\'';
+  }
+  catch (Exception& e)
+  {
+    logEntry << ", failed to save its image as '" << imageFile << "' (" << e.Message() << ')';
+  }
+}
+
+
 bool
 LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
 {
   uint64_t      temp;
 
+  const WTICKS start = wh_msec_ticks();
+
   ostringstream logEntry;
   logEntry << "Loading database: " << inoutDesc.mDbsName;
   log.Log(LT_INFO, logEntry.str());
@@ -80,6 +175,27 @@ LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
     logEntry.str(CLEAR_LOG_STREAM);
   }
 
+  temp = inoutDesc.mTimeSlice;
+  if ( ! inoutDesc.mSession->NotifyEvent(ISession::PROCS_TIME_SLICE, &temp))
+  {
+    logEntry << "Failed to set the procedures' time slice for session '"
+             << inoutDesc.mDbsName << "' at " << inoutDesc.mTimeSlice << " instructions.";
+
+    log.Log(LT_ERROR, logEntry.str());
+    logEntry.str(CLEAR_LOG_STREAM);
+  }
+
+  temp = inoutDesc.mSyncWaitTmo;
+  if ( ! inoutDesc.mSession->NotifyEvent(ISession::SYNC_WAIT_TMO, &temp))
+  {
+    logEntry << "Failed to set the synchronized statements' wait timeout for session '"
+             << inoutDesc.mDbsName << "' at " << inoutDesc.mSyncWaitTmo << " ms.";
+
+    log.Log(LT_ERROR, logEntry.str());
+    logEntry.str(CLEAR_LOG_STREAM);
+  }
+
+  const WTICKS libsStart = wh_msec_ticks();
   for (const auto& lib : inoutDesc.mNativeLibs)
   {
     logEntry << "... Loading dynamic native library '" << lib << "'.";
@@ -92,6 +208,7 @@ LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
       log.Log(LT_ERROR, "Failed to load the dynamic library.");
   }
 
+  const WTICKS objsStart = wh_msec_ticks();
   for (const auto& obj : inoutDesc.mObjectLibs)
   {
     logEntry << "... Loading compiled object unit '" << obj << "'.";
@@ -99,11 +216,52 @@ LoadDatabase(FileLogger& log, DBSDescriptors& inoutDesc)
     log.Log(LT_INFO, logEntry.str());
     logEntry.str(CLEAR_LOG_STREAM);
 
-    CompiledFileUnit unit(obj.c_str());
+    bool linked;
+
+    logEntry << "... Object unit '" << obj << "': ";
+    CompiledImageUnit& unit = load_object_unit(obj, logEntry, linked);
+
+    const WTICKS loadStart = wh_msec_ticks();
     inoutDesc.mSession->LoadCompiledUnit(unit);
+
+    logEntry << ", loaded in " << wh_msec_ticks() - loadStart << " ms";
+    if (linked)
+      save_object_image(obj, unit, logEntry);
+
+    logEntry << '.';
+    dbsLogger->Log(LT_INFO, logEntry.str());
+    log.Log(LT_INFO, logEntry.str());
+    logEntry.str(CLEAR_LOG_STREAM);
   }
 
+  const WTICKS end = wh_msec_ticks();
+  sLoadTicks += end - start;
+
+  logEntry << "Database '" << inoutDesc.mDbsName << "' loaded in " << end - start
+           << " ms (native libraries " << objsStart - libsStart
+           << " ms, object units " << end - objsStart << " ms).";
+  dbsLogger->Log(LT_INFO, logEntry.str());
+  log.Log(LT_INFO, logEntry.str());
+  logEntry.str(CLEAR_LOG_STREAM);
+
   inoutDesc.mLogger = dbsLogger.release();
 
   return true;
 }
+
+
+void
+DatabasesLoaded(FileLogger& log)
+{
+  ostringstream logEntry;
+
+  logEntry << "All databases loaded in " << sLoadTicks << " ms. Object units linked: "
+           << sUnitsLinked << ", mapped from their saved images: " << sUnitsMapped << " ("
+           << sUnitsBytes << " bytes), shared between databases: " << sUnitsShared << '.';
+  log.Log(LT_INFO, logEntry.str());
+
+  sObjectUnits.clear();
+  sLoadTicks = 0;
+  sUnitsLinked = sUnitsMapped = sUnitsShared = 0;
+  sUnitsBytes = 0;
+}
@@ -33,5 +33,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 bool
 LoadDatabase(whais::FileLogger& log, DBSDescriptors& inoutDesc);
 
+//Log the startup's totals and release the object units kept for the
+//databases loaded so far.
+void
+DatabasesLoaded(whais::FileLogger& log);
+
 #endif /* LOADER_H_ */
 
@@ -291,6 +291,8 @@ main(int argc, char** argv)
     for (auto& d : databases)
       LoadDatabase( *glbLog, d);
 
+    DatabasesLoaded( *glbLog);
+
     cout << "All configured databases have been loaded!\n";
     StartServer(*glbLog, databases);
   }
@@ -130,6 +130,66 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define CMD_DESC_PROC_PARAM            (CMD_LIST_PROCEDURE_RSP + 1)
 #define CMD_DESC_PROC_PARAM_RSP        (CMD_DESC_PROC_PARAM + 1)
 
+#define CMD_PROC_SYNC_STATS            (CMD_DESC_PROC_PARAM_RSP + 1)
+#define CMD_PROC_SYNC_STATS_RSP        (CMD_PROC_SYNC_STATS + 1)
+/*
+ * CmdProcSyncStats
+ * {
+ *      sync         : uint16
+ *      reserved     : uint16
+ *      name         : char[]
+ * }
+ *
+ * CmdProcSyncStatsRsp
+ * {
+ *      status       : uint32
+ *      syncsCount   : uint16
+ *      held         : uint8
+ *      reserved     : uint8
+ *      waiting      : uint32
+ *      aquires      : uint64
+ *      contentions  : uint64
+ *      timeouts     : uint64
+ *      waitTime     : uint64
+ *      maxWaitTime  : uint64
+ * }
+ */
+
+#define CMD_PROC_PROFILE               (CMD_PROC_SYNC_STATS_RSP + 1)
+#define CMD_PROC_PROFILE_RSP           (CMD_PROC_PROFILE + 1)
+/*
+ * CmdProcProfile
+ * {
+ *      action       : uint16
+ *      reserved     : uint16
+ *      fromPos      : uint32
+ *      name         : char[]
+ * }
+ *
+ * CmdProcProfileRsp
+ * {
+ *      status       : uint32
+ *      enabled      : uint8
+ *      reserved     : uint8
+ *      countsCount  : uint16
+ *      nextPos      : uint32
+ *      calls        : uint64
+ *      instructions : uint64
+ *      inclTime     : uint64
+ *      exclTime     : uint64
+ *      counts       : { pos : uint32, count : uint64 }[countsCount]
+ * }
+ *
+ * The counts are sent only for the instructions executed at least once,
+ * starting with the one from 'fromPos'. The ones left, if any, are to be
+ * requested from 'nextPos', which is 0 when all of them were sent.
+ * With an empty name only the action is applied.
+ */
+#define CMD_PROC_PROFILE_QUERY         0
+#define CMD_PROC_PROFILE_ENABLE        1
+#define CMD_PROC_PROFILE_DISABLE       2
+#define CMD_PROC_PROFILE_RESET         3
+
 
 /* Connection close command */
 #define CMD_CLOSE_CONN                 USER_CMD_BASE
@@ -283,7 +343,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define CMD_HELLO_SERVER         (CMD_PING_SERVER_RSP + 1)
 #define CMD_HELLO_SERVER_RSP     (CMD_HELLO_SERVER + 1)
 
-#define ADMIN_CMDS_COUNT        ((CMD_DESC_PROC_PARAM / 2) + 1)
+#define ADMIN_CMDS_COUNT        ((CMD_PROC_PROFILE / 2) + 1)
 #define USER_CMDS_COUNT         ((CMD_HELLO_SERVER - USER_CMD_BASE) / 2 + 1)
 
 #endif /* SERVER_PROTOCOL_H_ */
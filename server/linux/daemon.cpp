@@ -284,6 +284,8 @@ boot_server()
       LoadDatabase( *glbLog, d);
     }
 
+    DatabasesLoaded( *glbLog);
+
     syslog(LOG_INFO, "All databases loaded!");
     if (sPidFile != nullptr)
     {
@@ -362,6 +362,8 @@ boot_server(const char* configFile, ostream& errOut)
         LoadDatabase(*glbLog, *dbsIterator);
       }
 
+    DatabasesLoaded(*glbLog);
+
     svc_report_status(SERVICE_RUNNING, NO_ERROR, 0);
     StartServer(*glbLog, databases);
     svc_report_status(SERVICE_STOP_PENDING, NO_ERROR, 60000);
@@ -200,6 +200,37 @@ static const WLIB_PROC_DESCRIPTION* sgRegisteredProcs[] = {
                                                     &gProcArrayMax,
                                                     &gProcArrayTruncate,
                                                     &gProcArrayHash,
+                          /* Array procedures for known element types */
+                                                    &gProcArrayTypedMin[0],
+                                                    &gProcArrayTypedMin[1],
+                                                    &gProcArrayTypedMin[2],
+                                                    &gProcArrayTypedMin[3],
+                                                    &gProcArrayTypedMin[4],
+                                                    &gProcArrayTypedMin[5],
+                                                    &gProcArrayTypedMin[6],
+                                                    &gProcArrayTypedMin[7],
+                                                    &gProcArrayTypedMin[8],
+                                                    &gProcArrayTypedMin[9],
+                                                    &gProcArrayTypedMin[10],
+                                                    &gProcArrayTypedMin[11],
+                                                    &gProcArrayTypedMin[12],
+                                                    &gProcArrayTypedMin[13],
+                                                    &gProcArrayTypedMin[14],
+                                                    &gProcArrayTypedMax[0],
+                                                    &gProcArrayTypedMax[1],
+                                                    &gProcArrayTypedMax[2],
+                                                    &gProcArrayTypedMax[3],
+                                                    &gProcArrayTypedMax[4],
+                                                    &gProcArrayTypedMax[5],
+                                                    &gProcArrayTypedMax[6],
+                                                    &gProcArrayTypedMax[7],
+                                                    &gProcArrayTypedMax[8],
+                                                    &gProcArrayTypedMax[9],
+                                                    &gProcArrayTypedMax[10],
+                                                    &gProcArrayTypedMax[11],
+                                                    &gProcArrayTypedMax[12],
+                                                    &gProcArrayTypedMax[13],
+                                                    &gProcArrayTypedMax[14],
                           /* Field procedures */
                                                     &gProcFieldTable,
                                                     &gProcIsFielsIndexed,
@@ -217,8 +248,16 @@ static const WLIB_PROC_DESCRIPTION* sgRegisteredProcs[] = {
                                                     &gProcTableAddRow,
                                                     &gProcTableFindRemovedRow,
                                                     &gProcTableRemoveRow,
+                                                    &gProcTableRemoveRows,
+                                                    &gProcTableRemoveRowsRange,
                                                     &gProcTableExchangeRows,
-                                                    &gProcTableSort
+                                                    &gProcTableSort,
+                                                    &gProcTableMatchComposite,
+                                                    &gProcRowsAnd,
+                                                    &gProcRowsOr,
+                                                    &gProcRowsNot,
+                                                    &gProcTableMatchAll,
+                                                    &gProcTableMatchAny
                                                           };
 
 static const WLIB_DESCRIPTION sgLibraryDescription =
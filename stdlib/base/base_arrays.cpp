@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils/whash.h"
 
 #include "base_types.h"
+#include "base_arrays.h"
 
 
 using namespace whais;
@@ -45,6 +46,9 @@ WLIB_PROC_DESCRIPTION         gProcArrayMax;
 WLIB_PROC_DESCRIPTION         gProcArrayTruncate;
 WLIB_PROC_DESCRIPTION         gProcArrayHash;
 
+WLIB_PROC_DESCRIPTION         gProcArrayTypedMin[TYPED_MINMAX_COUNT];
+WLIB_PROC_DESCRIPTION         gProcArrayTypedMax[TYPED_MINMAX_COUNT];
+
 
 
 static WLIB_STATUS
@@ -446,6 +450,42 @@ search_minmax( SessionStack& stack, ISession&)
 }
 
 
+//The variant of the above for a known type of the array's elements.
+template<bool minSearch, typename T> WLIB_STATUS
+search_typed_minmax( SessionStack& stack, ISession&)
+{
+  DUInt64 result, from;
+  DArray array;
+  T margin;
+
+  const auto paramsCount = 3;
+  const auto firstParam = stack.Size() - paramsCount;
+
+  if (stack[firstParam].Operand().IsNull())
+  {
+    stack.Pop(paramsCount - 1);
+    stack[firstParam] = StackValue();
+    return WOP_OK;
+  }
+
+  stack[firstParam].Operand().GetValue(array);
+  stack[firstParam + 1].Operand().GetValue(margin);
+  stack[firstParam + 2].Operand().GetValue(from);
+
+  if (from.IsNull())
+    from = DUInt64(0);
+
+  result = minSearch
+             ? retrieve_minim_value(array, margin, from.mValue)
+             : retrieve_maxim_value(array, margin, from.mValue);
+
+  stack.Pop(paramsCount - 1);
+  stack[firstParam] = StackValue::Create(result);
+
+  return WOP_OK;
+}
+
+
 static WLIB_STATUS
 proc_array_truncate( SessionStack& stack, ISession&)
 {
@@ -639,6 +679,68 @@ base_arrays_init()
   gProcArrayMax.code         = search_minmax<false>;
 
 
+  //The compiler binds the calls to 'get_min@INT32_ARRAY' (and so on) when it
+  //knows the type of the array, skipping the switch on it.
+  static const struct {
+    const char*     minName;
+    const char*     maxName;
+    uint8_t*        arrayType;
+    WLIB_PROCEDURE  minCode;
+    WLIB_PROCEDURE  maxCode;
+  } typedMinMax[TYPED_MINMAX_COUNT] = {
+    {"get_min@BOOL_ARRAY", "get_max@BOOL_ARRAY", gABoolType,
+      search_typed_minmax<true, DBool>, search_typed_minmax<false, DBool>},
+    {"get_min@CHAR_ARRAY", "get_max@CHAR_ARRAY", gACharType,
+      search_typed_minmax<true, DChar>, search_typed_minmax<false, DChar>},
+    {"get_min@DATE_ARRAY", "get_max@DATE_ARRAY", gADateType,
+      search_typed_minmax<true, DDate>, search_typed_minmax<false, DDate>},
+    {"get_min@DATETIME_ARRAY", "get_max@DATETIME_ARRAY", gADateTimeType,
+      search_typed_minmax<true, DDateTime>, search_typed_minmax<false, DDateTime>},
+    {"get_min@HIRESTIME_ARRAY", "get_max@HIRESTIME_ARRAY", gAHiresTimeType,
+      search_typed_minmax<true, DHiresTime>, search_typed_minmax<false, DHiresTime>},
+    {"get_min@INT8_ARRAY", "get_max@INT8_ARRAY", gAInt8Type,
+      search_typed_minmax<true, DInt8>, search_typed_minmax<false, DInt8>},
+    {"get_min@INT16_ARRAY", "get_max@INT16_ARRAY", gAInt16Type,
+      search_typed_minmax<true, DInt16>, search_typed_minmax<false, DInt16>},
+    {"get_min@INT32_ARRAY", "get_max@INT32_ARRAY", gAInt32Type,
+      search_typed_minmax<true, DInt32>, search_typed_minmax<false, DInt32>},
+    {"get_min@INT64_ARRAY", "get_max@INT64_ARRAY", gAInt64Type,
+      search_typed_minmax<true, DInt64>, search_typed_minmax<false, DInt64>},
+    {"get_min@UINT8_ARRAY", "get_max@UINT8_ARRAY", gAUInt8Type,
+      search_typed_minmax<true, DUInt8>, search_typed_minmax<false, DUInt8>},
+    {"get_min@UINT16_ARRAY", "get_max@UINT16_ARRAY", gAUInt16Type,
+      search_typed_minmax<true, DUInt16>, search_typed_minmax<false, DUInt16>},
+    {"get_min@UINT32_ARRAY", "get_max@UINT32_ARRAY", gAUInt32Type,
+      search_typed_minmax<true, DUInt32>, search_typed_minmax<false, DUInt32>},
+    {"get_min@UINT64_ARRAY", "get_max@UINT64_ARRAY", gAUInt64Type,
+      search_typed_minmax<true, DUInt64>, search_typed_minmax<false, DUInt64>},
+    {"get_min@REAL_ARRAY", "get_max@REAL_ARRAY", gARealType,
+      search_typed_minmax<true, DReal>, search_typed_minmax<false, DReal>},
+    {"get_min@RICHREAL_ARRAY", "get_max@RICHREAL_ARRAY", gARichRealType,
+      search_typed_minmax<true, DRichReal>, search_typed_minmax<false, DRichReal>}
+  };
+
+  static const uint8_t* typedMinMaxLocals[TYPED_MINMAX_COUNT][4];
+
+  for (uint_t i = 0; i < TYPED_MINMAX_COUNT; ++i)
+  {
+    typedMinMaxLocals[i][0] = gUInt64Type;
+    typedMinMaxLocals[i][1] = typedMinMax[i].arrayType;
+    typedMinMaxLocals[i][2] = gUndefinedType;
+    typedMinMaxLocals[i][3] = gUInt64Type;
+
+    gProcArrayTypedMin[i].name        = typedMinMax[i].minName;
+    gProcArrayTypedMin[i].localsCount = 4;
+    gProcArrayTypedMin[i].localsTypes = typedMinMaxLocals[i];
+    gProcArrayTypedMin[i].code        = typedMinMax[i].minCode;
+
+    gProcArrayTypedMax[i].name        = typedMinMax[i].maxName;
+    gProcArrayTypedMax[i].localsCount = 4;
+    gProcArrayTypedMax[i].localsTypes = typedMinMaxLocals[i];
+    gProcArrayTypedMax[i].code        = typedMinMax[i].maxCode;
+  }
+
+
   static const uint8_t* arrayTruncateLocals[] = {
                                                   gUInt64Type,
                                                   gGenericArrayType,
@@ -35,6 +35,12 @@ extern whais::WLIB_PROC_DESCRIPTION         gProcArrayMax;
 extern whais::WLIB_PROC_DESCRIPTION         gProcArrayTruncate;
 extern whais::WLIB_PROC_DESCRIPTION         gProcArrayHash;
 
+//The count of the types of the arrays get_min() and get_max() have variants for.
+#define TYPED_MINMAX_COUNT      15
+
+extern whais::WLIB_PROC_DESCRIPTION         gProcArrayTypedMin[TYPED_MINMAX_COUNT];
+extern whais::WLIB_PROC_DESCRIPTION         gProcArrayTypedMax[TYPED_MINMAX_COUNT];
+
 whais::WLIB_STATUS
 base_arrays_init();
 
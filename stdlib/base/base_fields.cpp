@@ -22,6 +22,7 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -344,6 +345,25 @@ is_in_set(const DArray& set, const T e, const bool addNull)
   return false;
 }
 
+template<typename T> bool
+is_in_range(const DArray& set, const T& min, const T& max)
+{
+  if (min.IsNull())
+    return false;
+
+  const uint_t to = set.Count();
+  for (uint_t from = 0; from < to; ++from)
+  {
+    T current;
+    set.Get(from, current);
+
+    if ( ! current.IsNull() && ! (current < min) && ! (max < current))
+      return true;
+  }
+
+  return false;
+}
+
 template<typename T> DArray
 test_rows (ITable& table,
            const FIELD_INDEX f,
@@ -356,6 +376,13 @@ test_rows (ITable& table,
 
   const ROW_INDEX rowsCount = table.AllocatedRows();
   const ROW_INDEX count = rows.Count();
+
+  //Summarising a zone reads all its rows, so the zones are worth to be
+  //consulted only when the rows to test are dense enough.
+  const bool useZones = (count > 0) && (count >= rowsCount / 4);
+
+  DBSZone zone = {1, 0, 0};
+  bool zoneMayMatch = true;
   for ( ROW_INDEX i = 0; i < count; ++i)
   {
     DROW_INDEX row;
@@ -364,10 +391,24 @@ test_rows (ITable& table,
     if (row.mValue >= rowsCount)
       continue ;
 
-    T current;
-    table.Get(row.mValue, f, current);
+    if (useZones && ((row.mValue < zone.mFirstRow) || (zone.mLastRow < row.mValue)))
+    {
+      T zoneMin, zoneMax;
+      zone = table.RetrieveZone(row.mValue, f, zoneMin, zoneMax);
+
+      zoneMayMatch = ((zone.mNullsCount > 0) && addNull)
+                     || is_in_range(set, zoneMin, zoneMax);
+    }
+
+    bool inSet = false;
+    if (zoneMayMatch)
+    {
+      T current;
+      table.Get(row.mValue, f, current);
+
+      inSet = is_in_set(set, current, addNull);
+    }
 
-    const bool inSet = is_in_set(set, current, addNull);
     if (inSet ^ fiterOut)
       result.Add(row);
   }
@@ -479,7 +520,7 @@ proc_field_filter_rows(SessionStack& stack, ISession&)
     break;
 
   case T_REAL:
-    result = test_rows<DUInt64>(table, f, rows, set, addNull.mValue, filterout.mValue);
+    result = test_rows<DReal>(table, f, rows, set, addNull.mValue, filterout.mValue);
     break;
 
   case T_RICHREAL:
@@ -506,21 +547,36 @@ retrieve_minim_value(ITable& table, const FIELD_INDEX field, T margin)
   if (margin.IsNull())
     margin = T::Min();
 
-  for (ROW_INDEX row = 0; row < rowsCount; ++row)
+  ROW_INDEX row = 0;
+  while (row < rowsCount)
   {
-    T value;
-    table.Get(row, field, value);
+    T zoneMin, zoneMax;
+    const DBSZone zone = table.RetrieveZone(row, field, zoneMin, zoneMax);
+    const ROW_INDEX lastRow = std::min<ROW_INDEX>(zone.mLastRow, rowsCount - 1);
 
-    if ( ! value.IsNull() && (value > margin))
+    //Skip the zones that cannot hold any of the searched values.
+    if (zoneMax.IsNull() || ! (margin < zoneMax) || (minim < zoneMin))
     {
-      if (value < minim)
+      row = lastRow + 1;
+      continue;
+    }
+
+    for (; row <= lastRow; ++row)
+    {
+      T value;
+      table.Get(row, field, value);
+
+      if ( ! value.IsNull() && (value > margin))
       {
-        minim = value;
-        result = DArray();
-        result.Add(DROW_INDEX(row));
+        if (value < minim)
+        {
+          minim = value;
+          result = DArray();
+          result.Add(DROW_INDEX(row));
+        }
+        else if (value == minim)
+          result.Add(DROW_INDEX(row));
       }
-      else if (value == minim)
-        result.Add(DROW_INDEX(row));
     }
   }
 
@@ -538,21 +594,36 @@ retrieve_maxim_value( ITable& table, const FIELD_INDEX field, T margin)
   if (margin.IsNull())
     margin = T::Max();
 
-  for (ROW_INDEX row = 0; row < rowsCount; ++row)
+  ROW_INDEX row = 0;
+  while (row < rowsCount)
   {
-    T value;
-    table.Get(row, field, value);
+    T zoneMin, zoneMax;
+    const DBSZone zone = table.RetrieveZone(row, field, zoneMin, zoneMax);
+    const ROW_INDEX lastRow = std::min<ROW_INDEX>(zone.mLastRow, rowsCount - 1);
 
-    if ( ! value.IsNull() && (value < margin))
+    //Skip the zones that cannot hold any of the searched values.
+    if (zoneMin.IsNull() || ! (zoneMin < margin) || (zoneMax < maxim))
     {
-      if (maxim < value)
+      row = lastRow + 1;
+      continue;
+    }
+
+    for (; row <= lastRow; ++row)
+    {
+      T value;
+      table.Get(row, field, value);
+
+      if ( ! value.IsNull() && (value < margin))
       {
-        maxim = value;
-        result = DArray();
-        result.Add(DROW_INDEX(row));
+        if (maxim < value)
+        {
+          maxim = value;
+          result = DArray();
+          result.Add(DROW_INDEX(row));
+        }
+        else if (maxim == value)
+          result.Add(DROW_INDEX(row));
       }
-      else if (maxim == value)
-        result.Add(DROW_INDEX(row));
     }
   }
 
@@ -47,8 +47,16 @@ WLIB_PROC_DESCRIPTION       gProcTableRowsCount;
 WLIB_PROC_DESCRIPTION       gProcTableAddRow;
 WLIB_PROC_DESCRIPTION       gProcTableFindRemovedRow;
 WLIB_PROC_DESCRIPTION       gProcTableRemoveRow;
+WLIB_PROC_DESCRIPTION       gProcTableRemoveRows;
+WLIB_PROC_DESCRIPTION       gProcTableRemoveRowsRange;
 WLIB_PROC_DESCRIPTION       gProcTableExchangeRows;
 WLIB_PROC_DESCRIPTION       gProcTableSort;
+WLIB_PROC_DESCRIPTION       gProcTableMatchComposite;
+WLIB_PROC_DESCRIPTION       gProcRowsAnd;
+WLIB_PROC_DESCRIPTION       gProcRowsOr;
+WLIB_PROC_DESCRIPTION       gProcRowsNot;
+WLIB_PROC_DESCRIPTION       gProcTableMatchAll;
+WLIB_PROC_DESCRIPTION       gProcTableMatchAny;
 
 
 class TableSortContainer
@@ -296,6 +304,17 @@ public:
   void Pivot( const uint64_t index) { mPivot = Value( *this, index); }
   const Value& Pivot() const { return mPivot; }
 
+  bool IsSorted(const ROW_INDEX from, const ROW_INDEX to) const
+  {
+    for (ROW_INDEX row = from; row < to; ++row)
+    {
+      if (Value( *this, row + 1) < Value( *this, row))
+        return false;
+    }
+
+    return true;
+  }
+
   void Commit()
   {
     ROW_INDEX row = 0;
@@ -671,6 +690,62 @@ proc_table_reuse_row( SessionStack& stack, ISession&)
 }
 
 
+static WLIB_STATUS
+proc_table_reuse_rows( SessionStack& stack, ISession&)
+{
+  IOperand& op = stack[stack.Size() - 2].Operand();
+  if (op.IsNullExpression())
+  {
+    stack.Pop(2);
+    stack.Push(DUInt32());
+
+    return WOP_OK;
+  }
+
+  DArray rows;
+  stack[stack.Size() - 1].Operand().GetValue(rows);
+
+  const DUInt32 result(op.GetTable().MarkRowsForReuse(rows));
+
+  stack.Pop(2);
+  stack.Push(result);
+
+  return WOP_OK;
+}
+
+
+static WLIB_STATUS
+proc_table_reuse_rows_range( SessionStack& stack, ISession&)
+{
+  DUInt32 from, to;
+
+  IOperand& op = stack[stack.Size() - 3].Operand();
+  if (op.IsNullExpression())
+  {
+    stack.Pop(3);
+    stack.Push(DUInt32());
+
+    return WOP_OK;
+  }
+
+  stack[stack.Size() - 2].Operand().GetValue(from);
+  stack[stack.Size() - 1].Operand().GetValue(to);
+
+  if (from.IsNull())
+    from = DUInt32(0);
+
+  if (to.IsNull())
+    to = DUInt32(~0);
+
+  const DUInt32 result(op.GetTable().MarkRowsForReuse(from.mValue, to.mValue));
+
+  stack.Pop(3);
+  stack.Push(result);
+
+  return WOP_OK;
+}
+
+
 static WLIB_STATUS
 table_exchange_rows( SessionStack& stack, ISession&)
 {
@@ -775,8 +850,11 @@ proc_table_sort( SessionStack& stack, ISession&)
     return WOP_OK;
   }
 
+  //Tables filled in order (e.g. by a timestamp) are often sorted already.
   TableSortContainer container(table, fields, sortOrder);
-  quick_sort<TableSortContainer::Value>(from.mValue, to.mValue, false, container);
+  if ( ! container.IsSorted(from.mValue, to.mValue))
+    quick_sort<TableSortContainer::Value>(from.mValue, to.mValue, false, container);
+
   container.Commit();
 
   stack.Pop(5);
@@ -785,6 +863,473 @@ proc_table_sort( SessionStack& stack, ISession&)
 }
 
 
+template<typename T> static bool
+add_composite_bound(ITable&            bounds,
+                    const ROW_INDEX    row,
+                    const FIELD_INDEX  field,
+                    DBSCompositeKey&   key)
+{
+  T value;
+
+  bounds.Get(row, field, value);
+  if (value.IsNull())
+    return false;
+
+  key.Add(value);
+  return true;
+}
+
+
+static bool
+add_composite_bound(ITable&            bounds,
+                    const ROW_INDEX    row,
+                    const FIELD_INDEX  field,
+                    DBSCompositeKey&   key)
+{
+  if (row >= bounds.AllocatedRows())
+    return false;
+
+  switch (bounds.DescribeField(field).type)
+  {
+  case T_BOOL:
+    return add_composite_bound<DBool>(bounds, row, field, key);
+
+  case T_CHAR:
+    return add_composite_bound<DChar>(bounds, row, field, key);
+
+  case T_DATE:
+    return add_composite_bound<DDate>(bounds, row, field, key);
+
+  case T_DATETIME:
+    return add_composite_bound<DDateTime>(bounds, row, field, key);
+
+  case T_HIRESTIME:
+    return add_composite_bound<DHiresTime>(bounds, row, field, key);
+
+  case T_INT8:
+    return add_composite_bound<DInt8>(bounds, row, field, key);
+
+  case T_INT16:
+    return add_composite_bound<DInt16>(bounds, row, field, key);
+
+  case T_INT32:
+    return add_composite_bound<DInt32>(bounds, row, field, key);
+
+  case T_INT64:
+    return add_composite_bound<DInt64>(bounds, row, field, key);
+
+  case T_UINT8:
+    return add_composite_bound<DUInt8>(bounds, row, field, key);
+
+  case T_UINT16:
+    return add_composite_bound<DUInt16>(bounds, row, field, key);
+
+  case T_UINT32:
+    return add_composite_bound<DUInt32>(bounds, row, field, key);
+
+  case T_UINT64:
+    return add_composite_bound<DUInt64>(bounds, row, field, key);
+
+  case T_REAL:
+    return add_composite_bound<DReal>(bounds, row, field, key);
+
+  case T_RICHREAL:
+    return add_composite_bound<DRichReal>(bounds, row, field, key);
+
+  default:
+    throw InterException(_EXTRA(InterException::INVALID_PARAMETER_TYPE),
+                         "Composite bounds are available only for basic types"
+                         " (e.g. reals, integers, dates, etc.).");
+  }
+}
+
+
+static WLIB_STATUS
+proc_table_match_composite( SessionStack& stack, ISession&)
+{
+  DArray fields(_SC(DUInt16*, nullptr));
+
+  IOperand& opTable = stack[stack.Size() - 5].Operand();
+  IOperand& opFields = stack[stack.Size() - 4].Operand();
+  IOperand& opBounds = stack[stack.Size() - 3].Operand();
+  if (opTable.IsNullExpression() || opTable.IsNull() || opFields.IsNullExpression())
+  {
+    stack.Pop(5);
+    stack.Push(DArray());
+    return WOP_OK;
+  }
+
+  opFields.GetValue(fields);
+
+  ITable& table = opTable.GetTable();
+  const uint_t fieldsCount = fields.Count();
+  if ((fieldsCount == 0) || (fieldsCount > 0xFF))
+  {
+    stack.Pop(5);
+    stack.Push(DArray());
+    return WOP_OK;
+  }
+
+  vector<FIELD_INDEX> fieldIds;
+  for (auto f = 0u; f < fieldsCount; ++f)
+  {
+    DUInt16 fieldId;
+
+    fields.Get(f, fieldId);
+    if (fieldId.mValue >= table.FieldsCount())
+    {
+      stack.Pop(5);
+      stack.Push(DArray());
+      return WOP_OK;
+    }
+    fieldIds.push_back(fieldId.mValue);
+  }
+
+  //The first row of the bounds table holds the lower limits and the second
+  //one the upper limits. The i-th field stands for the i-th indexed field and
+  //a null value leaves the rest of the fields unbounded.
+  DBSCompositeKey minKey, maxKey;
+  if ( ! (opBounds.IsNullExpression() || opBounds.IsNull()))
+  {
+    ITable& bounds = opBounds.GetTable();
+    const uint_t boundsCount = MIN(fieldsCount, _SC(uint_t, bounds.FieldsCount()));
+
+    for (uint_t b = 0; b < boundsCount; ++b)
+    {
+      if ( ! add_composite_bound(bounds, 0, b, minKey))
+        break;
+    }
+
+    for (uint_t b = 0; b < boundsCount; ++b)
+    {
+      if ( ! add_composite_bound(bounds, 1, b, maxKey))
+        break;
+    }
+  }
+
+  DUInt32 from, to;
+  stack[stack.Size() - 2].Operand().GetValue(from);
+  stack[stack.Size() - 1].Operand().GetValue(to);
+
+  ROW_INDEX fromRow = from.IsNull() ? 0 : from.mValue;
+  ROW_INDEX toRow = to.IsNull() ? table.AllocatedRows() - 1 : to.mValue;
+  if (toRow < fromRow)
+    swap(fromRow, toRow);
+
+  DArray result = table.MatchCompositeRows(minKey,
+                                           maxKey,
+                                           fromRow,
+                                           toRow,
+                                           &fieldIds[0],
+                                           fieldIds.size());
+  stack.Pop(5);
+  stack.Push(result);
+  return WOP_OK;
+}
+
+
+static DBSRowsBitmap
+rows_bitmap(IOperand& op)
+{
+  if (op.IsNullExpression())
+    return DBSRowsBitmap();
+
+  DArray rows;
+  op.GetValue(rows);
+
+  return DBSRowsBitmap::FromRows(rows);
+}
+
+
+template<bool intersect> static WLIB_STATUS
+proc_rows_combine( SessionStack& stack, ISession&)
+{
+  DBSRowsBitmap result = rows_bitmap(stack[stack.Size() - 2].Operand());
+  const DBSRowsBitmap second = rows_bitmap(stack[stack.Size() - 1].Operand());
+
+  if (intersect)
+    result.And(second);
+
+  else
+    result.Or(second);
+
+  stack.Pop(2);
+  stack.Push(result.Rows());
+
+  return WOP_OK;
+}
+
+
+static WLIB_STATUS
+proc_rows_not( SessionStack& stack, ISession&)
+{
+  IOperand& opTable = stack[stack.Size() - 2].Operand();
+  if (opTable.IsNullExpression() || opTable.IsNull())
+  {
+    stack.Pop(2);
+    stack.Push(DArray());
+    return WOP_OK;
+  }
+
+  DBSRowsBitmap result = rows_bitmap(stack[stack.Size() - 1].Operand());
+  result.Not(opTable.GetTable().AllocatedRows());
+
+  stack.Pop(2);
+  stack.Push(result.Rows());
+
+  return WOP_OK;
+}
+
+
+template<typename T> static DBSRowsBitmap
+match_predicate_rows(ITable&            table,
+                     const FIELD_INDEX  field,
+                     const T&           min,
+                     const T&           max,
+                     const ROW_INDEX    fromRow,
+                     const ROW_INDEX    toRow)
+{
+  return DBSRowsBitmap::FromRows(table.MatchRows(min, max, fromRow, toRow, field));
+}
+
+
+static DBSRowsBitmap
+match_predicate_rows(ITable&            table,
+                     const FIELD_INDEX  field,
+                     const DBool&       min,
+                     const DBool&       max,
+                     const ROW_INDEX    fromRow,
+                     const ROW_INDEX    toRow)
+{
+  if (table.IsBitmapIndexed(field))
+    return table.MatchRowsBitmap(min, max, fromRow, toRow, field);
+
+  return match_predicate_rows<DBool>(table, field, min, max, fromRow, toRow);
+}
+
+
+static DBSRowsBitmap
+match_predicate_rows(ITable&            table,
+                     const FIELD_INDEX  field,
+                     const DChar&       min,
+                     const DChar&       max,
+                     const ROW_INDEX    fromRow,
+                     const ROW_INDEX    toRow)
+{
+  if (table.IsBitmapIndexed(field))
+    return table.MatchRowsBitmap(min, max, fromRow, toRow, field);
+
+  return match_predicate_rows<DChar>(table, field, min, max, fromRow, toRow);
+}
+
+
+static DBSRowsBitmap
+match_predicate_rows(ITable&            table,
+                     const FIELD_INDEX  field,
+                     const DUInt8&      min,
+                     const DUInt8&      max,
+                     const ROW_INDEX    fromRow,
+                     const ROW_INDEX    toRow)
+{
+  if (table.IsBitmapIndexed(field))
+    return table.MatchRowsBitmap(min, max, fromRow, toRow, field);
+
+  return match_predicate_rows<DUInt8>(table, field, min, max, fromRow, toRow);
+}
+
+
+template<typename T> static DBSRowsBitmap
+match_predicate_rows(ITable&            table,
+                     const FIELD_INDEX  field,
+                     ITable&            bounds,
+                     const FIELD_INDEX  boundsField,
+                     const ROW_INDEX    fromRow,
+                     const ROW_INDEX    toRow)
+{
+  T min, max;
+
+  //A bounds table with a single row asks for the rows holding its values.
+  bounds.Get(0, boundsField, min);
+  if (bounds.AllocatedRows() > 1)
+    bounds.Get(1, boundsField, max);
+
+  else
+    max = min;
+
+  if (max < min)
+    swap(min, max);
+
+  return match_predicate_rows(table, field, min, max, fromRow, toRow);
+}
+
+
+static DBSRowsBitmap
+match_predicate_rows(ITable&            table,
+                     const FIELD_INDEX  field,
+                     ITable&            bounds,
+                     const FIELD_INDEX  boundsField,
+                     const ROW_INDEX    fromRow,
+                     const ROW_INDEX    toRow)
+{
+  const DBSFieldDescriptor fd = table.DescribeField(field);
+  const DBSFieldDescriptor bd = bounds.DescribeField(boundsField);
+  if (fd.isArray || bd.isArray || (fd.type != bd.type))
+  {
+    throw InterException(_EXTRA(InterException::INVALID_PARAMETER_TYPE),
+                         "The bounds of field '%s' are not of its type.",
+                         fd.name);
+  }
+
+  switch (fd.type)
+  {
+  case T_BOOL:
+    return match_predicate_rows<DBool>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_CHAR:
+    return match_predicate_rows<DChar>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_DATE:
+    return match_predicate_rows<DDate>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_DATETIME:
+    return match_predicate_rows<DDateTime>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_HIRESTIME:
+    return match_predicate_rows<DHiresTime>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_INT8:
+    return match_predicate_rows<DInt8>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_INT16:
+    return match_predicate_rows<DInt16>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_INT32:
+    return match_predicate_rows<DInt32>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_INT64:
+    return match_predicate_rows<DInt64>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_UINT8:
+    return match_predicate_rows<DUInt8>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_UINT16:
+    return match_predicate_rows<DUInt16>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_UINT32:
+    return match_predicate_rows<DUInt32>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_UINT64:
+    return match_predicate_rows<DUInt64>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_REAL:
+    return match_predicate_rows<DReal>(table, field, bounds, boundsField, fromRow, toRow);
+
+  case T_RICHREAL:
+    return match_predicate_rows<DRichReal>(table, field, bounds, boundsField, fromRow, toRow);
+
+  default:
+    throw InterException(_EXTRA(InterException::INVALID_PARAMETER_TYPE),
+                         "Matching field values is available only for basic"
+                         " types (e.g. reals, integers, dates, etc.).");
+  }
+}
+
+
+/* Every predicate gets its rows as a bitmap (straight from the bitmap index
+ * of the field if it has one) and the bitmaps are combined in place, so only
+ * the final result is turned into an array. */
+template<bool all> static WLIB_STATUS
+proc_table_match_predicates( SessionStack& stack, ISession&)
+{
+  DArray fields(_SC(DUInt16*, nullptr));
+  DArray negations(_SC(DBool*, nullptr));
+
+  IOperand& opTable = stack[stack.Size() - 6].Operand();
+  IOperand& opFields = stack[stack.Size() - 5].Operand();
+  IOperand& opBounds = stack[stack.Size() - 4].Operand();
+  IOperand& opNegations = stack[stack.Size() - 3].Operand();
+  if (opTable.IsNullExpression()
+      || opTable.IsNull()
+      || opFields.IsNullExpression()
+      || opBounds.IsNullExpression()
+      || opBounds.IsNull())
+  {
+    stack.Pop(6);
+    stack.Push(DArray());
+    return WOP_OK;
+  }
+
+  opFields.GetValue(fields);
+  if ( ! opNegations.IsNullExpression())
+    opNegations.GetValue(negations);
+
+  ITable& table = opTable.GetTable();
+  ITable& bounds = opBounds.GetTable();
+  const uint_t fieldsCount = fields.Count();
+  if ((fieldsCount == 0)
+      || (fieldsCount > bounds.FieldsCount())
+      || (bounds.AllocatedRows() == 0))
+  {
+    stack.Pop(6);
+    stack.Push(DArray());
+    return WOP_OK;
+  }
+
+  DUInt32 from, to;
+  stack[stack.Size() - 2].Operand().GetValue(from);
+  stack[stack.Size() - 1].Operand().GetValue(to);
+
+  ROW_INDEX fromRow = from.IsNull() ? 0 : from.mValue;
+  ROW_INDEX toRow = to.IsNull() ? table.AllocatedRows() - 1 : to.mValue;
+  if (toRow < fromRow)
+    swap(fromRow, toRow);
+
+  DBSRowsBitmap result;
+  for (uint_t f = 0; f < fieldsCount; ++f)
+  {
+    DUInt16 fieldId;
+    DBool   negated;
+
+    fields.Get(f, fieldId);
+    if (fieldId.mValue >= table.FieldsCount())
+    {
+      stack.Pop(6);
+      stack.Push(DArray());
+      return WOP_OK;
+    }
+
+    if (f < negations.Count())
+      negations.Get(f, negated);
+
+    DBSRowsBitmap rows = match_predicate_rows(table,
+                                              fieldId.mValue,
+                                              bounds,
+                                              f,
+                                              fromRow,
+                                              toRow);
+    if ( ! negated.IsNull() && negated.mValue)
+      rows.Not(table.AllocatedRows()).Crop(fromRow, toRow);
+
+    if (f == 0)
+      result = move(rows);
+
+    else if (all)
+      result.And(rows);
+
+    else
+      result.Or(rows);
+
+    if (all && result.IsEmpty())
+      break;
+  }
+
+  stack.Pop(6);
+  stack.Push(result.Rows());
+
+  return WOP_OK;
+}
+
+
 WLIB_STATUS
 base_tables_init()
 {
@@ -866,6 +1411,29 @@ base_tables_init()
   gProcTableRemoveRow.localsTypes = tableReuseRowLocals;
   gProcTableRemoveRow.code        = proc_table_reuse_row;
 
+  static const uint8_t* tableReuseRowsLocals[] = {
+                                                   gUInt32Type,
+                                                   gGenericTableType,
+                                                   gAUInt32Type
+                                                 };
+
+  gProcTableRemoveRows.name        = "empty_rows";
+  gProcTableRemoveRows.localsCount = 3;
+  gProcTableRemoveRows.localsTypes = tableReuseRowsLocals;
+  gProcTableRemoveRows.code        = proc_table_reuse_rows;
+
+  static const uint8_t* tableReuseRowsRangeLocals[] = {
+                                                        gUInt32Type,
+                                                        gGenericTableType,
+                                                        gUInt32Type,
+                                                        gUInt32Type
+                                                      };
+
+  gProcTableRemoveRowsRange.name        = "empty_rows_range";
+  gProcTableRemoveRowsRange.localsCount = 4;
+  gProcTableRemoveRowsRange.localsTypes = tableReuseRowsRangeLocals;
+  gProcTableRemoveRowsRange.code        = proc_table_reuse_rows_range;
+
   static const uint8_t* tableExchangeRows[] = {
                                                 gBoolType,
                                                 gGenericTableType,
@@ -893,6 +1461,70 @@ base_tables_init()
   gProcTableSort.code        = proc_table_sort;
 
 
+  static const uint8_t* tableMatchCompositeLocals[] = {
+                                                        gAUInt32Type,
+                                                        gGenericTableType,
+                                                        gAUInt16Type,
+                                                        gGenericTableType,
+                                                        gUInt32Type,
+                                                        gUInt32Type
+                                                      };
+
+  gProcTableMatchComposite.name        = "match_composite_rows";
+  gProcTableMatchComposite.localsCount = 6;
+  gProcTableMatchComposite.localsTypes = tableMatchCompositeLocals;
+  gProcTableMatchComposite.code        = proc_table_match_composite;
+
+
+  static const uint8_t* rowsCombineLocals[] = {
+                                                gAUInt32Type,
+                                                gAUInt32Type,
+                                                gAUInt32Type
+                                              };
+
+  gProcRowsAnd.name        = "rows_and";
+  gProcRowsAnd.localsCount = 3;
+  gProcRowsAnd.localsTypes = rowsCombineLocals;
+  gProcRowsAnd.code        = proc_rows_combine<true>;
+
+  gProcRowsOr.name        = "rows_or";
+  gProcRowsOr.localsCount = 3;
+  gProcRowsOr.localsTypes = rowsCombineLocals; //reusing
+  gProcRowsOr.code        = proc_rows_combine<false>;
+
+  static const uint8_t* rowsNotLocals[] = {
+                                            gAUInt32Type,
+                                            gGenericTableType,
+                                            gAUInt32Type
+                                          };
+
+  gProcRowsNot.name        = "rows_not";
+  gProcRowsNot.localsCount = 3;
+  gProcRowsNot.localsTypes = rowsNotLocals;
+  gProcRowsNot.code        = proc_rows_not;
+
+
+  static const uint8_t* tableMatchPredicatesLocals[] = {
+                                                         gAUInt32Type,
+                                                         gGenericTableType,
+                                                         gAUInt16Type,
+                                                         gGenericTableType,
+                                                         gABoolType,
+                                                         gUInt32Type,
+                                                         gUInt32Type
+                                                       };
+
+  gProcTableMatchAll.name        = "match_rows_all";
+  gProcTableMatchAll.localsCount = 7;
+  gProcTableMatchAll.localsTypes = tableMatchPredicatesLocals;
+  gProcTableMatchAll.code        = proc_table_match_predicates<true>;
+
+  gProcTableMatchAny.name        = "match_rows_any";
+  gProcTableMatchAny.localsCount = 7;
+  gProcTableMatchAny.localsTypes = tableMatchPredicatesLocals; //reusing
+  gProcTableMatchAny.code        = proc_table_match_predicates<false>;
+
+
   return WOP_OK;
 }
 
@@ -37,8 +37,16 @@ extern whais::WLIB_PROC_DESCRIPTION       gProcTableRowsCount;
 extern whais::WLIB_PROC_DESCRIPTION       gProcTableAddRow;
 extern whais::WLIB_PROC_DESCRIPTION       gProcTableFindRemovedRow;
 extern whais::WLIB_PROC_DESCRIPTION       gProcTableRemoveRow;
+extern whais::WLIB_PROC_DESCRIPTION       gProcTableRemoveRows;
+extern whais::WLIB_PROC_DESCRIPTION       gProcTableRemoveRowsRange;
 extern whais::WLIB_PROC_DESCRIPTION       gProcTableExchangeRows;
 extern whais::WLIB_PROC_DESCRIPTION       gProcTableSort;
+extern whais::WLIB_PROC_DESCRIPTION       gProcTableMatchComposite;
+extern whais::WLIB_PROC_DESCRIPTION       gProcRowsAnd;
+extern whais::WLIB_PROC_DESCRIPTION       gProcRowsOr;
+extern whais::WLIB_PROC_DESCRIPTION       gProcRowsNot;
+extern whais::WLIB_PROC_DESCRIPTION       gProcTableMatchAll;
+extern whais::WLIB_PROC_DESCRIPTION       gProcTableMatchAny;
 
 
 whais::WLIB_STATUS
@@ -622,3 +622,107 @@ DO
 ENDPROC
 
 
+
+PROCEDURE same_matched_rows(r1 UINT32 ARRAY, r2 UINT32 ARRAY) RETURN BOOL
+DO
+	IF (count(r1) != count(r2)) DO
+		write_log(_FUNCL_ + ": " + count(r1) + " rows were matched rather than " + count(r2));
+		RETURN FALSE;
+	END
+
+	FOR (r : r1)
+		IF (r != r2[@r]) DO
+			write_log(_FUNCL_ + ": at index " + @r + " the result is " + r + " rather than " + r2[@r]);
+			RETURN FALSE;
+		END
+
+	RETURN TRUE;
+ENDPROC
+
+PROCEDURE test_whais_api_match_rows_all_any(tc UINT8) RETURN BOOL
+DO
+    VAR tlocal TABLE (f1 BOOL, f2 UINT8, f3 INT32);
+    VAR tnull TABLE;
+    VAR bounds TABLE (b1 BOOL, b2 UINT8);
+    VAR bounds2 TABLE (b1 BOOL, b2 INT32);
+    VAR cols, cols2 UINT16 ARRAY;
+    VAR negate BOOL ARRAY;
+    VAR i UINT32;
+
+    # The rows are matched through the bitmap indexes of the global table and
+    # by a search of the same values on the local one.
+    i = 0;
+    WHILE (i < 40) DO
+        tlocal.f1[i] = (i % 2 == 0);
+        tlocal.f2[i] = i % 5;
+        tlocal.f3[i] = i;
+
+        IF (count_rows(table_glb_bitmap_fields) <= i) DO
+            table_glb_bitmap_fields.f1[i] = (i % 2 == 0);
+            table_glb_bitmap_fields.f2[i] = i % 5;
+            table_glb_bitmap_fields.f3[i] = i;
+        END
+        i = i + 1;
+    END
+
+    cols = {0, 1} UINT16;
+    cols2 = {0, 2} UINT16;
+    bounds.b1[0] = TRUE; bounds.b2[0] = 0;
+    bounds2.b1[0] = TRUE; bounds2.b1[1] = TRUE;
+    bounds2.b2[0] = 10; bounds2.b2[1] = 19;
+
+    IF (tc == 0) DO
+	IF (match_rows_all(NULL, cols, bounds, NULL) != NULL)
+		RETURN FALSE;
+	ELSE IF (match_rows_any(tnull, cols, bounds, NULL) != NULL)
+		RETURN FALSE;
+	ELSE IF (match_rows_all(tlocal, NULL, bounds, NULL) != NULL)
+		RETURN FALSE;
+	ELSE IF (match_rows_all(tlocal, cols, tnull, NULL) != NULL)
+		RETURN FALSE;
+	ELSE
+		RETURN TRUE;
+
+    ELSE IF (tc == 1) DO
+	IF ( NOT same_matched_rows(match_rows_all(table_glb_bitmap_fields, cols, bounds, NULL),
+	                         {0, 10, 20, 30} UINT32))
+		RETURN FALSE;
+	RETURN same_matched_rows(match_rows_all(tlocal, cols, bounds, NULL),
+	                         {0, 10, 20, 30} UINT32);
+
+    ELSE IF (tc == 2) DO
+	IF (count(match_rows_any(table_glb_bitmap_fields, cols, bounds, NULL)) != 24)
+		RETURN FALSE;
+	RETURN same_matched_rows(match_rows_any(table_glb_bitmap_fields, cols, bounds, NULL),
+	                         match_rows_any(tlocal, cols, bounds, NULL));
+
+    ELSE IF (tc == 3) DO
+	bounds.b1[1] = TRUE; bounds.b2[1] = 1;
+	negate = {FALSE, TRUE} BOOL;
+	IF ( NOT same_matched_rows(match_rows_all(table_glb_bitmap_fields, cols, bounds, negate),
+	                         {2, 4, 8, 12, 14, 18, 22, 24, 28, 32, 34, 38} UINT32))
+		RETURN FALSE;
+	RETURN same_matched_rows(match_rows_all(tlocal, cols, bounds, negate),
+	                         match_rows_all(table_glb_bitmap_fields, cols, bounds, negate));
+
+    ELSE IF (tc == 4) DO
+	IF ( NOT same_matched_rows(match_rows_all(table_glb_bitmap_fields, cols2, bounds2, NULL),
+	                         {10, 12, 14, 16, 18} UINT32))
+		RETURN FALSE;
+	RETURN same_matched_rows(match_rows_all(tlocal, cols2, bounds2, NULL),
+	                         {10, 12, 14, 16, 18} UINT32);
+
+    ELSE IF (tc == 5) DO
+	IF ( NOT same_matched_rows(match_rows_all(table_glb_bitmap_fields, cols, bounds, NULL, 5, 25),
+	                         {10, 20} UINT32))
+		RETURN FALSE;
+	RETURN same_matched_rows(match_rows_any(table_glb_bitmap_fields, cols, bounds, NULL, 36, 39),
+	                         {36, 38} UINT32);
+
+    ELSE IF (tc == 6) DO
+	cols[1] = 100;
+	RETURN match_rows_all(table_glb_bitmap_fields, cols, bounds, NULL) == NULL;
+    END
+
+    RETURN NULL;
+ENDPROC
@@ -0,0 +1,9 @@
+/* Generated by _tools_/superinstr/gen_superinstrs.sh from opcodes profiles.
+ * Every entry is a sequence of opcodes the interpreter runs as a single
+ * instruction, followed by the count of dispatches it saved when profiled.
+ * Regenerate it rather than editing it by hand. */
+
+SUPER_INSTRUCTION(W_MULU, W_SADD)                            /* 250000 */
+SUPER_INSTRUCTION(W_MODU, W_INDT)                            /* 50000 */
+SUPER_INSTRUCTION(W_INDA, W_SADD)                            /* 5000 */
+SUPER_INSTRUCTION(W_MULU, W_STI64)                           /* 5000 */
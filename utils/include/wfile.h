@@ -63,11 +63,14 @@ public:
   void     Seek(const int64_t where, const int whence);
   uint64_t Tell();
   void     Sync();
+  void     Prefetch(const uint64_t offset, const uint64_t size);
   uint64_t Size() const;
   void     Size(const uint64_t size);
   void     Close();
 
 private:
+  friend class FileMapping;
+
   static const uint64_t UNKNOWN_SIZE = 0xFFFFFFFFFFFFFFFFull;
 
   WH_FILE     mHandle;
@@ -75,6 +78,26 @@ private:
 };
 
 
+//A read only view of the whole content of a file, kept after the file is
+//closed.
+class CUSTOM_SHL FileMapping
+{
+public:
+  explicit FileMapping(const char* name);
+  ~FileMapping();
+
+  FileMapping(FileMapping&) = delete;
+  FileMapping& operator= (FileMapping&) = delete;
+
+  const uint8_t* Data() const { return mData; }
+  uint64_t       Size() const { return mSize; }
+
+private:
+  const uint8_t*  mData;
+  uint64_t        mSize;
+};
+
+
 } //namespace whais
 
 
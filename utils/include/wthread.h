@@ -45,12 +45,37 @@ public:
   void unlock();
 
 private:
+  friend class Condition;
+
   Lock(const Lock&);
   Lock& operator= (const Lock&);
 
   WH_LOCK mLock;
 };
 
+
+class CUSTOM_SHL Condition
+{
+public:
+  Condition();
+  ~Condition();
+
+  //The lock has to be held by the caller.
+  void Wait(Lock& lock);
+
+  //Returns false if the time has passed before the condition was signaled.
+  bool Wait(Lock& lock, const uint_t millisecs);
+
+  void Signal();
+  void Broadcast();
+
+private:
+  Condition(const Condition&);
+  Condition& operator= (const Condition&);
+
+  WH_COND mCond;
+};
+
 class CUSTOM_SHL SpinLock
 {
 public: